@@ -9,6 +9,7 @@ export const MESSAGE_TYPES = {
   HEARTBEAT: 'heartbeat',
   COMMAND: 'command',
   METRICS: 'metrics',
+  CURSOR: 'cursor', // Позиція/форма вказівника (сервер пересилає глядачам)
   
   // Server → Client
   WELCOME: 'welcome',
@@ -22,6 +23,7 @@ export const MESSAGE_TYPES = {
   // Bidirectional (both Client ↔ Server)
   START_CAPTURE: 'start_capture',
   STOP_CAPTURE: 'stop_capture',
+  REPLAY_GOP: 'replay_gop', // Повторити поточну групу кадрів лише для нового глядача
 } as const;
 
 export const CLIENT_TYPES = {
@@ -34,6 +36,8 @@ export const FRAME_CODECS = {
   BGRA: 'bgra',
   JPEG: 'jpeg',
   H264: 'h264',
+  DELTA: 'delta',
+  TILE: 'tile',
 } as const;
 
 export const WEBSOCKET_EVENTS = {
@@ -0,0 +1,121 @@
+/**
+ * Cursor Relay
+ * Канал курсора від capture-client до глядачів: позиція та id форми кожної зміни,
+ * пікселі форми - кожному глядачу один раз (сервер кешує їх за id)
+ */
+
+// Скільки форм тримати на потік (найстаріші витісняються, як у нативному трекері)
+const MAX_SHAPES_PER_STREAM = 64;
+
+export interface CursorShape {
+    id: number;
+    width: number;
+    height: number;
+    hotX: number;
+    hotY: number;
+    data: string; // base64, непремультиплікована BGRA
+}
+
+export interface CursorMessage {
+    type: string;
+    output: number;
+    x: number;
+    y: number;
+    visible: boolean;
+    shapeId: number;
+    sequence: number;
+    shape?: CursorShape;
+}
+
+interface StreamCursor {
+    states: Map<number, CursorMessage>; // output -> останній стан (без пікселів)
+    shapes: Map<string, CursorShape>; // 'output:id' -> форма
+}
+
+export class CursorRelay {
+    private streams = new Map<string, StreamCursor>();
+    // Форми, які глядач уже отримав ('output:id')
+    private viewerShapes = new Map<string, Set<string>>();
+
+    /**
+     * Запам'ятати повідомлення capture-client. Повертає стан без пікселів форми
+     * або null, якщо повідомлення невалідне.
+     */
+    update(streamId: string, message: any): CursorMessage | null {
+        if (typeof message.x !== 'number' || typeof message.y !== 'number') {
+            return null;
+        }
+
+        let stream = this.streams.get(streamId);
+        if (!stream) {
+            stream = { states: new Map(), shapes: new Map() };
+            this.streams.set(streamId, stream);
+        }
+
+        const output = typeof message.output === 'number' ? message.output : 0;
+        const state: CursorMessage = {
+            type: message.type,
+            output,
+            x: message.x,
+            y: message.y,
+            visible: message.visible !== false,
+            shapeId: message.shapeId || 0,
+            sequence: message.sequence || 0
+        };
+        stream.states.set(output, state);
+
+        const shape = message.shape;
+        if (shape && typeof shape.data === 'string' && shape.id === state.shapeId) {
+            const key = `${output}:${shape.id}`;
+            stream.shapes.delete(key); // Оновити порядок витіснення
+            stream.shapes.set(key, shape);
+            if (stream.shapes.size > MAX_SHAPES_PER_STREAM) {
+                stream.shapes.delete(stream.shapes.keys().next().value as string);
+            }
+        }
+        return state;
+    }
+
+    /**
+     * Повідомлення для глядача: форма додається, якщо він її ще не отримував
+     */
+    messageFor(streamId: string, viewerId: string, state: CursorMessage): CursorMessage {
+        if (!state.shapeId) {
+            return state;
+        }
+        const key = `${state.output}:${state.shapeId}`;
+        let seen = this.viewerShapes.get(viewerId);
+        if (seen && seen.has(key)) {
+            return state;
+        }
+        const shape = this.streams.get(streamId)?.shapes.get(key);
+        if (!shape) {
+            return state;
+        }
+        if (!seen) {
+            seen = new Set();
+            this.viewerShapes.set(viewerId, seen);
+        }
+        seen.add(key);
+        return { ...state, shape };
+    }
+
+    /**
+     * Поточний курсор кожного виходу для нового глядача
+     */
+    snapshot(streamId: string, viewerId: string): CursorMessage[] {
+        const stream = this.streams.get(streamId);
+        if (!stream) {
+            return [];
+        }
+        return Array.from(stream.states.values()).map((state) => this.messageFor(streamId, viewerId, state));
+    }
+
+    removeStream(streamId: string): void {
+        this.streams.delete(streamId);
+    }
+
+    removeViewer(viewerId: string): void {
+        this.viewerShapes.delete(viewerId);
+    }
+}
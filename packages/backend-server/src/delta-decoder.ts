@@ -0,0 +1,189 @@
+/**
+ * Delta Frame Decoder для Backend
+ * Відновлює повний BGRA кадр з дельта-пакетів capture-client (формат DLT1)
+ * Формат описано в packages/capture-client/native/delta-encoder.h
+ */
+
+import { logger } from './logger';
+
+const DELTA_MAGIC = 0x31544c44; // "DLT1"
+const DELTA_HEADER_SIZE = 16;
+const DELTA_FLAG_KEYFRAME = 0x01;
+const DELTA_FLAG_MOVES = 0x02;
+const DELTA_FLAG_TILE_CACHE = 0x04;
+const DELTA_MOVE_SIZE = 12;
+const DELTA_CACHE_HIT = 0x8000;
+
+interface DeltaCanvas {
+    width: number;
+    height: number;
+    pixels: Buffer;
+    // Кеш плиток: слоти призначає capture-client, тут лише зберігаються пікселі
+    tileCache: Buffer[];
+}
+
+export class DeltaDecoder {
+    // Поточний стан кадру: ключ `${streamId}:${output}` - у кожного монітора власне полотно
+    private canvases = new Map<string, DeltaCanvas>();
+
+    /**
+     * Застосувати пакет до кадру полотна canvasKey.
+     * Повертає копію повного BGRA кадру або null, якщо ще не було keyframe.
+     */
+    apply(canvasKey: string, packet: Buffer): Buffer | null {
+        if (packet.length < DELTA_HEADER_SIZE || packet.readUInt32LE(0) !== DELTA_MAGIC) {
+            logger.warn(`⚠️ Невалідний дельта-пакет для ${canvasKey}`);
+            return null;
+        }
+
+        const width = packet.readUInt16LE(4);
+        const height = packet.readUInt16LE(6);
+        const tileSize = packet.readUInt16LE(8);
+        const flags = packet.readUInt8(10);
+        const keyframe = (flags & DELTA_FLAG_KEYFRAME) !== 0;
+
+        let canvas = this.canvases.get(canvasKey);
+        if (keyframe && (!canvas || canvas.width !== width || canvas.height !== height)) {
+            canvas = { width, height, pixels: Buffer.alloc(width * height * 4), tileCache: [] };
+            this.canvases.set(canvasKey, canvas);
+        }
+
+        if (!canvas || canvas.width !== width || canvas.height !== height) {
+            // Очікуємо keyframe
+            return null;
+        }
+
+        const tilesX = Math.ceil(width / tileSize);
+        const tilesY = Math.ceil(height / tileSize);
+        const tileCount = tilesX * tilesY;
+        const stride = width * 4;
+
+        let bitmapOffset = DELTA_HEADER_SIZE;
+        if (flags & DELTA_FLAG_MOVES) {
+            const moves = packet.length >= bitmapOffset + 4 ? packet.readUInt16LE(bitmapOffset) : 0;
+            bitmapOffset += 4 + moves * DELTA_MOVE_SIZE;
+            if (bitmapOffset > packet.length || !this.applyMoves(canvas, packet, DELTA_HEADER_SIZE + 4, moves)) {
+                logger.warn(`⚠️ Невалідні переміщення в дельта-пакеті для ${canvasKey}`);
+                return null;
+            }
+        }
+        // Keyframe очищає кеш: глядач, що підключився з GOP кешу, має той самий стан
+        if (keyframe) {
+            canvas.tileCache = [];
+        }
+        const cached = (flags & DELTA_FLAG_TILE_CACHE) !== 0;
+        let referenceOffset = bitmapOffset + Math.ceil(tileCount / 8);
+        let offset = referenceOffset + (cached ? packet.readUInt32LE(12) * 2 : 0);
+
+        for (let i = 0; i < tileCount; i++) {
+            if ((packet[bitmapOffset + (i >> 3)] & (1 << (i & 7))) === 0) {
+                continue;
+            }
+
+            const x = (i % tilesX) * tileSize;
+            const y = Math.floor(i / tilesX) * tileSize;
+            const rowBytes = Math.min(tileSize, width - x) * 4;
+            const rows = Math.min(tileSize, height - y);
+
+            let source = packet;
+            let sourceOffset = offset;
+            if (cached) {
+                if (referenceOffset + 2 > packet.length) {
+                    logger.warn(`⚠️ Обрізаний дельта-пакет для ${canvasKey}`);
+                    return null;
+                }
+                const reference = packet.readUInt16LE(referenceOffset);
+                referenceOffset += 2;
+                const slot = reference & ~DELTA_CACHE_HIT;
+                if (reference & DELTA_CACHE_HIT) {
+                    const tile = canvas.tileCache[slot];
+                    if (!tile || tile.length !== rowBytes * rows) {
+                        logger.warn(`⚠️ Невідомий слот кешу плиток ${slot} для ${canvasKey}`);
+                        return null;
+                    }
+                    source = tile;
+                    sourceOffset = 0;
+                } else if (offset + rowBytes * rows <= packet.length) {
+                    canvas.tileCache[slot] = Buffer.from(packet.subarray(offset, offset + rowBytes * rows));
+                }
+            }
+
+            if (source === packet) {
+                if (offset + rowBytes * rows > packet.length) {
+                    logger.warn(`⚠️ Обрізаний дельта-пакет для ${canvasKey}`);
+                    return null;
+                }
+                offset += rowBytes * rows;
+            }
+
+            for (let row = 0; row < rows; row++) {
+                source.copy(canvas.pixels, (y + row) * stride + x * 4, sourceOffset, sourceOffset + rowBytes);
+                sourceOffset += rowBytes;
+            }
+        }
+
+        // Копія - JPEG компресор змінює буфер на місці
+        return Buffer.from(canvas.pixels);
+    }
+
+    /**
+     * Поточний кадр полотна canvasKey (копія) - стартовий кадр для нового глядача.
+     * null, якщо полотна ще немає.
+     */
+    snapshot(canvasKey: string): { width: number; height: number; pixels: Buffer } | null {
+        const canvas = this.canvases.get(canvasKey);
+        if (!canvas) {
+            return null;
+        }
+        return { width: canvas.width, height: canvas.height, pixels: Buffer.from(canvas.pixels) };
+    }
+
+    /**
+     * Переміщення (прокрутка) до накладання плиток. Джерела читаються з кадру
+     * до будь-якого з переміщень, тому спершу копіюються всі.
+     */
+    private applyMoves(canvas: DeltaCanvas, packet: Buffer, offset: number, count: number): boolean {
+        const stride = canvas.width * 4;
+        const sources: Buffer[] = [];
+        for (let i = 0; i < count; i++) {
+            const at = offset + i * DELTA_MOVE_SIZE;
+            const srcX = packet.readUInt16LE(at);
+            const srcY = packet.readUInt16LE(at + 2);
+            const width = packet.readUInt16LE(at + 4);
+            const height = packet.readUInt16LE(at + 6);
+            const dstX = packet.readUInt16LE(at + 8);
+            const dstY = packet.readUInt16LE(at + 10);
+            if (Math.max(srcX, dstX) + width > canvas.width || Math.max(srcY, dstY) + height > canvas.height) {
+                return false;
+            }
+            const rowBytes = width * 4;
+            const source = Buffer.allocUnsafe(rowBytes * height);
+            for (let row = 0; row < height; row++) {
+                const start = (srcY + row) * stride + srcX * 4;
+                canvas.pixels.copy(source, row * rowBytes, start, start + rowBytes);
+            }
+            sources.push(source);
+        }
+        for (let i = 0; i < count; i++) {
+            const at = offset + i * DELTA_MOVE_SIZE;
+            const width = packet.readUInt16LE(at + 4);
+            const height = packet.readUInt16LE(at + 6);
+            const dstX = packet.readUInt16LE(at + 8);
+            const dstY = packet.readUInt16LE(at + 10);
+            const rowBytes = width * 4;
+            for (let row = 0; row < height; row++) {
+                sources[i].copy(canvas.pixels, (dstY + row) * stride + dstX * 4, row * rowBytes, (row + 1) * rowBytes);
+            }
+        }
+        return true;
+    }
+
+    // Усі полотна потоку (кожного монітора)
+    removeStream(streamId: string): void {
+        for (const key of this.canvases.keys()) {
+            if (key.startsWith(`${streamId}:`)) {
+                this.canvases.delete(key);
+            }
+        }
+    }
+}
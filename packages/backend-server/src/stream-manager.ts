@@ -18,7 +18,8 @@ export interface StreamInfo {
         width: number;
         height: number;
         fps: number;
-        codec: typeof FRAME_CODECS.BGRA | typeof FRAME_CODECS.JPEG | typeof FRAME_CODECS.H264;
+        codec: typeof FRAME_CODECS.BGRA | typeof FRAME_CODECS.JPEG | typeof FRAME_CODECS.H264 |
+            typeof FRAME_CODECS.TILE;
     };
     stats: {
         framesReceived: number;
@@ -34,6 +35,11 @@ export interface FrameMetadata {
     timestamp: number;
     frameNumber: number;
     size: number;
+    codec?: string;
+    output: number;     // Монітор capture-client (кожен - окремий дельта-потік)
+    // Повтор групи кадрів з GOP кешу capture-client - лише для одного глядача
+    replay?: boolean;
+    viewerId?: string;
 }
 
 export class StreamManager extends EventEmitter {
@@ -126,7 +132,8 @@ export class StreamManager extends EventEmitter {
                 width: metadata.width,
                 height: metadata.height,
                 fps: 0, // Розрахуємо окремо
-                codec: FRAME_CODECS.JPEG
+                // Глядачам іде JPEG; tile пересилається без перекодування
+                codec: metadata.codec === FRAME_CODECS.TILE ? FRAME_CODECS.TILE : FRAME_CODECS.JPEG
             };
         }
     }
@@ -7,9 +7,11 @@ import WebSocket, { WebSocketServer } from 'ws';
 import { ClientManager, ClientType } from './client-manager';
 import { StreamManager, FrameMetadata } from './stream-manager';
 import { JPEGCompressor } from './jpeg-compressor';
+import { DeltaDecoder } from './delta-decoder';
 import { logger } from './logger';
 import { MESSAGE_TYPES, CLIENT_TYPES, ERRORS, JPEG_CONFIG, FRAME_CODECS } from './constants';
 import { isValidMessage, safeJSONParse, generateId, formatCompressionRatio } from './utils';
+import { CursorRelay } from './cursor-relay';
 import type { BaseMessage, ClientMessage } from './types';
 
 export class WebSocketHandler {
@@ -17,6 +19,10 @@ export class WebSocketHandler {
     private streamManager: StreamManager;
     private clientManager: ClientManager;
     private compressor: JPEGCompressor;
+    private deltaDecoder = new DeltaDecoder();
+    // Метадані останнього кадру кожного дельта-полотна (`${streamId}:${output}`) - для стартового кадру глядача
+    private deltaFrames = new Map<string, FrameMetadata>();
+    private cursorRelay = new CursorRelay();
 
     // Тимчасове сховище для очікування бінарних даних після метаданих
     private pendingFrames = new Map<string, FrameMetadata>();
@@ -157,6 +163,10 @@ export class WebSocketHandler {
                 this.handleMetrics(clientId, message);
                 break;
 
+            case MESSAGE_TYPES.CURSOR:
+                this.handleCursor(clientId, message);
+                break;
+
             default:
                 logger.warn(`⚠️ Невідомий тип повідомлення від ${clientId}:`, message.type);
         }
@@ -191,8 +201,14 @@ export class WebSocketHandler {
             height: message.height,
             timestamp: message.timestamp,
             frameNumber: message.frameNumber,
-            size: message.size
+            size: message.size,
+            codec: message.codec,
+            output: message.output || 0
         };
+        if (message.replay && message.viewerId) {
+            metadata.replay = true;
+            metadata.viewerId = message.viewerId;
+        }
 
         // Зберегти метадані, очікуємо бінарний кадр наступним повідомленням
         this.pendingFrames.set(clientId, metadata);
@@ -223,33 +239,66 @@ export class WebSocketHandler {
         // Записати статистику (оригінальний розмір)
         this.streamManager.recordFrameReceived(stream.streamId, frameData.length);
 
+        // Дельта-пакет - відновити повний BGRA кадр на полотні свого монітора
+        if (metadata.codec === FRAME_CODECS.DELTA) {
+            // Новий глядач дельта-потоку отримує знімок спільного полотна, повтор групи не потрібен
+            if (metadata.replay) {
+                return;
+            }
+            const canvasKey = `${stream.streamId}:${metadata.output}`;
+            const fullFrame = this.deltaDecoder.apply(canvasKey, frameData);
+            if (!fullFrame) {
+                return;
+            }
+            this.deltaFrames.set(canvasKey, metadata);
+            frameData = fullFrame;
+        }
+
         // Стиснути BGRA -> JPEG перед відправкою
         let compressedFrame: Buffer;
-        let codec: typeof FRAME_CODECS.BGRA | typeof FRAME_CODECS.JPEG = FRAME_CODECS.BGRA;
+        let codec: typeof FRAME_CODECS.BGRA | typeof FRAME_CODECS.JPEG | typeof FRAME_CODECS.TILE = FRAME_CODECS.BGRA;
         
-        try {
-            compressedFrame = await this.compressor.compress(
-                frameData,
-                metadata.width,
-                metadata.height
-            );
+        if (metadata.codec === FRAME_CODECS.JPEG) {
+            // Capture client вже стиснув кадр в аддоні - пересилаємо як є
+            compressedFrame = frameData;
             codec = FRAME_CODECS.JPEG;
-        } catch (error) {
-            logger.error('❌ Помилка стиснення, відправляємо оригінал:', error);
-            compressedFrame = frameData; // Fallback до RAW
+        } else if (metadata.codec === FRAME_CODECS.TILE) {
+            // Екранний кодек: глядач декодує сам (tile-decoder.js), перекодування в JPEG зіпсувало б текст
+            compressedFrame = frameData;
+            codec = FRAME_CODECS.TILE;
+        } else {
+            try {
+                compressedFrame = await this.compressor.compress(
+                    frameData,
+                    metadata.width,
+                    metadata.height
+                );
+                codec = FRAME_CODECS.JPEG;
+            } catch (error) {
+                logger.error('❌ Помилка стиснення, відправляємо оригінал:', error);
+                compressedFrame = frameData; // Fallback до RAW
+            }
         }
 
-        // Розіслати кадр усім глядачам
+        // Розіслати кадр усім глядачам; повтор групи - лише тому, хто його запросив
         const viewers = this.streamManager.getViewersForStream(stream.streamId);
-        
+        const recipients = metadata.replay
+            ? viewers.filter((viewerId) => viewerId === metadata.viewerId)
+            : viewers;
+
+        // Службові поля повтору глядачу не потрібні
+        const frameMetadata: FrameMetadata = { ...metadata };
+        delete frameMetadata.replay;
+        delete frameMetadata.viewerId;
+
         let sentCount = 0;
-        for (const viewerId of viewers) {
+        for (const viewerId of recipients) {
             const viewer = this.clientManager.getClient(viewerId);
             if (viewer && viewer.ws.readyState === WebSocket.OPEN) {
                 // Відправити метадані (з оновленим codec та size)
                 this.sendMessage(viewer.ws, {
                     type: MESSAGE_TYPES.FRAME_METADATA,
-                    ...metadata,
+                    ...frameMetadata,
                     size: compressedFrame.length,
                     codec: codec
                 });
@@ -271,6 +320,25 @@ export class WebSocketHandler {
         logger.debug(`📤 Кадр #${metadata.frameNumber} розіслано ${sentCount} глядачам (${codec})`);
     }
 
+    // Рух вказівника - окремим маленьким повідомленням, без нового кадру
+    private handleCursor(clientId: string, message: any): void {
+        const stream = this.streamManager.getStreamByCaptureClient(clientId);
+        if (!stream) {
+            return;
+        }
+        const state = this.cursorRelay.update(stream.streamId, message);
+        if (!state) {
+            return;
+        }
+
+        for (const viewerId of this.streamManager.getViewersForStream(stream.streamId)) {
+            const viewer = this.clientManager.getClient(viewerId);
+            if (viewer) {
+                this.sendMessage(viewer.ws, this.cursorRelay.messageFor(stream.streamId, viewerId, state));
+            }
+        }
+    }
+
     private handleJoinStream(clientId: string, message: any): void {
         const streamId = message.streamId;
         
@@ -301,6 +369,14 @@ export class WebSocketHandler {
                     streamId,
                     timestamp: Date.now()
                 });
+                // Поточний курсор - одразу, не чекаючи наступного руху
+                for (const cursor of this.cursorRelay.snapshot(streamId, clientId)) {
+                    this.sendMessage(client.ws, cursor);
+                }
+                // Старт без очікування keyframe: знімок дельта-полотна або група кадрів з кешу capture-client
+                if (!this.sendDeltaSnapshots(streamId, clientId)) {
+                    this.requestGopReplay(streamId, clientId);
+                }
             } else {
                 this.sendMessage(client.ws, {
                     type: MESSAGE_TYPES.ERROR,
@@ -311,6 +387,77 @@ export class WebSocketHandler {
         }
     }
 
+    /**
+     * Поточний кадр кожного дельта-полотна потоку - одним JPEG лише новому глядачу.
+     * false, якщо потік не дельта (або ще без keyframe) - тоді повтор групи кадрів.
+     */
+    private sendDeltaSnapshots(streamId: string, viewerId: string): boolean {
+        let sent = false;
+        for (const [canvasKey, metadata] of this.deltaFrames) {
+            if (!canvasKey.startsWith(`${streamId}:`)) {
+                continue;
+            }
+            const snapshot = this.deltaDecoder.snapshot(canvasKey);
+            if (!snapshot) {
+                continue;
+            }
+            sent = true;
+            this.sendDeltaSnapshot(streamId, viewerId, canvasKey, metadata, snapshot);
+        }
+        return sent;
+    }
+
+    private async sendDeltaSnapshot(
+        streamId: string,
+        viewerId: string,
+        canvasKey: string,
+        metadata: FrameMetadata,
+        snapshot: { width: number; height: number; pixels: Buffer }
+    ): Promise<void> {
+        let jpeg: Buffer;
+        try {
+            jpeg = await this.compressor.compress(snapshot.pixels, snapshot.width, snapshot.height);
+        } catch (error) {
+            logger.error('❌ Помилка стиснення стартового кадру:', error);
+            return;
+        }
+
+        // Поки стискали, глядач уже отримує новіші кадри цього полотна - знімок застарів
+        if (this.deltaFrames.get(canvasKey) !== metadata) {
+            return;
+        }
+        const viewer = this.clientManager.getClient(viewerId);
+        if (!viewer || viewer.ws.readyState !== WebSocket.OPEN) {
+            return;
+        }
+
+        this.sendMessage(viewer.ws, {
+            type: MESSAGE_TYPES.FRAME_METADATA,
+            ...metadata,
+            width: snapshot.width,
+            height: snapshot.height,
+            size: jpeg.length,
+            codec: FRAME_CODECS.JPEG
+        });
+        viewer.ws.send(jpeg, (error) => {
+            if (error) {
+                logger.error(`❌ Помилка відправки стартового кадру глядачу ${viewerId}:`, error);
+            }
+        });
+        this.streamManager.recordFrameSent(streamId, jpeg.length, 1);
+    }
+
+    private requestGopReplay(streamId: string, viewerId: string): void {
+        const stream = this.streamManager.getStream(streamId);
+        const captureClient = stream && this.clientManager.getClient(stream.captureClientId);
+        if (captureClient) {
+            this.sendCommand(captureClient.ws, {
+                type: MESSAGE_TYPES.REPLAY_GOP,
+                viewerId
+            });
+        }
+    }
+
     private handleHeartbeat(clientId: string, message: any): void {
         const client = this.clientManager.getClient(clientId);
         if (client) {
@@ -349,6 +496,13 @@ export class WebSocketHandler {
                     }
                 }
 
+                this.deltaDecoder.removeStream(stream.streamId);
+                for (const canvasKey of this.deltaFrames.keys()) {
+                    if (canvasKey.startsWith(`${stream.streamId}:`)) {
+                        this.deltaFrames.delete(canvasKey);
+                    }
+                }
+                this.cursorRelay.removeStream(stream.streamId);
                 this.streamManager.removeStream(stream.streamId);
             }
         } else if (client.type === CLIENT_TYPES.VIEWER) {
@@ -358,6 +512,7 @@ export class WebSocketHandler {
                     this.streamManager.removeViewer(stream.streamId, clientId);
                 }
             }
+            this.cursorRelay.removeViewer(clientId);
         }
 
         this.clientManager.removeClient(clientId);
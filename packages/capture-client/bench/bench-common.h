@@ -0,0 +1,65 @@
+/**
+ * Benchmark Helpers
+ * Спільні роздільності та синтетичні кадри для бенчмарків
+ */
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "aligned-memory.h"
+#include "synthetic-capture.h"
+#include "worker-pool.h"
+
+// 720p, 1080p, 1440p, 4K (аргументи бенчмарку: width, height)
+inline void FrameSizes(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"width", "height"});
+    b->Args({1280, 720});
+    b->Args({1920, 1080});
+    b->Args({2560, 1440});
+    b->Args({3840, 2160});
+}
+
+// Спільний пул потоків (як в аддоні - один на процес)
+inline WorkerPool* GetBenchWorkerPool() {
+    static std::unique_ptr<WorkerPool> pool = [] {
+        std::unique_ptr<WorkerPool> p(new WorkerPool());
+        p->Initialize(0);
+        return p;
+    }();
+    return pool.get();
+}
+
+// Послідовність детермінованих кадрів синтетичного джерела (щільний BGRA)
+class SyntheticFrames {
+public:
+    SyntheticFrames(int width, int height, int count,
+                    SyntheticScenario scenario = SyntheticScenario::Mixed)
+        : width_(width), height_(height), frames_(count) {
+        SyntheticCapture source(scenario, 0, 1);
+        source.Initialize(width, height);
+        for (int i = 0; i < count; i++) {
+            frames_[i].Resize(GetFrameBytes());
+            // Кадр простою (false) повторює попередній вміст
+            if (!source.CaptureFrame(frames_[i].data(), GetStride()) && i > 0) {
+                memcpy(frames_[i].data(), frames_[i - 1].data(), GetFrameBytes());
+            }
+        }
+    }
+
+    const uint8_t* Get(size_t index) const { return frames_[index % frames_.size()].data(); }
+    size_t GetCount() const { return frames_.size(); }
+    int GetStride() const { return width_ * 4; }
+    size_t GetFrameBytes() const { return (size_t)width_ * height_ * 4; }
+
+private:
+    int width_;
+    int height_;
+    std::vector<AlignedBuffer> frames_;
+};
+
+#endif // BENCH_COMMON_H
@@ -0,0 +1,95 @@
+/**
+ * Conversion Benchmarks
+ * BGRA -> NV12 (окремі ядра та смуги на пулі), копіювання рядків з pitch
+ */
+
+#include "bench-common.h"
+#include "color-convert.h"
+#include "frame-converter.h"
+
+namespace {
+
+// Одне ядро на одному потоці (arg 2: ConvertKernel)
+void BM_ConvertNV12_Kernel(benchmark::State& state) {
+    const int width = (int)state.range(0);
+    const int height = (int)state.range(1);
+    const ConvertKernel kernel = static_cast<ConvertKernel>(state.range(2));
+    if (!IsConvertKernelSupported(kernel)) {
+        state.SkipWithError("Kernel not supported by this CPU");
+        return;
+    }
+    state.SetLabel(GetConvertKernelName(kernel));
+
+    SyntheticFrames frames(width, height, 1);
+    AlignedBuffer nv12((size_t)width * height * 3 / 2);
+    uint8_t* y = nv12.data();
+    uint8_t* uv = y + (size_t)width * height;
+
+    for (auto _ : state) {
+        ConvertBGRAToNV12(frames.Get(0), frames.GetStride(), width, height,
+                          y, width, uv, width,
+                          ColorMatrix::BT601, ColorRange::Limited, kernel);
+        benchmark::DoNotOptimize(nv12.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)frames.GetFrameBytes());
+    state.SetItemsProcessed(state.iterations());
+}
+
+void KernelSizes(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"width", "height", "kernel"});
+    const int sizes[][2] = {{1280, 720}, {1920, 1080}, {2560, 1440}, {3840, 2160}};
+    const ConvertKernel kernels[] = {ConvertKernel::Scalar, ConvertKernel::SSE2, ConvertKernel::AVX2};
+    for (const auto& size : sizes) {
+        for (ConvertKernel kernel : kernels) {
+            b->Args({size[0], size[1], (int64_t)kernel});
+        }
+    }
+}
+
+// Шлях аддону: найкраще ядро, смуги на WorkerPool
+void BM_ConvertNV12_Striped(benchmark::State& state) {
+    const int width = (int)state.range(0);
+    const int height = (int)state.range(1);
+
+    SyntheticFrames frames(width, height, 1);
+    AlignedBuffer nv12((size_t)width * height * 3 / 2);
+    FrameConverter converter;
+    converter.SetWorkerPool(GetBenchWorkerPool());
+
+    for (auto _ : state) {
+        converter.ConvertToNV12(frames.Get(0), frames.GetStride(), width, height,
+                                nv12.data(), width, nv12.data() + (size_t)width * height, width);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)frames.GetFrameBytes());
+    state.SetItemsProcessed(state.iterations());
+    state.counters["threads"] = GetBenchWorkerPool()->GetThreadCount();
+}
+
+// Копіювання з staging текстури: рядок джерела ширший за кадр (row pitch)
+void BM_CopyRows_Pitch(benchmark::State& state) {
+    const int width = (int)state.range(0);
+    const int height = (int)state.range(1);
+    const int row_bytes = width * 4;
+    const int src_pitch = row_bytes + 256;
+
+    AlignedBuffer src((size_t)src_pitch * height);
+    AlignedBuffer dst((size_t)row_bytes * height);
+    memset(src.data(), 0x5A, src.size());
+    FrameConverter copier;
+    copier.SetWorkerPool(GetBenchWorkerPool());
+
+    for (auto _ : state) {
+        copier.CopyRows(src.data(), src_pitch, dst.data(), row_bytes, row_bytes, height);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)row_bytes * height);
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_ConvertNV12_Kernel)->Apply(KernelSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ConvertNV12_Striped)->Apply(FrameSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_CopyRows_Pitch)->Apply(FrameSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,135 @@
+/**
+ * Cursor Benchmarks
+ * Ядра накладання курсора і ціна руху вказівника: окремий канал проти нового
+ * дельта-кадру з курсором у пікселях
+ */
+
+#include "bench-common.h"
+#include "cursor.h"
+#include "cursor-blend.h"
+#include "delta-encoder.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr int kFrameWidth = 1920;
+constexpr int kFrameHeight = 1080;
+
+// Кругла форма з м'яким краєм: і непрозорі, і напівпрозорі, і прозорі пікселі
+CursorShape MakeBenchShape(int size) {
+    std::vector<uint32_t> pixels((size_t)size * size);
+    const double radius = size * 0.5;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            const double dx = x + 0.5 - radius;
+            const double dy = y + 0.5 - radius;
+            const double edge = radius - std::sqrt(dx * dx + dy * dy);
+            const uint32_t alpha = edge <= 0.0 ? 0 : edge >= 2.0 ? 255 : (uint32_t)(edge * 127.5);
+            pixels[(size_t)y * size + x] = (alpha << 24) | ((uint32_t)(x * 255 / size) << 8) | 0x40;
+        }
+    }
+    CursorShape shape;
+    ConvertCursorShape(CursorShapeType::Color, reinterpret_cast<const uint8_t*>(pixels.data()),
+                       size, size, size * 4, size / 2, size / 2, shape);
+    return shape;
+}
+
+// Позиція вказівника на i-му кроці (діагональ по кадру)
+void GetPointerPosition(size_t i, int& x, int& y) {
+    x = (int)((i * 37) % (kFrameWidth - 64));
+    y = (int)((i * 23) % (kFrameHeight - 64));
+}
+
+// Одне ядро (arg 0: розмір форми, arg 1: ConvertKernel)
+void BM_CursorBlend_Kernel(benchmark::State& state) {
+    const int size = (int)state.range(0);
+    const ConvertKernel kernel = static_cast<ConvertKernel>(state.range(1));
+    if (!IsConvertKernelSupported(kernel)) {
+        state.SkipWithError("Kernel not supported by this CPU");
+        return;
+    }
+    state.SetLabel(GetConvertKernelName(kernel));
+
+    const CursorShape shape = MakeBenchShape(size);
+    SyntheticFrames frames(kFrameWidth, kFrameHeight, 1);
+    AlignedBuffer frame(frames.GetFrameBytes());
+    memcpy(frame.data(), frames.Get(0), frames.GetFrameBytes());
+
+    size_t index = 0;
+    for (auto _ : state) {
+        int x = 0;
+        int y = 0;
+        GetPointerPosition(index++, x, y);
+        BlendCursor(frame.data(), frames.GetStride(), kFrameWidth, kFrameHeight, shape, x, y, kernel);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)shape.bgra.size());
+}
+
+void KernelArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"size", "kernel"});
+    const ConvertKernel kernels[] = {ConvertKernel::Scalar, ConvertKernel::SSE2, ConvertKernel::AVX2};
+    for (int size : {32, 64, 128}) {
+        for (ConvertKernel kernel : kernels) {
+            b->Args({size, (int64_t)kernel});
+        }
+    }
+}
+
+// Рух вказівника на статичному екрані. channel:0 - курсор у пікселях: стерти старий,
+// накласти новий і закодувати дельта-кадр. channel:1 - лише повідомлення каналу курсора.
+void BM_CursorMove(benchmark::State& state) {
+    const bool channel = state.range(0) != 0;
+    const CursorShape shape = MakeBenchShape(32);
+    SyntheticFrames frames(kFrameWidth, kFrameHeight, 1, SyntheticScenario::Idle);
+    const int stride = frames.GetStride();
+
+    AlignedBuffer frame(frames.GetFrameBytes());
+    memcpy(frame.data(), frames.Get(0), frames.GetFrameBytes());
+    DeltaEncoder encoder;
+    encoder.Initialize(kFrameWidth, kFrameHeight, 64, 0);
+    AlignedBuffer packet(encoder.GetMaxPacketSize());
+    size_t size = 0;
+    encoder.Encode(frame.data(), stride, packet.data(), packet.size(), size);  // Ключовий кадр - до вимірювання
+
+    CursorTracker tracker;
+    tracker.UpdateShape(CursorShape(shape));
+    char message[160];
+
+    size_t index = 0;
+    int last_x = 0;
+    int last_y = 0;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        int x = 0;
+        int y = 0;
+        GetPointerPosition(index++, x, y);
+        if (channel) {
+            tracker.UpdatePosition(true, x, y);
+            const CursorState cursor = tracker.GetState();
+            size = (size_t)snprintf(message, sizeof(message),
+                "{\"type\":\"cursor\",\"output\":0,\"x\":%d,\"y\":%d,\"visible\":true,\"shapeId\":%u,\"sequence\":%llu}",
+                cursor.x, cursor.y, cursor.shape_id, (unsigned long long)cursor.sequence);
+        } else {
+            // Відновити пікселі під старим курсором, накласти новий
+            for (int row = 0; row < shape.height && last_y + row < kFrameHeight; row++) {
+                const size_t offset = (size_t)(last_y + row) * stride + (size_t)last_x * 4;
+                memcpy(frame.data() + offset, frames.Get(0) + offset, (size_t)shape.width * 4);
+            }
+            BlendCursor(frame.data(), stride, kFrameWidth, kFrameHeight, shape, x, y);
+            encoder.Encode(frame.data(), stride, packet.data(), packet.size(), size);
+        }
+        last_x = x;
+        last_y = y;
+        bytes += (int64_t)size;
+        benchmark::DoNotOptimize(size);
+    }
+    state.counters["bytes_per_move"] = benchmark::Counter((double)bytes / (double)state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_CursorBlend_Kernel)->Apply(KernelArgs);
+BENCHMARK(BM_CursorMove)->ArgName("channel")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,112 @@
+/**
+ * Frame Diff Benchmarks
+ * Порівняння плиток і дельта-пакети на статичному та змінному вмісті, перемикання вікон
+ * з кешем плиток і без
+ */
+
+#include "bench-common.h"
+#include "delta-encoder.h"
+#include "tile-diff.h"
+
+namespace {
+
+constexpr int kFrameCount = 8;
+
+// Екран без змін - найгірший випадок порівняння (кожна плитка перевіряється повністю)
+void BM_TileDiff_Static(benchmark::State& state) {
+    const int width = (int)state.range(0);
+    const int height = (int)state.range(1);
+
+    SyntheticFrames frames(width, height, 1, SyntheticScenario::Idle);
+    TileDiff diff;
+    diff.Initialize(width, height, 64);
+    std::vector<uint8_t> dirty;
+    diff.Compare(frames.Get(0), frames.GetStride(), dirty);
+
+    for (auto _ : state) {
+        int changed = diff.Compare(frames.Get(0), frames.GetStride(), dirty);
+        benchmark::DoNotOptimize(changed);
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)frames.GetFrameBytes());
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Прокрутка тексту (перша фаза Mixed): частина плиток змінюється кожен кадр
+void BM_TileDiff_Changing(benchmark::State& state) {
+    const int width = (int)state.range(0);
+    const int height = (int)state.range(1);
+
+    SyntheticFrames frames(width, height, kFrameCount, SyntheticScenario::Mixed);
+    TileDiff diff;
+    diff.Initialize(width, height, 64);
+    std::vector<uint8_t> dirty;
+
+    size_t index = 0;
+    int64_t tiles = 0;
+    for (auto _ : state) {
+        tiles += diff.Compare(frames.Get(index++), frames.GetStride(), dirty);
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)frames.GetFrameBytes());
+    state.SetItemsProcessed(state.iterations());
+    state.counters["dirty_tiles"] = benchmark::Counter((double)tiles, benchmark::Counter::kAvgIterations);
+}
+
+// Повний delta кодек (diff + пакування змінених плиток)
+void BM_DeltaEncode(benchmark::State& state) {
+    const int width = (int)state.range(0);
+    const int height = (int)state.range(1);
+
+    SyntheticFrames frames(width, height, kFrameCount, SyntheticScenario::Mixed);
+    DeltaEncoder encoder;
+    encoder.Initialize(width, height, 64, 0);
+    AlignedBuffer packet(encoder.GetMaxPacketSize());
+
+    size_t index = 0;
+    int64_t bytes_out = 0;
+    for (auto _ : state) {
+        size_t size = 0;
+        encoder.Encode(frames.Get(index++), frames.GetStride(), packet.data(), packet.size(), size);
+        bytes_out += (int64_t)size;
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)frames.GetFrameBytes());
+    state.SetItemsProcessed(state.iterations());
+    state.counters["packet_bytes"] = benchmark::Counter((double)bytes_out, benchmark::Counter::kAvgIterations);
+}
+
+// Перемикання між двома вікнами щокадру (1080p). cache:0 - кожне перемикання
+// передає всі змінені плитки, cache:1 - плитки, що вже були, передаються посиланнями.
+void BM_DeltaWindowSwitch(benchmark::State& state) {
+    const bool cache = state.range(0) != 0;
+    const int width = 1920;
+    const int height = 1080;
+
+    // Перші кадри сценаріїв однакові - вікна беруться після кількох кроків
+    SyntheticFrames editor(width, height, 3, SyntheticScenario::Text);
+    SyntheticFrames player(width, height, 8, SyntheticScenario::Video);
+    const uint8_t* windows[] = {editor.Get(2), player.Get(7)};
+    DeltaEncoder encoder;
+    encoder.Initialize(width, height, 64, 0, false, cache ? 32u << 20 : 0);
+    AlignedBuffer packet(encoder.GetMaxPacketSize());
+    memset(packet.data(), 0, packet.size());
+    size_t size = 0;
+    // Обидва вікна вже показані до вимірювання
+    encoder.Encode(windows[0], editor.GetStride(), packet.data(), packet.size(), size);
+    encoder.Encode(windows[1], editor.GetStride(), packet.data(), packet.size(), size);
+
+    size_t index = 0;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        encoder.Encode(windows[index++ & 1], editor.GetStride(), packet.data(), packet.size(), size);
+        bytes += (int64_t)size;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["bytes_per_frame"] = benchmark::Counter((double)bytes, benchmark::Counter::kAvgIterations);
+    state.counters["cache_hits"] = (double)encoder.GetLastTileCacheStats().hits;
+}
+
+} // namespace
+
+BENCHMARK(BM_TileDiff_Static)->Apply(FrameSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TileDiff_Changing)->Apply(FrameSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DeltaEncode)->Apply(FrameSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DeltaWindowSwitch)->ArgName("cache")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
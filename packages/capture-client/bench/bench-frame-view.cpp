@@ -0,0 +1,134 @@
+/**
+ * Frame View Benchmarks
+ * Регіон 800x600 з 4K проти всього кадру і кодування з view проти копії у width*4
+ */
+
+#include "bench-common.h"
+#include "delta-encoder.h"
+#include "frame-view.h"
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+#include "jpeg-encoder.h"
+#endif
+
+namespace {
+
+constexpr int kFrameCount = 8;
+constexpr int kDesktopWidth = 3840;
+constexpr int kDesktopHeight = 2160;
+// Вікно застосунку 800x600 у відео-області синтетичного 4K робочого столу
+constexpr int kRegionX = 2304;
+constexpr int kRegionY = 324;
+constexpr int kRegionWidth = 800;
+constexpr int kRegionHeight = 600;
+
+void RegionArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"region"});
+    b->Arg(0);
+    b->Arg(1);
+}
+
+// View на кадр 4K з pitch робочого столу, як відображена staging texture
+FrameView MakeView(const SyntheticFrames& frames, size_t index, bool region) {
+    FrameView view;
+    view.data = frames.Get(index);
+    view.stride = frames.GetStride();
+    view.width = kDesktopWidth;
+    view.height = kDesktopHeight;
+    view.crop.width = kDesktopWidth;
+    view.crop.height = kDesktopHeight;
+    if (!region) {
+        return view;
+    }
+    FrameRect rect;
+    rect.x = kRegionX;
+    rect.y = kRegionY;
+    rect.width = kRegionWidth;
+    rect.height = kRegionHeight;
+    return view.Crop(rect);
+}
+
+const SyntheticFrames& GetDesktopFrames() {
+    static SyntheticFrames frames(kDesktopWidth, kDesktopHeight, kFrameCount, SyntheticScenario::Video);
+    return frames;
+}
+
+// Дельта-кодек прямо з view: регіон коштує пропорційно своїй площі
+void BM_Region_DeltaEncode(benchmark::State& state) {
+    const bool region = state.range(0) != 0;
+    const SyntheticFrames& frames = GetDesktopFrames();
+    const FrameView first = MakeView(frames, 0, region);
+
+    DeltaEncoder encoder;
+    encoder.Initialize(first.width, first.height, 64, 0);
+    AlignedBuffer packet(encoder.GetMaxPacketSize());
+
+    size_t index = 0;
+    for (auto _ : state) {
+        FrameView view = MakeView(frames, index++, region);
+        size_t size = 0;
+        encoder.Encode(view.data, view.stride, packet.data(), packet.size(), size);
+        benchmark::DoNotOptimize(size);
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)first.width * first.height * 4);
+    state.counters["fps"] = benchmark::Counter((double)state.iterations(), benchmark::Counter::kIsRate);
+}
+
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+void BM_Region_JpegEncode(benchmark::State& state) {
+    const bool region = state.range(0) != 0;
+    const SyntheticFrames& frames = GetDesktopFrames();
+    const FrameView first = MakeView(frames, 0, region);
+
+    JpegEncoder encoder;
+    encoder.SetWorkerPool(GetBenchWorkerPool());
+    encoder.Initialize(first.width, first.height, 80, true);
+    AlignedBuffer packet(encoder.GetMaxOutputSize());
+
+    size_t index = 0;
+    for (auto _ : state) {
+        FrameView view = MakeView(frames, index++, region);
+        size_t size = 0;
+        encoder.Encode(view.data, view.stride, packet.data(), packet.size(), size);
+        benchmark::DoNotOptimize(size);
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)first.width * first.height * 4);
+    state.counters["fps"] = benchmark::Counter((double)state.iterations(), benchmark::Counter::kIsRate);
+}
+#endif
+
+// Кодування з view проти попереднього шляху: копія рядків у щільний буфер, потім кодек
+void BM_FrameView_DeltaEncode(benchmark::State& state) {
+    const bool copy = state.range(0) != 0;
+    const SyntheticFrames& frames = GetDesktopFrames();
+
+    DeltaEncoder encoder;
+    encoder.Initialize(kDesktopWidth, kDesktopHeight, 64, 0);
+    AlignedBuffer packet(encoder.GetMaxPacketSize());
+    AlignedBuffer packed((size_t)kDesktopWidth * kDesktopHeight * 4);
+    memset(packed.data(), 0, packed.size());     // Сторінки - до вимірювання, не в першій ітерації
+
+    size_t index = 0;
+    for (auto _ : state) {
+        FrameView view = MakeView(frames, index++, false);
+        const uint8_t* input = view.data;
+        int stride = view.stride;
+        if (copy) {
+            CopyFrameView(view, packed.data(), kDesktopWidth * 4);
+            input = packed.data();
+            stride = kDesktopWidth * 4;
+        }
+        size_t size = 0;
+        encoder.Encode(input, stride, packet.data(), packet.size(), size);
+        benchmark::DoNotOptimize(size);
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)frames.GetFrameBytes());
+    state.counters["fps"] = benchmark::Counter((double)state.iterations(), benchmark::Counter::kIsRate);
+}
+
+} // namespace
+
+BENCHMARK(BM_Region_DeltaEncode)->Apply(RegionArgs)->Unit(benchmark::kMillisecond);
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+BENCHMARK(BM_Region_JpegEncode)->Apply(RegionArgs)->Unit(benchmark::kMillisecond);
+#endif
+BENCHMARK(BM_FrameView_DeltaEncode)->ArgName("copy")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
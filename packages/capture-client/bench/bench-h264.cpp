@@ -0,0 +1,144 @@
+/**
+ * H.264 (x264) Benchmarks
+ * Затримка кодування кадру (zerolatency, як у аддоні) і вартість IDR за запитом
+ * (ForceKeyframe - новий глядач або відкинутий кадр). Лише якщо pkg-config знайшов x264.
+ */
+
+#include "bench-common.h"
+#include "color-convert.h"
+#include "x264-encoder.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+const char* const kPresets[] = { "ultrafast", "veryfast", "faster" };
+
+void H264Sizes(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"width", "height", "preset"});
+    const int sizes[][2] = {{1280, 720}, {1920, 1080}, {2560, 1440}};
+    for (int preset = 0; preset < 3; preset++) {
+        for (const auto& size : sizes) {
+            b->Args({size[0], size[1], preset});
+        }
+    }
+}
+
+// Кадри синтетичного відео в NV12 - бенчмарк міряє лише x264
+class NV12Frames {
+public:
+    NV12Frames(int width, int height, int count) : frames_(count) {
+        SyntheticFrames source(width, height, count, SyntheticScenario::Video);
+        const size_t y_size = (size_t)width * height;
+        for (int i = 0; i < count; i++) {
+            frames_[i].Resize(y_size * 3 / 2);
+            ConvertBGRAToNV12(source.Get(i), source.GetStride(), width, height,
+                              frames_[i].data(), width, frames_[i].data() + y_size, width);
+        }
+    }
+
+    const uint8_t* Get(size_t index) const { return frames_[index % frames_.size()].data(); }
+
+private:
+    std::vector<AlignedBuffer> frames_;
+};
+
+bool SetUpEncoder(benchmark::State& state, X264Encoder& encoder, AlignedBuffer& out, int keyframe_interval) {
+    VideoEncoderConfig config;
+    config.width = (int)state.range(0);
+    config.height = (int)state.range(1);
+    config.preset = kPresets[state.range(2)];
+    config.bitrate = 8000000;
+    config.keyframe_interval = keyframe_interval;
+    if (!encoder.Initialize(config) || !out.Resize(encoder.GetNV12Size() * 2)) {
+        state.SkipWithError(encoder.GetLastError().c_str());
+        return false;
+    }
+    state.SetLabel(config.preset);
+    return true;
+}
+
+double Percentile(std::vector<double>& samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    const size_t index = std::min(samples.size() - 1, (size_t)(p * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+// Затримка одного кадру: від подачі NV12 до готового Annex-B пакета
+void BM_X264_EncodeLatency(benchmark::State& state) {
+    X264Encoder encoder;
+    AlignedBuffer out;
+    if (!SetUpEncoder(state, encoder, out, 300)) {
+        return;
+    }
+    NV12Frames frames((int)state.range(0), (int)state.range(1), 30);
+
+    std::vector<double> latency_ms;
+    int64_t bytes = 0;
+    size_t index = 0;
+    for (auto _ : state) {
+        size_t size = 0;
+        const auto start = std::chrono::steady_clock::now();
+        if (!encoder.EncodeNV12(frames.Get(index++), out.data(), out.size(), size)) {
+            state.SkipWithError(encoder.GetLastError().c_str());
+            return;
+        }
+        latency_ms.push_back(std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count());
+        bytes += (int64_t)size;
+    }
+    state.counters["fps"] = benchmark::Counter((double)state.iterations(), benchmark::Counter::kIsRate);
+    state.counters["frame_bytes"] = benchmark::Counter((double)bytes, benchmark::Counter::kAvgIterations);
+    state.counters["p50_ms"] = Percentile(latency_ms, 0.5);
+    state.counters["p99_ms"] = Percentile(latency_ms, 0.99);
+}
+
+// IDR за запитом кожні 30 кадрів (без інтервалу keyframe): розмір і затримка IDR
+// проти P-кадрів - скільки коштує requestKeyframe / відкинутий кадр циклу
+void BM_X264_ForcedIdr(benchmark::State& state) {
+    X264Encoder encoder;
+    AlignedBuffer out;
+    if (!SetUpEncoder(state, encoder, out, 0)) {
+        return;
+    }
+    NV12Frames frames((int)state.range(0), (int)state.range(1), 30);
+
+    std::vector<double> idr_ms;
+    int64_t idr_bytes = 0;
+    int64_t p_bytes = 0;
+    int64_t p_frames = 0;
+    size_t index = 0;
+    for (auto _ : state) {
+        if (index % 30 == 29) {
+            encoder.ForceKeyframe();
+        }
+        size_t size = 0;
+        const auto start = std::chrono::steady_clock::now();
+        if (!encoder.EncodeNV12(frames.Get(index++), out.data(), out.size(), size)) {
+            state.SkipWithError(encoder.GetLastError().c_str());
+            return;
+        }
+        const double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        if (encoder.IsLastKeyframe()) {
+            idr_ms.push_back(ms);
+            idr_bytes += (int64_t)size;
+        } else {
+            p_bytes += (int64_t)size;
+            p_frames++;
+        }
+    }
+    const double idrs = (double)idr_ms.size();
+    state.counters["idr_frames"] = idrs;
+    state.counters["idr_bytes"] = idrs > 0 ? (double)idr_bytes / idrs : 0.0;
+    state.counters["p_bytes"] = p_frames > 0 ? (double)p_bytes / (double)p_frames : 0.0;
+    state.counters["idr_p50_ms"] = Percentile(idr_ms, 0.5);
+}
+
+} // namespace
+
+BENCHMARK(BM_X264_EncodeLatency)->Apply(H264Sizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_X264_ForcedIdr)->Apply(H264Sizes)->Unit(benchmark::kMillisecond)->UseRealTime();
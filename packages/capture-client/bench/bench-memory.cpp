@@ -0,0 +1,88 @@
+/**
+ * Buffer Benchmarks
+ * Пул вирівняних буферів і арена проти виділення пам'яті на кожен кадр
+ */
+
+#include "bench-common.h"
+#include "buffer-arena.h"
+#include "frame-pool.h"
+
+namespace {
+
+// Буфер з пулу: сторінки вже відображені, запис кадру без page fault
+void BM_FrameBuffer_Pooled(benchmark::State& state) {
+    const size_t bytes = (size_t)state.range(0) * state.range(1) * 4;
+    std::shared_ptr<FramePool> pool = FramePool::Create(bytes, 4);
+    if (!pool) {
+        state.SkipWithError("Failed to create frame pool");
+        return;
+    }
+
+    for (auto _ : state) {
+        uint8_t* buffer = pool->Acquire();
+        memset(buffer, 0x7F, bytes);
+        benchmark::DoNotOptimize(buffer);
+        pool->Release(buffer);
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)bytes);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Новий буфер на кожен кадр (як Napi::Buffer::Copy): malloc + page fault при записі
+void BM_FrameBuffer_Allocated(benchmark::State& state) {
+    const size_t bytes = (size_t)state.range(0) * state.range(1) * 4;
+
+    for (auto _ : state) {
+        void* buffer = AlignedAlloc(bytes);
+        memset(buffer, 0x7F, bytes);
+        benchmark::DoNotOptimize(buffer);
+        AlignedFree(buffer);
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)bytes);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Тимчасовий буфер з арени (AlignedBuffer): блок класу береться з вільного списку
+void BM_FrameBuffer_Arena(benchmark::State& state) {
+    const size_t bytes = (size_t)state.range(0) * state.range(1) * 4;
+
+    for (auto _ : state) {
+        AlignedBuffer buffer(bytes);
+        memset(buffer.data(), 0x7F, bytes);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)bytes);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Облік арени для дрібних об'єктів на кадр (власники Buffer, кадри GOP кешу) проти new/delete
+void BM_Arena_SmallBlock(benchmark::State& state) {
+    BufferArena& arena = GetBufferArena();
+
+    for (auto _ : state) {
+        void* block = arena.Allocate(64);
+        benchmark::DoNotOptimize(block);
+        arena.Free(block);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Лише облік пулу (mutex + free list) - накладні витрати передачі кадру в JS
+void BM_FramePool_AcquireRelease(benchmark::State& state) {
+    std::shared_ptr<FramePool> pool = FramePool::Create(4096, 8);
+
+    for (auto _ : state) {
+        uint8_t* buffer = pool->Acquire();
+        benchmark::DoNotOptimize(buffer);
+        pool->Release(buffer);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_FrameBuffer_Pooled)->Apply(FrameSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FrameBuffer_Allocated)->Apply(FrameSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FrameBuffer_Arena)->Apply(FrameSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Arena_SmallBlock);
+BENCHMARK(BM_FramePool_AcquireRelease);
@@ -0,0 +1,69 @@
+/**
+ * Motion Detection Benchmarks
+ * Пошук прокрутки за хешами рядків і дельта-пакети прокрутки з переміщеннями та без
+ */
+
+#include "bench-common.h"
+#include "delta-encoder.h"
+#include "motion-detector.h"
+
+namespace {
+
+constexpr int kFrameCount = 16;
+
+// Хешування кадру + пошук зсувів (прокрутка тексту кожен кадр)
+void BM_MotionAnalyze(benchmark::State& state) {
+    const int width = (int)state.range(0);
+    const int height = (int)state.range(1);
+
+    SyntheticFrames frames(width, height, kFrameCount, SyntheticScenario::Text);
+    MotionDetector detector;
+    detector.Initialize(width, height);
+    std::vector<MoveRect> moves;
+    detector.Analyze(frames.Get(0), frames.GetStride(), moves);
+
+    size_t index = 1;
+    int64_t found = 0;
+    for (auto _ : state) {
+        found += detector.Analyze(frames.Get(index++), frames.GetStride(), moves);
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)frames.GetFrameBytes());
+    state.counters["moves"] = benchmark::Counter((double)found, benchmark::Counter::kAvgIterations);
+}
+
+// Дельта-кадр прокрутки: motion:0 - зсунутий текст плитками, motion:1 - переміщення + залишок
+void BM_DeltaScroll(benchmark::State& state) {
+    const bool motion = state.range(0) != 0;
+    const int width = 1920;
+    const int height = 1080;
+
+    SyntheticFrames frames(width, height, kFrameCount, SyntheticScenario::Text);
+    DeltaEncoder encoder;
+    encoder.Initialize(width, height, 64, 0, motion);
+    AlignedBuffer packet(encoder.GetMaxPacketSize());
+    memset(packet.data(), 0, packet.size());
+    size_t size = 0;
+    encoder.Encode(frames.Get(0), frames.GetStride(), packet.data(), packet.size(), size);
+
+    size_t index = 1;
+    int64_t bytes = 0;
+    int64_t tiles = 0;
+    for (auto _ : state) {
+        encoder.Encode(frames.Get(index++), frames.GetStride(), packet.data(), packet.size(), size);
+        bytes += (int64_t)size;
+        tiles += encoder.GetLastTileCount();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["bytes_per_frame"] = benchmark::Counter((double)bytes, benchmark::Counter::kAvgIterations);
+    state.counters["dirty_tiles"] = benchmark::Counter((double)tiles, benchmark::Counter::kAvgIterations);
+}
+
+} // namespace
+
+BENCHMARK(BM_MotionAnalyze)
+    ->ArgNames({"width", "height"})
+    ->Args({1280, 720})
+    ->Args({1920, 1080})
+    ->Args({3840, 2160})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DeltaScroll)->ArgName("motion")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,116 @@
+/**
+ * Multi-Output Benchmarks
+ * Кілька синтетичних моніторів: окремий конвеєр на вихід і склеєне полотно
+ */
+
+#include "bench-common.h"
+#include "delta-encoder.h"
+#include "multi-output-capture.h"
+#include <atomic>
+#include <thread>
+
+namespace {
+
+constexpr int kOutputWidth = 1920;
+constexpr int kOutputHeight = 1080;
+constexpr int kFramesPerRun = 8;    // Кадрів на вихід за ітерацію (окупає запуск потоків)
+
+void OutputCounts(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"outputs"});
+    for (int outputs = 1; outputs <= 4; outputs++) {
+        b->Arg(outputs);
+    }
+}
+
+// Сесія одного виходу як у module.cpp: власне джерело, кодек і буфер захоплення
+struct OutputSession {
+    std::unique_ptr<SyntheticCapture> source;
+    DeltaEncoder encoder;
+    AlignedBuffer capture;
+    AlignedBuffer packet;
+};
+
+// Кожен вихід захоплює і кодує на власному потоці - масштабування за ядрами
+void BM_MultiOutput_Parallel(benchmark::State& state) {
+    const int output_count = (int)state.range(0);
+    const int stride = kOutputWidth * 4;
+
+    std::vector<std::unique_ptr<OutputSession>> sessions;
+    for (int i = 0; i < output_count; i++) {
+        std::unique_ptr<OutputSession> session(new OutputSession());
+        session->source.reset(new SyntheticCapture(SyntheticScenario::Video, 0, 1 + (uint32_t)i));
+        if (!session->source->Initialize(kOutputWidth, kOutputHeight) ||
+            !session->encoder.Initialize(kOutputWidth, kOutputHeight, 64, 300) ||
+            !session->capture.Resize((size_t)stride * kOutputHeight) ||
+            !session->packet.Resize(session->encoder.GetMaxPacketSize())) {
+            state.SkipWithError("Failed to initialize output session");
+            return;
+        }
+        sessions.push_back(std::move(session));
+    }
+
+    std::atomic<int64_t> bytes_out{0};
+    auto run_output = [&](OutputSession& session) {
+        int64_t bytes = 0;
+        for (int frame = 0; frame < kFramesPerRun; frame++) {
+            session.source->CaptureFrame(session.capture.data(), stride);
+            size_t size = 0;
+            session.encoder.Encode(session.capture.data(), stride, session.packet.data(),
+                                   session.packet.size(), size);
+            bytes += (int64_t)size;
+        }
+        bytes_out += bytes;
+    };
+
+    for (auto _ : state) {
+        std::vector<std::thread> threads;
+        for (int i = 1; i < output_count; i++) {
+            threads.emplace_back(run_output, std::ref(*sessions[i]));
+        }
+        run_output(*sessions[0]);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    const double frames = (double)state.iterations() * kFramesPerRun;
+    state.counters["fps"] = benchmark::Counter(frames * output_count, benchmark::Counter::kIsRate);
+    state.counters["fps_per_output"] = benchmark::Counter(frames, benchmark::Counter::kIsRate);
+    state.counters["frame_bytes"] = benchmark::Counter(
+        (double)bytes_out.load() / (output_count * kFramesPerRun), benchmark::Counter::kAvgIterations);
+}
+
+// Склеєне полотно: виходи захоплюються паралельно прямо у свої прямокутники,
+// копія в кадр - смугами виходів
+void BM_MultiOutput_Stitched(benchmark::State& state) {
+    const int output_count = (int)state.range(0);
+
+    std::vector<CaptureOutputInfo> outputs;
+    SyntheticCapture::EnumerateOutputs(output_count, outputs);
+
+    MultiOutputCapture capture;
+    for (const CaptureOutputInfo& info : outputs) {
+        std::unique_ptr<CaptureSource> source(
+            new SyntheticCapture(SyntheticScenario::Video, 0, 1 + (uint32_t)info.index));
+        capture.AddOutput(std::move(source), info);
+    }
+    if (!capture.Initialize()) {
+        state.SkipWithError(capture.GetLastError().c_str());
+        return;
+    }
+
+    const int stride = capture.GetWidth() * 4;
+    AlignedBuffer frame((size_t)stride * capture.GetHeight());
+    for (auto _ : state) {
+        capture.CaptureFrame(frame.data(), stride);
+        benchmark::DoNotOptimize(frame.data());
+    }
+
+    state.SetBytesProcessed((int64_t)state.iterations() * (int64_t)frame.size());
+    state.counters["fps"] = benchmark::Counter((double)state.iterations(), benchmark::Counter::kIsRate);
+}
+
+} // namespace
+
+BENCHMARK(BM_MultiOutput_Parallel)->Apply(OutputCounts)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_MultiOutput_Stitched)->Apply(OutputCounts)->Unit(benchmark::kMillisecond)->UseRealTime();
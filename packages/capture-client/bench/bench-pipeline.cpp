@@ -0,0 +1,170 @@
+/**
+ * End-to-End Benchmarks
+ * Кадри/с від синтетичного джерела до закодованого кадру: послідовно та конвеєром
+ */
+
+#include "bench-common.h"
+#include "delta-encoder.h"
+#include "frame-pipeline.h"
+#include <atomic>
+#include <thread>
+
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+#include "jpeg-encoder.h"
+#endif
+
+namespace {
+
+enum BenchCodec {
+    kCodecDelta = 0,
+    kCodecJpeg = 1
+};
+
+// Кодек як у module.cpp: encode з BGRA у вихідний буфер
+class BenchEncoder {
+public:
+    bool Initialize(int codec, int width, int height) {
+        codec_ = codec;
+        if (codec == kCodecDelta) {
+            if (!delta_.Initialize(width, height, 64, 300)) {
+                return false;
+            }
+            return out_.Resize(delta_.GetMaxPacketSize());
+        }
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+        jpeg_.SetWorkerPool(GetBenchWorkerPool());
+        if (!jpeg_.Initialize(width, height, 80, true)) {
+            return false;
+        }
+        return out_.Resize(jpeg_.GetMaxOutputSize());
+#else
+        return false;
+#endif
+    }
+
+    size_t Encode(const uint8_t* bgra, int stride) {
+        size_t size = 0;
+        if (codec_ == kCodecDelta) {
+            delta_.Encode(bgra, stride, out_.data(), out_.size(), size);
+        }
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+        else {
+            jpeg_.Encode(bgra, stride, out_.data(), out_.size(), size);
+        }
+#endif
+        return size;
+    }
+
+    static const char* GetName(int codec) { return codec == kCodecDelta ? "delta" : "jpeg"; }
+
+private:
+    int codec_ = kCodecDelta;
+    DeltaEncoder delta_;
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+    JpegEncoder jpeg_;
+#endif
+    AlignedBuffer out_;
+};
+
+void CodecSizes(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"width", "height", "codec"});
+    const int sizes[][2] = {{1280, 720}, {1920, 1080}, {2560, 1440}, {3840, 2160}};
+    for (int codec : {kCodecDelta, kCodecJpeg}) {
+        for (const auto& size : sizes) {
+            b->Args({size[0], size[1], codec});
+        }
+    }
+}
+
+bool SetUpSource(benchmark::State& state, SyntheticCapture& source, BenchEncoder& encoder) {
+    const int width = (int)state.range(0);
+    const int height = (int)state.range(1);
+    const int codec = (int)state.range(2);
+
+    // Відео-сценарій: новий вміст на кожен виклик, без темпу (fps = 0)
+    source.SetWorkerPool(GetBenchWorkerPool());
+    if (!source.Initialize(width, height)) {
+        state.SkipWithError(source.GetLastError().c_str());
+        return false;
+    }
+    if (!encoder.Initialize(codec, width, height)) {
+        state.SkipWithError("Codec not available in this build");
+        return false;
+    }
+    state.SetLabel(BenchEncoder::GetName(codec));
+    return true;
+}
+
+// Захоплення і кодування на одному потоці (captureFrame без циклу)
+void BM_EndToEnd_Serial(benchmark::State& state) {
+    SyntheticCapture source(SyntheticScenario::Video, 0, 1);
+    BenchEncoder encoder;
+    if (!SetUpSource(state, source, encoder)) {
+        return;
+    }
+
+    const int stride = source.GetWidth() * 4;
+    AlignedBuffer capture((size_t)stride * source.GetHeight());
+    int64_t bytes_out = 0;
+
+    for (auto _ : state) {
+        source.CaptureFrame(capture.data(), stride);
+        bytes_out += (int64_t)encoder.Encode(capture.data(), stride);
+    }
+    state.counters["fps"] = benchmark::Counter((double)state.iterations(), benchmark::Counter::kIsRate);
+    state.counters["frame_bytes"] = benchmark::Counter((double)bytes_out, benchmark::Counter::kAvgIterations);
+}
+
+// Джерело на потоці бенчмарку, кодування - стадією FramePipeline (як startCaptureLoop)
+void BM_EndToEnd_Pipeline(benchmark::State& state) {
+    SyntheticCapture source(SyntheticScenario::Video, 0, 1);
+    BenchEncoder encoder;
+    if (!SetUpSource(state, source, encoder)) {
+        return;
+    }
+
+    const int stride = source.GetWidth() * 4;
+    std::atomic<int64_t> completed{0};
+    std::atomic<int64_t> bytes_out{0};
+
+    std::vector<FramePipeline::Stage> stages;
+    stages.push_back({"encode", [&](PipelineFrame& frame) {
+        bytes_out += (int64_t)encoder.Encode(frame.capture.data(), stride);
+        return true;
+    }});
+
+    FramePipeline pipeline;
+    if (!pipeline.Start(3, (size_t)stride * source.GetHeight(), 0, stages,
+                        [&](PipelineFrame&) { completed++; })) {
+        state.SkipWithError(pipeline.GetLastError().c_str());
+        return;
+    }
+
+    int64_t submitted = 0;
+    for (auto _ : state) {
+        PipelineFrame* frame = pipeline.AcquireSlot();
+        while (!frame) {
+            std::this_thread::yield();
+            frame = pipeline.AcquireSlot();
+        }
+        source.CaptureFrame(frame->capture.data(), stride);
+        pipeline.Submit(frame);
+        submitted++;
+    }
+
+    // Дочекатися кадрів, що ще в стадіях
+    while (completed.load() < submitted) {
+        std::this_thread::yield();
+    }
+    pipeline.Stop();
+
+    state.counters["fps"] = benchmark::Counter((double)submitted, benchmark::Counter::kIsRate);
+    state.counters["frame_bytes"] = benchmark::Counter((double)bytes_out.load(),
+                                                       benchmark::Counter::kAvgIterations);
+    state.counters["source_stalls"] = (double)pipeline.GetStats().source_stalls;
+}
+
+} // namespace
+
+BENCHMARK(BM_EndToEnd_Serial)->Apply(CodecSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_EndToEnd_Pipeline)->Apply(CodecSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,83 @@
+/**
+ * Image Quality Benchmarks
+ * PSNR / SSIM кадру 1080p (ядра) - вартість метрик у quality_eval
+ */
+
+#include "bench-common.h"
+#include "image-quality.h"
+
+namespace {
+
+constexpr int kFrameWidth = 1920;
+constexpr int kFrameHeight = 1080;
+
+// Повний QualityMeter::Measure: BGR PSNR, яскравість, SSIM (arg: ConvertKernel)
+void BM_QualityMeter_Kernel(benchmark::State& state) {
+    const ConvertKernel kernel = static_cast<ConvertKernel>(state.range(0));
+    if (!IsConvertKernelSupported(kernel)) {
+        state.SkipWithError("Kernel not supported by this CPU");
+        return;
+    }
+    state.SetLabel(GetConvertKernelName(kernel));
+
+    // Сусідні кадри відео-сцени - реалістична (ненульова) різниця
+    SyntheticFrames frames(kFrameWidth, kFrameHeight, 8, SyntheticScenario::Video);
+    QualityMeter meter(kernel);
+    QualityScores scores;
+
+    for (auto _ : state) {
+        meter.Measure(frames.Get(6), frames.GetStride(), frames.Get(7), frames.GetStride(),
+                      kFrameWidth, kFrameHeight, scores);
+        benchmark::DoNotOptimize(scores);
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)frames.GetFrameBytes() * 2);
+    state.counters["ssim"] = scores.ssim;
+}
+
+// Лише ядро SSIM: усі вікна 8x8 з кроком 4 площини яскравості 1080p
+void BM_SsimSums_Kernel(benchmark::State& state) {
+    const ConvertKernel kernel = static_cast<ConvertKernel>(state.range(0));
+    if (!IsConvertKernelSupported(kernel)) {
+        state.SkipWithError("Kernel not supported by this CPU");
+        return;
+    }
+    state.SetLabel(GetConvertKernelName(kernel));
+
+    const SsimSumsFunc ssim_sums = GetSsimSumsFunc(kernel);
+    std::vector<uint8_t> a((size_t)kFrameWidth * kFrameHeight);
+    std::vector<uint8_t> b(a.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        a[i] = (uint8_t)(i * 7 + (i >> 11));
+        b[i] = (uint8_t)(a[i] + (i % 5));
+    }
+
+    uint32_t sums[5];
+    uint64_t checksum = 0;
+    for (auto _ : state) {
+        for (int y = 0; y + QualityMeter::kSsimWindow <= kFrameHeight; y += QualityMeter::kSsimStep) {
+            for (int x = 0; x + QualityMeter::kSsimWindow <= kFrameWidth; x += QualityMeter::kSsimStep) {
+                const size_t offset = (size_t)y * kFrameWidth + x;
+                ssim_sums(a.data() + offset, kFrameWidth, b.data() + offset, kFrameWidth, sums);
+                checksum += sums[4];
+            }
+        }
+    }
+    benchmark::DoNotOptimize(checksum);
+    state.SetBytesProcessed(state.iterations() * (int64_t)a.size() * 2);
+}
+
+} // namespace
+
+BENCHMARK(BM_QualityMeter_Kernel)
+    ->ArgName("kernel")
+    ->Arg((int64_t)ConvertKernel::Scalar)
+    ->Arg((int64_t)ConvertKernel::SSE2)
+    ->Arg((int64_t)ConvertKernel::AVX2)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_SsimSums_Kernel)
+    ->ArgName("kernel")
+    ->Arg((int64_t)ConvertKernel::Scalar)
+    ->Arg((int64_t)ConvertKernel::SSE2)
+    ->Arg((int64_t)ConvertKernel::AVX2)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,93 @@
+/**
+ * Replay Benchmarks
+ * Відтворення запису якнайшвидше: view у відображений файл проти копії, повний і дельта-запис
+ */
+
+#include "bench-common.h"
+#include "capture-recording.h"
+#include "replay-capture.h"
+#include <cstdio>
+#include <string>
+
+namespace {
+
+constexpr int kWidth = 1920;
+constexpr int kHeight = 1080;
+constexpr int kRecordedFrames = 60;     // Повний запис 1080p - ~500 МБ
+
+// Тимчасовий запис синтетичного mixed (видаляється разом з об'єктом)
+class BenchRecording {
+public:
+    explicit BenchRecording(bool delta)
+        : path_(delta ? "capture-bench-delta.crec" : "capture-bench-full.crec") {
+        std::unique_ptr<CaptureSource> source(new SyntheticCapture(SyntheticScenario::Mixed, 0, 1));
+        RecordingCapture recording(std::move(source), path_, delta);
+        if (!recording.Initialize(kWidth, kHeight)) {
+            error_ = recording.GetLastError();
+            return;
+        }
+        AlignedBuffer frame((size_t)kWidth * 4 * kHeight);
+        for (int i = 0; i < kRecordedFrames; i++) {
+            recording.CaptureFrame(frame.data(), kWidth * 4);
+        }
+        file_bytes_ = recording.GetRecorderStats().bytes;
+        recording.Cleanup();
+        if (!recording.GetLastError().empty()) {
+            error_ = recording.GetLastError();
+        }
+    }
+    ~BenchRecording() { std::remove(path_.c_str()); }
+
+    const std::string& GetPath() const { return path_; }
+    const std::string& GetError() const { return error_; }
+    uint64_t GetFileBytes() const { return file_bytes_; }
+
+private:
+    std::string path_;
+    std::string error_;
+    uint64_t file_bytes_ = 0;
+};
+
+// Аргументи: delta - дельта-запис; copy - CaptureFrame у буфер замість view
+void BM_Replay_Acquire(benchmark::State& state) {
+    const bool delta = state.range(0) != 0;
+    const bool copy = state.range(1) != 0;
+
+    BenchRecording recording(delta);
+    if (!recording.GetError().empty()) {
+        state.SkipWithError(recording.GetError().c_str());
+        return;
+    }
+    ReplayCapture replay(recording.GetPath(), false, true);
+    if (!replay.Initialize()) {
+        state.SkipWithError(replay.GetLastError().c_str());
+        return;
+    }
+
+    const int stride = kWidth * 4;
+    AlignedBuffer frame((size_t)stride * kHeight);
+    for (auto _ : state) {
+        if (copy) {
+            replay.CaptureFrame(frame.data(), stride);
+            benchmark::DoNotOptimize(frame.data());
+        } else {
+            FrameView view;
+            replay.AcquireFrameView(view);
+            benchmark::DoNotOptimize(view.data);
+        }
+    }
+
+    // View повного кадру - лише вказівник (сторінки читає споживач), байти - для копії
+    if (copy) {
+        state.SetBytesProcessed((int64_t)state.iterations() * (int64_t)frame.size());
+    }
+    state.counters["fps"] = benchmark::Counter((double)state.iterations(), benchmark::Counter::kIsRate);
+    state.counters["file_bytes_per_frame"] = (double)recording.GetFileBytes() / kRecordedFrames;
+}
+
+} // namespace
+
+BENCHMARK(BM_Replay_Acquire)
+    ->ArgNames({"delta", "copy"})
+    ->Args({0, 0})->Args({0, 1})->Args({1, 0})->Args({1, 1})
+    ->Unit(benchmark::kMicrosecond)->UseRealTime();
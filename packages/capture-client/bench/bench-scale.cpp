@@ -0,0 +1,90 @@
+/**
+ * Scaling Benchmarks
+ * Злитий масштаб + BGRA -> NV12 проти двох проходів (масштаб у BGRA буфер, потім конвертація)
+ */
+
+#include "bench-common.h"
+#include "frame-converter.h"
+#include "frame-scaler.h"
+
+namespace {
+
+// Аргументи: src_width, src_height, dst_width, dst_height, filter
+void ScaleSizes(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"src_w", "src_h", "dst_w", "dst_h", "filter"});
+    const int sizes[][4] = {
+        {1920, 1080, 1280, 720},
+        {2560, 1440, 1280, 720},
+        {3840, 2160, 1280, 720},
+        {3840, 2160, 1920, 1080},
+    };
+    const ScaleFilter filters[] = {ScaleFilter::Box, ScaleFilter::Bilinear};
+    for (const auto& size : sizes) {
+        for (ScaleFilter filter : filters) {
+            b->Args({size[0], size[1], size[2], size[3], (int64_t)filter});
+        }
+    }
+}
+
+// Шлях аддону для h264: один прохід, проміжний кадр не пишеться в пам'ять
+void BM_ScaleNV12_Fused(benchmark::State& state) {
+    const int src_width = (int)state.range(0);
+    const int src_height = (int)state.range(1);
+    const int width = (int)state.range(2);
+    const int height = (int)state.range(3);
+    const ScaleFilter filter = static_cast<ScaleFilter>(state.range(4));
+    state.SetLabel(GetScaleFilterName(filter));
+
+    SyntheticFrames frames(src_width, src_height, 1);
+    AlignedBuffer nv12((size_t)width * height * 3 / 2);
+    FrameScaler scaler;
+    scaler.SetWorkerPool(GetBenchWorkerPool());
+    if (!scaler.Initialize(src_width, src_height, width, height, filter)) {
+        state.SkipWithError("Scaler initialization failed");
+        return;
+    }
+
+    for (auto _ : state) {
+        scaler.ScaleToNV12(frames.Get(0), frames.GetStride(),
+                           nv12.data(), width, nv12.data() + (size_t)width * height, width);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)frames.GetFrameBytes());
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Еталон: масштабований BGRA кадр у пам'ять, потім FrameConverter
+void BM_ScaleNV12_Separate(benchmark::State& state) {
+    const int src_width = (int)state.range(0);
+    const int src_height = (int)state.range(1);
+    const int width = (int)state.range(2);
+    const int height = (int)state.range(3);
+    const ScaleFilter filter = static_cast<ScaleFilter>(state.range(4));
+    state.SetLabel(GetScaleFilterName(filter));
+
+    SyntheticFrames frames(src_width, src_height, 1);
+    AlignedBuffer scaled((size_t)width * height * 4);
+    AlignedBuffer nv12((size_t)width * height * 3 / 2);
+    FrameScaler scaler;
+    FrameConverter converter;
+    scaler.SetWorkerPool(GetBenchWorkerPool());
+    converter.SetWorkerPool(GetBenchWorkerPool());
+    if (!scaler.Initialize(src_width, src_height, width, height, filter)) {
+        state.SkipWithError("Scaler initialization failed");
+        return;
+    }
+
+    for (auto _ : state) {
+        scaler.ScaleBGRA(frames.Get(0), frames.GetStride(), scaled.data(), width * 4);
+        converter.ConvertToNV12(scaled.data(), width * 4, width, height,
+                                nv12.data(), width, nv12.data() + (size_t)width * height, width);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)frames.GetFrameBytes());
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_ScaleNV12_Fused)->Apply(ScaleSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ScaleNV12_Separate)->Apply(ScaleSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,56 @@
+/**
+ * Instrumentation Benchmarks
+ * Вартість постійно увімкненої статистики на гарячому шляху
+ */
+
+#include "bench-common.h"
+#include "stats.h"
+
+namespace {
+
+// Запис у гістограму (кілька потоків - як стадії конвеєра)
+void BM_Stats_Record(benchmark::State& state) {
+    CaptureStats& stats = GetCaptureStats();
+    uint64_t us = 1 + state.thread_index() * 997;
+    for (auto _ : state) {
+        stats.Record(StatStage::Encode, us);
+        us = (us * 13 + 7) & 0xFFFF;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Таймер області видимості: два читання steady_clock + запис
+void BM_Stats_ScopedTimer(benchmark::State& state) {
+    for (auto _ : state) {
+        ScopedStageTimer timer(StatStage::Handoff);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_Stats_Counter(benchmark::State& state) {
+    CaptureStats& stats = GetCaptureStats();
+    for (auto _ : state) {
+        stats.Add(StatCounter::BytesOut, 4096);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Знімок для getStats() (лише коли JS опитує)
+void BM_Stats_Snapshot(benchmark::State& state) {
+    CaptureStats& stats = GetCaptureStats();
+    for (uint64_t us = 1; us < 100000; us += 37) {
+        stats.Record(StatStage::Latency, us);
+    }
+    for (auto _ : state) {
+        LatencySnapshot snapshot = stats.GetSnapshot(StatStage::Latency);
+        benchmark::DoNotOptimize(snapshot);
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_Stats_Record)->ThreadRange(1, 4)->UseRealTime();
+BENCHMARK(BM_Stats_ScopedTimer);
+BENCHMARK(BM_Stats_Counter);
+BENCHMARK(BM_Stats_Snapshot);
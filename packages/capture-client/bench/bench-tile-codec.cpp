@@ -0,0 +1,104 @@
+/**
+ * Screen Tile Codec Benchmarks
+ * Підрахунок кольорів плиток (ядра) і екранний кодек проти JPEG усього кадру
+ */
+
+#include "bench-common.h"
+#include "color-count.h"
+#include <algorithm>
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+#include "jpeg-encoder.h"
+#include "tile-encoder.h"
+#endif
+
+namespace {
+
+constexpr int kFrameWidth = 1920;
+constexpr int kFrameHeight = 1080;
+constexpr int kTileSize = 64;
+constexpr int kFrameCount = 8;
+
+// Класифікація всіх плиток кадру тексту одним ядром (arg: ConvertKernel)
+void BM_CountColors_Kernel(benchmark::State& state) {
+    const ConvertKernel kernel = static_cast<ConvertKernel>(state.range(0));
+    if (!IsConvertKernelSupported(kernel)) {
+        state.SkipWithError("Kernel not supported by this CPU");
+        return;
+    }
+    state.SetLabel(GetConvertKernelName(kernel));
+
+    const CountColorsFunc count_colors = GetCountColorsFunc(kernel);
+    SyntheticFrames frames(kFrameWidth, kFrameHeight, 1, SyntheticScenario::Text);
+    const uint8_t* frame = frames.Get(0);
+    uint32_t palette[kMaxCountedColors];
+
+    int64_t palette_tiles = 0;
+    for (auto _ : state) {
+        for (int y = 0; y < kFrameHeight; y += kTileSize) {
+            for (int x = 0; x < kFrameWidth; x += kTileSize) {
+                const int colors = count_colors(frame + (size_t)y * frames.GetStride() + (size_t)x * 4,
+                                                frames.GetStride(), std::min(kTileSize, kFrameWidth - x),
+                                                std::min(kTileSize, kFrameHeight - y), palette,
+                                                kMaxCountedColors);
+                palette_tiles += colors <= kMaxCountedColors;
+            }
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)frames.GetFrameBytes());
+    state.counters["palette_tiles"] = benchmark::Counter((double)palette_tiles, benchmark::Counter::kAvgIterations);
+}
+
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+// Повний кадр: codec:0 - JPEG q80 усього кадру, 1 - tile (JPEG q80 лише складних плиток),
+// 2 - tile без втрат. video:1 - сцена з відео-областю замість прокрутки тексту.
+void BM_ScreenCodec(benchmark::State& state) {
+    const int codec = (int)state.range(0);
+    const SyntheticScenario scenario = state.range(1) ? SyntheticScenario::Video : SyntheticScenario::Text;
+    SyntheticFrames frames(kFrameWidth, kFrameHeight, kFrameCount, scenario);
+
+    JpegEncoder jpeg;
+    TileEncoder tile;
+    size_t capacity;
+    if (codec == 0) {
+        jpeg.Initialize(kFrameWidth, kFrameHeight, 80, true);
+        capacity = jpeg.GetMaxOutputSize();
+    } else {
+        tile.Initialize(kFrameWidth, kFrameHeight, kTileSize, codec == 1 ? 80 : 0);
+        capacity = tile.GetMaxPacketSize();
+    }
+    AlignedBuffer packet(capacity);
+    memset(packet.data(), 0, packet.size());
+
+    size_t index = 0;
+    size_t size = 0;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        if (codec == 0) {
+            jpeg.Encode(frames.Get(index++), frames.GetStride(), packet.data(), packet.size(), size);
+        } else {
+            tile.Encode(frames.Get(index++), frames.GetStride(), packet.data(), packet.size(), size);
+        }
+        bytes += (int64_t)size;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["bytes_per_frame"] = benchmark::Counter((double)bytes, benchmark::Counter::kAvgIterations);
+    if (codec != 0) {
+        state.counters["complex_tiles"] = tile.GetLastStats().complex_tiles;
+    }
+}
+#endif
+
+} // namespace
+
+BENCHMARK(BM_CountColors_Kernel)
+    ->ArgName("kernel")
+    ->Arg((int64_t)ConvertKernel::Scalar)
+    ->Arg((int64_t)ConvertKernel::SSE2)
+    ->Arg((int64_t)ConvertKernel::AVX2)
+    ->Unit(benchmark::kMillisecond);
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+BENCHMARK(BM_ScreenCodec)
+    ->ArgNames({"codec", "video"})
+    ->ArgsProduct({{0, 1, 2}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+#endif
@@ -0,0 +1,108 @@
+/**
+ * N-API Handoff Benchmark
+ * Вартість передачі кадру з аддону в JS (captureFrame -> Buffer) на синтетичному джерелі.
+ * Результат - JSON у форматі Google Benchmark (порівнюється тими ж інструментами).
+ *
+ *   node bench/napi-handoff.js [--out results.json] [--frames 300]
+ */
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const nativeCapture = require(path.join(__dirname, '..', 'build', 'Release', 'screen_capture.node'));
+
+const FRAME_SIZES = [
+    [1280, 720],
+    [1920, 1080],
+    [2560, 1440],
+    [3840, 2160]
+];
+
+function parseArgs(argv) {
+    const args = { out: null, frames: 300 };
+    for (let i = 0; i < argv.length; i++) {
+        if (argv[i] === '--out') {
+            args.out = argv[++i];
+        } else if (argv[i] === '--frames') {
+            args.frames = parseInt(argv[++i], 10);
+        }
+    }
+    return args;
+}
+
+// codec: bgra - кадр пишеться одразу в буфер пулу і віддається в JS без копії
+function runHandoff(width, height, frames) {
+    const init = nativeCapture.initialize({
+        backend: 'synthetic',
+        syntheticScenario: 'video',
+        width: width,
+        height: height,
+        fps: 0, // Без темпу - новий кадр на кожен виклик
+        codec: 'bgra',
+        poolDepth: 8
+    });
+    if (!init.success) {
+        throw new Error(`initialize ${width}x${height}: ${init.error}`);
+    }
+
+    const before = nativeCapture.getFramePoolStats();
+    let checksum = 0;
+    let delivered = 0;
+
+    const start = process.hrtime.bigint();
+    for (let i = 0; i < frames; i++) {
+        const result = nativeCapture.captureFrame();
+        if (result.success && result.data) {
+            checksum ^= result.data[0];
+            delivered++;
+        }
+    }
+    const elapsedNs = Number(process.hrtime.bigint() - start);
+    const after = nativeCapture.getFramePoolStats();
+
+    nativeCapture.cleanup();
+
+    const perFrameNs = elapsedNs / Math.max(delivered, 1);
+    return {
+        name: `NAPI_CaptureFrame_Handoff/width:${width}/height:${height}/real_time`,
+        run_type: 'iteration',
+        iterations: delivered,
+        real_time: perFrameNs / 1e6,
+        cpu_time: perFrameNs / 1e6,
+        time_unit: 'ms',
+        bytes_per_second: (width * height * 4 * 1e9) / perFrameNs,
+        items_per_second: 1e9 / perFrameNs,
+        // Кадри, що пішли через запасний буфер (пул вичерпано, GC ще не повернув буфери)
+        copied_frames: after.exhausted - before.exhausted,
+        checksum: checksum
+    };
+}
+
+function main() {
+    const args = parseArgs(process.argv.slice(2));
+    const benchmarks = FRAME_SIZES.map(([width, height]) => runHandoff(width, height, args.frames));
+
+    const report = {
+        context: {
+            date: new Date().toISOString(),
+            host_name: os.hostname(),
+            executable: `node ${process.version}`,
+            num_cpus: os.cpus().length,
+            library_build_type: 'release'
+        },
+        benchmarks: benchmarks
+    };
+
+    const json = JSON.stringify(report, null, 2);
+    if (args.out) {
+        fs.writeFileSync(args.out, json);
+        for (const b of benchmarks) {
+            console.log(`${b.name}: ${b.real_time.toFixed(3)} ms/кадр, копій ${b.copied_frames}`);
+        }
+    } else {
+        console.log(json);
+    }
+}
+
+main();
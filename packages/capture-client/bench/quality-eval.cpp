@@ -0,0 +1,744 @@
+/**
+ * Quality vs Throughput Evaluation
+ * Прогін корпусу кадрів (синтетичного або записаного) через варіанти конвеєра:
+ * масштаб -> кодек -> декодування -> порівняння з оригіналом (PSNR / SSIM).
+ * На кожен варіант - fps, CPU час і байти на кадр, якість; результат - JSON.
+ *
+ *   quality_eval [--scenario mixed|text|video|idle] [--size 1920x1080] [--frames 30]
+ *                [--input frames.bgra] [--variant SPEC]... [--out quality.json]
+ *
+ * SPEC: codec[:key=value,...]; codec - raw | nv12 | jpeg | tile,
+ * ключі - q (якість), chroma (420 | 444), scale (WxH), filter (box | bilinear),
+ * kernel (auto | scalar | sse2 | avx2), tile (розмір плитки). Без --variant - типовий набір.
+ */
+
+#include "aligned-memory.h"
+#include "color-convert.h"
+#include "frame-scaler.h"
+#include "image-quality.h"
+#include "synthetic-capture.h"
+#include "worker-pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+#include "jpeg-encoder.h"
+#include "lz-block.h"
+#include "tile-encoder.h"
+#include <csetjmp>
+#include <jpeglib.h>
+#endif
+
+namespace {
+
+struct Corpus {
+    std::string source;
+    int width = 0;
+    int height = 0;
+    std::vector<AlignedBuffer> frames;
+
+    int GetStride() const { return width * 4; }
+    size_t GetFrameBytes() const { return (size_t)width * height * 4; }
+};
+
+struct VariantConfig {
+    std::string spec;
+    std::string codec = "raw";
+    int quality = 80;
+    bool chroma_420 = true;
+    int tile_size = 64;
+    int scale_width = 0;            // 0 - без масштабу
+    int scale_height = 0;
+    ScaleFilter filter = ScaleFilter::Box;
+    ConvertKernel kernel = ConvertKernel::Auto;
+};
+
+struct VariantResult {
+    int frames = 0;
+    double wall_ms = 0.0;           // Масштаб + кодування (без декодування і метрик)
+    double cpu_ms = 0.0;            // Процесорний час усіх потоків процесу за той самий інтервал
+    uint64_t bytes = 0;
+    double psnr = 0.0;
+    double psnr_y = 0.0;
+    double ssim = 0.0;
+    double min_ssim = 1.0;
+};
+
+bool ParseSize(const std::string& text, int& width, int& height) {
+    return sscanf(text.c_str(), "%dx%d", &width, &height) == 2 && width > 0 && height > 0;
+}
+
+bool ParseKernel(const std::string& name, ConvertKernel& kernel) {
+    for (ConvertKernel k : {ConvertKernel::Auto, ConvertKernel::Scalar, ConvertKernel::SSE2, ConvertKernel::AVX2}) {
+        if (name == GetConvertKernelName(k)) {
+            kernel = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ParseVariant(const std::string& spec, VariantConfig& config) {
+    config = VariantConfig();
+    config.spec = spec;
+    const size_t colon = spec.find(':');
+    config.codec = spec.substr(0, colon);
+    if (config.codec != "raw" && config.codec != "nv12" && config.codec != "jpeg" && config.codec != "tile") {
+        return false;
+    }
+
+    size_t pos = colon == std::string::npos ? spec.size() : colon + 1;
+    while (pos < spec.size()) {
+        size_t end = spec.find(',', pos);
+        if (end == std::string::npos) {
+            end = spec.size();
+        }
+        const std::string item = spec.substr(pos, end - pos);
+        const size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            return false;
+        }
+        const std::string key = item.substr(0, eq);
+        const std::string value = item.substr(eq + 1);
+        bool ok = true;
+        if (key == "q") {
+            config.quality = atoi(value.c_str());
+        } else if (key == "chroma") {
+            ok = value == "420" || value == "444";
+            config.chroma_420 = value == "420";
+        } else if (key == "tile") {
+            config.tile_size = atoi(value.c_str());
+        } else if (key == "scale") {
+            ok = ParseSize(value, config.scale_width, config.scale_height);
+        } else if (key == "filter") {
+            ok = ParseScaleFilter(value, config.filter);
+        } else if (key == "kernel") {
+            ok = ParseKernel(value, config.kernel);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            return false;
+        }
+        pos = end + 1;
+    }
+    return true;
+}
+
+// Типовий набір: якість JPEG / tile, ядра конвертації, фільтри масштабу до половини
+std::vector<std::string> GetDefaultVariants(int width, int height) {
+    std::vector<std::string> specs;
+    const std::string half = std::to_string((width / 2) & ~1) + "x" + std::to_string((height / 2) & ~1);
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+    specs.push_back("jpeg:q=50");
+    specs.push_back("jpeg:q=75");
+    specs.push_back("jpeg:q=90");
+    specs.push_back("jpeg:q=90,chroma=444");
+    specs.push_back("tile:q=80");
+    specs.push_back("tile:q=0");
+    specs.push_back("jpeg:q=80,scale=" + half + ",filter=box");
+#endif
+    for (ConvertKernel kernel : {ConvertKernel::Scalar, ConvertKernel::SSE2, ConvertKernel::AVX2}) {
+        if (IsConvertKernelSupported(kernel)) {
+            specs.push_back(std::string("nv12:kernel=") + GetConvertKernelName(kernel));
+        }
+    }
+    specs.push_back("raw:scale=" + half + ",filter=box");
+    specs.push_back("raw:scale=" + half + ",filter=bilinear");
+    return specs;
+}
+
+bool LoadSynthetic(const std::string& name, int width, int height, int count, Corpus& corpus) {
+    SyntheticScenario scenario;
+    if (name == "mixed") {
+        scenario = SyntheticScenario::Mixed;
+    } else if (name == "text") {
+        scenario = SyntheticScenario::Text;
+    } else if (name == "video") {
+        scenario = SyntheticScenario::Video;
+    } else if (name == "idle") {
+        scenario = SyntheticScenario::Idle;
+    } else {
+        return false;
+    }
+
+    SyntheticCapture source(scenario, 0, 1);
+    if (!source.Initialize(width, height)) {
+        return false;
+    }
+    corpus.source = "synthetic:" + name;
+    corpus.width = width;
+    corpus.height = height;
+    corpus.frames.resize(count);
+    for (int i = 0; i < count; i++) {
+        corpus.frames[i].Resize(corpus.GetFrameBytes());
+        // Кадр простою (false) повторює попередній вміст
+        if (!source.CaptureFrame(corpus.frames[i].data(), corpus.GetStride()) && i > 0) {
+            memcpy(corpus.frames[i].data(), corpus.frames[i - 1].data(), corpus.GetFrameBytes());
+        }
+    }
+    return true;
+}
+
+// Записаний корпус - щільні BGRA кадри підряд
+bool LoadRaw(const std::string& path, int width, int height, int max_frames, Corpus& corpus) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    corpus.source = path;
+    corpus.width = width;
+    corpus.height = height;
+    corpus.frames.clear();
+    while ((int)corpus.frames.size() < max_frames) {
+        AlignedBuffer frame(corpus.GetFrameBytes());
+        if (fread(frame.data(), 1, frame.size(), file) != frame.size()) {
+            break;
+        }
+        corpus.frames.push_back(std::move(frame));
+    }
+    fclose(file);
+    return !corpus.frames.empty();
+}
+
+// Білінійне повернення до розміру оригіналу (8 біт дробу) - як це зробить
+// переглядач, розтягуючи масштабований потік
+void UpscaleBilinear(const uint8_t* src, int src_width, int src_height, uint8_t* dst, int dst_width,
+                     int dst_height) {
+    std::vector<int> x0(dst_width), x1(dst_width), fx(dst_width);
+    for (int x = 0; x < dst_width; x++) {
+        const int pos = std::max(0, (int)(((x + 0.5) * src_width / dst_width - 0.5) * 256));
+        x0[x] = std::min(pos >> 8, src_width - 1);
+        x1[x] = std::min(x0[x] + 1, src_width - 1);
+        fx[x] = pos & 255;
+    }
+    for (int y = 0; y < dst_height; y++) {
+        const int pos = std::max(0, (int)(((y + 0.5) * src_height / dst_height - 0.5) * 256));
+        const int y0 = std::min(pos >> 8, src_height - 1);
+        const int y1 = std::min(y0 + 1, src_height - 1);
+        const int fy = pos & 255;
+        const uint8_t* r0 = src + (size_t)y0 * src_width * 4;
+        const uint8_t* r1 = src + (size_t)y1 * src_width * 4;
+        uint8_t* out = dst + (size_t)y * dst_width * 4;
+        for (int x = 0; x < dst_width; x++) {
+            for (int c = 0; c < 4; c++) {
+                const int top = r0[x0[x] * 4 + c] * (256 - fx[x]) + r0[x1[x] * 4 + c] * fx[x];
+                const int bottom = r1[x0[x] * 4 + c] * (256 - fx[x]) + r1[x1[x] * 4 + c] * fx[x];
+                out[x * 4 + c] = (uint8_t)((top * (256 - fy) + bottom * fy + 32768) >> 16);
+            }
+        }
+    }
+}
+
+inline uint8_t Clamp255(int value) {
+    return (uint8_t)std::min(255, std::max(0, value));
+}
+
+// NV12 (BT.601, обмежений діапазон - як у конвеєрі аддону) -> BGRA, chroma без інтерполяції
+void NV12ToBGRA(const uint8_t* y_plane, const uint8_t* uv_plane, int width, int height, uint8_t* dst) {
+    const int uv_stride = ((width + 1) / 2) * 2;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const int c = 298 * (y_plane[(size_t)y * width + x] - 16);
+            const uint8_t* uv = uv_plane + (size_t)(y / 2) * uv_stride + (x / 2) * 2;
+            const int d = uv[0] - 128;
+            const int e = uv[1] - 128;
+            uint8_t* out = dst + ((size_t)y * width + x) * 4;
+            out[0] = Clamp255((c + 516 * d + 128) >> 8);
+            out[1] = Clamp255((c - 100 * d - 208 * e + 128) >> 8);
+            out[2] = Clamp255((c + 409 * e + 128) >> 8);
+            out[3] = 255;
+        }
+    }
+}
+
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+struct JpegErrorManager {
+    jpeg_error_mgr base;
+    jmp_buf jump;
+};
+
+void OnJpegError(j_common_ptr cinfo) {
+    longjmp(reinterpret_cast<JpegErrorManager*>(cinfo->err)->jump, 1);
+}
+
+// JPEG -> BGRA (JCS_EXT_BGRA libjpeg-turbo)
+bool DecodeJpeg(const uint8_t* data, size_t size, std::vector<uint8_t>& pixels, int& width, int& height) {
+    jpeg_decompress_struct cinfo;
+    JpegErrorManager error;
+    cinfo.err = jpeg_std_error(&error.base);
+    error.base.error_exit = OnJpegError;
+    if (setjmp(error.jump)) {
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, const_cast<unsigned char*>(data), (unsigned long)size);
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space = JCS_EXT_BGRA;
+    jpeg_start_decompress(&cinfo);
+    width = (int)cinfo.output_width;
+    height = (int)cinfo.output_height;
+    pixels.resize((size_t)width * height * 4);
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = pixels.data() + (size_t)cinfo.output_scanline * width * 4;
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return true;
+}
+
+inline uint32_t ReadU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline uint16_t ReadU16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// TIL1 пакет -> BGRA (та сама логіка, що й frontend/public/js/tile-decoder.js)
+bool DecodeTilePacket(const uint8_t* packet, size_t size, uint8_t* dst, int width, int height) {
+    if (size < TileEncoder::kHeaderSize || ReadU32(packet) != TileEncoder::kMagic ||
+        ReadU16(packet + 4) != width || ReadU16(packet + 6) != height) {
+        return false;
+    }
+    const int tile_size = ReadU16(packet + 8);
+    const int atlas_columns = packet[10];
+    const size_t stream_size = ReadU32(packet + 12);
+    const size_t lz_size = ReadU32(packet + 16);
+    const size_t jpeg_size = ReadU32(packet + 20);
+    if (tile_size == 0 || TileEncoder::kHeaderSize + lz_size + jpeg_size != size) {
+        return false;
+    }
+
+    std::vector<uint8_t> stream(stream_size);
+    if (!LzDecompress(packet + TileEncoder::kHeaderSize, lz_size, stream.data(), stream_size)) {
+        return false;
+    }
+    std::vector<uint8_t> atlas;
+    int atlas_width = 0;
+    int atlas_height = 0;
+    if (jpeg_size > 0 && !DecodeJpeg(packet + TileEncoder::kHeaderSize + lz_size, jpeg_size, atlas,
+                                     atlas_width, atlas_height)) {
+        return false;
+    }
+
+    const int tiles_x = (width + tile_size - 1) / tile_size;
+    const int tiles_y = (height + tile_size - 1) / tile_size;
+    const uint8_t* p = stream.data();
+    const uint8_t* end = p + stream.size();
+    int cell = 0;
+    for (int ty = 0; ty < tiles_y; ty++) {
+        for (int tx = 0; tx < tiles_x; tx++) {
+            const int x0 = tx * tile_size;
+            const int y0 = ty * tile_size;
+            const int w = std::min(tile_size, width - x0);
+            const int h = std::min(tile_size, height - y0);
+            if (p >= end) {
+                return false;
+            }
+            const uint8_t type = *p++;
+            auto put = [&](int x, int y, const uint8_t* bgr) {
+                uint8_t* out = dst + ((size_t)(y0 + y) * width + x0 + x) * 4;
+                out[0] = bgr[0];
+                out[1] = bgr[1];
+                out[2] = bgr[2];
+                out[3] = 255;
+            };
+
+            if (type == TileEncoder::kTileComplex) {
+                const int sx = (cell % std::max(1, atlas_columns)) * tile_size;
+                const int sy = (cell / std::max(1, atlas_columns)) * tile_size;
+                cell++;
+                if (!atlas_columns || sx + w > atlas_width || sy + h > atlas_height) {
+                    return false;
+                }
+                for (int y = 0; y < h; y++) {
+                    memcpy(dst + ((size_t)(y0 + y) * width + x0) * 4,
+                           atlas.data() + ((size_t)(sy + y) * atlas_width + sx) * 4, (size_t)w * 4);
+                }
+                continue;
+            }
+            if (type == TileEncoder::kTileFlat || type == TileEncoder::kTileRaw) {
+                const bool raw = type == TileEncoder::kTileRaw;
+                if (end - p < (raw ? (ptrdiff_t)w * h * 3 : 3)) {
+                    return false;
+                }
+                for (int y = 0; y < h; y++) {
+                    for (int x = 0; x < w; x++) {
+                        put(x, y, p);
+                        if (raw) {
+                            p += 3;
+                        }
+                    }
+                }
+                if (!raw) {
+                    p += 3;
+                }
+                continue;
+            }
+            if (type != TileEncoder::kTilePalette && type != TileEncoder::kTileRle) {
+                return false;
+            }
+
+            const int colors = p < end ? *p++ : 0;
+            if (colors < 2 || colors > TileEncoder::kMaxPaletteColors || end - p < colors * 3) {
+                return false;
+            }
+            const uint8_t* palette = p;
+            p += colors * 3;
+            if (type == TileEncoder::kTilePalette) {
+                // Старші біти - лівіші пікселі, рядок доповнено до байта
+                const int bits = colors <= 2 ? 1 : (colors <= 4 ? 2 : 4);
+                const int row_bytes = (w * bits + 7) / 8;
+                if (end - p < (ptrdiff_t)row_bytes * h) {
+                    return false;
+                }
+                for (int y = 0; y < h; y++, p += row_bytes) {
+                    for (int x = 0; x < w; x++) {
+                        const int bit = x * bits;
+                        const int index = (p[bit >> 3] >> (8 - bits - (bit & 7))) & ((1 << bits) - 1);
+                        if (index >= colors) {
+                            return false;
+                        }
+                        put(x, y, palette + index * 3);
+                    }
+                }
+            } else {
+                for (int i = 0; i < w * h;) {
+                    if (p >= end) {
+                        return false;
+                    }
+                    const int index = *p >> 4;
+                    const int run_end = i + (*p & 15) + 1;
+                    p++;
+                    if (index >= colors || run_end > w * h) {
+                        return false;
+                    }
+                    for (; i < run_end; i++) {
+                        put(i % w, i / w, palette + index * 3);
+                    }
+                }
+            }
+        }
+    }
+    return p == end;
+}
+#endif // CAPTURE_BENCH_HAVE_JPEG
+
+// Один варіант конвеєра над усім корпусом
+class VariantRunner {
+public:
+    VariantRunner(const Corpus& corpus, const VariantConfig& config, WorkerPool* pool)
+        : corpus_(corpus), config_(config), pool_(pool) {
+    }
+
+    bool Initialize(std::string& error) {
+        width_ = corpus_.width;
+        height_ = corpus_.height;
+        if (config_.scale_width > 0) {
+            if (!scaler_.Initialize(corpus_.width, corpus_.height, config_.scale_width, config_.scale_height,
+                                    config_.filter)) {
+                error = "scaler initialization failed";
+                return false;
+            }
+            scaler_.SetWorkerPool(pool_);
+            scaler_.SetKernel(config_.kernel);
+            width_ = config_.scale_width;
+            height_ = config_.scale_height;
+            scaled_.Resize((size_t)width_ * height_ * 4);
+        }
+        if (!IsConvertKernelSupported(config_.kernel)) {
+            error = "kernel not supported by this CPU";
+            return false;
+        }
+
+        size_t capacity = (size_t)width_ * height_ * 4;
+        if (config_.codec == "jpeg" || config_.codec == "tile") {
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+            if (config_.codec == "jpeg") {
+                jpeg_.SetWorkerPool(pool_);
+                if (!jpeg_.Initialize(width_, height_, config_.quality, config_.chroma_420)) {
+                    error = jpeg_.GetLastError();
+                    return false;
+                }
+                capacity = jpeg_.GetMaxOutputSize();
+            } else {
+                if (!tile_.Initialize(width_, height_, config_.tile_size, config_.quality, config_.chroma_420)) {
+                    error = tile_.GetLastError();
+                    return false;
+                }
+                capacity = tile_.GetMaxPacketSize();
+            }
+#else
+            error = "built without libjpeg";
+            return false;
+#endif
+        }
+        packet_.Resize(capacity);
+        decoded_.Resize((size_t)width_ * height_ * 4);
+        if (config_.scale_width > 0) {
+            restored_.Resize(corpus_.GetFrameBytes());
+        }
+        return true;
+    }
+
+    bool Run(VariantResult& result, std::string& error) {
+        result = VariantResult();
+        size_t size = 0;
+        // Прогрів: ліниві ініціалізації (атлас tile, смуги JPEG) не потрапляють у заміри
+        if (!Encode(corpus_.frames[0].data(), size)) {
+            error = "encode failed";
+            return false;
+        }
+
+        double psnr = 0.0, psnr_y = 0.0, ssim = 0.0;
+        for (const AlignedBuffer& frame : corpus_.frames) {
+            const std::clock_t cpu_start = std::clock();
+            const auto wall_start = std::chrono::steady_clock::now();
+            if (!Encode(frame.data(), size)) {
+                error = "encode failed";
+                return false;
+            }
+            result.wall_ms += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - wall_start).count();
+            result.cpu_ms += 1000.0 * (double)(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+            result.bytes += size;
+
+            const uint8_t* output = Decode(size);
+            if (!output) {
+                error = "decode failed";
+                return false;
+            }
+            if (config_.scale_width > 0) {
+                UpscaleBilinear(output, width_, height_, restored_.data(), corpus_.width, corpus_.height);
+                output = restored_.data();
+            }
+            QualityScores scores;
+            if (!meter_.Measure(frame.data(), corpus_.GetStride(), output, corpus_.GetStride(),
+                                corpus_.width, corpus_.height, scores)) {
+                error = "quality measurement failed";
+                return false;
+            }
+            psnr += scores.psnr;
+            psnr_y += scores.psnr_y;
+            ssim += scores.ssim;
+            result.min_ssim = std::min(result.min_ssim, scores.min_ssim);
+            result.frames++;
+        }
+        result.psnr = psnr / result.frames;
+        result.psnr_y = psnr_y / result.frames;
+        result.ssim = ssim / result.frames;
+        return true;
+    }
+
+private:
+    // Заміряна частина: масштаб і кодування так, як їх виконує аддон
+    bool Encode(const uint8_t* frame, size_t& size) {
+        const uint8_t* input = frame;
+        if (config_.scale_width > 0) {
+            if (!scaler_.ScaleBGRA(frame, corpus_.GetStride(), scaled_.data(), width_ * 4)) {
+                return false;
+            }
+            input = scaled_.data();
+        }
+
+        if (config_.codec == "raw") {
+            input_ = input;
+            size = (size_t)width_ * height_ * 4;
+            return true;
+        }
+        if (config_.codec == "nv12") {
+            const size_t y_size = (size_t)width_ * height_;
+            const int uv_stride = ((width_ + 1) / 2) * 2;
+            size = y_size + (size_t)uv_stride * ((height_ + 1) / 2);
+            return ConvertBGRAToNV12(input, width_ * 4, width_, height_, packet_.data(), width_,
+                                     packet_.data() + y_size, uv_stride, ColorMatrix::BT601,
+                                     ColorRange::Limited, config_.kernel);
+        }
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+        if (config_.codec == "jpeg") {
+            return jpeg_.Encode(input, width_ * 4, packet_.data(), packet_.size(), size);
+        }
+        return tile_.Encode(input, width_ * 4, packet_.data(), packet_.size(), size);
+#else
+        return false;
+#endif
+    }
+
+    // BGRA кадр після кодека (розмір width_ x height_)
+    const uint8_t* Decode(size_t size) {
+        if (config_.codec == "raw") {
+            return input_;
+        }
+        if (config_.codec == "nv12") {
+            NV12ToBGRA(packet_.data(), packet_.data() + (size_t)width_ * height_, width_, height_,
+                       decoded_.data());
+            return decoded_.data();
+        }
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+        if (config_.codec == "jpeg") {
+            int width = 0;
+            int height = 0;
+            if (!DecodeJpeg(packet_.data(), size, jpeg_pixels_, width, height) ||
+                width != width_ || height != height_) {
+                return nullptr;
+            }
+            return jpeg_pixels_.data();
+        }
+        if (!DecodeTilePacket(packet_.data(), size, decoded_.data(), width_, height_)) {
+            return nullptr;
+        }
+        return decoded_.data();
+#else
+        (void)size;
+        return nullptr;
+#endif
+    }
+
+    const Corpus& corpus_;
+    VariantConfig config_;
+    WorkerPool* pool_;
+    int width_ = 0;
+    int height_ = 0;
+    FrameScaler scaler_;
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+    JpegEncoder jpeg_;
+    TileEncoder tile_;
+    std::vector<uint8_t> jpeg_pixels_;
+#endif
+    QualityMeter meter_;
+    AlignedBuffer scaled_;
+    AlignedBuffer packet_;
+    AlignedBuffer decoded_;
+    AlignedBuffer restored_;
+    const uint8_t* input_ = nullptr;
+};
+
+void WriteJsonString(FILE* out, const std::string& value) {
+    fputc('"', out);
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            fputc('\\', out);
+        }
+        fputc(c, out);
+    }
+    fputc('"', out);
+}
+
+void PrintUsage() {
+    fprintf(stderr,
+            "usage: quality_eval [--scenario mixed|text|video|idle] [--size WxH] [--frames N]\n"
+            "                    [--input frames.bgra] [--variant SPEC]... [--out file.json]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string scenario = "mixed";
+    std::string input;
+    std::string out_path;
+    int width = 1920;
+    int height = 1080;
+    int frames = 30;
+    std::vector<std::string> specs;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--scenario" && has_value) {
+            scenario = argv[++i];
+        } else if (arg == "--size" && has_value) {
+            if (!ParseSize(argv[++i], width, height)) {
+                PrintUsage();
+                return 2;
+            }
+        } else if (arg == "--frames" && has_value) {
+            frames = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--input" && has_value) {
+            input = argv[++i];
+        } else if (arg == "--variant" && has_value) {
+            specs.push_back(argv[++i]);
+        } else if (arg == "--out" && has_value) {
+            out_path = argv[++i];
+        } else {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    Corpus corpus;
+    const bool loaded = input.empty() ? LoadSynthetic(scenario, width, height, frames, corpus)
+                                      : LoadRaw(input, width, height, frames, corpus);
+    if (!loaded) {
+        fprintf(stderr, "quality_eval: cannot load corpus %s\n", input.empty() ? scenario.c_str() : input.c_str());
+        return 1;
+    }
+    if (specs.empty()) {
+        specs = GetDefaultVariants(corpus.width, corpus.height);
+    }
+
+    WorkerPool pool;
+    pool.Initialize(0);
+
+    FILE* out = out_path.empty() ? stdout : fopen(out_path.c_str(), "w");
+    if (!out) {
+        fprintf(stderr, "quality_eval: cannot write %s\n", out_path.c_str());
+        return 1;
+    }
+    fprintf(out, "{\n  \"corpus\": {\"source\": ");
+    WriteJsonString(out, corpus.source);
+    fprintf(out, ", \"width\": %d, \"height\": %d, \"frames\": %d},\n  \"variants\": [",
+            corpus.width, corpus.height, (int)corpus.frames.size());
+
+    int failed = 0;
+    bool first = true;
+    for (const std::string& spec : specs) {
+        VariantConfig config;
+        std::string error;
+        VariantResult result;
+        if (!ParseVariant(spec, config)) {
+            error = "invalid variant spec";
+        } else {
+            VariantRunner runner(corpus, config, &pool);
+            if (runner.Initialize(error)) {
+                runner.Run(result, error);
+            }
+        }
+
+        fprintf(out, "%s\n    {\"name\": ", first ? "" : ",");
+        first = false;
+        WriteJsonString(out, spec);
+        if (!error.empty()) {
+            fprintf(out, ", \"error\": ");
+            WriteJsonString(out, error);
+            fprintf(out, "}");
+            fprintf(stderr, "%-40s %s\n", spec.c_str(), error.c_str());
+            failed++;
+            continue;
+        }
+        const double wall_ms = result.wall_ms / result.frames;
+        fprintf(out,
+                ", \"codec\": \"%s\", \"kernel\": \"%s\", \"frames\": %d, \"fps\": %.2f, "
+                "\"wall_ms_per_frame\": %.3f, \"cpu_ms_per_frame\": %.3f, \"bytes_per_frame\": %.0f, "
+                "\"psnr\": %.3f, \"psnr_y\": %.3f, \"ssim\": %.5f, \"min_ssim\": %.5f}",
+                config.codec.c_str(), GetConvertKernelName(config.kernel), result.frames,
+                wall_ms > 0.0 ? 1000.0 / wall_ms : 0.0, wall_ms, result.cpu_ms / result.frames,
+                (double)result.bytes / result.frames, result.psnr, result.psnr_y, result.ssim,
+                result.min_ssim);
+        fprintf(stderr, "%-40s %8.2f fps %10.0f B/frame  PSNR %6.2f dB  SSIM %.4f\n", spec.c_str(),
+                wall_ms > 0.0 ? 1000.0 / wall_ms : 0.0, (double)result.bytes / result.frames, result.psnr,
+                result.ssim);
+    }
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+    return failed > 0 ? 1 : 0;
+}
@@ -1,10 +1,44 @@
 {
+  "variables": {
+    "with_x264%": "<!(node -p \"process.platform === 'linux' && process.env.CAPTURE_X264 !== '0' && require('child_process').spawnSync('pkg-config', ['--exists', 'x264']).status === 0 ? 1 : 0\")",
+    "with_xrandr%": "<!(node -p \"process.platform === 'linux' && require('child_process').spawnSync('pkg-config', ['--exists', 'xrandr']).status === 0 ? 1 : 0\")",
+    "with_xfixes%": "<!(node -p \"process.platform === 'linux' && require('child_process').spawnSync('pkg-config', ['--exists', 'xfixes']).status === 0 ? 1 : 0\")"
+  },
   "targets": [
     {
       "target_name": "screen_capture",
       "sources": [
-        "native/screen-capture.cpp",
-        "native/encoder.cpp",
+        "native/capture-source.cpp",
+        "native/synthetic-capture.cpp",
+        "native/multi-output-capture.cpp",
+        "native/capture-recording.cpp",
+        "native/replay-capture.cpp",
+        "native/video-encoder.cpp",
+        "native/h264-parser.cpp",
+        "native/gop-cache.cpp",
+        "native/frame-broadcast.cpp",
+        "native/cursor.cpp",
+        "native/cursor-blend.cpp",
+        "native/cpu-features.cpp",
+        "native/color-convert.cpp",
+        "native/worker-pool.cpp",
+        "native/frame-converter.cpp",
+        "native/image-scale.cpp",
+        "native/frame-scaler.cpp",
+        "native/tile-diff.cpp",
+        "native/tile-cache.cpp",
+        "native/motion-detector.cpp",
+        "native/delta-encoder.cpp",
+        "native/jpeg-encoder.cpp",
+        "native/lz-block.cpp",
+        "native/color-count.cpp",
+        "native/tile-encoder.cpp",
+        "native/buffer-arena.cpp",
+        "native/frame-pool.cpp",
+        "native/capture-scheduler.cpp",
+        "native/capture-loop.cpp",
+        "native/frame-pipeline.cpp",
+        "native/stats.cpp",
         "native/module.cpp"
       ],
       "include_dirs": [
@@ -24,11 +58,20 @@
         [
           "OS=='win'",
           {
+            "sources": [
+              "native/screen-capture.cpp",
+              "native/encoder.cpp"
+            ],
+            "include_dirs": [
+              "<!(node -p \"(process.env.LIBJPEG_TURBO_DIR || 'C:/libjpeg-turbo64') + '/include'\")"
+            ],
             "libraries": [
+              "<!(node -p \"(process.env.LIBJPEG_TURBO_DIR || 'C:/libjpeg-turbo64') + '/lib/jpeg-static.lib'\")",
               "d3d11.lib",
               "dxgi.lib",
               "d3dcompiler.lib",
-              "windowscodecs.lib"
+              "windowscodecs.lib",
+              "winmm.lib"
             ],
             "msvs_settings": {
               "VCCLCompilerTool": {
@@ -37,6 +80,55 @@
               }
             }
           }
+        ],
+        [
+          "OS=='linux'",
+          {
+            "sources": [
+              "native/x11-capture.cpp"
+            ],
+            "defines": [
+              "CAPTURE_HAVE_X11"
+            ],
+            "cflags_cc": ["-std=c++17"],
+            "libraries": [
+              "-lX11",
+              "-lXext",
+              "-ljpeg",
+              "-lpthread"
+            ]
+          }
+        ],
+        [
+          "with_x264==1",
+          {
+            "sources": [
+              "native/x264-encoder.cpp"
+            ],
+            "defines": [
+              "CAPTURE_HAVE_X264"
+            ],
+            "cflags_cc": ["<!@(pkg-config --cflags x264)"],
+            "libraries": ["<!@(pkg-config --libs x264)"]
+          }
+        ],
+        [
+          "with_xrandr==1",
+          {
+            "defines": [
+              "CAPTURE_HAVE_XRANDR"
+            ],
+            "libraries": ["<!@(pkg-config --libs xrandr)"]
+          }
+        ],
+        [
+          "with_xfixes==1",
+          {
+            "defines": [
+              "CAPTURE_HAVE_XFIXES"
+            ],
+            "libraries": ["<!@(pkg-config --libs xfixes)"]
+          }
         ]
       ]
     }
@@ -24,35 +24,147 @@ let frameNumber = 0;
 let isInitialized = false;
 let captureWidth = 1280;  // За замовчуванням
 let captureHeight = 720;  // За замовчуванням
+let captureOutputs = [0]; // Виходи (монітори) сесії; -1 - склеєне полотно
+const outputSizes = new Map(); // output -> { width, height }
+let cursorInterval = null;
+const cursorSequences = new Map(); // output -> sequence останнього надісланого стану
+const sentCursorShapes = new Set(); // 'output:shapeId' - пікселі форми вже на сервері
 
 console.log('🎥 Real Capture Client (NAPI)');
 console.log(`🔌 Підключення до ${SERVER_URL}...`);
 
+// Нативний цикл захоплення (старі збірки аддону його не мають - тоді setInterval)
+const useCaptureLoop = typeof nativeCapture.startCaptureLoop === 'function';
+let captureLoopRunning = false;
+
+// CAPTURE_OUTPUTS: 'all' або список індексів моніторів через кому ('0,1')
+function parseCaptureOutputs(value) {
+    if (!value) {
+        return undefined;
+    }
+    if (value === 'all') {
+        return 'all';
+    }
+    return value.split(',').map((index) => parseInt(index, 10)).filter((index) => !Number.isNaN(index));
+}
+
+// CAPTURE_REGION: 'x,y,width,height' у координатах монітора (вікно застосунку)
+function parseCaptureRegion(value) {
+    if (!value) {
+        return undefined;
+    }
+    const [x, y, width, height] = value.split(',').map((part) => parseInt(part, 10));
+    if ([x, y, width, height].some((part) => Number.isNaN(part))) {
+        console.warn(`⚠️ Невалідний CAPTURE_REGION: ${value} (очікується x,y,width,height)`);
+        return undefined;
+    }
+    return { x, y, width, height };
+}
+
+function buildCaptureConfig() {
+    // bgra - сирі кадри, delta - лише змінені плитки, jpeg - стиснення в аддоні, h264 - енкодер,
+    // tile - екранний кодек (текст/UI без втрат, решта - JPEG якості CAPTURE_QUALITY)
+    const codec = process.env.CAPTURE_CODEC || 'bgra';
+    const outputs = parseCaptureOutputs(process.env.CAPTURE_OUTPUTS);
+
+    const config = {
+        // Розмір кадру на виході; екран більшої роздільності масштабується в аддоні
+        width: parseInt(process.env.CAPTURE_WIDTH || '1280', 10),
+        height: parseInt(process.env.CAPTURE_HEIGHT || '720', 10),
+        scaleFilter: process.env.CAPTURE_SCALE_FILTER || 'box', // box | bilinear
+        fps: 30, // Збільшено до 30 FPS (з adaptive - максимум при русі)
+        adaptive: process.env.CAPTURE_ADAPTIVE !== '0', // Частота за вмістом: статичний екран -> minFps
+        minFps: parseInt(process.env.CAPTURE_MIN_FPS || '2', 10),
+        idleHoldMs: 500, // Скільки тримати частоту після останньої зміни
+        motionThreshold: 0.05, // Частка зміненого екрану, з якої - повна частота
+        codec: codec,
+        bitrate: codec === 'h264' ? 2000000 : 0,
+        useHardware: false,
+        encoderBackend: process.env.CAPTURE_ENCODER || 'auto', // auto | mf (Windows) | x264
+        tileSize: 64,
+        moveDetection: process.env.CAPTURE_MOVE_DETECTION !== '0', // delta: прокрутка - копіюванням прямокутників
+        // delta: кеш уже переданих плиток на сервері (перемикання вікон - посиланнями), 0 - вимкнено
+        tileCacheMaxBytes: parseInt(process.env.CAPTURE_TILE_CACHE_MB || '32', 10) * 1024 * 1024,
+        keyframeInterval: 300, // Повний кадр кожні ~10 секунд (delta)
+        jpegQuality: parseInt(process.env.CAPTURE_QUALITY || '80', 10),
+        poolDepth: 8, // Кадри передаються в JS без копіювання з пулу на 8 буферів
+        gopCache: true, // h264/delta: поточна група кадрів для глядачів, що підключаються пізніше
+        gopCacheMaxBytes: 32 * 1024 * 1024,
+        maxQueue: 2, // Нативний цикл: не більше 2 кадрів очікують JS (старі відкидаються)
+        pipelineSlots: 3, // Кадри одночасно в стадіях capture -> convert -> encode
+        backend: process.env.CAPTURE_BACKEND || 'auto', // auto | dxgi | x11 | synthetic | replay
+        syntheticScenario: process.env.CAPTURE_SCENARIO || 'mixed', // mixed | text | video | idle
+        threads: parseInt(process.env.CAPTURE_THREADS || '0', 10), // 0 = авто (до 8 потоків, ділиться між виходами)
+        stitch: process.env.CAPTURE_STITCH === '1', // Вибрані монітори - один склеєний кадр
+        syntheticOutputs: parseInt(process.env.CAPTURE_SYNTHETIC_OUTPUTS || '1', 10),
+        cursor: process.env.CAPTURE_CURSOR !== '0' // Вказівник окремим каналом: рух не дає нового кадру
+    };
+    if (outputs !== undefined) {
+        config.outputs = outputs; // Кожен монітор - окрема сесія з власним конвеєром
+    }
+    const region = parseCaptureRegion(process.env.CAPTURE_REGION);
+    if (region !== undefined) {
+        config.region = region; // Лише цей прямокутник читається, конвертується і кодується
+    }
+    if (process.env.CAPTURE_REPLAY) {
+        // Відтворення запису замість екрану (CAPTURE_BACKEND=replay)
+        config.replayPath = process.env.CAPTURE_REPLAY;
+        config.replaySpeed = process.env.CAPTURE_REPLAY_SPEED || 'original'; // original | max
+        config.replayLoop = process.env.CAPTURE_REPLAY_LOOP !== '0';
+    }
+    if (process.env.CAPTURE_RECORD) {
+        config.recordPath = process.env.CAPTURE_RECORD; // Захоплені кадри - у файл для replay
+        config.recordDelta = process.env.CAPTURE_RECORD_DELTA !== '0';
+    }
+    return config;
+}
+
+function handleInitResult(result) {
+    if (result.success) {
+        // Зберегти реальні розміри захоплення
+        captureWidth = result.width;
+        captureHeight = result.height;
+        outputSizes.clear();
+        const sessions = result.outputs || [result];
+        captureOutputs = sessions.map((session) => session.output || 0);
+        for (const session of sessions) {
+            outputSizes.set(session.output || 0, { width: session.width, height: session.height });
+        }
+        if (result.recordPath) {
+            console.log(`⏺️ Запис кадрів у ${result.recordPath}`);
+        }
+        if (result.region) {
+            console.log(`🔲 Регіон ${result.region.width}x${result.region.height} з (${result.region.x}, ${result.region.y})`);
+        }
+        const scaled = result.scaleFilter ? ` (з ${result.sourceWidth}x${result.sourceHeight}, ${result.scaleFilter})` : '';
+        const rate = result.adaptive ? `${result.minFps}-30 FPS адаптивно` : '30 FPS';
+        console.log(`✅ Захоплення ініціалізовано: ${captureWidth}x${captureHeight}${scaled} @ ${rate} (${result.backend}, ${result.encoder ? `${result.codec}/${result.encoder}` : result.codec}, ${result.threads} потоків)`);
+        if (sessions.length > 1 || result.stitched) {
+            const layout = result.stitched ? `склеєно ${result.layout.length} моніторів` : `моніторів ${sessions.length}`;
+            console.log(`🖥️ ${layout}: ${sessions.map((s) => `#${s.output} ${s.width}x${s.height}`).join(', ')}`);
+        }
+        isInitialized = true;
+        if (result.cursor) {
+            startCursorChannel();
+        }
+        return true;
+    } else {
+        console.error('❌ Помилка ініціалізації:', result.error);
+        console.log('⚠️ Продовжуємо з тестовими даними...');
+        return false;
+    }
+}
+
 // Спочатку ініціалізуємо NAPI аддон
 function initializeCapture() {
+    // Нативний цикл ініціалізує захоплення сам у startCapture()
+    if (useCaptureLoop) {
+        return true;
+    }
+
     try {
         console.log('🚀 Ініціалізація захоплення екрану (БЕЗ енкодера)...');
-        
-        const result = nativeCapture.initialize({
-            width: 1280,
-            height: 720,
-            fps: 30, // Збільшено до 30 FPS
-            bitrate: 0, // Не використовувати енкодер
-            useHardware: false
-        });
-
-        if (result.success) {
-            // Зберегти реальні розміри захоплення
-            captureWidth = result.width;
-            captureHeight = result.height;
-            console.log(`✅ Захоплення ініціалізовано: ${captureWidth}x${captureHeight} @ 30 FPS`);
-            isInitialized = true;
-            return true;
-        } else {
-            console.error('❌ Помилка ініціалізації:', result.error);
-            console.log('⚠️ Продовжуємо з тестовими даними...');
-            return false;
-        }
+        return handleInitResult(nativeCapture.initialize(buildCaptureConfig()));
     } catch (error) {
         console.error('❌ Виняток при ініціалізації:', error.message);
         return false;
@@ -125,7 +237,7 @@ function handleCommand(command) {
     switch (command.type) {
         case 'start_capture':
             console.log('▶️ Команда: почати захоплення');
-            if (!captureInterval) {
+            if (!captureInterval && !captureLoopRunning) {
                 initializeCapture();
                 startCapture();
             }
@@ -135,31 +247,146 @@ function handleCommand(command) {
             console.log('⏹️ Команда: зупинити захоплення');
             stopCapture();
             break;
+
+        case 'replay_gop':
+            replayGop(command.viewerId);
+            break;
+    }
+}
+
+// Новий глядач посеред потоку: повторити поточну групу кадрів з нативного кешу
+// (keyframe + SPS/PPS + наступні кадри) лише для нього, без примусового keyframe для всіх
+function replayGop(viewerId) {
+    if (typeof nativeCapture.getGopFrames !== 'function') {
+        return;
+    }
+    // У кожного монітора - власна група кадрів
+    for (const output of captureOutputs) {
+        const gop = nativeCapture.getGopFrames(output);
+        if (!gop.success || !gop.complete) {
+            // Кешу немає або група перевищила ліміт - глядач чекає наступного keyframe
+            nativeCapture.requestKeyframe(output);
+            continue;
+        }
+        for (const frame of gop.frames) {
+            const extra = { replay: true, viewerId: viewerId, output: output, ...h264Metadata(frame) };
+            if (frame.parameterSets) {
+                extra.parameterSets = true;
+            }
+            sendFrame(frame.data, frame.size, true, frame.codec, frame.keyframe, extra);
+        }
+        console.log(`🔁 Група кадрів для ${viewerId} (монітор ${output}): ${gop.frames.length} кадрів, ${(gop.bytes / 1024).toFixed(1)} KB`);
     }
 }
 
 function startCapture() {
-    if (captureInterval) {
+    if (captureInterval || captureLoopRunning) {
         console.log('⚠️ Захоплення вже запущено');
         return;
     }
     
     console.log('▶️ Починаємо захоплення екрану (30 FPS)...');
     frameNumber = 0;
+
+    if (useCaptureLoop) {
+        // Захоплення, конвертація і кодування на нативному потоці,
+        // кадри приходять у колбек без блокування event loop
+        try {
+            const result = nativeCapture.startCaptureLoop(buildCaptureConfig(), (frame) => {
+                frameNumber++;
+                handleFrameResult(frame);
+            });
+            captureLoopRunning = handleInitResult(result);
+        } catch (error) {
+            console.error('❌ Не вдалося запустити нативний цикл:', error.message);
+        }
+        return;
+    }
     
-    // Захоплювати кадри з частотою 30 FPS
-    captureInterval = setInterval(() => {
-        captureAndSendFrame();
-    }, 33); // ~33ms = 30 FPS
+    // Наступне захоплення - через nextCaptureMs від планувальника аддону
+    // (без нього - фіксовані ~33ms = 30 FPS)
+    const scheduleCapture = (delayMs) => {
+        captureInterval = setTimeout(() => {
+            const nextMs = captureAndSendFrame();
+            if (captureInterval) {
+                scheduleCapture(nextMs !== undefined ? nextMs : 33);
+            }
+        }, delayMs);
+    };
+    scheduleCapture(0);
+}
+
+// Канал курсора: позиція і id форми (~100 байт) при кожній зміні, пікселі форми -
+// лише першого разу для кожного id (сервер кешує їх для нових глядачів)
+function startCursorChannel() {
+    if (cursorInterval || typeof nativeCapture.getCursor !== 'function') {
+        return;
+    }
+    cursorSequences.clear();
+    sentCursorShapes.clear();
+    // Трекер оновлюється захопленням (до maxFps) - частіше опитувати нема сенсу
+    cursorInterval = setInterval(pollCursor, 33);
+}
+
+function stopCursorChannel() {
+    if (cursorInterval) {
+        clearInterval(cursorInterval);
+        cursorInterval = null;
+    }
+}
+
+function pollCursor() {
+    if (!ws || ws.readyState !== WebSocket.OPEN) {
+        return;
+    }
+    for (const output of captureOutputs) {
+        const cursor = nativeCapture.getCursor(output);
+        // sequence 0 - бекенд ще не повідомив курсор (або не відстежує його)
+        if (!cursor || cursor.sequence === 0 || cursorSequences.get(output) === cursor.sequence) {
+            continue;
+        }
+        cursorSequences.set(output, cursor.sequence);
+
+        const message = {
+            type: 'cursor',
+            output: output,
+            x: cursor.x,
+            y: cursor.y,
+            visible: cursor.visible,
+            shapeId: cursor.shapeId,
+            sequence: cursor.sequence
+        };
+        const shapeKey = `${output}:${cursor.shapeId}`;
+        if (cursor.shapeId && !sentCursorShapes.has(shapeKey)) {
+            const shape = nativeCapture.getCursorShape(cursor.shapeId, output);
+            if (shape) {
+                // Непремультиплікована BGRA, крок width * 4
+                message.shape = {
+                    id: shape.id,
+                    width: shape.width,
+                    height: shape.height,
+                    hotX: shape.hotX,
+                    hotY: shape.hotY,
+                    data: shape.data.toString('base64')
+                };
+                sentCursorShapes.add(shapeKey);
+            }
+        }
+        ws.send(JSON.stringify(message));
+    }
 }
 
 function stopCapture() {
-    if (captureInterval) {
-        clearInterval(captureInterval);
-        captureInterval = null;
+    stopCursorChannel();
+    if (captureInterval || captureLoopRunning) {
+        if (captureInterval) {
+            clearTimeout(captureInterval);
+            captureInterval = null;
+        }
+        captureLoopRunning = false;
         console.log('⏹️ Захоплення зупинено');
         
-        // Очистити NAPI ресурси
+        // Очистити NAPI ресурси (stopCapture також зупиняє нативний цикл)
         try {
             nativeCapture.stopCapture();
         } catch (e) {
@@ -172,33 +399,109 @@ function captureAndSendFrame() {
     frameNumber++;
     
     try {
-        // Спробувати захопити кадр через NAPI
-        const result = nativeCapture.captureFrame();
-        
-        if (result.success && result.data) {
-            // Є дані (закодовані або RAW)
-            const isEncoded = result.encoded || false;
-            sendFrame(result.data, result.size, isEncoded);
-        } else {
-            // Помилка захоплення або немає даних
-            if (result.error && result.error !== 'NO_NEW_FRAME') {
-                if (frameNumber % 100 === 0) {
-                    console.log(`⚠️ ${result.error}`);
-                }
+        // Спробувати захопити кадр через NAPI (по кадру з кожного монітора)
+        let nextMs;
+        for (const output of captureOutputs) {
+            const result = nativeCapture.captureFrame(output);
+            handleFrameResult(result);
+            if (result.nextCaptureMs !== undefined) {
+                nextMs = nextMs === undefined ? result.nextCaptureMs : Math.min(nextMs, result.nextCaptureMs);
             }
-            // ВАЖЛИВО: НЕ відправляємо тестові кадри - вони мають неправильний розмір
-            // і викликають помилки Sharp при JPEG компресії
         }
+        return nextMs;
     } catch (error) {
         console.error('❌ Помилка при захопленні:', error.message);
         sendTestFrame();
     }
+    return undefined;
 }
 
-function sendFrame(frameData, size, isEncoded) {
-    // Використовуємо реальні розміри захоплення
-    const width = captureWidth;
-    const height = captureHeight;
+// Затримки стадій за останні 300 кадрів (p50/p99) і втрачені кадри
+function logNativeStats() {
+    if (typeof nativeCapture.getStats !== 'function') {
+        return;
+    }
+    const stats = nativeCapture.getStats();
+    const stages = Object.entries(stats.stages)
+        .filter(([, stage]) => stage.count > 0)
+        .map(([name, stage]) => `${name} ${stage.p50Ms.toFixed(1)}/${stage.p99Ms.toFixed(1)}`)
+        .join(', ');
+    const c = stats.counters;
+    console.log(`📊 Стадії p50/p99 мс: ${stages}; кадрів ${c.framesCaptured}, пропущено ${c.framesSkipped}, відкинуто ${c.framesDropped}, копій ${c.bufferCopies}`);
+    if (stats.scheduler) {
+        const s = stats.scheduler;
+        console.log(`🎚️ Частота ${s.fps.toFixed(1)} FPS (${s.minFps}-${s.maxFps}), змін ${(s.lastChange * 100).toFixed(1)}%, стрибків ${s.bursts}, відставань ${s.congested}`);
+    }
+    if (stats.cursor) {
+        const cursor = stats.cursor;
+        console.log(`🖱️ Курсор: позицій ${cursor.positionUpdates}, форм ${cursor.shapeUpdates} (з кешу ${cursor.shapeCacheHits}), у кеші ${cursor.shapes}`);
+    }
+    if (typeof nativeCapture.getArenaStats === 'function') {
+        const arena = nativeCapture.getArenaStats();
+        console.log(`🧱 Арена: виділень з купи ${arena.heapAllocations}, в роботі ${(arena.bytesInUse / 1048576).toFixed(1)} МБ, пік ${(arena.peakBytesInUse / 1048576).toFixed(1)} МБ`);
+    }
+    if (typeof nativeCapture.getBroadcastStats === 'function') {
+        for (const consumer of nativeCapture.getBroadcastStats().consumers) {
+            console.log(`📡 ${consumer.name}: черга ${consumer.queued}/${consumer.capacity}, відставання ${consumer.lagMs.toFixed(1)} мс, доставлено ${consumer.delivered}, відкинуто ${consumer.dropped}`);
+        }
+    }
+    nativeCapture.resetStats();
+}
+
+function handleFrameResult(result) {
+    if (result.success && result.data) {
+        // Є дані (закодовані або RAW)
+        const isEncoded = result.encoded || false;
+        const codec = result.codec || (isEncoded ? 'h264' : 'bgra');
+        const extra = { output: result.output || 0, ...h264Metadata(result) };
+        sendFrame(result.data, result.size, isEncoded, codec, result.keyframe || false, extra);
+
+        if (result.convertTimeMs !== undefined && frameNumber % 100 === 0) {
+            console.log(`⏱️ Конвертація BGRA -> NV12: ${result.convertTimeMs.toFixed(2)} ms`);
+        }
+
+        if (frameNumber % 300 === 0) {
+            const pool = nativeCapture.getFramePoolStats();
+            if (pool && pool.exhausted > 0) {
+                console.log(`⚠️ Пул кадрів вичерпувався ${pool.exhausted} разів (пік ${pool.peakInUse}/${pool.depth})`);
+            }
+            const loop = captureLoopRunning ? nativeCapture.getCaptureLoopStats() : null;
+            if (loop && loop.dropped > 0) {
+                console.log(`⚠️ Нативний цикл відкинув ${loop.dropped} кадрів (запізнень ${loop.late})`);
+            }
+            if (loop && loop.pipeline && loop.pipeline.sourceStalls > 0) {
+                // Найповільніша стадія обмежує FPS конвеєра
+                const slowest = loop.pipeline.stages.reduce((a, b) => (b.busyMs > a.busyMs ? b : a));
+                console.log(`⚠️ Конвеєр заповнений ${loop.pipeline.sourceStalls} разів, найповільніша стадія: ${slowest.name}`);
+            }
+            logNativeStats();
+        }
+    } else {
+        // Помилка захоплення або немає даних
+        if (result.error && result.error !== 'NO_NEW_FRAME') {
+            if (frameNumber % 100 === 0) {
+                console.log(`⚠️ ${result.error}`);
+            }
+        }
+        // ВАЖЛИВО: НЕ відправляємо тестові кадри - вони мають неправильний розмір
+        // і викликають помилки Sharp при JPEG компресії
+    }
+}
+
+// Структура h264 кадру з аддону (pts, NAL одиниці) для метаданих
+function h264Metadata(result) {
+    if (!result.nals) {
+        return null;
+    }
+    return { pts: result.pts, nals: result.nals, hasParameterSets: result.hasParameterSets };
+}
+
+// extra - додаткові поля метаданих (h264, повтор групи кадрів)
+function sendFrame(frameData, size, isEncoded, codec, keyframe, extra) {
+    // Використовуємо реальні розміри захоплення (у кожного монітора - свої)
+    const outputSize = extra && outputSizes.get(extra.output);
+    const width = outputSize ? outputSize.width : captureWidth;
+    const height = outputSize ? outputSize.height : captureHeight;
     
     // Метадані кадру
     const metadata = {
@@ -209,8 +512,12 @@ function sendFrame(frameData, size, isEncoded) {
         frameNumber: frameNumber,
         size: size,
         encoded: isEncoded,
-        codec: isEncoded ? 'h264' : 'bgra'
+        codec: codec,
+        keyframe: keyframe
     };
+    if (extra) {
+        Object.assign(metadata, extra);
+    }
     
     // Відправити метадані
     ws.send(JSON.stringify(metadata));
@@ -219,7 +526,7 @@ function sendFrame(frameData, size, isEncoded) {
     ws.send(frameData);
     
     if (frameNumber % 25 === 0) {
-        console.log(`📤 Кадр #${frameNumber} (${isEncoded ? 'H.264' : 'BGRA RAW'}, ${(size / 1024).toFixed(1)} KB)`);
+        console.log(`📤 Кадр #${frameNumber} (${codec.toUpperCase()}, ${(size / 1024).toFixed(1)} KB)`);
     }
 }
 
@@ -0,0 +1,89 @@
+/**
+ * Aligned Memory Helpers
+ * Вирівняні на кеш-лінію буфери для кадрів (SIMD + DMA-friendly)
+ */
+
+#ifndef ALIGNED_MEMORY_H
+#define ALIGNED_MEMORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include "buffer-arena.h"
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+constexpr size_t kFrameAlignment = 64;
+
+inline void* AlignedAlloc(size_t size, size_t alignment = kFrameAlignment) {
+    if (size == 0) {
+        return nullptr;
+    }
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment, size) != 0) {
+        return nullptr;
+    }
+    return ptr;
+#endif
+}
+
+inline void AlignedFree(void* ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+// Вирівняний буфер з одним власником (без ініціалізації вмісту).
+// Пам'ять береться з BufferArena: звільнений буфер повертається у вільний список
+// класу розміру, і наступний буфер того ж розміру не звертається до купи.
+class AlignedBuffer {
+public:
+    AlignedBuffer() {}
+    explicit AlignedBuffer(size_t size) { Resize(size); }
+    ~AlignedBuffer() { GetBufferArena().Free(data_); }
+
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    AlignedBuffer(AlignedBuffer&& other) noexcept
+        : data_(other.data_), size_(other.size_) {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    AlignedBuffer& operator=(AlignedBuffer&& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    // Вміст не зберігається; false при нестачі пам'яті
+    bool Resize(size_t size) {
+        if (size == size_) {
+            return true;
+        }
+        BufferArena& arena = GetBufferArena();
+        arena.Free(data_);
+        data_ = static_cast<uint8_t*>(arena.Allocate(size));
+        size_ = data_ ? size : 0;
+        return data_ != nullptr || size == 0;
+    }
+
+    uint8_t* data() { return data_; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+#endif // ALIGNED_MEMORY_H
@@ -0,0 +1,158 @@
+/**
+ * Buffer Arena Implementation
+ */
+
+#include "buffer-arena.h"
+#include "aligned-memory.h"
+#include <algorithm>
+
+BufferArena::BufferArena() {
+}
+
+BufferArena::~BufferArena() {
+    Trim();
+}
+
+namespace {
+
+struct BlockHeader {
+    size_t block_size;
+};
+
+uint8_t* ToData(void* block) {
+    return static_cast<uint8_t*>(block) + BufferArena::kHeaderSize;
+}
+
+void* ToBlock(void* data) {
+    return static_cast<uint8_t*>(data) - BufferArena::kHeaderSize;
+}
+
+} // namespace
+
+size_t BufferArena::GetBlockSize(size_t size) {
+    size += kHeaderSize;
+    if (size <= kMinBlockSize) {
+        return kMinBlockSize;
+    }
+    if (size <= kSmallClassLimit) {
+        size_t block = kMinBlockSize;
+        while (block < size) {
+            block <<= 1;
+        }
+        return block;
+    }
+    return (size + kLargeGranularity - 1) / kLargeGranularity * kLargeGranularity;
+}
+
+void* BufferArena::Allocate(size_t size) {
+    if (size == 0) {
+        return nullptr;
+    }
+    const size_t block_size = GetBlockSize(size);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        acquires_++;
+
+        // Найменший вільний блок не більше ніж удвічі за потрібний клас
+        for (auto it = free_lists_.lower_bound(block_size);
+             it != free_lists_.end() && it->first <= block_size * 2; ++it) {
+            if (it->second.empty()) {
+                continue;
+            }
+            void* block = it->second.back();
+            it->second.pop_back();
+            bytes_in_use_ += it->first;
+            peak_bytes_in_use_ = std::max(peak_bytes_in_use_, bytes_in_use_);
+            return ToData(block);
+        }
+
+        heap_allocations_++;
+        bytes_reserved_ += block_size;
+        bytes_in_use_ += block_size;
+        peak_bytes_in_use_ = std::max(peak_bytes_in_use_, bytes_in_use_);
+    }
+
+    // Новий блок виділяється поза mutex - інші стадії не чекають на ядро
+    void* block = AlignedAlloc(block_size, kFrameAlignment);
+    if (!block) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        acquires_--;
+        heap_allocations_--;
+        bytes_reserved_ -= block_size;
+        bytes_in_use_ -= block_size;
+        return nullptr;
+    }
+    static_cast<BlockHeader*>(block)->block_size = block_size;
+    return ToData(block);
+}
+
+void BufferArena::Free(void* data) {
+    if (!data) {
+        return;
+    }
+    void* block = ToBlock(data);
+    const size_t block_size = static_cast<BlockHeader*>(block)->block_size;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    releases_++;
+    bytes_in_use_ -= block_size;
+    // Ємність вільного списку росте лише до піку класу - далі push_back без виділень
+    free_lists_[block_size].push_back(block);
+}
+
+bool BufferArena::Reserve(size_t size, int count) {
+    if (size == 0 || count <= 0) {
+        return true;
+    }
+    const size_t block_size = GetBlockSize(size);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<void*>& list = free_lists_[block_size];
+    list.reserve(list.size() + count);
+    while ((int)list.size() < count) {
+        void* block = AlignedAlloc(block_size, kFrameAlignment);
+        if (!block) {
+            return false;
+        }
+        static_cast<BlockHeader*>(block)->block_size = block_size;
+        heap_allocations_++;
+        bytes_reserved_ += block_size;
+        list.push_back(block);
+    }
+    return true;
+}
+
+void BufferArena::Trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : free_lists_) {
+        for (void* block : entry.second) {
+            AlignedFree(block);
+        }
+        bytes_reserved_ -= entry.first * entry.second.size();
+    }
+    free_lists_.clear();
+}
+
+BufferArenaStats BufferArena::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    BufferArenaStats stats;
+    stats.heap_allocations = heap_allocations_;
+    stats.acquires = acquires_;
+    stats.releases = releases_;
+    stats.bytes_reserved = bytes_reserved_;
+    stats.bytes_in_use = bytes_in_use_;
+    stats.peak_bytes_in_use = peak_bytes_in_use_;
+    for (const auto& entry : free_lists_) {
+        stats.free_blocks += entry.second.size();
+    }
+    stats.size_classes = (int)free_lists_.size();
+    return stats;
+}
+
+BufferArena& GetBufferArena() {
+    // Навмисно не знищується: статичні AlignedBuffer і фіналізатори JS
+    // можуть повертати блоки під час завершення процесу
+    static BufferArena* arena = new BufferArena();
+    return *arena;
+}
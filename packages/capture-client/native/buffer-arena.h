@@ -0,0 +1,103 @@
+/**
+ * Buffer Arena
+ * Спільне сховище вирівняних (64 байти) блоків для всіх нативних стадій: блоки
+ * розбиті на класи розмірів і після звільнення повертаються у вільний список класу,
+ * тож у сталому режимі захоплення кадр не виділяє пам'ять з купи.
+ */
+
+#ifndef BUFFER_ARENA_H
+#define BUFFER_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <new>
+#include <vector>
+
+struct BufferArenaStats {
+    uint64_t heap_allocations = 0;  // Нові блоки з купи (у сталому режимі не ростуть)
+    uint64_t acquires = 0;          // Видачі блоків (з вільного списку або нові)
+    uint64_t releases = 0;
+    size_t bytes_reserved = 0;      // Усі блоки арени (видані + вільні)
+    size_t bytes_in_use = 0;
+    size_t peak_bytes_in_use = 0;   // High-water mark
+    size_t free_blocks = 0;
+    int size_classes = 0;
+};
+
+class BufferArena {
+public:
+    // Малі класи - степені двійки від 256 Б до 64 КБ, великі - кратні 64 КБ
+    // (кадри однієї роздільності потрапляють у той самий клас, втрата < 64 КБ на блок)
+    static constexpr size_t kMinBlockSize = 256;
+    static constexpr size_t kSmallClassLimit = 64 * 1024;
+    static constexpr size_t kLargeGranularity = 64 * 1024;
+    // Заголовок перед даними (розмір блоку); кратний вирівнюванню кадрів
+    static constexpr size_t kHeaderSize = 64;
+
+    BufferArena();
+    ~BufferArena();
+
+    BufferArena(const BufferArena&) = delete;
+    BufferArena& operator=(const BufferArena&) = delete;
+
+    // Розмір блоку класу (із заголовком), в який потрапляє запит size
+    static size_t GetBlockSize(size_t size);
+
+    // Вирівняний блок щонайменше size байт; nullptr при нестачі пам'яті.
+    // Якщо класу бракує вільного блоку, береться вільний з більшого класу (до 2x) -
+    // закодовані кадри змінного розміру не множать нові виділення.
+    void* Allocate(size_t size);
+    void Free(void* block);
+
+    // Попередньо виділити блоки, щоб у класі size було count вільних (initialize)
+    bool Reserve(size_t size, int count);
+    // Повернути системі всі вільні блоки (повторна ініціалізація з іншими розмірами)
+    void Trim();
+
+    BufferArenaStats GetStats() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::map<size_t, std::vector<void*>> free_lists_;   // Розмір блоку -> вільні блоки
+
+    uint64_t heap_allocations_ = 0;
+    uint64_t acquires_ = 0;
+    uint64_t releases_ = 0;
+    size_t bytes_reserved_ = 0;
+    size_t bytes_in_use_ = 0;
+    size_t peak_bytes_in_use_ = 0;
+};
+
+// Арена процесу (як і статистика - одна на аддон, живе до виходу з процесу,
+// бо блоки можуть повертатися з фіналізаторів JS після cleanup)
+BufferArena& GetBufferArena();
+
+// Аллокатор STL поверх арени (allocate_shared для дрібних об'єктів на кадр)
+template <typename T>
+struct ArenaAllocator {
+    typedef T value_type;
+
+    ArenaAllocator() {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        void* block = GetBufferArena().Allocate(n * sizeof(T));
+        if (!block) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(block);
+    }
+    void deallocate(T* block, size_t) {
+        GetBufferArena().Free(block);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>&) const { return false; }
+};
+
+#endif // BUFFER_ARENA_H
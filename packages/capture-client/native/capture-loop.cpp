@@ -0,0 +1,197 @@
+/**
+ * Native Capture Loop Implementation
+ */
+
+#include "capture-loop.h"
+#include "stats.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+CaptureLoop::CaptureLoop() {
+}
+
+CaptureLoop::~CaptureLoop() {
+    Stop();
+}
+
+bool CaptureLoop::Start(int fps, size_t max_queue, ProduceFunc produce, NotifyFunc notify,
+                        ReleaseFunc release) {
+    if (running_ || fps <= 0 || !produce || !notify || !release) {
+        return false;
+    }
+
+    fps_ = fps;
+    max_queue_ = max_queue > 0 ? max_queue : 1;
+    produce_ = produce;
+    notify_ = notify;
+    release_ = release;
+    notify_pending_ = false;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        queue_.assign(max_queue_, LoopFrame());
+        queue_head_ = 0;
+        queue_count_ = 0;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&CaptureLoop::ThreadMain, this);
+    return true;
+}
+
+void CaptureLoop::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex_);
+        running_ = false;
+    }
+    stop_cv_.notify_all();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    // Недоставлені кадри повертаються в пул
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    LoopFrame frame;
+    while (queue_count_ > 0) {
+        PopFront(frame);
+        release_(frame);
+    }
+}
+
+void CaptureLoop::PopFront(LoopFrame& frame) {
+    // Викликається під queue_mutex_ з непорожньою чергою
+    frame = queue_[queue_head_];
+    queue_head_ = (queue_head_ + 1) % queue_.size();
+    queue_count_--;
+}
+
+void CaptureLoop::WaitUntil(Clock::time_point deadline) {
+    // Сон з запасом 1 мс (перерваний Stop), далі - доточнення yield-циклом
+    const auto spin_margin = std::chrono::milliseconds(1);
+    {
+        std::unique_lock<std::mutex> lock(stop_mutex_);
+        stop_cv_.wait_until(lock, deadline - spin_margin, [this] { return !running_; });
+    }
+
+    while (running_ && Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+void CaptureLoop::ThreadMain() {
+#ifdef _WIN32
+    // Підвищити роздільність системного таймера для точного темпу
+    timeBeginPeriod(1);
+#endif
+
+    auto interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / fps_));
+    auto deadline = Clock::now();
+
+    while (running_) {
+        LoopFrame frame;
+        frame.timestamp_ms = std::chrono::duration<double, std::milli>(
+            Clock::now().time_since_epoch()).count();
+        frame.sequence = sequence_ + 1;
+
+        ProduceResult produced = produce_(frame);
+        if (produced == ProduceResult::Idle) {
+            idle_++;
+        } else {
+            sequence_++;
+            if (produced == ProduceResult::Ready) {
+                Push(frame);
+            }
+        }
+
+        if (scheduler_) {
+            interval = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double, std::milli>(scheduler_->GetIntervalMs()));
+        }
+        deadline += interval;
+        auto now = Clock::now();
+        if (now >= deadline) {
+            // Ітерація довша за інтервал - не наздоганяти пропущені кадри
+            late_++;
+            deadline = now;
+            continue;
+        }
+
+        WaitUntil(deadline);
+    }
+
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+void CaptureLoop::Deliver(LoopFrame& frame) {
+    Push(frame);
+}
+
+void CaptureLoop::Push(LoopFrame& frame) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        // Цикл зупинено - Stop() уже вичистив чергу, споживача більше немає
+        if (!running_) {
+            release_(frame);
+            return;
+        }
+
+        // Споживач відстає - відкинути найстаріший кадр
+        while (queue_count_ >= queue_.size()) {
+            LoopFrame oldest;
+            PopFront(oldest);
+            release_(oldest);
+            if (scheduler_) {
+                scheduler_->ReportCongestion();
+            }
+            dropped_++;
+            GetCaptureStats().Add(StatCounter::FramesDropped);
+        }
+        queue_[(queue_head_ + queue_count_) % queue_.size()] = frame;
+        queue_count_++;
+        produced_++;
+    }
+
+    // Одне повідомлення на серію кадрів - споживач вичитує всю чергу
+    if (!notify_pending_.exchange(true)) {
+        notify_();
+    }
+}
+
+void CaptureLoop::BeginDrain() {
+    notify_pending_ = false;
+}
+
+bool CaptureLoop::Pop(LoopFrame& frame) {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (queue_count_ == 0) {
+        return false;
+    }
+
+    PopFront(frame);
+    delivered_++;
+    return true;
+}
+
+CaptureLoopStats CaptureLoop::GetStats() const {
+    CaptureLoopStats stats;
+    stats.running = running_;
+    stats.fps = fps_;
+    stats.produced = produced_;
+    stats.delivered = delivered_;
+    stats.dropped = dropped_;
+    stats.idle = idle_;
+    stats.late = late_;
+
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    stats.queue_depth = queue_count_;
+    return stats;
+}
@@ -0,0 +1,123 @@
+/**
+ * Native Capture Loop
+ * Окремий потік захоплення з точним темпом кадрів і обмеженою чергою доставки
+ * (при відставанні споживача відкидаються найстаріші кадри)
+ */
+
+#ifndef CAPTURE_LOOP_H
+#define CAPTURE_LOOP_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <vector>
+#include "capture-scheduler.h"
+#include "h264-parser.h"
+
+// Готовий кадр, що очікує доставки в JS
+struct LoopFrame {
+    uint8_t* data = nullptr;    // Буфер з FramePool
+    size_t size = 0;
+    const char* codec = "bgra";
+    bool encoded = false;
+    bool keyframe = false;
+    bool has_delta_info = false;
+    int tiles = 0;
+    int moves = 0;
+    bool has_h264_info = false;
+    H264Packet h264;            // NAL одиниці кадру h264 (зміщення в data)
+    double convert_ms = -1.0;   // < 0 - конвертації не було
+    double timestamp_ms = 0.0;  // Час захоплення (steady clock)
+    uint64_t sequence = 0;
+};
+
+// Результат однієї ітерації захоплення
+enum class ProduceResult {
+    Idle,       // Нового кадру немає (або помилка)
+    Ready,      // Кадр готовий - поставити в чергу доставки
+    Forwarded   // Кадр переданий у конвеєр, буде доставлений через Deliver()
+};
+
+struct CaptureLoopStats {
+    bool running = false;
+    int fps = 0;
+    uint64_t produced = 0;      // Кадри, поставлені в чергу
+    uint64_t delivered = 0;     // Кадри, забрані споживачем
+    uint64_t dropped = 0;       // Відкинуті через переповнення черги
+    uint64_t idle = 0;          // Ітерації без нового кадру
+    uint64_t late = 0;          // Пропущені дедлайни (ітерація довша за інтервал)
+    size_t queue_depth = 0;
+};
+
+class CaptureLoop {
+public:
+    // Захопити кадр (timestamp_ms і sequence вже заповнені циклом)
+    typedef std::function<ProduceResult(LoopFrame& frame)> ProduceFunc;
+    // Повідомити споживача, що в черзі з'явилися кадри (з потоку захоплення)
+    typedef std::function<void()> NotifyFunc;
+    // Звільнити кадр, який не буде доставлено
+    typedef std::function<void(LoopFrame& frame)> ReleaseFunc;
+
+    CaptureLoop();
+    ~CaptureLoop();
+
+    // Адаптивний темп (до Start): інтервал береться з планувальника, fps - лише
+    // початкове значення; переповнення черги повідомляється йому як відставання
+    void SetScheduler(std::shared_ptr<CaptureScheduler> scheduler) { scheduler_ = scheduler; }
+
+    bool Start(int fps, size_t max_queue, ProduceFunc produce, NotifyFunc notify, ReleaseFunc release);
+    // Зупинити потік і звільнити недоставлені кадри
+    void Stop();
+
+    // Поставити в чергу кадр, переданий раніше в конвеєр (з будь-якого потоку).
+    // Після Stop() кадр одразу звільняється.
+    void Deliver(LoopFrame& frame);
+
+    // Споживач: викликати перед вичитуванням черги, потім Pop() до false
+    void BeginDrain();
+    bool Pop(LoopFrame& frame);
+
+    bool IsRunning() const { return running_; }
+    CaptureLoopStats GetStats() const;
+
+private:
+    void ThreadMain();
+    void Push(LoopFrame& frame);
+    void WaitUntil(std::chrono::steady_clock::time_point deadline);
+    void PopFront(LoopFrame& frame);
+
+    ProduceFunc produce_;
+    NotifyFunc notify_;
+    ReleaseFunc release_;
+    std::shared_ptr<CaptureScheduler> scheduler_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::mutex stop_mutex_;
+    std::condition_variable stop_cv_;
+
+    mutable std::mutex queue_mutex_;
+    // Кільце фіксованого розміру (виділяється в Start): LoopFrame великий,
+    // і deque виділяв би новий блок майже на кожен кадр
+    std::vector<LoopFrame> queue_;
+    size_t queue_head_ = 0;
+    size_t queue_count_ = 0;
+    size_t max_queue_ = 2;
+    std::atomic<bool> notify_pending_{false};
+
+    int fps_ = 30;
+    uint64_t sequence_ = 0;
+    std::atomic<uint64_t> produced_{0};
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> idle_{0};
+    std::atomic<uint64_t> late_{0};
+};
+
+#endif // CAPTURE_LOOP_H
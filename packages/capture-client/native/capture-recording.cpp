@@ -0,0 +1,518 @@
+/**
+ * Capture Recording Implementation
+ */
+
+#include "capture-recording.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+inline uint64_t AlignRecord(uint64_t offset) {
+    return (offset + CaptureRecorder::kRecordAlignment - 1) & ~(uint64_t)(CaptureRecorder::kRecordAlignment - 1);
+}
+
+inline uint64_t GetRectBytes(const FrameRect& rect) {
+    return (uint64_t)rect.width * rect.height * 4;
+}
+
+} // namespace
+
+// ============================================================
+// CaptureRecorder
+// ============================================================
+
+CaptureRecorder::CaptureRecorder() {
+}
+
+CaptureRecorder::~CaptureRecorder() {
+    Close();
+}
+
+void CaptureRecorder::SetError(const std::string& error) {
+    last_error_ = error;
+}
+
+bool CaptureRecorder::Open(const std::string& path, int width, int height, PixelFormat format, bool delta,
+                           int tile_size) {
+    Close();
+
+    if (width <= 0 || height <= 0) {
+        SetError("Invalid frame size for recording");
+        return false;
+    }
+    if (!diff_.Initialize(width, height, tile_size)) {
+        SetError("Invalid recording tile size");
+        return false;
+    }
+    file_ = fopen(path.c_str(), "wb");
+    if (!file_) {
+        SetError("Failed to create recording: " + path);
+        return false;
+    }
+
+    path_ = path;
+    header_ = RecordingHeader();
+    header_.magic = kMagic;
+    header_.version = kVersion;
+    header_.format = (uint16_t)format;
+    header_.width = (uint32_t)width;
+    header_.height = (uint32_t)height;
+    header_.tile_size = (uint32_t)tile_size;
+    header_.flags = delta ? kFlagDelta : 0;
+    delta_ = delta;
+    offset_ = 0;
+    index_.clear();
+    frames_since_full_ = 0;
+    stats_ = RecorderStats();
+
+    // index_offset = 0, поки Close не допише індекс
+    if (!Write(&header_, sizeof(header_)) || !Pad()) {
+        fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool CaptureRecorder::Write(const void* data, size_t size) {
+    if (size > 0 && fwrite(data, 1, size, file_) != size) {
+        SetError("Failed to write recording: " + path_);
+        return false;
+    }
+    offset_ += size;
+    return true;
+}
+
+bool CaptureRecorder::Pad() {
+    static const uint8_t zeros[kRecordAlignment] = {};
+    return Write(zeros, (size_t)(AlignRecord(offset_) - offset_));
+}
+
+void CaptureRecorder::CollectDirtyRects(int dirty_tiles) {
+    // Сусідні змінені плитки рядка сітки - один прямокутник
+    dirty_rects_.clear();
+    if (dirty_tiles == 0) {
+        return;
+    }
+    const int tiles_x = diff_.GetTilesX();
+    for (int ty = 0; ty < diff_.GetTilesY(); ty++) {
+        for (int tx = 0; tx < tiles_x;) {
+            if (!dirty_tiles_[(size_t)ty * tiles_x + tx]) {
+                tx++;
+                continue;
+            }
+            int end = tx + 1;
+            while (end < tiles_x && dirty_tiles_[(size_t)ty * tiles_x + end]) {
+                end++;
+            }
+            int x, y, w, h, last_x, last_y, last_w, last_h;
+            diff_.GetTileRect(ty * tiles_x + tx, x, y, w, h);
+            diff_.GetTileRect(ty * tiles_x + end - 1, last_x, last_y, last_w, last_h);
+            FrameRect rect;
+            rect.x = x;
+            rect.y = y;
+            rect.width = last_x + last_w - x;
+            rect.height = h;
+            dirty_rects_.push_back(rect);
+            tx = end;
+        }
+    }
+}
+
+bool CaptureRecorder::WriteFrame(const FrameView& view, const std::vector<MoveRect>& moves) {
+    if (!file_) {
+        SetError("Recording not open");
+        return false;
+    }
+    if (!view.data || view.width != (int)header_.width || view.height != (int)header_.height ||
+        view.stride < view.width * 4) {
+        SetError("Frame does not match recording size");
+        return false;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (stats_.frames == 0) {
+        start_time_ = now;
+    }
+    const uint64_t timestamp_us = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        now - start_time_).count();
+
+    // Перше порівняння позначає всі плитки - перший кадр завжди повний
+    const int dirty_tiles = diff_.Compare(view.data, view.stride, dirty_tiles_);
+    CollectDirtyRects(dirty_tiles);
+    const uint64_t frame_bytes = (uint64_t)view.width * view.height * 4;
+    const bool full = !delta_ || frames_since_full_ == 0 || frames_since_full_ >= kFullFrameInterval ||
+                      dirty_tiles * 2 > diff_.GetTileCount();
+
+    RecordedFrameHeader frame = {};
+    frame.magic = kFrameMagic;
+    frame.type = full ? kFrameFull : kFrameDelta;
+    frame.timestamp_us = timestamp_us;
+    frame.dirty_count = (uint32_t)dirty_rects_.size();
+    frame.move_count = (uint32_t)moves.size();
+    if (full) {
+        frame.pixel_bytes = frame_bytes;
+    } else {
+        for (const FrameRect& rect : dirty_rects_) {
+            frame.pixel_bytes += GetRectBytes(rect);
+        }
+    }
+
+    RecordingIndexEntry entry = {};
+    entry.offset = offset_;
+    entry.timestamp_us = timestamp_us;
+    entry.type = frame.type;
+    const uint64_t start = offset_;
+
+    if (!Write(&frame, sizeof(frame)) ||
+        !Write(dirty_rects_.data(), dirty_rects_.size() * sizeof(FrameRect)) ||
+        !Write(moves.data(), moves.size() * sizeof(MoveRect)) || !Pad()) {
+        return false;
+    }
+    if (full) {
+        for (int y = 0; y < view.height; y++) {
+            if (!Write(view.Row(y), (size_t)view.width * 4)) {
+                return false;
+            }
+        }
+    } else {
+        for (const FrameRect& rect : dirty_rects_) {
+            for (int y = 0; y < rect.height; y++) {
+                if (!Write(view.Row(rect.y + y) + (size_t)rect.x * 4, (size_t)rect.width * 4)) {
+                    return false;
+                }
+            }
+        }
+    }
+    if (!Pad()) {
+        return false;
+    }
+
+    index_.push_back(entry);
+    frames_since_full_ = full ? 1 : frames_since_full_ + 1;
+    stats_.frames++;
+    stats_.full_frames += full ? 1 : 0;
+    stats_.bytes += offset_ - start;
+    stats_.raw_bytes += frame_bytes;
+    return true;
+}
+
+bool CaptureRecorder::Close() {
+    if (!file_) {
+        return true;
+    }
+
+    header_.frame_count = index_.size();
+    header_.index_offset = offset_;
+    header_.duration_us = index_.empty() ? 0 : index_.back().timestamp_us;
+    bool ok = Write(index_.data(), index_.size() * sizeof(RecordingIndexEntry));
+    if (ok && (fseek(file_, 0, SEEK_SET) != 0 || fwrite(&header_, sizeof(header_), 1, file_) != 1)) {
+        SetError("Failed to finalize recording: " + path_);
+        ok = false;
+    }
+    if (fclose(file_) != 0 && ok) {
+        SetError("Failed to finalize recording: " + path_);
+        ok = false;
+    }
+    file_ = nullptr;
+    return ok;
+}
+
+// ============================================================
+// CaptureRecording
+// ============================================================
+
+CaptureRecording::CaptureRecording() {
+}
+
+CaptureRecording::~CaptureRecording() {
+    Close();
+}
+
+void CaptureRecording::SetError(const std::string& error) {
+    last_error_ = error;
+}
+
+bool CaptureRecording::Map(const std::string& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        SetError("Failed to open recording: " + path);
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        SetError("Empty recording: " + path);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!data) {
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        SetError("Failed to map recording: " + path);
+        return false;
+    }
+    file_handle_ = file;
+    mapping_handle_ = mapping;
+    data_ = static_cast<const uint8_t*>(data);
+    size_ = (size_t)size.QuadPart;
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        SetError("Failed to open recording: " + path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        SetError("Empty recording: " + path);
+        return false;
+    }
+    void* data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // Відображення тримає файл і після close
+    close(fd);
+    if (data == MAP_FAILED) {
+        SetError("Failed to map recording: " + path);
+        return false;
+    }
+    // Відтворення йде підряд - ядро читає наперед
+    madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+    data_ = static_cast<const uint8_t*>(data);
+    size_ = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+void CaptureRecording::Unmap() {
+    if (!data_) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(static_cast<HANDLE>(mapping_handle_));
+    CloseHandle(static_cast<HANDLE>(file_handle_));
+    mapping_handle_ = nullptr;
+    file_handle_ = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool CaptureRecording::ValidateRecord(uint64_t offset, RecordedFrameHeader& frame, uint64_t& end) const {
+    if (offset % CaptureRecorder::kRecordAlignment != 0 || offset + sizeof(RecordedFrameHeader) > size_) {
+        return false;
+    }
+    memcpy(&frame, data_ + offset, sizeof(frame));
+    if (frame.magic != CaptureRecorder::kFrameMagic ||
+        (frame.type != CaptureRecorder::kFrameFull && frame.type != CaptureRecorder::kFrameDelta)) {
+        return false;
+    }
+
+    const uint64_t meta_end = offset + sizeof(frame) + (uint64_t)frame.dirty_count * sizeof(FrameRect) +
+                              (uint64_t)frame.move_count * sizeof(MoveRect);
+    const uint64_t pixels = AlignRecord(meta_end);
+    if (pixels > size_ || frame.pixel_bytes > size_ - pixels) {
+        return false;
+    }
+
+    // Прямокутники в межах кадру; дельта - пікселі рівно на всі прямокутники
+    const FrameRect* rects = reinterpret_cast<const FrameRect*>(data_ + offset + sizeof(frame));
+    uint64_t rect_bytes = 0;
+    for (uint32_t i = 0; i < frame.dirty_count; i++) {
+        const FrameRect& rect = rects[i];
+        if (rect.IsEmpty() || rect.x < 0 || rect.y < 0 || rect.x + rect.width > (int)header_.width ||
+            rect.y + rect.height > (int)header_.height) {
+            return false;
+        }
+        rect_bytes += GetRectBytes(rect);
+    }
+    const uint64_t frame_bytes = (uint64_t)header_.width * header_.height * 4;
+    if (frame.pixel_bytes != (frame.type == CaptureRecorder::kFrameFull ? frame_bytes : rect_bytes)) {
+        return false;
+    }
+    end = AlignRecord(pixels + frame.pixel_bytes);
+    return true;
+}
+
+bool CaptureRecording::Open(const std::string& path) {
+    Close();
+    if (!Map(path)) {
+        return false;
+    }
+    if (size_ < sizeof(RecordingHeader)) {
+        Close();
+        SetError("Not a capture recording: " + path);
+        return false;
+    }
+    memcpy(&header_, data_, sizeof(header_));
+    if (header_.magic != CaptureRecorder::kMagic || header_.version != CaptureRecorder::kVersion ||
+        header_.width == 0 || header_.height == 0 || header_.width > 0xFFFF || header_.height > 0xFFFF ||
+        header_.format > (uint16_t)PixelFormat::BGRX) {
+        Close();
+        SetError("Not a capture recording: " + path);
+        return false;
+    }
+
+    bool valid = true;
+    if (header_.index_offset != 0) {
+        const uint64_t index_bytes = header_.frame_count * sizeof(RecordingIndexEntry);
+        valid = header_.frame_count <= size_ && header_.index_offset <= size_ &&
+                index_bytes <= size_ - header_.index_offset;
+        if (valid) {
+            index_.resize((size_t)header_.frame_count);
+            memcpy(index_.data(), data_ + header_.index_offset, (size_t)index_bytes);
+        }
+        // Тип з індексу має збігатися із записом: replay бере його з запису, а повний
+        // перший кадр перевіряється за індексом
+        RecordedFrameHeader frame;
+        uint64_t end = 0;
+        for (size_t i = 0; valid && i < index_.size(); i++) {
+            valid = ValidateRecord(index_[i].offset, frame, end) && end <= header_.index_offset &&
+                    frame.type == index_[i].type;
+        }
+    } else {
+        // Запис обірвано до Close: кадри підряд до першого неповного
+        uint64_t offset = AlignRecord(sizeof(RecordingHeader));
+        RecordedFrameHeader frame;
+        uint64_t end = 0;
+        while (ValidateRecord(offset, frame, end)) {
+            RecordingIndexEntry entry = {};
+            entry.offset = offset;
+            entry.timestamp_us = frame.timestamp_us;
+            entry.type = frame.type;
+            index_.push_back(entry);
+            offset = end;
+        }
+        recovered_ = true;
+    }
+
+    // Дельта застосовується до попереднього кадру - відтворення починається з повного
+    if (valid && !index_.empty() && index_[0].type != CaptureRecorder::kFrameFull) {
+        valid = false;
+    }
+    if (!valid || index_.empty()) {
+        Close();
+        SetError(valid ? "Recording has no frames: " + path : "Corrupted recording: " + path);
+        return false;
+    }
+    return true;
+}
+
+void CaptureRecording::Close() {
+    Unmap();
+    header_ = RecordingHeader();
+    index_.clear();
+    recovered_ = false;
+}
+
+bool CaptureRecording::GetFrame(size_t index, RecordedFrame& frame) const {
+    if (index >= index_.size()) {
+        return false;
+    }
+    const uint64_t offset = index_[index].offset;
+    RecordedFrameHeader header;
+    memcpy(&header, data_ + offset, sizeof(header));
+
+    const uint8_t* meta = data_ + offset + sizeof(header);
+    frame.timestamp_us = header.timestamp_us;
+    frame.full = header.type == CaptureRecorder::kFrameFull;
+    frame.dirty = reinterpret_cast<const FrameRect*>(meta);
+    frame.dirty_count = (int)header.dirty_count;
+    frame.moves = reinterpret_cast<const MoveRect*>(meta + (size_t)header.dirty_count * sizeof(FrameRect));
+    frame.move_count = (int)header.move_count;
+    frame.pixels = data_ + AlignRecord(offset + sizeof(header) + (uint64_t)header.dirty_count * sizeof(FrameRect) +
+                                       (uint64_t)header.move_count * sizeof(MoveRect));
+    frame.pixel_bytes = (size_t)header.pixel_bytes;
+    return true;
+}
+
+// ============================================================
+// RecordingCapture
+// ============================================================
+
+RecordingCapture::RecordingCapture(std::unique_ptr<CaptureSource> source, const std::string& path, bool delta)
+    : source_(std::move(source)), path_(path), delta_(delta) {
+}
+
+RecordingCapture::~RecordingCapture() {
+    recorder_.Close();
+}
+
+bool RecordingCapture::Initialize(int width, int height) {
+    last_error_.clear();
+    if (!source_->Initialize(width, height)) {
+        return false;
+    }
+    // Формат view зберігається як є (BGRX X11 - без перепакування)
+    const PixelFormat format = source_->SupportsFrameView() ? source_->GetViewFormat() : PixelFormat::BGRA;
+    if (!recorder_.Open(path_, source_->GetWidth(), source_->GetHeight(), format, delta_)) {
+        last_error_ = recorder_.GetLastError();
+        return false;
+    }
+    return true;
+}
+
+std::string RecordingCapture::GetLastError() const {
+    return last_error_.empty() ? source_->GetLastError() : last_error_;
+}
+
+bool RecordingCapture::Record(const FrameView& view) {
+    source_->GetMoveRects(moves_);
+    if (!recorder_.WriteFrame(view, moves_)) {
+        last_error_ = recorder_.GetLastError();
+        return false;
+    }
+    return true;
+}
+
+bool RecordingCapture::CaptureFrame(uint8_t* dst, int dst_stride) {
+    last_error_.clear();
+    if (!source_->CaptureFrame(dst, dst_stride)) {
+        return false;
+    }
+    FrameView view;
+    view.data = dst;
+    view.stride = dst_stride;
+    view.width = source_->GetWidth();
+    view.height = source_->GetHeight();
+    return Record(view);
+}
+
+bool RecordingCapture::AcquireFrameView(FrameView& view) {
+    last_error_.clear();
+    if (!source_->AcquireFrameView(view)) {
+        return false;
+    }
+    if (!Record(view)) {
+        source_->ReleaseFrameView();
+        return false;
+    }
+    return true;
+}
+
+void RecordingCapture::Cleanup() {
+    if (!recorder_.Close()) {
+        last_error_ = recorder_.GetLastError();
+    }
+    source_->Cleanup();
+}
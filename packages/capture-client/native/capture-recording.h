@@ -0,0 +1,227 @@
+/**
+ * Capture Recording
+ * Запис захоплених кадрів в один файл, придатний для mmap: BGRA кадри (повні або
+ * лише змінені прямокутники), час захоплення, змінені області, переміщення та індекс.
+ * Бекенд replay (replay-capture.h) відтворює запис без копіювання повних кадрів.
+ */
+
+#ifndef CAPTURE_RECORDING_H
+#define CAPTURE_RECORDING_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "capture-source.h"
+#include "frame-view.h"
+#include "tile-diff.h"
+
+// Формат файлу (little-endian):
+//   RecordingHeader
+//   записи кадрів, кожен з межі kRecordAlignment:
+//     RecordedFrameHeader, FrameRect[dirty_count], MoveRect[move_count],
+//     пікселі з межі kRecordAlignment: повний кадр - рядки width * 4;
+//     дельта - рядки кожного зміненого прямокутника підряд
+//   індекс: RecordingIndexEntry[frame_count] з index_offset
+// index_offset = 0 - запис не завершено (обрив процесу); індекс відновлюється проходом по записах.
+struct RecordingHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t format;            // PixelFormat
+    uint32_t width;
+    uint32_t height;
+    uint32_t tile_size;         // Сітка, за якою визначено змінені області
+    uint32_t flags;
+    uint64_t frame_count;
+    uint64_t index_offset;
+    uint64_t duration_us;       // Час останнього кадру від першого
+    uint8_t reserved[16];
+};
+
+struct RecordedFrameHeader {
+    uint32_t magic;
+    uint16_t type;              // kFrameFull | kFrameDelta
+    uint16_t reserved;
+    uint64_t timestamp_us;      // Від першого кадру запису
+    uint32_t dirty_count;
+    uint32_t move_count;
+    uint64_t pixel_bytes;
+};
+
+struct RecordingIndexEntry {
+    uint64_t offset;            // Початок RecordedFrameHeader
+    uint64_t timestamp_us;
+    uint32_t type;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(RecordingHeader) == 64, "RecordingHeader layout");
+static_assert(sizeof(RecordedFrameHeader) == 32, "RecordedFrameHeader layout");
+static_assert(sizeof(RecordingIndexEntry) == 24, "RecordingIndexEntry layout");
+static_assert(sizeof(FrameRect) == 16 && sizeof(MoveRect) == 24, "Rect layout stored as is");
+
+struct RecorderStats {
+    uint64_t frames = 0;
+    uint64_t full_frames = 0;
+    uint64_t bytes = 0;             // Записано у файл
+    uint64_t raw_bytes = 0;         // Стільки ж кадрів повністю
+};
+
+// Кадр запису: вказівники в пам'ять відображеного файлу
+struct RecordedFrame {
+    uint64_t timestamp_us = 0;
+    bool full = true;
+    const FrameRect* dirty = nullptr;   // Області, змінені відносно попереднього кадру
+    int dirty_count = 0;
+    const MoveRect* moves = nullptr;    // Переміщення, які повідомило джерело
+    int move_count = 0;
+    const uint8_t* pixels = nullptr;
+    size_t pixel_bytes = 0;
+};
+
+class CaptureRecorder {
+public:
+    static constexpr uint32_t kMagic = 0x43455243;          // "CREC"
+    static constexpr uint32_t kFrameMagic = 0x4D524643;     // "CFRM"
+    static constexpr uint16_t kVersion = 1;
+    static constexpr uint16_t kFrameFull = 0;
+    static constexpr uint16_t kFrameDelta = 1;
+    static constexpr uint32_t kFlagDelta = 0x01;
+    static constexpr size_t kRecordAlignment = 64;
+    // Дельта-запис: повний кадр не рідше - відтворення з будь-якого місця недалеко
+    static constexpr int kFullFrameInterval = 300;
+
+    CaptureRecorder();
+    ~CaptureRecorder();
+
+    CaptureRecorder(const CaptureRecorder&) = delete;
+    CaptureRecorder& operator=(const CaptureRecorder&) = delete;
+
+    // delta = false - кожен кадр повністю (відтворення повністю без копіювання)
+    bool Open(const std::string& path, int width, int height, PixelFormat format, bool delta,
+              int tile_size = 64);
+    // Кадр розміру Open; moves - переміщення джерела (можуть бути порожні)
+    bool WriteFrame(const FrameView& view, const std::vector<MoveRect>& moves);
+    // Записати індекс і заголовок; після Close файл готовий до відтворення
+    bool Close();
+
+    bool IsOpen() const { return file_ != nullptr; }
+    const std::string& GetPath() const { return path_; }
+    RecorderStats GetStats() const { return stats_; }
+    std::string GetLastError() const { return last_error_; }
+
+private:
+    bool Write(const void* data, size_t size);
+    bool Pad();
+    void CollectDirtyRects(int dirty_tiles);
+    void SetError(const std::string& error);
+
+    FILE* file_ = nullptr;
+    std::string path_;
+    RecordingHeader header_ = {};
+    bool delta_ = false;
+    uint64_t offset_ = 0;
+    TileDiff diff_;
+    std::vector<uint8_t> dirty_tiles_;
+    std::vector<FrameRect> dirty_rects_;
+    std::vector<RecordingIndexEntry> index_;
+    std::chrono::steady_clock::time_point start_time_;
+    int frames_since_full_ = 0;
+    RecorderStats stats_;
+    std::string last_error_;
+};
+
+// Файл запису, відображений у пам'ять лише для читання
+class CaptureRecording {
+public:
+    CaptureRecording();
+    ~CaptureRecording();
+
+    CaptureRecording(const CaptureRecording&) = delete;
+    CaptureRecording& operator=(const CaptureRecording&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    bool GetFrame(size_t index, RecordedFrame& frame) const;
+    // Час кадру з індексу (без звернення до запису кадру)
+    uint64_t GetTimestampUs(size_t index) const { return index_[index].timestamp_us; }
+    bool IsFullFrame(size_t index) const { return index_[index].type == CaptureRecorder::kFrameFull; }
+
+    size_t GetFrameCount() const { return index_.size(); }
+    int GetWidth() const { return (int)header_.width; }
+    int GetHeight() const { return (int)header_.height; }
+    int GetStride() const { return (int)header_.width * 4; }
+    PixelFormat GetFormat() const { return (PixelFormat)header_.format; }
+    bool IsDelta() const { return (header_.flags & CaptureRecorder::kFlagDelta) != 0; }
+    // Індекс відновлено проходом по записах (запис не завершено)
+    bool IsRecovered() const { return recovered_; }
+    uint64_t GetDurationUs() const { return index_.empty() ? 0 : index_.back().timestamp_us; }
+    std::string GetLastError() const { return last_error_; }
+
+private:
+    bool Map(const std::string& path);
+    void Unmap();
+    // Запис кадру з offset цілий і в межах файлу; frame - його заголовок, end - кінець запису
+    bool ValidateRecord(uint64_t offset, RecordedFrameHeader& frame, uint64_t& end) const;
+    void SetError(const std::string& error);
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+#endif
+    RecordingHeader header_ = {};
+    std::vector<RecordingIndexEntry> index_;
+    bool recovered_ = false;
+    std::string last_error_;
+};
+
+// Джерело-обгортка: кожен кадр вкладеного джерела пишеться в запис,
+// решта викликів передається без змін. Запис завершується в Cleanup / деструкторі.
+class RecordingCapture : public CaptureSource {
+public:
+    RecordingCapture(std::unique_ptr<CaptureSource> source, const std::string& path, bool delta);
+    ~RecordingCapture() override;
+
+    bool Initialize(int width = 0, int height = 0) override;
+    bool CaptureFrame(uint8_t* dst, int dst_stride) override;
+    void Cleanup() override;
+
+    bool SetRegion(const FrameRect& region) override { return source_->SetRegion(region); }
+    bool SupportsFrameView() const override { return source_->SupportsFrameView(); }
+    bool AcquireFrameView(FrameView& view) override;
+    void ReleaseFrameView() override { source_->ReleaseFrameView(); }
+    PixelFormat GetViewFormat() const override { return source_->GetViewFormat(); }
+
+    void SetWorkerPool(WorkerPool* pool) override { source_->SetWorkerPool(pool); }
+    void SetCursorTracker(CursorTracker* tracker) override { source_->SetCursorTracker(tracker); }
+    void SetAcquireTimeout(unsigned int timeout_ms) override { source_->SetAcquireTimeout(timeout_ms); }
+    int GetAccumulatedFrames() const override { return source_->GetAccumulatedFrames(); }
+    bool GetMoveRects(std::vector<MoveRect>& moves) const override { return source_->GetMoveRects(moves); }
+    bool GetDirtyRects(std::vector<FrameRect>& rects) const override { return source_->GetDirtyRects(rects); }
+
+    const char* GetName() const override { return source_->GetName(); }
+    int GetWidth() const override { return source_->GetWidth(); }
+    int GetHeight() const override { return source_->GetHeight(); }
+    std::string GetLastError() const override;
+
+    const std::string& GetPath() const { return path_; }
+    RecorderStats GetRecorderStats() const { return recorder_.GetStats(); }
+
+private:
+    bool Record(const FrameView& view);
+
+    std::unique_ptr<CaptureSource> source_;
+    std::string path_;
+    bool delta_;
+    CaptureRecorder recorder_;
+    std::vector<MoveRect> moves_;
+    std::string last_error_;
+};
+
+#endif // CAPTURE_RECORDING_H
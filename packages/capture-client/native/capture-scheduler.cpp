@@ -0,0 +1,194 @@
+/**
+ * Adaptive Capture Scheduler Implementation
+ */
+
+#include "capture-scheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr uint64_t kHashSeed = 0x243F6A8885A308D3ULL;
+constexpr uint64_t kHashMultiplier = 0x9E3779B97F4A7C15ULL;
+
+// Рядок сканування ~1080p / 4: довші кадри читаються рідше, коротші - частіше
+constexpr int kSampledRows = 270;
+constexpr int kMaxRowStep = 8;
+
+inline uint64_t Mix(uint64_t hash, uint64_t value) {
+    hash = (hash ^ value) * kHashMultiplier;
+    return hash ^ (hash >> 29);
+}
+
+inline uint64_t Load64(const uint8_t* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Відбиток відрізка рядка: чотири незалежні ланцюжки (без залежності множень між словами)
+uint64_t HashBytes(const uint8_t* data, size_t size, uint64_t hash) {
+    uint64_t h0 = hash;
+    uint64_t h1 = hash + 1;
+    uint64_t h2 = hash + 2;
+    uint64_t h3 = hash + 3;
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        h0 = Mix(h0, Load64(data + i));
+        h1 = Mix(h1, Load64(data + i + 8));
+        h2 = Mix(h2, Load64(data + i + 16));
+        h3 = Mix(h3, Load64(data + i + 24));
+    }
+    for (; i + 8 <= size; i += 8) {
+        h0 = Mix(h0, Load64(data + i));
+    }
+    if (i < size) {
+        uint64_t tail = 0;
+        memcpy(&tail, data + i, size - i);
+        h1 = Mix(h1, tail);
+    }
+
+    return Mix(Mix(h0, h1), Mix(h2, h3));
+}
+
+} // namespace
+
+ChangeDetector::ChangeDetector() {
+}
+
+bool ChangeDetector::Initialize(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    width_ = width;
+    height_ = height;
+    row_step_ = std::max(1, std::min(height / kSampledRows, kMaxRowStep));
+    hashes_.assign(kGridColumns * kGridRows, 0);
+    previous_.assign(kGridColumns * kGridRows, 0);
+    has_previous_ = false;
+    return true;
+}
+
+double ChangeDetector::Measure(const uint8_t* frame, int stride) {
+    if (!frame || hashes_.empty()) {
+        return 1.0;
+    }
+
+    std::fill(hashes_.begin(), hashes_.end(), kHashSeed);
+
+    for (int y = 0; y < height_; y += row_step_) {
+        const uint8_t* row = frame + (size_t)y * stride;
+        uint64_t* band = hashes_.data() + (size_t)(y * kGridRows / height_) * kGridColumns;
+        for (int c = 0; c < kGridColumns; c++) {
+            int x0 = c * width_ / kGridColumns;
+            int x1 = (c + 1) * width_ / kGridColumns;
+            band[c] = HashBytes(row + (size_t)x0 * 4, (size_t)(x1 - x0) * 4, band[c]);
+        }
+    }
+
+    int changed = 0;
+    for (size_t i = 0; i < hashes_.size(); i++) {
+        changed += hashes_[i] != previous_[i];
+    }
+    hashes_.swap(previous_);
+
+    if (!has_previous_) {
+        has_previous_ = true;
+        return 1.0;
+    }
+    return (double)changed / (double)previous_.size();
+}
+
+CaptureScheduler::CaptureScheduler() {
+    Configure(config_);
+}
+
+bool CaptureScheduler::Configure(const CaptureSchedulerConfig& config) {
+    if (config.min_fps <= 0 || config.max_fps < config.min_fps || config.idle_hold_ms < 0 ||
+        config.motion_threshold <= 0.0 || config.motion_threshold > 1.0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    // Старт на максимумі: перші кадри (новий глядач, keyframe) не чекають розгону
+    fps_ = config.max_fps;
+    ceiling_fps_ = config.max_fps;
+    peak_ms_ = 0.0;
+    congestion_pending_ = false;
+    stats_ = CaptureSchedulerStats();
+    return true;
+}
+
+void CaptureScheduler::ReportFrame(double now_ms, double change, int accumulated_frames) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const double min_fps = config_.min_fps;
+    const double max_fps = config_.max_fps;
+
+    // Корінь: дрібні зміни (набір тексту, одна клітинка з 144) уже дають ~40% діапазону
+    double activity = std::sqrt(std::min(1.0, std::max(0.0, change) / config_.motion_threshold));
+    // Екран оновлювався кілька разів між захопленнями - поточна частота замала
+    if (accumulated_frames > 1) {
+        activity = 1.0;
+    }
+    double target = min_fps + (max_fps - min_fps) * activity;
+
+    if (change > 0.0 || accumulated_frames > 1) {
+        stats_.changed_frames++;
+    } else {
+        stats_.static_frames++;
+    }
+    stats_.last_change = change;
+
+    if (congestion_pending_) {
+        ceiling_fps_ = std::max(min_fps, fps_ * kCongestionFactor);
+        congestion_pending_ = false;
+        stats_.congested++;
+    } else {
+        ceiling_fps_ = std::min(max_fps, ceiling_fps_ * kCeilingRecovery);
+    }
+    target = std::min(target, ceiling_fps_);
+
+    if (target >= fps_) {
+        // Рух - підйом одразу, без розгону
+        if (target > fps_ + 1.0) {
+            stats_.bursts++;
+        }
+        fps_ = target;
+        peak_ms_ = now_ms;
+    } else if (now_ms - peak_ms_ >= config_.idle_hold_ms) {
+        fps_ = std::max(target, fps_ * kDecay);
+    }
+    fps_ = std::max(min_fps, std::min(fps_, ceiling_fps_));
+}
+
+void CaptureScheduler::ReportCursorMove(double now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.cursor_moves++;
+    if (ceiling_fps_ > fps_ + 1.0) {
+        stats_.bursts++;
+    }
+    fps_ = std::max(fps_, ceiling_fps_);
+    peak_ms_ = now_ms;
+}
+
+void CaptureScheduler::ReportCongestion() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    congestion_pending_ = true;
+}
+
+double CaptureScheduler::GetIntervalMs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return 1000.0 / fps_;
+}
+
+CaptureSchedulerStats CaptureScheduler::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CaptureSchedulerStats stats = stats_;
+    stats.fps = fps_;
+    return stats;
+}
@@ -0,0 +1,99 @@
+/**
+ * Adaptive Capture Scheduler
+ * Частота захоплення за вмістом: на статичному екрані спадає до minFps,
+ * при русі одразу піднімається до maxFps; відставання споживача її обмежує
+ */
+
+#ifndef CAPTURE_SCHEDULER_H
+#define CAPTURE_SCHEDULER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Частка зміненого екрану між двома кадрами за відбитками сітки клітинок.
+// Читається лише кожен step-й рядок (текстовий рядок чи курсор не пропускаються).
+class ChangeDetector {
+public:
+    static constexpr int kGridColumns = 16;
+    static constexpr int kGridRows = 9;
+
+    ChangeDetector();
+
+    bool Initialize(int width, int height);
+    // Наступне вимірювання поверне 1.0 (немає з чим порівнювати)
+    void Reset() { has_previous_ = false; }
+
+    // 0.0 - кадр не змінився, 1.0 - змінилися всі клітинки
+    double Measure(const uint8_t* frame, int stride);
+
+    int GetRowStep() const { return row_step_; }
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    int row_step_ = 1;
+    bool has_previous_ = false;
+    std::vector<uint64_t> hashes_;      // Відбитки клітинок поточного кадру
+    std::vector<uint64_t> previous_;
+};
+
+struct CaptureSchedulerConfig {
+    int min_fps = 2;
+    int max_fps = 30;
+    int idle_hold_ms = 500;             // Скільки тримати частоту після руху (гістерезис)
+    double motion_threshold = 0.05;     // Частка змінених клітинок для maxFps
+};
+
+struct CaptureSchedulerStats {
+    double fps = 0.0;                   // Поточна частота
+    double last_change = 0.0;           // Частка змін останнього кадру
+    uint64_t changed_frames = 0;
+    uint64_t static_frames = 0;         // Кадри без змін (або нового кадру не було)
+    uint64_t bursts = 0;                // Стрибки частоти вгору
+    uint64_t congested = 0;             // Зниження через відставання споживача
+    uint64_t cursor_moves = 0;          // Захоплення з рухом вказівника
+};
+
+// Політика: швидкий підйом до цілі за часткою змін (корінь - дрібні зміни теж
+// помітно прискорюють), утримання idle_hold_ms, далі експоненційний спад до minFps.
+// Методи потокобезпечні (цикл + стадії).
+class CaptureScheduler {
+public:
+    CaptureScheduler();
+
+    bool Configure(const CaptureSchedulerConfig& config);
+
+    // Результат спроби захоплення: change у [0, 1] (0 - кадру не було),
+    // accumulated_frames - оновлення екрану з попереднього захоплення (-1 - невідомо)
+    void ReportFrame(double now_ms, double change, int accumulated_frames);
+    // Вказівник змінився (до ReportFrame того ж захоплення): рух курсора йде окремим
+    // каналом і кадру не дає, але опитується лише захопленням - частота до стелі
+    void ReportCursorMove(double now_ms);
+    // Черга доставки переповнена або конвеєр без вільних слотів
+    void ReportCongestion();
+
+    // Інтервал до наступного захоплення
+    double GetIntervalMs() const;
+    const CaptureSchedulerConfig& GetConfig() const { return config_; }
+    CaptureSchedulerStats GetStats() const;
+
+private:
+    // Спад за одне захоплення після утримання (30 -> 2 кадри/с приблизно за 1.5 с)
+    static constexpr double kDecay = 0.8;
+    // Відставання споживача: стеля частоти знижується і повільно відновлюється
+    static constexpr double kCongestionFactor = 0.75;
+    static constexpr double kCeilingRecovery = 1.05;
+
+    CaptureSchedulerConfig config_;
+
+    mutable std::mutex mutex_;
+    double fps_ = 0.0;
+    double ceiling_fps_ = 0.0;
+    double peak_ms_ = 0.0;              // Останній раз, коли частота піднімалася або трималася
+    bool congestion_pending_ = false;
+    CaptureSchedulerStats stats_;
+};
+
+#endif // CAPTURE_SCHEDULER_H
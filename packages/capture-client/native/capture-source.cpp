@@ -0,0 +1,114 @@
+/**
+ * Capture Source Factory
+ */
+
+#include "capture-source.h"
+#include "replay-capture.h"
+#include "synthetic-capture.h"
+#include <algorithm>
+
+#ifdef _WIN32
+#include "screen-capture.h"
+#endif
+
+#ifdef CAPTURE_HAVE_X11
+#include "x11-capture.h"
+#endif
+
+const char* GetDefaultCaptureBackend() {
+#if defined(_WIN32)
+    return "dxgi";
+#elif defined(CAPTURE_HAVE_X11)
+    return "x11";
+#else
+    return "synthetic";
+#endif
+}
+
+namespace {
+
+std::string ResolveBackend(const CaptureSourceOptions& options) {
+    if (options.backend.empty() || options.backend == "auto") {
+        return GetDefaultCaptureBackend();
+    }
+    return options.backend;
+}
+
+} // namespace
+
+bool EnumerateCaptureOutputs(const CaptureSourceOptions& options,
+                             std::vector<CaptureOutputInfo>& outputs, std::string& error) {
+    std::string backend = ResolveBackend(options);
+    outputs.clear();
+
+    if (backend == "synthetic") {
+        SyntheticCapture::EnumerateOutputs(options.synthetic_outputs, outputs);
+        return true;
+    }
+    if (backend == "replay") {
+        return ReplayCapture::EnumerateOutputs(options.replay_path, outputs, error);
+    }
+
+#ifdef _WIN32
+    if (backend == "dxgi") {
+        return ScreenCapture::EnumerateOutputs(outputs, error);
+    }
+#endif
+
+#ifdef CAPTURE_HAVE_X11
+    if (backend == "x11") {
+        return X11Capture::EnumerateOutputs(options.display, outputs, error);
+    }
+#endif
+
+    error = "Capture backend not available on this platform: " + backend;
+    return false;
+}
+
+std::unique_ptr<CaptureSource> CreateCaptureSource(const CaptureSourceOptions& options,
+                                                   std::string& error) {
+    std::string backend = ResolveBackend(options);
+    if (options.output < 0) {
+        error = "Invalid output index: " + std::to_string(options.output);
+        return nullptr;
+    }
+
+    if (backend == "synthetic") {
+        SyntheticScenario scenario;
+        if (!SyntheticCapture::ParseScenario(options.scenario, scenario)) {
+            error = "Unknown synthetic scenario: " + options.scenario;
+            return nullptr;
+        }
+        if (options.output >= std::max(1, options.synthetic_outputs)) {
+            error = "Output not found: " + std::to_string(options.output);
+            return nullptr;
+        }
+        // Кожен імітований монітор - власний вміст
+        return std::unique_ptr<CaptureSource>(
+            new SyntheticCapture(scenario, options.fps, options.seed + (uint32_t)options.output));
+    }
+    if (backend == "replay") {
+        // Запис - один вихід
+        if (options.output != 0) {
+            error = "Output not found: " + std::to_string(options.output);
+            return nullptr;
+        }
+        return std::unique_ptr<CaptureSource>(
+            new ReplayCapture(options.replay_path, options.replay_realtime, options.replay_loop));
+    }
+
+#ifdef _WIN32
+    if (backend == "dxgi") {
+        return std::unique_ptr<CaptureSource>(new ScreenCapture(options.output));
+    }
+#endif
+
+#ifdef CAPTURE_HAVE_X11
+    if (backend == "x11") {
+        return std::unique_ptr<CaptureSource>(new X11Capture(options.display, options.output));
+    }
+#endif
+
+    error = "Capture backend not available on this platform: " + backend;
+    return nullptr;
+}
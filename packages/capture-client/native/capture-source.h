@@ -0,0 +1,102 @@
+/**
+ * Capture Source Interface
+ * Абстракція джерела кадрів: DXGI (Windows), X11 MIT-SHM (Linux), синтетичне, запис (replay)
+ */
+
+#ifndef CAPTURE_SOURCE_H
+#define CAPTURE_SOURCE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "frame-view.h"
+
+class WorkerPool;
+class CursorTracker;
+
+class CaptureSource {
+public:
+    static constexpr unsigned int kDefaultAcquireTimeoutMs = 100;
+
+    virtual ~CaptureSource() {}
+
+    // width/height = 0 -> розмір екрану (бекенд може ігнорувати запит - тоді кадр масштабує module.cpp)
+    virtual bool Initialize(int width = 0, int height = 0) = 0;
+    // Записати кадр у dst (BGRA, розмір >= dst_stride * height).
+    // false - нового кадру немає або помилка (GetLastError).
+    virtual bool CaptureFrame(uint8_t* dst, int dst_stride) = 0;
+    virtual void Cleanup() = 0;
+
+    // До Initialize: захоплювати лише прямокутник виходу (порожній - увесь вихід).
+    // Після Initialize GetWidth/GetHeight - розмір регіону. false - бекенд не підтримує регіон.
+    virtual bool SetRegion(const FrameRect& region) { return region.IsEmpty(); }
+
+    // Кадр без копіювання: view на пам'ять джерела (відображена staging texture,
+    // сегмент MIT-SHM), дійсний до ReleaseFrameView. false - нового кадру немає
+    // або помилка; тоді ReleaseFrameView не викликається.
+    virtual bool SupportsFrameView() const { return false; }
+    virtual bool AcquireFrameView(FrameView& view) { (void)view; return false; }
+    virtual void ReleaseFrameView() {}
+    // Формат view (CaptureFrame завжди пише BGRA з альфою 0xFF)
+    virtual PixelFormat GetViewFormat() const { return PixelFormat::BGRA; }
+
+    // Пул потоків для смугового копіювання рядків
+    virtual void SetWorkerPool(WorkerPool* pool) { (void)pool; }
+    // Позиція і форма вказівника окремим каналом (nullptr - не відстежувати).
+    // Рух курсора без змін екрану не дає нового кадру. Бекенди без курсора ігнорують.
+    virtual void SetCursorTracker(CursorTracker* tracker) { (void)tracker; }
+    // Скільки чекати на новий кадр (0 - не блокувати)
+    virtual void SetAcquireTimeout(unsigned int timeout_ms) { (void)timeout_ms; }
+    // Оновлення екрану, накопичені з попереднього захоплення (-1 - бекенд не знає)
+    virtual int GetAccumulatedFrames() const { return -1; }
+    // Переміщення блоків (DXGI move rects) останнього кадру в координатах кадру -
+    // підказка для пошуку прокрутки. false - бекенд їх не повідомляє (moves порожній).
+    virtual bool GetMoveRects(std::vector<MoveRect>& moves) const { moves.clear(); return false; }
+    // Області, змінені в останньому кадрі відносно попереднього (порожньо - кадр без змін).
+    // false - бекенд їх не повідомляє (rects порожній).
+    virtual bool GetDirtyRects(std::vector<FrameRect>& rects) const { rects.clear(); return false; }
+
+    virtual const char* GetName() const = 0;
+    virtual int GetWidth() const = 0;
+    virtual int GetHeight() const = 0;
+    virtual std::string GetLastError() const = 0;
+};
+
+// Вихід (монітор) у координатах робочого столу
+struct CaptureOutputInfo {
+    int index = 0;                      // Значення CaptureSourceOptions::output
+    std::string name;
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    bool primary = false;
+};
+
+// Параметри вибору бекенду
+struct CaptureSourceOptions {
+    std::string backend = "auto";       // auto | dxgi | x11 | synthetic | replay
+    int output = 0;                     // Індекс виходу з EnumerateCaptureOutputs
+    std::string scenario = "mixed";     // synthetic: mixed | text | video | idle
+    int fps = 30;                       // synthetic: частота нових кадрів
+    uint32_t seed = 1;                  // synthetic: детермінований вміст
+    int synthetic_outputs = 1;          // synthetic: скільки моніторів імітувати
+    std::string display;                // x11: ім'я дисплея (порожнє - $DISPLAY)
+    std::string replay_path;            // replay: файл запису (capture-recording.h)
+    bool replay_realtime = true;        // replay: темп оригіналу (false - якнайшвидше)
+    bool replay_loop = true;            // replay: після останнього кадру - знову з першого
+};
+
+// Бекенд за замовчуванням для поточної платформи
+const char* GetDefaultCaptureBackend();
+
+// Виходи бекенду options.backend (індекс у списку = index); false - бекенд недоступний
+bool EnumerateCaptureOutputs(const CaptureSourceOptions& options,
+                             std::vector<CaptureOutputInfo>& outputs, std::string& error);
+
+// nullptr, якщо бекенд невідомий або недоступний на цій платформі (error)
+std::unique_ptr<CaptureSource> CreateCaptureSource(const CaptureSourceOptions& options,
+                                                   std::string& error);
+
+#endif // CAPTURE_SOURCE_H
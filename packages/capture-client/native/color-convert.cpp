@@ -0,0 +1,408 @@
+/**
+ * BGRA -> YUV 4:2:0 Color Conversion Implementation
+ * Scalar еталон + SSE2/AVX2 ядра з ідентичною цілочисельною арифметикою
+ */
+
+#include "color-convert.h"
+#include "cpu-features.h"
+
+namespace {
+
+// ============================================================
+// Scalar еталон
+// ============================================================
+
+template <class C>
+inline uint8_t ScalarY(int b, int g, int r) {
+    return (uint8_t)(((C::kYR * r + C::kYG * g + C::kYB * b + 128) >> 8) + C::kYOffset);
+}
+
+template <class C>
+inline uint8_t ScalarU(int b, int g, int r) {
+    return (uint8_t)(((C::kUR * r + C::kUG * g + C::kUB * b + 128) >> 8) + 128);
+}
+
+template <class C>
+inline uint8_t ScalarV(int b, int g, int r) {
+    return (uint8_t)(((C::kVR * r + C::kVG * g + C::kVB * b + 128) >> 8) + 128);
+}
+
+// Обробити пікселі [x, width) - використовується як еталон і для хвостів SIMD ядер
+template <class C, bool kNV12>
+inline void RowPairScalarFrom(int x, const uint8_t* row0, const uint8_t* row1, int width,
+                              uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v) {
+    for (int i = x; i < width; i++) {
+        const uint8_t* p = row0 + i * 4;
+        if (y0) y0[i] = ScalarY<C>(p[0], p[1], p[2]);
+        if (y1) {
+            const uint8_t* q = row1 + i * 4;
+            y1[i] = ScalarY<C>(q[0], q[1], q[2]);
+        }
+    }
+
+    for (int i = x; i < width; i += 2) {
+        // Для непарної ширини останній стовпець дублюється
+        int i1 = (i + 1 < width) ? i + 1 : i;
+        const uint8_t* a = row0 + i * 4;
+        const uint8_t* b = row0 + i1 * 4;
+        const uint8_t* c = row1 + i * 4;
+        const uint8_t* d = row1 + i1 * 4;
+
+        int bb = (a[0] + b[0] + c[0] + d[0] + 2) >> 2;
+        int gg = (a[1] + b[1] + c[1] + d[1] + 2) >> 2;
+        int rr = (a[2] + b[2] + c[2] + d[2] + 2) >> 2;
+
+        if (kNV12) {
+            u[i] = ScalarU<C>(bb, gg, rr);
+            u[i + 1] = ScalarV<C>(bb, gg, rr);
+        } else {
+            u[i / 2] = ScalarU<C>(bb, gg, rr);
+            v[i / 2] = ScalarV<C>(bb, gg, rr);
+        }
+    }
+}
+
+template <class C, bool kNV12>
+void RowPairScalar(const uint8_t* row0, const uint8_t* row1, int width,
+                   uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v) {
+    RowPairScalarFrom<C, kNV12>(0, row0, row1, width, y0, y1, u, v);
+}
+
+#ifdef NATIVE_ARCH_X86
+
+// ============================================================
+// SSE2: 16 пікселів за ітерацію
+// ============================================================
+
+// 8 BGRA пікселів -> три вектори по 8 x int16 (B, G, R)
+NATIVE_TARGET_SSE2
+inline void LoadBGR8_SSE2(const uint8_t* p, __m128i& b, __m128i& g, __m128i& r) {
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+
+    b = _mm_packs_epi32(_mm_and_si128(v0, mask), _mm_and_si128(v1, mask));
+    g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(v0, 8), mask),
+                        _mm_and_si128(_mm_srli_epi32(v1, 8), mask));
+    r = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(v0, 16), mask),
+                        _mm_and_si128(_mm_srli_epi32(v1, 16), mask));
+}
+
+template <class C>
+NATIVE_TARGET_SSE2
+inline __m128i Luma_SSE2(__m128i b, __m128i g, __m128i r) {
+    // Сума не перевищує 65535, тому беззнакове 16-бітне переповнення неможливе
+    __m128i y = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(C::kYR)),
+                              _mm_mullo_epi16(g, _mm_set1_epi16(C::kYG)));
+    y = _mm_add_epi16(y, _mm_mullo_epi16(b, _mm_set1_epi16(C::kYB)));
+    y = _mm_srli_epi16(_mm_add_epi16(y, _mm_set1_epi16(128)), 8);
+    return _mm_add_epi16(y, _mm_set1_epi16(C::kYOffset));
+}
+
+template <int KR, int KG, int KB>
+NATIVE_TARGET_SSE2
+inline __m128i Chroma_SSE2(__m128i b, __m128i g, __m128i r) {
+    __m128i c = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(KR)),
+                              _mm_mullo_epi16(g, _mm_set1_epi16(KG)));
+    c = _mm_add_epi16(c, _mm_mullo_epi16(b, _mm_set1_epi16(KB)));
+    c = _mm_srai_epi16(_mm_add_epi16(c, _mm_set1_epi16(128)), 8);
+    return _mm_add_epi16(c, _mm_set1_epi16(128));
+}
+
+// Суми двох рядків (2 x 8 пікселів) -> 8 середніх значень блоків 2x2
+NATIVE_TARGET_SSE2
+inline __m128i Average2x2_SSE2(__m128i sum_lo, __m128i sum_hi) {
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i pairs = _mm_packs_epi32(_mm_madd_epi16(sum_lo, ones), _mm_madd_epi16(sum_hi, ones));
+    return _mm_srli_epi16(_mm_add_epi16(pairs, _mm_set1_epi16(2)), 2);
+}
+
+template <class C, bool kNV12>
+NATIVE_TARGET_SSE2
+void RowPairSSE2(const uint8_t* row0, const uint8_t* row1, int width,
+                 uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i b0a, g0a, r0a, b0b, g0b, r0b;
+        __m128i b1a, g1a, r1a, b1b, g1b, r1b;
+        LoadBGR8_SSE2(row0 + x * 4, b0a, g0a, r0a);
+        LoadBGR8_SSE2(row0 + x * 4 + 32, b0b, g0b, r0b);
+        LoadBGR8_SSE2(row1 + x * 4, b1a, g1a, r1a);
+        LoadBGR8_SSE2(row1 + x * 4 + 32, b1b, g1b, r1b);
+
+        if (y0) {
+            __m128i ya = Luma_SSE2<C>(b0a, g0a, r0a);
+            __m128i yb = Luma_SSE2<C>(b0b, g0b, r0b);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(y0 + x), _mm_packus_epi16(ya, yb));
+        }
+        if (y1) {
+            __m128i ya = Luma_SSE2<C>(b1a, g1a, r1a);
+            __m128i yb = Luma_SSE2<C>(b1b, g1b, r1b);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(y1 + x), _mm_packus_epi16(ya, yb));
+        }
+
+        __m128i b = Average2x2_SSE2(_mm_add_epi16(b0a, b1a), _mm_add_epi16(b0b, b1b));
+        __m128i g = Average2x2_SSE2(_mm_add_epi16(g0a, g1a), _mm_add_epi16(g0b, g1b));
+        __m128i r = Average2x2_SSE2(_mm_add_epi16(r0a, r1a), _mm_add_epi16(r0b, r1b));
+
+        __m128i cu = Chroma_SSE2<C::kUR, C::kUG, C::kUB>(b, g, r);
+        __m128i cv = Chroma_SSE2<C::kVR, C::kVG, C::kVB>(b, g, r);
+
+        if (kNV12) {
+            __m128i uv = _mm_or_si128(cu, _mm_slli_epi16(cv, 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(u + x), uv);
+        } else {
+            __m128i packed = _mm_packus_epi16(cu, cv);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(u + x / 2), packed);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(v + x / 2), _mm_srli_si128(packed, 8));
+        }
+    }
+
+    RowPairScalarFrom<C, kNV12>(x, row0, row1, width, y0, y1, u, v);
+}
+
+// ============================================================
+// AVX2: 32 пікселі за ітерацію
+// ============================================================
+
+// pack інструкції AVX2 працюють у межах 128-бітних половин,
+// permute4x64(0xD8) повертає природний порядок елементів
+NATIVE_TARGET_AVX2
+inline __m256i PacksEpi32_AVX2(__m256i a, __m256i b) {
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+}
+
+NATIVE_TARGET_AVX2
+inline __m256i PackusEpi16_AVX2(__m256i a, __m256i b) {
+    return _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+}
+
+// 16 BGRA пікселів -> три вектори по 16 x int16 (B, G, R)
+NATIVE_TARGET_AVX2
+inline void LoadBGR16_AVX2(const uint8_t* p, __m256i& b, __m256i& g, __m256i& r) {
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+
+    b = PacksEpi32_AVX2(_mm256_and_si256(v0, mask), _mm256_and_si256(v1, mask));
+    g = PacksEpi32_AVX2(_mm256_and_si256(_mm256_srli_epi32(v0, 8), mask),
+                        _mm256_and_si256(_mm256_srli_epi32(v1, 8), mask));
+    r = PacksEpi32_AVX2(_mm256_and_si256(_mm256_srli_epi32(v0, 16), mask),
+                        _mm256_and_si256(_mm256_srli_epi32(v1, 16), mask));
+}
+
+template <class C>
+NATIVE_TARGET_AVX2
+inline __m256i Luma_AVX2(__m256i b, __m256i g, __m256i r) {
+    __m256i y = _mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(C::kYR)),
+                                 _mm256_mullo_epi16(g, _mm256_set1_epi16(C::kYG)));
+    y = _mm256_add_epi16(y, _mm256_mullo_epi16(b, _mm256_set1_epi16(C::kYB)));
+    y = _mm256_srli_epi16(_mm256_add_epi16(y, _mm256_set1_epi16(128)), 8);
+    return _mm256_add_epi16(y, _mm256_set1_epi16(C::kYOffset));
+}
+
+template <int KR, int KG, int KB>
+NATIVE_TARGET_AVX2
+inline __m256i Chroma_AVX2(__m256i b, __m256i g, __m256i r) {
+    __m256i c = _mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(KR)),
+                                 _mm256_mullo_epi16(g, _mm256_set1_epi16(KG)));
+    c = _mm256_add_epi16(c, _mm256_mullo_epi16(b, _mm256_set1_epi16(KB)));
+    c = _mm256_srai_epi16(_mm256_add_epi16(c, _mm256_set1_epi16(128)), 8);
+    return _mm256_add_epi16(c, _mm256_set1_epi16(128));
+}
+
+NATIVE_TARGET_AVX2
+inline __m256i Average2x2_AVX2(__m256i sum_lo, __m256i sum_hi) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i pairs = PacksEpi32_AVX2(_mm256_madd_epi16(sum_lo, ones), _mm256_madd_epi16(sum_hi, ones));
+    return _mm256_srli_epi16(_mm256_add_epi16(pairs, _mm256_set1_epi16(2)), 2);
+}
+
+template <class C, bool kNV12>
+NATIVE_TARGET_AVX2
+void RowPairAVX2(const uint8_t* row0, const uint8_t* row1, int width,
+                 uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v) {
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m256i b0a, g0a, r0a, b0b, g0b, r0b;
+        __m256i b1a, g1a, r1a, b1b, g1b, r1b;
+        LoadBGR16_AVX2(row0 + x * 4, b0a, g0a, r0a);
+        LoadBGR16_AVX2(row0 + x * 4 + 64, b0b, g0b, r0b);
+        LoadBGR16_AVX2(row1 + x * 4, b1a, g1a, r1a);
+        LoadBGR16_AVX2(row1 + x * 4 + 64, b1b, g1b, r1b);
+
+        if (y0) {
+            __m256i ya = Luma_AVX2<C>(b0a, g0a, r0a);
+            __m256i yb = Luma_AVX2<C>(b0b, g0b, r0b);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(y0 + x), PackusEpi16_AVX2(ya, yb));
+        }
+        if (y1) {
+            __m256i ya = Luma_AVX2<C>(b1a, g1a, r1a);
+            __m256i yb = Luma_AVX2<C>(b1b, g1b, r1b);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(y1 + x), PackusEpi16_AVX2(ya, yb));
+        }
+
+        __m256i b = Average2x2_AVX2(_mm256_add_epi16(b0a, b1a), _mm256_add_epi16(b0b, b1b));
+        __m256i g = Average2x2_AVX2(_mm256_add_epi16(g0a, g1a), _mm256_add_epi16(g0b, g1b));
+        __m256i r = Average2x2_AVX2(_mm256_add_epi16(r0a, r1a), _mm256_add_epi16(r0b, r1b));
+
+        __m256i cu = Chroma_AVX2<C::kUR, C::kUG, C::kUB>(b, g, r);
+        __m256i cv = Chroma_AVX2<C::kVR, C::kVG, C::kVB>(b, g, r);
+
+        if (kNV12) {
+            __m256i uv = _mm256_or_si256(cu, _mm256_slli_epi16(cv, 8));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(u + x), uv);
+        } else {
+            // [U0..U15 | V0..V15]
+            __m256i packed = PackusEpi16_AVX2(cu, cv);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(u + x / 2), _mm256_castsi256_si128(packed));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(v + x / 2), _mm256_extracti128_si256(packed, 1));
+        }
+    }
+
+    RowPairScalarFrom<C, kNV12>(x, row0, row1, width, y0, y1, u, v);
+}
+
+#endif // NATIVE_ARCH_X86
+
+// ============================================================
+// Диспетчеризація
+// ============================================================
+
+template <ColorMatrix M, ColorRange R, bool kNV12>
+ConvertRowPairFunc SelectRowPair(ConvertKernel kernel) {
+    typedef YuvCoefficients<M, R> C;
+
+    switch (kernel) {
+        case ConvertKernel::Scalar:
+            return &RowPairScalar<C, kNV12>;
+#ifdef NATIVE_ARCH_X86
+        case ConvertKernel::SSE2:
+            return &RowPairSSE2<C, kNV12>;
+        case ConvertKernel::AVX2:
+            return &RowPairAVX2<C, kNV12>;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+template <bool kNV12>
+ConvertRowPairFunc GetRowPairFunc(ColorMatrix matrix, ColorRange range, ConvertKernel kernel) {
+    if (kernel == ConvertKernel::Auto) {
+        kernel = GetBestConvertKernel();
+    }
+
+    if (!IsConvertKernelSupported(kernel)) {
+        return nullptr;
+    }
+
+    if (matrix == ColorMatrix::BT601) {
+        return range == ColorRange::Limited
+            ? SelectRowPair<ColorMatrix::BT601, ColorRange::Limited, kNV12>(kernel)
+            : SelectRowPair<ColorMatrix::BT601, ColorRange::Full, kNV12>(kernel);
+    }
+
+    return range == ColorRange::Limited
+        ? SelectRowPair<ColorMatrix::BT709, ColorRange::Limited, kNV12>(kernel)
+        : SelectRowPair<ColorMatrix::BT709, ColorRange::Full, kNV12>(kernel);
+}
+
+} // namespace
+
+ConvertKernel GetBestConvertKernel() {
+    if (CpuHasAVX2()) {
+        return ConvertKernel::AVX2;
+    }
+    if (CpuHasSSE2()) {
+        return ConvertKernel::SSE2;
+    }
+    return ConvertKernel::Scalar;
+}
+
+bool IsConvertKernelSupported(ConvertKernel kernel) {
+    switch (kernel) {
+        case ConvertKernel::Auto:
+        case ConvertKernel::Scalar:
+            return true;
+        case ConvertKernel::SSE2:
+            return CpuHasSSE2();
+        case ConvertKernel::AVX2:
+            return CpuHasAVX2();
+    }
+    return false;
+}
+
+const char* GetConvertKernelName(ConvertKernel kernel) {
+    switch (kernel) {
+        case ConvertKernel::Auto: return "auto";
+        case ConvertKernel::Scalar: return "scalar";
+        case ConvertKernel::SSE2: return "sse2";
+        case ConvertKernel::AVX2: return "avx2";
+    }
+    return "unknown";
+}
+
+ConvertRowPairFunc GetNV12RowPairFunc(ColorMatrix matrix, ColorRange range, ConvertKernel kernel) {
+    return GetRowPairFunc<true>(matrix, range, kernel);
+}
+
+ConvertRowPairFunc GetI420RowPairFunc(ColorMatrix matrix, ColorRange range, ConvertKernel kernel) {
+    return GetRowPairFunc<false>(matrix, range, kernel);
+}
+
+bool ConvertBGRAToNV12(const uint8_t* src, int src_stride, int width, int height,
+                       uint8_t* dst_y, int dst_y_stride,
+                       uint8_t* dst_uv, int dst_uv_stride,
+                       ColorMatrix matrix, ColorRange range, ConvertKernel kernel) {
+    if (!src || !dst_y || !dst_uv || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    ConvertRowPairFunc row_pair = GetNV12RowPairFunc(matrix, range, kernel);
+    if (!row_pair) {
+        return false;
+    }
+
+    for (int y = 0; y < height; y += 2) {
+        bool has_second = (y + 1 < height);
+        const uint8_t* row0 = src + (size_t)y * src_stride;
+        const uint8_t* row1 = has_second ? row0 + src_stride : row0;
+        uint8_t* y0 = dst_y + (size_t)y * dst_y_stride;
+        uint8_t* y1 = has_second ? y0 + dst_y_stride : nullptr;
+        uint8_t* uv = dst_uv + (size_t)(y / 2) * dst_uv_stride;
+
+        row_pair(row0, row1, width, y0, y1, uv, nullptr);
+    }
+
+    return true;
+}
+
+bool ConvertBGRAToI420(const uint8_t* src, int src_stride, int width, int height,
+                       uint8_t* dst_y, int dst_y_stride,
+                       uint8_t* dst_u, int dst_u_stride,
+                       uint8_t* dst_v, int dst_v_stride,
+                       ColorMatrix matrix, ColorRange range, ConvertKernel kernel) {
+    if (!src || !dst_y || !dst_u || !dst_v || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    ConvertRowPairFunc row_pair = GetI420RowPairFunc(matrix, range, kernel);
+    if (!row_pair) {
+        return false;
+    }
+
+    for (int y = 0; y < height; y += 2) {
+        bool has_second = (y + 1 < height);
+        const uint8_t* row0 = src + (size_t)y * src_stride;
+        const uint8_t* row1 = has_second ? row0 + src_stride : row0;
+        uint8_t* y0 = dst_y + (size_t)y * dst_y_stride;
+        uint8_t* y1 = has_second ? y0 + dst_y_stride : nullptr;
+
+        row_pair(row0, row1, width, y0, y1,
+                 dst_u + (size_t)(y / 2) * dst_u_stride,
+                 dst_v + (size_t)(y / 2) * dst_v_stride);
+    }
+
+    return true;
+}
@@ -0,0 +1,100 @@
+/**
+ * BGRA -> YUV 4:2:0 Color Conversion (NV12 / I420)
+ * Платформонезалежні ядра з фіксованою точкою: scalar (еталон), SSE2, AVX2
+ */
+
+#ifndef COLOR_CONVERT_H
+#define COLOR_CONVERT_H
+
+#include <cstdint>
+
+enum class ColorMatrix {
+    BT601,
+    BT709
+};
+
+enum class ColorRange {
+    Limited,    // Y 16..235, UV 16..240 (студійний діапазон)
+    Full        // Y 0..255, UV 1..255 (JPEG діапазон)
+};
+
+enum class ConvertKernel {
+    Auto,       // Найкраще доступне ядро (визначається під час виконання)
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+// Коефіцієнти з 8-бітною дробовою частиною (значення * 256).
+// Усі добутки та суми вміщаються в 16 біт, тому SIMD ядра рахують
+// у 16-бітних лініях і дають результат біт-в-біт як scalar еталон:
+//   Y = ((YR*r + YG*g + YB*b + 128) >> 8) + YOffset
+//   U = ((UR*r + UG*g + UB*b + 128) >> 8) + 128
+//   V = ((VR*r + VG*g + VB*b + 128) >> 8) + 128
+// Chroma береться з усередненого блоку 2x2: (p0 + p1 + p2 + p3 + 2) >> 2
+template <ColorMatrix M, ColorRange R>
+struct YuvCoefficients;
+
+template <>
+struct YuvCoefficients<ColorMatrix::BT601, ColorRange::Limited> {
+    static constexpr int kYR = 66, kYG = 129, kYB = 25, kYOffset = 16;
+    static constexpr int kUR = -38, kUG = -74, kUB = 112;
+    static constexpr int kVR = 112, kVG = -94, kVB = -18;
+};
+
+template <>
+struct YuvCoefficients<ColorMatrix::BT601, ColorRange::Full> {
+    static constexpr int kYR = 77, kYG = 150, kYB = 29, kYOffset = 0;
+    static constexpr int kUR = -43, kUG = -84, kUB = 127;
+    static constexpr int kVR = 127, kVG = -106, kVB = -21;
+};
+
+template <>
+struct YuvCoefficients<ColorMatrix::BT709, ColorRange::Limited> {
+    static constexpr int kYR = 47, kYG = 157, kYB = 16, kYOffset = 16;
+    static constexpr int kUR = -26, kUG = -86, kUB = 112;
+    static constexpr int kVR = 112, kVG = -102, kVB = -10;
+};
+
+template <>
+struct YuvCoefficients<ColorMatrix::BT709, ColorRange::Full> {
+    static constexpr int kYR = 54, kYG = 183, kYB = 19, kYOffset = 0;
+    static constexpr int kUR = -29, kUG = -98, kUB = 127;
+    static constexpr int kVR = 127, kVG = -116, kVB = -11;
+};
+
+// Конвертація пари рядків BGRA у два рядки Y та один рядок chroma.
+// row1 == row0 та y1 == nullptr для останнього рядка при непарній висоті.
+// Для NV12 chroma пишеться в u як UVUV..., v не використовується.
+typedef void (*ConvertRowPairFunc)(const uint8_t* row0, const uint8_t* row1, int width,
+                                   uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v);
+
+// Найкраще ядро, яке підтримує поточний процесор
+ConvertKernel GetBestConvertKernel();
+bool IsConvertKernelSupported(ConvertKernel kernel);
+const char* GetConvertKernelName(ConvertKernel kernel);
+
+// nullptr, якщо ядро не підтримується процесором
+ConvertRowPairFunc GetNV12RowPairFunc(ColorMatrix matrix, ColorRange range,
+                                      ConvertKernel kernel = ConvertKernel::Auto);
+ConvertRowPairFunc GetI420RowPairFunc(ColorMatrix matrix, ColorRange range,
+                                      ConvertKernel kernel = ConvertKernel::Auto);
+
+// BGRA -> NV12 (площина Y + площина UV з чергуванням)
+bool ConvertBGRAToNV12(const uint8_t* src, int src_stride, int width, int height,
+                       uint8_t* dst_y, int dst_y_stride,
+                       uint8_t* dst_uv, int dst_uv_stride,
+                       ColorMatrix matrix = ColorMatrix::BT601,
+                       ColorRange range = ColorRange::Limited,
+                       ConvertKernel kernel = ConvertKernel::Auto);
+
+// BGRA -> I420 (три окремі площини Y, U, V)
+bool ConvertBGRAToI420(const uint8_t* src, int src_stride, int width, int height,
+                       uint8_t* dst_y, int dst_y_stride,
+                       uint8_t* dst_u, int dst_u_stride,
+                       uint8_t* dst_v, int dst_v_stride,
+                       ColorMatrix matrix = ColorMatrix::BT601,
+                       ColorRange range = ColorRange::Limited,
+                       ConvertKernel kernel = ConvertKernel::Auto);
+
+#endif // COLOR_CONVERT_H
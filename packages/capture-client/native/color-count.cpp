@@ -0,0 +1,166 @@
+/**
+ * Tile Color Counting Kernels Implementation
+ */
+
+#include "color-count.h"
+#include "cpu-features.h"
+
+namespace {
+
+constexpr uint32_t kColorMask = 0x00FFFFFF;
+
+// Додати колір, якщо його ще немає; max_colors + 1 - переповнення
+inline int AddColor(uint32_t color, uint32_t* palette, int count, int max_colors) {
+    for (int k = 0; k < count; k++) {
+        if (palette[k] == color) {
+            return count;
+        }
+    }
+    if (count == max_colors) {
+        return max_colors + 1;
+    }
+    palette[count] = color;
+    return count + 1;
+}
+
+// ============================================================
+// Scalar еталон
+// ============================================================
+
+inline int CountRowScalarFrom(int x, const uint32_t* row, int width, uint32_t* palette, int count,
+                              int max_colors) {
+    uint32_t last = count > 0 ? palette[count - 1] : 0xFFFFFFFFu;
+    for (; x < width && count <= max_colors; x++) {
+        const uint32_t color = row[x] & kColorMask;
+        if (color != last) {
+            count = AddColor(color, palette, count, max_colors);
+            last = color;
+        }
+    }
+    return count;
+}
+
+int CountColorsScalar(const uint8_t* pixels, int stride, int width, int height, uint32_t* palette,
+                      int max_colors) {
+    int count = 0;
+    for (int y = 0; y < height && count <= max_colors; y++) {
+        const uint32_t* row = reinterpret_cast<const uint32_t*>(pixels + (size_t)y * stride);
+        count = CountRowScalarFrom(0, row, width, palette, count, max_colors);
+    }
+    return count;
+}
+
+#ifdef NATIVE_ARCH_X86
+
+// ============================================================
+// SSE2
+// ============================================================
+
+// 4 пікселі порівнюються з усіма відомими кольорами; лише вектори з новим
+// кольором проходять скалярно (по лініях - порядок палітри як у scalar)
+NATIVE_TARGET_SSE2
+int CountColorsSSE2(const uint8_t* pixels, int stride, int width, int height, uint32_t* palette,
+                    int max_colors) {
+    const __m128i mask = _mm_set1_epi32((int)kColorMask);
+    __m128i known[kMaxCountedColors];
+    int count = 0;
+
+    for (int y = 0; y < height; y++) {
+        const uint32_t* row = reinterpret_cast<const uint32_t*>(pixels + (size_t)y * stride);
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            const __m128i v = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x)), mask);
+            __m128i hit = _mm_setzero_si128();
+            for (int k = 0; k < count; k++) {
+                hit = _mm_or_si128(hit, _mm_cmpeq_epi32(v, known[k]));
+            }
+            if (_mm_movemask_epi8(hit) == 0xFFFF) {
+                continue;
+            }
+            const int before = count;
+            count = CountRowScalarFrom(x, row, x + 4, palette, count, max_colors);
+            if (count > max_colors) {
+                return count;
+            }
+            for (int k = before; k < count; k++) {
+                known[k] = _mm_set1_epi32((int)palette[k]);
+            }
+        }
+        const int before = count;
+        count = CountRowScalarFrom(x, row, width, palette, count, max_colors);
+        if (count > max_colors) {
+            return count;
+        }
+        for (int k = before; k < count; k++) {
+            known[k] = _mm_set1_epi32((int)palette[k]);
+        }
+    }
+    return count;
+}
+
+// ============================================================
+// AVX2
+// ============================================================
+
+NATIVE_TARGET_AVX2
+int CountColorsAVX2(const uint8_t* pixels, int stride, int width, int height, uint32_t* palette,
+                    int max_colors) {
+    const __m256i mask = _mm256_set1_epi32((int)kColorMask);
+    __m256i known[kMaxCountedColors];
+    int count = 0;
+
+    for (int y = 0; y < height; y++) {
+        const uint32_t* row = reinterpret_cast<const uint32_t*>(pixels + (size_t)y * stride);
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            const __m256i v = _mm256_and_si256(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + x)), mask);
+            __m256i hit = _mm256_setzero_si256();
+            for (int k = 0; k < count; k++) {
+                hit = _mm256_or_si256(hit, _mm256_cmpeq_epi32(v, known[k]));
+            }
+            if (_mm256_movemask_epi8(hit) == -1) {
+                continue;
+            }
+            const int before = count;
+            count = CountRowScalarFrom(x, row, x + 8, palette, count, max_colors);
+            if (count > max_colors) {
+                return count;
+            }
+            for (int k = before; k < count; k++) {
+                known[k] = _mm256_set1_epi32((int)palette[k]);
+            }
+        }
+        const int before = count;
+        count = CountRowScalarFrom(x, row, width, palette, count, max_colors);
+        if (count > max_colors) {
+            return count;
+        }
+        for (int k = before; k < count; k++) {
+            known[k] = _mm256_set1_epi32((int)palette[k]);
+        }
+    }
+    return count;
+}
+
+#endif // NATIVE_ARCH_X86
+
+} // namespace
+
+CountColorsFunc GetCountColorsFunc(ConvertKernel kernel) {
+    if (kernel == ConvertKernel::Auto) {
+        kernel = GetBestConvertKernel();
+    }
+    if (!IsConvertKernelSupported(kernel)) {
+        return nullptr;
+    }
+#ifdef NATIVE_ARCH_X86
+    if (kernel == ConvertKernel::AVX2) {
+        return &CountColorsAVX2;
+    }
+    if (kernel == ConvertKernel::SSE2) {
+        return &CountColorsSSE2;
+    }
+#endif
+    return &CountColorsScalar;
+}
@@ -0,0 +1,24 @@
+/**
+ * Tile Color Counting Kernels
+ * Різні кольори плитки до невеликої межі (класифікація плиток екранного кодека).
+ * Альфа ігнорується. Ядра scalar, SSE2, AVX2 дають однакову палітру в порядку
+ * першої появи кольору.
+ */
+
+#ifndef COLOR_COUNT_H
+#define COLOR_COUNT_H
+
+#include <cstdint>
+#include "color-convert.h"
+
+constexpr int kMaxCountedColors = 16;
+
+// Кольори (0x00RRGGBB) width x height BGRA пікселів у palette (ємність >= max_colors,
+// max_colors <= kMaxCountedColors). Повертає кількість або max_colors + 1, щойно
+// кольорів стало більше (решта плитки не переглядається).
+typedef int (*CountColorsFunc)(const uint8_t* pixels, int stride, int width, int height,
+                               uint32_t* palette, int max_colors);
+
+CountColorsFunc GetCountColorsFunc(ConvertKernel kernel = ConvertKernel::Auto);
+
+#endif // COLOR_COUNT_H
@@ -0,0 +1,54 @@
+/**
+ * CPU Feature Detection Implementation
+ */
+
+#include "cpu-features.h"
+
+#if defined(NATIVE_ARCH_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+struct CpuFeatures {
+    bool sse2 = false;
+    bool avx2 = false;
+
+    CpuFeatures() {
+#if defined(NATIVE_ARCH_X86) && defined(_MSC_VER)
+        int regs[4] = {};
+        __cpuid(regs, 0);
+        int max_leaf = regs[0];
+
+        __cpuid(regs, 1);
+        sse2 = (regs[3] & (1 << 26)) != 0;
+        bool osxsave = (regs[2] & (1 << 27)) != 0;
+        bool avx = (regs[2] & (1 << 28)) != 0;
+
+        // AVX2 потребує підтримки збереження YMM регістрів з боку ОС
+        if (max_leaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+            __cpuidex(regs, 7, 0);
+            avx2 = (regs[1] & (1 << 5)) != 0;
+        }
+#elif defined(NATIVE_ARCH_X86)
+        __builtin_cpu_init();
+        sse2 = __builtin_cpu_supports("sse2");
+        avx2 = __builtin_cpu_supports("avx2");
+#endif
+    }
+};
+
+const CpuFeatures& GetCpuFeatures() {
+    static const CpuFeatures features;
+    return features;
+}
+
+} // namespace
+
+bool CpuHasSSE2() {
+    return GetCpuFeatures().sse2;
+}
+
+bool CpuHasAVX2() {
+    return GetCpuFeatures().avx2;
+}
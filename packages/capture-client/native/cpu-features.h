@@ -0,0 +1,27 @@
+/**
+ * CPU Feature Detection
+ * Визначення SIMD розширень під час виконання (SSE2 / AVX2)
+ */
+
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NATIVE_ARCH_X86 1
+#include <immintrin.h>
+#endif
+
+// GCC/Clang компілюють SIMD функції без глобальних -mavx2 флагів,
+// MSVC дозволяє intrinsics без додаткових налаштувань
+#if defined(NATIVE_ARCH_X86) && (defined(__GNUC__) || defined(__clang__))
+#define NATIVE_TARGET_SSE2 __attribute__((target("sse2")))
+#define NATIVE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define NATIVE_TARGET_SSE2
+#define NATIVE_TARGET_AVX2
+#endif
+
+bool CpuHasSSE2();
+bool CpuHasAVX2();
+
+#endif // CPU_FEATURES_H
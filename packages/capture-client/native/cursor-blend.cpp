@@ -0,0 +1,169 @@
+/**
+ * Cursor Blend Kernels Implementation
+ */
+
+#include "cursor-blend.h"
+#include "cpu-features.h"
+#include <algorithm>
+
+namespace {
+
+// ============================================================
+// Scalar еталон
+// ============================================================
+
+// round(v / 255) для v <= 255 * 255 без ділення (та сама формула в SIMD ядрах)
+inline uint32_t Div255(uint32_t v) {
+    v += 128;
+    return (v + (v >> 8)) >> 8;
+}
+
+void BlendRowScalarFrom(int i, uint8_t* dst, const uint8_t* src, int count) {
+    for (; i < count; i++) {
+        const uint8_t* s = src + (size_t)i * 4;
+        uint8_t* d = dst + (size_t)i * 4;
+        const uint32_t a = s[3];
+        if (a == 0) {
+            continue;
+        }
+        const uint32_t inv = 255 - a;
+        for (int c = 0; c < 3; c++) {
+            d[c] = (uint8_t)Div255(s[c] * a + d[c] * inv);
+        }
+    }
+}
+
+void BlendRowScalar(uint8_t* dst, const uint8_t* src, int count) {
+    BlendRowScalarFrom(0, dst, src, count);
+}
+
+#ifdef NATIVE_ARCH_X86
+
+// ============================================================
+// SSE2
+// ============================================================
+
+// 2 пікселі в 16-бітних лініях: src * a + dst * (255 - a), потім Div255.
+// Добутки й сума <= 255 * 255 вміщаються в беззнакові 16 біт.
+NATIVE_TARGET_SSE2
+inline __m128i BlendHalf_SSE2(__m128i s, __m128i d) {
+    const __m128i max = _mm_set1_epi16(255);
+    const __m128i round = _mm_set1_epi16(128);
+    __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)),
+                                    _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i v = _mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, _mm_sub_epi16(max, a)));
+    v = _mm_add_epi16(v, round);
+    return _mm_srli_epi16(_mm_add_epi16(v, _mm_srli_epi16(v, 8)), 8);
+}
+
+// 4 пікселі за ітерацію; блоки без видимих пікселів курсора пропускаються
+NATIVE_TARGET_SSE2
+void BlendRowSSE2(uint8_t* dst, const uint8_t* src, int count) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha_mask = _mm_set1_epi32((int)0xFF000000u);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (size_t)i * 4));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, alpha_mask), zero)) == 0xFFFF) {
+            continue;
+        }
+        __m128i* out = reinterpret_cast<__m128i*>(dst + (size_t)i * 4);
+        __m128i d = _mm_loadu_si128(out);
+        __m128i lo = BlendHalf_SSE2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+        __m128i hi = BlendHalf_SSE2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+        __m128i blended = _mm_packus_epi16(lo, hi);
+        // Альфа кадру без змін
+        _mm_storeu_si128(out, _mm_or_si128(_mm_andnot_si128(alpha_mask, blended),
+                                           _mm_and_si128(alpha_mask, d)));
+    }
+
+    BlendRowScalarFrom(i, dst, src, count);
+}
+
+// ============================================================
+// AVX2
+// ============================================================
+
+NATIVE_TARGET_AVX2
+inline __m256i BlendHalf_AVX2(__m256i s, __m256i d) {
+    const __m256i max = _mm256_set1_epi16(255);
+    const __m256i round = _mm256_set1_epi16(128);
+    __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)),
+                                       _MM_SHUFFLE(3, 3, 3, 3));
+    __m256i v = _mm256_add_epi16(_mm256_mullo_epi16(s, a),
+                                 _mm256_mullo_epi16(d, _mm256_sub_epi16(max, a)));
+    v = _mm256_add_epi16(v, round);
+    return _mm256_srli_epi16(_mm256_add_epi16(v, _mm256_srli_epi16(v, 8)), 8);
+}
+
+// 8 пікселів за ітерацію; unpack і pack у межах 128-бітних половин зберігають порядок
+NATIVE_TARGET_AVX2
+void BlendRowAVX2(uint8_t* dst, const uint8_t* src, int count) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i alpha_mask = _mm256_set1_epi32((int)0xFF000000u);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + (size_t)i * 4));
+        if (_mm256_testz_si256(s, alpha_mask)) {
+            continue;
+        }
+        __m256i* out = reinterpret_cast<__m256i*>(dst + (size_t)i * 4);
+        __m256i d = _mm256_loadu_si256(out);
+        __m256i lo = BlendHalf_AVX2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero));
+        __m256i hi = BlendHalf_AVX2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero));
+        __m256i blended = _mm256_packus_epi16(lo, hi);
+        _mm256_storeu_si256(out, _mm256_or_si256(_mm256_andnot_si256(alpha_mask, blended),
+                                                 _mm256_and_si256(alpha_mask, d)));
+    }
+
+    BlendRowScalarFrom(i, dst, src, count);
+}
+
+#endif // NATIVE_ARCH_X86
+
+} // namespace
+
+BlendRowFunc GetBlendRowFunc(ConvertKernel kernel) {
+    if (kernel == ConvertKernel::Auto) {
+        kernel = GetBestConvertKernel();
+    }
+    if (!IsConvertKernelSupported(kernel)) {
+        return nullptr;
+    }
+#ifdef NATIVE_ARCH_X86
+    if (kernel == ConvertKernel::AVX2) {
+        return &BlendRowAVX2;
+    }
+    if (kernel == ConvertKernel::SSE2) {
+        return &BlendRowSSE2;
+    }
+#endif
+    return &BlendRowScalar;
+}
+
+bool BlendCursor(uint8_t* frame, int stride, int width, int height, const CursorShape& shape,
+                 int x, int y, ConvertKernel kernel) {
+    BlendRowFunc blend = GetBlendRowFunc(kernel);
+    if (!blend || !frame || shape.bgra.empty()) {
+        return false;
+    }
+
+    // Відсікти форму по межах кадру
+    const int left = std::max(0, -x);
+    const int top = std::max(0, -y);
+    const int right = std::min(shape.width, width - x);
+    const int bottom = std::min(shape.height, height - y);
+    if (left >= right || top >= bottom) {
+        return false;
+    }
+
+    const int shape_stride = shape.width * 4;
+    for (int row = top; row < bottom; row++) {
+        uint8_t* dst = frame + (size_t)(y + row) * stride + (size_t)(x + left) * 4;
+        const uint8_t* src = shape.bgra.data() + (size_t)row * shape_stride + (size_t)left * 4;
+        blend(dst, src, right - left);
+    }
+    return true;
+}
@@ -0,0 +1,25 @@
+/**
+ * Cursor Blend Kernels
+ * Накладання курсора (непремультиплікована BGRA) на кадр для споживачів,
+ * яким потрібен вбудований курсор. Ядра scalar, SSE2, AVX2 дають біт-в-біт
+ * однаковий результат: (src * a + dst * (255 - a)) / 255 з округленням.
+ */
+
+#ifndef CURSOR_BLEND_H
+#define CURSOR_BLEND_H
+
+#include <cstdint>
+#include "color-convert.h"
+#include "cursor.h"
+
+// Змішати count пікселів src поверх dst (альфа dst не змінюється)
+typedef void (*BlendRowFunc)(uint8_t* dst, const uint8_t* src, int count);
+
+BlendRowFunc GetBlendRowFunc(ConvertKernel kernel = ConvertKernel::Auto);
+
+// Накласти форму лівим верхнім кутом у (x, y) на BGRA кадр width x height;
+// частина поза кадром відсікається. false - форма не перетинає кадр.
+bool BlendCursor(uint8_t* frame, int stride, int width, int height, const CursorShape& shape,
+                 int x, int y, ConvertKernel kernel = ConvertKernel::Auto);
+
+#endif // CURSOR_BLEND_H
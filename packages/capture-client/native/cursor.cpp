@@ -0,0 +1,207 @@
+/**
+ * Cursor Channel Implementation
+ */
+
+#include "cursor.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t kFnvOffset = 2166136261u;
+constexpr uint32_t kFnvPrime = 16777619u;
+
+uint32_t HashBytes(uint32_t hash, const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * kFnvPrime;
+    }
+    return hash;
+}
+
+uint32_t HashCursorShape(const CursorShape& shape) {
+    const int header[4] = { shape.width, shape.height, shape.hot_x, shape.hot_y };
+    uint32_t hash = HashBytes(kFnvOffset, reinterpret_cast<const uint8_t*>(header), sizeof(header));
+    hash = HashBytes(hash, shape.bgra.data(), shape.bgra.size());
+    // 0 зарезервовано для "форми немає"
+    return hash ? hash : 1;
+}
+
+inline bool GetBit(const uint8_t* row, int x) {
+    return (row[x >> 3] & (0x80 >> (x & 7))) != 0;
+}
+
+} // namespace
+
+bool ConvertCursorShape(CursorShapeType type, const uint8_t* data, int width, int height, int pitch,
+                        int hot_x, int hot_y, CursorShape& shape) {
+    if (!data || width <= 0 || height <= 0 || width > 256 || height > 256) {
+        return false;
+    }
+
+    shape.width = width;
+    shape.height = height;
+    shape.hot_x = std::max(0, std::min(hot_x, width - 1));
+    shape.hot_y = std::max(0, std::min(hot_y, height - 1));
+    shape.bgra.assign((size_t)width * height * 4, 0);
+    uint32_t* out = reinterpret_cast<uint32_t*>(shape.bgra.data());
+
+    for (int y = 0; y < height; y++) {
+        uint32_t* dst = out + (size_t)y * width;
+        switch (type) {
+            case CursorShapeType::Color:
+                memcpy(dst, data + (size_t)y * pitch, (size_t)width * 4);
+                break;
+
+            case CursorShapeType::MaskedColor: {
+                const uint32_t* src = reinterpret_cast<const uint32_t*>(data + (size_t)y * pitch);
+                for (int x = 0; x < width; x++) {
+                    const uint32_t rgb = src[x] & 0x00FFFFFFu;
+                    const bool xor_pixel = (src[x] >> 24) != 0;
+                    dst[x] = xor_pixel && rgb == 0 ? 0 : (rgb | 0xFF000000u);
+                }
+                break;
+            }
+
+            case CursorShapeType::Monochrome: {
+                const uint8_t* and_row = data + (size_t)y * pitch;
+                const uint8_t* xor_row = data + (size_t)(y + height) * pitch;
+                for (int x = 0; x < width; x++) {
+                    const bool and_bit = GetBit(and_row, x);
+                    const bool xor_bit = GetBit(xor_row, x);
+                    if (and_bit && !xor_bit) {
+                        dst[x] = 0;                 // Екран без змін
+                    } else if (!and_bit && xor_bit) {
+                        dst[x] = 0xFFFFFFFFu;       // Білий
+                    } else {
+                        dst[x] = 0xFF000000u;       // Чорний (інверсія - теж чорним)
+                    }
+                }
+                break;
+            }
+
+            case CursorShapeType::PremultipliedARGB: {
+                const uint32_t* src = reinterpret_cast<const uint32_t*>(data + (size_t)y * pitch);
+                for (int x = 0; x < width; x++) {
+                    const uint32_t a = src[x] >> 24;
+                    if (a == 0) {
+                        continue;
+                    }
+                    uint32_t pixel = a << 24;
+                    for (int shift = 0; shift < 24; shift += 8) {
+                        const uint32_t c = (src[x] >> shift) & 0xFF;
+                        pixel |= std::min(255u, (c * 255 + a / 2) / a) << shift;
+                    }
+                    dst[x] = pixel;
+                }
+                break;
+            }
+        }
+    }
+
+    shape.id = HashCursorShape(shape);
+    return true;
+}
+
+void ScaleCursorShape(const CursorShape& shape, double scale_x, double scale_y, CursorShape& scaled) {
+    scaled.id = shape.id;
+    scaled.width = std::max(1, (int)(shape.width * scale_x + 0.5));
+    scaled.height = std::max(1, (int)(shape.height * scale_y + 0.5));
+    scaled.hot_x = std::min((int)(shape.hot_x * scale_x + 0.5), scaled.width - 1);
+    scaled.hot_y = std::min((int)(shape.hot_y * scale_y + 0.5), scaled.height - 1);
+    scaled.bgra.resize((size_t)scaled.width * scaled.height * 4);
+
+    const uint32_t* src = reinterpret_cast<const uint32_t*>(shape.bgra.data());
+    uint32_t* dst = reinterpret_cast<uint32_t*>(scaled.bgra.data());
+    for (int y = 0; y < scaled.height; y++) {
+        // Центр вихідного пікселя -> піксель джерела
+        const int sy = std::min((int)((y + 0.5) * shape.height / scaled.height), shape.height - 1);
+        for (int x = 0; x < scaled.width; x++) {
+            const int sx = std::min((int)((x + 0.5) * shape.width / scaled.width), shape.width - 1);
+            dst[(size_t)y * scaled.width + x] = src[(size_t)sy * shape.width + sx];
+        }
+    }
+}
+
+CursorTracker::CursorTracker() {
+}
+
+void CursorTracker::UpdatePosition(bool visible, int x, int y) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_.visible == visible && state_.x == x && state_.y == y) {
+        return;
+    }
+    state_.visible = visible;
+    state_.x = x;
+    state_.y = y;
+    state_.sequence++;
+    stats_.position_updates++;
+}
+
+CursorShapePtr CursorTracker::FindShapeLocked(uint32_t id) const {
+    for (auto it = shapes_.begin(); it != shapes_.end(); ++it) {
+        if ((*it)->id == id) {
+            // Нещодавно використана - на початок списку
+            shapes_.splice(shapes_.begin(), shapes_, it);
+            return shapes_.front();
+        }
+    }
+    return nullptr;
+}
+
+uint32_t CursorTracker::UpdateShape(CursorShape&& shape) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint32_t id = shape.id;
+
+    if (FindShapeLocked(id)) {
+        stats_.shape_cache_hits++;
+    } else {
+        shapes_.push_front(std::make_shared<const CursorShape>(std::move(shape)));
+        if (shapes_.size() > kMaxShapes) {
+            shapes_.pop_back();
+        }
+    }
+
+    if (state_.shape_id != id) {
+        state_.shape_id = id;
+        state_.sequence++;
+        stats_.shape_updates++;
+    }
+    return id;
+}
+
+CursorState CursorTracker::GetState() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_;
+}
+
+uint64_t CursorTracker::GetSequence() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_.sequence;
+}
+
+CursorShapePtr CursorTracker::GetShape(uint32_t id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return FindShapeLocked(id);
+}
+
+CursorShapePtr CursorTracker::GetCurrentShape() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_.shape_id ? FindShapeLocked(state_.shape_id) : nullptr;
+}
+
+CursorStats CursorTracker::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CursorStats stats = stats_;
+    stats.shapes = shapes_.size();
+    return stats;
+}
+
+void CursorTracker::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // sequence не скидається - споживачі не пропустять стан після повторної ініціалізації
+    const uint64_t sequence = state_.sequence;
+    state_ = CursorState();
+    state_.sequence = sequence + 1;
+    shapes_.clear();
+    stats_ = CursorStats();
+}
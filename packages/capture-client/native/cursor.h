@@ -0,0 +1,93 @@
+/**
+ * Cursor Channel
+ * Позиція і форма вказівника окремо від зображення робочого столу: форми
+ * кешуються за хешем, споживачі отримують лише позицію та id форми
+ */
+
+#ifndef CURSOR_H
+#define CURSOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Формати форм бекендів (DXGI_OUTDUPL_POINTER_SHAPE_TYPE_*, XFixes)
+enum class CursorShapeType {
+    Color,              // BGRA з альфою (DXGI COLOR)
+    MaskedColor,        // BGR + маска в альфі: 0 - замінити, 0xFF - XOR з екраном (DXGI)
+    Monochrome,         // 1 біт: AND маска, під нею XOR маска (висота подвоєна, DXGI)
+    PremultipliedARGB   // Премультиплікований ARGB (XFixesGetCursorImage)
+};
+
+struct CursorShape {
+    uint32_t id = 0;                // Хеш розміру, hotspot і пікселів (0 - форми немає)
+    int width = 0;
+    int height = 0;
+    int hot_x = 0;                  // Точка вказівника відносно лівого верхнього кута
+    int hot_y = 0;
+    std::vector<uint8_t> bgra;      // Непремультиплікована BGRA, крок width * 4
+};
+
+typedef std::shared_ptr<const CursorShape> CursorShapePtr;
+
+// Перетворити форму бекенду в BGRA з альфою. XOR-пікселі (інверсія екрану)
+// наближаються непрозорими: чорний XOR не змінює екран - прозорий.
+// height - висота форми (для Monochrome - без подвоєння), pitch - байт на рядок джерела.
+bool ConvertCursorShape(CursorShapeType type, const uint8_t* data, int width, int height, int pitch,
+                        int hot_x, int hot_y, CursorShape& shape);
+
+// Форма для кадру, масштабованого відносно джерела (width/height - розмір виходу кодека):
+// найближчий піксель - краї й XOR-наближення лишаються чіткими. Hotspot масштабується
+// разом з формою, id лишається тим самим (масштаб сесії незмінний)
+void ScaleCursorShape(const CursorShape& shape, double scale_x, double scale_y, CursorShape& scaled);
+
+struct CursorState {
+    bool visible = false;
+    int x = 0;                      // Лівий верхній кут форми в координатах кадру
+    int y = 0;
+    uint32_t shape_id = 0;
+    uint64_t sequence = 0;          // Росте при кожній зміні позиції, видимості чи форми
+};
+
+struct CursorStats {
+    uint64_t position_updates = 0;
+    uint64_t shape_updates = 0;     // Зміни поточної форми
+    uint64_t shape_cache_hits = 0;  // Форма вже була в кеші - пікселі не зберігаються вдруге
+    size_t shapes = 0;
+};
+
+// Потокобезпечний стан курсора: джерело оновлює на потоці захоплення, JS читає
+class CursorTracker {
+public:
+    static constexpr size_t kMaxShapes = 32;
+
+    CursorTracker();
+
+    // Позиція без змін не збільшує sequence
+    void UpdatePosition(bool visible, int x, int y);
+    // Зробити форму поточною; повертає id (форму з тим самим хешем бере з кешу)
+    uint32_t UpdateShape(CursorShape&& shape);
+
+    CursorState GetState() const;
+    uint64_t GetSequence() const;
+    // nullptr - форму витіснено з кешу або id невідомий
+    CursorShapePtr GetShape(uint32_t id) const;
+    CursorShapePtr GetCurrentShape() const;
+    CursorStats GetStats() const;
+
+    void Reset();
+
+private:
+    CursorShapePtr FindShapeLocked(uint32_t id) const;
+
+    mutable std::mutex mutex_;
+    CursorState state_;
+    // Нещодавно використані - на початку; найстаріша витісняється
+    mutable std::list<CursorShapePtr> shapes_;
+    CursorStats stats_;
+};
+
+#endif // CURSOR_H
@@ -0,0 +1,167 @@
+/**
+ * Delta Frame Encoder Implementation
+ */
+
+#include "delta-encoder.h"
+#include <cstring>
+
+namespace {
+
+inline void WriteU16(uint8_t* p, uint16_t value) {
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)(value >> 8);
+}
+
+inline void WriteU32(uint8_t* p, uint32_t value) {
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)((value >> 8) & 0xFF);
+    p[2] = (uint8_t)((value >> 16) & 0xFF);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+} // namespace
+
+DeltaEncoder::DeltaEncoder() {
+}
+
+void DeltaEncoder::SetError(const std::string& error) {
+    last_error_ = error;
+}
+
+bool DeltaEncoder::Initialize(int width, int height, int tile_size, int keyframe_interval,
+                              bool detect_motion, size_t tile_cache_bytes) {
+    if (width > 0xFFFF || height > 0xFFFF) {
+        SetError("Frame too large for delta encoding");
+        return false;
+    }
+
+    if (!diff_.Initialize(width, height, tile_size)) {
+        SetError("Invalid delta tile configuration");
+        return false;
+    }
+
+    detect_motion_ = detect_motion && motion_.Initialize(width, height);
+    moves_.clear();
+    cache_.Initialize(tile_size, tile_cache_bytes);
+    last_cache_stats_ = TileCacheStats();
+
+    keyframe_interval_ = keyframe_interval;
+    frames_since_keyframe_ = 0;
+    force_keyframe_ = true;
+    return true;
+}
+
+size_t DeltaEncoder::GetMaxPacketSize() const {
+    size_t bitmap = (size_t)(diff_.GetTileCount() + 7) / 8;
+    size_t moves = detect_motion_ ? 4 + MotionDetector::kMaxMoves * kMoveSize : 0;
+    size_t references = cache_.IsEnabled() ? (size_t)diff_.GetTileCount() * 2 : 0;
+    return kHeaderSize + moves + bitmap + references + (size_t)diff_.GetWidth() * diff_.GetHeight() * 4;
+}
+
+bool DeltaEncoder::Encode(const uint8_t* frame, int stride, uint8_t* out, size_t capacity,
+                          size_t& out_size) {
+    out_size = 0;
+
+    if (capacity < GetMaxPacketSize()) {
+        SetError("Delta output buffer too small");
+        return false;
+    }
+
+    // Періодичний keyframe - щоб нові отримувачі та втрачені пакети відновлювалися
+    // Запит знімається атомарно: ForceKeyframe під час кодування не губиться
+    bool keyframe = force_keyframe_.exchange(false);
+    keyframe = keyframe || (keyframe_interval_ > 0 && frames_since_keyframe_ >= keyframe_interval_);
+    if (keyframe) {
+        diff_.Reset();
+        cache_.Reset();
+        frames_since_keyframe_ = 0;
+    }
+    frames_since_keyframe_++;
+
+    // Переміщення зсувають збережений кадр так само, як їх застосує отримувач:
+    // плитки, що після цього збігаються, не передаються
+    moves_.clear();
+    if (detect_motion_) {
+        if (keyframe) {
+            motion_.Reset();
+        }
+        motion_.Analyze(frame, stride, moves_);
+        diff_.ApplyMoves(moves_);
+    }
+
+    int changed = diff_.Compare(frame, stride, dirty_);
+    last_keyframe_ = keyframe;
+    last_tile_count_ = changed;
+    last_cache_stats_ = TileCacheStats();
+
+    if (changed == 0 && moves_.empty()) {
+        return true;
+    }
+
+    int tile_count = diff_.GetTileCount();
+    size_t bitmap_size = (size_t)(tile_count + 7) / 8;
+
+    WriteU32(out, kMagic);
+    WriteU16(out + 4, (uint16_t)diff_.GetWidth());
+    WriteU16(out + 6, (uint16_t)diff_.GetHeight());
+    WriteU16(out + 8, (uint16_t)diff_.GetTileSize());
+    out[10] = (keyframe ? kFlagKeyframe : 0) | (moves_.empty() ? 0 : kFlagMoves) |
+              (cache_.IsEnabled() ? kFlagTileCache : 0);
+    out[11] = 0;
+    WriteU32(out + 12, (uint32_t)changed);
+
+    uint8_t* bitmap = out + kHeaderSize;
+    if (!moves_.empty()) {
+        WriteU16(bitmap, (uint16_t)moves_.size());
+        WriteU16(bitmap + 2, 0);
+        bitmap += 4;
+        for (const MoveRect& move : moves_) {
+            WriteU16(bitmap, (uint16_t)move.src_x);
+            WriteU16(bitmap + 2, (uint16_t)move.src_y);
+            WriteU16(bitmap + 4, (uint16_t)move.width);
+            WriteU16(bitmap + 6, (uint16_t)move.height);
+            WriteU16(bitmap + 8, (uint16_t)move.dst_x);
+            WriteU16(bitmap + 10, (uint16_t)move.dst_y);
+            bitmap += kMoveSize;
+        }
+    }
+    memset(bitmap, 0, bitmap_size);
+
+    // Посилання на кеш - перед пікселями, по одному на змінену плитку
+    uint8_t* references = bitmap + bitmap_size;
+    uint8_t* pixels = references + (cache_.IsEnabled() ? (size_t)changed * 2 : 0);
+    const TileCacheStats cache_before = cache_.GetStats();
+    for (int i = 0; i < tile_count; i++) {
+        if (!dirty_[i]) {
+            continue;
+        }
+        bitmap[i >> 3] |= (uint8_t)(1 << (i & 7));
+
+        int x, y, w, h;
+        diff_.GetTileRect(i, x, y, w, h);
+        size_t row_bytes = (size_t)w * 4;
+        const uint8_t* tile = frame + (size_t)y * stride + (size_t)x * 4;
+        if (cache_.IsEnabled()) {
+            uint16_t slot = 0;
+            const bool hit = cache_.Lookup(TileCache::HashTile(tile, stride, w, h), row_bytes * h, slot);
+            WriteU16(references, hit ? (uint16_t)(kCacheHit | slot) : slot);
+            references += 2;
+            if (hit) {
+                continue;
+            }
+        }
+        for (int row = 0; row < h; row++) {
+            memcpy(pixels, tile + (size_t)row * stride, row_bytes);
+            pixels += row_bytes;
+        }
+    }
+
+    const TileCacheStats cache_after = cache_.GetStats();
+    last_cache_stats_.hits = cache_after.hits - cache_before.hits;
+    last_cache_stats_.misses = cache_after.misses - cache_before.misses;
+    last_cache_stats_.evictions = cache_after.evictions - cache_before.evictions;
+    last_cache_stats_.bytes_saved = cache_after.bytes_saved - cache_before.bytes_saved;
+
+    out_size = (size_t)(pixels - out);
+    return true;
+}
@@ -0,0 +1,101 @@
+/**
+ * Delta Frame Encoder
+ * Пакує лише змінені плитки кадру + компактний бітовий індекс плиток
+ *
+ * Формат пакету (little-endian):
+ *   0  uint32  magic 'DLT1'
+ *   4  uint16  width
+ *   6  uint16  height
+ *   8  uint16  tile_size
+ *   10 uint8   flags (bit 0 = keyframe, bit 1 = переміщення, bit 2 = кеш плиток)
+ *   11 uint8   reserved
+ *   12 uint32  кількість змінених плиток
+ *   [лише з bit 1]
+ *   16 uint16  кількість переміщень
+ *   18 uint16  reserved
+ *   20 uint16[6] на переміщення: src_x, src_y, width, height, dst_x, dst_y
+ *   ..  uint8[] бітова маска плиток (ceil(tiles / 8) байт, біт i = плитка i)
+ *   [лише з bit 2]
+ *   ..  uint16 на кожну змінену плитку в порядку індексу: біт 15 = влучання
+ *       (пікселі взяти зі слота), інакше промах (пікселі передано - зберегти в слот);
+ *       біти 0-14 - номер слота (tile-cache.h)
+ *   ..  BGRA пікселі змінених плиток (з bit 2 - лише промахів) у порядку індексу,
+ *       кожна щільно упакована (w * h * 4, крайні плитки обрізані)
+ *
+ * Отримувач спершу застосовує переміщення до свого кадру (джерела - з кадру до
+ * переміщень), потім накладає плитки. Посилання обробляються по черзі (влучання
+ * може вказувати на плитку, збережену раніше в тому ж пакеті); keyframe очищає кеш.
+ */
+
+#ifndef DELTA_ENCODER_H
+#define DELTA_ENCODER_H
+
+#include "motion-detector.h"
+#include "tile-cache.h"
+#include "tile-diff.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class DeltaEncoder {
+public:
+    static constexpr uint32_t kMagic = 0x31544C44; // "DLT1"
+    static constexpr size_t kHeaderSize = 16;
+    static constexpr uint8_t kFlagKeyframe = 0x01;
+    static constexpr uint8_t kFlagMoves = 0x02;
+    static constexpr uint8_t kFlagTileCache = 0x04;
+    static constexpr size_t kMoveSize = 12;
+    static constexpr uint16_t kCacheHit = 0x8000;
+
+    DeltaEncoder();
+
+    // keyframe_interval - повний кадр кожні N кадрів (0 = лише перший).
+    // detect_motion - шукати прокрутку/переміщення і передавати їх копіюванням.
+    // tile_cache_bytes - пам'ять кешу плиток отримувача (0 - без кешу).
+    bool Initialize(int width, int height, int tile_size = 64, int keyframe_interval = 300,
+                    bool detect_motion = false, size_t tile_cache_bytes = 0);
+
+    // Закодувати кадр у out (ємність >= GetMaxPacketSize()).
+    // out_size = 0, якщо жодна плитка не змінилася.
+    bool Encode(const uint8_t* frame, int stride, uint8_t* out, size_t capacity, size_t& out_size);
+
+    // Безпечно з будь-якого потоку (JS, цикл захоплення) під час Encode на потоці конвеєра.
+    // Keyframe скидає і кеш плиток - так відновлюється потік після відкинутого пакета
+    void ForceKeyframe() { force_keyframe_ = true; }
+    // Переміщення від джерела захоплення для наступного Encode (замість пошуку)
+    void SetMoveHints(const std::vector<MoveRect>& hints) { motion_.SetHints(hints); }
+
+    size_t GetMaxPacketSize() const;
+    bool IsLastKeyframe() const { return last_keyframe_; }
+    int GetLastTileCount() const { return last_tile_count_; }
+    int GetLastMoveCount() const { return (int)moves_.size(); }
+    bool IsMotionDetectionEnabled() const { return detect_motion_; }
+    MotionDetectorStats GetMotionStats() const { return motion_.GetStats(); }
+    bool IsTileCacheEnabled() const { return cache_.IsEnabled(); }
+    int GetTileCacheSlots() const { return cache_.GetSlotCount(); }
+    // Кеш за останній Encode / за весь час
+    TileCacheStats GetLastTileCacheStats() const { return last_cache_stats_; }
+    TileCacheStats GetTileCacheStats() const { return cache_.GetStats(); }
+    int GetTileCount() const { return diff_.GetTileCount(); }
+    std::string GetLastError() const { return last_error_; }
+
+private:
+    void SetError(const std::string& error);
+
+    TileDiff diff_;
+    std::vector<uint8_t> dirty_;
+    MotionDetector motion_;
+    std::vector<MoveRect> moves_;
+    bool detect_motion_ = false;
+    TileCache cache_;
+    TileCacheStats last_cache_stats_;
+    int keyframe_interval_ = 0;
+    int frames_since_keyframe_ = 0;
+    std::atomic<bool> force_keyframe_{true};
+    bool last_keyframe_ = false;
+    int last_tile_count_ = 0;
+    std::string last_error_;
+};
+
+#endif // DELTA_ENCODER_H
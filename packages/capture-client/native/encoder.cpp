@@ -4,6 +4,7 @@
  */
 
 #include "encoder.h"
+#include "stats.h"
 #include <codecapi.h>
 #include <wmcodecdsp.h>
 
@@ -27,16 +28,19 @@ H264Encoder::~H264Encoder() {
     Cleanup();
 }
 
-void H264Encoder::SetError(const std::string& error) {
-    last_error_ = error;
-}
+bool H264Encoder::Initialize(const VideoEncoderConfig& config) {
+    Cleanup();
 
-bool H264Encoder::Initialize(int width, int height, int bitrate, int fps, bool useHardware) {
-    width_ = width;
-    height_ = height;
-    bitrate_ = bitrate;
-    fps_ = fps;
-    use_hardware_ = useHardware;
+    if (config.width <= 0 || config.height <= 0 || config.fps <= 0) {
+        SetError("Invalid encoder configuration");
+        return false;
+    }
+
+    width_ = config.width;
+    height_ = config.height;
+    bitrate_ = config.bitrate;
+    fps_ = config.fps;
+    use_hardware_ = config.use_hardware;
 
     // Розрахувати тривалість кадру
     sample_duration_ = 10000000LL / fps_; // 100-nanosecond units
@@ -58,9 +62,103 @@ bool H264Encoder::Initialize(int width, int height, int bitrate, int fps, bool u
         return false;
     }
 
+    if (!CreateSamples()) {
+        Cleanup();
+        return false;
+    }
+
     return true;
 }
 
+bool H264Encoder::CreateSamples() {
+    const DWORD nv12_size = (DWORD)GetNV12Size();
+
+    for (int i = 0; i < kInputSamples; i++) {
+        if (FAILED(MFCreateSample(&input_samples_[i])) ||
+            FAILED(MFCreateMemoryBuffer(nv12_size, &input_buffers_[i])) ||
+            FAILED(input_samples_[i]->AddBuffer(input_buffers_[i]))) {
+            SetError("Failed to create input sample");
+            return false;
+        }
+    }
+
+    MFT_OUTPUT_STREAM_INFO stream_info = {};
+    HRESULT hr = encoder_->GetOutputStreamInfo(0, &stream_info);
+    if (FAILED(hr)) {
+        SetError("Failed to get output stream info");
+        return false;
+    }
+
+    // Апаратні MFT зазвичай самі виділяють вихідні семпли - тоді свій не потрібен
+    if (stream_info.dwFlags & (MFT_OUTPUT_STREAM_PROVIDES_SAMPLES | MFT_OUTPUT_STREAM_CAN_PROVIDE_SAMPLES)) {
+        return true;
+    }
+
+    DWORD output_size = (DWORD)(width_ * height_);
+    if (stream_info.cbSize > output_size) {
+        output_size = stream_info.cbSize;
+    }
+    if (FAILED(MFCreateSample(&output_sample_)) ||
+        FAILED(MFCreateMemoryBuffer(output_size, &output_buffer_)) ||
+        FAILED(output_sample_->AddBuffer(output_buffer_))) {
+        SetError("Failed to create output sample");
+        return false;
+    }
+
+    return true;
+}
+
+void H264Encoder::ReleaseSamples() {
+    for (int i = 0; i < kInputSamples; i++) {
+        if (input_buffers_[i]) {
+            input_buffers_[i]->Release();
+            input_buffers_[i] = nullptr;
+        }
+        if (input_samples_[i]) {
+            input_samples_[i]->Release();
+            input_samples_[i] = nullptr;
+        }
+    }
+    next_input_ = 0;
+
+    if (output_buffer_) {
+        output_buffer_->Release();
+        output_buffer_ = nullptr;
+    }
+    if (output_sample_) {
+        output_sample_->Release();
+        output_sample_ = nullptr;
+    }
+}
+
+IMFSample* H264Encoder::AcquireInputSample(IMFMediaBuffer** buffer) {
+    // Семпл вільний, якщо посилання на нього тримає лише енкодер-обгортка
+    for (int attempt = 0; attempt < kInputSamples; attempt++) {
+        int index = (next_input_ + attempt) % kInputSamples;
+        IMFSample* sample = input_samples_[index];
+        sample->AddRef();
+        if (sample->Release() == 1) {
+            next_input_ = (index + 1) % kInputSamples;
+            *buffer = input_buffers_[index];
+            sample->AddRef();
+            (*buffer)->AddRef();
+            return sample;
+        }
+    }
+
+    // MFT тримає всі семпли кільця - тимчасовий семпл (виділення лише в цьому випадку)
+    IMFSample* sample = nullptr;
+    if (FAILED(MFCreateSample(&sample))) {
+        return nullptr;
+    }
+    if (FAILED(MFCreateMemoryBuffer((DWORD)GetNV12Size(), buffer))) {
+        sample->Release();
+        return nullptr;
+    }
+    sample->AddBuffer(*buffer);
+    return sample;
+}
+
 bool H264Encoder::InitializeMediaFoundation() {
     if (mf_initialized_) {
         return true;
@@ -231,60 +329,23 @@ bool H264Encoder::ConfigureEncoder() {
     return true;
 }
 
-bool H264Encoder::Encode(const std::vector<uint8_t>& bgraData, std::vector<uint8_t>& h264Data) {
+bool H264Encoder::EncodeNV12(const uint8_t* nv12, uint8_t* out, size_t capacity, size_t& out_size) {
+    out_size = 0;
+    last_keyframe_ = false;
+
     if (!encoder_) {
         SetError("Encoder not initialized");
         return false;
     }
 
     HRESULT hr;
+    const DWORD nv12_size = (DWORD)GetNV12Size();
 
-    // Перевірити розмір даних
-    size_t expected_size = width_ * height_ * 4; // BGRA = 4 bytes per pixel
-    if (bgraData.size() != expected_size) {
-        SetError("Invalid input data size");
-        return false;
-    }
-
-    // Конвертувати BGRA -> NV12
-    std::vector<uint8_t> nv12_data(width_ * height_ * 3 / 2);
-    
-    // Y plane
-    for (int y = 0; y < height_; y++) {
-        for (int x = 0; x < width_; x++) {
-            int bgra_idx = (y * width_ + x) * 4;
-            int y_idx = y * width_ + x;
-            
-            uint8_t b = bgraData[bgra_idx + 0];
-            uint8_t g = bgraData[bgra_idx + 1];
-            uint8_t r = bgraData[bgra_idx + 2];
-            
-            // BT.601 formula
-            nv12_data[y_idx] = (uint8_t)((0.257 * r + 0.504 * g + 0.098 * b) + 16);
-        }
-    }
-    
-    // UV plane (subsampled 2x2)
-    int uv_offset = width_ * height_;
-    for (int y = 0; y < height_; y += 2) {
-        for (int x = 0; x < width_; x += 2) {
-            int bgra_idx = (y * width_ + x) * 4;
-            int uv_idx = uv_offset + (y / 2) * width_ + x;
-            
-            uint8_t b = bgraData[bgra_idx + 0];
-            uint8_t g = bgraData[bgra_idx + 1];
-            uint8_t r = bgraData[bgra_idx + 2];
-            
-            nv12_data[uv_idx + 0] = (uint8_t)((-0.148 * r - 0.291 * g + 0.439 * b) + 128); // U
-            nv12_data[uv_idx + 1] = (uint8_t)((0.439 * r - 0.368 * g - 0.071 * b) + 128);  // V
-        }
-    }
-
-    // Створити Media Buffer
+    // Вхідний семпл з кільця (без MFCreateSample/MFCreateMemoryBuffer на кадр)
     IMFMediaBuffer* media_buffer = nullptr;
-    hr = MFCreateMemoryBuffer((DWORD)nv12_data.size(), &media_buffer);
-    if (FAILED(hr)) {
-        SetError("Failed to create media buffer");
+    IMFSample* sample = AcquireInputSample(&media_buffer);
+    if (!sample) {
+        SetError("Failed to create sample");
         return false;
     }
 
@@ -292,27 +353,28 @@ bool H264Encoder::Encode(const std::vector<uint8_t>& bgraData, std::vector<uint8
     BYTE* buffer_data = nullptr;
     hr = media_buffer->Lock(&buffer_data, nullptr, nullptr);
     if (SUCCEEDED(hr)) {
-        memcpy(buffer_data, nv12_data.data(), nv12_data.size());
+        memcpy(buffer_data, nv12, nv12_size);
         media_buffer->Unlock();
-        media_buffer->SetCurrentLength((DWORD)nv12_data.size());
-    }
-
-    // Створити Sample
-    IMFSample* sample = nullptr;
-    hr = MFCreateSample(&sample);
-    if (FAILED(hr)) {
-        media_buffer->Release();
-        SetError("Failed to create sample");
-        return false;
+        media_buffer->SetCurrentLength(nv12_size);
     }
+    media_buffer->Release();
 
-    sample->AddBuffer(media_buffer);
     sample->SetSampleTime(sample_time_);
     sample->SetSampleDuration(sample_duration_);
     
     sample_time_ += sample_duration_;
 
-    media_buffer->Release();
+    if (ConsumeKeyframeRequest()) {
+        // IDR на наступному вхідному кадрі (апаратні MFT підтримують з Windows 8)
+        ICodecAPI* codec_api = nullptr;
+        if (SUCCEEDED(encoder_->QueryInterface(IID_PPV_ARGS(&codec_api)))) {
+            VARIANT var;
+            var.vt = VT_UI4;
+            var.ulVal = 1;
+            codec_api->SetValue(&CODECAPI_AVEncVideoForceKeyFrame, &var);
+            codec_api->Release();
+        }
+    }
 
     // Подати на вхід енкодера
     hr = encoder_->ProcessInput(0, sample, 0);
@@ -323,55 +385,86 @@ bool H264Encoder::Encode(const std::vector<uint8_t>& bgraData, std::vector<uint8
         return false;
     }
 
-    // Отримати вихідні дані
+    // Отримати вихідні дані: у власний постійний семпл або в семпл MFT
     MFT_OUTPUT_DATA_BUFFER output_buffer = {};
     output_buffer.dwStreamID = 0;
-    
-    hr = MFCreateSample(&output_buffer.pSample);
-    if (FAILED(hr)) {
-        SetError("Failed to create output sample");
-        return false;
-    }
-
-    hr = MFCreateMemoryBuffer(width_ * height_, &media_buffer);
-    if (SUCCEEDED(hr)) {
-        output_buffer.pSample->AddBuffer(media_buffer);
-        media_buffer->Release();
+    if (output_sample_) {
+        // Атрибути попереднього кадру (CleanPoint) не мають перейти на наступний
+        output_sample_->DeleteAllItems();
+        output_buffer_->SetCurrentLength(0);
+        output_buffer.pSample = output_sample_;
     }
 
     DWORD status = 0;
     hr = encoder_->ProcessOutput(0, 1, &output_buffer, &status);
 
+    if (output_buffer.pEvents) {
+        output_buffer.pEvents->Release();
+        output_buffer.pEvents = nullptr;
+    }
+
+    // Семпл, виділений MFT, звільняється після копіювання; власний - живе до Cleanup
+    IMFSample* produced = output_buffer.pSample;
+    const bool owns_produced = produced && produced != output_sample_;
+
     if (hr == MF_E_TRANSFORM_NEED_MORE_INPUT) {
         // Потрібно більше даних - це нормально
-        output_buffer.pSample->Release();
+        GetCaptureStats().Add(StatCounter::EncoderNeedInput);
+        if (owns_produced) {
+            produced->Release();
+        }
         return true;
     }
 
-    if (FAILED(hr)) {
-        output_buffer.pSample->Release();
+    if (FAILED(hr) || !produced) {
+        if (owns_produced) {
+            produced->Release();
+        }
         SetError("Failed to process output");
         return false;
     }
 
-    // Отримати дані з output sample
-    hr = output_buffer.pSample->ConvertToContiguousBuffer(&media_buffer);
+    // IDR кадри MFT позначає як clean point
+    UINT32 clean_point = 0;
+    if (SUCCEEDED(produced->GetUINT32(MFSampleExtension_CleanPoint, &clean_point))) {
+        last_keyframe_ = clean_point != 0;
+    }
+
+    // Власний семпл має один буфер - читаємо його напряму, без ConvertToContiguousBuffer
+    if (produced == output_sample_) {
+        media_buffer = output_buffer_;
+        media_buffer->AddRef();
+        hr = S_OK;
+    } else {
+        hr = produced->ConvertToContiguousBuffer(&media_buffer);
+    }
     if (SUCCEEDED(hr)) {
         BYTE* data = nullptr;
         DWORD length = 0;
         
         hr = media_buffer->Lock(&data, nullptr, &length);
         if (SUCCEEDED(hr)) {
-            h264Data.assign(data, data + length);
+            // Одне копіювання з буфера MFT одразу у вихідний буфер пулу
+            if (length <= capacity) {
+                memcpy(out, data, length);
+                out_size = length;
+            }
             media_buffer->Unlock();
         }
         
         media_buffer->Release();
     }
 
-    output_buffer.pSample->Release();
+    if (owns_produced) {
+        produced->Release();
+    }
+
+    if (out_size == 0) {
+        SetError("Encoded frame does not fit output buffer");
+        return false;
+    }
 
-    return h264Data.size() > 0;
+    return true;
 }
 
 void H264Encoder::Cleanup() {
@@ -382,6 +475,9 @@ void H264Encoder::Cleanup() {
         encoder_ = nullptr;
     }
 
+    // Після звільнення MFT семпли вже ніхто не тримає
+    ReleaseSamples();
+
     if (input_type_) {
         input_type_->Release();
         input_type_ = nullptr;
@@ -398,4 +494,7 @@ void H264Encoder::Cleanup() {
     }
 
     sample_time_ = 0;
+    width_ = 0;
+    height_ = 0;
+    last_keyframe_ = false;
 }
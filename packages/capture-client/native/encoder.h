@@ -6,47 +6,52 @@
 #ifndef ENCODER_H
 #define ENCODER_H
 
-#include <vector>
-#include <cstdint>
-#include <string>
+#include "video-encoder.h"
 #include <windows.h>
 #include <mfapi.h>
 #include <mfidl.h>
 #include <mfreadwrite.h>
 #include <mferror.h>
 
-class H264Encoder {
+// Бекенд VideoEncoder для Windows (Media Foundation MFT)
+class H264Encoder : public VideoEncoder {
 public:
     H264Encoder();
-    ~H264Encoder();
+    ~H264Encoder() override;
 
-    bool Initialize(int width, int height, int bitrate = 2000000, int fps = 30, bool useHardware = true);
-    bool Encode(const std::vector<uint8_t>& bgraData, std::vector<uint8_t>& h264Data);
-    void Cleanup();
-    
-    std::string GetLastError() const { return last_error_; }
+    bool Initialize(const VideoEncoderConfig& config) override;
+    bool EncodeNV12(const uint8_t* nv12, uint8_t* out, size_t capacity, size_t& out_size) override;
+    void Cleanup() override;
+    const char* GetName() const override { return "mf"; }
 
 private:
     bool InitializeMediaFoundation();
     bool CreateEncoder();
     bool ConfigureEncoder();
-    void SetError(const std::string& error);
-    
+    bool CreateSamples();
+    void ReleaseSamples();
+    IMFSample* AcquireInputSample(IMFMediaBuffer** buffer);
+
+    // Семпли створюються один раз при Initialize і перевикористовуються кожен кадр.
+    // Вхідних кілька: асинхронний (апаратний) MFT може ще тримати попередній семпл.
+    static constexpr int kInputSamples = 4;
+
     IMFTransform* encoder_ = nullptr;
     IMFMediaType* input_type_ = nullptr;
     IMFMediaType* output_type_ = nullptr;
-    IMFSample* input_sample_ = nullptr;
-    
-    int width_ = 0;
-    int height_ = 0;
+    IMFSample* input_samples_[kInputSamples] = {};
+    IMFMediaBuffer* input_buffers_[kInputSamples] = {};
+    int next_input_ = 0;
+    IMFSample* output_sample_ = nullptr;     // nullptr, якщо семпли виділяє сам MFT
+    IMFMediaBuffer* output_buffer_ = nullptr;
+
     int bitrate_ = 0;
     int fps_ = 0;
     bool use_hardware_ = false;
     bool mf_initialized_ = false;
-    
-    std::string last_error_;
-    UINT64 sample_time_ = 0;
-    UINT64 sample_duration_ = 0;
+
+    uint64_t sample_time_ = 0;
+    uint64_t sample_duration_ = 0;
 };
 
 #endif // ENCODER_H
@@ -0,0 +1,208 @@
+/**
+ * Frame Broadcast Implementation
+ */
+
+#include "frame-broadcast.h"
+#include "buffer-arena.h"
+#include <algorithm>
+#include <chrono>
+#include <new>
+
+bool ParseBroadcastDropPolicy(const std::string& name, BroadcastDropPolicy& policy) {
+    if (name == "oldest") {
+        policy = BroadcastDropPolicy::DropOldest;
+        return true;
+    }
+    if (name == "newest") {
+        policy = BroadcastDropPolicy::DropNewest;
+        return true;
+    }
+    return false;
+}
+
+const char* GetBroadcastDropPolicyName(BroadcastDropPolicy policy) {
+    return policy == BroadcastDropPolicy::DropNewest ? "newest" : "oldest";
+}
+
+FrameBroadcast::FrameBroadcast() {
+}
+
+std::shared_ptr<BroadcastFrame> FrameBroadcast::CreateFrame() {
+    try {
+        return std::allocate_shared<BroadcastFrame>(ArenaAllocator<BroadcastFrame>());
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+int FrameBroadcast::AddConsumer(const std::string& name, size_t capacity, BroadcastDropPolicy policy,
+                                NotifyFunc notify) {
+    if (capacity == 0 || capacity > kMaxCapacity) {
+        return 0;
+    }
+
+    auto consumer = std::make_shared<Consumer>();
+    consumer->name = name;
+    consumer->policy = policy;
+    consumer->notify = std::move(notify);
+    // Кільце фіксованого розміру: Publish не виділяє пам'ять
+    consumer->ring.resize(capacity);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    consumer->id = next_id_++;
+    consumers_.push_back(consumer);
+    consumer_count_.store((int)consumers_.size(), std::memory_order_relaxed);
+    return consumer->id;
+}
+
+bool FrameBroadcast::RemoveConsumer(int id) {
+    std::shared_ptr<Consumer> removed;
+    {
+        // Publish повідомляє під цим mutex - після виходу notify споживача більше не викликається
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find_if(consumers_.begin(), consumers_.end(),
+                               [id](const std::shared_ptr<Consumer>& c) { return c->id == id; });
+        if (it == consumers_.end()) {
+            return false;
+        }
+        removed = *it;
+        consumers_.erase(it);
+        consumer_count_.store((int)consumers_.size(), std::memory_order_relaxed);
+    }
+
+    // Кадри в черзі повертаються в арену, Wait повертається
+    std::lock_guard<std::mutex> consumer_lock(removed->mutex);
+    for (BroadcastFramePtr& frame : removed->ring) {
+        frame.reset();
+    }
+    removed->count = 0;
+    removed->removed = true;
+    removed->cv.notify_all();
+    return true;
+}
+
+void FrameBroadcast::RemoveAllConsumers() {
+    std::vector<int> ids;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& consumer : consumers_) {
+            ids.push_back(consumer->id);
+        }
+    }
+    for (int id : ids) {
+        RemoveConsumer(id);
+    }
+}
+
+void FrameBroadcast::Publish(std::shared_ptr<BroadcastFrame> frame) {
+    if (!frame) {
+        return;
+    }
+    frame->sequence = published_.fetch_add(1, std::memory_order_relaxed) + 1;
+    BroadcastFramePtr shared = std::move(frame);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& consumer_ptr : consumers_) {
+        Consumer& consumer = *consumer_ptr;
+        {
+            std::lock_guard<std::mutex> consumer_lock(consumer.mutex);
+            const size_t capacity = consumer.ring.size();
+            if (consumer.count == capacity) {
+                consumer.dropped++;
+                if (consumer.policy == BroadcastDropPolicy::DropNewest) {
+                    // Черга повна - кадр не потрапляє до цього споживача, інші його отримують
+                    continue;
+                }
+                consumer.ring[consumer.head].reset();
+                consumer.head = (consumer.head + 1) % capacity;
+                consumer.count--;
+            }
+            // Лише лічильник посилань - пікселі не копіюються
+            consumer.ring[(consumer.head + consumer.count) % capacity] = shared;
+            consumer.count++;
+            consumer.peak_count = std::max(consumer.peak_count, consumer.count);
+        }
+        consumer.cv.notify_one();
+
+        // Одне повідомлення, доки споживач не почав вичитувати чергу
+        if (consumer.notify && !consumer.notify_pending.exchange(true, std::memory_order_acq_rel)) {
+            consumer.notify(consumer.id);
+        }
+    }
+}
+
+std::shared_ptr<FrameBroadcast::Consumer> FrameBroadcast::Find(int id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& consumer : consumers_) {
+        if (consumer->id == id) {
+            return consumer;
+        }
+    }
+    return nullptr;
+}
+
+bool FrameBroadcast::PopLocked(Consumer& consumer, BroadcastFramePtr& frame) {
+    if (consumer.count == 0) {
+        return false;
+    }
+    frame = std::move(consumer.ring[consumer.head]);
+    consumer.head = (consumer.head + 1) % consumer.ring.size();
+    consumer.count--;
+    consumer.delivered++;
+    return true;
+}
+
+void FrameBroadcast::BeginDrain(int id) {
+    // Скидається до вичитування: кадр, опублікований під час drain, дасть нове повідомлення
+    if (auto consumer = Find(id)) {
+        consumer->notify_pending.store(false, std::memory_order_release);
+    }
+}
+
+bool FrameBroadcast::Poll(int id, BroadcastFramePtr& frame) {
+    auto consumer = Find(id);
+    if (!consumer) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(consumer->mutex);
+    return PopLocked(*consumer, frame);
+}
+
+bool FrameBroadcast::Wait(int id, BroadcastFramePtr& frame, unsigned int timeout_ms) {
+    auto consumer = Find(id);
+    if (!consumer) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(consumer->mutex);
+    consumer->cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&consumer]() {
+        return consumer->count > 0 || consumer->removed;
+    });
+    return PopLocked(*consumer, frame);
+}
+
+std::vector<BroadcastConsumerStats> FrameBroadcast::GetStats() const {
+    // Той самий годинник, що й timestamp_ms кадру
+    const double now_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<BroadcastConsumerStats> result;
+    result.reserve(consumers_.size());
+    for (const auto& consumer : consumers_) {
+        std::lock_guard<std::mutex> consumer_lock(consumer->mutex);
+        BroadcastConsumerStats stats;
+        stats.id = consumer->id;
+        stats.name = consumer->name;
+        stats.policy = consumer->policy;
+        stats.capacity = consumer->ring.size();
+        stats.queued = consumer->count;
+        stats.peak_queued = consumer->peak_count;
+        if (consumer->count > 0) {
+            stats.lag_ms = std::max(0.0, now_ms - consumer->ring[consumer->head]->timestamp_ms);
+        }
+        stats.delivered = consumer->delivered;
+        stats.dropped = consumer->dropped;
+        result.push_back(stats);
+    }
+    return result;
+}
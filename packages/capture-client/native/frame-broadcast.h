@@ -0,0 +1,122 @@
+/**
+ * Frame Broadcast
+ * Один виробник, кілька споживачів одного захопленого кадру (енкодер для глядачів,
+ * прев'ю, запис): кадр спільний за лічильником посилань і ніколи не копіюється,
+ * кожен споживач має власну обмежену чергу, тож повільний не гальмує інших.
+ */
+
+#ifndef FRAME_BROADCAST_H
+#define FRAME_BROADCAST_H
+
+#include "aligned-memory.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Незмінний після Publish кадр (BGRA у розмірі джерела)
+struct BroadcastFrame {
+    AlignedBuffer data;
+    int width = 0;
+    int height = 0;
+    int stride = 0;
+    double timestamp_ms = 0.0;  // Час захоплення (steady clock)
+    uint64_t sequence = 0;      // Призначає Publish
+    int output = 0;             // Вихід (монітор) джерела; -1 - склеєне полотно
+};
+
+typedef std::shared_ptr<const BroadcastFrame> BroadcastFramePtr;
+
+// Що робити, коли черга споживача заповнена
+enum class BroadcastDropPolicy {
+    DropOldest,     // Відкинути найстаріший - споживач завжди бачить свіжі кадри (прев'ю)
+    DropNewest      // Відкинути новий - без розривів у вже прийнятій послідовності (запис)
+};
+
+bool ParseBroadcastDropPolicy(const std::string& name, BroadcastDropPolicy& policy);
+const char* GetBroadcastDropPolicyName(BroadcastDropPolicy policy);
+
+struct BroadcastConsumerStats {
+    int id = 0;
+    std::string name;
+    BroadcastDropPolicy policy = BroadcastDropPolicy::DropOldest;
+    size_t capacity = 0;
+    size_t queued = 0;          // Відставання в кадрах
+    size_t peak_queued = 0;
+    double lag_ms = 0.0;        // Вік найстарішого кадру в черзі
+    uint64_t delivered = 0;
+    uint64_t dropped = 0;
+};
+
+class FrameBroadcast {
+public:
+    static constexpr size_t kMaxCapacity = 64;
+
+    // Кадри в черзі споживача consumer_id (з потоку виробника; одне повідомлення
+    // на серію - як CaptureLoop)
+    typedef std::function<void(int consumer_id)> NotifyFunc;
+
+    FrameBroadcast();
+
+    FrameBroadcast(const FrameBroadcast&) = delete;
+    FrameBroadcast& operator=(const FrameBroadcast&) = delete;
+
+    // Новий кадр для заповнення виробником (об'єкт і буфер - з BufferArena)
+    static std::shared_ptr<BroadcastFrame> CreateFrame();
+
+    // id > 0; 0 - невірні параметри
+    int AddConsumer(const std::string& name, size_t capacity, BroadcastDropPolicy policy,
+                    NotifyFunc notify = NotifyFunc());
+    bool RemoveConsumer(int id);
+    void RemoveAllConsumers();
+
+    // Дешева перевірка в гарячому шляху: без споживачів кадр не передається
+    bool HasConsumers() const { return consumer_count_.load(std::memory_order_relaxed) > 0; }
+
+    // Поставити кадр у черги всіх споживачів (не блокується на обробці)
+    void Publish(std::shared_ptr<BroadcastFrame> frame);
+
+    // Споживач: BeginDrain перед вичитуванням, далі Poll до false
+    void BeginDrain(int id);
+    bool Poll(int id, BroadcastFramePtr& frame);
+    // Чекати кадр до timeout_ms (нативні споживачі на власному потоці)
+    bool Wait(int id, BroadcastFramePtr& frame, unsigned int timeout_ms);
+
+    uint64_t GetPublished() const { return published_.load(std::memory_order_relaxed); }
+    std::vector<BroadcastConsumerStats> GetStats() const;
+
+private:
+    struct Consumer {
+        int id = 0;
+        std::string name;
+        BroadcastDropPolicy policy = BroadcastDropPolicy::DropOldest;
+        NotifyFunc notify;
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<BroadcastFramePtr> ring;    // Фіксований розмір = capacity
+        size_t head = 0;
+        size_t count = 0;
+        size_t peak_count = 0;
+        uint64_t delivered = 0;
+        uint64_t dropped = 0;
+        std::atomic<bool> notify_pending{false};
+        bool removed = false;
+    };
+
+    std::shared_ptr<Consumer> Find(int id) const;
+    static bool PopLocked(Consumer& consumer, BroadcastFramePtr& frame);
+
+    mutable std::mutex mutex_;      // Реєстр споживачів
+    std::vector<std::shared_ptr<Consumer>> consumers_;
+    std::atomic<int> consumer_count_{0};
+    std::atomic<uint64_t> published_{0};
+    int next_id_ = 1;
+};
+
+#endif // FRAME_BROADCAST_H
@@ -0,0 +1,124 @@
+/**
+ * Striped Frame Converter Implementation
+ */
+
+#include "frame-converter.h"
+#include "worker-pool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+FrameConverter::FrameConverter() {
+}
+
+void FrameConverter::SetColorSpace(ColorMatrix matrix, ColorRange range) {
+    matrix_ = matrix;
+    range_ = range;
+}
+
+int FrameConverter::GetThreadCount() const {
+    return pool_ ? pool_->GetThreadCount() : 1;
+}
+
+int FrameConverter::ComputeStripeRows(int height, int threads) {
+    int rows = (height + threads - 1) / std::max(1, threads);
+    rows = std::max(rows, kMinStripeRows);
+    return (rows + 1) & ~1;
+}
+
+bool FrameConverter::ConvertToNV12(const uint8_t* src, int src_stride, int width, int height,
+                                   uint8_t* dst_y, int dst_y_stride,
+                                   uint8_t* dst_uv, int dst_uv_stride) {
+    auto start = std::chrono::steady_clock::now();
+
+    int stripe_rows = ComputeStripeRows(height, GetThreadCount());
+    int stripes = (height + stripe_rows - 1) / stripe_rows;
+    std::atomic<bool> ok{true};
+
+    auto convert_stripe = [&](int i) {
+        int y = i * stripe_rows;
+        int rows = std::min(stripe_rows, height - y);
+        if (!ConvertBGRAToNV12(src + (size_t)y * src_stride, src_stride, width, rows,
+                               dst_y + (size_t)y * dst_y_stride, dst_y_stride,
+                               dst_uv + (size_t)(y / 2) * dst_uv_stride, dst_uv_stride,
+                               matrix_, range_)) {
+            ok = false;
+        }
+    };
+
+    if (pool_ && stripes > 1) {
+        pool_->ParallelFor(stripes, convert_stripe);
+    } else {
+        for (int i = 0; i < stripes; i++) {
+            convert_stripe(i);
+        }
+    }
+
+    last_convert_ms_ = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return ok;
+}
+
+bool FrameConverter::ConvertToI420(const uint8_t* src, int src_stride, int width, int height,
+                                   uint8_t* dst_y, int dst_y_stride,
+                                   uint8_t* dst_u, int dst_u_stride,
+                                   uint8_t* dst_v, int dst_v_stride) {
+    auto start = std::chrono::steady_clock::now();
+
+    int stripe_rows = ComputeStripeRows(height, GetThreadCount());
+    int stripes = (height + stripe_rows - 1) / stripe_rows;
+    std::atomic<bool> ok{true};
+
+    auto convert_stripe = [&](int i) {
+        int y = i * stripe_rows;
+        int rows = std::min(stripe_rows, height - y);
+        if (!ConvertBGRAToI420(src + (size_t)y * src_stride, src_stride, width, rows,
+                               dst_y + (size_t)y * dst_y_stride, dst_y_stride,
+                               dst_u + (size_t)(y / 2) * dst_u_stride, dst_u_stride,
+                               dst_v + (size_t)(y / 2) * dst_v_stride, dst_v_stride,
+                               matrix_, range_)) {
+            ok = false;
+        }
+    };
+
+    if (pool_ && stripes > 1) {
+        pool_->ParallelFor(stripes, convert_stripe);
+    } else {
+        for (int i = 0; i < stripes; i++) {
+            convert_stripe(i);
+        }
+    }
+
+    last_convert_ms_ = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return ok;
+}
+
+void FrameConverter::CopyRows(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+                              int row_bytes, int height) {
+    // Щільно упаковані буфери - одним memcpy
+    if (src_stride == row_bytes && dst_stride == row_bytes && (!pool_ || GetThreadCount() == 1)) {
+        memcpy(dst, src, (size_t)row_bytes * height);
+        return;
+    }
+
+    int stripe_rows = ComputeStripeRows(height, GetThreadCount());
+    int stripes = (height + stripe_rows - 1) / stripe_rows;
+
+    auto copy_stripe = [&](int i) {
+        int y0 = i * stripe_rows;
+        int y1 = std::min(height, y0 + stripe_rows);
+        for (int y = y0; y < y1; y++) {
+            memcpy(dst + (size_t)y * dst_stride, src + (size_t)y * src_stride, row_bytes);
+        }
+    };
+
+    if (pool_ && stripes > 1) {
+        pool_->ParallelFor(stripes, copy_stripe);
+    } else {
+        for (int i = 0; i < stripes; i++) {
+            copy_stripe(i);
+        }
+    }
+}
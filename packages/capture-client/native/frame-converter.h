@@ -0,0 +1,52 @@
+/**
+ * Striped Frame Converter
+ * Паралельна конвертація кадру горизонтальними смугами на WorkerPool
+ */
+
+#ifndef FRAME_CONVERTER_H
+#define FRAME_CONVERTER_H
+
+#include "color-convert.h"
+#include <cstdint>
+
+class WorkerPool;
+
+class FrameConverter {
+public:
+    // Мінімальна висота смуги - менші смуги не окупають синхронізацію
+    static constexpr int kMinStripeRows = 32;
+
+    FrameConverter();
+
+    void SetWorkerPool(WorkerPool* pool) { pool_ = pool; }
+    void SetColorSpace(ColorMatrix matrix, ColorRange range);
+
+    bool ConvertToNV12(const uint8_t* src, int src_stride, int width, int height,
+                       uint8_t* dst_y, int dst_y_stride,
+                       uint8_t* dst_uv, int dst_uv_stride);
+
+    bool ConvertToI420(const uint8_t* src, int src_stride, int width, int height,
+                       uint8_t* dst_y, int dst_y_stride,
+                       uint8_t* dst_u, int dst_u_stride,
+                       uint8_t* dst_v, int dst_v_stride);
+
+    // Копіювання рядків з урахуванням pitch (теж смугами)
+    void CopyRows(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+                  int row_bytes, int height);
+
+    // Тривалість останньої конвертації (мс)
+    double GetLastConvertTimeMs() const { return last_convert_ms_; }
+
+    // Межі смуг вирівняні на парні рядки (рядки chroma)
+    static int ComputeStripeRows(int height, int threads);
+
+private:
+    int GetThreadCount() const;
+
+    WorkerPool* pool_ = nullptr;
+    ColorMatrix matrix_ = ColorMatrix::BT601;
+    ColorRange range_ = ColorRange::Limited;
+    double last_convert_ms_ = 0.0;
+};
+
+#endif // FRAME_CONVERTER_H
@@ -0,0 +1,228 @@
+/**
+ * Frame Pipeline Implementation
+ */
+
+#include "frame-pipeline.h"
+#include <chrono>
+
+namespace {
+
+// Скільки разів перевірити кільце перед сном (кадр зазвичай уже в дорозі)
+constexpr int kSpinAttempts = 64;
+// Страховка від втраченого пробудження
+constexpr auto kWakeupTimeout = std::chrono::milliseconds(10);
+
+void UpdatePeak(std::atomic<size_t>& peak, size_t value) {
+    size_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value)) {
+    }
+}
+
+} // namespace
+
+FramePipeline::FramePipeline() {
+}
+
+FramePipeline::~FramePipeline() {
+    Stop();
+}
+
+bool FramePipeline::Start(size_t slot_count, size_t capture_bytes, size_t scratch_bytes,
+                          const std::vector<Stage>& stages, SinkFunc sink) {
+    if (running_) {
+        SetError("Pipeline already running");
+        return false;
+    }
+    if (stages.empty() || stages.size() > kMaxStages || slot_count == 0 || !sink) {
+        SetError("Invalid pipeline configuration");
+        return false;
+    }
+
+    slots_.clear();
+    stages_.clear();
+    spare_ = nullptr;
+    sink_ = sink;
+    submitted_ = 0;
+    completed_ = 0;
+    source_stalls_ = 0;
+    source_blocked_ = 0;
+
+    // Усі слоти виділяються заздалегідь - у роботі пам'ять не виділяється
+    if (!free_.Initialize(slot_count)) {
+        SetError("Failed to allocate pipeline rings");
+        return false;
+    }
+    for (size_t i = 0; i < slot_count; i++) {
+        std::unique_ptr<PipelineFrame> slot(new PipelineFrame());
+        if (!slot->capture.Resize(capture_bytes) || !slot->scratch.Resize(scratch_bytes)) {
+            SetError("Failed to allocate pipeline slots");
+            slots_.clear();
+            return false;
+        }
+        free_.TryPush(slot.get());
+        slots_.push_back(std::move(slot));
+    }
+
+    for (const Stage& stage : stages) {
+        std::unique_ptr<StageState> state(new StageState());
+        state->name = stage.name;
+        state->func = stage.func;
+        // Ємність = кількість слотів, тому кільце між стадіями не переповнюється
+        state->input.Initialize(slot_count);
+        stages_.push_back(std::move(state));
+    }
+
+    running_ = true;
+    for (size_t i = 0; i < stages_.size(); i++) {
+        stages_[i]->thread = std::thread(&FramePipeline::StageMain, this, i);
+    }
+    return true;
+}
+
+void FramePipeline::Stop() {
+    running_ = false;
+
+    for (auto& stage : stages_) {
+        std::lock_guard<std::mutex> lock(stage->doorbell.mutex);
+        stage->doorbell.cv.notify_all();
+    }
+    for (auto& stage : stages_) {
+        if (stage->thread.joinable()) {
+            stage->thread.join();
+        }
+    }
+}
+
+PipelineFrame* FramePipeline::AcquireSlot() {
+    PipelineFrame* frame = spare_;
+    spare_ = nullptr;
+
+    if (!frame && !free_.TryPop(frame)) {
+        // Усі слоти в роботі - найповільніша стадія не встигає
+        source_stalls_++;
+        return nullptr;
+    }
+
+    frame->dropped = false;
+    frame->output = LoopFrame();
+    return frame;
+}
+
+void FramePipeline::Submit(PipelineFrame* frame) {
+    submitted_++;
+    PushTo(*stages_[0], frame, source_blocked_);
+}
+
+void FramePipeline::Cancel(PipelineFrame* frame) {
+    // Слот лишається у джерела для наступної спроби
+    spare_ = frame;
+}
+
+void FramePipeline::Ring(Doorbell& doorbell) {
+    // Пара до fence у WaitForInput: або споживач побачить кадр, або ми - sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (doorbell.sleeping.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(doorbell.mutex);
+        doorbell.cv.notify_one();
+    }
+}
+
+void FramePipeline::PushTo(StageState& target, PipelineFrame* frame, std::atomic<uint64_t>& blocked) {
+    if (!target.input.TryPush(frame)) {
+        blocked++;
+        while (!target.input.TryPush(frame)) {
+            std::this_thread::yield();
+        }
+    }
+    UpdatePeak(target.peak_queue_depth, target.input.Size());
+    Ring(target.doorbell);
+}
+
+bool FramePipeline::WaitForInput(StageState& stage, PipelineFrame*& frame) {
+    for (int i = 0; i < kSpinAttempts; i++) {
+        if (stage.input.TryPop(frame)) {
+            return true;
+        }
+        if (!running_) {
+            return false;
+        }
+    }
+
+    stage.starved++;
+
+    std::unique_lock<std::mutex> lock(stage.doorbell.mutex);
+    stage.doorbell.sleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    bool got = false;
+    while (running_) {
+        if (stage.input.TryPop(frame)) {
+            got = true;
+            break;
+        }
+        stage.doorbell.cv.wait_for(lock, kWakeupTimeout);
+    }
+
+    stage.doorbell.sleeping.store(false, std::memory_order_relaxed);
+    return got;
+}
+
+void FramePipeline::StageMain(size_t index) {
+    StageState& stage = *stages_[index];
+    bool last = index + 1 == stages_.size();
+
+    PipelineFrame* frame = nullptr;
+    while (WaitForInput(stage, frame)) {
+        if (!frame->dropped) {
+            auto start = std::chrono::steady_clock::now();
+            bool ok = stage.func(*frame);
+            stage.busy_us += (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+            if (ok) {
+                stage.processed++;
+            } else {
+                stage.dropped++;
+                frame->dropped = true;
+            }
+        }
+
+        if (!last) {
+            PushTo(*stages_[index + 1], frame, stage.blocked);
+            continue;
+        }
+
+        if (!frame->dropped) {
+            sink_(*frame);
+            completed_++;
+        }
+        // Слот повертається джерелу (free_ має місце для всіх слотів)
+        free_.TryPush(frame);
+    }
+}
+
+PipelineStats FramePipeline::GetStats() const {
+    PipelineStats stats;
+    stats.submitted = submitted_;
+    stats.completed = completed_;
+    stats.source_stalls = source_stalls_;
+    stats.slots = slots_.size();
+
+    for (const auto& stage : stages_) {
+        PipelineStageStats stage_stats;
+        stage_stats.name = stage->name;
+        stage_stats.processed = stage->processed;
+        stage_stats.dropped = stage->dropped;
+        stage_stats.starved = stage->starved;
+        stage_stats.blocked = stage->blocked;
+        stage_stats.queue_depth = stage->input.Size();
+        stage_stats.peak_queue_depth = stage->peak_queue_depth;
+        stage_stats.busy_ms = stage->busy_us / 1000.0;
+        stats.stages.push_back(stage_stats);
+    }
+    return stats;
+}
+
+void FramePipeline::SetError(const std::string& error) {
+    last_error_ = error;
+}
@@ -0,0 +1,129 @@
+/**
+ * Frame Pipeline
+ * Стадії capture -> convert -> encode на окремих потоках, з'єднані
+ * lock-free SPSC кільцями з обмеженим пулом слотів кадрів
+ */
+
+#ifndef FRAME_PIPELINE_H
+#define FRAME_PIPELINE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "aligned-memory.h"
+#include "capture-loop.h"
+#include "frame-view.h"
+#include "spsc-ring.h"
+
+// Слот кадру - проходить усі стадії і повертається у вільне кільце
+struct PipelineFrame {
+    AlignedBuffer capture;      // Вхід від джерела (BGRA)
+    AlignedBuffer scratch;      // Проміжний результат (наприклад, NV12)
+    LoopFrame output;           // Результат для доставки (заповнює остання стадія)
+    std::vector<MoveRect> moves;    // Переміщення від джерела (підказка дельта-кодеру)
+    bool dropped = false;       // Стадія відкинула кадр - наступні пропускають
+};
+
+struct PipelineStageStats {
+    std::string name;
+    uint64_t processed = 0;     // Кадри, оброблені стадією
+    uint64_t dropped = 0;       // Кадри, відкинуті стадією
+    uint64_t starved = 0;       // Очікування вхідного кадру (стадія простоює)
+    uint64_t blocked = 0;       // Очікування місця у вихідному кільці
+    size_t queue_depth = 0;     // Кадри у вхідному кільці
+    size_t peak_queue_depth = 0;
+    double busy_ms = 0.0;       // Сумарний час роботи стадії
+};
+
+struct PipelineStats {
+    uint64_t submitted = 0;
+    uint64_t completed = 0;     // Кадри, передані в sink
+    uint64_t source_stalls = 0; // Джерело не отримало вільний слот (усі в роботі)
+    size_t slots = 0;
+    std::vector<PipelineStageStats> stages;
+};
+
+class FramePipeline {
+public:
+    static constexpr int kMaxStages = 4;
+
+    // Обробити кадр; false - кадр відкинуто (наступні стадії його пропускають)
+    typedef std::function<bool(PipelineFrame& frame)> StageFunc;
+    // Готовий кадр після останньої стадії (потік останньої стадії)
+    typedef std::function<void(PipelineFrame& frame)> SinkFunc;
+
+    struct Stage {
+        std::string name;
+        StageFunc func;
+    };
+
+    FramePipeline();
+    ~FramePipeline();
+
+    // slot_count - скільки кадрів одночасно в роботі (обмежує пам'ять і затримку)
+    bool Start(size_t slot_count, size_t capture_bytes, size_t scratch_bytes,
+               const std::vector<Stage>& stages, SinkFunc sink);
+    // Зупинити потоки; кадри, що не дійшли до sink, відкидаються
+    void Stop();
+
+    // Сторона джерела (один потік): отримати вільний слот, заповнити
+    // capture та output.timestamp_ms/sequence, потім Submit або Cancel
+    PipelineFrame* AcquireSlot();
+    void Submit(PipelineFrame* frame);
+    void Cancel(PipelineFrame* frame);
+
+    bool IsRunning() const { return running_; }
+    PipelineStats GetStats() const;
+    std::string GetLastError() const { return last_error_; }
+
+private:
+    // Пробудження стадії, що чекає на вхідний кадр
+    struct Doorbell {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::atomic<bool> sleeping{false};
+    };
+
+    struct StageState {
+        std::string name;
+        StageFunc func;
+        SpscRing<PipelineFrame*> input;
+        Doorbell doorbell;
+        std::thread thread;
+
+        std::atomic<uint64_t> processed{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> starved{0};
+        std::atomic<uint64_t> blocked{0};
+        std::atomic<size_t> peak_queue_depth{0};
+        std::atomic<uint64_t> busy_us{0};
+    };
+
+    void StageMain(size_t index);
+    bool WaitForInput(StageState& stage, PipelineFrame*& frame);
+    void PushTo(StageState& target, PipelineFrame* frame, std::atomic<uint64_t>& blocked);
+    static void Ring(Doorbell& doorbell);
+    void SetError(const std::string& error);
+
+    std::vector<std::unique_ptr<PipelineFrame>> slots_;
+    std::vector<std::unique_ptr<StageState>> stages_;
+    SpscRing<PipelineFrame*> free_;     // Остання стадія -> джерело
+    PipelineFrame* spare_ = nullptr;    // Скасований слот (лише потік джерела)
+    SinkFunc sink_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> completed_{0};
+    std::atomic<uint64_t> source_stalls_{0};
+    std::atomic<uint64_t> source_blocked_{0};
+    std::string last_error_;
+};
+
+#endif // FRAME_PIPELINE_H
@@ -0,0 +1,81 @@
+/**
+ * Frame Buffer Pool Implementation
+ */
+
+#include "frame-pool.h"
+#include "buffer-arena.h"
+
+FramePool::FramePool(size_t buffer_size) : buffer_size_(buffer_size) {
+}
+
+FramePool::~FramePool() {
+    // Блоки повертаються в арену: пул для тієї ж роздільності (restart, повторна
+    // ініціалізація) отримає їх без нових виділень
+    BufferArena& arena = GetBufferArena();
+    for (uint8_t* buffer : buffers_) {
+        arena.Free(buffer);
+    }
+}
+
+std::shared_ptr<FramePool> FramePool::Create(size_t buffer_size, int depth) {
+    if (buffer_size == 0 || depth <= 0) {
+        return nullptr;
+    }
+
+    std::shared_ptr<FramePool> pool(new FramePool(buffer_size));
+    pool->buffers_.reserve(depth);
+    pool->free_list_.reserve(depth);
+
+    BufferArena& arena = GetBufferArena();
+    for (int i = 0; i < depth; i++) {
+        uint8_t* buffer = static_cast<uint8_t*>(arena.Allocate(buffer_size));
+        if (!buffer) {
+            return nullptr;
+        }
+        pool->buffers_.push_back(buffer);
+        pool->free_list_.push_back(buffer);
+    }
+
+    return pool;
+}
+
+uint8_t* FramePool::Acquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (free_list_.empty()) {
+        exhausted_++;
+        return nullptr;
+    }
+
+    uint8_t* buffer = free_list_.back();
+    free_list_.pop_back();
+    acquired_++;
+
+    int in_use = static_cast<int>(buffers_.size() - free_list_.size());
+    if (in_use > peak_in_use_) {
+        peak_in_use_ = in_use;
+    }
+    return buffer;
+}
+
+void FramePool::Release(uint8_t* buffer) {
+    if (!buffer) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_list_.push_back(buffer);
+}
+
+FramePoolStats FramePool::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    FramePoolStats stats;
+    stats.buffer_size = buffer_size_;
+    stats.depth = static_cast<int>(buffers_.size());
+    stats.in_use = static_cast<int>(buffers_.size() - free_list_.size());
+    stats.peak_in_use = peak_in_use_;
+    stats.acquired = acquired_;
+    stats.exhausted = exhausted_;
+    return stats;
+}
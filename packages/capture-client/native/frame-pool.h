@@ -0,0 +1,55 @@
+/**
+ * Frame Buffer Pool
+ * Попередньо виділені вирівняні буфери кадрів (з BufferArena) для передачі в JS без копіювання
+ */
+
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct FramePoolStats {
+    size_t buffer_size = 0;
+    int depth = 0;
+    int in_use = 0;
+    int peak_in_use = 0;
+    uint64_t acquired = 0;
+    uint64_t exhausted = 0;     // Acquire() без вільного буфера
+};
+
+// Буфери повертаються в пул з фіналізатора Napi::Buffer, тому пул
+// живе в shared_ptr і не знищується, поки JS тримає хоч один кадр.
+class FramePool {
+public:
+    static std::shared_ptr<FramePool> Create(size_t buffer_size, int depth);
+    ~FramePool();
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // nullptr, якщо всі буфери зайняті (рахується як exhausted)
+    uint8_t* Acquire();
+    void Release(uint8_t* buffer);
+
+    size_t GetBufferSize() const { return buffer_size_; }
+    int GetDepth() const { return static_cast<int>(buffers_.size()); }
+    FramePoolStats GetStats() const;
+
+private:
+    FramePool(size_t buffer_size);
+
+    size_t buffer_size_ = 0;
+    std::vector<uint8_t*> buffers_;     // Усі буфери (для звільнення)
+    std::vector<uint8_t*> free_list_;
+    mutable std::mutex mutex_;
+
+    int peak_in_use_ = 0;
+    uint64_t acquired_ = 0;
+    uint64_t exhausted_ = 0;
+};
+
+#endif // FRAME_POOL_H
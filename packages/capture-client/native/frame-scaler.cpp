@@ -0,0 +1,205 @@
+/**
+ * Striped Frame Scaler Implementation
+ */
+
+#include "frame-scaler.h"
+#include "frame-converter.h"
+#include "worker-pool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+FrameScaler::FrameScaler() {
+}
+
+void FrameScaler::SetColorSpace(ColorMatrix matrix, ColorRange range) {
+    matrix_ = matrix;
+    range_ = range;
+}
+
+void FrameScaler::SetKernel(ConvertKernel kernel) {
+    kernel_ = kernel;
+    h_scale_ = GetHScaleRowFunc(kernel_);
+    v_scale_ = GetVScaleRowFunc(kernel_);
+}
+
+int FrameScaler::GetThreadCount() const {
+    return pool_ ? pool_->GetThreadCount() : 1;
+}
+
+bool FrameScaler::Initialize(int src_width, int src_height, int dst_width, int dst_height,
+                             ScaleFilter filter) {
+    dst_width_ = 0;
+    dst_height_ = 0;
+    scratch_.clear();
+
+    if (dst_width <= 0 || dst_height <= 0 ||
+        !ComputeScaleTaps(src_width, dst_width, filter, h_taps_) ||
+        !ComputeScaleTaps(src_height, dst_height, filter, v_taps_) ||
+        h_taps_.taps > kMaxTaps || v_taps_.taps > kMaxTaps) {
+        return false;
+    }
+
+    h_scale_ = GetHScaleRowFunc(kernel_);
+    v_scale_ = GetVScaleRowFunc(kernel_);
+    if (!h_scale_ || !v_scale_) {
+        return false;
+    }
+
+    src_width_ = src_width;
+    src_height_ = src_height;
+    dst_width_ = dst_width;
+    dst_height_ = dst_height;
+    filter_ = filter;
+    return true;
+}
+
+const uint8_t* FrameScaler::ProduceRow(StripeScratch& scratch, const uint8_t* src, int src_stride,
+                                       int y, uint8_t* blend_row) const {
+    const int taps = v_taps_.taps;
+    const int start = v_taps_.start[y];
+    const int16_t* weights = &v_taps_.weights[(size_t)y * taps];
+    const size_t row_bytes = (size_t)dst_width_ * 4;
+    const bool h_identity = src_width_ == dst_width_;
+
+    // Рядки вікна: H-масштаб кожного рядка джерела рахується один раз на смугу
+    const uint8_t* rows[kMaxTaps];
+    for (int k = 0; k < taps; k++) {
+        int r = start + k;
+        if (h_identity) {
+            rows[k] = src + (size_t)r * src_stride;
+            continue;
+        }
+        int slot = r % taps;
+        uint8_t* ring_row = &scratch.ring[slot * row_bytes];
+        if (scratch.ring_rows[slot] != r) {
+            h_scale_(src + (size_t)r * src_stride, dst_width_, h_taps_, ring_row);
+            scratch.ring_rows[slot] = r;
+        }
+        rows[k] = ring_row;
+    }
+
+    // Один відлік з вагою 1.0 (той самий розмір по вертикалі, збіг сітки) - без змішування
+    for (int k = 0; k < taps; k++) {
+        if (weights[k] == (1 << kScaleWeightBits)) {
+            return rows[k];
+        }
+    }
+
+    v_scale_(rows, weights, taps, (int)row_bytes, blend_row);
+    return blend_row;
+}
+
+bool FrameScaler::Run(Output output, const uint8_t* src, int src_stride,
+                      uint8_t* dst0, int dst0_stride, uint8_t* dst1, int dst1_stride,
+                      uint8_t* dst2, int dst2_stride) {
+    auto start = std::chrono::steady_clock::now();
+
+    if (!IsInitialized() || !src || !dst0 || src_stride < src_width_ * 4) {
+        return false;
+    }
+    if (output != Output::BGRA && ((dst_width_ & 1) || (dst_height_ & 1))) {
+        return false;
+    }
+
+    ConvertRowPairFunc row_pair = nullptr;
+    if (output == Output::NV12) {
+        row_pair = GetNV12RowPairFunc(matrix_, range_, kernel_);
+    } else if (output == Output::I420) {
+        row_pair = GetI420RowPairFunc(matrix_, range_, kernel_);
+    }
+    if (output != Output::BGRA && !row_pair) {
+        return false;
+    }
+
+    int stripe_rows = FrameConverter::ComputeStripeRows(dst_height_, GetThreadCount());
+    int stripes = (dst_height_ + stripe_rows - 1) / stripe_rows;
+
+    // Робочі буфери виділяються один раз і живуть між кадрами
+    const size_t row_bytes = (size_t)dst_width_ * 4;
+    if ((int)scratch_.size() < stripes) {
+        scratch_.resize(stripes);
+    }
+    for (int i = 0; i < stripes; i++) {
+        StripeScratch& scratch = scratch_[i];
+        scratch.ring.resize(row_bytes * v_taps_.taps);
+        scratch.blended.resize(row_bytes * 2);
+        // Кільце не переживає кадр: джерело вже інше
+        scratch.ring_rows.assign(v_taps_.taps, -1);
+    }
+
+    auto scale_stripe = [&](int i) {
+        StripeScratch& scratch = scratch_[i];
+        int y0 = i * stripe_rows;
+        int y1 = std::min(dst_height_, y0 + stripe_rows);
+
+        if (output == Output::BGRA) {
+            for (int y = y0; y < y1; y++) {
+                uint8_t* dst_row = dst0 + (size_t)y * dst0_stride;
+                const uint8_t* row = ProduceRow(scratch, src, src_stride, y, dst_row);
+                if (row != dst_row) {
+                    memcpy(dst_row, row, row_bytes);
+                }
+            }
+            return;
+        }
+
+        uint8_t* blend0 = scratch.blended.data();
+        uint8_t* blend1 = blend0 + row_bytes;
+        for (int y = y0; y < y1; y += 2) {
+            const uint8_t* row0 = ProduceRow(scratch, src, src_stride, y, blend0);
+            // Слот кільця з row0 може перезаписатися вікном row1 (великий крок по джерелу)
+            if (row0 != blend0 && src_width_ != dst_width_) {
+                memcpy(blend0, row0, row_bytes);
+                row0 = blend0;
+            }
+            const uint8_t* row1 = ProduceRow(scratch, src, src_stride, y + 1, blend1);
+            uint8_t* y_row0 = dst0 + (size_t)y * dst0_stride;
+            uint8_t* y_row1 = y_row0 + dst0_stride;
+            uint8_t* u_row = dst1 + (size_t)(y / 2) * dst1_stride;
+            uint8_t* v_row = dst2 ? dst2 + (size_t)(y / 2) * dst2_stride : nullptr;
+            row_pair(row0, row1, dst_width_, y_row0, y_row1, u_row, v_row);
+        }
+    };
+
+    if (pool_ && stripes > 1) {
+        pool_->ParallelFor(stripes, scale_stripe);
+    } else {
+        for (int i = 0; i < stripes; i++) {
+            scale_stripe(i);
+        }
+    }
+
+    last_scale_ms_ = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+bool FrameScaler::ScaleToNV12(const uint8_t* src, int src_stride,
+                              uint8_t* dst_y, int dst_y_stride,
+                              uint8_t* dst_uv, int dst_uv_stride) {
+    if (!dst_uv) {
+        return false;
+    }
+    return Run(Output::NV12, src, src_stride, dst_y, dst_y_stride, dst_uv, dst_uv_stride,
+               nullptr, 0);
+}
+
+bool FrameScaler::ScaleToI420(const uint8_t* src, int src_stride,
+                              uint8_t* dst_y, int dst_y_stride,
+                              uint8_t* dst_u, int dst_u_stride,
+                              uint8_t* dst_v, int dst_v_stride) {
+    if (!dst_u || !dst_v) {
+        return false;
+    }
+    return Run(Output::I420, src, src_stride, dst_y, dst_y_stride, dst_u, dst_u_stride,
+               dst_v, dst_v_stride);
+}
+
+bool FrameScaler::ScaleBGRA(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride) {
+    if (dst_stride < dst_width_ * 4) {
+        return false;
+    }
+    return Run(Output::BGRA, src, src_stride, dst, dst_stride, nullptr, 0, nullptr, 0);
+}
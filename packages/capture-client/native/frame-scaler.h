@@ -0,0 +1,96 @@
+/**
+ * Striped Frame Scaler
+ * Масштабування BGRA кадру, злите з конвертацією в NV12 / I420: кожен вихідний рядок
+ * проходить H-масштаб -> V-змішування -> колірну конвертацію, поки він ще в L1/L2.
+ * Проміжний масштабований BGRA кадр у пам'ять не пишеться.
+ */
+
+#ifndef FRAME_SCALER_H
+#define FRAME_SCALER_H
+
+#include "color-convert.h"
+#include "image-scale.h"
+#include <cstdint>
+#include <vector>
+
+class WorkerPool;
+
+class FrameScaler {
+public:
+    // Верхня межа відліків на вісь (зменшення до ~60x)
+    static constexpr int kMaxTaps = 64;
+
+    FrameScaler();
+
+    // Розміри джерела >= 2; для NV12 / I420 вихідні розміри мають бути парними
+    bool Initialize(int src_width, int src_height, int dst_width, int dst_height,
+                    ScaleFilter filter);
+
+    void SetWorkerPool(WorkerPool* pool) { pool_ = pool; }
+    void SetColorSpace(ColorMatrix matrix, ColorRange range);
+    void SetKernel(ConvertKernel kernel);
+
+    bool ScaleToNV12(const uint8_t* src, int src_stride,
+                     uint8_t* dst_y, int dst_y_stride,
+                     uint8_t* dst_uv, int dst_uv_stride);
+
+    bool ScaleToI420(const uint8_t* src, int src_stride,
+                     uint8_t* dst_y, int dst_y_stride,
+                     uint8_t* dst_u, int dst_u_stride,
+                     uint8_t* dst_v, int dst_v_stride);
+
+    // Лише масштаб (для кодеків, що працюють з BGRA: delta, jpeg, bgra)
+    bool ScaleBGRA(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride);
+
+    bool IsInitialized() const { return dst_width_ > 0; }
+    int GetSourceWidth() const { return src_width_; }
+    int GetSourceHeight() const { return src_height_; }
+    int GetWidth() const { return dst_width_; }
+    int GetHeight() const { return dst_height_; }
+    ScaleFilter GetFilter() const { return filter_; }
+
+    // Тривалість останнього масштабування (мс)
+    double GetLastScaleTimeMs() const { return last_scale_ms_; }
+
+private:
+    enum class Output { BGRA, NV12, I420 };
+
+    // Робочі буфери однієї смуги: кільце H-масштабованих рядків джерела
+    // (рядок r - у слоті r % vtaps) та два рядки після V-змішування
+    struct StripeScratch {
+        std::vector<uint8_t> ring;
+        std::vector<int> ring_rows;
+        std::vector<uint8_t> blended;
+    };
+
+    bool Run(Output output, const uint8_t* src, int src_stride,
+             uint8_t* dst0, int dst0_stride, uint8_t* dst1, int dst1_stride,
+             uint8_t* dst2, int dst2_stride);
+
+    // Рядок y виходу (BGRA, dst_width_ пікселів): вказівник у кільце / джерело або blend_row
+    const uint8_t* ProduceRow(StripeScratch& scratch, const uint8_t* src, int src_stride,
+                              int y, uint8_t* blend_row) const;
+
+    int GetThreadCount() const;
+
+    WorkerPool* pool_ = nullptr;
+    ColorMatrix matrix_ = ColorMatrix::BT601;
+    ColorRange range_ = ColorRange::Limited;
+    ConvertKernel kernel_ = ConvertKernel::Auto;
+
+    int src_width_ = 0;
+    int src_height_ = 0;
+    int dst_width_ = 0;
+    int dst_height_ = 0;
+    ScaleFilter filter_ = ScaleFilter::Box;
+
+    ScaleTaps h_taps_;
+    ScaleTaps v_taps_;
+    HScaleRowFunc h_scale_ = nullptr;
+    VScaleRowFunc v_scale_ = nullptr;
+
+    std::vector<StripeScratch> scratch_;
+    double last_scale_ms_ = 0.0;
+};
+
+#endif // FRAME_SCALER_H
@@ -0,0 +1,120 @@
+/**
+ * Frame View
+ * Кадр без копіювання: вказівник, крок рядка (pitch), формат і прямокутник
+ * у кадрі джерела. Стадії читають пам'ять джерела напряму, без перепакування у width*4.
+ */
+
+#ifndef FRAME_VIEW_H
+#define FRAME_VIEW_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+enum class PixelFormat {
+    BGRA,       // Альфа 0xFF (DXGI, синтетичне джерело)
+    BGRX        // Четвертий байт не визначений (X11)
+};
+
+// Прямокутник у пікселях кадру виходу
+struct FrameRect {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    bool IsEmpty() const { return width <= 0 || height <= 0; }
+};
+
+// Регіон захоплення в межах виходу width x height: порожній - увесь вихід.
+// Сторони округлюються вниз до парних (chroma 2x2). false - регіон поза виходом.
+inline bool ResolveCaptureRegion(const FrameRect& region, int width, int height, FrameRect& resolved) {
+    if (region.IsEmpty()) {
+        resolved.x = 0;
+        resolved.y = 0;
+        resolved.width = width;
+        resolved.height = height;
+        return true;
+    }
+    if (region.x < 0 || region.y < 0 || region.width < 2 || region.height < 2 ||
+        region.x + region.width > width || region.y + region.height > height) {
+        return false;
+    }
+    resolved = region;
+    resolved.width &= ~1;
+    resolved.height &= ~1;
+    return true;
+}
+
+// Переміщення блоку між попереднім і поточним кадром (прокрутка, перетягування вікна):
+// прямокутник width x height з (src_x, src_y) попереднього кадру стає на (dst_x, dst_y)
+struct MoveRect {
+    int src_x = 0;
+    int src_y = 0;
+    int width = 0;
+    int height = 0;
+    int dst_x = 0;
+    int dst_y = 0;
+};
+
+// Обрізати переміщення так, щоб і джерело, і ціль були в кадрі width x height.
+// false - нічого не лишилося або зсуву немає.
+inline bool ClipMoveRect(MoveRect& move, int width, int height) {
+    const int left = std::max(0, std::max(-move.src_x, -move.dst_x));
+    const int top = std::max(0, std::max(-move.src_y, -move.dst_y));
+    const int right = std::min(move.width, std::min(width - move.src_x, width - move.dst_x));
+    const int bottom = std::min(move.height, std::min(height - move.src_y, height - move.dst_y));
+    if (left >= right || top >= bottom || (move.src_x == move.dst_x && move.src_y == move.dst_y)) {
+        return false;
+    }
+    move.src_x += left;
+    move.dst_x += left;
+    move.src_y += top;
+    move.dst_y += top;
+    move.width = right - left;
+    move.height = bottom - top;
+    return true;
+}
+
+struct FrameView {
+    const uint8_t* data = nullptr;  // Перший піксель view
+    int stride = 0;                 // Крок рядка пам'яті джерела (може бути > width * 4)
+    int width = 0;
+    int height = 0;
+    PixelFormat format = PixelFormat::BGRA;
+    FrameRect crop;                 // Положення view у кадрі виходу
+
+    const uint8_t* Row(int y) const { return data + (size_t)y * stride; }
+
+    // Під-прямокутник у координатах цього view (без перевірки меж)
+    FrameView Crop(const FrameRect& rect) const {
+        FrameView view = *this;
+        view.data = data + (size_t)rect.y * stride + (size_t)rect.x * 4;
+        view.width = rect.width;
+        view.height = rect.height;
+        view.crop.x = crop.x + rect.x;
+        view.crop.y = crop.y + rect.y;
+        view.crop.width = rect.width;
+        view.crop.height = rect.height;
+        return view;
+    }
+};
+
+// Скопіювати view у BGRA буфер; BGRX отримує альфу 0xFF, як кадр DXGI
+inline void CopyFrameView(const FrameView& view, uint8_t* dst, int dst_stride) {
+    const size_t row_bytes = (size_t)view.width * 4;
+    for (int y = 0; y < view.height; y++) {
+        uint8_t* out = dst + (size_t)y * dst_stride;
+        if (view.format == PixelFormat::BGRA) {
+            memcpy(out, view.Row(y), row_bytes);
+            continue;
+        }
+        const uint32_t* src = reinterpret_cast<const uint32_t*>(view.Row(y));
+        uint32_t* pixels = reinterpret_cast<uint32_t*>(out);
+        for (int x = 0; x < view.width; x++) {
+            pixels[x] = src[x] | 0xFF000000u;
+        }
+    }
+}
+
+#endif // FRAME_VIEW_H
@@ -0,0 +1,121 @@
+/**
+ * GOP Cache Implementation
+ */
+
+#include "gop-cache.h"
+#include <cstring>
+
+GopCache::GopCache(size_t max_bytes, int max_frames)
+    : max_bytes_(max_bytes), max_frames_(max_frames > 0 ? max_frames : 1) {
+}
+
+void GopCache::Add(const uint8_t* data, size_t size, const GopFrameInfo& info,
+                   const std::vector<uint8_t>* parameter_sets) {
+    if (!data || size == 0) {
+        return;
+    }
+
+    size_t prefix_size = (info.keyframe && parameter_sets) ? parameter_sets->size() : 0;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (info.keyframe) {
+        // Нова група - попередні кадри звільняться, коли JS відпустить свої посилання
+        // Група стає повною лише після того, як keyframe ляже в кеш
+        Drop();
+        complete_ = false;
+        gops_++;
+    } else if (!complete_) {
+        // Без keyframe на початку група не декодується - чекаємо наступного
+        return;
+    }
+
+    if (bytes_ + prefix_size + size > max_bytes_ ||
+        (int)frames_.size() + (prefix_size > 0 ? 2 : 1) > max_frames_) {
+        // Пам'ять обмежена: група, що не вміщається, не обслуговується зовсім
+        Drop();
+        complete_ = false;
+        overflows_++;
+        return;
+    }
+
+    if (prefix_size > 0) {
+        GopFrameInfo config;
+        config.codec = info.codec;
+        config.parameter_sets = true;
+        config.timestamp_ms = info.timestamp_ms;
+        auto frame = NewFrame(config, parameter_sets->data(), prefix_size);
+        if (!frame) {
+            Drop();
+            return;
+        }
+        Append(std::move(frame));
+    }
+
+    // Копія робиться під mutex: кадри стиснуті (десятки КБ), Add викликає лише потік кодування
+    auto frame = NewFrame(info, data, size);
+    if (!frame) {
+        // Група з пропуском не декодується - чекаємо наступного keyframe
+        Drop();
+        complete_ = false;
+        return;
+    }
+    Append(std::move(frame));
+    if (info.keyframe) {
+        complete_ = true;
+    }
+}
+
+std::shared_ptr<GopFrame> GopCache::NewFrame(const GopFrameInfo& info, const uint8_t* data, size_t size) {
+    std::shared_ptr<GopFrame> frame;
+    try {
+        frame = std::allocate_shared<GopFrame>(ArenaAllocator<GopFrame>());
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+    static_cast<GopFrameInfo&>(*frame) = info;
+    if (!frame->data.Resize(size)) {
+        return nullptr;
+    }
+    memcpy(frame->data.data(), data, size);
+    return frame;
+}
+
+void GopCache::Append(std::shared_ptr<GopFrame> frame) {
+    bytes_ += frame->data.size();
+    frames_.push_back(std::move(frame));
+}
+
+void GopCache::Drop() {
+    frames_.clear();
+    bytes_ = 0;
+}
+
+GopCache::Snapshot GopCache::GetSnapshot() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!complete_) {
+        return Snapshot();
+    }
+    replays_++;
+    return frames_;
+}
+
+void GopCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Drop();
+    complete_ = false;
+}
+
+GopCacheStats GopCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    GopCacheStats stats;
+    stats.frames = frames_.size();
+    stats.bytes = bytes_;
+    stats.max_bytes = max_bytes_;
+    stats.max_frames = max_frames_;
+    stats.complete = complete_;
+    stats.gops = gops_;
+    stats.overflows = overflows_;
+    stats.replays = replays_;
+    return stats;
+}
@@ -0,0 +1,79 @@
+/**
+ * GOP Cache
+ * Поточна група кадрів (останній keyframe + SPS/PPS + наступні кадри) для миттєвого
+ * старту глядачів, що підключаються посеред потоку: без перекодування і без копії на глядача.
+ * Кадри - спільні незмінні буфери (shared_ptr), JS отримує їх без копіювання.
+ */
+
+#ifndef GOP_CACHE_H
+#define GOP_CACHE_H
+
+#include "aligned-memory.h"
+#include "h264-parser.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct GopFrameInfo {
+    const char* codec = "h264";
+    bool keyframe = false;
+    bool parameter_sets = false;    // Лише SPS/PPS (IDR прийшов без них)
+    bool has_h264_info = false;
+    H264Packet h264;
+    double timestamp_ms = 0.0;
+};
+
+// Дані кадру і сам об'єкт (allocate_shared) - з BufferArena: після першої групи
+// кеш обертає ті самі блоки і не звертається до купи на кожен кадр
+struct GopFrame : GopFrameInfo {
+    AlignedBuffer data;
+};
+
+struct GopCacheStats {
+    size_t frames = 0;
+    size_t bytes = 0;
+    size_t max_bytes = 0;
+    int max_frames = 0;
+    bool complete = false;      // Кеш починається з keyframe і може обслужити глядача
+    uint64_t gops = 0;          // Почато груп (keyframe)
+    uint64_t overflows = 0;     // Група перевищила ліміт - кеш порожній до наступного keyframe
+    uint64_t replays = 0;
+};
+
+class GopCache {
+public:
+    typedef std::vector<std::shared_ptr<const GopFrame>> Snapshot;
+
+    GopCache(size_t max_bytes, int max_frames);
+
+    // Скопіювати закодований кадр у кеш (одна копія на кадр, не на глядача).
+    // parameter_sets - SPS/PPS для keyframe, який їх не містить (вставляються перед ним).
+    void Add(const uint8_t* data, size_t size, const GopFrameInfo& info,
+             const std::vector<uint8_t>* parameter_sets = nullptr);
+
+    // Кадри поточної групи в порядку декодування; порожньо, якщо група неповна
+    Snapshot GetSnapshot();
+
+    void Clear();
+    GopCacheStats GetStats() const;
+
+private:
+    std::shared_ptr<GopFrame> NewFrame(const GopFrameInfo& info, const uint8_t* data, size_t size);
+    void Append(std::shared_ptr<GopFrame> frame);
+    void Drop();
+
+    size_t max_bytes_;
+    int max_frames_;
+
+    mutable std::mutex mutex_;
+    Snapshot frames_;
+    size_t bytes_ = 0;
+    bool complete_ = false;
+    uint64_t gops_ = 0;
+    uint64_t overflows_ = 0;
+    uint64_t replays_ = 0;
+};
+
+#endif // GOP_CACHE_H
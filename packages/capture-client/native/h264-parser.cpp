@@ -0,0 +1,160 @@
+/**
+ * H.264 Annex-B Parser Implementation
+ */
+
+#include "h264-parser.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const uint8_t kStartCode[4] = { 0, 0, 0, 1 };
+
+void AppendWithStartCode(std::vector<uint8_t>& out, const std::vector<uint8_t>& nal) {
+    out.insert(out.end(), kStartCode, kStartCode + 4);
+    out.insert(out.end(), nal.begin(), nal.end());
+}
+
+} // namespace
+
+H264Parser::H264Parser() {
+}
+
+size_t H264Parser::FindStartCode(const uint8_t* data, size_t size, size_t pos) {
+    // memchr шукає байт 01 (векторизований у libc), потім перевіряються два нулі перед ним
+    size_t i = pos + 2;
+    while (i < size) {
+        const void* hit = memchr(data + i, 0x01, size - i);
+        if (!hit) {
+            break;
+        }
+        i = static_cast<const uint8_t*>(hit) - data;
+        if (data[i - 1] == 0 && data[i - 2] == 0) {
+            return i - 2;
+        }
+        i++;
+    }
+    return size;
+}
+
+bool H264Parser::Parse(const uint8_t* data, size_t size, H264Packet& packet) {
+    packet.nal_count = 0;
+    packet.truncated = false;
+    packet.keyframe = false;
+    packet.has_parameter_sets = false;
+
+    if (!data || size == 0 || size > UINT32_MAX) {
+        last_error_ = "Invalid H.264 buffer";
+        return false;
+    }
+
+    size_t pos = FindStartCode(data, size, 0);
+    if (pos == size) {
+        last_error_ = "No Annex-B start code";
+        return false;
+    }
+
+    bool has_sps = false;
+    bool has_pps = false;
+    while (pos < size) {
+        size_t nal_start = pos + 3;
+        size_t next = FindStartCode(data, size, nal_start);
+
+        // Нулі перед наступним start code - trailing_zero_8bits або перший байт 4-байтового коду
+        size_t nal_end = next;
+        while (nal_end > nal_start && data[nal_end - 1] == 0) {
+            nal_end--;
+        }
+
+        if (nal_end > nal_start) {
+            uint8_t header = data[nal_start];
+            if (header & 0x80) {
+                last_error_ = "Corrupt NAL header (forbidden_zero_bit)";
+                return false;
+            }
+
+            uint8_t type = header & 0x1F;
+            if (type == static_cast<uint8_t>(H264NalType::IdrSlice)) {
+                packet.keyframe = true;
+            } else if (type == static_cast<uint8_t>(H264NalType::Sps)) {
+                has_sps = true;
+                CacheParameterSet(sps_, data + nal_start, nal_end - nal_start);
+            } else if (type == static_cast<uint8_t>(H264NalType::Pps)) {
+                has_pps = true;
+                CacheParameterSet(pps_, data + nal_start, nal_end - nal_start);
+            }
+
+            if (packet.nal_count < H264Packet::kMaxNals) {
+                H264Nal& nal = packet.nals[packet.nal_count++];
+                nal.offset = (uint32_t)nal_start;
+                nal.size = (uint32_t)(nal_end - nal_start);
+                nal.type = type;
+            } else {
+                packet.truncated = true;
+            }
+        }
+        pos = next;
+    }
+
+    if (packet.nal_count == 0) {
+        last_error_ = "No NAL units in H.264 buffer";
+        return false;
+    }
+
+    packet.has_parameter_sets = has_sps && has_pps;
+    return true;
+}
+
+void H264Parser::CacheParameterSet(std::vector<uint8_t>& cache, const uint8_t* nal, size_t size) {
+    // SPS/PPS повторюються перед кожним IDR - здебільшого ті самі байти, без запису
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (cache.size() == size && memcmp(cache.data(), nal, size) == 0) {
+        return;
+    }
+    cache.assign(nal, nal + size);
+}
+
+void H264Parser::Reset() {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    sps_.clear();
+    pps_.clear();
+    last_error_.clear();
+}
+
+bool H264Parser::HasParameterSets() const {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    return !sps_.empty() && !pps_.empty();
+}
+
+std::vector<uint8_t> H264Parser::GetCodecConfig() const {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    std::vector<uint8_t> config;
+    if (sps_.empty() || pps_.empty()) {
+        return config;
+    }
+    config.reserve(sps_.size() + pps_.size() + 8);
+    AppendWithStartCode(config, sps_);
+    AppendWithStartCode(config, pps_);
+    return config;
+}
+
+std::vector<uint8_t> H264Parser::GetSps() const {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    return sps_;
+}
+
+std::vector<uint8_t> H264Parser::GetPps() const {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    return pps_;
+}
+
+std::string H264Parser::GetCodecString() const {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (sps_.size() < 4) {
+        return std::string();
+    }
+    // Байти 1..3 SPS: profile_idc, constraint_set flags, level_idc
+    char codec[16];
+    snprintf(codec, sizeof(codec), "avc1.%02x%02x%02x", sps_[1], sps_[2], sps_[3]);
+    return codec;
+}
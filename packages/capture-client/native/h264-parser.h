@@ -0,0 +1,78 @@
+/**
+ * H.264 Annex-B Parser
+ * Розбиття виходу енкодера на NAL одиниці без копіювання (зміщення в буфері кадру),
+ * позначка IDR кадрів і кеш останніх SPS/PPS для глядачів, що підключаються посеред потоку
+ */
+
+#ifndef H264_PARSER_H
+#define H264_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class H264NalType : uint8_t {
+    Slice = 1,
+    IdrSlice = 5,
+    Sei = 6,
+    Sps = 7,
+    Pps = 8,
+    AccessUnitDelimiter = 9
+};
+
+// NAL одиниця в буфері кадру: offset - перший байт заголовка NAL (після start code)
+struct H264Nal {
+    uint32_t offset = 0;
+    uint32_t size = 0;
+    uint8_t type = 0;
+};
+
+// Структурований пакет одного закодованого кадру
+struct H264Packet {
+    // Slice-потоки x264 / MFT дають кілька slice на кадр + SPS/PPS/SEI
+    static constexpr int kMaxNals = 32;
+
+    H264Nal nals[kMaxNals];
+    int nal_count = 0;
+    bool truncated = false;             // NAL більше за kMaxNals (keyframe все одно визначено)
+    bool keyframe = false;              // Є IDR slice
+    bool has_parameter_sets = false;    // Кадр містить SPS і PPS
+    int64_t pts = 0;                    // 90 кГц від першого кадру потоку
+};
+
+class H264Parser {
+public:
+    H264Parser();
+
+    // Розібрати Annex-B кадр. Буфер не копіюється - у пакеті лише зміщення.
+    bool Parse(const uint8_t* data, size_t size, H264Packet& packet);
+
+    // Новий потік (повторна ініціалізація енкодера)
+    void Reset();
+
+    // Кеш параметрів (потокобезпечно: кадри розбирає потік конвеєра, читає JS потік)
+    bool HasParameterSets() const;
+    // SPS і PPS з start codes - префікс для декодера глядача
+    std::vector<uint8_t> GetCodecConfig() const;
+    std::vector<uint8_t> GetSps() const;
+    std::vector<uint8_t> GetPps() const;
+    // Рядок кодека для WebCodecs / MSE: "avc1.PPCCLL" з profile_idc, constraint flags, level_idc
+    std::string GetCodecString() const;
+
+    std::string GetLastError() const { return last_error_; }
+
+    // Позиція наступного start code (00 00 01) починаючи з pos; size, якщо немає
+    static size_t FindStartCode(const uint8_t* data, size_t size, size_t pos);
+
+private:
+    void CacheParameterSet(std::vector<uint8_t>& cache, const uint8_t* nal, size_t size);
+
+    mutable std::mutex cache_mutex_;
+    std::vector<uint8_t> sps_;      // Без start code
+    std::vector<uint8_t> pps_;
+    std::string last_error_;
+};
+
+#endif // H264_PARSER_H
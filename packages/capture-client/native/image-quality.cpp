@@ -0,0 +1,327 @@
+/**
+ * Image Quality Metrics Implementation
+ */
+
+#include "image-quality.h"
+#include "cpu-features.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Стандартні константи SSIM для 8-бітних значень
+constexpr double kSsimC1 = (0.01 * 255) * (0.01 * 255);
+constexpr double kSsimC2 = (0.03 * 255) * (0.03 * 255);
+
+// Після стількох векторів 32-бітні суми переносяться в 64-бітні: за крок лінія
+// отримує не більше 2 * 2 * 255^2, тож 4096 кроків далеко від переповнення
+constexpr size_t kFlushVectors = 4096;
+
+double ToPsnr(double mse) {
+    if (mse <= 0.0) {
+        return QualityMeter::kMaxPsnr;
+    }
+    return std::min(QualityMeter::kMaxPsnr, 10.0 * std::log10(255.0 * 255.0 / mse));
+}
+
+// ============================================================
+// Scalar еталон
+// ============================================================
+
+uint64_t SquaredErrorScalarFrom(size_t i, const uint8_t* a, const uint8_t* b, size_t count, uint32_t mask) {
+    uint64_t sum = 0;
+    for (; i < count; i++) {
+        if ((mask >> ((i & 3) * 8)) & 0xFF) {
+            const int d = (int)a[i] - (int)b[i];
+            sum += (uint64_t)(d * d);
+        }
+    }
+    return sum;
+}
+
+uint64_t SquaredErrorScalar(const uint8_t* a, const uint8_t* b, size_t count, uint32_t mask) {
+    return SquaredErrorScalarFrom(0, a, b, count, mask);
+}
+
+void SsimSumsScalar(const uint8_t* a, int a_stride, const uint8_t* b, int b_stride, uint32_t sums[5]) {
+    uint32_t sa = 0, sb = 0, saa = 0, sbb = 0, sab = 0;
+    for (int y = 0; y < QualityMeter::kSsimWindow; y++) {
+        const uint8_t* ra = a + (size_t)y * a_stride;
+        const uint8_t* rb = b + (size_t)y * b_stride;
+        for (int x = 0; x < QualityMeter::kSsimWindow; x++) {
+            sa += ra[x];
+            sb += rb[x];
+            saa += (uint32_t)ra[x] * ra[x];
+            sbb += (uint32_t)rb[x] * rb[x];
+            sab += (uint32_t)ra[x] * rb[x];
+        }
+    }
+    sums[0] = sa;
+    sums[1] = sb;
+    sums[2] = saa;
+    sums[3] = sbb;
+    sums[4] = sab;
+}
+
+#ifdef NATIVE_ARCH_X86
+
+// ============================================================
+// SSE2
+// ============================================================
+
+NATIVE_TARGET_SSE2
+inline uint64_t HorizontalSum64SSE2(__m128i v) {
+    // Через пам'ять - _mm_cvtsi128_si64 немає на 32-бітному x86
+    alignas(16) uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), v);
+    return lanes[0] + lanes[1];
+}
+
+NATIVE_TARGET_SSE2
+inline uint32_t HorizontalSum32SSE2(__m128i v) {
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (uint32_t)_mm_cvtsi128_si32(v);
+}
+
+// |a - b| через насичені віднімання, квадрати й попарні суми - _mm_madd_epi16
+NATIVE_TARGET_SSE2
+uint64_t SquaredErrorSSE2(const uint8_t* a, const uint8_t* b, size_t count, uint32_t mask) {
+    const __m128i byte_mask = _mm_set1_epi32((int)mask);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i total = _mm_setzero_si128();
+    size_t i = 0;
+
+    while (i + 16 <= count) {
+        const size_t end = std::min(count & ~(size_t)15, i + kFlushVectors * 16);
+        __m128i acc = _mm_setzero_si128();
+        for (; i < end; i += 16) {
+            const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            const __m128i d = _mm_and_si128(_mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va)),
+                                            byte_mask);
+            const __m128i lo = _mm_unpacklo_epi8(d, zero);
+            const __m128i hi = _mm_unpackhi_epi8(d, zero);
+            acc = _mm_add_epi32(acc, _mm_add_epi32(_mm_madd_epi16(lo, lo), _mm_madd_epi16(hi, hi)));
+        }
+        total = _mm_add_epi64(total, _mm_add_epi64(_mm_unpacklo_epi32(acc, zero), _mm_unpackhi_epi32(acc, zero)));
+    }
+    return HorizontalSum64SSE2(total) + SquaredErrorScalarFrom(i, a, b, count, mask);
+}
+
+// Рядок вікна - 8 пікселів, одразу розширених до 16 біт
+NATIVE_TARGET_SSE2
+void SsimSumsSSE2(const uint8_t* a, int a_stride, const uint8_t* b, int b_stride, uint32_t sums[5]) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i sa = _mm_setzero_si128();
+    __m128i sb = _mm_setzero_si128();
+    __m128i saa = _mm_setzero_si128();
+    __m128i sbb = _mm_setzero_si128();
+    __m128i sab = _mm_setzero_si128();
+
+    for (int y = 0; y < QualityMeter::kSsimWindow; y++) {
+        const __m128i va = _mm_unpacklo_epi8(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a + (size_t)y * a_stride)), zero);
+        const __m128i vb = _mm_unpacklo_epi8(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b + (size_t)y * b_stride)), zero);
+        sa = _mm_add_epi16(sa, va);
+        sb = _mm_add_epi16(sb, vb);
+        saa = _mm_add_epi32(saa, _mm_madd_epi16(va, va));
+        sbb = _mm_add_epi32(sbb, _mm_madd_epi16(vb, vb));
+        sab = _mm_add_epi32(sab, _mm_madd_epi16(va, vb));
+    }
+    sums[0] = HorizontalSum32SSE2(_mm_madd_epi16(sa, ones));
+    sums[1] = HorizontalSum32SSE2(_mm_madd_epi16(sb, ones));
+    sums[2] = HorizontalSum32SSE2(saa);
+    sums[3] = HorizontalSum32SSE2(sbb);
+    sums[4] = HorizontalSum32SSE2(sab);
+}
+
+// ============================================================
+// AVX2
+// ============================================================
+
+NATIVE_TARGET_AVX2
+inline uint32_t HorizontalSum32AVX2(__m256i v) {
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (uint32_t)_mm_cvtsi128_si32(s);
+}
+
+NATIVE_TARGET_AVX2
+uint64_t SquaredErrorAVX2(const uint8_t* a, const uint8_t* b, size_t count, uint32_t mask) {
+    const __m256i byte_mask = _mm256_set1_epi32((int)mask);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+
+    while (i + 32 <= count) {
+        const size_t end = std::min(count & ~(size_t)31, i + kFlushVectors * 32);
+        __m256i acc = _mm256_setzero_si256();
+        for (; i < end; i += 32) {
+            const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            const __m256i d = _mm256_and_si256(
+                _mm256_or_si256(_mm256_subs_epu8(va, vb), _mm256_subs_epu8(vb, va)), byte_mask);
+            const __m256i lo = _mm256_unpacklo_epi8(d, zero);
+            const __m256i hi = _mm256_unpackhi_epi8(d, zero);
+            acc = _mm256_add_epi32(acc, _mm256_add_epi32(_mm256_madd_epi16(lo, lo), _mm256_madd_epi16(hi, hi)));
+        }
+        total = _mm256_add_epi64(total, _mm256_add_epi64(_mm256_unpacklo_epi32(acc, zero),
+                                                         _mm256_unpackhi_epi32(acc, zero)));
+    }
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + SquaredErrorScalarFrom(i, a, b, count, mask);
+}
+
+// Два рядки вікна в одному регістрі
+NATIVE_TARGET_AVX2
+void SsimSumsAVX2(const uint8_t* a, int a_stride, const uint8_t* b, int b_stride, uint32_t sums[5]) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sa = _mm256_setzero_si256();
+    __m256i sb = _mm256_setzero_si256();
+    __m256i saa = _mm256_setzero_si256();
+    __m256i sbb = _mm256_setzero_si256();
+    __m256i sab = _mm256_setzero_si256();
+
+    for (int y = 0; y < QualityMeter::kSsimWindow; y += 2) {
+        const uint8_t* ra = a + (size_t)y * a_stride;
+        const uint8_t* rb = b + (size_t)y * b_stride;
+        const __m256i va = _mm256_cvtepu8_epi16(_mm_unpacklo_epi64(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(ra)),
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(ra + a_stride))));
+        const __m256i vb = _mm256_cvtepu8_epi16(_mm_unpacklo_epi64(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(rb)),
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(rb + b_stride))));
+        sa = _mm256_add_epi16(sa, va);
+        sb = _mm256_add_epi16(sb, vb);
+        saa = _mm256_add_epi32(saa, _mm256_madd_epi16(va, va));
+        sbb = _mm256_add_epi32(sbb, _mm256_madd_epi16(vb, vb));
+        sab = _mm256_add_epi32(sab, _mm256_madd_epi16(va, vb));
+    }
+    sums[0] = HorizontalSum32AVX2(_mm256_madd_epi16(sa, ones));
+    sums[1] = HorizontalSum32AVX2(_mm256_madd_epi16(sb, ones));
+    sums[2] = HorizontalSum32AVX2(saa);
+    sums[3] = HorizontalSum32AVX2(sbb);
+    sums[4] = HorizontalSum32AVX2(sab);
+}
+
+#endif // NATIVE_ARCH_X86
+
+} // namespace
+
+SquaredErrorFunc GetSquaredErrorFunc(ConvertKernel kernel) {
+    if (kernel == ConvertKernel::Auto) {
+        kernel = GetBestConvertKernel();
+    }
+    if (!IsConvertKernelSupported(kernel)) {
+        return nullptr;
+    }
+#ifdef NATIVE_ARCH_X86
+    if (kernel == ConvertKernel::AVX2) {
+        return &SquaredErrorAVX2;
+    }
+    if (kernel == ConvertKernel::SSE2) {
+        return &SquaredErrorSSE2;
+    }
+#endif
+    return &SquaredErrorScalar;
+}
+
+SsimSumsFunc GetSsimSumsFunc(ConvertKernel kernel) {
+    if (kernel == ConvertKernel::Auto) {
+        kernel = GetBestConvertKernel();
+    }
+    if (!IsConvertKernelSupported(kernel)) {
+        return nullptr;
+    }
+#ifdef NATIVE_ARCH_X86
+    if (kernel == ConvertKernel::AVX2) {
+        return &SsimSumsAVX2;
+    }
+    if (kernel == ConvertKernel::SSE2) {
+        return &SsimSumsSSE2;
+    }
+#endif
+    return &SsimSumsScalar;
+}
+
+QualityMeter::QualityMeter(ConvertKernel kernel)
+    : kernel_(kernel),
+      squared_error_(GetSquaredErrorFunc(kernel)),
+      ssim_sums_(GetSsimSumsFunc(kernel)) {
+}
+
+bool QualityMeter::ComputeLuma(const uint8_t* bgra, int stride, int width, int height,
+                               std::vector<uint8_t>& luma) {
+    const int chroma_width = (width + 1) / 2;
+    const size_t chroma_size = (size_t)chroma_width * ((height + 1) / 2);
+    luma.resize((size_t)width * height);
+    chroma_.resize(chroma_size * 2);
+    return ConvertBGRAToI420(bgra, stride, width, height,
+                             luma.data(), width,
+                             chroma_.data(), chroma_width,
+                             chroma_.data() + chroma_size, chroma_width,
+                             ColorMatrix::BT601, ColorRange::Full, kernel_);
+}
+
+bool QualityMeter::Measure(const uint8_t* reference, int reference_stride, const uint8_t* test, int test_stride,
+                           int width, int height, QualityScores& scores) {
+    scores = QualityScores();
+    if (!squared_error_ || !ssim_sums_ || !reference || !test || width <= 0 || height <= 0 ||
+        reference_stride < width * 4 || test_stride < width * 4) {
+        return false;
+    }
+
+    uint64_t error = 0;
+    for (int y = 0; y < height; y++) {
+        error += squared_error_(reference + (size_t)y * reference_stride, test + (size_t)y * test_stride,
+                                (size_t)width * 4, 0x00FFFFFF);
+    }
+    scores.mse = (double)error / ((double)width * height * 3);
+    scores.psnr = ToPsnr(scores.mse);
+
+    if (!ComputeLuma(reference, reference_stride, width, height, reference_luma_) ||
+        !ComputeLuma(test, test_stride, width, height, test_luma_)) {
+        return false;
+    }
+    const uint64_t luma_error = squared_error_(reference_luma_.data(), test_luma_.data(),
+                                               reference_luma_.size(), 0xFFFFFFFF);
+    scores.psnr_y = ToPsnr((double)luma_error / ((double)width * height));
+
+    // Кадр, менший за вікно, - лише PSNR
+    if (width < kSsimWindow || height < kSsimWindow) {
+        scores.ssim = scores.mse > 0.0 ? 0.0 : 1.0;
+        scores.min_ssim = scores.ssim;
+        return true;
+    }
+
+    const double n = kSsimWindow * kSsimWindow;
+    double total = 0.0;
+    double worst = 1.0;
+    int windows = 0;
+    uint32_t sums[5];
+    for (int y = 0; y + kSsimWindow <= height; y += kSsimStep) {
+        for (int x = 0; x + kSsimWindow <= width; x += kSsimStep) {
+            const size_t offset = (size_t)y * width + x;
+            ssim_sums_(reference_luma_.data() + offset, width, test_luma_.data() + offset, width, sums);
+
+            const double mean_a = sums[0] / n;
+            const double mean_b = sums[1] / n;
+            const double var_a = sums[2] / n - mean_a * mean_a;
+            const double var_b = sums[3] / n - mean_b * mean_b;
+            const double cov = sums[4] / n - mean_a * mean_b;
+            const double ssim = ((2.0 * mean_a * mean_b + kSsimC1) * (2.0 * cov + kSsimC2)) /
+                                ((mean_a * mean_a + mean_b * mean_b + kSsimC1) * (var_a + var_b + kSsimC2));
+            total += ssim;
+            worst = std::min(worst, ssim);
+            windows++;
+        }
+    }
+    scores.ssim = total / windows;
+    scores.min_ssim = worst;
+    return true;
+}
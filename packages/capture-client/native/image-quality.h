@@ -0,0 +1,58 @@
+/**
+ * Image Quality Metrics
+ * PSNR і SSIM між еталонним і декодованим кадром (scalar/SSE2/AVX2 ядра, біт-в-біт
+ * однакові суми) - для підбору якості кодеків і регресій ядер конвертації/масштабу
+ */
+
+#ifndef IMAGE_QUALITY_H
+#define IMAGE_QUALITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "color-convert.h"
+
+// Сума квадратів різниць count байт. mask - які байти кожної четвірки враховуються
+// (0x00FFFFFF - BGRA без альфи, 0xFFFFFFFF - площина). a і b починаються з четвірки.
+typedef uint64_t (*SquaredErrorFunc)(const uint8_t* a, const uint8_t* b, size_t count, uint32_t mask);
+
+// Суми вікна 8x8 двох площин: sums = {a, b, a*a, b*b, a*b}
+typedef void (*SsimSumsFunc)(const uint8_t* a, int a_stride, const uint8_t* b, int b_stride,
+                             uint32_t sums[5]);
+
+// nullptr, якщо ядро не підтримується процесором
+SquaredErrorFunc GetSquaredErrorFunc(ConvertKernel kernel = ConvertKernel::Auto);
+SsimSumsFunc GetSsimSumsFunc(ConvertKernel kernel = ConvertKernel::Auto);
+
+struct QualityScores {
+    double mse = 0.0;               // B, G, R разом
+    double psnr = 0.0;              // дБ, однакові кадри - QualityMeter::kMaxPsnr
+    double psnr_y = 0.0;            // Яскравість (BT.601, повний діапазон)
+    double ssim = 0.0;              // Яскравість, середнє вікон 8x8 з кроком 4
+    double min_ssim = 0.0;          // Найгірше вікно - локальні артефакти (текст, межі плиток)
+};
+
+// Метрики BGRA кадрів однакового розміру. Буфери яскравості живуть між викликами.
+class QualityMeter {
+public:
+    static constexpr double kMaxPsnr = 100.0;
+    static constexpr int kSsimWindow = 8;
+    static constexpr int kSsimStep = 4;
+
+    explicit QualityMeter(ConvertKernel kernel = ConvertKernel::Auto);
+
+    bool Measure(const uint8_t* reference, int reference_stride, const uint8_t* test, int test_stride,
+                 int width, int height, QualityScores& scores);
+
+private:
+    bool ComputeLuma(const uint8_t* bgra, int stride, int width, int height, std::vector<uint8_t>& luma);
+
+    ConvertKernel kernel_;
+    SquaredErrorFunc squared_error_ = nullptr;
+    SsimSumsFunc ssim_sums_ = nullptr;
+    std::vector<uint8_t> reference_luma_;
+    std::vector<uint8_t> test_luma_;
+    std::vector<uint8_t> chroma_;   // U, V конвертації - не використовуються
+};
+
+#endif // IMAGE_QUALITY_H
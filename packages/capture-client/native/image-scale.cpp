@@ -0,0 +1,289 @@
+/**
+ * BGRA Image Scaling Kernels Implementation
+ */
+
+#include "image-scale.h"
+#include "cpu-features.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr int kWeightOne = 1 << kScaleWeightBits;
+constexpr int kWeightRound = 1 << (kScaleWeightBits - 1);
+
+struct Contribution {
+    int index;
+    double weight;
+};
+
+// Відліки однієї вихідної координати (ваги ще не нормалізовані)
+void CollectBox(int i, double scale, int src_size, std::vector<Contribution>& out) {
+    // Вихідний піксель покриває [i * scale, (i + 1) * scale) джерела
+    double begin = i * scale;
+    double end = std::min((i + 1) * scale, (double)src_size);
+    int first = (int)std::floor(begin);
+    int last = std::min((int)std::ceil(end) - 1, src_size - 1);
+    for (int s = first; s <= last; s++) {
+        double overlap = std::min(end, (double)s + 1.0) - std::max(begin, (double)s);
+        if (overlap > 1e-9) {
+            out.push_back({ s, overlap });
+        }
+    }
+}
+
+void CollectBilinear(int i, double scale, int src_size, std::vector<Contribution>& out) {
+    // Центри пікселів збігаються: (i + 0.5) * scale - 0.5
+    double center = (i + 0.5) * scale - 0.5;
+    center = std::max(0.0, std::min(center, (double)(src_size - 1)));
+    int s0 = (int)std::floor(center);
+    double frac = center - s0;
+    out.push_back({ s0, 1.0 - frac });
+    if (s0 + 1 < src_size && frac > 1e-9) {
+        out.push_back({ s0 + 1, frac });
+    }
+}
+
+// ============================================================
+// Scalar еталон
+// ============================================================
+
+void HScaleRowScalar(const uint8_t* src, int dst_width, const ScaleTaps& taps, uint8_t* dst) {
+    const int n = taps.taps;
+    for (int x = 0; x < dst_width; x++) {
+        const uint8_t* p = src + (size_t)taps.start[x] * 4;
+        const int16_t* w = &taps.weights[(size_t)x * n];
+        int b = kWeightRound, g = kWeightRound, r = kWeightRound, a = kWeightRound;
+        for (int k = 0; k < n; k++) {
+            b += p[k * 4 + 0] * w[k];
+            g += p[k * 4 + 1] * w[k];
+            r += p[k * 4 + 2] * w[k];
+            a += p[k * 4 + 3] * w[k];
+        }
+        dst[x * 4 + 0] = (uint8_t)(b >> kScaleWeightBits);
+        dst[x * 4 + 1] = (uint8_t)(g >> kScaleWeightBits);
+        dst[x * 4 + 2] = (uint8_t)(r >> kScaleWeightBits);
+        dst[x * 4 + 3] = (uint8_t)(a >> kScaleWeightBits);
+    }
+}
+
+void VScaleRowScalarFrom(int i, const uint8_t* const* rows, const int16_t* weights, int taps,
+                         int bytes, uint8_t* dst) {
+    for (; i < bytes; i++) {
+        int sum = kWeightRound;
+        for (int k = 0; k < taps; k++) {
+            sum += rows[k][i] * weights[k];
+        }
+        dst[i] = (uint8_t)(sum >> kScaleWeightBits);
+    }
+}
+
+void VScaleRowScalar(const uint8_t* const* rows, const int16_t* weights, int taps,
+                     int bytes, uint8_t* dst) {
+    VScaleRowScalarFrom(0, rows, weights, taps, bytes, dst);
+}
+
+#ifdef NATIVE_ARCH_X86
+
+// ============================================================
+// SSE2
+// ============================================================
+
+// Пара ваг (w0, w1) у кожній 32-бітній лінії для madd
+NATIVE_TARGET_SSE2
+inline __m128i WeightPair_SSE2(const int16_t* w) {
+    return _mm_set1_epi32((int)(uint16_t)w[0] | ((int)(uint16_t)w[1] << 16));
+}
+
+// Один вихідний піксель за ітерацію: пари пікселів джерела (B0 B1 G0 G1 R0 R1 A0 A1) x (w0 w1)
+NATIVE_TARGET_SSE2
+void HScaleRowSSE2(const uint8_t* src, int dst_width, const ScaleTaps& taps, uint8_t* dst) {
+    const int n = taps.taps;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32(kWeightRound);
+
+    for (int x = 0; x < dst_width; x++) {
+        const uint8_t* p = src + (size_t)taps.start[x] * 4;
+        const int16_t* w = &taps.weights[(size_t)x * n];
+        __m128i acc = round;
+        for (int k = 0; k < n; k += 2) {
+            __m128i px = _mm_unpacklo_epi8(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + k * 4)), zero);
+            px = _mm_unpacklo_epi16(px, _mm_srli_si128(px, 8));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(px, WeightPair_SSE2(w + k)));
+        }
+        acc = _mm_srai_epi32(acc, kScaleWeightBits);
+        acc = _mm_packus_epi16(_mm_packs_epi32(acc, acc), zero);
+        int value = _mm_cvtsi128_si32(acc);
+        memcpy(dst + x * 4, &value, 4);
+    }
+}
+
+// 16 байт за ітерацію: рядки попарно чергуються по 16 біт і множаться на пару ваг
+NATIVE_TARGET_SSE2
+void VScaleRowSSE2(const uint8_t* const* rows, const int16_t* weights, int taps,
+                   int bytes, uint8_t* dst) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32(kWeightRound);
+
+    int i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i acc0 = round, acc1 = round, acc2 = round, acc3 = round;
+        for (int k = 0; k < taps; k += 2) {
+            __m128i w = WeightPair_SSE2(weights + k);
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k] + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k + 1] + i));
+            __m128i a_lo = _mm_unpacklo_epi8(a, zero), a_hi = _mm_unpackhi_epi8(a, zero);
+            __m128i b_lo = _mm_unpacklo_epi8(b, zero), b_hi = _mm_unpackhi_epi8(b, zero);
+            acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(_mm_unpacklo_epi16(a_lo, b_lo), w));
+            acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(_mm_unpackhi_epi16(a_lo, b_lo), w));
+            acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(_mm_unpacklo_epi16(a_hi, b_hi), w));
+            acc3 = _mm_add_epi32(acc3, _mm_madd_epi16(_mm_unpackhi_epi16(a_hi, b_hi), w));
+        }
+        __m128i lo = _mm_packs_epi32(_mm_srai_epi32(acc0, kScaleWeightBits),
+                                     _mm_srai_epi32(acc1, kScaleWeightBits));
+        __m128i hi = _mm_packs_epi32(_mm_srai_epi32(acc2, kScaleWeightBits),
+                                     _mm_srai_epi32(acc3, kScaleWeightBits));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+
+    VScaleRowScalarFrom(i, rows, weights, taps, bytes, dst);
+}
+
+// ============================================================
+// AVX2 (вертикальний прохід; горизонтальний - SSE2, один піксель не заповнює 256 біт)
+// ============================================================
+
+// unpack і pack працюють у межах 128-бітних половин однаково, тому порядок байтів зберігається
+NATIVE_TARGET_AVX2
+void VScaleRowAVX2(const uint8_t* const* rows, const int16_t* weights, int taps,
+                   int bytes, uint8_t* dst) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i round = _mm256_set1_epi32(kWeightRound);
+
+    int i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        __m256i acc0 = round, acc1 = round, acc2 = round, acc3 = round;
+        for (int k = 0; k < taps; k += 2) {
+            __m256i w = _mm256_set1_epi32((int)(uint16_t)weights[k] |
+                                          ((int)(uint16_t)weights[k + 1] << 16));
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows[k] + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows[k + 1] + i));
+            __m256i a_lo = _mm256_unpacklo_epi8(a, zero), a_hi = _mm256_unpackhi_epi8(a, zero);
+            __m256i b_lo = _mm256_unpacklo_epi8(b, zero), b_hi = _mm256_unpackhi_epi8(b, zero);
+            acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(_mm256_unpacklo_epi16(a_lo, b_lo), w));
+            acc1 = _mm256_add_epi32(acc1, _mm256_madd_epi16(_mm256_unpackhi_epi16(a_lo, b_lo), w));
+            acc2 = _mm256_add_epi32(acc2, _mm256_madd_epi16(_mm256_unpacklo_epi16(a_hi, b_hi), w));
+            acc3 = _mm256_add_epi32(acc3, _mm256_madd_epi16(_mm256_unpackhi_epi16(a_hi, b_hi), w));
+        }
+        __m256i lo = _mm256_packs_epi32(_mm256_srai_epi32(acc0, kScaleWeightBits),
+                                        _mm256_srai_epi32(acc1, kScaleWeightBits));
+        __m256i hi = _mm256_packs_epi32(_mm256_srai_epi32(acc2, kScaleWeightBits),
+                                        _mm256_srai_epi32(acc3, kScaleWeightBits));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+    }
+
+    VScaleRowScalarFrom(i, rows, weights, taps, bytes, dst);
+}
+
+#endif // NATIVE_ARCH_X86
+
+} // namespace
+
+bool ParseScaleFilter(const std::string& name, ScaleFilter& filter) {
+    if (name == "box") {
+        filter = ScaleFilter::Box;
+    } else if (name == "bilinear") {
+        filter = ScaleFilter::Bilinear;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* GetScaleFilterName(ScaleFilter filter) {
+    return filter == ScaleFilter::Box ? "box" : "bilinear";
+}
+
+bool ComputeScaleTaps(int src_size, int dst_size, ScaleFilter filter, ScaleTaps& taps) {
+    if (src_size < 2 || dst_size <= 0) {
+        return false;
+    }
+
+    const double scale = (double)src_size / dst_size;
+    std::vector<std::vector<Contribution>> all(dst_size);
+    int max_taps = 0;
+    for (int i = 0; i < dst_size; i++) {
+        if (filter == ScaleFilter::Box) {
+            CollectBox(i, scale, src_size, all[i]);
+        } else {
+            CollectBilinear(i, scale, src_size, all[i]);
+        }
+        max_taps = std::max(max_taps, (int)all[i].size());
+    }
+
+    // Парна кількість відліків; вікно зсувається всередину джерела
+    taps.taps = std::min((max_taps + 1) & ~1, src_size & ~1);
+    taps.start.assign(dst_size, 0);
+    taps.weights.assign((size_t)dst_size * taps.taps, 0);
+
+    for (int i = 0; i < dst_size; i++) {
+        const std::vector<Contribution>& c = all[i];
+        int start = std::min(c.front().index, src_size - taps.taps);
+        taps.start[i] = start;
+
+        double total = 0.0;
+        for (const Contribution& item : c) {
+            total += item.weight;
+        }
+
+        // Округлені ваги; залишок до 1.0 додається до найбільшої, щоб яскравість не зсувалась
+        int16_t* w = &taps.weights[(size_t)i * taps.taps];
+        int sum = 0;
+        int largest = 0;
+        for (const Contribution& item : c) {
+            int k = item.index - start;
+            w[k] = (int16_t)std::lround(item.weight / total * kWeightOne);
+            sum += w[k];
+            if (w[k] > w[largest]) {
+                largest = k;
+            }
+        }
+        w[largest] = (int16_t)(w[largest] + (kWeightOne - sum));
+    }
+    return true;
+}
+
+HScaleRowFunc GetHScaleRowFunc(ConvertKernel kernel) {
+    if (kernel == ConvertKernel::Auto) {
+        kernel = GetBestConvertKernel();
+    }
+    if (!IsConvertKernelSupported(kernel)) {
+        return nullptr;
+    }
+#ifdef NATIVE_ARCH_X86
+    if (kernel == ConvertKernel::SSE2 || kernel == ConvertKernel::AVX2) {
+        return &HScaleRowSSE2;
+    }
+#endif
+    return &HScaleRowScalar;
+}
+
+VScaleRowFunc GetVScaleRowFunc(ConvertKernel kernel) {
+    if (kernel == ConvertKernel::Auto) {
+        kernel = GetBestConvertKernel();
+    }
+    if (!IsConvertKernelSupported(kernel)) {
+        return nullptr;
+    }
+#ifdef NATIVE_ARCH_X86
+    if (kernel == ConvertKernel::AVX2) {
+        return &VScaleRowAVX2;
+    }
+    if (kernel == ConvertKernel::SSE2) {
+        return &VScaleRowSSE2;
+    }
+#endif
+    return &VScaleRowScalar;
+}
@@ -0,0 +1,49 @@
+/**
+ * BGRA Image Scaling Kernels
+ * Роздільний фільтр з фіксованою точкою (box / bilinear, будь-яке співвідношення):
+ * горизонтальний прохід по рядку джерела + вертикальне змішування рядків.
+ * Ядра scalar (еталон), SSE2, AVX2 дають біт-в-біт однаковий результат.
+ */
+
+#ifndef IMAGE_SCALE_H
+#define IMAGE_SCALE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "color-convert.h"
+
+enum class ScaleFilter {
+    Box,        // Усереднення площі (зменшення без аліасингу, чіткий текст)
+    Bilinear    // 2 відліки на вісь (дешевше, для зменшення до ~2x)
+};
+
+bool ParseScaleFilter(const std::string& name, ScaleFilter& filter);
+const char* GetScaleFilterName(ScaleFilter filter);
+
+// Ваги з 14-бітною дробовою частиною, сума ваг кожного відліку = 1 << kScaleWeightBits.
+// Піксель (<= 255) * вага вміщається в int32 разом із сумою по всіх відліках.
+constexpr int kScaleWeightBits = 14;
+
+// Відліки по одній осі: для вихідної координати i беруться джерела
+// [start[i], start[i] + taps) з вагами weights[i * taps + k]
+struct ScaleTaps {
+    int taps = 0;                   // Завжди парне (SIMD ядра беруть пари)
+    std::vector<int> start;
+    std::vector<int16_t> weights;
+};
+
+// src_size >= 2 (вікно з парною кількістю відліків не виходить за межі джерела)
+bool ComputeScaleTaps(int src_size, int dst_size, ScaleFilter filter, ScaleTaps& taps);
+
+// Горизонтальний прохід: рядок BGRA джерела -> dst_width пікселів
+typedef void (*HScaleRowFunc)(const uint8_t* src, int dst_width, const ScaleTaps& taps,
+                              uint8_t* dst);
+// Вертикальний прохід: зважена сума taps рядків (bytes байт кожен)
+typedef void (*VScaleRowFunc)(const uint8_t* const* rows, const int16_t* weights, int taps,
+                              int bytes, uint8_t* dst);
+
+HScaleRowFunc GetHScaleRowFunc(ConvertKernel kernel = ConvertKernel::Auto);
+VScaleRowFunc GetVScaleRowFunc(ConvertKernel kernel = ConvertKernel::Auto);
+
+#endif // IMAGE_SCALE_H
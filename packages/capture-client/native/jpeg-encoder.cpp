@@ -0,0 +1,366 @@
+/**
+ * JPEG Encoder Implementation (libjpeg-turbo)
+ */
+
+#include "jpeg-encoder.h"
+#include "worker-pool.h"
+#include <algorithm>
+#include <chrono>
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+#include <jpeglib.h>
+#include <jerror.h>
+
+#if !defined(JCS_EXTENSIONS)
+#error "libjpeg-turbo (JCS_EXT_BGRA) is required"
+#endif
+
+// Стан одного компресора: libjpeg об'єкт + призначення в пам'ять
+struct JpegStripeContext {
+    struct ErrorManager {
+        jpeg_error_mgr pub;
+        jmp_buf jump;
+        char message[JMSG_LENGTH_MAX];
+    };
+
+    jpeg_compress_struct cinfo;
+    ErrorManager error;
+    jpeg_destination_mgr dest;
+    bool created = false;
+
+    int first_row = 0;
+    int rows = 0;
+    // Результат останнього CompressRows - пишеться лише своїм потоком пулу
+    bool ok = false;
+
+    // Призначення: зовнішній буфер фіксованого розміру або власний, що росте
+    uint8_t* out = nullptr;
+    size_t capacity = 0;
+    size_t size = 0;
+    bool growable = false;
+    std::vector<uint8_t> scratch;
+};
+
+namespace {
+
+constexpr int kRowBatch = 16;
+
+void OnJpegError(j_common_ptr cinfo) {
+    auto* error = reinterpret_cast<JpegStripeContext::ErrorManager*>(cinfo->err);
+    (*cinfo->err->format_message)(cinfo, error->message);
+    longjmp(error->jump, 1);
+}
+
+void OnJpegMessage(j_common_ptr) {
+    // Попередження libjpeg не виводяться в stderr
+}
+
+JpegStripeContext* GetContext(j_compress_ptr cinfo) {
+    return static_cast<JpegStripeContext*>(cinfo->client_data);
+}
+
+void InitDestination(j_compress_ptr cinfo) {
+    JpegStripeContext* ctx = GetContext(cinfo);
+    if (ctx->growable) {
+        if (ctx->scratch.empty()) {
+            ctx->scratch.resize(64 * 1024);
+        }
+        ctx->out = ctx->scratch.data();
+        ctx->capacity = ctx->scratch.size();
+    }
+    ctx->dest.next_output_byte = ctx->out;
+    ctx->dest.free_in_buffer = ctx->capacity;
+    ctx->size = 0;
+}
+
+boolean EmptyOutputBuffer(j_compress_ptr cinfo) {
+    JpegStripeContext* ctx = GetContext(cinfo);
+    if (!ctx->growable) {
+        ERREXIT(cinfo, JERR_BUFFER_SIZE);
+    }
+
+    // Буфер смуги росте і зберігається для наступних кадрів
+    size_t used = ctx->capacity;
+    ctx->scratch.resize(ctx->scratch.size() * 2);
+    ctx->out = ctx->scratch.data();
+    ctx->capacity = ctx->scratch.size();
+    ctx->dest.next_output_byte = ctx->out + used;
+    ctx->dest.free_in_buffer = ctx->capacity - used;
+    return TRUE;
+}
+
+void TermDestination(j_compress_ptr cinfo) {
+    JpegStripeContext* ctx = GetContext(cinfo);
+    ctx->size = ctx->capacity - ctx->dest.free_in_buffer;
+}
+
+// Лише POD локальні змінні - функція використовує setjmp/longjmp
+bool CompressRows(JpegStripeContext* ctx, const uint8_t* bgra, int stride) {
+    if (setjmp(ctx->error.jump)) {
+        jpeg_abort_compress(&ctx->cinfo);
+        return false;
+    }
+
+    jpeg_start_compress(&ctx->cinfo, TRUE);
+
+    JSAMPROW rows[kRowBatch];
+    while (ctx->cinfo.next_scanline < ctx->cinfo.image_height) {
+        int batch = 0;
+        JDIMENSION row = ctx->cinfo.next_scanline;
+        for (; batch < kRowBatch && row < ctx->cinfo.image_height; batch++, row++) {
+            rows[batch] = const_cast<JSAMPROW>(bgra + (size_t)(ctx->first_row + row) * stride);
+        }
+        jpeg_write_scanlines(&ctx->cinfo, rows, batch);
+    }
+
+    jpeg_finish_compress(&ctx->cinfo);
+    return true;
+}
+
+// Знайти кінець заголовка (після SOS) та позицію SOF0 у JPEG смуги
+bool FindScanData(const uint8_t* data, size_t size, size_t& header_end, size_t& sof_offset) {
+    if (size < 4 || data[0] != 0xFF || data[1] != 0xD8) {
+        return false;
+    }
+
+    size_t pos = 2;
+    sof_offset = 0;
+    while (pos + 4 <= size) {
+        if (data[pos] != 0xFF) {
+            return false;
+        }
+        uint8_t marker = data[pos + 1];
+        size_t length = ((size_t)data[pos + 2] << 8) | data[pos + 3];
+        if (marker == 0xC0) {
+            sof_offset = pos;
+        }
+        if (marker == 0xDA) {
+            header_end = pos + 2 + length;
+            return sof_offset != 0 && header_end <= size;
+        }
+        pos += 2 + length;
+    }
+    return false;
+}
+
+} // namespace
+
+JpegEncoder::JpegEncoder() {
+}
+
+JpegEncoder::~JpegEncoder() {
+    Cleanup();
+}
+
+void JpegEncoder::SetError(const std::string& error) {
+    last_error_ = error;
+}
+
+bool JpegEncoder::Initialize(int width, int height, int quality, bool chroma_420) {
+    Cleanup();
+
+    if (width <= 0 || height <= 0 || width > 65535 || height > 65535) {
+        SetError("Invalid JPEG frame size");
+        return false;
+    }
+
+    width_ = width;
+    height_ = height;
+    quality_ = quality < 1 ? 1 : (quality > 100 ? 100 : quality);
+    chroma_420_ = chroma_420;
+
+    // Звичайний кадр - один компресор без restart-маркерів
+    return PrepareStripes(1);
+}
+
+void JpegEncoder::Cleanup() {
+    for (auto& stripe : stripes_) {
+        if (stripe->created) {
+            jpeg_destroy_compress(&stripe->cinfo);
+        }
+    }
+    stripes_.clear();
+    last_stripe_count_ = 0;
+}
+
+bool JpegEncoder::PrepareStripes(int count) {
+    if ((int)stripes_.size() == count) {
+        return true;
+    }
+
+    for (auto& stripe : stripes_) {
+        if (stripe->created) {
+            jpeg_destroy_compress(&stripe->cinfo);
+        }
+    }
+    stripes_.clear();
+
+    const int mcu_width = chroma_420_ ? 16 : 8;
+    const int mcu_height = chroma_420_ ? 16 : 8;
+    const int mcu_rows = (height_ + mcu_height - 1) / mcu_height;
+
+    // Смуга - ціле число груп по 8 рядків MCU: номери RST0..RST7 у кожній
+    // смузі тоді збігаються з номерами в суцільному потоці
+    int group_rows = (mcu_rows + count - 1) / count;
+    group_rows = (group_rows + 7) / 8 * 8;
+    const int stripe_rows = group_rows * mcu_height;
+
+    for (int i = 0; i < count; i++) {
+        int first_row = i * stripe_rows;
+        if (first_row >= height_) {
+            break;
+        }
+
+        std::unique_ptr<JpegStripeContext> ctx(new JpegStripeContext());
+        ctx->first_row = first_row;
+        ctx->rows = std::min(stripe_rows, height_ - first_row);
+        ctx->growable = count > 1;
+
+        jpeg_compress_struct& cinfo = ctx->cinfo;
+        cinfo.err = jpeg_std_error(&ctx->error.pub);
+        ctx->error.pub.error_exit = OnJpegError;
+        ctx->error.pub.output_message = OnJpegMessage;
+        if (setjmp(ctx->error.jump)) {
+            SetError(std::string("libjpeg: ") + ctx->error.message);
+            if (ctx->created) {
+                jpeg_destroy_compress(&cinfo);
+            }
+            return false;
+        }
+
+        jpeg_create_compress(&cinfo);
+        ctx->created = true;
+        cinfo.client_data = ctx.get();
+
+        ctx->dest.init_destination = InitDestination;
+        ctx->dest.empty_output_buffer = EmptyOutputBuffer;
+        ctx->dest.term_destination = TermDestination;
+        cinfo.dest = &ctx->dest;
+
+        // BGRA напряму - libjpeg-turbo сам конвертує в YCbCr (SIMD)
+        cinfo.image_width = width_;
+        cinfo.image_height = ctx->rows;
+        cinfo.input_components = 4;
+        cinfo.in_color_space = JCS_EXT_BGRA;
+        jpeg_set_defaults(&cinfo);
+        jpeg_set_quality(&cinfo, quality_, TRUE);
+        cinfo.optimize_coding = FALSE;  // Стандартні таблиці Хаффмана - однакові в усіх смугах
+        cinfo.dct_method = JDCT_ISLOW;
+        cinfo.comp_info[0].h_samp_factor = chroma_420_ ? 2 : 1;
+        cinfo.comp_info[0].v_samp_factor = chroma_420_ ? 2 : 1;
+        if (count > 1) {
+            // Restart-маркер після кожного рядка MCU - межі смуг стають межами інтервалів
+            cinfo.restart_interval = (width_ + mcu_width - 1) / mcu_width;
+        }
+
+        stripes_.push_back(std::move(ctx));
+    }
+
+    return true;
+}
+
+size_t JpegEncoder::GetMaxOutputSize() const {
+    size_t padded = (size_t)((width_ + 15) & ~15) * ((height_ + 15) & ~15);
+    // Висока якість на шумному вмісті може перевищити розмір сирого 4:2:0
+    size_t body = quality_ > 90 ? padded * 3 : padded * 3 / 2;
+    return body + 4096;
+}
+
+bool JpegEncoder::Encode(const uint8_t* bgra, int stride, uint8_t* out, size_t capacity,
+                         size_t& out_size) {
+    out_size = 0;
+
+    if (stripes_.empty()) {
+        SetError("JPEG encoder not initialized");
+        return false;
+    }
+    if (!bgra || !out || stride < width_ * 4) {
+        SetError("Invalid input data size");
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    int threads = pool_ ? pool_->GetThreadCount() : 1;
+    int stripe_count = (height_ >= kStripeMinHeight && threads > 1) ? threads : 1;
+    if (!PrepareStripes(stripe_count)) {
+        return false;
+    }
+
+    bool ok;
+    if (stripes_.size() == 1) {
+        // Один компресор пише одразу у вихідний буфер (без копіювання)
+        JpegStripeContext* ctx = stripes_[0].get();
+        ctx->out = out;
+        ctx->capacity = capacity;
+        ok = CompressRows(ctx, bgra, stride);
+        if (ok) {
+            out_size = ctx->size;
+        } else {
+            SetError(std::string("libjpeg: ") + ctx->error.message);
+        }
+    } else {
+        ok = EncodeStriped(bgra, stride, (int)stripes_.size(), out, capacity, out_size);
+    }
+
+    last_stripe_count_ = (int)stripes_.size();
+    last_encode_ms_ = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return ok;
+}
+
+bool JpegEncoder::EncodeStriped(const uint8_t* bgra, int stride, int count,
+                                uint8_t* out, size_t capacity, size_t& out_size) {
+    pool_->ParallelFor(count, [&](int i) {
+        stripes_[i]->ok = CompressRows(stripes_[i].get(), bgra, stride);
+    });
+
+    for (int i = 0; i < count; i++) {
+        if (!stripes_[i]->ok) {
+            SetError(std::string("libjpeg: ") + stripes_[i]->error.message);
+            return false;
+        }
+    }
+
+    // Зшити смуги: заголовок першої (висота SOF0 = повний кадр) + ентропійні
+    // дані всіх смуг, розділені RSTn, + EOI
+    size_t pos = 0;
+    for (int i = 0; i < count; i++) {
+        const JpegStripeContext* ctx = stripes_[i].get();
+        size_t header_end = 0;
+        size_t sof_offset = 0;
+        if (!FindScanData(ctx->out, ctx->size, header_end, sof_offset) || ctx->size < header_end + 2) {
+            SetError("Malformed JPEG stripe");
+            return false;
+        }
+
+        const uint8_t* copy_from = ctx->out + (i == 0 ? 0 : header_end);
+        size_t copy_size = ctx->size - 2 - (i == 0 ? 0 : header_end);   // Без EOI
+        if (pos + copy_size + 4 > capacity) {
+            SetError("Encoded frame does not fit output buffer");
+            return false;
+        }
+
+        if (i > 0) {
+            // Restart-маркер між смугами; смуги кратні 8 рядкам MCU
+            int mcu_height = chroma_420_ ? 16 : 8;
+            int prev_mcu_rows = ctx->first_row / mcu_height;
+            out[pos++] = 0xFF;
+            out[pos++] = (uint8_t)(0xD0 + (prev_mcu_rows - 1) % 8);
+        }
+
+        memcpy(out + pos, copy_from, copy_size);
+        if (i == 0) {
+            // SOF0: FF C0 len(2) precision(1) height(2) width(2)
+            out[sof_offset + 5] = (uint8_t)(height_ >> 8);
+            out[sof_offset + 6] = (uint8_t)(height_ & 0xFF);
+        }
+        pos += copy_size;
+    }
+
+    out[pos++] = 0xFF;
+    out[pos++] = 0xD9;
+    out_size = pos;
+    return true;
+}
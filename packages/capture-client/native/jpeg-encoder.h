@@ -0,0 +1,66 @@
+/**
+ * JPEG Encoder (libjpeg-turbo)
+ * Кодування BGRA кадру напряму (JCS_EXT_BGRA, без перестановки каналів).
+ * Великі кадри (>= 1440p) кодуються смугами на пулі потоків і зшиваються
+ * в один baseline JPEG через restart-маркери (декодується будь-яким декодером).
+ */
+
+#ifndef JPEG_ENCODER_H
+#define JPEG_ENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class WorkerPool;
+struct JpegStripeContext;
+
+class JpegEncoder {
+public:
+    // Висота кадру, з якої вмикається смугове кодування
+    static constexpr int kStripeMinHeight = 1440;
+
+    JpegEncoder();
+    ~JpegEncoder();
+
+    JpegEncoder(const JpegEncoder&) = delete;
+    JpegEncoder& operator=(const JpegEncoder&) = delete;
+
+    // quality 1..100; chroma_420 = false -> 4:4:4 (чіткіший текст, більший розмір)
+    bool Initialize(int width, int height, int quality = 80, bool chroma_420 = true);
+    void Cleanup();
+
+    void SetWorkerPool(WorkerPool* pool) { pool_ = pool; }
+
+    // Закодувати BGRA кадр у out; помилка, якщо JPEG не вміщається в capacity
+    bool Encode(const uint8_t* bgra, int stride, uint8_t* out, size_t capacity, size_t& out_size);
+
+    // Рекомендований розмір вихідного буфера
+    size_t GetMaxOutputSize() const;
+    int GetLastStripeCount() const { return last_stripe_count_; }
+    double GetLastEncodeTimeMs() const { return last_encode_ms_; }
+    std::string GetLastError() const { return last_error_; }
+
+private:
+    bool PrepareStripes(int count);
+    bool EncodeStriped(const uint8_t* bgra, int stride, int count,
+                       uint8_t* out, size_t capacity, size_t& out_size);
+    void SetError(const std::string& error);
+
+    int width_ = 0;
+    int height_ = 0;
+    int quality_ = 80;
+    bool chroma_420_ = true;
+    WorkerPool* pool_ = nullptr;
+
+    // Компресори libjpeg створюються один раз і перевикористовуються між кадрами
+    std::vector<std::unique_ptr<JpegStripeContext>> stripes_;
+
+    int last_stripe_count_ = 0;
+    double last_encode_ms_ = 0.0;
+    std::string last_error_;
+};
+
+#endif // JPEG_ENCODER_H
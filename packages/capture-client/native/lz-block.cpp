@@ -0,0 +1,176 @@
+/**
+ * LZ Block Compressor Implementation
+ */
+
+#include "lz-block.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr size_t kMinMatch = 4;
+constexpr size_t kLastLiterals = 5;     // Останні байти блоку - завжди літерали
+constexpr size_t kMatchLimit = 12;      // Збіг не починається ближче до кінця
+constexpr size_t kMaxOffset = 65535;
+
+inline uint32_t Read32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t HashSequence(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - LzCompressor::kHashBits);
+}
+
+// Довжина понад 15 - додаткові байти по 255 і залишок
+inline uint8_t* WriteLength(uint8_t* op, size_t length) {
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = (uint8_t)length;
+    return op;
+}
+
+uint8_t* WriteSequence(uint8_t* op, const uint8_t* literals, size_t literal_count, size_t offset,
+                       size_t match_length) {
+    uint8_t* token = op++;
+    *token = (uint8_t)((literal_count >= 15 ? 15 : literal_count) << 4);
+    if (literal_count >= 15) {
+        op = WriteLength(op, literal_count - 15);
+    }
+    if (literal_count > 0) {
+        memcpy(op, literals, literal_count);
+        op += literal_count;
+    }
+
+    if (match_length == 0) {
+        return op;  // Остання послідовність - без збігу
+    }
+    *op++ = (uint8_t)(offset & 0xFF);
+    *op++ = (uint8_t)(offset >> 8);
+    const size_t extra = match_length - kMinMatch;
+    *token |= (uint8_t)(extra >= 15 ? 15 : extra);
+    if (extra >= 15) {
+        op = WriteLength(op, extra - 15);
+    }
+    return op;
+}
+
+} // namespace
+
+LzCompressor::LzCompressor() : table_((size_t)1 << kHashBits, 0) {
+}
+
+size_t LzCompressor::Compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity) {
+    if (!dst || capacity < GetMaxCompressedSize(size)) {
+        return 0;
+    }
+
+    // Таблиця з чистого аркуша - однаковий вхід дає однаковий блок
+    std::fill(table_.begin(), table_.end(), 0);
+
+    const uint8_t* ip = src;
+    const uint8_t* anchor = src;
+    const uint8_t* const end = src + size;
+    const uint8_t* const match_start_limit = size > kMatchLimit ? end - kMatchLimit : src;
+    const uint8_t* const match_end_limit = size > kLastLiterals ? end - kLastLiterals : src;
+    uint8_t* op = dst;
+
+    while (ip < match_start_limit) {
+        const uint32_t sequence = Read32(ip);
+        const uint32_t hash = HashSequence(sequence);
+        const uint8_t* ref = src + table_[hash];
+        table_[hash] = (uint32_t)(ip - src);
+
+        if (ref >= ip || (size_t)(ip - ref) > kMaxOffset || Read32(ref) != sequence) {
+            // Нестисливі ділянки проходяться дедалі більшими кроками
+            ip += 1 + ((size_t)(ip - anchor) >> 6);
+            continue;
+        }
+
+        const uint8_t* match_end = ip + kMinMatch;
+        ref += kMinMatch;
+        while (match_end < match_end_limit && *match_end == *ref) {
+            match_end++;
+            ref++;
+        }
+
+        op = WriteSequence(op, anchor, (size_t)(ip - anchor), (size_t)(match_end - ref),
+                           (size_t)(match_end - ip));
+        ip = match_end;
+        anchor = ip;
+        if (ip < match_start_limit) {
+            table_[HashSequence(Read32(ip - 2))] = (uint32_t)(ip - 2 - src);
+        }
+    }
+
+    op = WriteSequence(op, anchor, (size_t)(end - anchor), 0, 0);
+    return (size_t)(op - dst);
+}
+
+bool LzDecompress(const uint8_t* src, size_t size, uint8_t* dst, size_t dst_size) {
+    const uint8_t* ip = src;
+    const uint8_t* const ip_end = src + size;
+    uint8_t* op = dst;
+    uint8_t* const op_end = dst + dst_size;
+
+    while (ip < ip_end) {
+        const uint8_t token = *ip++;
+
+        size_t literal_count = token >> 4;
+        if (literal_count == 15) {
+            uint8_t byte;
+            do {
+                if (ip >= ip_end) {
+                    return false;
+                }
+                byte = *ip++;
+                literal_count += byte;
+            } while (byte == 255);
+        }
+        if (literal_count > (size_t)(ip_end - ip) || literal_count > (size_t)(op_end - op)) {
+            return false;
+        }
+        memcpy(op, ip, literal_count);
+        ip += literal_count;
+        op += literal_count;
+        if (ip == ip_end) {
+            break;
+        }
+
+        if (ip_end - ip < 2) {
+            return false;
+        }
+        const size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst)) {
+            return false;
+        }
+
+        size_t match_length = token & 15;
+        if (match_length == 15) {
+            uint8_t byte;
+            do {
+                if (ip >= ip_end) {
+                    return false;
+                }
+                byte = *ip++;
+                match_length += byte;
+            } while (byte == 255);
+        }
+        match_length += kMinMatch;
+        if (match_length > (size_t)(op_end - op)) {
+            return false;
+        }
+
+        // Збіг може перекривати сам себе (зміщення < довжини) - побайтово
+        const uint8_t* match = op - offset;
+        for (size_t i = 0; i < match_length; i++) {
+            op[i] = match[i];
+        }
+        op += match_length;
+    }
+    return op == op_end;
+}
@@ -0,0 +1,34 @@
+/**
+ * LZ Block Compressor
+ * Швидке стиснення без втрат у форматі блоку LZ4 (токен, літерали, 16-бітне зміщення):
+ * декодер - кілька десятків рядків, зокрема в браузері
+ */
+
+#ifndef LZ_BLOCK_H
+#define LZ_BLOCK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class LzCompressor {
+public:
+    static constexpr int kHashBits = 14;
+
+    LzCompressor();
+
+    // Найгірший розмір стиснутого блоку (нестисливі дані)
+    static size_t GetMaxCompressedSize(size_t size) { return size + size / 255 + 16; }
+
+    // Жадібний пошук збігів через хеш-таблицю останніх позицій.
+    // Повертає розмір блоку або 0, якщо capacity не вистачає.
+    size_t Compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity);
+
+private:
+    std::vector<uint32_t> table_;
+};
+
+// Розпакувати блок рівно в dst_size байт; false - блок пошкоджений
+bool LzDecompress(const uint8_t* src, size_t size, uint8_t* dst, size_t dst_size);
+
+#endif // LZ_BLOCK_H
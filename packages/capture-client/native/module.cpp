@@ -4,208 +4,2353 @@
  */
 
 #include <napi.h>
-#include "screen-capture.h"
-#include "encoder.h"
+#include "capture-source.h"
+#include "video-encoder.h"
+#include "frame-scaler.h"
+#include "h264-parser.h"
+#include "gop-cache.h"
+#include "worker-pool.h"
+#include "delta-encoder.h"
+#include "jpeg-encoder.h"
+#include "tile-encoder.h"
+#include "frame-pool.h"
+#include "aligned-memory.h"
+#include "buffer-arena.h"
+#include "capture-loop.h"
+#include "capture-scheduler.h"
+#include "cursor.h"
+#include "cursor-blend.h"
+#include "frame-pipeline.h"
+#include "frame-broadcast.h"
+#include "multi-output-capture.h"
+#include "capture-recording.h"
+#include "stats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
-// Глобальні об'єкти (один екземпляр на процес)
-static std::unique_ptr<ScreenCapture> g_screen_capture;
-static std::unique_ptr<H264Encoder> g_encoder;
+// Сесія захоплення одного виходу (монітора) або склеєного полотна: власне джерело,
+// кодек і буфери. Виходи не ділять стан, тож їх цикли працюють паралельно.
+struct CaptureSession {
+    int output = 0;                                 // Індекс виходу; -1 - склеєне полотно
+    std::unique_ptr<CaptureSource> screen_capture;  // DXGI / X11 / synthetic / stitched
+    std::unique_ptr<VideoEncoder> encoder;          // MF / x264
+    std::unique_ptr<H264Parser> h264_parser;        // NAL одиниці + кеш SPS/PPS виходу енкодера
+    double h264_pts_base_ms = -1.0;                 // Час захоплення першого кадру потоку
+    std::unique_ptr<GopCache> gop_cache;            // Поточна група кадрів h264/delta для нових глядачів
+    std::unique_ptr<WorkerPool> worker_pool;
+    std::unique_ptr<DeltaEncoder> delta_encoder;
+    std::unique_ptr<JpegEncoder> jpeg_encoder;
+    std::unique_ptr<TileEncoder> tile_encoder;      // Екранний кодек: текст/UI без втрат, решта - JPEG
+    std::unique_ptr<FrameScaler> scaler;            // Масштаб до width/height для bgra/delta/jpeg/tile
+    std::shared_ptr<CaptureScheduler> scheduler;    // Адаптивна частота (nullptr - фіксований темп)
+    std::unique_ptr<ChangeDetector> change_detector;
+    // Канал вказівника (nullptr - cursor: false). Поле змінюється лише під g_mutex -
+    // JS опитує трекер без mutex сесії, не чекаючи на захоплення
+    std::shared_ptr<CursorTracker> cursor;
+    uint64_t cursor_sequence = 0;                   // Останній стан курсора, показаний планувальнику
+    std::shared_ptr<FramePool> frame_pool;          // Вихідні кадри для JS
+    AlignedBuffer capture_buffer;                   // Вхідний BGRA кадр для h264/delta/масштабу
+    AlignedBuffer scaled_buffer;                    // Масштабований BGRA кадр для delta/jpeg/tile
+    std::vector<MoveRect> move_hints;               // Переміщення останнього кадру від джерела
+    AlignedBuffer overflow_buffer;                  // Запасний буфер, коли пул вичерпано
+    std::string codec;
+    int width = 0;                                  // Розмір виходу кодека
+    int height = 0;
+    int source_width = 0;                           // Розмір джерела (регіону) до масштабу
+    int source_height = 0;
+    std::mutex mutex;                               // Потік циклу бере лише mutex своєї сесії
+};
+
+// Сесії поточної ініціалізації (за замовчуванням одна - вихід 0).
+// Порядок блокувань: g_mutex -> CaptureSession::mutex.
+static std::vector<std::shared_ptr<CaptureSession>> g_sessions;
 static std::mutex g_mutex;
 
-// Ініціалізація захоплення екрану
-Napi::Value Initialize(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    
-    if (info.Length() < 1 || !info[0].IsObject()) {
-        Napi::TypeError::New(env, "Expected object with configuration").ThrowAsJavaScriptException();
-        return env.Null();
+// Асинхронний цикл захоплення (startCaptureLoop): по циклу на сесію. Власний
+// mutex - потік циклу сам бере mutex сесії, тому зупиняти його під ним не можна.
+struct SessionLoop {
+    std::shared_ptr<CaptureSession> session;
+    std::shared_ptr<CaptureLoop> loop;
+    std::shared_ptr<FramePipeline> pipeline;    // Стадії scale/convert/encode
+};
+static std::vector<SessionLoop> g_capture_loops;
+static Napi::ThreadSafeFunction g_loop_tsfn;    // Спільний для всіх сесій
+static std::mutex g_loop_mutex;
+
+// Захоплені кадри для додаткових споживачів (прев'ю, запис): один кадр на всіх
+// за лічильником посилань. ThreadSafeFunction споживачів - лише з JS потоку.
+static FrameBroadcast g_broadcast;
+static std::map<int, Napi::ThreadSafeFunction> g_broadcast_tsfns;
+
+// Звільнити нативні ресурси сесії (викликається під mutex сесії)
+static void ReleaseSession(CaptureSession& session) {
+    session.screen_capture.reset();
+    // Після джерела - воно тримає вказівник на трекер
+    session.cursor.reset();
+    session.cursor_sequence = 0;
+    session.encoder.reset();
+    session.h264_parser.reset();
+    session.gop_cache.reset();
+    session.delta_encoder.reset();
+    session.jpeg_encoder.reset();
+    session.tile_encoder.reset();
+    session.scaler.reset();
+    session.scheduler.reset();
+    session.change_detector.reset();
+    // Буфери, які ще тримає JS, повернуться в пул при фіналізації
+    session.frame_pool.reset();
+    session.capture_buffer = AlignedBuffer();
+    session.scaled_buffer = AlignedBuffer();
+    session.overflow_buffer = AlignedBuffer();
+    // Пул потоків - останнім, інші об'єкти тримають на нього вказівник
+    session.worker_pool.reset();
+}
+
+// Звільнити всі сесії (викликається під g_mutex, цикли вже зупинені)
+static void ReleaseCaptureObjects() {
+    for (const auto& session : g_sessions) {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        ReleaseSession(*session);
+    }
+    g_sessions.clear();
+}
+
+// Сесія виходу output (під g_mutex); output < 0 - перша сесія
+static std::shared_ptr<CaptureSession> FindSession(int output) {
+    for (const auto& session : g_sessions) {
+        if (output < 0 || session->output == output) {
+            return session;
+        }
+    }
+    return nullptr;
+}
+
+// Необов'язковий індекс виходу в info[index]; -1 - перша сесія
+static int GetOutputArgument(const Napi::CallbackInfo& info, size_t index) {
+    if (info.Length() > index && info[index].IsNumber()) {
+        return info[index].As<Napi::Number>().Int32Value();
+    }
+    return -1;
+}
+
+// Вихідний буфер кадру: з пулу (без копіювання) або запасний (пул вичерпано)
+struct OutputBuffer {
+    uint8_t* data = nullptr;
+    size_t capacity = 0;
+    bool pooled = false;
+};
+
+// allow_overflow = false: при вичерпаному пулі data == nullptr (кадр пропускається)
+static OutputBuffer AcquireOutputBuffer(CaptureSession& session, bool allow_overflow) {
+    OutputBuffer out;
+    out.capacity = session.frame_pool->GetBufferSize();
+    out.data = session.frame_pool->Acquire();
+    out.pooled = out.data != nullptr;
+
+    if (!out.pooled && allow_overflow) {
+        session.overflow_buffer.Resize(out.capacity);
+        out.data = session.overflow_buffer.data();
+    } else if (!out.pooled) {
+        GetCaptureStats().Add(StatCounter::FramesDropped);
+    }
+    return out;
+}
+
+static void DiscardOutputBuffer(CaptureSession& session, const OutputBuffer& out) {
+    if (out.pooled) {
+        session.frame_pool->Release(out.data);
+    }
+}
+
+// Власник буфера пулу, переданого в JS
+struct PooledBufferOwner {
+    std::shared_ptr<FramePool> pool;
+    int64_t external_bytes;
+};
+
+// Буфер пулу передається в JS як external Buffer - фіналізатор повертає його в пул.
+// Пул тримається через shared_ptr, поки живий хоч один такий Buffer.
+static Napi::Buffer<uint8_t> WrapPoolBuffer(Napi::Env env, const std::shared_ptr<FramePool>& pool,
+                                            uint8_t* data, size_t size) {
+    // Власник на кожен переданий кадр - блок з арени, а не new
+    void* owner_block = GetBufferArena().Allocate(sizeof(PooledBufferOwner));
+    if (!owner_block) {
+        GetCaptureStats().Add(StatCounter::BufferCopies);
+        Napi::Buffer<uint8_t> copy = Napi::Buffer<uint8_t>::Copy(env, data, size);
+        pool->Release(data);
+        return copy;
+    }
+    auto* owner = new (owner_block) PooledBufferOwner{ pool, (int64_t)pool->GetBufferSize() };
+    // Повідомити V8 про зовнішню пам'ять, щоб GC швидше повертав буфери в пул
+    Napi::MemoryManagement::AdjustExternalMemory(env, owner->external_bytes);
+
+    return Napi::Buffer<uint8_t>::New(env, data, size,
+        [](Napi::Env finalize_env, uint8_t* data, PooledBufferOwner* buffer_owner) {
+            buffer_owner->pool->Release(data);
+            Napi::MemoryManagement::AdjustExternalMemory(finalize_env, -buffer_owner->external_bytes);
+            buffer_owner->~PooledBufferOwner();
+            GetBufferArena().Free(buffer_owner);
+        }, owner);
+}
+
+static Napi::Buffer<uint8_t> ToJsBuffer(Napi::Env env, CaptureSession& session, const OutputBuffer& out,
+                                        size_t size) {
+    ScopedStageTimer timer(StatStage::Handoff);
+    GetCaptureStats().Add(StatCounter::BytesOut, size);
+    if (!out.pooled) {
+        GetCaptureStats().Add(StatCounter::BufferCopies);
+        return Napi::Buffer<uint8_t>::Copy(env, out.data, size);
+    }
+    return WrapPoolBuffer(env, session.frame_pool, out.data, size);
+}
+
+// Результат захоплення + кодування одного кадру (без залежності від JS)
+struct EncodedFrame {
+    OutputBuffer out;
+    size_t size = 0;            // 0 - даних немає (енкодеру потрібно більше кадрів / без змін)
+    const char* codec = "bgra";
+    bool keyframe = false;
+    bool has_delta_info = false;
+    int tiles = 0;
+    int moves = 0;              // delta: переміщення (прокрутка) у пакеті
+    bool has_h264_info = false;
+    H264Packet h264;
+    double convert_ms = -1.0;
+    double timestamp_ms = 0.0;  // Час захоплення (steady clock) - вхід для pts
+    std::string error;
+};
+
+// Час steady clock у мс (той самий годинник, що й timestamp_ms циклу)
+static double GetSteadyTimeMs() {
+    return std::chrono::duration<double, std::milli>(
+        CaptureStats::Clock::now().time_since_epoch()).count();
+}
+
+// Результат захоплення для планувальника (під mutex сесії): frame == nullptr - нового кадру немає
+static void ReportCaptureToScheduler(CaptureSession& session, const uint8_t* frame, int stride) {
+    if (!session.scheduler) {
+        return;
+    }
+    const double now_ms = GetSteadyTimeMs();
+    if (session.cursor) {
+        const uint64_t sequence = session.cursor->GetSequence();
+        if (sequence != session.cursor_sequence) {
+            session.cursor_sequence = sequence;
+            session.scheduler->ReportCursorMove(now_ms);
+        }
+    }
+    double change = frame ? session.change_detector->Measure(frame, stride) : 0.0;
+    session.scheduler->ReportFrame(now_ms, change, session.screen_capture->GetAccumulatedFrames());
+}
+
+// Передати захоплений кадр споживачам трансляції без копіювання: буфер захоплення
+// переходить у кадр, а на його місце береться інший блок того ж класу з арени.
+// Викликається, коли енкодеру кадр уже не потрібен.
+static void BroadcastCapturedFrame(CaptureSession& session, AlignedBuffer& capture, double timestamp_ms) {
+    if (!g_broadcast.HasConsumers() || !capture.data()) {
+        return;
+    }
+    std::shared_ptr<BroadcastFrame> frame = FrameBroadcast::CreateFrame();
+    if (!frame) {
+        return;
+    }
+
+    const size_t size = capture.size();
+    frame->data = std::move(capture);
+    if (!capture.Resize(size)) {
+        // Без запасного блоку захоплення важливіше за трансляцію
+        capture = std::move(frame->data);
+        GetCaptureStats().Add(StatCounter::FramesDropped);
+        return;
+    }
+    frame->width = session.screen_capture->GetWidth();
+    frame->height = session.screen_capture->GetHeight();
+    frame->stride = frame->width * 4;
+    frame->timestamp_ms = timestamp_ms;
+    frame->output = session.output;
+    g_broadcast.Publish(std::move(frame));
+}
+
+// captureFrame() з планувальником не блокує JS потік: темп задає nextCaptureMs
+static unsigned int GetSyncAcquireTimeout(CaptureSession& session) {
+    return session.scheduler ? 0 : CaptureSource::kDefaultAcquireTimeoutMs;
+}
+
+// Розібрати закодований кадр h264 прямо у вихідному буфері (без копіювання)
+static bool ParseH264Frame(CaptureSession& session, EncodedFrame& frame) {
+    if (!session.h264_parser->Parse(frame.out.data, frame.size, frame.h264)) {
+        frame.error = session.h264_parser->GetLastError();
+        return false;
+    }
+
+    // pts у 90 кГц від першого кадру: кадри простою пропускаються, тому не лічильник кадрів
+    if (session.h264_pts_base_ms < 0) {
+        session.h264_pts_base_ms = frame.timestamp_ms;
+    }
+    frame.h264.pts = std::llround((frame.timestamp_ms - session.h264_pts_base_ms) * 90.0);
+    frame.keyframe = frame.keyframe || frame.h264.keyframe;
+    frame.has_h264_info = true;
+    return true;
+}
+
+// Крок рядка BGRA кадру на вході кодека: h264 масштабує сам (разом з конвертацією),
+// delta/jpeg/tile отримують уже масштабований кадр
+static int GetEncoderInputStride(CaptureSession& session) {
+    return (session.scaler ? session.scaler->GetWidth() : session.screen_capture->GetWidth()) * 4;
+}
+
+// Масштабувати захоплений кадр до розміру виходу (bgra/delta/jpeg/tile).
+// src_stride - крок рядка буфера захоплення або pitch view джерела.
+static bool ScaleCapturedFrame(CaptureSession& session, const uint8_t* src, int src_stride, uint8_t* dst) {
+    if (!session.scaler->ScaleBGRA(src, src_stride, dst, session.scaler->GetWidth() * 4)) {
+        return false;
+    }
+    GetCaptureStats().RecordMs(StatStage::Convert, session.scaler->GetLastScaleTimeMs());
+    return true;
+}
+
+// Додати закодований кадр у GOP кеш (одна копія стиснутого кадру на всіх глядачів)
+static void CacheEncodedFrame(CaptureSession& session, const EncodedFrame& frame) {
+    GopFrameInfo info;
+    info.codec = frame.codec;
+    info.keyframe = frame.keyframe;
+    info.has_h264_info = frame.has_h264_info;
+    if (frame.has_h264_info) {
+        info.h264 = frame.h264;
+    }
+    info.timestamp_ms = frame.timestamp_ms;
+
+    // MFT може віддати IDR без SPS/PPS - тоді група починається з кешованих параметрів
+    std::vector<uint8_t> parameter_sets;
+    if (frame.has_h264_info && frame.h264.keyframe && !frame.h264.has_parameter_sets) {
+        parameter_sets = session.h264_parser->GetCodecConfig();
+    }
+    session.gop_cache->Add(frame.out.data, frame.size, info,
+                     parameter_sets.empty() ? nullptr : &parameter_sets);
+}
+
+// Переміщення від джерела (DXGI move rects) для дельта-кодера. Лише без масштабу:
+// інакше координати джерела і кадру кодера різні.
+static void CollectMoveHints(CaptureSession& session, std::vector<MoveRect>& moves) {
+    if (!session.delta_encoder || !session.delta_encoder->IsMotionDetectionEnabled() || session.scaler ||
+        !session.screen_capture->GetMoveRects(moves)) {
+        moves.clear();
+    }
+}
+
+// Підказки щойно захопленого кадру - кодеру (кодування одразу після захоплення)
+static void PassMoveHints(CaptureSession& session) {
+    CollectMoveHints(session, session.move_hints);
+    if (!session.move_hints.empty()) {
+        session.delta_encoder->SetMoveHints(session.move_hints);
+    }
+}
+
+// Відкинутий дельта/h264 кадр ламає ланцюжок посилань: наступні кадри закодовані
+// відносно нього (кадр-еталон, слоти кешу плиток), тож глядачі відновлюються лише з
+// найближчого keyframe. Запит атомарний - з потоку циклу або конвеєра без mutex сесії
+static void ForceKeyframeAfterDrop(CaptureSession& session, const char* codec) {
+    const std::string name = codec;
+    if (name == "delta" && session.delta_encoder) {
+        session.delta_encoder->ForceKeyframe();
+    } else if (name == "h264" && session.encoder) {
+        session.encoder->ForceKeyframe();
+    }
+}
+
+// Закодувати вже захоплений BGRA кадр (h264/delta/jpeg/tile) у вихідний буфер.
+// nv12 != nullptr - кадр уже сконвертований стадією конвеєра.
+static bool EncodeCapturedFrame(CaptureSession& session, const uint8_t* bgra, int frame_stride,
+                                const uint8_t* nv12, EncodedFrame& frame, bool allow_overflow) {
+    frame.out = AcquireOutputBuffer(session, allow_overflow);
+    if (!frame.out.data) {
+        frame.error = "POOL_EXHAUSTED";
+        return false;
+    }
+
+    CaptureStats& stats = GetCaptureStats();
+    auto encode_start = CaptureStats::Clock::now();
+
+    bool ok;
+    if (session.encoder) {
+        if (nv12) {
+            ok = session.encoder->EncodeNV12(nv12, frame.out.data, frame.out.capacity, frame.size);
+        } else {
+            ok = session.encoder->Encode(bgra, frame_stride,
+                                   frame.out.data, frame.out.capacity, frame.size);
+        }
+        frame.codec = "h264";
+        frame.keyframe = session.encoder->IsLastKeyframe();
+        if (!nv12) {
+            frame.convert_ms = session.encoder->GetLastConvertTimeMs();
+        }
+        if (!ok) {
+            frame.error = session.encoder->GetLastError();
+        } else if (frame.size > 0) {
+            ok = ParseH264Frame(session, frame);
+        }
+    } else if (session.jpeg_encoder) {
+        // JPEG напряму з BGRA (libjpeg-turbo), великі кадри - смугами
+        ok = session.jpeg_encoder->Encode(bgra, frame_stride,
+                                    frame.out.data, frame.out.capacity, frame.size);
+        frame.codec = "jpeg";
+        if (!ok) {
+            frame.error = session.jpeg_encoder->GetLastError();
+        }
+    } else if (session.tile_encoder) {
+        // Кожен кадр самодостатній - без keyframe і GOP кешу
+        ok = session.tile_encoder->Encode(bgra, frame_stride,
+                                    frame.out.data, frame.out.capacity, frame.size);
+        frame.codec = "tile";
+        if (!ok) {
+            frame.error = session.tile_encoder->GetLastError();
+        }
+    } else {
+        // Дельта-режим - лише змінені плитки + індекс
+        ok = session.delta_encoder->Encode(bgra, frame_stride,
+                                     frame.out.data, frame.out.capacity, frame.size);
+        frame.codec = "delta";
+        frame.has_delta_info = true;
+        frame.keyframe = session.delta_encoder->IsLastKeyframe();
+        frame.tiles = session.delta_encoder->GetLastTileCount();
+        frame.moves = session.delta_encoder->GetLastMoveCount();
+        if (!ok) {
+            frame.error = session.delta_encoder->GetLastError();
+        } else {
+            const TileCacheStats cache = session.delta_encoder->GetLastTileCacheStats();
+            stats.Add(StatCounter::TileCacheHits, cache.hits);
+            stats.Add(StatCounter::TileCacheMisses, cache.misses);
+            stats.Add(StatCounter::TileCacheEvictions, cache.evictions);
+        }
+    }
+
+    // Конвертація (h264 без конвеєра) має власну гістограму - тут лише кодек
+    double encode_ms = std::chrono::duration<double, std::milli>(
+        CaptureStats::Clock::now() - encode_start).count();
+    stats.RecordMs(StatStage::Encode, frame.convert_ms > 0 ? encode_ms - frame.convert_ms : encode_ms);
+    if (!ok) {
+        stats.Add(StatCounter::Errors);
+    } else if (frame.size > 0) {
+        stats.Add(StatCounter::FramesEncoded);
+        stats.Add(StatCounter::MoveRects, (uint64_t)frame.moves);
+        if (session.gop_cache) {
+            CacheEncodedFrame(session, frame);
+        }
+    }
+
+    // Помилка або даних немає - буфер одразу повертається в пул
+    if (!ok || frame.size == 0) {
+        if (!ok) {
+            // Кодер міг уже оновити свій стан пакетом, якого отримувач не побачить
+            ForceKeyframeAfterDrop(session, frame.codec);
+        }
+        DiscardOutputBuffer(session, frame.out);
+        frame.out = OutputBuffer();
+        frame.size = 0;
+    }
+    return ok;
+}
+
+// Чи можуть стадії читати кадр прямо з пам'яті джерела (view з її pitch) замість
+// копії в буфер захоплення. Трансляція забирає буфер захоплення собі, а delta/bgra
+// передають альфу, якої у BGRX немає. RAW без масштабу і так копіюється один раз - у пул.
+static bool CanEncodeFromView(CaptureSession& session) {
+    if (!session.screen_capture->SupportsFrameView() || g_broadcast.HasConsumers()) {
+        return false;
+    }
+    if (!session.encoder && !session.delta_encoder && !session.jpeg_encoder && !session.tile_encoder &&
+        !session.scaler) {
+        return false;
+    }
+    return session.screen_capture->GetViewFormat() == PixelFormat::BGRA ||
+           session.encoder || session.jpeg_encoder || session.tile_encoder;
+}
+
+// Захопити кадр як view і закодувати (або масштабувати RAW) без проміжної копії.
+// Кадр джерела тримається лише до кінця кодування.
+static bool CaptureAndEncodeView(CaptureSession& session, EncodedFrame& frame, bool allow_overflow) {
+    const bool raw = !session.encoder && !session.delta_encoder && !session.jpeg_encoder &&
+                     !session.tile_encoder;
+    if (raw) {
+        frame.out = AcquireOutputBuffer(session, allow_overflow);
+        if (!frame.out.data) {
+            frame.error = "POOL_EXHAUSTED";
+            return false;
+        }
+    }
+
+    FrameView view;
+    if (!session.screen_capture->AcquireFrameView(view)) {
+        if (raw) {
+            DiscardOutputBuffer(session, frame.out);
+        }
+        ReportCaptureToScheduler(session, nullptr, 0);
+        GetCaptureStats().Add(StatCounter::FramesSkipped);
+        frame.error = "NO_NEW_FRAME";
+        return false;
+    }
+    ReportCaptureToScheduler(session, view.data, view.stride);
+    GetCaptureStats().Add(StatCounter::FramesCaptured);
+
+    bool ok;
+    if (!session.scaler) {
+        PassMoveHints(session);
+        ok = EncodeCapturedFrame(session, view.data, view.stride, nullptr, frame, allow_overflow);
+    } else if (!ScaleCapturedFrame(session, view.data, view.stride,
+                                   raw ? frame.out.data : session.scaled_buffer.data())) {
+        if (raw) {
+            DiscardOutputBuffer(session, frame.out);
+        }
+        GetCaptureStats().Add(StatCounter::Errors);
+        frame.error = "Failed to scale frame";
+        ok = false;
+    } else if (raw) {
+        frame.codec = "bgra";
+        frame.size = (size_t)GetEncoderInputStride(session) * session.scaler->GetHeight();
+        frame.convert_ms = session.scaler->GetLastScaleTimeMs();
+        ok = true;
+    } else {
+        ok = EncodeCapturedFrame(session, session.scaled_buffer.data(), GetEncoderInputStride(session),
+                                 nullptr, frame, allow_overflow);
+        frame.convert_ms = session.scaler->GetLastScaleTimeMs();
+    }
+
+    session.screen_capture->ReleaseFrameView();
+    return ok;
+}
+
+// Захопити й закодувати кадр (викликається під mutex сесії з JS потоку або потоку циклу).
+// false - кадру немає або помилка (frame.error).
+static bool CaptureAndEncode(CaptureSession& session, EncodedFrame& frame, bool allow_overflow) {
+    if (!session.screen_capture) {
+        frame.error = "Not initialized";
+        return false;
+    }
+
+    if (CanEncodeFromView(session)) {
+        return CaptureAndEncodeView(session, frame, allow_overflow);
+    }
+
+    int frame_stride = session.screen_capture->GetWidth() * 4;
+
+    if (!session.encoder && !session.delta_encoder && !session.jpeg_encoder && !session.tile_encoder) {
+        // Енкодер вимкнений - RAW BGRA захоплюється одразу у буфер пулу
+        // (з масштабом або трансляцією - через внутрішній буфер)
+        bool broadcast = g_broadcast.HasConsumers() &&
+                         session.capture_buffer.Resize((size_t)frame_stride * session.screen_capture->GetHeight());
+        frame.out = AcquireOutputBuffer(session, allow_overflow);
+        if (!frame.out.data) {
+            frame.error = "POOL_EXHAUSTED";
+            return false;
+        }
+        uint8_t* target = session.scaler || broadcast ? session.capture_buffer.data() : frame.out.data;
+        if (!session.screen_capture->CaptureFrame(target, frame_stride)) {
+            DiscardOutputBuffer(session, frame.out);
+            ReportCaptureToScheduler(session, nullptr, 0);
+            GetCaptureStats().Add(StatCounter::FramesSkipped);
+            frame.error = "NO_NEW_FRAME";
+            return false;
+        }
+        ReportCaptureToScheduler(session, target, frame_stride);
+        GetCaptureStats().Add(StatCounter::FramesCaptured);
+
+        if (session.scaler) {
+            if (!ScaleCapturedFrame(session, target, frame_stride, frame.out.data)) {
+                DiscardOutputBuffer(session, frame.out);
+                GetCaptureStats().Add(StatCounter::Errors);
+                frame.error = "Failed to scale frame";
+                return false;
+            }
+            frame.convert_ms = session.scaler->GetLastScaleTimeMs();
+        } else if (broadcast) {
+            // Без масштабу кадр у пул іде копією - трансляція забирає сам буфер захоплення
+            memcpy(frame.out.data, target, session.capture_buffer.size());
+        }
+        BroadcastCapturedFrame(session, session.capture_buffer, frame.timestamp_ms);
+
+        frame.codec = "bgra";
+        frame.size = (size_t)GetEncoderInputStride(session) *
+                     (session.scaler ? session.scaler->GetHeight() : session.screen_capture->GetHeight());
+        return true;
+    }
+
+    // Захопити кадр у внутрішній буфер (вхід енкодера)
+    if (!session.screen_capture->CaptureFrame(session.capture_buffer.data(), frame_stride)) {
+        ReportCaptureToScheduler(session, nullptr, 0);
+        GetCaptureStats().Add(StatCounter::FramesSkipped);
+        frame.error = "NO_NEW_FRAME";
+        return false;
+    }
+    ReportCaptureToScheduler(session, session.capture_buffer.data(), frame_stride);
+    GetCaptureStats().Add(StatCounter::FramesCaptured);
+
+    if (!session.scaler) {
+        PassMoveHints(session);
+        bool ok = EncodeCapturedFrame(session, session.capture_buffer.data(), frame_stride, nullptr,
+                                      frame, allow_overflow);
+        BroadcastCapturedFrame(session, session.capture_buffer, frame.timestamp_ms);
+        return ok;
+    }
+
+    if (!ScaleCapturedFrame(session, session.capture_buffer.data(), frame_stride,
+                            session.scaled_buffer.data())) {
+        GetCaptureStats().Add(StatCounter::Errors);
+        frame.error = "Failed to scale frame";
+        return false;
+    }
+    BroadcastCapturedFrame(session, session.capture_buffer, frame.timestamp_ms);
+    bool ok = EncodeCapturedFrame(session, session.scaled_buffer.data(), GetEncoderInputStride(session),
+                                  nullptr, frame, allow_overflow);
+    frame.convert_ms = session.scaler->GetLastScaleTimeMs();
+    return ok;
+}
+
+// Розмір виходу за запитом width/height: 0 - як у джерела, одна сторона - за пропорцією.
+// Більше за джерело не буває; масштабований кадр має парні сторони (chroma 2x2).
+static void ComputeOutputSize(int source_width, int source_height, int width, int height,
+                              int& out_width, int& out_height) {
+    out_width = source_width;
+    out_height = source_height;
+    if (width <= 0 && height <= 0) {
+        return;
+    }
+    if (width <= 0) {
+        width = (int)((int64_t)height * source_width / source_height);
+    } else if (height <= 0) {
+        height = (int)((int64_t)width * source_height / source_width);
+    }
+
+    width = std::min(width, source_width);
+    height = std::min(height, source_height);
+    if (width != source_width || height != source_height) {
+        out_width = std::max(2, width & ~1);
+        out_height = std::max(2, height & ~1);
+    }
+}
+
+// Параметри ініціалізації з JS (спільні для всіх сесій)
+struct CaptureConfig {
+    int width = 0;
+    int height = 0;
+    int bitrate = 2000000;
+    int fps = 30;
+    bool use_hardware = true;
+    VideoEncoderConfig encoder_config;      // encoderBackend: auto | mf | x264
+    std::string encoder_backend = "auto";
+    int threads = 0;            // 0 = кількість ядер (до WorkerPool::kMaxThreads)
+    std::string codec;          // "bgra" | "h264" | "delta" | "jpeg" | "tile" (за замовчуванням - за bitrate)
+    int tile_size = 64;
+    bool move_detection = true; // delta: прокрутка/переміщення - копіюванням замість плиток
+    double tile_cache_max_bytes = 32.0 * 1024 * 1024;   // delta: кеш плиток отримувача (0 - вимкнено)
+    int keyframe_interval = 300;
+    int pool_depth = 4;         // Кількість кадрів, які JS може тримати одночасно
+    int jpeg_quality = 80;      // jpeg; tile - якість складних плиток (0 - без втрат)
+    bool jpeg_chroma420 = true; // false - 4:4:4 (чіткіший текст)
+    bool gop_cache = true;      // h264/delta: група кадрів для глядачів, що підключаються пізніше
+    double gop_cache_max_bytes = 32.0 * 1024 * 1024;
+    int gop_cache_max_frames = 0;   // 0 - keyframeInterval + 1 (уся група)
+    CaptureSourceOptions source_options;    // backend: auto | dxgi | x11 | synthetic | replay
+    ScaleFilter scale_filter = ScaleFilter::Box;    // scaleFilter: box | bilinear
+    bool adaptive = true;       // Частота за вмістом: fps - максимум, minFps - на статичному екрані
+    CaptureSchedulerConfig scheduler_config;
+    std::vector<int> outputs;   // outputs: [індекси] - по сесії на вихід
+    bool all_outputs = false;   // outputs: 'all'
+    bool stitch = false;        // Вибрані виходи - одне склеєне полотно
+    FrameRect region;           // region: {x, y, width, height} у межах виходу (порожній - увесь)
+    bool cursor = true;         // Позиція і форма вказівника окремим каналом (getCursor)
+    std::string record_path;    // recordPath: захоплені кадри - у файл запису (для replay)
+    bool record_delta = true;   // recordDelta: лише змінені прямокутники між повними кадрами
+};
+
+static bool ParseCaptureConfig(Napi::Object config, CaptureConfig& cfg, std::string& error) {
+    if (config.Has("width")) {
+        cfg.width = config.Get("width").As<Napi::Number>().Int32Value();
+    }
+    if (config.Has("height")) {
+        cfg.height = config.Get("height").As<Napi::Number>().Int32Value();
+    }
+    if (config.Has("bitrate")) {
+        cfg.bitrate = config.Get("bitrate").As<Napi::Number>().Int32Value();
+    }
+    if (config.Has("fps")) {
+        cfg.fps = config.Get("fps").As<Napi::Number>().Int32Value();
+    }
+    if (config.Has("useHardware")) {
+        cfg.use_hardware = config.Get("useHardware").As<Napi::Boolean>().Value();
+    }
+    if (config.Has("encoderBackend")) {
+        cfg.encoder_backend = config.Get("encoderBackend").As<Napi::String>().Utf8Value();
+    }
+    if (config.Has("encoderPreset")) {
+        cfg.encoder_config.preset = config.Get("encoderPreset").As<Napi::String>().Utf8Value();
+    }
+    if (config.Has("lowLatency")) {
+        cfg.encoder_config.low_latency = config.Get("lowLatency").As<Napi::Boolean>().Value();
+    }
+    if (config.Has("threads")) {
+        cfg.threads = config.Get("threads").As<Napi::Number>().Int32Value();
+    }
+    if (config.Has("codec")) {
+        cfg.codec = config.Get("codec").As<Napi::String>().Utf8Value();
+    }
+    if (config.Has("tileSize")) {
+        cfg.tile_size = config.Get("tileSize").As<Napi::Number>().Int32Value();
+    }
+    if (config.Has("moveDetection")) {
+        cfg.move_detection = config.Get("moveDetection").As<Napi::Boolean>().Value();
+    }
+    if (config.Has("tileCacheMaxBytes")) {
+        cfg.tile_cache_max_bytes = config.Get("tileCacheMaxBytes").As<Napi::Number>().DoubleValue();
+    }
+    if (config.Has("keyframeInterval")) {
+        cfg.keyframe_interval = config.Get("keyframeInterval").As<Napi::Number>().Int32Value();
+    }
+    if (config.Has("poolDepth")) {
+        cfg.pool_depth = config.Get("poolDepth").As<Napi::Number>().Int32Value();
+    }
+    if (config.Has("jpegQuality")) {
+        cfg.jpeg_quality = config.Get("jpegQuality").As<Napi::Number>().Int32Value();
+    }
+    if (config.Has("jpegChroma")) {
+        cfg.jpeg_chroma420 = config.Get("jpegChroma").As<Napi::String>().Utf8Value() != "444";
+    }
+    if (config.Has("gopCache")) {
+        cfg.gop_cache = config.Get("gopCache").As<Napi::Boolean>().Value();
+    }
+    if (config.Has("gopCacheMaxBytes")) {
+        cfg.gop_cache_max_bytes = config.Get("gopCacheMaxBytes").As<Napi::Number>().DoubleValue();
+    }
+    if (config.Has("gopCacheMaxFrames")) {
+        cfg.gop_cache_max_frames = config.Get("gopCacheMaxFrames").As<Napi::Number>().Int32Value();
+    }
+    if (config.Has("backend")) {
+        cfg.source_options.backend = config.Get("backend").As<Napi::String>().Utf8Value();
+    }
+    if (config.Has("syntheticScenario")) {
+        cfg.source_options.scenario = config.Get("syntheticScenario").As<Napi::String>().Utf8Value();
+    }
+    if (config.Has("syntheticSeed")) {
+        cfg.source_options.seed = config.Get("syntheticSeed").As<Napi::Number>().Uint32Value();
+    }
+    if (config.Has("syntheticOutputs")) {
+        cfg.source_options.synthetic_outputs = config.Get("syntheticOutputs").As<Napi::Number>().Int32Value();
+    }
+    if (config.Has("display")) {
+        cfg.source_options.display = config.Get("display").As<Napi::String>().Utf8Value();
+    }
+    if (config.Has("output")) {
+        cfg.source_options.output = config.Get("output").As<Napi::Number>().Int32Value();
+    }
+    if (config.Has("replayPath")) {
+        cfg.source_options.replay_path = config.Get("replayPath").As<Napi::String>().Utf8Value();
+    }
+    if (config.Has("replaySpeed")) {
+        std::string speed = config.Get("replaySpeed").As<Napi::String>().Utf8Value();
+        if (speed != "original" && speed != "max") {
+            error = "replaySpeed must be 'original' or 'max'";
+            return false;
+        }
+        cfg.source_options.replay_realtime = speed == "original";
+    }
+    if (config.Has("replayLoop")) {
+        cfg.source_options.replay_loop = config.Get("replayLoop").As<Napi::Boolean>().Value();
+    }
+    if (config.Has("recordPath")) {
+        cfg.record_path = config.Get("recordPath").As<Napi::String>().Utf8Value();
+    }
+    if (config.Has("recordDelta")) {
+        cfg.record_delta = config.Get("recordDelta").As<Napi::Boolean>().Value();
+    }
+    if (config.Has("outputs")) {
+        Napi::Value outputs = config.Get("outputs");
+        if (outputs.IsString() && outputs.As<Napi::String>().Utf8Value() == "all") {
+            cfg.all_outputs = true;
+        } else if (outputs.IsArray()) {
+            Napi::Array list = outputs.As<Napi::Array>();
+            for (uint32_t i = 0; i < list.Length(); i++) {
+                cfg.outputs.push_back(list.Get(i).As<Napi::Number>().Int32Value());
+            }
+        } else {
+            error = "outputs must be an array of output indices or 'all'";
+            return false;
+        }
+    }
+    if (config.Has("stitch")) {
+        cfg.stitch = config.Get("stitch").As<Napi::Boolean>().Value();
+    }
+    if (config.Has("region")) {
+        Napi::Value region = config.Get("region");
+        if (!region.IsObject()) {
+            error = "region must be an object { x, y, width, height }";
+            return false;
+        }
+        Napi::Object rect = region.As<Napi::Object>();
+        const char* keys[] = { "x", "y", "width", "height" };
+        int* fields[] = { &cfg.region.x, &cfg.region.y, &cfg.region.width, &cfg.region.height };
+        for (int i = 0; i < 4; i++) {
+            if (rect.Has(keys[i])) {
+                *fields[i] = rect.Get(keys[i]).As<Napi::Number>().Int32Value();
+            }
+        }
+        if (cfg.region.IsEmpty() && (cfg.region.width != 0 || cfg.region.height != 0)) {
+            error = "region width and height must be positive";
+            return false;
+        }
+    }
+    if (config.Has("scaleFilter")) {
+        std::string filter_name = config.Get("scaleFilter").As<Napi::String>().Utf8Value();
+        if (!ParseScaleFilter(filter_name, cfg.scale_filter)) {
+            error = "Unsupported scale filter: " + filter_name;
+            return false;
+        }
+    }
+    if (config.Has("cursor")) {
+        cfg.cursor = config.Get("cursor").As<Napi::Boolean>().Value();
+    }
+    if (config.Has("adaptive")) {
+        cfg.adaptive = config.Get("adaptive").As<Napi::Boolean>().Value();
+    }
+    if (config.Has("minFps")) {
+        cfg.scheduler_config.min_fps = config.Get("minFps").As<Napi::Number>().Int32Value();
+    }
+    if (config.Has("idleHoldMs")) {
+        cfg.scheduler_config.idle_hold_ms = config.Get("idleHoldMs").As<Napi::Number>().Int32Value();
+    }
+    if (config.Has("motionThreshold")) {
+        cfg.scheduler_config.motion_threshold = config.Get("motionThreshold").As<Napi::Number>().DoubleValue();
+    }
+    cfg.source_options.fps = cfg.fps;
+    cfg.scheduler_config.max_fps = cfg.fps;
+    cfg.scheduler_config.min_fps = std::min(cfg.scheduler_config.min_fps, cfg.fps);
+
+    // Сумісність: без codec енкодер вмикається при bitrate > 0
+    if (cfg.codec.empty()) {
+        cfg.codec = cfg.bitrate > 0 ? "h264" : "bgra";
+    }
+    if (cfg.codec != "bgra" && cfg.codec != "h264" && cfg.codec != "delta" && cfg.codec != "jpeg" &&
+        cfg.codec != "tile") {
+        error = "Unsupported codec: " + cfg.codec;
+        return false;
+    }
+    return true;
+}
+
+// Виходи для захоплення. Без outputs/stitch монітори не перелічуються - лише output.
+static bool SelectOutputs(const CaptureConfig& cfg, std::vector<CaptureOutputInfo>& selected,
+                          std::string& error) {
+    selected.clear();
+    if (!cfg.all_outputs && !cfg.stitch && cfg.outputs.size() <= 1) {
+        CaptureOutputInfo info;
+        info.index = cfg.outputs.empty() ? cfg.source_options.output : cfg.outputs[0];
+        selected.push_back(info);
+        return true;
+    }
+
+    std::vector<CaptureOutputInfo> available;
+    if (!EnumerateCaptureOutputs(cfg.source_options, available, error)) {
+        return false;
+    }
+    if (cfg.all_outputs || cfg.outputs.empty()) {
+        // stitch без списку - увесь робочий стіл
+        selected = available;
+    }
+    for (int index : cfg.outputs) {
+        if (cfg.all_outputs) {
+            break;
+        }
+        auto found = std::find_if(available.begin(), available.end(),
+                                  [index](const CaptureOutputInfo& info) { return info.index == index; });
+        if (found == available.end()) {
+            error = "Output not found: " + std::to_string(index);
+            return false;
+        }
+        for (const CaptureOutputInfo& info : selected) {
+            if (info.index == index) {
+                error = "Duplicate output: " + std::to_string(index);
+                return false;
+            }
+        }
+        selected.push_back(*found);
+    }
+
+    if (selected.empty() || (int)selected.size() > MultiOutputCapture::kMaxOutputs) {
+        error = "Expected 1.." + std::to_string(MultiOutputCapture::kMaxOutputs) + " outputs";
+        return false;
+    }
+    return true;
+}
+
+// Склеєне полотно: окреме джерело на кожен вихід, розміщене за координатами робочого столу
+static std::unique_ptr<CaptureSource> CreateStitchedSource(const CaptureConfig& cfg,
+                                                           const std::vector<CaptureOutputInfo>& outputs,
+                                                           std::string& error) {
+    std::unique_ptr<MultiOutputCapture> stitched(new MultiOutputCapture());
+    for (const CaptureOutputInfo& info : outputs) {
+        CaptureSourceOptions options = cfg.source_options;
+        options.output = info.index;
+        std::unique_ptr<CaptureSource> source = CreateCaptureSource(options, error);
+        if (!source) {
+            return nullptr;
+        }
+        stitched->AddOutput(std::move(source), info);
+    }
+    return std::unique_ptr<CaptureSource>(std::move(stitched));
+}
+
+// Опис виходу (монітора) для JS
+static Napi::Object OutputInfoToJs(Napi::Env env, const CaptureOutputInfo& info) {
+    Napi::Object output = Napi::Object::New(env);
+    output.Set("index", Napi::Number::New(env, info.index));
+    output.Set("name", Napi::String::New(env, info.name));
+    output.Set("x", Napi::Number::New(env, info.x));
+    output.Set("y", Napi::Number::New(env, info.y));
+    output.Set("width", Napi::Number::New(env, info.width));
+    output.Set("height", Napi::Number::New(env, info.height));
+    output.Set("primary", Napi::Boolean::New(env, info.primary));
+    return output;
+}
+
+// Ініціалізувати сесію з уже створеним джерелом. Сесія ще не видима іншим
+// потокам, тому mutex не потрібен; при помилці викликач звільняє сесію.
+static bool InitializeSession(const CaptureConfig& cfg, int threads, std::unique_ptr<CaptureSource> source,
+                              CaptureSession& session, std::string& error) {
+    // Пул потоків створюється один раз і живе до stopCapture/cleanup
+    session.worker_pool = std::make_unique<WorkerPool>();
+    if (!session.worker_pool->Initialize(threads)) {
+        error = "Failed to start worker threads";
+        return false;
+    }
+
+    session.screen_capture = std::move(source);
+    session.screen_capture->SetWorkerPool(session.worker_pool.get());
+    if (!session.screen_capture->SetRegion(cfg.region)) {
+        error = std::string("Capture region is not supported by backend: ") +
+                session.screen_capture->GetName();
+        return false;
+    }
+    if (cfg.cursor) {
+        session.cursor = std::make_shared<CursorTracker>();
+        session.screen_capture->SetCursorTracker(session.cursor.get());
+    }
+
+    // Ініціалізувати захоплення екрану
+    if (!session.screen_capture->Initialize(cfg.width, cfg.height)) {
+        error = session.screen_capture->GetLastError();
+        return false;
+    }
+
+    // Планувальник міряє зміни на кадрі джерела (до масштабу)
+    if (cfg.adaptive && cfg.fps > 0) {
+        session.scheduler = std::make_shared<CaptureScheduler>();
+        session.change_detector = std::make_unique<ChangeDetector>();
+        if (!session.scheduler->Configure(cfg.scheduler_config) ||
+            !session.change_detector->Initialize(session.screen_capture->GetWidth(),
+                                                 session.screen_capture->GetHeight())) {
+            error = "Invalid adaptive capture configuration";
+            return false;
+        }
+    }
+    session.screen_capture->SetAcquireTimeout(GetSyncAcquireTimeout(session));
+
+    // Бекенди DXGI / X11 віддають кадр у розмірі екрану - width/height
+    // досягаються масштабом (для h264 - разом з конвертацією в NV12)
+    int source_width = session.screen_capture->GetWidth();
+    int source_height = session.screen_capture->GetHeight();
+    int actual_width = 0;
+    int actual_height = 0;
+    ComputeOutputSize(source_width, source_height, cfg.width, cfg.height, actual_width, actual_height);
+    bool scaled = actual_width != source_width || actual_height != source_height;
+    session.codec = cfg.codec;
+    session.width = actual_width;
+    session.height = actual_height;
+    session.source_width = source_width;
+    session.source_height = source_height;
+
+    // Ініціалізувати енкодер ТІЛЬКИ ДЛЯ codec = h264
+    if (cfg.codec == "h264") {
+        session.encoder = CreateVideoEncoder(cfg.encoder_backend, error);
+        if (!session.encoder) {
+            return false;
+        }
+
+        VideoEncoderConfig encoder_config = cfg.encoder_config;
+        encoder_config.width = actual_width;
+        encoder_config.height = actual_height;
+        encoder_config.bitrate = cfg.bitrate;
+        encoder_config.fps = cfg.fps;
+        encoder_config.keyframe_interval = cfg.keyframe_interval;
+        encoder_config.use_hardware = cfg.use_hardware;
+        encoder_config.threads = session.worker_pool->GetThreadCount();
+        session.encoder->SetWorkerPool(session.worker_pool.get());
+        session.encoder->SetSourceSize(source_width, source_height, cfg.scale_filter);
+        session.h264_parser = std::make_unique<H264Parser>();
+        session.h264_pts_base_ms = -1.0;
+
+        if (!session.encoder->Initialize(encoder_config)) {
+            error = session.encoder->GetLastError();
+            return false;
+        }
+    } else if (scaled) {
+        // Енкодер вимкнений - RAW, дельти плиток або JPEG масштабуються окремо
+        session.scaler = std::make_unique<FrameScaler>();
+        session.scaler->SetWorkerPool(session.worker_pool.get());
+        if (!session.scaler->Initialize(source_width, source_height, actual_width, actual_height,
+                                        cfg.scale_filter)) {
+            error = "Failed to initialize frame scaler";
+            return false;
+        }
+    }
+
+    if (cfg.codec == "delta") {
+        session.delta_encoder = std::make_unique<DeltaEncoder>();
+        if (!session.delta_encoder->Initialize(actual_width, actual_height, cfg.tile_size,
+                                               cfg.keyframe_interval, cfg.move_detection,
+                                               (size_t)std::max(0.0, cfg.tile_cache_max_bytes))) {
+            error = session.delta_encoder->GetLastError();
+            return false;
+        }
+    }
+
+    if (cfg.codec == "jpeg") {
+        session.jpeg_encoder = std::make_unique<JpegEncoder>();
+        session.jpeg_encoder->SetWorkerPool(session.worker_pool.get());
+        if (!session.jpeg_encoder->Initialize(actual_width, actual_height, cfg.jpeg_quality,
+                                              cfg.jpeg_chroma420)) {
+            error = session.jpeg_encoder->GetLastError();
+            return false;
+        }
+    }
+
+    if (cfg.codec == "tile") {
+        session.tile_encoder = std::make_unique<TileEncoder>();
+        if (!session.tile_encoder->Initialize(actual_width, actual_height, cfg.tile_size, cfg.jpeg_quality,
+                                              cfg.jpeg_chroma420)) {
+            error = session.tile_encoder->GetLastError();
+            return false;
+        }
+    }
+
+    // Кодеки з міжкадровими залежностями: новий глядач без групи чекав би наступного keyframe
+    if (cfg.gop_cache && (cfg.codec == "h264" || cfg.codec == "delta") && cfg.gop_cache_max_bytes > 0) {
+        int max_frames = cfg.gop_cache_max_frames > 0 ? cfg.gop_cache_max_frames : cfg.keyframe_interval + 1;
+        session.gop_cache = std::make_unique<GopCache>((size_t)cfg.gop_cache_max_bytes, max_frames);
+    }
+
+    // Розмір вихідного буфера залежить від кодека
+    size_t frame_bytes = (size_t)actual_width * actual_height * 4;
+    size_t output_bytes = frame_bytes;
+    if (cfg.codec == "h264") {
+        output_bytes = (size_t)actual_width * actual_height * 3 / 2;
+    } else if (cfg.codec == "delta") {
+        output_bytes = session.delta_encoder->GetMaxPacketSize();
+    } else if (cfg.codec == "jpeg") {
+        output_bytes = session.jpeg_encoder->GetMaxOutputSize();
+    } else if (cfg.codec == "tile") {
+        output_bytes = session.tile_encoder->GetMaxPacketSize();
+    }
+
+    size_t source_bytes = (size_t)source_width * source_height * 4;
+    session.frame_pool = FramePool::Create(output_bytes, cfg.pool_depth);
+    // Власники external Buffer - по одному на кожен буфер пулу, що може бути в JS
+    if (!session.frame_pool ||
+        ((cfg.codec != "bgra" || scaled) && !session.capture_buffer.Resize(source_bytes)) ||
+        (session.scaler && cfg.codec != "bgra" && !session.scaled_buffer.Resize(frame_bytes)) ||
+        !GetBufferArena().Reserve(sizeof(PooledBufferOwner), cfg.pool_depth)) {
+        error = "Failed to allocate frame buffers";
+        return false;
+    }
+    return true;
+}
+
+// Параметри сесії для JS (результат initialize і елементи outputs)
+static void SetSessionResult(Napi::Env env, const CaptureConfig& cfg, const CaptureSession& session,
+                             Napi::Object result) {
+    int source_width = session.screen_capture->GetWidth();
+    int source_height = session.screen_capture->GetHeight();
+    result.Set("output", Napi::Number::New(env, session.output));
+    result.Set("width", Napi::Number::New(env, session.width));
+    result.Set("height", Napi::Number::New(env, session.height));
+    result.Set("sourceWidth", Napi::Number::New(env, source_width));
+    result.Set("sourceHeight", Napi::Number::New(env, source_height));
+    if (session.width != source_width || session.height != source_height) {
+        result.Set("scaleFilter", Napi::String::New(env, GetScaleFilterName(cfg.scale_filter)));
+    }
+    if (!cfg.region.IsEmpty()) {
+        // Сторони регіону після округлення до парних
+        Napi::Object region = Napi::Object::New(env);
+        region.Set("x", Napi::Number::New(env, cfg.region.x));
+        region.Set("y", Napi::Number::New(env, cfg.region.y));
+        region.Set("width", Napi::Number::New(env, source_width));
+        region.Set("height", Napi::Number::New(env, source_height));
+        result.Set("region", region);
+    }
+    result.Set("encoderEnabled", Napi::Boolean::New(env, session.encoder != nullptr));
+    if (session.encoder) {
+        result.Set("encoder", Napi::String::New(env, session.encoder->GetName()));
+    }
+    result.Set("threads", Napi::Number::New(env, session.worker_pool->GetThreadCount()));
+    result.Set("codec", Napi::String::New(env, session.codec));
+    result.Set("backend", Napi::String::New(env, session.screen_capture->GetName()));
+    result.Set("poolDepth", Napi::Number::New(env, session.frame_pool->GetDepth()));
+    result.Set("gopCache", Napi::Boolean::New(env, session.gop_cache != nullptr));
+    if (session.delta_encoder) {
+        // Слоти кешу плиток отримувача (0 - кеш вимкнено)
+        result.Set("tileCacheSlots", Napi::Number::New(env, session.delta_encoder->GetTileCacheSlots()));
+    }
+    result.Set("cursor", Napi::Boolean::New(env, session.cursor != nullptr));
+    auto* recording = dynamic_cast<const RecordingCapture*>(session.screen_capture.get());
+    if (recording) {
+        result.Set("recordPath", Napi::String::New(env, recording->GetPath()));
+    }
+    result.Set("adaptive", Napi::Boolean::New(env, session.scheduler != nullptr));
+    if (session.scheduler) {
+        result.Set("minFps", Napi::Number::New(env, cfg.scheduler_config.min_fps));
+    }
+
+    // Склеєне полотно: де на кадрі кожен монітор
+    auto* stitched = dynamic_cast<const MultiOutputCapture*>(session.screen_capture.get());
+    if (stitched) {
+        Napi::Array layout = Napi::Array::New(env, stitched->GetOutputCount());
+        for (int i = 0; i < stitched->GetOutputCount(); i++) {
+            layout.Set((uint32_t)i, OutputInfoToJs(env, stitched->GetOutputInfo(i)));
+        }
+        result.Set("layout", layout);
+    }
+}
+
+// Ініціалізація захоплення за конфігурацією з JS (викликається під g_mutex).
+// Результат (success/error/розміри) записується в result: поля першої сесії
+// і масив outputs з кожною сесією.
+static bool InitializeCapture(Napi::Env env, Napi::Object config, Napi::Object result) {
+    CaptureConfig cfg;
+    std::vector<CaptureOutputInfo> outputs;
+    std::string error;
+    if (!ParseCaptureConfig(config, cfg, error) || !SelectOutputs(cfg, outputs, error)) {
+        result.Set("success", Napi::Boolean::New(env, false));
+        result.Set("error", Napi::String::New(env, error));
+        return false;
+    }
+    // Регіон задається в координатах одного виходу
+    if (!cfg.region.IsEmpty() && (cfg.stitch || outputs.size() > 1)) {
+        result.Set("success", Napi::Boolean::New(env, false));
+        result.Set("error", Napi::String::New(env, "region requires a single output"));
+        return false;
+    }
+    // Запис - один файл на одне джерело (склеєне полотно пишеться цілком)
+    if (!cfg.record_path.empty() && !cfg.stitch && outputs.size() > 1) {
+        result.Set("success", Napi::Boolean::New(env, false));
+        result.Set("error", Napi::String::New(env, "recordPath requires a single session"));
+        return false;
+    }
+
+    // Повторна ініціалізація - спочатку звільнити попередні об'єкти
+    ReleaseCaptureObjects();
+
+    // Склеєне полотно - одна сесія, інакше по сесії (і пулу потоків) на вихід.
+    // Ядра діляться між сесіями, щоб пули не конкурували за ті самі ядра.
+    const int session_count = cfg.stitch ? 1 : (int)outputs.size();
+    int threads = cfg.threads;
+    if (session_count > 1) {
+        int total = threads > 0 ? threads : (int)std::thread::hardware_concurrency();
+        threads = std::max(1, total / session_count);
+    }
+
+    for (int i = 0; i < session_count; i++) {
+        auto session = std::make_shared<CaptureSession>();
+        std::unique_ptr<CaptureSource> source;
+        if (cfg.stitch) {
+            session->output = -1;
+            source = CreateStitchedSource(cfg, outputs, error);
+        } else {
+            CaptureSourceOptions options = cfg.source_options;
+            options.output = outputs[i].index;
+            session->output = options.output;
+            source = CreateCaptureSource(options, error);
+        }
+        if (source && !cfg.record_path.empty()) {
+            source.reset(new RecordingCapture(std::move(source), cfg.record_path, cfg.record_delta));
+        }
+
+        if (!source || !InitializeSession(cfg, threads, std::move(source), *session, error)) {
+            ReleaseSession(*session);
+            ReleaseCaptureObjects();
+            if (session_count > 1) {
+                error = "Output " + std::to_string(outputs[i].index) + ": " + error;
+            }
+            result.Set("success", Napi::Boolean::New(env, false));
+            result.Set("error", Napi::String::New(env, error));
+            return false;
+        }
+        g_sessions.push_back(session);
+    }
+
+    Napi::Array sessions = Napi::Array::New(env, g_sessions.size());
+    for (size_t i = 0; i < g_sessions.size(); i++) {
+        Napi::Object entry = Napi::Object::New(env);
+        SetSessionResult(env, cfg, *g_sessions[i], entry);
+        sessions.Set((uint32_t)i, entry);
+    }
+    result.Set("success", Napi::Boolean::New(env, true));
+    SetSessionResult(env, cfg, *g_sessions.front(), result);
+    result.Set("stitched", Napi::Boolean::New(env, cfg.stitch));
+    result.Set("outputs", sessions);
+    return true;
+}
+
+static void StopCaptureLoopInternal();
+
+// Ініціалізація захоплення екрану
+Napi::Value Initialize(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "Expected object with configuration").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Object config = info[0].As<Napi::Object>();
+    Napi::Object result = Napi::Object::New(env);
+
+    // Повторна ініціалізація зупиняє асинхронний цикл
+    StopCaptureLoopInternal();
+
+    try {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        InitializeCapture(env, config, result);
+    } catch (const std::exception& e) {
+        result.Set("success", Napi::Boolean::New(env, false));
+        result.Set("error", Napi::String::New(env, e.what()));
+    }
+
+    return result;
+}
+
+// Отримання інформації про екран
+Napi::Value GetScreenInfo(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Object screenInfo = Napi::Object::New(env);
+
+    try {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        std::shared_ptr<CaptureSession> session = FindSession(GetOutputArgument(info, 0));
+
+        if (session) {
+            std::lock_guard<std::mutex> session_lock(session->mutex);
+            screenInfo.Set("width", Napi::Number::New(env, session->screen_capture->GetWidth()));
+            screenInfo.Set("height", Napi::Number::New(env, session->screen_capture->GetHeight()));
+            screenInfo.Set("backend", Napi::String::New(env, session->screen_capture->GetName()));
+            screenInfo.Set("output", Napi::Number::New(env, session->output));
+            screenInfo.Set("initialized", Napi::Boolean::New(env, true));
+        } else {
+            // Створити тимчасове джерело (бекенд платформи) для отримання інформації
+            std::string source_error;
+            std::unique_ptr<CaptureSource> temp_capture =
+                CreateCaptureSource(CaptureSourceOptions(), source_error);
+            if (temp_capture && temp_capture->Initialize(0, 0)) {
+                screenInfo.Set("width", Napi::Number::New(env, temp_capture->GetWidth()));
+                screenInfo.Set("height", Napi::Number::New(env, temp_capture->GetHeight()));
+                screenInfo.Set("backend", Napi::String::New(env, temp_capture->GetName()));
+                screenInfo.Set("initialized", Napi::Boolean::New(env, false));
+            } else {
+                Napi::Error::New(env, "Failed to get screen info").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+        }
+        
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    return screenInfo;
+}
+
+// Перелік виходів (моніторів): getOutputs({ backend, display, syntheticOutputs, replayPath })
+Napi::Value GetOutputs(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    CaptureSourceOptions options;
+    if (info.Length() > 0 && info[0].IsObject()) {
+        Napi::Object config = info[0].As<Napi::Object>();
+        if (config.Has("backend")) {
+            options.backend = config.Get("backend").As<Napi::String>().Utf8Value();
+        }
+        if (config.Has("display")) {
+            options.display = config.Get("display").As<Napi::String>().Utf8Value();
+        }
+        if (config.Has("syntheticOutputs")) {
+            options.synthetic_outputs = config.Get("syntheticOutputs").As<Napi::Number>().Int32Value();
+        }
+        if (config.Has("replayPath")) {
+            options.replay_path = config.Get("replayPath").As<Napi::String>().Utf8Value();
+        }
+    }
+
+    std::vector<CaptureOutputInfo> outputs;
+    std::string error;
+    if (!EnumerateCaptureOutputs(options, outputs, error)) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Array result = Napi::Array::New(env, outputs.size());
+    for (size_t i = 0; i < outputs.size(); i++) {
+        result.Set((uint32_t)i, OutputInfoToJs(env, outputs[i]));
+    }
+    return result;
+}
+
+// Заповнити об'єкт результату кадру для JS
+static void SetFrameResult(Napi::Env env, Napi::Object result, const char* codec, bool keyframe,
+                           bool has_delta_info, int tiles, int moves, double convert_ms) {
+    result.Set("success", Napi::Boolean::New(env, true));
+    result.Set("codec", Napi::String::New(env, codec));
+    if (has_delta_info) {
+        result.Set("keyframe", Napi::Boolean::New(env, keyframe));
+        result.Set("tiles", Napi::Number::New(env, tiles));
+        result.Set("moves", Napi::Number::New(env, moves));
+    }
+    if (convert_ms >= 0) {
+        result.Set("convertTimeMs", Napi::Number::New(env, convert_ms));
+    }
+}
+
+// Структура h264 кадру: keyframe, pts і NAL одиниці (зміщення в data)
+static void SetH264Result(Napi::Env env, Napi::Object result, const H264Packet& packet) {
+    result.Set("keyframe", Napi::Boolean::New(env, packet.keyframe));
+    result.Set("pts", Napi::Number::New(env, (double)packet.pts));
+    result.Set("hasParameterSets", Napi::Boolean::New(env, packet.has_parameter_sets));
+
+    Napi::Array nals = Napi::Array::New(env, packet.nal_count);
+    for (int i = 0; i < packet.nal_count; i++) {
+        Napi::Object nal = Napi::Object::New(env);
+        nal.Set("type", Napi::Number::New(env, packet.nals[i].type));
+        nal.Set("offset", Napi::Number::New(env, packet.nals[i].offset));
+        nal.Set("size", Napi::Number::New(env, packet.nals[i].size));
+        nals.Set((uint32_t)i, nal);
+    }
+    result.Set("nals", nals);
+    if (packet.truncated) {
+        result.Set("nalsTruncated", Napi::Boolean::New(env, true));
+    }
+}
+
+// Захоплення одного кадру: captureFrame(output?) - за замовчуванням перша сесія
+Napi::Value CaptureFrame(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Object result = Napi::Object::New(env);
+
+    try {
+        std::lock_guard<std::mutex> lock(g_mutex);
+
+        {
+            std::lock_guard<std::mutex> loop_lock(g_loop_mutex);
+            if (!g_capture_loops.empty()) {
+                result.Set("success", Napi::Boolean::New(env, false));
+                result.Set("error", Napi::String::New(env, "CAPTURE_LOOP_RUNNING"));
+                return result;
+            }
+        }
+
+        std::shared_ptr<CaptureSession> found = FindSession(GetOutputArgument(info, 0));
+        if (!found) {
+            result.Set("success", Napi::Boolean::New(env, false));
+            result.Set("error", Napi::String::New(env,
+                g_sessions.empty() ? "Not initialized" : "OUTPUT_NOT_CAPTURED"));
+            return result;
+        }
+        CaptureSession& session = *found;
+        std::lock_guard<std::mutex> session_lock(session.mutex);
+        result.Set("output", Napi::Number::New(env, session.output));
+
+        auto capture_start = CaptureStats::Clock::now();
+        EncodedFrame frame;
+        frame.timestamp_ms = GetSteadyTimeMs();
+        bool captured = CaptureAndEncode(session, frame, true);
+        // Коли викликати captureFrame() наступного разу (адаптивна частота)
+        if (session.scheduler) {
+            result.Set("nextCaptureMs", Napi::Number::New(env, session.scheduler->GetIntervalMs()));
+        }
+        if (!captured) {
+            result.Set("success", Napi::Boolean::New(env, false));
+            result.Set("error", Napi::String::New(env, frame.error));
+            return result;
+        }
+
+        SetFrameResult(env, result, frame.codec, frame.keyframe, frame.has_delta_info,
+                       frame.tiles, frame.moves, frame.convert_ms);
+
+        // Енкодеру потрібно більше кадрів або нічого не змінилося - даних немає
+        if (frame.size == 0) {
+            result.Set("encoded", Napi::Boolean::New(env, false));
+            return result;
+        }
+
+        result.Set("encoded", Napi::Boolean::New(env, std::string(frame.codec) != "bgra"));
+        result.Set("data", ToJsBuffer(env, session, frame.out, frame.size));
+        result.Set("size", Napi::Number::New(env, frame.size));
+        result.Set("pooled", Napi::Boolean::New(env, frame.out.pooled));
+        if (frame.has_h264_info) {
+            SetH264Result(env, result, frame.h264);
+        }
+        GetCaptureStats().RecordSince(StatStage::Latency, capture_start);
+
+    } catch (const std::exception& e) {
+        result.Set("success", Napi::Boolean::New(env, false));
+        result.Set("error", Napi::String::New(env, e.what()));
+    }
+
+    return result;
+}
+
+// Зупинити асинхронні цикли всіх сесій (не можна викликати під mutex сесії)
+static void StopCaptureLoopInternal() {
+    std::lock_guard<std::mutex> loop_lock(g_loop_mutex);
+    if (g_capture_loops.empty()) {
+        return;
+    }
+
+    // Спочатку джерело, потім стадії - вони доставляють кадри в зупинений
+    // цикл, який одразу повертає їх у пул
+    for (SessionLoop& entry : g_capture_loops) {
+        entry.loop->Stop();
+        if (entry.pipeline) {
+            entry.pipeline->Stop();
+        }
+    }
+    std::vector<SessionLoop> stopped;
+    stopped.swap(g_capture_loops);
+    g_loop_tsfn.Release();
+
+    for (SessionLoop& entry : stopped) {
+        CaptureSession& session = *entry.session;
+        std::lock_guard<std::mutex> lock(session.mutex);
+        if (session.screen_capture) {
+            session.screen_capture->SetAcquireTimeout(GetSyncAcquireTimeout(session));
+        }
+    }
+}
+
+static void FillLoopFrame(const EncodedFrame& frame, LoopFrame& loop_frame) {
+    loop_frame.data = frame.out.data;
+    loop_frame.size = frame.size;
+    loop_frame.codec = frame.codec;
+    loop_frame.encoded = std::string(frame.codec) != "bgra";
+    loop_frame.keyframe = frame.keyframe;
+    loop_frame.has_delta_info = frame.has_delta_info;
+    loop_frame.tiles = frame.tiles;
+    loop_frame.moves = frame.moves;
+    loop_frame.has_h264_info = frame.has_h264_info;
+    if (frame.has_h264_info) {
+        loop_frame.h264 = frame.h264;
     }
+}
 
-    Napi::Object config = info[0].As<Napi::Object>();
-    Napi::Object result = Napi::Object::New(env);
+// Стадії конвеєра для h264 (convert -> encode) або delta/jpeg/tile ([scale ->] encode).
+// Масштаб для h264 злитий зі стадією convert.
+// Потік циклу лише захоплює кадр, тож пропускна здатність обмежена
+// найповільнішою стадією, а не сумою всіх.
+static std::vector<FramePipeline::Stage> BuildPipelineStages(CaptureSession& session) {
+    std::vector<FramePipeline::Stage> stages;
 
-    try {
-        std::lock_guard<std::mutex> lock(g_mutex);
+    if (session.scaler) {
+        stages.push_back({ "scale", [&session](PipelineFrame& frame) {
+            int stride = session.screen_capture->GetWidth() * 4;
+            if (!ScaleCapturedFrame(session, frame.capture.data(), stride, frame.scratch.data())) {
+                return false;
+            }
+            frame.output.convert_ms = session.scaler->GetLastScaleTimeMs();
+            return true;
+        } });
+    }
 
-        // Отримати параметри
-        int width = 0;
-        int height = 0;
-        int bitrate = 2000000;
-        int fps = 30;
-        bool useHardware = true;
+    if (session.encoder) {
+        stages.push_back({ "convert", [&session](PipelineFrame& frame) {
+            int stride = session.screen_capture->GetWidth() * 4;
+            if (!session.encoder->ConvertToNV12(frame.capture.data(), stride, frame.scratch.data())) {
+                return false;
+            }
+            frame.output.convert_ms = session.encoder->GetLastConvertTimeMs();
+            return true;
+        } });
+    }
 
-        if (config.Has("width")) {
-            width = config.Get("width").As<Napi::Number>().Int32Value();
+    stages.push_back({ "encode", [&session](PipelineFrame& frame) {
+        EncodedFrame encoded;
+        encoded.timestamp_ms = frame.output.timestamp_ms;
+        const uint8_t* nv12 = session.encoder ? frame.scratch.data() : nullptr;
+        const uint8_t* bgra = session.scaler ? frame.scratch.data() : frame.capture.data();
+        if (session.delta_encoder && !frame.moves.empty()) {
+            session.delta_encoder->SetMoveHints(frame.moves);
         }
-        if (config.Has("height")) {
-            height = config.Get("height").As<Napi::Number>().Int32Value();
+        bool ok = EncodeCapturedFrame(session, bgra, GetEncoderInputStride(session), nv12, encoded, false);
+        // Буфер захоплення слота більше не потрібен - споживачі отримують і кадри без змін
+        BroadcastCapturedFrame(session, frame.capture, frame.output.timestamp_ms);
+        if (!ok || encoded.size == 0) {
+            return false;
         }
-        if (config.Has("bitrate")) {
-            bitrate = config.Get("bitrate").As<Napi::Number>().Int32Value();
+        FillLoopFrame(encoded, frame.output);
+        return true;
+    } });
+
+    return stages;
+}
+
+// Вичитати чергу циклу і передати кадри в JS (JS потік, виклик з ThreadSafeFunction)
+static void DeliverLoopFrames(Napi::Env env, Napi::Function on_frame,
+                              const std::shared_ptr<CaptureLoop>& loop,
+                              const std::shared_ptr<FramePool>& pool, int output) {
+    loop->BeginDrain();
+
+    LoopFrame frame;
+    while (loop->Pop(frame)) {
+        Napi::Object result = Napi::Object::New(env);
+        SetFrameResult(env, result, frame.codec, frame.keyframe, frame.has_delta_info,
+                       frame.tiles, frame.moves, frame.convert_ms);
+        result.Set("encoded", Napi::Boolean::New(env, frame.encoded));
+        {
+            ScopedStageTimer timer(StatStage::Handoff);
+            result.Set("data", WrapPoolBuffer(env, pool, frame.data, frame.size));
         }
-        if (config.Has("fps")) {
-            fps = config.Get("fps").As<Napi::Number>().Int32Value();
+        result.Set("size", Napi::Number::New(env, frame.size));
+        result.Set("pooled", Napi::Boolean::New(env, true));
+        result.Set("timestamp", Napi::Number::New(env, frame.timestamp_ms));
+        result.Set("sequence", Napi::Number::New(env, (double)frame.sequence));
+        result.Set("output", Napi::Number::New(env, output));
+        if (frame.has_h264_info) {
+            SetH264Result(env, result, frame.h264);
         }
-        if (config.Has("useHardware")) {
-            useHardware = config.Get("useHardware").As<Napi::Boolean>().Value();
+
+        // timestamp_ms - steady clock на момент початку захоплення
+        CaptureStats& stats = GetCaptureStats();
+        stats.RecordMs(StatStage::Latency, GetSteadyTimeMs() - frame.timestamp_ms);
+        stats.Add(StatCounter::BytesOut, frame.size);
+
+        on_frame.Call({ result });
+        if (env.IsExceptionPending()) {
+            // Виняток у колбеку - решта кадрів буде доставлена наступного разу
+            break;
         }
+    }
+}
 
-        // Створити об'єкти
-        g_screen_capture = std::make_unique<ScreenCapture>();
-        g_encoder = std::make_unique<H264Encoder>();
+// Параметри асинхронного циклу (спільні для всіх сесій)
+struct LoopOptions {
+    int fps = 30;
+    int max_queue = 2;          // Кадри, що очікують JS; при переповненні відкидаються найстаріші
+    bool use_pipeline = true;
+    int pipeline_slots = 3;     // Кадри одночасно в конвеєрі (capture + convert + encode)
+};
 
-        // Ініціалізувати захоплення екрану
-        if (!g_screen_capture->Initialize(width, height)) {
-            result.Set("success", Napi::Boolean::New(env, false));
-            result.Set("error", Napi::String::New(env, g_screen_capture->GetLastError()));
-            g_screen_capture.reset();
-            g_encoder.reset();
-            return result;
+// Запустити цикл (і конвеєр) однієї сесії на власних потоках (під g_loop_mutex)
+static bool StartSessionLoop(const std::shared_ptr<CaptureSession>& session_ptr, const LoopOptions& options,
+                             SessionLoop& entry, std::string& error) {
+    CaptureSession& session = *session_ptr;
+    std::shared_ptr<FramePool> pool;
+    std::shared_ptr<CaptureScheduler> scheduler;
+    int frame_stride = 0;
+    size_t frame_bytes = 0;
+    size_t scratch_bytes = 0;
+    bool use_pipeline;
+    {
+        std::lock_guard<std::mutex> lock(session.mutex);
+        pool = session.frame_pool;
+        scheduler = session.scheduler;
+        frame_stride = session.screen_capture->GetWidth() * 4;
+        frame_bytes = (size_t)frame_stride * session.screen_capture->GetHeight();
+        // scratch - NV12 (h264) або масштабований BGRA кадр (delta/jpeg/tile)
+        if (session.encoder) {
+            scratch_bytes = session.encoder->GetNV12Size();
+        } else if (session.scaler) {
+            scratch_bytes = (size_t)session.scaler->GetWidth() * session.scaler->GetHeight() * 4;
         }
+        // RAW BGRA захоплюється одразу у вихідний буфер - стадій немає
+        use_pipeline = options.use_pipeline &&
+                       (session.encoder || session.delta_encoder || session.jpeg_encoder ||
+                        session.tile_encoder);
 
-        // Ініціалізувати енкодер ТІЛЬКИ ЯКЩО bitrate > 0
-        int actual_width = g_screen_capture->GetWidth();
-        int actual_height = g_screen_capture->GetHeight();
-        
-        if (bitrate > 0) {
-            if (!g_encoder->Initialize(actual_width, actual_height, bitrate, fps, useHardware)) {
-                result.Set("success", Napi::Boolean::New(env, false));
-                result.Set("error", Napi::String::New(env, g_encoder->GetLastError()));
-                g_screen_capture.reset();
-                g_encoder.reset();
-                return result;
+        // Цикл сам задає темп - AcquireNextFrame не повинен блокувати
+        session.screen_capture->SetAcquireTimeout(0);
+    }
+
+    auto loop = std::make_shared<CaptureLoop>();
+    std::shared_ptr<FramePipeline> pipeline;
+    CaptureLoop* loop_ptr = loop.get();
+
+    // Цикл і конвеєр зупиняються раніше, ніж звільняється сесія (SessionLoop
+    // тримає її), тому лямбди можуть тримати посилання на неї
+    CaptureLoop::ProduceFunc produce;
+    if (use_pipeline) {
+        pipeline = std::make_shared<FramePipeline>();
+        // Конвеєр зупиняється раніше за цикл, тому sink може тримати сирий вказівник
+        auto sink = [loop_ptr](PipelineFrame& frame) {
+            loop_ptr->Deliver(frame.output);
+        };
+        if (!pipeline->Start((size_t)options.pipeline_slots, frame_bytes, scratch_bytes,
+                             BuildPipelineStages(session), sink)) {
+            error = pipeline->GetLastError();
+            return false;
+        }
+
+        // Потік циклу - стадія capture: кадр пишеться у вільний слот конвеєра
+        FramePipeline* pipeline_ptr = pipeline.get();
+        produce = [&session, pipeline_ptr, scheduler, frame_stride](LoopFrame& loop_frame) {
+            PipelineFrame* slot = pipeline_ptr->AcquireSlot();
+            if (!slot) {
+                // Усі слоти в стадіях - кадр цього інтервалу втрачено, темп знижується
+                GetCaptureStats().Add(StatCounter::FramesDropped);
+                if (scheduler) {
+                    scheduler->ReportCongestion();
+                }
+                return ProduceResult::Idle;
             }
-            result.Set("encoderEnabled", Napi::Boolean::New(env, true));
-        } else {
-            // Енкодер вимкнений - відправляємо RAW
-            g_encoder.reset();
-            result.Set("encoderEnabled", Napi::Boolean::New(env, false));
+
+            bool captured;
+            {
+                std::lock_guard<std::mutex> lock(session.mutex);
+                captured = session.screen_capture &&
+                           session.screen_capture->CaptureFrame(slot->capture.data(), frame_stride);
+                if (session.screen_capture) {
+                    ReportCaptureToScheduler(session, captured ? slot->capture.data() : nullptr, frame_stride);
+                    // Підказки належать саме цьому кадру - кодер отримає їх у стадії encode
+                    CollectMoveHints(session, slot->moves);
+                }
+            }
+            if (!captured) {
+                GetCaptureStats().Add(StatCounter::FramesSkipped);
+                pipeline_ptr->Cancel(slot);
+                return ProduceResult::Idle;
+            }
+            GetCaptureStats().Add(StatCounter::FramesCaptured);
+
+            slot->output.timestamp_ms = loop_frame.timestamp_ms;
+            slot->output.sequence = loop_frame.sequence;
+            pipeline_ptr->Submit(slot);
+            return ProduceResult::Forwarded;
+        };
+    } else {
+        produce = [&session](LoopFrame& loop_frame) {
+            std::lock_guard<std::mutex> lock(session.mutex);
+
+            // У циклі пул не переповнюється запасним буфером - кадр пропускається
+            EncodedFrame frame;
+            frame.timestamp_ms = loop_frame.timestamp_ms;
+            if (!CaptureAndEncode(session, frame, false) || frame.size == 0) {
+                return ProduceResult::Idle;
+            }
+
+            FillLoopFrame(frame, loop_frame);
+            loop_frame.convert_ms = frame.convert_ms;
+            return ProduceResult::Ready;
+        };
+    }
+
+    Napi::ThreadSafeFunction tsfn = g_loop_tsfn;
+    std::weak_ptr<CaptureLoop> weak_loop = loop;
+    const int output = session.output;
+
+    auto notify = [tsfn, weak_loop, pool, output]() mutable {
+        tsfn.NonBlockingCall([weak_loop, pool, output](Napi::Env call_env, Napi::Function js_callback) {
+            // Цикл міг бути зупинений, поки виклик стояв у черзі
+            if (auto current = weak_loop.lock()) {
+                DeliverLoopFrames(call_env, js_callback, current, pool, output);
+            }
+        });
+    };
+
+    // Кадр, що не дійде до JS (черга переповнена, Stop), повертається в пул
+    auto release = [pool, &session](LoopFrame& loop_frame) {
+        pool->Release(loop_frame.data);
+        if (loop_frame.encoded) {
+            ForceKeyframeAfterDrop(session, loop_frame.codec);
         }
+    };
 
-        result.Set("success", Napi::Boolean::New(env, true));
-        result.Set("width", Napi::Number::New(env, actual_width));
-        result.Set("height", Napi::Number::New(env, actual_height));
-        
+    loop->SetScheduler(scheduler);
+    if (!loop->Start(options.fps, (size_t)options.max_queue, produce, notify, release)) {
+        if (pipeline) {
+            pipeline->Stop();
+        }
+        error = "Failed to start capture loop";
+        return false;
+    }
+
+    entry.session = session_ptr;
+    entry.loop = loop;
+    entry.pipeline = pipeline;
+    return true;
+}
+
+// Запуск асинхронного циклу: захоплення, конвертація і кодування на нативних
+// потоках (окремий цикл і конвеєр на кожен вихід), кадри доставляються
+// в onFrame через ThreadSafeFunction з полем output
+Napi::Value StartCaptureLoop(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsObject() || !info[1].IsFunction()) {
+        Napi::TypeError::New(env, "Expected (config, onFrame)").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Object config = info[0].As<Napi::Object>();
+    Napi::Function on_frame = info[1].As<Napi::Function>();
+    Napi::Object result = Napi::Object::New(env);
+
+    StopCaptureLoopInternal();
+
+    LoopOptions options;
+    if (config.Has("fps")) {
+        options.fps = config.Get("fps").As<Napi::Number>().Int32Value();
+    }
+    if (config.Has("maxQueue")) {
+        options.max_queue = config.Get("maxQueue").As<Napi::Number>().Int32Value();
+    }
+    if (config.Has("pipeline")) {
+        options.use_pipeline = config.Get("pipeline").As<Napi::Boolean>().Value();
+    }
+    if (config.Has("pipelineSlots")) {
+        options.pipeline_slots = config.Get("pipelineSlots").As<Napi::Number>().Int32Value();
+    }
+    if (options.fps <= 0) {
+        options.fps = 30;
+    }
+    if (options.pipeline_slots < 2) {
+        options.pipeline_slots = 2;
+    }
+
+    std::vector<std::shared_ptr<CaptureSession>> sessions;
+    try {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (!InitializeCapture(env, config, result)) {
+            return result;
+        }
+        sessions = g_sessions;
     } catch (const std::exception& e) {
         result.Set("success", Napi::Boolean::New(env, false));
         result.Set("error", Napi::String::New(env, e.what()));
+        return result;
+    }
+
+    std::lock_guard<std::mutex> loop_lock(g_loop_mutex);
+    g_loop_tsfn = Napi::ThreadSafeFunction::New(env, on_frame, "CaptureLoop", 0, 1);
+
+    std::vector<SessionLoop> loops;
+    for (const auto& session : sessions) {
+        SessionLoop entry;
+        std::string error;
+        if (!StartSessionLoop(session, options, entry, error)) {
+            for (SessionLoop& started : loops) {
+                started.loop->Stop();
+                if (started.pipeline) {
+                    started.pipeline->Stop();
+                }
+            }
+            g_loop_tsfn.Release();
+            result.Set("success", Napi::Boolean::New(env, false));
+            result.Set("error", Napi::String::New(env, error));
+            return result;
+        }
+        loops.push_back(entry);
     }
 
+    g_capture_loops = std::move(loops);
+    result.Set("loop", Napi::Boolean::New(env, true));
+    result.Set("pipeline", Napi::Boolean::New(env, g_capture_loops.front().pipeline != nullptr));
     return result;
 }
 
-// Отримання інформації про екран
-Napi::Value GetScreenInfo(const Napi::CallbackInfo& info) {
+Napi::Value StopCaptureLoop(const Napi::CallbackInfo& info) {
+    StopCaptureLoopInternal();
+    return info.Env().Undefined();
+}
+
+// Статистика циклу однієї сесії (під g_loop_mutex)
+static Napi::Object LoopStatsToJs(Napi::Env env, const SessionLoop& entry) {
+    CaptureLoopStats loop_stats = entry.loop->GetStats();
+    Napi::Object stats = Napi::Object::New(env);
+    stats.Set("output", Napi::Number::New(env, entry.session->output));
+    stats.Set("running", Napi::Boolean::New(env, loop_stats.running));
+    stats.Set("fps", Napi::Number::New(env, loop_stats.fps));
+    stats.Set("produced", Napi::Number::New(env, (double)loop_stats.produced));
+    stats.Set("delivered", Napi::Number::New(env, (double)loop_stats.delivered));
+    stats.Set("dropped", Napi::Number::New(env, (double)loop_stats.dropped));
+    stats.Set("idle", Napi::Number::New(env, (double)loop_stats.idle));
+    stats.Set("late", Napi::Number::New(env, (double)loop_stats.late));
+    stats.Set("queueDepth", Napi::Number::New(env, (double)loop_stats.queue_depth));
+
+    if (entry.pipeline) {
+        PipelineStats pipeline_stats = entry.pipeline->GetStats();
+        Napi::Object pipeline = Napi::Object::New(env);
+        pipeline.Set("slots", Napi::Number::New(env, (double)pipeline_stats.slots));
+        pipeline.Set("submitted", Napi::Number::New(env, (double)pipeline_stats.submitted));
+        pipeline.Set("completed", Napi::Number::New(env, (double)pipeline_stats.completed));
+        pipeline.Set("sourceStalls", Napi::Number::New(env, (double)pipeline_stats.source_stalls));
+
+        Napi::Array stages = Napi::Array::New(env, pipeline_stats.stages.size());
+        for (size_t i = 0; i < pipeline_stats.stages.size(); i++) {
+            const PipelineStageStats& stage_stats = pipeline_stats.stages[i];
+            Napi::Object stage = Napi::Object::New(env);
+            stage.Set("name", Napi::String::New(env, stage_stats.name));
+            stage.Set("processed", Napi::Number::New(env, (double)stage_stats.processed));
+            stage.Set("dropped", Napi::Number::New(env, (double)stage_stats.dropped));
+            stage.Set("starved", Napi::Number::New(env, (double)stage_stats.starved));
+            stage.Set("blocked", Napi::Number::New(env, (double)stage_stats.blocked));
+            stage.Set("queueDepth", Napi::Number::New(env, (double)stage_stats.queue_depth));
+            stage.Set("peakQueueDepth", Napi::Number::New(env, (double)stage_stats.peak_queue_depth));
+            stage.Set("busyMs", Napi::Number::New(env, stage_stats.busy_ms));
+            stages.Set((uint32_t)i, stage);
+        }
+        pipeline.Set("stages", stages);
+        stats.Set("pipeline", pipeline);
+    }
+    return stats;
+}
+
+// Статистика асинхронного циклу: поля першої сесії і масив outputs
+Napi::Value GetCaptureLoopStats(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    Napi::Object screenInfo = Napi::Object::New(env);
 
-    try {
+    std::lock_guard<std::mutex> loop_lock(g_loop_mutex);
+    if (g_capture_loops.empty()) {
+        return env.Null();
+    }
+
+    Napi::Object stats = LoopStatsToJs(env, g_capture_loops.front());
+    Napi::Array outputs = Napi::Array::New(env, g_capture_loops.size());
+    for (size_t i = 0; i < g_capture_loops.size(); i++) {
+        outputs.Set((uint32_t)i, i == 0 ? stats : LoopStatsToJs(env, g_capture_loops[i]));
+    }
+    stats.Set("outputs", outputs);
+    return stats;
+}
+
+// Статистика пулу вихідних буферів: getFramePoolStats(output?)
+Napi::Value GetFramePoolStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Object stats = Napi::Object::New(env);
+
+    std::shared_ptr<FramePool> pool;
+    {
         std::lock_guard<std::mutex> lock(g_mutex);
+        std::shared_ptr<CaptureSession> session = FindSession(GetOutputArgument(info, 0));
+        if (session) {
+            std::lock_guard<std::mutex> session_lock(session->mutex);
+            pool = session->frame_pool;
+        }
+    }
+    if (!pool) {
+        return env.Null();
+    }
 
-        if (g_screen_capture) {
-            screenInfo.Set("width", Napi::Number::New(env, g_screen_capture->GetWidth()));
-            screenInfo.Set("height", Napi::Number::New(env, g_screen_capture->GetHeight()));
-            screenInfo.Set("initialized", Napi::Boolean::New(env, true));
-        } else {
-            // Створити тимчасовий об'єкт для отримання інформації
-            ScreenCapture temp_capture;
-            if (temp_capture.Initialize(0, 0)) {
-                screenInfo.Set("width", Napi::Number::New(env, temp_capture.GetWidth()));
-                screenInfo.Set("height", Napi::Number::New(env, temp_capture.GetHeight()));
-                screenInfo.Set("initialized", Napi::Boolean::New(env, false));
-            } else {
-                Napi::Error::New(env, "Failed to get screen info").ThrowAsJavaScriptException();
-                return env.Null();
-            }
+    FramePoolStats pool_stats = pool->GetStats();
+    stats.Set("bufferSize", Napi::Number::New(env, (double)pool_stats.buffer_size));
+    stats.Set("depth", Napi::Number::New(env, pool_stats.depth));
+    stats.Set("inUse", Napi::Number::New(env, pool_stats.in_use));
+    stats.Set("peakInUse", Napi::Number::New(env, pool_stats.peak_in_use));
+    stats.Set("acquired", Napi::Number::New(env, (double)pool_stats.acquired));
+    stats.Set("exhausted", Napi::Number::New(env, (double)pool_stats.exhausted));
+    return stats;
+}
+
+// Статистика арени буферів: heapAllocations не росте в сталому режимі захоплення
+Napi::Value GetArenaStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Object stats = Napi::Object::New(env);
+
+    BufferArenaStats arena_stats = GetBufferArena().GetStats();
+    stats.Set("heapAllocations", Napi::Number::New(env, (double)arena_stats.heap_allocations));
+    stats.Set("acquires", Napi::Number::New(env, (double)arena_stats.acquires));
+    stats.Set("releases", Napi::Number::New(env, (double)arena_stats.releases));
+    stats.Set("bytesReserved", Napi::Number::New(env, (double)arena_stats.bytes_reserved));
+    stats.Set("bytesInUse", Napi::Number::New(env, (double)arena_stats.bytes_in_use));
+    stats.Set("peakBytesInUse", Napi::Number::New(env, (double)arena_stats.peak_bytes_in_use));
+    stats.Set("freeBlocks", Napi::Number::New(env, (double)arena_stats.free_blocks));
+    stats.Set("sizeClasses", Napi::Number::New(env, arena_stats.size_classes));
+    return stats;
+}
+
+// Власник кадру трансляції, переданого в JS (блок з арени, як PooledBufferOwner)
+struct BroadcastFrameOwner {
+    BroadcastFramePtr frame;
+    int64_t external_bytes;
+};
+
+// Кадр трансляції як external Buffer: пам'ять спільна з іншими споживачами,
+// тому в JS лише для читання
+static Napi::Value WrapBroadcastFrame(Napi::Env env, const BroadcastFramePtr& frame) {
+    uint8_t* data = const_cast<uint8_t*>(frame->data.data());
+    void* owner_block = GetBufferArena().Allocate(sizeof(BroadcastFrameOwner));
+    if (!owner_block) {
+        GetCaptureStats().Add(StatCounter::BufferCopies);
+        return Napi::Buffer<uint8_t>::Copy(env, data, frame->data.size());
+    }
+    auto* owner = new (owner_block) BroadcastFrameOwner{ frame, (int64_t)frame->data.size() };
+    Napi::MemoryManagement::AdjustExternalMemory(env, owner->external_bytes);
+
+    return Napi::Buffer<uint8_t>::New(env, data, frame->data.size(),
+        [](Napi::Env finalize_env, uint8_t*, BroadcastFrameOwner* frame_owner) {
+            Napi::MemoryManagement::AdjustExternalMemory(finalize_env, -frame_owner->external_bytes);
+            frame_owner->~BroadcastFrameOwner();
+            GetBufferArena().Free(frame_owner);
+        }, owner);
+}
+
+// Вичитати чергу споживача трансляції (JS потік, виклик з ThreadSafeFunction)
+static void DeliverBroadcastFrames(Napi::Env env, Napi::Function on_frame, int consumer_id) {
+    g_broadcast.BeginDrain(consumer_id);
+
+    BroadcastFramePtr frame;
+    while (g_broadcast.Poll(consumer_id, frame)) {
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("data", WrapBroadcastFrame(env, frame));
+        result.Set("width", Napi::Number::New(env, frame->width));
+        result.Set("height", Napi::Number::New(env, frame->height));
+        result.Set("stride", Napi::Number::New(env, frame->stride));
+        result.Set("timestamp", Napi::Number::New(env, frame->timestamp_ms));
+        result.Set("sequence", Napi::Number::New(env, (double)frame->sequence));
+        result.Set("output", Napi::Number::New(env, frame->output));
+        frame.reset();
+
+        on_frame.Call({ result });
+        if (env.IsExceptionPending()) {
+            break;
         }
-        
-    } catch (const std::exception& e) {
-        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+}
+
+// Додатковий споживач захоплених кадрів (BGRA у розмірі джерела):
+// addBroadcastConsumer({ name, capacity, dropPolicy: 'oldest' | 'newest' }, onFrame) -> id
+Napi::Value AddBroadcastConsumer(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsObject() || !info[1].IsFunction()) {
+        Napi::TypeError::New(env, "Expected (options, onFrame)").ThrowAsJavaScriptException();
         return env.Null();
     }
 
-    return screenInfo;
+    Napi::Object options = info[0].As<Napi::Object>();
+    std::string name = "consumer";
+    int capacity = 2;
+    BroadcastDropPolicy policy = BroadcastDropPolicy::DropOldest;
+    if (options.Has("name")) {
+        name = options.Get("name").As<Napi::String>().Utf8Value();
+    }
+    if (options.Has("capacity")) {
+        capacity = options.Get("capacity").As<Napi::Number>().Int32Value();
+    }
+    if (options.Has("dropPolicy")) {
+        std::string policy_name = options.Get("dropPolicy").As<Napi::String>().Utf8Value();
+        if (!ParseBroadcastDropPolicy(policy_name, policy)) {
+            Napi::TypeError::New(env, "Unsupported drop policy: " + policy_name).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    }
+    if (capacity <= 0 || capacity > (int)FrameBroadcast::kMaxCapacity) {
+        Napi::RangeError::New(env, "capacity must be 1.." + std::to_string(FrameBroadcast::kMaxCapacity))
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(
+        env, info[1].As<Napi::Function>(), "FrameBroadcast", 0, 1);
+
+    int id = g_broadcast.AddConsumer(name, (size_t)capacity, policy, [tsfn](int consumer_id) mutable {
+        tsfn.NonBlockingCall([consumer_id](Napi::Env call_env, Napi::Function js_callback) {
+            // Споживача могли зняти, поки виклик стояв у черзі - тоді Poll нічого не поверне
+            DeliverBroadcastFrames(call_env, js_callback, consumer_id);
+        });
+    });
+    g_broadcast_tsfns[id] = tsfn;
+    return Napi::Number::New(env, id);
 }
 
-// Захоплення одного кадру
-Napi::Value CaptureFrame(const Napi::CallbackInfo& info) {
+static bool RemoveBroadcastConsumerInternal(int id) {
+    auto it = g_broadcast_tsfns.find(id);
+    if (it == g_broadcast_tsfns.end()) {
+        return false;
+    }
+    // Після RemoveConsumer виробник більше не викликає notify - TSFN можна звільнити
+    g_broadcast.RemoveConsumer(id);
+    it->second.Release();
+    g_broadcast_tsfns.erase(it);
+    return true;
+}
+
+// Зняти всіх споживачів: активний TSFN тримав би процес Node живим
+static void RemoveBroadcastConsumers() {
+    while (!g_broadcast_tsfns.empty()) {
+        RemoveBroadcastConsumerInternal(g_broadcast_tsfns.begin()->first);
+    }
+}
+
+Napi::Value RemoveBroadcastConsumer(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Expected consumer id").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return Napi::Boolean::New(env, RemoveBroadcastConsumerInternal(info[0].As<Napi::Number>().Int32Value()));
+}
+
+// Відставання і втрати кожного споживача трансляції
+Napi::Value GetBroadcastStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Object stats = Napi::Object::New(env);
+
+    std::vector<BroadcastConsumerStats> consumer_stats = g_broadcast.GetStats();
+    Napi::Array consumers = Napi::Array::New(env, consumer_stats.size());
+    for (size_t i = 0; i < consumer_stats.size(); i++) {
+        const BroadcastConsumerStats& entry = consumer_stats[i];
+        Napi::Object consumer = Napi::Object::New(env);
+        consumer.Set("id", Napi::Number::New(env, entry.id));
+        consumer.Set("name", Napi::String::New(env, entry.name));
+        consumer.Set("dropPolicy", Napi::String::New(env, GetBroadcastDropPolicyName(entry.policy)));
+        consumer.Set("capacity", Napi::Number::New(env, (double)entry.capacity));
+        consumer.Set("queued", Napi::Number::New(env, (double)entry.queued));
+        consumer.Set("peakQueued", Napi::Number::New(env, (double)entry.peak_queued));
+        consumer.Set("lagMs", Napi::Number::New(env, entry.lag_ms));
+        consumer.Set("delivered", Napi::Number::New(env, (double)entry.delivered));
+        consumer.Set("dropped", Napi::Number::New(env, (double)entry.dropped));
+        consumers.Set((uint32_t)i, consumer);
+    }
+    stats.Set("published", Napi::Number::New(env, (double)g_broadcast.GetPublished()));
+    stats.Set("consumers", consumers);
+    return stats;
+}
+
+// Останні SPS/PPS потоку h264 - глядач, що підключився посеред потоку,
+// ініціалізує декодер, не чекаючи наступного IDR. getCodecConfig(output?)
+Napi::Value GetCodecConfig(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     Napi::Object result = Napi::Object::New(env);
 
-    try {
-        std::lock_guard<std::mutex> lock(g_mutex);
+    std::lock_guard<std::mutex> lock(g_mutex);
+    std::shared_ptr<CaptureSession> found = FindSession(GetOutputArgument(info, 0));
+    if (!found) {
+        result.Set("success", Napi::Boolean::New(env, false));
+        result.Set("error", Napi::String::New(env, "H264_NOT_ACTIVE"));
+        return result;
+    }
+    CaptureSession& session = *found;
+    std::lock_guard<std::mutex> session_lock(session.mutex);
+    if (!session.h264_parser || !session.h264_parser->HasParameterSets()) {
+        result.Set("success", Napi::Boolean::New(env, false));
+        result.Set("error", Napi::String::New(env,
+            session.h264_parser ? "NO_PARAMETER_SETS" : "H264_NOT_ACTIVE"));
+        return result;
+    }
 
-        if (!g_screen_capture) {
-            result.Set("success", Napi::Boolean::New(env, false));
-            result.Set("error", Napi::String::New(env, "Not initialized"));
-            return result;
-        }
+    std::vector<uint8_t> sps = session.h264_parser->GetSps();
+    std::vector<uint8_t> pps = session.h264_parser->GetPps();
+    std::vector<uint8_t> config = session.h264_parser->GetCodecConfig();
+    result.Set("success", Napi::Boolean::New(env, true));
+    result.Set("codec", Napi::String::New(env, session.h264_parser->GetCodecString()));
+    result.Set("sps", Napi::Buffer<uint8_t>::Copy(env, sps.data(), sps.size()));
+    result.Set("pps", Napi::Buffer<uint8_t>::Copy(env, pps.data(), pps.size()));
+    result.Set("data", Napi::Buffer<uint8_t>::Copy(env, config.data(), config.size()));
+    return result;
+}
+
+// Поточна група кадрів для нового глядача: буфери спільні з кешем (без копіювання),
+// кеш може вже почати нову групу - знятий список лишається дійсним. getGopFrames(output?)
+Napi::Value GetGopFrames(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Object result = Napi::Object::New(env);
 
-        // Захопити кадр
-        std::vector<uint8_t> frameData;
-        if (!g_screen_capture->CaptureFrame(frameData)) {
+    GopCache::Snapshot snapshot;
+    GopCacheStats cache_stats;
+    int output = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        std::shared_ptr<CaptureSession> session = FindSession(GetOutputArgument(info, 0));
+        std::unique_lock<std::mutex> session_lock;
+        if (session) {
+            session_lock = std::unique_lock<std::mutex>(session->mutex);
+        }
+        if (!session || !session->gop_cache) {
             result.Set("success", Napi::Boolean::New(env, false));
-            result.Set("error", Napi::String::New(env, "NO_NEW_FRAME"));
+            result.Set("error", Napi::String::New(env, "GOP_CACHE_DISABLED"));
             return result;
         }
+        snapshot = session->gop_cache->GetSnapshot();
+        cache_stats = session->gop_cache->GetStats();
+        output = session->output;
+    }
 
-        // Якщо енкодер є - закодувати
-        if (g_encoder) {
-            std::vector<uint8_t> h264Data;
-            if (!g_encoder->Encode(frameData, h264Data)) {
-                // Може бути нормально (потрібно більше кадрів)
-                if (g_encoder->GetLastError().find("need more input") != std::string::npos) {
-                    result.Set("success", Napi::Boolean::New(env, true));
-                    result.Set("encoded", Napi::Boolean::New(env, false));
-                    return result;
-                }
-                
-                result.Set("success", Napi::Boolean::New(env, false));
-                result.Set("error", Napi::String::New(env, g_encoder->GetLastError()));
-                return result;
-            }
+    Napi::Array frames = Napi::Array::New(env, snapshot.size());
+    for (size_t i = 0; i < snapshot.size(); i++) {
+        const std::shared_ptr<const GopFrame>& frame = snapshot[i];
+        auto* owner = new std::shared_ptr<const GopFrame>(frame);
 
-            // Повернути H.264 дані
-            if (h264Data.size() > 0) {
-                Napi::Buffer<uint8_t> buffer = Napi::Buffer<uint8_t>::Copy(env, h264Data.data(), h264Data.size());
-                result.Set("success", Napi::Boolean::New(env, true));
-                result.Set("encoded", Napi::Boolean::New(env, true));
-                result.Set("data", buffer);
-                result.Set("size", Napi::Number::New(env, h264Data.size()));
-            } else {
-                result.Set("success", Napi::Boolean::New(env, true));
-                result.Set("encoded", Napi::Boolean::New(env, false));
-            }
-        } else {
-            // Енкодер вимкнений - повернути RAW BGRA дані
-            Napi::Buffer<uint8_t> buffer = Napi::Buffer<uint8_t>::Copy(env, frameData.data(), frameData.size());
-            result.Set("success", Napi::Boolean::New(env, true));
-            result.Set("encoded", Napi::Boolean::New(env, false));
-            result.Set("data", buffer);
-            result.Set("size", Napi::Number::New(env, frameData.size()));
+        Napi::Object item = Napi::Object::New(env);
+        item.Set("data", Napi::Buffer<uint8_t>::New(env, const_cast<uint8_t*>(frame->data.data()),
+            frame->data.size(),
+            [](Napi::Env, uint8_t*, std::shared_ptr<const GopFrame>* frame_owner) {
+                delete frame_owner;
+            }, owner));
+        item.Set("size", Napi::Number::New(env, (double)frame->data.size()));
+        item.Set("codec", Napi::String::New(env, frame->codec));
+        item.Set("encoded", Napi::Boolean::New(env, true));
+        item.Set("keyframe", Napi::Boolean::New(env, frame->keyframe));
+        item.Set("timestamp", Napi::Number::New(env, frame->timestamp_ms));
+        if (frame->parameter_sets) {
+            item.Set("parameterSets", Napi::Boolean::New(env, true));
+        } else if (frame->has_h264_info) {
+            SetH264Result(env, item, frame->h264);
         }
+        frames.Set((uint32_t)i, item);
+    }
 
-    } catch (const std::exception& e) {
-        result.Set("success", Napi::Boolean::New(env, false));
-        result.Set("error", Napi::String::New(env, e.what()));
+    result.Set("success", Napi::Boolean::New(env, true));
+    result.Set("output", Napi::Number::New(env, output));
+    result.Set("complete", Napi::Boolean::New(env, !snapshot.empty()));
+    result.Set("frames", frames);
+    result.Set("bytes", Napi::Number::New(env, (double)cache_stats.bytes));
+    result.Set("maxBytes", Napi::Number::New(env, (double)cache_stats.max_bytes));
+    result.Set("maxFrames", Napi::Number::New(env, cache_stats.max_frames));
+    result.Set("gops", Napi::Number::New(env, (double)cache_stats.gops));
+    result.Set("overflows", Napi::Number::New(env, (double)cache_stats.overflows));
+    result.Set("replays", Napi::Number::New(env, (double)cache_stats.replays));
+    return result;
+}
+
+// Трекер курсора сесії (під g_mutex, без mutex сесії - опитування не чекає на захоплення)
+// Курсор сесії і розмір джерела: трекер веде позицію в пікселях джерела (регіону),
+// а кадри для глядачів і compositeCursor можуть бути масштабовані
+struct CursorTarget {
+    std::shared_ptr<CursorTracker> tracker;
+    int source_width = 0;
+    int source_height = 0;
+    int width = 0;                  // Розмір виходу кодека
+    int height = 0;
+};
+
+static CursorTarget FindCursorTarget(int output) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    CursorTarget target;
+    std::shared_ptr<CaptureSession> session = FindSession(output);
+    if (session && session->cursor) {
+        target.tracker = session->cursor;
+        target.source_width = session->source_width;
+        target.source_height = session->source_height;
+        target.width = session->width;
+        target.height = session->height;
+    }
+    return target;
+}
+
+// Стан і форма курсора в координатах кадру width x height (масштаб відносно джерела).
+// shape = nullptr - форми немає або її витіснено з кешу
+static CursorState GetScaledCursor(const CursorTarget& target, int width, int height,
+                                   CursorShapePtr& shape) {
+    CursorState state = target.tracker->GetState();
+    shape = state.shape_id ? target.tracker->GetShape(state.shape_id) : nullptr;
+    if (target.source_width <= 0 || target.source_height <= 0 ||
+        (width == target.source_width && height == target.source_height)) {
+        return state;
+    }
+
+    const double scale_x = (double)width / target.source_width;
+    const double scale_y = (double)height / target.source_height;
+    // Точка вказівника (hotspot) масштабується, кут форми - від масштабованого hotspot
+    const int hot_x = shape ? shape->hot_x : 0;
+    const int hot_y = shape ? shape->hot_y : 0;
+    if (shape) {
+        auto scaled = std::make_shared<CursorShape>();
+        ScaleCursorShape(*shape, scale_x, scale_y, *scaled);
+        shape = scaled;
+    }
+    state.x = (int)std::floor((state.x + hot_x) * scale_x) - (shape ? shape->hot_x : 0);
+    state.y = (int)std::floor((state.y + hot_y) * scale_y) - (shape ? shape->hot_y : 0);
+    return state;
+}
+
+// Стан вказівника: позиція лівого верхнього кута форми в координатах кадру (після масштабу
+// width/height) і id форми. sequence росте при кожній зміні. getCursor(output?) -> null,
+// якщо курсор вимкнено
+Napi::Value GetCursor(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    CursorTarget target = FindCursorTarget(GetOutputArgument(info, 0));
+    if (!target.tracker) {
+        return env.Null();
+    }
+
+    CursorShapePtr shape;
+    CursorState state = GetScaledCursor(target, target.width, target.height, shape);
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("visible", Napi::Boolean::New(env, state.visible));
+    result.Set("x", Napi::Number::New(env, state.x));
+    result.Set("y", Napi::Number::New(env, state.y));
+    result.Set("shapeId", Napi::Number::New(env, state.shape_id));
+    result.Set("hotX", Napi::Number::New(env, shape ? shape->hot_x : 0));
+    result.Set("hotY", Napi::Number::New(env, shape ? shape->hot_y : 0));
+    result.Set("sequence", Napi::Number::New(env, (double)state.sequence));
+    return result;
+}
+
+// Пікселі форми (непремультиплікована BGRA, крок width * 4) у масштабі кадру - передаються
+// глядачу один раз на id. getCursorShape(id, output?) -> null, якщо форму витіснено.
+// Копія: форма в кеші трекера незмінна і спільна з потоком захоплення
+Napi::Value GetCursorShape(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Expected shape id").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    CursorTarget target = FindCursorTarget(GetOutputArgument(info, 1));
+    CursorShapePtr shape = target.tracker ? target.tracker->GetShape(info[0].As<Napi::Number>().Uint32Value())
+                                          : nullptr;
+    if (!shape) {
+        return env.Null();
+    }
+    if (target.source_width > 0 && target.source_height > 0 &&
+        (target.width != target.source_width || target.height != target.source_height)) {
+        auto scaled = std::make_shared<CursorShape>();
+        ScaleCursorShape(*shape, (double)target.width / target.source_width,
+                         (double)target.height / target.source_height, *scaled);
+        shape = scaled;
     }
 
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("id", Napi::Number::New(env, shape->id));
+    result.Set("width", Napi::Number::New(env, shape->width));
+    result.Set("height", Napi::Number::New(env, shape->height));
+    result.Set("hotX", Napi::Number::New(env, shape->hot_x));
+    result.Set("hotY", Napi::Number::New(env, shape->hot_y));
+    result.Set("data", Napi::Buffer<uint8_t>::Copy(env, shape->bgra.data(), shape->bgra.size()));
     return result;
 }
 
+// Накласти поточний курсор на BGRA кадр (запис, скріншот - споживачі без окремого
+// каналу). compositeCursor(buffer, width, height, stride?, output?) -> true, якщо накладено
+Napi::Value CompositeCursor(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 3 || !info[0].IsBuffer() || !info[1].IsNumber() || !info[2].IsNumber()) {
+        Napi::TypeError::New(env, "Expected (buffer, width, height, stride?, output?)").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    Napi::Buffer<uint8_t> buffer = info[0].As<Napi::Buffer<uint8_t>>();
+    const int width = info[1].As<Napi::Number>().Int32Value();
+    const int height = info[2].As<Napi::Number>().Int32Value();
+    const int stride = info.Length() > 3 && info[3].IsNumber() ? info[3].As<Napi::Number>().Int32Value()
+                                                                : width * 4;
+    if (width <= 0 || height <= 0 || stride < width * 4 ||
+        buffer.Length() < (size_t)stride * (height - 1) + (size_t)width * 4) {
+        Napi::RangeError::New(env, "Buffer is smaller than frame").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    // Кадр може бути в розмірі джерела або вже масштабований - позиція і форма під нього
+    CursorTarget target = FindCursorTarget(GetOutputArgument(info, 4));
+    if (!target.tracker) {
+        return Napi::Boolean::New(env, false);
+    }
+    CursorShapePtr shape;
+    CursorState state = GetScaledCursor(target, width, height, shape);
+    if (!state.visible || !shape) {
+        return Napi::Boolean::New(env, false);
+    }
+    return Napi::Boolean::New(env, BlendCursor(buffer.Data(), stride, width, height, *shape, state.x, state.y));
+}
+
+// Лічильники та гістограми затримок по стадіях (знімок робиться лише тут)
+Napi::Value GetStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    const CaptureStats& capture_stats = GetCaptureStats();
+    Napi::Object stats = Napi::Object::New(env);
+
+    Napi::Object counters = Napi::Object::New(env);
+    for (int i = 0; i < static_cast<int>(StatCounter::Count); i++) {
+        StatCounter counter = static_cast<StatCounter>(i);
+        counters.Set(CaptureStats::GetCounterName(counter),
+                     Napi::Number::New(env, (double)capture_stats.Get(counter)));
+    }
+
+    Napi::Object stages = Napi::Object::New(env);
+    for (int i = 0; i < static_cast<int>(StatStage::Count); i++) {
+        StatStage stage = static_cast<StatStage>(i);
+        LatencySnapshot snapshot = capture_stats.GetSnapshot(stage);
+        Napi::Object histogram = Napi::Object::New(env);
+        histogram.Set("count", Napi::Number::New(env, (double)snapshot.count));
+        histogram.Set("meanMs", Napi::Number::New(env, snapshot.mean_ms));
+        histogram.Set("p50Ms", Napi::Number::New(env, snapshot.p50_ms));
+        histogram.Set("p90Ms", Napi::Number::New(env, snapshot.p90_ms));
+        histogram.Set("p99Ms", Napi::Number::New(env, snapshot.p99_ms));
+        histogram.Set("maxMs", Napi::Number::New(env, snapshot.max_ms));
+        stages.Set(CaptureStats::GetStageName(stage), histogram);
+    }
+
+    stats.Set("elapsedMs", Napi::Number::New(env, capture_stats.GetElapsedMs()));
+    stats.Set("counters", counters);
+    stats.Set("stages", stages);
+
+    // Планувальник і курсор першої сесії (у кожного виходу - власні)
+    std::shared_ptr<CaptureScheduler> scheduler;
+    std::shared_ptr<CursorTracker> cursor;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        std::shared_ptr<CaptureSession> session = FindSession(-1);
+        if (session) {
+            cursor = session->cursor;
+            std::lock_guard<std::mutex> session_lock(session->mutex);
+            scheduler = session->scheduler;
+        }
+    }
+    if (scheduler) {
+        CaptureSchedulerStats scheduler_stats = scheduler->GetStats();
+        Napi::Object adaptive = Napi::Object::New(env);
+        adaptive.Set("fps", Napi::Number::New(env, scheduler_stats.fps));
+        adaptive.Set("minFps", Napi::Number::New(env, scheduler->GetConfig().min_fps));
+        adaptive.Set("maxFps", Napi::Number::New(env, scheduler->GetConfig().max_fps));
+        adaptive.Set("lastChange", Napi::Number::New(env, scheduler_stats.last_change));
+        adaptive.Set("changedFrames", Napi::Number::New(env, (double)scheduler_stats.changed_frames));
+        adaptive.Set("staticFrames", Napi::Number::New(env, (double)scheduler_stats.static_frames));
+        adaptive.Set("bursts", Napi::Number::New(env, (double)scheduler_stats.bursts));
+        adaptive.Set("congested", Napi::Number::New(env, (double)scheduler_stats.congested));
+        adaptive.Set("cursorMoves", Napi::Number::New(env, (double)scheduler_stats.cursor_moves));
+        stats.Set("scheduler", adaptive);
+    }
+    if (cursor) {
+        CursorStats cursor_stats = cursor->GetStats();
+        Napi::Object cursor_object = Napi::Object::New(env);
+        cursor_object.Set("positionUpdates", Napi::Number::New(env, (double)cursor_stats.position_updates));
+        cursor_object.Set("shapeUpdates", Napi::Number::New(env, (double)cursor_stats.shape_updates));
+        cursor_object.Set("shapeCacheHits", Napi::Number::New(env, (double)cursor_stats.shape_cache_hits));
+        cursor_object.Set("shapes", Napi::Number::New(env, (double)cursor_stats.shapes));
+        stats.Set("cursor", cursor_object);
+    }
+    return stats;
+}
+
+Napi::Value ResetStats(const Napi::CallbackInfo& info) {
+    GetCaptureStats().Reset();
+    return info.Env().Undefined();
+}
+
 // Зупинка захоплення
 Napi::Value StopCapture(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     Napi::Object result = Napi::Object::New(env);
 
+    // Спочатку зупинити асинхронний цикл (він використовує ті самі об'єкти)
+    StopCaptureLoopInternal();
+    RemoveBroadcastConsumers();
+
     try {
         std::lock_guard<std::mutex> lock(g_mutex);
         
         // Очистити ресурси (буде виклик деструкторів)
-        g_screen_capture.reset();
-        g_encoder.reset();
+        ReleaseCaptureObjects();
+        // Захоплення зупинено - вільні блоки арени повертаються системі
+        GetBufferArena().Trim();
 
         result.Set("success", Napi::Boolean::New(env, true));
     } catch (const std::exception& e) {
@@ -219,11 +2364,14 @@ Napi::Value StopCapture(const Napi::CallbackInfo& info) {
 // Cleanup ресурсів
 Napi::Value Cleanup(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
+
+    StopCaptureLoopInternal();
+    RemoveBroadcastConsumers();
     
     try {
         std::lock_guard<std::mutex> lock(g_mutex);
-        g_screen_capture.reset();
-        g_encoder.reset();
+        ReleaseCaptureObjects();
+        GetBufferArena().Trim();
     } catch (const std::exception& e) {
         Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     }
@@ -231,11 +2379,52 @@ Napi::Value Cleanup(const Napi::CallbackInfo& info) {
     return env.Undefined();
 }
 
+// Примусовий повний кадр (наприклад, коли підключився новий глядач): delta - keyframe,
+// h264 - IDR з SPS/PPS. requestKeyframe(output?) - без аргументу для всіх виходів
+Napi::Value RequestKeyframe(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    // g_mutex тримає кодери живими; mutex сесії не потрібен - стадія encode його не бере,
+    // запит атомарний і знімається в наступному Encode
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    const int output = GetOutputArgument(info, 0);
+    for (const auto& session : g_sessions) {
+        if (output >= 0 && session->output != output) {
+            continue;
+        }
+        if (session->delta_encoder) {
+            session->delta_encoder->ForceKeyframe();
+        }
+        if (session->encoder) {
+            session->encoder->ForceKeyframe();
+        }
+    }
+
+    return env.Undefined();
+}
+
 // Ініціалізація модуля
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
     exports.Set("initialize", Napi::Function::New(env, Initialize));
     exports.Set("getScreenInfo", Napi::Function::New(env, GetScreenInfo));
+    exports.Set("getOutputs", Napi::Function::New(env, GetOutputs));
     exports.Set("captureFrame", Napi::Function::New(env, CaptureFrame));
+    exports.Set("startCaptureLoop", Napi::Function::New(env, StartCaptureLoop));
+    exports.Set("stopCaptureLoop", Napi::Function::New(env, StopCaptureLoop));
+    exports.Set("getCaptureLoopStats", Napi::Function::New(env, GetCaptureLoopStats));
+    exports.Set("requestKeyframe", Napi::Function::New(env, RequestKeyframe));
+    exports.Set("getFramePoolStats", Napi::Function::New(env, GetFramePoolStats));
+    exports.Set("getArenaStats", Napi::Function::New(env, GetArenaStats));
+    exports.Set("getCodecConfig", Napi::Function::New(env, GetCodecConfig));
+    exports.Set("getGopFrames", Napi::Function::New(env, GetGopFrames));
+    exports.Set("getCursor", Napi::Function::New(env, GetCursor));
+    exports.Set("getCursorShape", Napi::Function::New(env, GetCursorShape));
+    exports.Set("compositeCursor", Napi::Function::New(env, CompositeCursor));
+    exports.Set("addBroadcastConsumer", Napi::Function::New(env, AddBroadcastConsumer));
+    exports.Set("removeBroadcastConsumer", Napi::Function::New(env, RemoveBroadcastConsumer));
+    exports.Set("getBroadcastStats", Napi::Function::New(env, GetBroadcastStats));
+    exports.Set("getStats", Napi::Function::New(env, GetStats));
+    exports.Set("resetStats", Napi::Function::New(env, ResetStats));
     exports.Set("stopCapture", Napi::Function::New(env, StopCapture));
     exports.Set("cleanup", Napi::Function::New(env, Cleanup));
 
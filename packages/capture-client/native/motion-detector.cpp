@@ -0,0 +1,301 @@
+/**
+ * Motion Detector Implementation
+ */
+
+#include "motion-detector.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+constexpr uint64_t kHashSeed = 0x9E3779B97F4A7C15ull;
+constexpr uint64_t kHashPrime = 0x100000001B3ull * 0x9E3779B1ull | 1;
+
+// Якорі зсуву на смугу і скільки збігів якоря в попередньому кадрі ще вважаються
+// характерними (повторювані рядки - рамки, порожні рядки - не голосують)
+constexpr int kAnchors = 8;
+constexpr int kMaxAnchorMatches = 4;
+
+inline uint64_t Mix(uint64_t h, uint64_t v) {
+    h = (h ^ v) * kHashPrime;
+    return h ^ (h >> 32);
+}
+
+// Хеш count пікселів рядка: 4 незалежні ланцюжки по 8 байт (множення не чекають одне на одне)
+uint64_t HashRow(const uint8_t* data, int count) {
+    const size_t bytes = (size_t)count * 4;
+    uint64_t h0 = kHashSeed;
+    uint64_t h1 = kHashSeed + 1;
+    uint64_t h2 = kHashSeed + 2;
+    uint64_t h3 = kHashSeed + 3;
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        uint64_t v[4];
+        memcpy(v, data + i, sizeof(v));
+        h0 = Mix(h0, v[0]);
+        h1 = Mix(h1, v[1]);
+        h2 = Mix(h2, v[2]);
+        h3 = Mix(h3, v[3]);
+    }
+    for (; i + 4 <= bytes; i += 4) {
+        uint32_t v;
+        memcpy(&v, data + i, sizeof(v));
+        h0 = Mix(h0, v);
+    }
+    return Mix(Mix(Mix(h0, h1), h2), h3 ^ bytes);
+}
+
+bool Intersects(const MoveRect& a, const MoveRect& b) {
+    return a.dst_x < b.dst_x + b.width && b.dst_x < a.dst_x + a.width &&
+           a.dst_y < b.dst_y + b.height && b.dst_y < a.dst_y + a.height;
+}
+
+} // namespace
+
+MotionDetector::MotionDetector() {
+}
+
+bool MotionDetector::Initialize(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+    width_ = width;
+    height_ = height;
+    strips_ = (width + kBlockSize - 1) / kBlockSize;
+    bands_ = (height + kBlockSize - 1) / kBlockSize;
+    row_hashes_.assign((size_t)strips_ * height, 0);
+    previous_row_hashes_.assign((size_t)strips_ * height, 0);
+    column_hashes_.assign((size_t)bands_ * width, 0);
+    previous_column_hashes_.assign((size_t)bands_ * width, 0);
+    has_previous_ = false;
+    hints_.clear();
+    stats_ = MotionDetectorStats();
+    return true;
+}
+
+void MotionDetector::SetHints(const std::vector<MoveRect>& hints) {
+    hints_.clear();
+    for (MoveRect move : hints) {
+        if (ClipMoveRect(move, width_, height_) && hints_.size() < kMaxMoves) {
+            hints_.push_back(move);
+        }
+    }
+}
+
+void MotionDetector::HashFrame(const uint8_t* frame, int stride) {
+    for (int y = 0; y < height_; y++) {
+        const uint8_t* row = frame + (size_t)y * stride;
+        for (int strip = 0; strip < strips_; strip++) {
+            const int x = strip * kBlockSize;
+            row_hashes_[(size_t)strip * height_ + y] = HashRow(row + (size_t)x * 4, std::min(kBlockSize, width_ - x));
+        }
+
+        // Стовпці смуги рядків накопичуються рядок за рядком (прохід по пам'яті - послідовний)
+        uint64_t* columns = &column_hashes_[(size_t)(y / kBlockSize) * width_];
+        if (y % kBlockSize == 0) {
+            std::fill(columns, columns + width_, kHashSeed);
+        }
+        const uint32_t* pixels = reinterpret_cast<const uint32_t*>(row);
+        for (int x = 0; x < width_; x++) {
+            columns[x] = (columns[x] ^ pixels[x]) * kHashPrime;
+        }
+    }
+}
+
+void MotionDetector::FindRuns(const uint64_t* current, const uint64_t* previous, int bands, int length,
+                              std::vector<Run>& runs) {
+    for (int band = 0; band < bands; band++) {
+        const uint64_t* c = current + (size_t)band * length;
+        const uint64_t* p = previous + (size_t)band * length;
+
+        // Змінені рядки; характерні (відмінні від сусідів) - кандидати в якорі
+        anchors_.clear();
+        int changed = 0;
+        for (int i = 0; i < length; i++) {
+            if (c[i] == p[i]) {
+                continue;
+            }
+            changed++;
+            if ((i == 0 || c[i] != c[i - 1]) && (i + 1 == length || c[i] != c[i + 1])) {
+                anchors_.push_back(i);
+            }
+        }
+        if (changed < kMinRunLength || anchors_.empty()) {
+            continue;
+        }
+
+        // Голосування: зсув, на який характерний рядок знайшовся в попередньому кадрі
+        int shifts[kAnchors * kMaxAnchorMatches];
+        int votes[kAnchors * kMaxAnchorMatches];
+        int candidates = 0;
+        const int anchor_count = std::min<int>(kAnchors, (int)anchors_.size());
+        for (int k = 0; k < anchor_count; k++) {
+            const int a = anchors_[(size_t)k * anchors_.size() / anchor_count];
+            int found[kMaxAnchorMatches];
+            int matches = 0;
+            bool repetitive = false;
+            for (int j = 0; j < length; j++) {
+                if (p[j] != c[a] || j == a) {
+                    continue;
+                }
+                if (matches == kMaxAnchorMatches) {
+                    repetitive = true;
+                    break;
+                }
+                found[matches++] = a - j;
+            }
+            for (int m = 0; !repetitive && m < matches; m++) {
+                int n = 0;
+                while (n < candidates && shifts[n] != found[m]) {
+                    n++;
+                }
+                if (n == candidates) {
+                    shifts[candidates] = found[m];
+                    votes[candidates++] = 0;
+                }
+                votes[n]++;
+            }
+        }
+
+        // Два найкращі зсуви (дві області смуги можуть прокручуватися по-різному)
+        const size_t band_runs = runs.size();
+        const int min_votes = std::min(2, anchor_count);
+        for (int attempt = 0; attempt < 2; attempt++) {
+            int best = -1;
+            for (int n = 0; n < candidates; n++) {
+                if (votes[n] >= min_votes && (best < 0 || votes[n] > votes[best])) {
+                    best = n;
+                }
+            }
+            if (best < 0) {
+                break;
+            }
+            const int shift = shifts[best];
+            votes[best] = 0;
+
+            // Неперервні відрізки, де рядок дорівнює зсунутому рядку попереднього кадру.
+            // Виграш - рядки, які без переміщення довелося б передати.
+            const int lo = std::max(0, shift);
+            const int hi = std::min(length, length + shift);
+            int start = -1;
+            int gain = 0;
+            for (int i = lo; i <= hi; i++) {
+                if (i < hi && c[i] == p[i - shift]) {
+                    if (start < 0) {
+                        start = i;
+                        gain = 0;
+                    }
+                    gain += c[i] != p[i];
+                    continue;
+                }
+                if (start >= 0 && i - start >= kMinRunLength && gain >= kMinRunLength / 2) {
+                    bool overlaps = false;
+                    for (size_t r = band_runs; r < runs.size(); r++) {
+                        overlaps |= start < runs[r].end && runs[r].start < i;
+                    }
+                    if (!overlaps) {
+                        runs.push_back({band, start, i, shift});
+                    }
+                }
+                start = -1;
+            }
+        }
+    }
+}
+
+void MotionDetector::AppendMoves(std::vector<Run>& runs, bool vertical, std::vector<MoveRect>& moves) {
+    // Сусідні смуги з тим самим відрізком і зсувом - один прямокутник; сортування на місці
+    std::sort(runs.begin(), runs.end(), [](const Run& a, const Run& b) {
+        if (a.shift != b.shift) return a.shift < b.shift;
+        if (a.start != b.start) return a.start < b.start;
+        if (a.end != b.end) return a.end < b.end;
+        return a.band < b.band;
+    });
+
+    const int extent = vertical ? width_ : height_;
+    for (size_t i = 0; i < runs.size();) {
+        size_t j = i + 1;
+        while (j < runs.size() && runs[j].shift == runs[i].shift && runs[j].start == runs[i].start &&
+               runs[j].end == runs[i].end && runs[j].band == runs[j - 1].band + 1) {
+            j++;
+        }
+        const int first = runs[i].band * kBlockSize;
+        const int last = std::min(extent, runs[j - 1].band * kBlockSize + kBlockSize);
+        MoveRect move;
+        if (vertical) {
+            move.src_x = first;
+            move.dst_x = first;
+            move.width = last - first;
+            move.src_y = runs[i].start - runs[i].shift;
+            move.dst_y = runs[i].start;
+            move.height = runs[i].end - runs[i].start;
+        } else {
+            move.src_y = first;
+            move.dst_y = first;
+            move.height = last - first;
+            move.src_x = runs[i].start - runs[i].shift;
+            move.dst_x = runs[i].start;
+            move.width = runs[i].end - runs[i].start;
+        }
+        moves.push_back(move);
+        i = j;
+    }
+}
+
+int MotionDetector::Analyze(const uint8_t* frame, int stride, std::vector<MoveRect>& moves) {
+    moves.clear();
+    if (!frame || width_ <= 0) {
+        return 0;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    std::swap(row_hashes_, previous_row_hashes_);
+    std::swap(column_hashes_, previous_column_hashes_);
+    HashFrame(frame, stride);
+
+    if (has_previous_) {
+        stats_.frames++;
+        if (!hints_.empty()) {
+            moves = hints_;
+            stats_.hinted++;
+        } else {
+            runs_.clear();
+            FindRuns(row_hashes_.data(), previous_row_hashes_.data(), strips_, height_, runs_);
+            AppendMoves(runs_, true, moves);
+
+            // Горизонтальні - лише там, де вертикальних немає (цілі не перетинаються)
+            runs_.clear();
+            FindRuns(column_hashes_.data(), previous_column_hashes_.data(), bands_, width_, runs_);
+            horizontal_.clear();
+            AppendMoves(runs_, false, horizontal_);
+            const size_t vertical_count = moves.size();
+            for (const MoveRect& move : horizontal_) {
+                bool overlaps = false;
+                for (size_t i = 0; i < vertical_count && !overlaps; i++) {
+                    overlaps = Intersects(move, moves[i]);
+                }
+                if (!overlaps) {
+                    moves.push_back(move);
+                }
+            }
+
+            // Забагато - лишаються найбільші
+            if (moves.size() > kMaxMoves) {
+                std::sort(moves.begin(), moves.end(), [](const MoveRect& a, const MoveRect& b) {
+                    return (int64_t)a.width * a.height > (int64_t)b.width * b.height;
+                });
+                moves.resize(kMaxMoves);
+            }
+        }
+        stats_.moves += moves.size();
+        for (const MoveRect& move : moves) {
+            stats_.moved_pixels += (uint64_t)move.width * move.height;
+        }
+    }
+    has_previous_ = true;
+    hints_.clear();
+
+    stats_.last_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return (int)moves.size();
+}
@@ -0,0 +1,85 @@
+/**
+ * Motion Detector
+ * Прокрутка і переміщення блоків між сусідніми кадрами за хешами рядків:
+ * замість повторної передачі зсунутого вмісту - операції копіювання прямокутників
+ */
+
+#ifndef MOTION_DETECTOR_H
+#define MOTION_DETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "frame-view.h"
+
+struct MotionDetectorStats {
+    uint64_t frames = 0;            // Проаналізовані кадри (з попереднім для порівняння)
+    uint64_t hinted = 0;            // Кадри, де взято підказки джерела замість пошуку
+    uint64_t moves = 0;             // Знайдені переміщення
+    uint64_t moved_pixels = 0;      // Пікселі, що не передаються повторно
+    double last_ms = 0.0;           // Час останнього Analyze
+};
+
+// Кадр ділиться на смуги kBlockSize: вертикальні смуги для вертикальних зсувів
+// (хеш кожного рядка в смузі), горизонтальні - для горизонтальних (хеш кожного
+// стовпця). Хеші рахуються за один прохід по кадру. Зсув смуги - голосуванням
+// характерних змінених рядків, далі - неперервні відрізки, де рядок поточного кадру
+// дорівнює зсунутому рядку попереднього. Хибне переміщення не псує картинку:
+// плитки, що після нього все одно відрізняються, кодер передає як залишок.
+class MotionDetector {
+public:
+    static constexpr int kBlockSize = 64;
+    static constexpr int kMinRunLength = 32;    // Мінімальна довжина переміщення вздовж зсуву
+    static constexpr size_t kMaxMoves = 64;
+
+    MotionDetector();
+
+    bool Initialize(int width, int height);
+    // Наступний Analyze лише запам'ятає кадр
+    void Reset() { has_previous_ = false; }
+
+    // Підказки для наступного Analyze (DXGI move rects): якщо є, пошук не виконується.
+    // Прямокутники поза кадром обрізаються.
+    void SetHints(const std::vector<MoveRect>& hints);
+
+    // Переміщення від попереднього кадру до цього. Джерела читаються з попереднього
+    // кадру (до застосування будь-якого з переміщень), цілі не перетинаються.
+    // Повертає кількість переміщень.
+    int Analyze(const uint8_t* frame, int stride, std::vector<MoveRect>& moves);
+
+    MotionDetectorStats GetStats() const { return stats_; }
+    int GetWidth() const { return width_; }
+    int GetHeight() const { return height_; }
+
+private:
+    // Відрізок [start, end) уздовж осі зсуву в смузі band, джерело - start - shift
+    struct Run {
+        int band;
+        int start;
+        int end;
+        int shift;
+    };
+
+    void HashFrame(const uint8_t* frame, int stride);
+    void FindRuns(const uint64_t* current, const uint64_t* previous, int bands, int length,
+                  std::vector<Run>& runs);
+    void AppendMoves(std::vector<Run>& runs, bool vertical, std::vector<MoveRect>& moves);
+
+    int width_ = 0;
+    int height_ = 0;
+    int strips_ = 0;                    // Вертикальні смуги (по kBlockSize стовпців)
+    int bands_ = 0;                     // Горизонтальні смуги (по kBlockSize рядків)
+    bool has_previous_ = false;
+    // [strip * height + y] - хеш рядка y у смузі; [band * width + x] - хеш стовпця x
+    std::vector<uint64_t> row_hashes_;
+    std::vector<uint64_t> previous_row_hashes_;
+    std::vector<uint64_t> column_hashes_;
+    std::vector<uint64_t> previous_column_hashes_;
+    std::vector<MoveRect> hints_;
+    std::vector<Run> runs_;
+    std::vector<int> anchors_;
+    std::vector<MoveRect> horizontal_;
+    MotionDetectorStats stats_;
+};
+
+#endif // MOTION_DETECTOR_H
@@ -0,0 +1,286 @@
+/**
+ * Multi-Output Capture Implementation
+ */
+
+#include "multi-output-capture.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t kCanvasBackground = 0xFF000000u;     // Непрозорий чорний, як DXGI
+
+void CopyRect(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+              int x, int y, int width, int height) {
+    const size_t offset_bytes = (size_t)x * 4;
+    for (int row = y; row < y + height; row++) {
+        memcpy(dst + (size_t)row * dst_stride + offset_bytes,
+               src + (size_t)row * src_stride + offset_bytes, (size_t)width * 4);
+    }
+}
+
+} // namespace
+
+MultiOutputCapture::MultiOutputCapture() {
+}
+
+MultiOutputCapture::~MultiOutputCapture() {
+    Cleanup();
+}
+
+void MultiOutputCapture::SetError(const std::string& error) {
+    last_error_ = error;
+}
+
+void MultiOutputCapture::AddOutput(std::unique_ptr<CaptureSource> source, const CaptureOutputInfo& info) {
+    std::unique_ptr<Output> output(new Output());
+    output->source = std::move(source);
+    output->info = info;
+    outputs_.push_back(std::move(output));
+}
+
+bool MultiOutputCapture::Initialize(int width, int height) {
+    (void)width;
+    (void)height;
+    StopWorkers();
+
+    if (outputs_.empty() || (int)outputs_.size() > kMaxOutputs) {
+        SetError("Stitched capture requires 1.." + std::to_string(kMaxOutputs) + " outputs");
+        return false;
+    }
+
+    // Кожен вихід - у власному розмірі (масштаб робиться вже для склеєного кадру)
+    int min_x = INT_MAX;
+    int min_y = INT_MAX;
+    int max_x = INT_MIN;
+    int max_y = INT_MIN;
+    for (auto& output : outputs_) {
+        if (!output->source->Initialize(0, 0)) {
+            SetError("Output " + std::to_string(output->info.index) + ": " +
+                     output->source->GetLastError());
+            return false;
+        }
+        output->info.width = output->source->GetWidth();
+        output->info.height = output->source->GetHeight();
+        min_x = std::min(min_x, output->info.x);
+        min_y = std::min(min_y, output->info.y);
+        max_x = std::max(max_x, output->info.x + output->info.width);
+        max_y = std::max(max_y, output->info.y + output->info.height);
+    }
+
+    for (auto& output : outputs_) {
+        output->info.x -= min_x;
+        output->info.y -= min_y;
+    }
+    // Дзеркальні монітори писали б в один прямокутник з різних потоків
+    for (size_t i = 0; i < outputs_.size(); i++) {
+        for (size_t j = i + 1; j < outputs_.size(); j++) {
+            const CaptureOutputInfo& a = outputs_[i]->info;
+            const CaptureOutputInfo& b = outputs_[j]->info;
+            if (a.x < b.x + b.width && b.x < a.x + a.width &&
+                a.y < b.y + b.height && b.y < a.y + a.height) {
+                SetError("Outputs overlap (mirrored displays) - capture them separately");
+                return false;
+            }
+        }
+    }
+
+    width_ = max_x - min_x;
+    height_ = max_y - min_y;
+    if (!canvas_.Resize((size_t)width_ * height_ * 4)) {
+        SetError("Failed to allocate stitched canvas");
+        width_ = 0;
+        height_ = 0;
+        return false;
+    }
+    uint32_t* pixels = reinterpret_cast<uint32_t*>(canvas_.data());
+    std::fill(pixels, pixels + (size_t)width_ * height_, kCanvasBackground);
+    ComputeGaps();
+
+    // Потоки ще не запущені - mutex не потрібен. Після повторного Initialize
+    // лічильник фаз не з нуля: потік стартує з поточного значення.
+    stopping_ = false;
+    const uint64_t generation = generation_;
+    for (auto& output : outputs_) {
+        Output* worker = output.get();
+        output->thread = std::thread([this, worker, generation]() { WorkerMain(*worker, generation); });
+    }
+    return true;
+}
+
+void MultiOutputCapture::ComputeGaps() {
+    gaps_.clear();
+
+    // Смуги між усіма верхніми/нижніми межами виходів; у кожній - непокриті відрізки
+    std::vector<int> bands = { 0, height_ };
+    for (const auto& output : outputs_) {
+        bands.push_back(output->info.y);
+        bands.push_back(output->info.y + output->info.height);
+    }
+    std::sort(bands.begin(), bands.end());
+    bands.erase(std::unique(bands.begin(), bands.end()), bands.end());
+
+    for (size_t b = 0; b + 1 < bands.size(); b++) {
+        const int y0 = bands[b];
+        const int y1 = bands[b + 1];
+        std::vector<std::pair<int, int>> covered;
+        for (const auto& output : outputs_) {
+            if (output->info.y <= y0 && output->info.y + output->info.height >= y1) {
+                covered.push_back({ output->info.x, output->info.x + output->info.width });
+            }
+        }
+        std::sort(covered.begin(), covered.end());
+
+        int x = 0;
+        for (const auto& span : covered) {
+            if (span.first > x) {
+                gaps_.push_back({ x, y0, span.first - x, y1 - y0 });
+            }
+            x = std::max(x, span.second);
+        }
+        if (x < width_) {
+            gaps_.push_back({ x, y0, width_ - x, y1 - y0 });
+        }
+    }
+}
+
+void MultiOutputCapture::WorkerMain(Output& output, uint64_t seen) {
+    const int canvas_stride = width_ * 4;
+    const CaptureOutputInfo& info = output.info;
+
+    for (;;) {
+        Phase phase;
+        uint8_t* dst;
+        int dst_stride;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this, seen]() { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+            phase = phase_;
+            dst = dst_;
+            dst_stride = dst_stride_;
+        }
+
+        if (phase == Phase::Capture) {
+            // Вихід без нового кадру лишає в полотні попередній
+            uint8_t* target = canvas_.data() + (size_t)info.y * canvas_stride + (size_t)info.x * 4;
+            output.captured = output.source->CaptureFrame(target, canvas_stride);
+        } else {
+            CopyRect(canvas_.data(), canvas_stride, dst, dst_stride,
+                     info.x, info.y, info.width, info.height);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+void MultiOutputCapture::RunPhase(Phase phase) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    phase_ = phase;
+    pending_ = (int)outputs_.size();
+    generation_++;
+    work_cv_.notify_all();
+
+    if (phase == Phase::Copy) {
+        // Порожні частини полотна - на викликаючому потоці, поки виходи копіюють свої
+        lock.unlock();
+        for (const Rect& gap : gaps_) {
+            CopyRect(canvas_.data(), width_ * 4, dst_, dst_stride_, gap.x, gap.y, gap.width, gap.height);
+        }
+        lock.lock();
+    }
+    done_cv_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+bool MultiOutputCapture::CaptureFrame(uint8_t* dst, int dst_stride) {
+    if (!canvas_.data()) {
+        SetError("Not initialized");
+        return false;
+    }
+    if (!dst || dst_stride < width_ * 4) {
+        SetError("Invalid destination buffer");
+        return false;
+    }
+
+    // Усі виходи чекають на AcquireNextFrame одночасно, а не по черзі
+    RunPhase(Phase::Capture);
+
+    bool any = false;
+    for (const auto& output : outputs_) {
+        any = any || output->captured;
+    }
+    if (!any) {
+        return false;
+    }
+
+    dst_ = dst;
+    dst_stride_ = dst_stride;
+    RunPhase(Phase::Copy);
+    return true;
+}
+
+void MultiOutputCapture::StopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& output : outputs_) {
+        if (output->thread.joinable()) {
+            output->thread.join();
+        }
+    }
+}
+
+void MultiOutputCapture::Cleanup() {
+    StopWorkers();
+    for (auto& output : outputs_) {
+        output->source->Cleanup();
+    }
+    canvas_ = AlignedBuffer();
+    gaps_.clear();
+    width_ = 0;
+    height_ = 0;
+}
+
+void MultiOutputCapture::SetAcquireTimeout(unsigned int timeout_ms) {
+    for (auto& output : outputs_) {
+        output->source->SetAcquireTimeout(timeout_ms);
+    }
+}
+
+int MultiOutputCapture::GetAccumulatedFrames() const {
+    // Найактивніший вихід визначає, чи встигає частота захоплення
+    int accumulated = -1;
+    for (const auto& output : outputs_) {
+        accumulated = std::max(accumulated, output->source->GetAccumulatedFrames());
+    }
+    return accumulated;
+}
+
+std::string MultiOutputCapture::GetLastError() const {
+    if (!last_error_.empty()) {
+        return last_error_;
+    }
+    for (const auto& output : outputs_) {
+        std::string error = output->source->GetLastError();
+        if (!error.empty()) {
+            return "Output " + std::to_string(output->info.index) + ": " + error;
+        }
+    }
+    return std::string();
+}
+
+CaptureOutputInfo MultiOutputCapture::GetOutputInfo(int index) const {
+    if (index < 0 || index >= (int)outputs_.size()) {
+        return CaptureOutputInfo();
+    }
+    return outputs_[index]->info;
+}
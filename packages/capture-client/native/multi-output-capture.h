@@ -0,0 +1,99 @@
+/**
+ * Multi-Output Capture
+ * Кілька моніторів як одне джерело (склеєне полотно): кожен вихід захоплюється
+ * на власному потоці прямо у свій прямокутник полотна
+ */
+
+#ifndef MULTI_OUTPUT_CAPTURE_H
+#define MULTI_OUTPUT_CAPTURE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "aligned-memory.h"
+#include "capture-source.h"
+
+class MultiOutputCapture : public CaptureSource {
+public:
+    static constexpr int kMaxOutputs = 8;
+
+    MultiOutputCapture();
+    ~MultiOutputCapture() override;
+
+    MultiOutputCapture(const MultiOutputCapture&) = delete;
+    MultiOutputCapture& operator=(const MultiOutputCapture&) = delete;
+
+    // До Initialize: джерело виходу і його місце на робочому столі (info.x/y)
+    void AddOutput(std::unique_ptr<CaptureSource> source, const CaptureOutputInfo& info);
+
+    // width/height ігноруються: полотно - прямокутник, що охоплює всі виходи
+    bool Initialize(int width = 0, int height = 0) override;
+    // false - жоден вихід не має нового кадру (dst не змінюється)
+    bool CaptureFrame(uint8_t* dst, int dst_stride) override;
+    void Cleanup() override;
+
+    // Виходи копіюють рядки на власних потоках - спільний пул їх лише серіалізував би
+    void SetWorkerPool(WorkerPool* pool) override { (void)pool; }
+    void SetAcquireTimeout(unsigned int timeout_ms) override;
+    int GetAccumulatedFrames() const override;
+
+    const char* GetName() const override { return "stitched"; }
+    int GetWidth() const override { return width_; }
+    int GetHeight() const override { return height_; }
+    std::string GetLastError() const override;
+
+    int GetOutputCount() const { return (int)outputs_.size(); }
+    // Прямокутник виходу на полотні (x/y відносно лівого верхнього кута полотна)
+    CaptureOutputInfo GetOutputInfo(int index) const;
+
+private:
+    enum class Phase {
+        Capture,    // Захопити вихід у його прямокутник полотна
+        Copy        // Скопіювати прямокутник полотна в dst
+    };
+
+    struct Output {
+        std::unique_ptr<CaptureSource> source;
+        CaptureOutputInfo info;         // x/y - на полотні після Initialize
+        std::thread thread;
+        bool captured = false;
+    };
+
+    struct Rect {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    void WorkerMain(Output& output, uint64_t seen);
+    void RunPhase(Phase phase);
+    void StopWorkers();
+    void ComputeGaps();
+    void SetError(const std::string& error);
+
+    std::vector<std::unique_ptr<Output>> outputs_;
+    std::vector<Rect> gaps_;            // Частини полотна без виходів (чорні)
+    AlignedBuffer canvas_;              // Останній кадр кожного виходу
+    int width_ = 0;
+    int height_ = 0;
+
+    // Поточна фаза для потоків виходів
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    Phase phase_ = Phase::Capture;
+    uint64_t generation_ = 0;
+    int pending_ = 0;
+    bool stopping_ = false;
+    uint8_t* dst_ = nullptr;
+    int dst_stride_ = 0;
+
+    std::string last_error_;
+};
+
+#endif // MULTI_OUTPUT_CAPTURE_H
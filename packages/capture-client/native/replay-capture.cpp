@@ -0,0 +1,252 @@
+/**
+ * Replay Capture Source Implementation
+ */
+
+#include "replay-capture.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+ReplayCapture::ReplayCapture(const std::string& path, bool realtime, bool loop)
+    : path_(path), realtime_(realtime), loop_(loop) {
+}
+
+ReplayCapture::~ReplayCapture() {
+    Cleanup();
+}
+
+void ReplayCapture::SetError(const std::string& error) {
+    last_error_ = error;
+}
+
+bool ReplayCapture::EnumerateOutputs(const std::string& path, std::vector<CaptureOutputInfo>& outputs,
+                                     std::string& error) {
+    outputs.clear();
+    CaptureRecording recording;
+    if (!recording.Open(path)) {
+        error = recording.GetLastError();
+        return false;
+    }
+    CaptureOutputInfo output;
+    output.name = path;
+    output.width = recording.GetWidth();
+    output.height = recording.GetHeight();
+    output.primary = true;
+    outputs.push_back(output);
+    return true;
+}
+
+bool ReplayCapture::SetRegion(const FrameRect& region) {
+    region_ = region;
+    return true;
+}
+
+bool ReplayCapture::Initialize(int width, int height) {
+    (void)width;
+    (void)height;
+    Cleanup();
+
+    if (path_.empty()) {
+        SetError("Replay requires a recording path");
+        return false;
+    }
+    if (!recording_.Open(path_)) {
+        SetError(recording_.GetLastError());
+        return false;
+    }
+    FrameRect crop;
+    if (!ResolveCaptureRegion(region_, recording_.GetWidth(), recording_.GetHeight(), crop)) {
+        recording_.Close();
+        SetError("Capture region is outside the recording");
+        return false;
+    }
+    // Полотно потрібне лише дельта-записам: повні кадри читаються з файлу
+    if (recording_.IsDelta() &&
+        !canvas_.Resize((size_t)recording_.GetStride() * recording_.GetHeight())) {
+        recording_.Close();
+        SetError("Failed to allocate replay canvas");
+        return false;
+    }
+
+    crop_ = crop;
+    position_ = 0;
+    loops_ = 0;
+    current_ = nullptr;
+    accumulated_frames_ = 0;
+    start_time_ = Clock::now();
+    return true;
+}
+
+void ReplayCapture::Cleanup() {
+    recording_.Close();
+    canvas_ = AlignedBuffer();
+    current_ = nullptr;
+    crop_ = FrameRect();
+    dirty_.clear();
+    moves_.clear();
+}
+
+bool ReplayCapture::WaitForNextFrame() {
+    if (!realtime_) {
+        return true;
+    }
+
+    const auto due = start_time_ + std::chrono::microseconds(recording_.GetTimestampUs(position_));
+    const auto now = Clock::now();
+    if (now < due) {
+        // Чекати не довше за timeout, як AcquireNextFrame
+        const auto timeout = std::chrono::milliseconds(acquire_timeout_ms_);
+        if (due - now > timeout) {
+            if (acquire_timeout_ms_ > 0) {
+                std::this_thread::sleep_for(timeout);
+            }
+            return false;
+        }
+        std::this_thread::sleep_until(due);
+    }
+    return true;
+}
+
+size_t ReplayCapture::GetDueFrames(Clock::time_point now) const {
+    // Споживач відстав - кадри, яким уже настав час, зливаються в один (як DXGI AccumulatedFrames)
+    const uint64_t elapsed_us = (uint64_t)std::max<int64_t>(
+        0, std::chrono::duration_cast<std::chrono::microseconds>(now - start_time_).count());
+    size_t last = position_;
+    while (last + 1 < recording_.GetFrameCount() && recording_.GetTimestampUs(last + 1) <= elapsed_us) {
+        last++;
+    }
+    return last - position_ + 1;
+}
+
+void ReplayCapture::ApplyFrame(const RecordedFrame& frame) {
+    if (frame.full) {
+        current_ = frame.pixels;
+        return;
+    }
+
+    // Перша дельта після повного кадру: полотно отримує його вміст
+    const int stride = recording_.GetStride();
+    uint8_t* canvas = canvas_.data();
+    if (current_ != canvas) {
+        copier_.CopyRows(current_, stride, canvas, stride, stride, recording_.GetHeight());
+        current_ = canvas;
+    }
+    const uint8_t* src = frame.pixels;
+    for (int i = 0; i < frame.dirty_count; i++) {
+        const FrameRect& rect = frame.dirty[i];
+        const size_t row_bytes = (size_t)rect.width * 4;
+        for (int y = 0; y < rect.height; y++) {
+            memcpy(canvas + (size_t)(rect.y + y) * stride + (size_t)rect.x * 4, src, row_bytes);
+            src += row_bytes;
+        }
+    }
+}
+
+bool ReplayCapture::AcquireFrameView(FrameView& view) {
+    if (recording_.GetFrameCount() == 0) {
+        SetError("Not initialized");
+        return false;
+    }
+
+    if (position_ >= recording_.GetFrameCount()) {
+        // Кінець запису без повтору - як екран без змін
+        if (!loop_) {
+            return false;
+        }
+        position_ = 0;
+        loops_++;
+        start_time_ = Clock::now();
+    }
+    if (!WaitForNextFrame()) {
+        return false;
+    }
+
+    const size_t count = realtime_ ? GetDueFrames(Clock::now()) : 1;
+    const size_t last = position_ + count - 1;
+    // Пікселі - лише від останнього повного кадру серед злитих
+    size_t first_applied = position_;
+    for (size_t i = last; i > position_; i--) {
+        if (recording_.IsFullFrame(i)) {
+            first_applied = i;
+            break;
+        }
+    }
+
+    dirty_.clear();
+    moves_.clear();
+    RecordedFrame frame;
+    for (size_t i = position_; i <= last; i++) {
+        recording_.GetFrame(i, frame);
+        if (i >= first_applied) {
+            ApplyFrame(frame);
+        }
+        // Області в координатах регіону
+        for (int k = 0; k < frame.dirty_count; k++) {
+            FrameRect rect = frame.dirty[k];
+            const int x0 = std::max(rect.x, crop_.x);
+            const int y0 = std::max(rect.y, crop_.y);
+            const int x1 = std::min(rect.x + rect.width, crop_.x + crop_.width);
+            const int y1 = std::min(rect.y + rect.height, crop_.y + crop_.height);
+            if (x0 < x1 && y0 < y1) {
+                rect.x = x0 - crop_.x;
+                rect.y = y0 - crop_.y;
+                rect.width = x1 - x0;
+                rect.height = y1 - y0;
+                dirty_.push_back(rect);
+            }
+        }
+        // Переміщення злитих кадрів не складаються - лише для одного кадру
+        for (int k = 0; count == 1 && k < frame.move_count; k++) {
+            MoveRect move = frame.moves[k];
+            move.src_x -= crop_.x;
+            move.dst_x -= crop_.x;
+            move.src_y -= crop_.y;
+            move.dst_y -= crop_.y;
+            if (ClipMoveRect(move, crop_.width, crop_.height)) {
+                moves_.push_back(move);
+            }
+        }
+    }
+    accumulated_frames_ = (int)count;
+    position_ = last + 1;
+
+    // Кадр у файлі або на полотні не змінюється до наступного AcquireFrameView
+    const int stride = recording_.GetStride();
+    view.data = current_ + (size_t)crop_.y * stride + (size_t)crop_.x * 4;
+    view.stride = stride;
+    view.width = crop_.width;
+    view.height = crop_.height;
+    view.format = recording_.GetFormat();
+    view.crop = crop_;
+    return true;
+}
+
+bool ReplayCapture::CaptureFrame(uint8_t* dst, int dst_stride) {
+    if (!dst || dst_stride < crop_.width * 4) {
+        SetError("Invalid destination buffer");
+        return false;
+    }
+
+    FrameView view;
+    if (!AcquireFrameView(view)) {
+        return false;
+    }
+    if (view.format == PixelFormat::BGRA) {
+        copier_.CopyRows(view.data, view.stride, dst, dst_stride, view.width * 4, view.height);
+    } else {
+        CopyFrameView(view, dst, dst_stride);
+    }
+    return true;
+}
+
+bool ReplayCapture::GetMoveRects(std::vector<MoveRect>& moves) const {
+    moves = moves_;
+    return true;
+}
+
+bool ReplayCapture::GetDirtyRects(std::vector<FrameRect>& rects) const {
+    rects = dirty_;
+    return true;
+}
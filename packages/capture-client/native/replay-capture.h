@@ -0,0 +1,86 @@
+/**
+ * Replay Capture Source
+ * Відтворення запису (capture-recording.h) як джерела кадрів: у темпі оригіналу або
+ * якнайшвидше. Повні кадри віддаються view прямо у відображений файл (без копіювання),
+ * дельта-кадри накладаються на полотно лише зміненими прямокутниками.
+ */
+
+#ifndef REPLAY_CAPTURE_H
+#define REPLAY_CAPTURE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "aligned-memory.h"
+#include "capture-recording.h"
+#include "capture-source.h"
+#include "frame-converter.h"
+
+class ReplayCapture : public CaptureSource {
+public:
+    // realtime = false - новий кадр на кожен виклик (пропускна здатність конвеєра);
+    // loop = false - після останнього кадру нових кадрів немає
+    ReplayCapture(const std::string& path, bool realtime = true, bool loop = true);
+    ~ReplayCapture() override;
+
+    // Один вихід розміру запису
+    static bool EnumerateOutputs(const std::string& path, std::vector<CaptureOutputInfo>& outputs,
+                                 std::string& error);
+
+    // Розмір задає запис (запит width/height ігнорується - масштабує module.cpp)
+    bool Initialize(int width = 0, int height = 0) override;
+    bool CaptureFrame(uint8_t* dst, int dst_stride) override;
+    void Cleanup() override;
+
+    bool SetRegion(const FrameRect& region) override;
+    bool SupportsFrameView() const override { return true; }
+    bool AcquireFrameView(FrameView& view) override;
+    PixelFormat GetViewFormat() const override { return recording_.GetFormat(); }
+
+    void SetWorkerPool(WorkerPool* pool) override { copier_.SetWorkerPool(pool); }
+    void SetAcquireTimeout(unsigned int timeout_ms) override { acquire_timeout_ms_ = timeout_ms; }
+    int GetAccumulatedFrames() const override { return accumulated_frames_; }
+    bool GetMoveRects(std::vector<MoveRect>& moves) const override;
+    bool GetDirtyRects(std::vector<FrameRect>& rects) const override;
+
+    const char* GetName() const override { return "replay"; }
+    int GetWidth() const override { return crop_.width; }
+    int GetHeight() const override { return crop_.height; }
+    std::string GetLastError() const override { return last_error_; }
+
+    size_t GetFrameCount() const { return recording_.GetFrameCount(); }
+    // Наступний кадр запису і кількість завершених проходів
+    size_t GetPosition() const { return position_; }
+    uint64_t GetLoopCount() const { return loops_; }
+
+private:
+    // Скільки кадрів від position_ уже настав час показати (щонайменше 1)
+    size_t GetDueFrames(std::chrono::steady_clock::time_point now) const;
+    bool WaitForNextFrame();
+    // Перейти до кадру position_: повний - вказівник у файл, дельта - на полотно
+    void ApplyFrame(const RecordedFrame& frame);
+    void SetError(const std::string& error);
+
+    std::string path_;
+    bool realtime_;
+    bool loop_;
+    unsigned int acquire_timeout_ms_ = kDefaultAcquireTimeoutMs;
+
+    CaptureRecording recording_;
+    FrameRect region_;              // Запит SetRegion (порожній - увесь кадр)
+    FrameRect crop_;                // Регіон після Initialize
+    AlignedBuffer canvas_;          // Стан екрану для дельта-кадрів
+    FrameConverter copier_;
+    const uint8_t* current_ = nullptr;  // Поточний кадр: у файлі або canvas_
+
+    size_t position_ = 0;
+    uint64_t loops_ = 0;
+    std::chrono::steady_clock::time_point start_time_;  // Момент кадру 0 поточного проходу
+    int accumulated_frames_ = 0;
+    std::vector<FrameRect> dirty_;
+    std::vector<MoveRect> moves_;
+    std::string last_error_;
+};
+
+#endif // REPLAY_CAPTURE_H
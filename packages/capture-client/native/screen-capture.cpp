@@ -4,13 +4,81 @@
  */
 
 #include "screen-capture.h"
+#include "stats.h"
 #include <stdexcept>
 #include <sstream>
 
+#include <string>
+
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
 
-ScreenCapture::ScreenCapture() {
+namespace {
+
+// Вихід за наскрізним індексом (адаптер за адаптером); false - такого немає
+bool FindOutput(int index, IDXGIAdapter1** found_adapter, IDXGIOutput** found_output,
+                std::vector<CaptureOutputInfo>* outputs) {
+    IDXGIFactory1* factory = nullptr;
+    if (FAILED(CreateDXGIFactory1(__uuidof(IDXGIFactory1), (void**)&factory))) {
+        return false;
+    }
+
+    bool found = false;
+    int next_index = 0;
+    IDXGIAdapter1* adapter = nullptr;
+    for (UINT a = 0; !found && factory->EnumAdapters1(a, &adapter) != DXGI_ERROR_NOT_FOUND; a++) {
+        IDXGIOutput* output = nullptr;
+        for (UINT o = 0; !found && adapter->EnumOutputs(o, &output) != DXGI_ERROR_NOT_FOUND; o++) {
+            DXGI_OUTPUT_DESC desc;
+            if (FAILED(output->GetDesc(&desc)) || !desc.AttachedToDesktop) {
+                output->Release();
+                continue;
+            }
+
+            if (outputs) {
+                CaptureOutputInfo info;
+                info.index = next_index;
+                char name[64] = {};
+                WideCharToMultiByte(CP_UTF8, 0, desc.DeviceName, -1, name, sizeof(name) - 1,
+                                    nullptr, nullptr);
+                info.name = name;
+                info.x = desc.DesktopCoordinates.left;
+                info.y = desc.DesktopCoordinates.top;
+                info.width = desc.DesktopCoordinates.right - desc.DesktopCoordinates.left;
+                info.height = desc.DesktopCoordinates.bottom - desc.DesktopCoordinates.top;
+                // Основний монітор Windows завжди має початок координат (0, 0)
+                info.primary = info.x == 0 && info.y == 0;
+                outputs->push_back(info);
+            }
+
+            if (next_index++ == index && found_output) {
+                adapter->AddRef();
+                *found_adapter = adapter;
+                *found_output = output;
+                found = true;
+            } else {
+                output->Release();
+            }
+        }
+        adapter->Release();
+    }
+
+    factory->Release();
+    return found || (outputs && !found_output);
+}
+
+} // namespace
+
+ScreenCapture::ScreenCapture(int output) : output_(output) {
+}
+
+bool ScreenCapture::EnumerateOutputs(std::vector<CaptureOutputInfo>& outputs, std::string& error) {
+    outputs.clear();
+    if (!FindOutput(-1, nullptr, nullptr, &outputs)) {
+        error = "Failed to enumerate DXGI outputs";
+        return false;
+    }
+    return true;
 }
 
 ScreenCapture::~ScreenCapture() {
@@ -25,21 +93,40 @@ bool ScreenCapture::Initialize(int width, int height) {
     // Очистити попередні ресурси
     Cleanup();
 
+    // Duplication створюється лише на пристрої адаптера, до якого під'єднано монітор
+    IDXGIAdapter1* adapter = nullptr;
+    IDXGIOutput* output = nullptr;
+    if (!FindOutput(output_, &adapter, &output, nullptr)) {
+        SetError("Output not found: " + std::to_string(output_));
+        return false;
+    }
+
     // Ініціалізувати D3D11
-    if (!InitializeD3D()) {
+    bool ok = InitializeD3D(adapter);
+    adapter->Release();
+    if (!ok) {
+        output->Release();
         return false;
     }
 
     // Ініціалізувати Desktop Duplication
-    if (!InitializeDuplication()) {
+    ok = InitializeDuplication(output);
+    output->Release();
+    if (!ok) {
         Cleanup();
         return false;
     }
 
     // ВИПРАВЛЕННЯ: Завжди захоплювати весь екран (ігнорувати width/height параметри)
-    // Це вирішує проблему з обрізкою та світлою картинкою
-    width_ = desktop_width_;
-    height_ = desktop_height_;
+    // Це вирішує проблему з обрізкою та світлою картинкою; width/height досягаються масштабом у module.cpp.
+    // Обрізається лише явно запитаний регіон.
+    if (!ResolveCaptureRegion(region_, desktop_width_, desktop_height_, crop_)) {
+        SetError("Capture region is outside the output");
+        Cleanup();
+        return false;
+    }
+    width_ = crop_.width;
+    height_ = crop_.height;
 
     // Створити staging texture для копіювання з GPU
     if (!CreateStagingTexture()) {
@@ -50,7 +137,7 @@ bool ScreenCapture::Initialize(int width, int height) {
     return true;
 }
 
-bool ScreenCapture::InitializeD3D() {
+bool ScreenCapture::InitializeD3D(IDXGIAdapter1* adapter) {
     HRESULT hr;
 
     // Створити D3D11 Device та Context
@@ -58,8 +145,8 @@ bool ScreenCapture::InitializeD3D() {
     D3D_FEATURE_LEVEL feature_levels[] = { D3D_FEATURE_LEVEL_11_0 };
 
     hr = D3D11CreateDevice(
-        nullptr,                    // Adapter (nullptr = default)
-        D3D_DRIVER_TYPE_HARDWARE,   // Апаратне прискорення
+        adapter,                    // Адаптер виходу
+        D3D_DRIVER_TYPE_UNKNOWN,    // Обов'язково з явним адаптером (апаратний пристрій)
         nullptr,                    // Software rasterizer
         0,                          // Flags
         feature_levels,
@@ -78,35 +165,9 @@ bool ScreenCapture::InitializeD3D() {
     return true;
 }
 
-bool ScreenCapture::InitializeDuplication() {
+bool ScreenCapture::InitializeDuplication(IDXGIOutput* dxgi_output) {
     HRESULT hr;
 
-    // Отримати DXGI Device
-    IDXGIDevice* dxgi_device = nullptr;
-    hr = d3d_device_->QueryInterface(__uuidof(IDXGIDevice), (void**)&dxgi_device);
-    if (FAILED(hr)) {
-        SetError("Failed to get DXGI Device");
-        return false;
-    }
-
-    // Отримати DXGI Adapter
-    IDXGIAdapter* dxgi_adapter = nullptr;
-    hr = dxgi_device->GetParent(__uuidof(IDXGIAdapter), (void**)&dxgi_adapter);
-    dxgi_device->Release();
-    if (FAILED(hr)) {
-        SetError("Failed to get DXGI Adapter");
-        return false;
-    }
-
-    // Отримати Output (монітор)
-    IDXGIOutput* dxgi_output = nullptr;
-    hr = dxgi_adapter->EnumOutputs(0, &dxgi_output);
-    dxgi_adapter->Release();
-    if (FAILED(hr)) {
-        SetError("Failed to get DXGI Output");
-        return false;
-    }
-
     // Отримати розмір екрану
     DXGI_OUTPUT_DESC output_desc;
     dxgi_output->GetDesc(&output_desc);
@@ -116,7 +177,6 @@ bool ScreenCapture::InitializeDuplication() {
     // Отримати IDXGIOutput1
     IDXGIOutput1* dxgi_output1 = nullptr;
     hr = dxgi_output->QueryInterface(__uuidof(IDXGIOutput1), (void**)&dxgi_output1);
-    dxgi_output->Release();
     if (FAILED(hr)) {
         SetError("Failed to get IDXGIOutput1");
         return false;
@@ -161,7 +221,25 @@ bool ScreenCapture::CreateStagingTexture() {
     return true;
 }
 
-bool ScreenCapture::CaptureFrame(std::vector<uint8_t>& frameData) {
+bool ScreenCapture::SetRegion(const FrameRect& region) {
+    region_ = region;
+    return true;
+}
+
+bool ScreenCapture::CaptureFrame(uint8_t* dst, int dst_stride) {
+    FrameView view;
+    if (!AcquireFrameView(view)) {
+        return false;
+    }
+
+    // Копіювати рядок за рядком (враховуючи pitch), смугами на пулі потоків
+    copier_.CopyRows(view.data, view.stride, dst, dst_stride, view.width * 4, view.height);
+
+    ReleaseFrameView();
+    return true;
+}
+
+bool ScreenCapture::AcquireFrameView(FrameView& view) {
     if (!duplication_ || !staging_texture_) {
         SetError("Not initialized");
         return false;
@@ -171,15 +249,22 @@ bool ScreenCapture::CaptureFrame(std::vector<uint8_t>& frameData) {
     IDXGIResource* desktop_resource = nullptr;
     DXGI_OUTDUPL_FRAME_INFO frame_info;
 
-    // Отримати наступний кадр (timeout 100ms)
-    hr = duplication_->AcquireNextFrame(100, &frame_info, &desktop_resource);
+    // Отримати наступний кадр (timeout 100ms, 0 у режиму асинхронного циклу)
+    CaptureStats& stats = GetCaptureStats();
+    auto acquire_start = CaptureStats::Clock::now();
+    hr = duplication_->AcquireNextFrame(acquire_timeout_ms_, &frame_info, &desktop_resource);
+    stats.RecordSince(StatStage::Acquire, acquire_start);
+    accumulated_frames_ = SUCCEEDED(hr) ? (int)frame_info.AccumulatedFrames : 0;
+    move_rects_.clear();
     
     if (hr == DXGI_ERROR_WAIT_TIMEOUT) {
         // Немає нового кадру - це нормально
+        stats.Add(StatCounter::AcquireTimeouts);
         return false;
     }
     
     if (FAILED(hr)) {
+        stats.Add(StatCounter::Errors);
         if (hr == DXGI_ERROR_ACCESS_LOST) {
             // Desktop Duplication втрачено (зміна режиму екрану, тощо)
             SetError("Access lost - reinitialize required");
@@ -190,6 +275,11 @@ bool ScreenCapture::CaptureFrame(std::vector<uint8_t>& frameData) {
         return false;
     }
 
+    // Вказівник - окремим каналом: рух без змін екрану не дає кадру нижче
+    if (cursor_ && frame_info.LastMouseUpdateTime.QuadPart != 0) {
+        UpdateCursor(frame_info);
+    }
+
     // Перевірити чи є оновлення
     if (frame_info.LastPresentTime.QuadPart == 0) {
         desktop_resource->Release();
@@ -208,13 +298,30 @@ bool ScreenCapture::CaptureFrame(std::vector<uint8_t>& frameData) {
         return false;
     }
 
-    // Скопіювати в staging texture
-    // ВИПРАВЛЕННЯ: Завжди копіювати весь екран, не обрізати
-    d3d_context_->CopyResource(staging_texture_, desktop_texture);
+    // Переміщення вікон і прокрутка, які бачить DWM - підказка дельта-кодеру
+    if (frame_info.TotalMetadataBufferSize > 0) {
+        UpdateMoveRects(frame_info);
+    }
+
+    // Скопіювати в staging texture: весь екран або лише регіон (копія на GPU,
+    // з GPU на CPU переходять тільки рядки регіону)
+    auto map_start = CaptureStats::Clock::now();
+    if (width_ == desktop_width_ && height_ == desktop_height_) {
+        d3d_context_->CopyResource(staging_texture_, desktop_texture);
+    } else {
+        D3D11_BOX box = {};
+        box.left = crop_.x;
+        box.top = crop_.y;
+        box.front = 0;
+        box.right = crop_.x + crop_.width;
+        box.bottom = crop_.y + crop_.height;
+        box.back = 1;
+        d3d_context_->CopySubresourceRegion(staging_texture_, 0, 0, 0, 0, desktop_texture, 0, &box);
+    }
 
     desktop_texture->Release();
 
-    // Прочитати дані з staging texture
+    // Відобразити staging texture - стадії читають її напряму (з RowPitch)
     D3D11_MAPPED_SUBRESOURCE mapped_resource;
     hr = d3d_context_->Map(staging_texture_, 0, D3D11_MAP_READ, 0, &mapped_resource);
     
@@ -223,31 +330,90 @@ bool ScreenCapture::CaptureFrame(std::vector<uint8_t>& frameData) {
         SetError("Failed to map staging texture");
         return false;
     }
+    stats.RecordSince(StatStage::Map, map_start);
+    mapped_ = true;
+
+    view.data = static_cast<const uint8_t*>(mapped_resource.pData);
+    view.stride = (int)mapped_resource.RowPitch;
+    view.width = width_;
+    view.height = height_;
+    view.format = PixelFormat::BGRA;
+    view.crop = crop_;
+    return true;
+}
 
-    // Скопіювати дані (BGRA формат)
-    size_t frame_size = width_ * height_ * 4; // 4 bytes per pixel (BGRA)
-    frameData.resize(frame_size);
+void ScreenCapture::UpdateCursor(const DXGI_OUTDUPL_FRAME_INFO& frame_info) {
+    // Нова форма - лише коли PointerShapeBufferSize > 0, інакше діє попередня
+    if (frame_info.PointerShapeBufferSize > 0) {
+        pointer_shape_.resize(frame_info.PointerShapeBufferSize);
+        UINT required = 0;
+        DXGI_OUTDUPL_POINTER_SHAPE_INFO shape_info = {};
+        HRESULT hr = duplication_->GetFramePointerShape((UINT)pointer_shape_.size(), pointer_shape_.data(),
+                                                        &required, &shape_info);
+        if (SUCCEEDED(hr)) {
+            CursorShapeType type = CursorShapeType::Color;
+            int height = (int)shape_info.Height;
+            if (shape_info.Type == DXGI_OUTDUPL_POINTER_SHAPE_TYPE_MONOCHROME) {
+                type = CursorShapeType::Monochrome;
+                height /= 2;    // AND і XOR маски одна під одною
+            } else if (shape_info.Type == DXGI_OUTDUPL_POINTER_SHAPE_TYPE_MASKED_COLOR) {
+                type = CursorShapeType::MaskedColor;
+            }
+            CursorShape shape;
+            if (ConvertCursorShape(type, pointer_shape_.data(), (int)shape_info.Width, height,
+                                   (int)shape_info.Pitch, shape_info.HotSpot.x, shape_info.HotSpot.y, shape)) {
+                cursor_->UpdateShape(std::move(shape));
+            }
+        }
+    }
 
-    uint8_t* src = static_cast<uint8_t*>(mapped_resource.pData);
-    uint8_t* dst = frameData.data();
+    // Position - лівий верхній кут форми на моніторі; Visible = false - вказівник на іншому виході
+    cursor_->UpdatePosition(frame_info.PointerPosition.Visible != FALSE,
+                            frame_info.PointerPosition.Position.x - crop_.x,
+                            frame_info.PointerPosition.Position.y - crop_.y);
+}
 
-    // Копіювати рядок за рядком (враховуючи pitch)
-    for (int y = 0; y < height_; ++y) {
-        memcpy(dst, src, width_ * 4);
-        src += mapped_resource.RowPitch;
-        dst += width_ * 4;
+void ScreenCapture::UpdateMoveRects(const DXGI_OUTDUPL_FRAME_INFO& frame_info) {
+    // Метадані - переміщення і dirty rects разом, тож буфера такого розміру вистачає
+    move_buffer_.resize(frame_info.TotalMetadataBufferSize / sizeof(DXGI_OUTDUPL_MOVE_RECT) + 1);
+    UINT required = 0;
+    HRESULT hr = duplication_->GetFrameMoveRects((UINT)(move_buffer_.size() * sizeof(DXGI_OUTDUPL_MOVE_RECT)),
+                                                 move_buffer_.data(), &required);
+    if (FAILED(hr)) {
+        return;
     }
 
-    // Unmap
-    d3d_context_->Unmap(staging_texture_, 0);
+    // Координати монітора -> регіону; частини поза регіоном відкидаються
+    const UINT count = required / sizeof(DXGI_OUTDUPL_MOVE_RECT);
+    for (UINT i = 0; i < count; i++) {
+        const DXGI_OUTDUPL_MOVE_RECT& rect = move_buffer_[i];
+        MoveRect move;
+        move.src_x = rect.SourcePoint.x - crop_.x;
+        move.src_y = rect.SourcePoint.y - crop_.y;
+        move.dst_x = rect.DestinationRect.left - crop_.x;
+        move.dst_y = rect.DestinationRect.top - crop_.y;
+        move.width = rect.DestinationRect.right - rect.DestinationRect.left;
+        move.height = rect.DestinationRect.bottom - rect.DestinationRect.top;
+        if (ClipMoveRect(move, width_, height_)) {
+            move_rects_.push_back(move);
+        }
+    }
+}
 
-    // Звільнити кадр
-    duplication_->ReleaseFrame();
+void ScreenCapture::ReleaseFrameView() {
+    if (!mapped_) {
+        return;
+    }
 
-    return true;
+    // Unmap і звільнити кадр
+    d3d_context_->Unmap(staging_texture_, 0);
+    duplication_->ReleaseFrame();
+    mapped_ = false;
 }
 
 void ScreenCapture::Cleanup() {
+    ReleaseFrameView();
+
     if (staging_texture_) {
         staging_texture_->Release();
         staging_texture_ = nullptr;
@@ -9,37 +9,79 @@
 #include <windows.h>
 #include <d3d11.h>
 #include <dxgi1_2.h>
-#include <vector>
+#include <cstdint>
 #include <string>
+#include <vector>
+#include "capture-source.h"
+#include "cursor.h"
+#include "frame-converter.h"
 
-class ScreenCapture {
+// Бекенд CaptureSource для Windows (DXGI Desktop Duplication)
+class ScreenCapture : public CaptureSource {
 public:
-    ScreenCapture();
-    ~ScreenCapture();
+    // output - індекс з EnumerateOutputs (виходи всіх адаптерів по порядку)
+    explicit ScreenCapture(int output = 0);
+    ~ScreenCapture() override;
+
+    // Монітори, під'єднані до робочого столу, на всіх адаптерах
+    static bool EnumerateOutputs(std::vector<CaptureOutputInfo>& outputs, std::string& error);
+
+    bool Initialize(int width = 0, int height = 0) override;
+    bool CaptureFrame(uint8_t* dst, int dst_stride) override;
+    void Cleanup() override;
+
+    // Регіон копіюється з текстури робочого столу на GPU (CopySubresourceRegion),
+    // staging texture - розміру регіону
+    bool SetRegion(const FrameRect& region) override;
+    // View - відображена staging texture (RowPitch), кадр DXGI тримається до ReleaseFrameView
+    bool SupportsFrameView() const override { return true; }
+    bool AcquireFrameView(FrameView& view) override;
+    void ReleaseFrameView() override;
 
-    bool Initialize(int width = 0, int height = 0);
-    bool CaptureFrame(std::vector<uint8_t>& frameData);
-    void Cleanup();
+    // Пул потоків для смугового копіювання рядків з staging texture
+    void SetWorkerPool(WorkerPool* pool) override { copier_.SetWorkerPool(pool); }
+    // Позиція/форма з DXGI_OUTDUPL_FRAME_INFO::PointerPosition і GetFramePointerShape
+    void SetCursorTracker(CursorTracker* tracker) override { cursor_ = tracker; }
+    // Скільки чекати на новий кадр у AcquireNextFrame (0 - не блокувати)
+    void SetAcquireTimeout(unsigned int timeout_ms) override { acquire_timeout_ms_ = timeout_ms; }
+    int GetAccumulatedFrames() const override { return accumulated_frames_; }
+    // GetFrameMoveRects останнього кадру в координатах регіону. Порожньо - DXGI
+    // переміщень не бачив (прокрутку, яку застосунок перемальовує сам, шукає кодер).
+    bool GetMoveRects(std::vector<MoveRect>& moves) const override { moves = move_rects_; return true; }
 
-    int GetWidth() const { return width_; }
-    int GetHeight() const { return height_; }
-    std::string GetLastError() const { return last_error_; }
+    const char* GetName() const override { return "dxgi"; }
+    int GetWidth() const override { return width_; }
+    int GetHeight() const override { return height_; }
+    std::string GetLastError() const override { return last_error_; }
 
 private:
-    bool InitializeD3D();
-    bool InitializeDuplication();
+    bool InitializeD3D(IDXGIAdapter1* adapter);
+    bool InitializeDuplication(IDXGIOutput* output);
     bool CreateStagingTexture();
+    void UpdateCursor(const DXGI_OUTDUPL_FRAME_INFO& frame_info);
+    void UpdateMoveRects(const DXGI_OUTDUPL_FRAME_INFO& frame_info);
     void SetError(const std::string& error);
 
+    int output_ = 0;
     ID3D11Device* d3d_device_ = nullptr;
     ID3D11DeviceContext* d3d_context_ = nullptr;
     IDXGIOutputDuplication* duplication_ = nullptr;
     ID3D11Texture2D* staging_texture_ = nullptr;
+    bool mapped_ = false;           // staging texture відображена, кадр не звільнено
+    FrameConverter copier_;
+    CursorTracker* cursor_ = nullptr;
+    std::vector<uint8_t> pointer_shape_;    // Буфер GetFramePointerShape
+    std::vector<DXGI_OUTDUPL_MOVE_RECT> move_buffer_;   // Буфер GetFrameMoveRects
+    std::vector<MoveRect> move_rects_;
     
+    unsigned int acquire_timeout_ms_ = kDefaultAcquireTimeoutMs;
+    int accumulated_frames_ = 0;    // DXGI_OUTDUPL_FRAME_INFO::AccumulatedFrames останнього кадру
     int width_ = 0;
     int height_ = 0;
     int desktop_width_ = 0;
     int desktop_height_ = 0;
+    FrameRect region_;              // Запит SetRegion
+    FrameRect crop_;                // Регіон у межах монітора після Initialize
     std::string last_error_;
 };
 
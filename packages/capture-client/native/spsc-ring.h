@@ -0,0 +1,93 @@
+/**
+ * Lock-free SPSC Ring Buffer
+ * Обмежена черга без блокувань для одного виробника та одного споживача
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Розмір лінії кешу - head_ і tail_ у різних лініях, щоб потоки
+// виробника та споживача не інвалідували кеш одне одного
+static constexpr size_t kCacheLineSize = 64;
+
+template <typename T>
+class SpscRing {
+public:
+    SpscRing() = default;
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Ємність округлюється вгору до степеня двійки.
+    // Викликати до початку роботи потоків.
+    bool Initialize(size_t capacity) {
+        if (capacity == 0) {
+            return false;
+        }
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        slots_.assign(size, T());
+        mask_ = size - 1;
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+        cached_head_ = 0;
+        cached_tail_ = 0;
+        return true;
+    }
+
+    // Лише потік виробника; false - черга заповнена
+    bool TryPush(const T& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Лише потік споживача; false - черга порожня
+    bool TryPop(T& value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+        value = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Наближена кількість елементів (точна лише з потоку виробника чи споживача)
+    size_t Size() const {
+        size_t tail = tail_.load(std::memory_order_acquire);
+        size_t head = head_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    size_t Capacity() const { return slots_.size(); }
+
+private:
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+
+    // Споживач: власний індекс + кеш індексу виробника
+    alignas(kCacheLineSize) std::atomic<size_t> head_{0};
+    size_t cached_tail_ = 0;
+
+    // Виробник: власний індекс + кеш індексу споживача
+    alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
+    size_t cached_head_ = 0;
+};
+
+#endif // SPSC_RING_H
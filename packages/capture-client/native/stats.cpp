@@ -0,0 +1,159 @@
+/**
+ * Capture Statistics Implementation
+ */
+
+#include "stats.h"
+
+namespace {
+
+int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        CaptureStats::Clock::now().time_since_epoch()).count();
+}
+
+int HighestBit(uint64_t value) {
+    int bit = 0;
+    while (value >>= 1) {
+        bit++;
+    }
+    return bit;
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram() {
+    Reset();
+}
+
+int LatencyHistogram::GetBucketIndex(uint64_t us) {
+    if (us < (uint64_t)kSubBuckets) {
+        return (int)us;
+    }
+    // Октава e (2^e <= us < 2^(e+1)) ділиться на 4 рівні частини
+    int exponent = HighestBit(us);
+    int sub = (int)((us >> (exponent - 2)) & (kSubBuckets - 1));
+    int index = kSubBuckets * (exponent - 1) + sub;
+    return index < kBucketCount ? index : kBucketCount - 1;
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(int index) {
+    if (index < kSubBuckets) {
+        return (uint64_t)index;
+    }
+    int exponent = index / kSubBuckets + 1;
+    int sub = index % kSubBuckets;
+    uint64_t lower = (uint64_t)(kSubBuckets + sub) << (exponent - 2);
+    return lower + ((uint64_t)1 << (exponent - 2)) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t us) {
+    buckets_[GetBucketIndex(us)].fetch_add(1, std::memory_order_relaxed);
+    sum_us_.fetch_add(us, std::memory_order_relaxed);
+
+    uint64_t current = max_us_.load(std::memory_order_relaxed);
+    while (us > current &&
+           !max_us_.compare_exchange_weak(current, us, std::memory_order_relaxed)) {
+    }
+}
+
+LatencySnapshot LatencyHistogram::GetSnapshot() const {
+    LatencySnapshot snapshot;
+
+    uint64_t counts[kBucketCount];
+    uint64_t total = 0;
+    for (int i = 0; i < kBucketCount; i++) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return snapshot;
+    }
+
+    uint64_t max_us = max_us_.load(std::memory_order_relaxed);
+    snapshot.count = total;
+    snapshot.mean_ms = (double)sum_us_.load(std::memory_order_relaxed) / (double)total / 1000.0;
+    snapshot.max_ms = max_us / 1000.0;
+
+    // Перцентиль - середина кошика, в якому накопичено rank значень (не більше max)
+    const double percentiles[] = { 0.50, 0.90, 0.99 };
+    double* outputs[] = { &snapshot.p50_ms, &snapshot.p90_ms, &snapshot.p99_ms };
+    for (int p = 0; p < 3; p++) {
+        uint64_t rank = (uint64_t)(percentiles[p] * (double)total + 0.999999);
+        if (rank == 0) {
+            rank = 1;
+        }
+        uint64_t seen = 0;
+        for (int i = 0; i < kBucketCount; i++) {
+            seen += counts[i];
+            if (seen >= rank) {
+                uint64_t upper = GetBucketUpperBound(i);
+                uint64_t lower = i > 0 ? GetBucketUpperBound(i - 1) + 1 : 0;
+                uint64_t middle = lower + (upper - lower) / 2;
+                *outputs[p] = (middle < max_us ? middle : max_us) / 1000.0;
+                break;
+            }
+        }
+    }
+    return snapshot;
+}
+
+void LatencyHistogram::Reset() {
+    for (int i = 0; i < kBucketCount; i++) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+    sum_us_.store(0, std::memory_order_relaxed);
+    max_us_.store(0, std::memory_order_relaxed);
+}
+
+CaptureStats::CaptureStats() : reset_time_ns_(NowNs()) {
+}
+
+double CaptureStats::GetElapsedMs() const {
+    return (NowNs() - reset_time_ns_.load(std::memory_order_relaxed)) / 1e6;
+}
+
+void CaptureStats::Reset() {
+    for (StageSlot& slot : stages_) {
+        slot.histogram.Reset();
+    }
+    for (CounterSlot& slot : counters_) {
+        slot.value.store(0, std::memory_order_relaxed);
+    }
+    reset_time_ns_.store(NowNs(), std::memory_order_relaxed);
+}
+
+const char* CaptureStats::GetStageName(StatStage stage) {
+    switch (stage) {
+        case StatStage::Acquire: return "acquire";
+        case StatStage::Map: return "map";
+        case StatStage::Convert: return "convert";
+        case StatStage::Encode: return "encode";
+        case StatStage::Handoff: return "handoff";
+        case StatStage::Latency: return "latency";
+        default: return "unknown";
+    }
+}
+
+const char* CaptureStats::GetCounterName(StatCounter counter) {
+    switch (counter) {
+        case StatCounter::FramesCaptured: return "framesCaptured";
+        case StatCounter::FramesSkipped: return "framesSkipped";
+        case StatCounter::FramesEncoded: return "framesEncoded";
+        case StatCounter::FramesDropped: return "framesDropped";
+        case StatCounter::AcquireTimeouts: return "acquireTimeouts";
+        case StatCounter::EncoderNeedInput: return "encoderNeedInput";
+        case StatCounter::BufferCopies: return "bufferCopies";
+        case StatCounter::Errors: return "errors";
+        case StatCounter::BytesOut: return "bytesOut";
+        case StatCounter::MoveRects: return "moveRects";
+        case StatCounter::TileCacheHits: return "tileCacheHits";
+        case StatCounter::TileCacheMisses: return "tileCacheMisses";
+        case StatCounter::TileCacheEvictions: return "tileCacheEvictions";
+        default: return "unknown";
+    }
+}
+
+CaptureStats& GetCaptureStats() {
+    static CaptureStats stats;
+    return stats;
+}
@@ -0,0 +1,142 @@
+/**
+ * Capture Statistics
+ * Постійно увімкнені лічильники та гістограми затримок по стадіях (lock-free).
+ * Запис - кілька relaxed атомарних операцій; знімок робиться лише на запит getStats().
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Стадії, для яких ведеться гістограма затримок
+enum class StatStage {
+    Acquire,    // Очікування нового кадру (AcquireNextFrame / XShmGetImage)
+    Map,        // Читання кадру з GPU / X сервера (CopyResource + Map + копіювання рядків)
+    Convert,    // Масштаб та / або BGRA -> NV12
+    Encode,     // Кодек (h264 / delta / jpeg)
+    Handoff,    // Створення JS Buffer (обгортка пулу або копія)
+    Latency,    // Від початку захоплення до передачі кадру в JS
+    Count
+};
+
+enum class StatCounter {
+    FramesCaptured,     // Джерело віддало новий кадр
+    FramesSkipped,      // Нового кадру немає (екран не змінився / тайм-аут)
+    FramesEncoded,      // Кодек видав непорожній кадр
+    FramesDropped,      // Кадр втрачено: пул вичерпано, черга JS переповнена, конвеєр зайнятий
+    AcquireTimeouts,    // AcquireNextFrame повернув WAIT_TIMEOUT
+    EncoderNeedInput,   // Енкодер не видав кадр (NEED_MORE_INPUT / затримка x264)
+    BufferCopies,       // Кадр скопійовано в JS (пул вичерпано), а не передано з пулу
+    Errors,             // Помилки захоплення / кодування
+    BytesOut,           // Байти, передані в JS
+    MoveRects,          // Переміщення (прокрутка) у дельта-пакетах замість плиток
+    TileCacheHits,      // Плитки дельта-пакетів, передані посиланням на кеш отримувача
+    TileCacheMisses,    // Плитки, передані пікселями і збережені в кеш
+    TileCacheEvictions, // Слоти кешу, віддані новим плиткам
+    Count
+};
+
+struct LatencySnapshot {
+    uint64_t count = 0;
+    double mean_ms = 0.0;
+    double p50_ms = 0.0;
+    double p90_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+};
+
+// Гістограма з логарифмічними кошиками: 4 під-кошики на октаву (перцентиль - середина кошика, похибка <= 12.5%),
+// значення в мікросекундах (більші за ~2 год - в останньому кошику)
+class LatencyHistogram {
+public:
+    static constexpr int kSubBuckets = 4;
+    static constexpr int kBucketCount = 32 * kSubBuckets;
+
+    LatencyHistogram();
+
+    void Record(uint64_t us);
+    LatencySnapshot GetSnapshot() const;
+    void Reset();
+
+    static int GetBucketIndex(uint64_t us);
+    // Верхня межа кошика (мкс)
+    static uint64_t GetBucketUpperBound(int index);
+
+private:
+    std::atomic<uint64_t> buckets_[kBucketCount];
+    std::atomic<uint64_t> sum_us_;
+    std::atomic<uint64_t> max_us_;
+};
+
+class CaptureStats {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    CaptureStats();
+
+    void Add(StatCounter counter, uint64_t value = 1) {
+        counters_[static_cast<int>(counter)].value.fetch_add(value, std::memory_order_relaxed);
+    }
+    void Record(StatStage stage, uint64_t us) {
+        stages_[static_cast<int>(stage)].histogram.Record(us);
+    }
+    void RecordMs(StatStage stage, double ms) {
+        Record(stage, ms > 0.0 ? (uint64_t)(ms * 1000.0 + 0.5) : 0);
+    }
+    void RecordSince(StatStage stage, Clock::time_point start) {
+        Record(stage, (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now() - start).count());
+    }
+
+    uint64_t Get(StatCounter counter) const {
+        return counters_[static_cast<int>(counter)].value.load(std::memory_order_relaxed);
+    }
+    LatencySnapshot GetSnapshot(StatStage stage) const {
+        return stages_[static_cast<int>(stage)].histogram.GetSnapshot();
+    }
+    // Час від старту процесу або останнього Reset() (мс)
+    double GetElapsedMs() const;
+
+    // Скидання не синхронізоване із записом - кадр у польоті може потрапити в будь-який бік
+    void Reset();
+
+    static const char* GetStageName(StatStage stage);
+    static const char* GetCounterName(StatCounter counter);
+
+private:
+    // Окремі кеш-лінії: стадії пишуться з різних потоків
+    struct alignas(64) StageSlot {
+        LatencyHistogram histogram;
+    };
+    struct alignas(64) CounterSlot {
+        std::atomic<uint64_t> value{0};
+    };
+
+    StageSlot stages_[static_cast<int>(StatStage::Count)];
+    CounterSlot counters_[static_cast<int>(StatCounter::Count)];
+    std::atomic<int64_t> reset_time_ns_;
+};
+
+// Статистика процесу (одна на аддон, як і решта глобальних об'єктів)
+CaptureStats& GetCaptureStats();
+
+// Записує тривалість області видимості в гістограму стадії
+class ScopedStageTimer {
+public:
+    explicit ScopedStageTimer(StatStage stage)
+        : stage_(stage), start_(CaptureStats::Clock::now()) {}
+    ~ScopedStageTimer() { GetCaptureStats().RecordSince(stage_, start_); }
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    StatStage stage_;
+    CaptureStats::Clock::time_point start_;
+};
+
+#endif // STATS_H
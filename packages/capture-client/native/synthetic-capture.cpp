@@ -0,0 +1,471 @@
+/**
+ * Synthetic Capture Source Implementation
+ */
+
+#include "synthetic-capture.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+constexpr int kGlyphWidth = 8;
+constexpr int kLineHeight = 16;
+constexpr int kTextMargin = 8;
+constexpr int kScrollStep = 3;          // Пікселів прокрутки за кадр
+constexpr int kTitleBarHeight = 24;
+constexpr int kTaskbarHeight = 40;
+
+// Тривалість фаз сценарію Mixed (у кадрах)
+constexpr uint64_t kPhaseText = 90;
+constexpr uint64_t kPhaseVideo = 90;
+constexpr uint64_t kPhaseBoth = 90;
+constexpr uint64_t kPhaseIdle = 60;
+
+constexpr uint32_t kTextBackground = 0xFFFFFFFF;
+constexpr uint32_t kTextInk = 0xFF202020;
+constexpr uint32_t kTitleBar = 0xFFD0D4DA;
+constexpr uint32_t kTaskbar = 0xFF1E2430;
+
+uint32_t Hash(uint32_t a, uint32_t b) {
+    uint32_t h = a * 0x9E3779B1u ^ (b + 0x7F4A7C15u + (a << 6) + (a >> 2));
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+uint32_t PackBGRA(int r, int g, int b) {
+    return 0xFF000000u | ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
+}
+
+const uint8_t* GetSineTable() {
+    static uint8_t table[256];
+    static bool initialized = [] {
+        for (int i = 0; i < 256; i++) {
+            table[i] = (uint8_t)(127.5 + 127.5 * std::sin(i * 6.283185307179586 / 256.0));
+        }
+        return true;
+    }();
+    (void)initialized;
+    return table;
+}
+
+// Форми вказівника: 'X' - чорний, 'o' - білий, решта - прозорий
+const char* const kArrowCursor[] = {
+    "X           ",
+    "XX          ",
+    "XoX         ",
+    "XooX        ",
+    "XoooX       ",
+    "XooooX      ",
+    "XoooooX     ",
+    "XooooooX    ",
+    "XoooooooX   ",
+    "XooooooooX  ",
+    "XoooooooooX ",
+    "XooooooXXXXX",
+    "XoooXooX    ",
+    "XooX XooX   ",
+    "XoX  XooX   ",
+    "XX    XooX  ",
+    "X     XooX  ",
+    "       XooX ",
+    "       XXX  ",
+};
+
+const char* const kIBeamCursor[] = {
+    "XXX XXX",
+    "   X   ",
+    "   X   ",
+    "   X   ",
+    "   X   ",
+    "   X   ",
+    "   X   ",
+    "   X   ",
+    "   X   ",
+    "   X   ",
+    "   X   ",
+    "   X   ",
+    "   X   ",
+    "   X   ",
+    "   X   ",
+    "XXX XXX",
+};
+
+template <size_t Rows>
+CursorShape MakeCursorShape(const char* const (&rows)[Rows], int hot_x, int hot_y) {
+    const int width = (int)strlen(rows[0]);
+    std::vector<uint32_t> pixels((size_t)width * Rows, 0);
+    for (size_t y = 0; y < Rows; y++) {
+        for (int x = 0; x < width; x++) {
+            const char c = rows[y][x];
+            pixels[y * width + x] = c == 'X' ? 0xFF000000u : c == 'o' ? 0xFFFFFFFFu : 0;
+        }
+    }
+    CursorShape shape;
+    ConvertCursorShape(CursorShapeType::Color, reinterpret_cast<const uint8_t*>(pixels.data()),
+                       width, (int)Rows, width * 4, hot_x, hot_y, shape);
+    return shape;
+}
+
+void FillRect(uint8_t* canvas, int stride, int x, int y, int width, int height, uint32_t color) {
+    for (int row = 0; row < height; row++) {
+        uint32_t* dst = reinterpret_cast<uint32_t*>(canvas + (size_t)(y + row) * stride) + x;
+        for (int col = 0; col < width; col++) {
+            dst[col] = color;
+        }
+    }
+}
+
+} // namespace
+
+SyntheticCapture::SyntheticCapture(SyntheticScenario scenario, int fps, uint32_t seed)
+    : scenario_(scenario), fps_(fps), seed_(seed) {
+    // Атлас псевдо-гліфів: гліф 0 - пробіл, решта - випадкові штрихи в межах x-height
+    memset(glyphs_, 0, sizeof(glyphs_));
+    for (int glyph = 1; glyph < 64; glyph++) {
+        uint32_t h = Hash(seed_, 0x1000 + glyph);
+        int top = (h & 1) ? 3 : 6;  // Високі та низькі літери
+        for (int row = top; row < 13; row++) {
+            uint32_t bits = Hash(h, row) & 0x7E;
+            glyphs_[glyph][row] = (uint8_t)(bits ? bits : 0x18);
+        }
+    }
+}
+
+SyntheticCapture::~SyntheticCapture() {
+    Cleanup();
+}
+
+bool SyntheticCapture::ParseScenario(const std::string& name, SyntheticScenario& scenario) {
+    if (name == "mixed") {
+        scenario = SyntheticScenario::Mixed;
+    } else if (name == "text") {
+        scenario = SyntheticScenario::Text;
+    } else if (name == "video") {
+        scenario = SyntheticScenario::Video;
+    } else if (name == "idle") {
+        scenario = SyntheticScenario::Idle;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void SyntheticCapture::EnumerateOutputs(int count, std::vector<CaptureOutputInfo>& outputs) {
+    outputs.clear();
+    for (int i = 0; i < std::max(1, count); i++) {
+        CaptureOutputInfo output;
+        output.index = i;
+        output.name = "synthetic-" + std::to_string(i);
+        output.x = i * kDefaultWidth;
+        output.width = kDefaultWidth;
+        output.height = kDefaultHeight;
+        output.primary = i == 0;
+        outputs.push_back(output);
+    }
+}
+
+void SyntheticCapture::SetError(const std::string& error) {
+    last_error_ = error;
+}
+
+bool SyntheticCapture::Initialize(int width, int height) {
+    Cleanup();
+
+    canvas_width_ = width > 0 ? width : kDefaultWidth;
+    canvas_height_ = height > 0 ? height : kDefaultHeight;
+    if (canvas_width_ < 64 || canvas_height_ < 64) {
+        SetError("Synthetic source requires at least 64x64");
+        return false;
+    }
+    // Полотно - увесь імітований монітор, кадр - лише регіон (view на полотно)
+    if (!ResolveCaptureRegion(region_, canvas_width_, canvas_height_, crop_)) {
+        SetError("Capture region is outside the output");
+        return false;
+    }
+
+    if (!canvas_.Resize((size_t)canvas_width_ * canvas_height_ * 4)) {
+        SetError("Failed to allocate synthetic canvas");
+        return false;
+    }
+
+    // Вікно з текстом зліва, відео-область справа (пропорційно роздільності)
+    text_rect_.x = canvas_width_ * 4 / 100;
+    text_rect_.y = canvas_height_ * 6 / 100 + kTitleBarHeight;
+    text_rect_.width = canvas_width_ * 52 / 100;
+    text_rect_.height = canvas_height_ - kTaskbarHeight - text_rect_.y - canvas_height_ * 4 / 100;
+    video_rect_.x = canvas_width_ * 60 / 100;
+    video_rect_.y = canvas_height_ * 15 / 100;
+    video_rect_.width = canvas_width_ * 36 / 100;
+    video_rect_.height = canvas_height_ * 45 / 100;
+    if (text_rect_.height < kLineHeight) {
+        text_rect_.height = kLineHeight;
+    }
+
+    frame_index_ = 0;
+    cursor_shape_ = -1;
+    text_offset_ = 0;
+    video_time_ = 0;
+    first_frame_ = true;
+    next_frame_time_ = std::chrono::steady_clock::now();
+    width_ = crop_.width;
+    height_ = crop_.height;
+    return true;
+}
+
+void SyntheticCapture::Cleanup() {
+    canvas_ = AlignedBuffer();
+    canvas_width_ = 0;
+    canvas_height_ = 0;
+    width_ = 0;
+    height_ = 0;
+}
+
+bool SyntheticCapture::SetRegion(const FrameRect& region) {
+    region_ = region;
+    return true;
+}
+
+bool SyntheticCapture::CaptureFrame(uint8_t* dst, int dst_stride) {
+    if (!dst || dst_stride < width_ * 4) {
+        SetError("Invalid destination buffer");
+        return false;
+    }
+
+    FrameView view;
+    if (!AcquireFrameView(view)) {
+        return false;
+    }
+    copier_.CopyRows(view.data, view.stride, dst, dst_stride, view.width * 4, view.height);
+    return true;
+}
+
+bool SyntheticCapture::AcquireFrameView(FrameView& view) {
+    if (!canvas_.data()) {
+        SetError("Not initialized");
+        return false;
+    }
+
+    if (!WaitForNextFrame()) {
+        return false;
+    }
+
+    // Вказівник рухається і без змін екрану - тоді оновлюється лише трекер
+    if (cursor_) {
+        UpdateCursor(frame_index_);
+    }
+
+    // Простій - як DXGI без змін на екрані: нового кадру немає
+    if (!RenderNextFrame()) {
+        return false;
+    }
+
+    // Полотно змінюється лише в наступному AcquireFrameView - view дійсний до нього
+    const int canvas_stride = canvas_width_ * 4;
+    view.data = canvas_.data() + (size_t)crop_.y * canvas_stride + (size_t)crop_.x * 4;
+    view.stride = canvas_stride;
+    view.width = crop_.width;
+    view.height = crop_.height;
+    view.format = PixelFormat::BGRA;
+    view.crop = crop_;
+    return true;
+}
+
+void SyntheticCapture::UpdateCursor(uint64_t t) {
+    // Траєкторія Ліссажу по всьому полотну: детермінована, без повторів поруч
+    const double phase = (double)t;
+    const int px = (int)(canvas_width_ * (0.5 + 0.45 * std::sin(phase * 0.031)));
+    const int py = (int)(canvas_height_ * (0.5 + 0.45 * std::sin(phase * 0.047 + 1.0)));
+
+    const bool over_text = px >= text_rect_.x && px < text_rect_.x + text_rect_.width &&
+                           py >= text_rect_.y && py < text_rect_.y + text_rect_.height;
+    const int shape_index = over_text ? 1 : 0;
+    if (shape_index != cursor_shape_) {
+        // Пікселі форм у трекері кешуються за хешем - повторна зміна бере кеш
+        cursor_->UpdateShape(over_text ? MakeCursorShape(kIBeamCursor, 3, 8)
+                                       : MakeCursorShape(kArrowCursor, 0, 0));
+        cursor_shape_ = shape_index;
+    }
+
+    CursorShapePtr shape = cursor_->GetCurrentShape();
+    const int hot_x = shape ? shape->hot_x : 0;
+    const int hot_y = shape ? shape->hot_y : 0;
+    const int width = shape ? shape->width : 0;
+    const int height = shape ? shape->height : 0;
+    const int x = px - hot_x - crop_.x;
+    const int y = py - hot_y - crop_.y;
+    const bool visible = x + width > 0 && y + height > 0 && x < crop_.width && y < crop_.height;
+    cursor_->UpdatePosition(visible, x, y);
+}
+
+bool SyntheticCapture::WaitForNextFrame() {
+    if (fps_ <= 0) {
+        return true;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / fps_));
+
+    auto now = Clock::now();
+    if (now < next_frame_time_) {
+        // Чекати не довше за timeout, як AcquireNextFrame
+        auto timeout = std::chrono::milliseconds(acquire_timeout_ms_);
+        if (next_frame_time_ - now > timeout) {
+            if (acquire_timeout_ms_ > 0) {
+                std::this_thread::sleep_for(timeout);
+            }
+            return false;
+        }
+        std::this_thread::sleep_until(next_frame_time_);
+        now = next_frame_time_;
+    }
+
+    // Споживач відстав - пропущені кадри не накопичуються
+    next_frame_time_ += interval;
+    if (next_frame_time_ <= now) {
+        next_frame_time_ = now + interval;
+    }
+    return true;
+}
+
+bool SyntheticCapture::RenderNextFrame() {
+    uint64_t index = frame_index_++;
+
+    bool text = false;
+    bool video = false;
+    switch (scenario_) {
+        case SyntheticScenario::Text:
+            text = true;
+            break;
+        case SyntheticScenario::Video:
+            video = true;
+            break;
+        case SyntheticScenario::Idle:
+            break;
+        case SyntheticScenario::Mixed: {
+            uint64_t phase = index % (kPhaseText + kPhaseVideo + kPhaseBoth + kPhaseIdle);
+            text = phase < kPhaseText ||
+                   (phase >= kPhaseText + kPhaseVideo && phase < kPhaseText + kPhaseVideo + kPhaseBoth);
+            video = phase >= kPhaseText && phase < kPhaseText + kPhaseVideo + kPhaseBoth;
+            break;
+        }
+    }
+
+    if (first_frame_) {
+        // Перший кадр - повне полотно незалежно від фази
+        first_frame_ = false;
+        RenderBackground();
+        RenderTextRows(0, text_rect_.height);
+        RenderVideo(video_time_);
+        return true;
+    }
+
+    if (text) {
+        ScrollText(kScrollStep);
+    }
+    if (video) {
+        RenderVideo(++video_time_);
+    }
+    return text || video;
+}
+
+void SyntheticCapture::RenderBackground() {
+    uint8_t* canvas = canvas_.data();
+    int stride = canvas_width_ * 4;
+
+    // Робочий стіл - вертикальний градієнт
+    for (int y = 0; y < canvas_height_; y++) {
+        int shade = y * 96 / canvas_height_;
+        uint32_t color = PackBGRA(24 + shade / 3, 48 + shade / 2, 96 + shade);
+        FillRect(canvas, stride, 0, y, canvas_width_, 1, color);
+    }
+
+    FillRect(canvas, stride, 0, canvas_height_ - kTaskbarHeight, canvas_width_, kTaskbarHeight,
+             kTaskbar);
+    FillRect(canvas, stride, text_rect_.x, text_rect_.y - kTitleBarHeight,
+             text_rect_.width, kTitleBarHeight, kTitleBar);
+}
+
+void SyntheticCapture::RenderTextRows(int first_row, int row_count) {
+    uint8_t* canvas = canvas_.data();
+    int stride = canvas_width_ * 4;
+    int cells = (text_rect_.width - kTextMargin * 2) / kGlyphWidth;
+
+    for (int row = first_row; row < first_row + row_count; row++) {
+        uint32_t* dst = reinterpret_cast<uint32_t*>(canvas + (size_t)(text_rect_.y + row) * stride) +
+                        text_rect_.x;
+        for (int x = 0; x < text_rect_.width; x++) {
+            dst[x] = kTextBackground;
+        }
+
+        uint64_t global_row = text_offset_ + row;
+        uint32_t line = (uint32_t)(global_row / kLineHeight);
+        int glyph_row = (int)(global_row % kLineHeight);
+
+        // Довжина рядка і порожні рядки - детерміновано від seed
+        uint32_t line_hash = Hash(seed_, line);
+        if (line_hash % 9 == 0 || cells <= 0) {
+            continue;
+        }
+        int length = cells > 20 ? 20 + (int)(line_hash % (uint32_t)(cells - 20)) : cells;
+
+        uint32_t* cell_dst = dst + kTextMargin;
+        for (int cell = 0; cell < length; cell++, cell_dst += kGlyphWidth) {
+            uint32_t char_hash = Hash(line_hash, cell);
+            if (char_hash % 7 == 0) {
+                continue;   // Пробіл між словами
+            }
+            uint8_t bits = glyphs_[1 + char_hash % 63][glyph_row];
+            for (int bit = 0; bit < kGlyphWidth; bit++) {
+                if (bits & (0x80 >> bit)) {
+                    cell_dst[bit] = kTextInk;
+                }
+            }
+        }
+    }
+}
+
+void SyntheticCapture::ScrollText(int delta) {
+    if (delta >= text_rect_.height) {
+        text_offset_ += delta;
+        RenderTextRows(0, text_rect_.height);
+        return;
+    }
+
+    // Зсунути видимі рядки вгору і домалювати нові знизу
+    uint8_t* canvas = canvas_.data();
+    int stride = canvas_width_ * 4;
+    size_t row_bytes = (size_t)text_rect_.width * 4;
+    uint8_t* origin = canvas + (size_t)text_rect_.y * stride + (size_t)text_rect_.x * 4;
+    for (int row = 0; row < text_rect_.height - delta; row++) {
+        memcpy(origin + (size_t)row * stride, origin + (size_t)(row + delta) * stride, row_bytes);
+    }
+
+    text_offset_ += delta;
+    RenderTextRows(text_rect_.height - delta, delta);
+}
+
+void SyntheticCapture::RenderVideo(uint64_t t) {
+    const uint8_t* sine = GetSineTable();
+    uint8_t* canvas = canvas_.data();
+    int stride = canvas_width_ * 4;
+    uint32_t time = (uint32_t)t;
+
+    // "Плазма" - кожен піксель області змінюється кожен кадр
+    for (int y = 0; y < video_rect_.height; y++) {
+        uint32_t* dst = reinterpret_cast<uint32_t*>(canvas + (size_t)(video_rect_.y + y) * stride) +
+                        video_rect_.x;
+        uint8_t g = sine[(y * 2 + time * 3) & 255];
+        for (int x = 0; x < video_rect_.width; x++) {
+            uint8_t b = sine[(x * 2 + time * 5) & 255];
+            uint8_t r = sine[((x + y) + time * 7 + (b >> 2)) & 255];
+            dst[x] = PackBGRA(r, (g + b) >> 1, b);
+        }
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ * Synthetic Capture Source
+ * Детермінований генератор кадрів: прокрутка тексту, відео-область, простій
+ * (відтворювані навантаження для вимірювань на Linux / CI без екрану)
+ */
+
+#ifndef SYNTHETIC_CAPTURE_H
+#define SYNTHETIC_CAPTURE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "aligned-memory.h"
+#include "capture-source.h"
+#include "cursor.h"
+#include "frame-converter.h"
+
+enum class SyntheticScenario {
+    Mixed,      // Фази: текст -> відео -> текст + відео -> простій (по колу)
+    Text,       // Безперервна прокрутка тексту
+    Video,      // Відео-область змінюється кожен кадр
+    Idle        // Один кадр, далі змін немає
+};
+
+class SyntheticCapture : public CaptureSource {
+public:
+    static constexpr int kDefaultWidth = 1920;
+    static constexpr int kDefaultHeight = 1080;
+
+    // fps = 0 -> новий кадр на кожен виклик CaptureFrame (без темпу)
+    SyntheticCapture(SyntheticScenario scenario = SyntheticScenario::Mixed, int fps = 30,
+                     uint32_t seed = 1);
+    ~SyntheticCapture() override;
+
+    static bool ParseScenario(const std::string& name, SyntheticScenario& scenario);
+    // Імітовані монітори kDefaultWidth x kDefaultHeight в один ряд (0 - основний)
+    static void EnumerateOutputs(int count, std::vector<CaptureOutputInfo>& outputs);
+
+    bool Initialize(int width = 0, int height = 0) override;
+    bool CaptureFrame(uint8_t* dst, int dst_stride) override;
+    void Cleanup() override;
+
+    // Регіон вирізається з полотна всього монітора (рендер - як без регіону)
+    bool SetRegion(const FrameRect& region) override;
+    bool SupportsFrameView() const override { return true; }
+    bool AcquireFrameView(FrameView& view) override;
+
+    void SetWorkerPool(WorkerPool* pool) override { copier_.SetWorkerPool(pool); }
+    // Вказівник рухається кожен такт (і в простої): стрілка, над текстом - I-beam
+    void SetCursorTracker(CursorTracker* tracker) override { cursor_ = tracker; }
+    void SetAcquireTimeout(unsigned int timeout_ms) override { acquire_timeout_ms_ = timeout_ms; }
+
+    const char* GetName() const override { return "synthetic"; }
+    int GetWidth() const override { return width_; }
+    int GetHeight() const override { return height_; }
+    std::string GetLastError() const override { return last_error_; }
+
+    // Номер останнього згенерованого кадру (включно з кадрами простою)
+    uint64_t GetFrameIndex() const { return frame_index_; }
+
+private:
+    struct Rect {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    // Оновити полотно для кадру frame_index_; false - кадр не змінився
+    bool RenderNextFrame();
+    void RenderBackground();
+    void RenderTextRows(int first_row, int row_count);
+    void ScrollText(int delta);
+    void RenderVideo(uint64_t t);
+    bool WaitForNextFrame();
+    void UpdateCursor(uint64_t t);
+    void SetError(const std::string& error);
+
+    SyntheticScenario scenario_;
+    int fps_;
+    uint32_t seed_;
+    unsigned int acquire_timeout_ms_ = kDefaultAcquireTimeoutMs;
+
+    int width_ = 0;                 // Розмір кадру (регіону)
+    int height_ = 0;
+    int canvas_width_ = 0;          // Розмір імітованого монітора
+    int canvas_height_ = 0;
+    FrameRect region_;              // Запит SetRegion (порожній - увесь монітор)
+    FrameRect crop_;                // Регіон у межах полотна після Initialize
+    AlignedBuffer canvas_;
+    FrameConverter copier_;
+    Rect text_rect_;
+    Rect video_rect_;
+    uint8_t glyphs_[64][16];     // Атлас псевдо-гліфів 8x16 (біт = піксель)
+    CursorTracker* cursor_ = nullptr;
+    int cursor_shape_ = -1;      // Поточна форма: 0 - стрілка, 1 - I-beam (-1 - ще не передана)
+
+    uint64_t frame_index_ = 0;
+    uint64_t text_offset_ = 0;   // Прокрутка тексту в пікселях
+    uint64_t video_time_ = 0;
+    bool first_frame_ = true;
+    std::chrono::steady_clock::time_point next_frame_time_;
+    std::string last_error_;
+};
+
+#endif // SYNTHETIC_CAPTURE_H
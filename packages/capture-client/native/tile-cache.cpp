@@ -0,0 +1,136 @@
+/**
+ * Tile Cache Implementation
+ */
+
+#include "tile-cache.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+constexpr uint64_t kHashSeed = 0x9E3779B97F4A7C15ull;
+constexpr uint64_t kHashPrime = 0x100000001B3ull * 0x9E3779B1ull | 1;
+
+// Кожен крок бієктивний за h: плитки, що відрізняються одним словом, дають різні хеші
+inline uint64_t Mix(uint64_t h, uint64_t v) {
+    h = (h ^ v) * kHashPrime;
+    return h ^ (h >> 32);
+}
+
+} // namespace
+
+TileCache::TileCache() {
+}
+
+bool TileCache::Initialize(int tile_size, size_t max_bytes) {
+    const size_t tile_bytes = (size_t)tile_size * tile_size * 4;
+    const size_t slots = tile_bytes > 0 ? std::min(max_bytes / tile_bytes, (size_t)kMaxSlots) : 0;
+
+    slots_.assign(slots, Slot());
+    index_.clear();
+    index_.reserve(slots);
+    max_bytes_ = slots * tile_bytes;
+    stats_ = TileCacheStats();
+    Reset();
+    return slots > 0;
+}
+
+void TileCache::Reset() {
+    index_.clear();
+    head_ = -1;
+    tail_ = -1;
+    used_ = 0;
+}
+
+uint64_t TileCache::HashTile(const uint8_t* pixels, int stride, int width, int height) {
+    // 4 незалежні ланцюжки по 8 байт - множення не чекають одне на одне
+    const size_t bytes = (size_t)width * 4;
+    uint64_t h0 = kHashSeed;
+    uint64_t h1 = kHashSeed + 1;
+    uint64_t h2 = kHashSeed + 2;
+    uint64_t h3 = Mix(kHashSeed + 3, ((uint64_t)width << 32) | (uint32_t)height);
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row = pixels + (size_t)y * stride;
+        size_t i = 0;
+        for (; i + 32 <= bytes; i += 32) {
+            uint64_t v[4];
+            memcpy(v, row + i, sizeof(v));
+            h0 = Mix(h0, v[0]);
+            h1 = Mix(h1, v[1]);
+            h2 = Mix(h2, v[2]);
+            h3 = Mix(h3, v[3]);
+        }
+        for (; i + 4 <= bytes; i += 4) {
+            uint32_t v;
+            memcpy(&v, row + i, sizeof(v));
+            h0 = Mix(h0, v);
+        }
+    }
+    return Mix(Mix(Mix(h0, h1), h2), h3);
+}
+
+void TileCache::Unlink(int slot) {
+    Slot& entry = slots_[slot];
+    if (entry.prev >= 0) {
+        slots_[entry.prev].next = entry.next;
+    } else {
+        head_ = entry.next;
+    }
+    if (entry.next >= 0) {
+        slots_[entry.next].prev = entry.prev;
+    } else {
+        tail_ = entry.prev;
+    }
+    entry.prev = -1;
+    entry.next = -1;
+}
+
+void TileCache::PushFront(int slot) {
+    Slot& entry = slots_[slot];
+    entry.prev = -1;
+    entry.next = head_;
+    if (head_ >= 0) {
+        slots_[head_].prev = slot;
+    }
+    head_ = slot;
+    if (tail_ < 0) {
+        tail_ = slot;
+    }
+}
+
+bool TileCache::Lookup(uint64_t hash, size_t tile_bytes, uint16_t& slot) {
+    auto it = index_.find(hash);
+    if (it != index_.end()) {
+        if (it->second != head_) {
+            Unlink(it->second);
+            PushFront(it->second);
+        }
+        slot = (uint16_t)it->second;
+        stats_.hits++;
+        stats_.bytes_saved += tile_bytes;
+        return true;
+    }
+
+    // Спершу вільні слоти, далі - найдавніше використаний
+    int target;
+    if (used_ < (int)slots_.size()) {
+        target = used_++;
+        index_.emplace(hash, target);
+    } else {
+        target = tail_;
+        Unlink(target);
+        // Вузол витісненого хешу переходить до нового - без free/malloc на кожен промах
+        auto node = index_.extract(slots_[target].hash);
+        node.key() = hash;
+        node.mapped() = target;
+        index_.insert(std::move(node));
+        stats_.evictions++;
+    }
+    slots_[target].hash = hash;
+    PushFront(target);
+
+    slot = (uint16_t)target;
+    stats_.misses++;
+    return false;
+}
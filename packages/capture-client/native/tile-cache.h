@@ -0,0 +1,69 @@
+/**
+ * Tile Cache
+ * Кеш уже переданих плиток за 64-бітним хешем вмісту (як bitmap cache у RDP):
+ * плитка, що вже є в кеші отримувача, передається номером слота замість пікселів
+ */
+
+#ifndef TILE_CACHE_H
+#define TILE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+struct TileCacheStats {
+    uint64_t hits = 0;              // Плитка передана посиланням на слот
+    uint64_t misses = 0;            // Плитка передана пікселями і збережена в слот
+    uint64_t evictions = 0;         // Найдавніше використаний слот віддано новій плитці
+    uint64_t bytes_saved = 0;       // Пікселі, не передані завдяки влучанням
+};
+
+// Слоти призначає відправник: отримувачу досить масиву слотів і правила
+// "промах - зберегти передані пікселі в слот, влучання - взяти пікселі зі слота".
+// Порядок LRU існує лише тут, тож стани обох сторін не можуть розійтися.
+class TileCache {
+public:
+    static constexpr int kMaxSlots = 0x7FFF;    // Номер слота - 15 біт посилання
+
+    TileCache();
+
+    // Кількість слотів - max_bytes / розмір повної плитки (до kMaxSlots).
+    // false - бюджет менший за одну плитку (кеш вимкнено).
+    bool Initialize(int tile_size, size_t max_bytes);
+    // Забути всі плитки (keyframe: отримувач теж очищає кеш)
+    void Reset();
+
+    // Хеш вмісту плитки BGRA (розмір входить у хеш)
+    static uint64_t HashTile(const uint8_t* pixels, int stride, int width, int height);
+
+    // true - плитка вже в кеші, slot - її слот. false - slot, у який отримувач збереже
+    // передані пікселі (за потреби витісняється найдавніше використаний).
+    bool Lookup(uint64_t hash, size_t tile_bytes, uint16_t& slot);
+
+    bool IsEnabled() const { return !slots_.empty(); }
+    int GetSlotCount() const { return (int)slots_.size(); }
+    int GetUsedSlots() const { return used_; }
+    size_t GetMaxBytes() const { return max_bytes_; }
+    TileCacheStats GetStats() const { return stats_; }
+
+private:
+    struct Slot {
+        uint64_t hash = 0;
+        int prev = -1;              // Ближче до нещодавно використаних
+        int next = -1;
+    };
+
+    void Unlink(int slot);
+    void PushFront(int slot);
+
+    std::vector<Slot> slots_;
+    std::unordered_map<uint64_t, int> index_;   // Хеш -> слот
+    int head_ = -1;                 // Нещодавно використаний
+    int tail_ = -1;                 // Кандидат на витіснення
+    int used_ = 0;
+    size_t max_bytes_ = 0;
+    TileCacheStats stats_;
+};
+
+#endif // TILE_CACHE_H
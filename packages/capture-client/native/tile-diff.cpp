@@ -0,0 +1,193 @@
+/**
+ * Tile-based Frame Differencing Implementation
+ */
+
+#include "tile-diff.h"
+#include "cpu-features.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+bool BytesEqualScalar(const uint8_t* a, const uint8_t* b, size_t size) {
+    return memcmp(a, b, size) == 0;
+}
+
+#ifdef NATIVE_ARCH_X86
+
+NATIVE_TARGET_SSE2
+bool BytesEqualSSE2(const uint8_t* a, const uint8_t* b, size_t size) {
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        __m128i e0 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        __m128i e1 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 16)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 16)));
+        __m128i e2 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 32)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 32)));
+        __m128i e3 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 48)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 48)));
+        __m128i all = _mm_and_si128(_mm_and_si128(e0, e1), _mm_and_si128(e2, e3));
+        if (_mm_movemask_epi8(all) != 0xFFFF) {
+            return false;
+        }
+    }
+    for (; i + 16 <= size; i += 16) {
+        __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        if (_mm_movemask_epi8(eq) != 0xFFFF) {
+            return false;
+        }
+    }
+    return memcmp(a + i, b + i, size - i) == 0;
+}
+
+NATIVE_TARGET_AVX2
+bool BytesEqualAVX2(const uint8_t* a, const uint8_t* b, size_t size) {
+    size_t i = 0;
+    for (; i + 128 <= size; i += 128) {
+        // XOR + OR: нуль лише якщо всі 128 байт співпадають
+        __m256i x0 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        __m256i x1 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 32)),
+                                      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 32)));
+        __m256i x2 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 64)),
+                                      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 64)));
+        __m256i x3 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 96)),
+                                      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 96)));
+        __m256i any = _mm256_or_si256(_mm256_or_si256(x0, x1), _mm256_or_si256(x2, x3));
+        if (!_mm256_testz_si256(any, any)) {
+            return false;
+        }
+    }
+    for (; i + 32 <= size; i += 32) {
+        __m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                     _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        if (!_mm256_testz_si256(x, x)) {
+            return false;
+        }
+    }
+    return memcmp(a + i, b + i, size - i) == 0;
+}
+
+#endif // NATIVE_ARCH_X86
+
+} // namespace
+
+TileDiff::TileDiff() {
+}
+
+bool TileDiff::Initialize(int width, int height, int tile_size) {
+    if (width <= 0 || height <= 0 || tile_size < kMinTileSize || tile_size > kMaxTileSize) {
+        return false;
+    }
+
+    width_ = width;
+    height_ = height;
+    tile_size_ = tile_size;
+    tiles_x_ = (width + tile_size - 1) / tile_size;
+    tiles_y_ = (height + tile_size - 1) / tile_size;
+    previous_.assign((size_t)width * height * 4, 0);
+    has_previous_ = false;
+
+    bytes_equal_ = &BytesEqualScalar;
+#ifdef NATIVE_ARCH_X86
+    if (CpuHasAVX2()) {
+        bytes_equal_ = &BytesEqualAVX2;
+    } else if (CpuHasSSE2()) {
+        bytes_equal_ = &BytesEqualSSE2;
+    }
+#endif
+
+    return true;
+}
+
+void TileDiff::GetTileRect(int index, int& x, int& y, int& w, int& h) const {
+    x = (index % tiles_x_) * tile_size_;
+    y = (index / tiles_x_) * tile_size_;
+    w = std::min(tile_size_, width_ - x);
+    h = std::min(tile_size_, height_ - y);
+}
+
+bool TileDiff::TileEqual(const uint8_t* frame, int stride, int x, int y, int w, int h) const {
+    size_t row_bytes = (size_t)w * 4;
+    size_t prev_stride = (size_t)width_ * 4;
+
+    for (int row = y; row < y + h; row++) {
+        const uint8_t* cur = frame + (size_t)row * stride + (size_t)x * 4;
+        const uint8_t* prev = previous_.data() + (size_t)row * prev_stride + (size_t)x * 4;
+        if (!bytes_equal_(cur, prev, row_bytes)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TileDiff::StoreTile(const uint8_t* frame, int stride, int x, int y, int w, int h) {
+    size_t row_bytes = (size_t)w * 4;
+    size_t prev_stride = (size_t)width_ * 4;
+
+    for (int row = y; row < y + h; row++) {
+        memcpy(previous_.data() + (size_t)row * prev_stride + (size_t)x * 4,
+               frame + (size_t)row * stride + (size_t)x * 4, row_bytes);
+    }
+}
+
+void TileDiff::ApplyMoves(const std::vector<MoveRect>& moves) {
+    if (!has_previous_ || moves.empty()) {
+        return;
+    }
+
+    size_t total = 0;
+    for (const MoveRect& move : moves) {
+        total += (size_t)move.width * move.height * 4;
+    }
+    move_scratch_.resize(total);
+
+    // Спершу всі джерела, потім усі цілі: переміщення не бачать результатів одне одного
+    const size_t prev_stride = (size_t)width_ * 4;
+    uint8_t* scratch = move_scratch_.data();
+    for (const MoveRect& move : moves) {
+        const size_t row_bytes = (size_t)move.width * 4;
+        for (int row = 0; row < move.height; row++) {
+            memcpy(scratch, previous_.data() + (size_t)(move.src_y + row) * prev_stride + (size_t)move.src_x * 4,
+                   row_bytes);
+            scratch += row_bytes;
+        }
+    }
+    scratch = move_scratch_.data();
+    for (const MoveRect& move : moves) {
+        const size_t row_bytes = (size_t)move.width * 4;
+        for (int row = 0; row < move.height; row++) {
+            memcpy(previous_.data() + (size_t)(move.dst_y + row) * prev_stride + (size_t)move.dst_x * 4, scratch,
+                   row_bytes);
+            scratch += row_bytes;
+        }
+    }
+}
+
+int TileDiff::Compare(const uint8_t* frame, int stride, std::vector<uint8_t>& dirty) {
+    int tile_count = GetTileCount();
+    dirty.assign(tile_count, 0);
+
+    if (!frame || tile_count == 0) {
+        return 0;
+    }
+
+    int changed = 0;
+    for (int i = 0; i < tile_count; i++) {
+        int x, y, w, h;
+        GetTileRect(i, x, y, w, h);
+
+        if (has_previous_ && TileEqual(frame, stride, x, y, w, h)) {
+            continue;
+        }
+
+        StoreTile(frame, stride, x, y, w, h);
+        dirty[i] = 1;
+        changed++;
+    }
+
+    has_previous_ = true;
+    return changed;
+}
@@ -0,0 +1,65 @@
+/**
+ * Tile-based Frame Differencing
+ * Порівняння кадру з попереднім по плитках (SIMD порівняння рядків)
+ */
+
+#ifndef TILE_DIFF_H
+#define TILE_DIFF_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "frame-view.h"
+
+class TileDiff {
+public:
+    static constexpr int kMinTileSize = 16;
+    static constexpr int kMaxTileSize = 256;
+
+    TileDiff();
+
+    bool Initialize(int width, int height, int tile_size = 64);
+
+    // Наступне порівняння позначить усі плитки як змінені
+    void Reset() { has_previous_ = false; }
+
+    // Порівняти BGRA кадр з попереднім. Збережена копія оновлюється лише
+    // для змінених плиток. Повертає кількість змінених плиток,
+    // dirty[i] != 0 для кожної зміненої плитки (порядок - рядками).
+    int Compare(const uint8_t* frame, int stride, std::vector<uint8_t>& dirty);
+
+    // Застосувати переміщення до збереженого кадру перед Compare: джерела читаються
+    // зі знімка до будь-якого з переміщень (як їх застосовує отримувач)
+    void ApplyMoves(const std::vector<MoveRect>& moves);
+
+    // Прямокутник плитки в пікселях (крайні плитки обрізані)
+    void GetTileRect(int index, int& x, int& y, int& w, int& h) const;
+
+    int GetTilesX() const { return tiles_x_; }
+    int GetTilesY() const { return tiles_y_; }
+    int GetTileCount() const { return tiles_x_ * tiles_y_; }
+    int GetTileSize() const { return tile_size_; }
+    int GetWidth() const { return width_; }
+    int GetHeight() const { return height_; }
+
+    // Доступ до останнього збереженого кадру (щільно упакований BGRA)
+    const uint8_t* GetPreviousFrame() const { return previous_.data(); }
+
+private:
+    typedef bool (*BytesEqualFunc)(const uint8_t* a, const uint8_t* b, size_t size);
+
+    bool TileEqual(const uint8_t* frame, int stride, int x, int y, int w, int h) const;
+    void StoreTile(const uint8_t* frame, int stride, int x, int y, int w, int h);
+
+    int width_ = 0;
+    int height_ = 0;
+    int tile_size_ = 0;
+    int tiles_x_ = 0;
+    int tiles_y_ = 0;
+    bool has_previous_ = false;
+    std::vector<uint8_t> previous_;
+    std::vector<uint8_t> move_scratch_;
+    BytesEqualFunc bytes_equal_ = nullptr;
+};
+
+#endif // TILE_DIFF_H
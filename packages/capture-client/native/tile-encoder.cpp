@@ -0,0 +1,310 @@
+/**
+ * Screen Tile Encoder Implementation
+ */
+
+#include "tile-encoder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t kColorMask = 0x00FFFFFF;
+constexpr size_t kMaxRun = 16;
+
+inline void WriteU16(uint8_t* p, uint16_t value) {
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)(value >> 8);
+}
+
+inline void WriteU32(uint8_t* p, uint32_t value) {
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)((value >> 8) & 0xFF);
+    p[2] = (uint8_t)((value >> 16) & 0xFF);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+// 0x00RRGGBB -> B, G, R (порядок байтів BGRA кадру)
+inline uint8_t* WriteColor(uint8_t* out, uint32_t color) {
+    out[0] = (uint8_t)(color & 0xFF);
+    out[1] = (uint8_t)((color >> 8) & 0xFF);
+    out[2] = (uint8_t)((color >> 16) & 0xFF);
+    return out + 3;
+}
+
+// Найбільший потік плитки: тип + raw пікселі (палітра завжди менша)
+size_t GetMaxStreamSize(int tiles, int width, int height) {
+    return (size_t)tiles * (2 + TileEncoder::kMaxPaletteColors * 3) + (size_t)width * height * 3;
+}
+
+} // namespace
+
+TileEncoder::TileEncoder() {
+}
+
+TileEncoder::~TileEncoder() {
+}
+
+void TileEncoder::SetError(const std::string& error) {
+    last_error_ = error;
+}
+
+bool TileEncoder::Initialize(int width, int height, int tile_size, int jpeg_quality, bool chroma_420) {
+    if (width <= 0 || height <= 0 || width > 0xFFFF || height > 0xFFFF) {
+        SetError("Invalid frame size for tile encoding");
+        return false;
+    }
+    if (tile_size < 16 || tile_size > 256 || tile_size % 16 != 0) {
+        SetError("Tile size must be a multiple of 16 in 16..256");
+        return false;
+    }
+
+    count_colors_ = GetCountColorsFunc();
+    if (!count_colors_) {
+        SetError("No color counting kernel");
+        return false;
+    }
+
+    width_ = width;
+    height_ = height;
+    tile_size_ = tile_size;
+    tiles_x_ = (width + tile_size - 1) / tile_size;
+    tiles_y_ = (height + tile_size - 1) / tile_size;
+    jpeg_quality_ = std::max(0, std::min(100, jpeg_quality));
+    chroma_420_ = chroma_420;
+
+    stream_.resize(GetMaxStreamSize(tiles_x_ * tiles_y_, width, height));
+    indices_.resize((size_t)tile_size * tile_size);
+    complex_.clear();
+    complex_.reserve((size_t)tiles_x_ * tiles_y_);
+
+    // Атлас ініціалізується під розмір при першому кадрі зі складними плитками
+    jpeg_.reset(jpeg_quality_ > 0 ? new JpegEncoder() : nullptr);
+    jpeg_width_ = 0;
+    jpeg_height_ = 0;
+    return true;
+}
+
+size_t TileEncoder::GetMaxPacketSize() const {
+    const int tiles = tiles_x_ * tiles_y_;
+    size_t atlas = 0;
+    if (jpeg_quality_ > 0 && tiles > 0) {
+        const int columns = std::min(kAtlasColumns, tiles);
+        const int rows = (tiles + columns - 1) / columns;
+        atlas = (size_t)columns * rows * tile_size_ * tile_size_ * 3 + 4096;
+    }
+    return kHeaderSize + LzCompressor::GetMaxCompressedSize(GetMaxStreamSize(tiles, width_, height_)) + atlas;
+}
+
+uint8_t* TileEncoder::WritePaletteTile(const uint8_t* pixels, int stride, int w, int h,
+                                       const uint32_t* palette, int colors, uint8_t* out) {
+    // Індекси пікселів; сусідні пікселі здебільшого того ж кольору
+    uint8_t last = 0;
+    size_t i = 0;
+    for (int y = 0; y < h; y++) {
+        const uint32_t* row = reinterpret_cast<const uint32_t*>(pixels + (size_t)y * stride);
+        for (int x = 0; x < w; x++) {
+            const uint32_t color = row[x] & kColorMask;
+            if (palette[last] != color) {
+                last = 0;
+                while (palette[last] != color) {
+                    last++;
+                }
+            }
+            indices_[i++] = last;
+        }
+    }
+    const size_t count = i;
+
+    const int bits = colors <= 2 ? 1 : (colors <= 4 ? 2 : 4);
+    const size_t row_bytes = ((size_t)w * bits + 7) / 8;
+    size_t runs = 0;
+    for (size_t start = 0; start < count; runs++) {
+        size_t end = start + 1;
+        while (end < count && end - start < kMaxRun && indices_[end] == indices_[start]) {
+            end++;
+        }
+        start = end;
+    }
+
+    const bool rle = runs < row_bytes * h;
+    *out++ = rle ? kTileRle : kTilePalette;
+    *out++ = (uint8_t)colors;
+    for (int k = 0; k < colors; k++) {
+        out = WriteColor(out, palette[k]);
+    }
+
+    if (rle) {
+        for (size_t start = 0; start < count;) {
+            size_t end = start + 1;
+            while (end < count && end - start < kMaxRun && indices_[end] == indices_[start]) {
+                end++;
+            }
+            *out++ = (uint8_t)((indices_[start] << 4) | (end - start - 1));
+            start = end;
+        }
+        stats_.rle_tiles++;
+        return out;
+    }
+
+    // Старші біти - лівіші пікселі, рядок доповнюється до байта
+    const uint8_t* index = indices_.data();
+    for (int y = 0; y < h; y++) {
+        uint8_t acc = 0;
+        int filled = 0;
+        for (int x = 0; x < w; x++) {
+            acc |= (uint8_t)(*index++ << (8 - bits - filled));
+            filled += bits;
+            if (filled == 8) {
+                *out++ = acc;
+                acc = 0;
+                filled = 0;
+            }
+        }
+        if (filled) {
+            *out++ = acc;
+        }
+    }
+    stats_.palette_tiles++;
+    return out;
+}
+
+uint8_t* TileEncoder::WriteTile(const uint8_t* pixels, int stride, int w, int h, uint8_t* out) {
+    uint32_t palette[kMaxPaletteColors];
+    const int colors = count_colors_(pixels, stride, w, h, palette, kMaxPaletteColors);
+
+    if (colors == 1) {
+        *out++ = kTileFlat;
+        stats_.flat_tiles++;
+        return WriteColor(out, palette[0]);
+    }
+    if (colors <= kMaxPaletteColors) {
+        return WritePaletteTile(pixels, stride, w, h, palette, colors, out);
+    }
+
+    stats_.complex_tiles++;
+    if (jpeg_) {
+        *out++ = kTileComplex;
+        return out;
+    }
+    *out++ = kTileRaw;
+    for (int y = 0; y < h; y++) {
+        const uint8_t* row = pixels + (size_t)y * stride;
+        for (int x = 0; x < w; x++) {
+            out[0] = row[x * 4];
+            out[1] = row[x * 4 + 1];
+            out[2] = row[x * 4 + 2];
+            out += 3;
+        }
+    }
+    return out;
+}
+
+bool TileEncoder::EncodeAtlas(const uint8_t* frame, int stride, uint8_t* out, size_t capacity,
+                              size_t& out_size) {
+    const int count = (int)complex_.size();
+    atlas_columns_ = std::min(kAtlasColumns, count);
+    const int rows = (count + atlas_columns_ - 1) / atlas_columns_;
+    const int atlas_width = atlas_columns_ * tile_size_;
+    const int atlas_height = rows * tile_size_;
+    const size_t atlas_stride = (size_t)atlas_width * 4;
+    atlas_.resize(atlas_stride * atlas_height);
+
+    // Обрізані плитки доповнюються повтором крайніх пікселів - без різкої межі в блоці JPEG
+    for (int k = 0; k < count; k++) {
+        const int tile = complex_[k];
+        const int x = (tile % tiles_x_) * tile_size_;
+        const int y = (tile / tiles_x_) * tile_size_;
+        const int w = std::min(tile_size_, width_ - x);
+        const int h = std::min(tile_size_, height_ - y);
+        uint8_t* cell = atlas_.data() + (size_t)(k / atlas_columns_) * tile_size_ * atlas_stride +
+                        (size_t)(k % atlas_columns_) * tile_size_ * 4;
+        for (int row = 0; row < tile_size_; row++) {
+            const uint8_t* src = frame + (size_t)(y + std::min(row, h - 1)) * stride + (size_t)x * 4;
+            uint32_t* dst = reinterpret_cast<uint32_t*>(cell + (size_t)row * atlas_stride);
+            memcpy(dst, src, (size_t)w * 4);
+            std::fill(dst + w, dst + tile_size_, dst[w - 1]);
+        }
+    }
+
+    if (atlas_width != jpeg_width_ || atlas_height != jpeg_height_) {
+        if (!jpeg_->Initialize(atlas_width, atlas_height, jpeg_quality_, chroma_420_)) {
+            SetError(jpeg_->GetLastError());
+            return false;
+        }
+        jpeg_width_ = atlas_width;
+        jpeg_height_ = atlas_height;
+    }
+    if (!jpeg_->Encode(atlas_.data(), (int)atlas_stride, out, capacity, out_size)) {
+        SetError(jpeg_->GetLastError());
+        return false;
+    }
+    return true;
+}
+
+bool TileEncoder::Encode(const uint8_t* frame, int stride, uint8_t* out, size_t capacity,
+                         size_t& out_size) {
+    out_size = 0;
+
+    if (!count_colors_) {
+        SetError("Tile encoder not initialized");
+        return false;
+    }
+    if (!frame || !out || stride < width_ * 4) {
+        SetError("Invalid input data size");
+        return false;
+    }
+    if (capacity < GetMaxPacketSize()) {
+        SetError("Tile output buffer too small");
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    stats_ = TileEncoderStats();
+    complex_.clear();
+
+    uint8_t* stream = stream_.data();
+    for (int ty = 0; ty < tiles_y_; ty++) {
+        for (int tx = 0; tx < tiles_x_; tx++) {
+            const int x = tx * tile_size_;
+            const int y = ty * tile_size_;
+            const int complex_before = stats_.complex_tiles;
+            stream = WriteTile(frame + (size_t)y * stride + (size_t)x * 4, stride,
+                               std::min(tile_size_, width_ - x), std::min(tile_size_, height_ - y), stream);
+            if (jpeg_ && stats_.complex_tiles != complex_before) {
+                complex_.push_back(ty * tiles_x_ + tx);
+            }
+        }
+    }
+    stats_.stream_bytes = (size_t)(stream - stream_.data());
+
+    uint8_t* body = out + kHeaderSize;
+    stats_.lz_bytes = lz_.Compress(stream_.data(), stats_.stream_bytes, body, capacity - kHeaderSize);
+    if (stats_.lz_bytes == 0 && stats_.stream_bytes > 0) {
+        SetError("Tile stream compression failed");
+        return false;
+    }
+
+    atlas_columns_ = 0;
+    if (!complex_.empty()) {
+        uint8_t* jpeg = body + stats_.lz_bytes;
+        if (!EncodeAtlas(frame, stride, jpeg, capacity - (size_t)(jpeg - out), stats_.jpeg_bytes)) {
+            return false;
+        }
+    }
+
+    WriteU32(out, kMagic);
+    WriteU16(out + 4, (uint16_t)width_);
+    WriteU16(out + 6, (uint16_t)height_);
+    WriteU16(out + 8, (uint16_t)tile_size_);
+    out[10] = (uint8_t)atlas_columns_;
+    out[11] = 0;
+    WriteU32(out + 12, (uint32_t)stats_.stream_bytes);
+    WriteU32(out + 16, (uint32_t)stats_.lz_bytes);
+    WriteU32(out + 20, (uint32_t)stats_.jpeg_bytes);
+
+    out_size = kHeaderSize + stats_.lz_bytes + stats_.jpeg_bytes;
+    stats_.encode_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return true;
+}
@@ -0,0 +1,114 @@
+/**
+ * Screen Tile Encoder
+ * Екранний кодек плитками: однотонні й малоколірні плитки (текст, UI) - без втрат
+ * (колір / палітра з упакованими індексами або RLE, далі LZ), складні (фото, відео) -
+ * одним JPEG атласом
+ *
+ * Формат пакету (little-endian):
+ *   0  uint32  magic 'TIL1'
+ *   4  uint16  width
+ *   6  uint16  height
+ *   8  uint16  tile_size
+ *   10 uint8   atlas_columns (клітинок у рядку атласу, 0 - атласу немає)
+ *   11 uint8   reserved
+ *   12 uint32  розмір потоку плиток
+ *   16 uint32  розмір стиснутого потоку (блок LZ4, lz-block.h)
+ *   20 uint32  розмір JPEG атласу
+ *   24 ..      стиснутий потік плиток, далі JPEG атлас
+ *
+ * Потік плиток - для кожної плитки рядками: тип (uint8) і дані
+ *   0 flat     B, G, R
+ *   1 palette  n (2..16), n * (B, G, R), індекси рядками по 1/2/4 біти (n <= 2 / 4 / 16,
+ *              старші біти байта - лівіші пікселі), кожен рядок доповнено до байта
+ *   2 rle      n (2..16), n * (B, G, R), байти (індекс << 4 | довжина - 1): серії
+ *              пікселів плитки рядками підряд (серія може переходити на наступний рядок)
+ *   3 complex  без даних: k-та складна плитка - клітинка k атласу (рядками по atlas_columns)
+ *   4 raw      w * h * (B, G, R) - складна плитка, коли JPEG вимкнено
+ * Крайні плитки обрізані; клітинки атласу - tile_size x tile_size (обрізана плитка
+ * в лівому верхньому куті клітинки). Альфа не передається.
+ */
+
+#ifndef TILE_ENCODER_H
+#define TILE_ENCODER_H
+
+#include "color-count.h"
+#include "jpeg-encoder.h"
+#include "lz-block.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct TileEncoderStats {
+    int flat_tiles = 0;
+    int palette_tiles = 0;          // Упаковані індекси
+    int rle_tiles = 0;
+    int complex_tiles = 0;          // JPEG атлас або raw
+    size_t stream_bytes = 0;        // Потік плиток до LZ
+    size_t lz_bytes = 0;
+    size_t jpeg_bytes = 0;
+    double encode_ms = 0.0;
+};
+
+class TileEncoder {
+public:
+    static constexpr uint32_t kMagic = 0x314C4954; // "TIL1"
+    static constexpr size_t kHeaderSize = 24;
+    static constexpr int kMaxPaletteColors = kMaxCountedColors;
+    static constexpr int kAtlasColumns = 16;
+
+    enum TileType : uint8_t {
+        kTileFlat = 0,
+        kTilePalette = 1,
+        kTileRle = 2,
+        kTileComplex = 3,
+        kTileRaw = 4
+    };
+
+    TileEncoder();
+    ~TileEncoder();
+
+    // tile_size кратний 16 - межі плиток збігаються з блоками JPEG атласу.
+    // jpeg_quality = 0 - складні плитки теж без втрат (raw + LZ).
+    bool Initialize(int width, int height, int tile_size = 64, int jpeg_quality = 80,
+                    bool chroma_420 = true);
+
+    // Закодувати BGRA кадр у out (ємність >= GetMaxPacketSize()). Кадр самодостатній.
+    bool Encode(const uint8_t* frame, int stride, uint8_t* out, size_t capacity, size_t& out_size);
+
+    size_t GetMaxPacketSize() const;
+    TileEncoderStats GetLastStats() const { return stats_; }
+    std::string GetLastError() const { return last_error_; }
+
+private:
+    uint8_t* WriteTile(const uint8_t* pixels, int stride, int w, int h, uint8_t* out);
+    uint8_t* WritePaletteTile(const uint8_t* pixels, int stride, int w, int h, const uint32_t* palette,
+                              int colors, uint8_t* out);
+    bool EncodeAtlas(const uint8_t* frame, int stride, uint8_t* out, size_t capacity, size_t& out_size);
+    void SetError(const std::string& error);
+
+    int width_ = 0;
+    int height_ = 0;
+    int tile_size_ = 0;
+    int tiles_x_ = 0;
+    int tiles_y_ = 0;
+    int jpeg_quality_ = 0;
+    bool chroma_420_ = true;
+    CountColorsFunc count_colors_ = nullptr;
+
+    std::vector<uint8_t> stream_;
+    std::vector<uint8_t> indices_;      // Індекси палітри поточної плитки
+    std::vector<int> complex_;          // Складні плитки кадру (індекси) - клітинки атласу
+    std::vector<uint8_t> atlas_;
+    int atlas_columns_ = 0;
+    std::unique_ptr<JpegEncoder> jpeg_;
+    int jpeg_width_ = 0;                // Розмір, під який ініціалізовано jpeg_
+    int jpeg_height_ = 0;
+    LzCompressor lz_;
+
+    TileEncoderStats stats_;
+    std::string last_error_;
+};
+
+#endif // TILE_ENCODER_H
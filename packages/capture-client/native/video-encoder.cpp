@@ -0,0 +1,121 @@
+/**
+ * Video Encoder - спільна конвертація та вибір бекенду
+ */
+
+#include "video-encoder.h"
+#include "stats.h"
+
+#ifdef _WIN32
+#include "encoder.h"
+#endif
+
+#ifdef CAPTURE_HAVE_X264
+#include "x264-encoder.h"
+#endif
+
+bool VideoEncoder::Encode(const uint8_t* bgra, int stride, uint8_t* out, size_t capacity,
+                          size_t& out_size) {
+    out_size = 0;
+
+    if (!nv12_buffer_.Resize(GetNV12Size())) {
+        SetError("Failed to allocate NV12 buffer");
+        return false;
+    }
+
+    if (!ConvertToNV12(bgra, stride, nv12_buffer_.data())) {
+        return false;
+    }
+    return EncodeNV12(nv12_buffer_.data(), out, capacity, out_size);
+}
+
+void VideoEncoder::SetSourceSize(int width, int height, ScaleFilter filter) {
+    source_width_ = width;
+    source_height_ = height;
+    scale_filter_ = filter;
+}
+
+bool VideoEncoder::ConvertToNV12(const uint8_t* bgra, int stride, uint8_t* nv12) {
+    if (width_ == 0) {
+        SetError("Encoder not initialized");
+        return false;
+    }
+
+    bool scale = source_width_ > 0 && source_height_ > 0 &&
+                 (source_width_ != width_ || source_height_ != height_);
+    int input_width = scale ? source_width_ : width_;
+
+    // Перевірити вхідні дані
+    if (!bgra || !nv12 || stride < input_width * 4) {
+        SetError("Invalid input data size");
+        return false;
+    }
+
+    uint8_t* y_plane = nv12;
+    uint8_t* uv_plane = y_plane + (size_t)width_ * height_;
+
+    if (scale) {
+        // Таблиці відліків перераховуються лише після зміни розмірів (повторний Initialize)
+        if (!scaler_.IsInitialized() || scaler_.GetFilter() != scale_filter_ ||
+            scaler_.GetSourceWidth() != source_width_ || scaler_.GetSourceHeight() != source_height_ ||
+            scaler_.GetWidth() != width_ || scaler_.GetHeight() != height_) {
+            if (!scaler_.Initialize(source_width_, source_height_, width_, height_, scale_filter_)) {
+                SetError("Failed to initialize frame scaler");
+                return false;
+            }
+        }
+
+        // Масштаб + BGRA -> NV12 за один прохід (SIMD смугами на пулі потоків)
+        if (!scaler_.ScaleToNV12(bgra, stride, y_plane, width_, uv_plane, width_)) {
+            SetError("Failed to scale BGRA to NV12");
+            return false;
+        }
+        last_convert_ms_ = scaler_.GetLastScaleTimeMs();
+    } else {
+        // Конвертувати BGRA -> NV12 (SIMD смугами на пулі потоків, chroma 2x2)
+        if (!converter_.ConvertToNV12(bgra, stride, width_, height_,
+                                      y_plane, width_, uv_plane, width_)) {
+            SetError("Failed to convert BGRA to NV12");
+            return false;
+        }
+        last_convert_ms_ = converter_.GetLastConvertTimeMs();
+    }
+
+    GetCaptureStats().RecordMs(StatStage::Convert, last_convert_ms_);
+    return true;
+}
+
+const char* GetDefaultVideoEncoderBackend() {
+#if defined(_WIN32)
+    return "mf";
+#elif defined(CAPTURE_HAVE_X264)
+    return "x264";
+#else
+    return "none";
+#endif
+}
+
+std::unique_ptr<VideoEncoder> CreateVideoEncoder(const std::string& backend, std::string& error) {
+    std::string name = backend;
+    if (name.empty() || name == "auto") {
+        name = GetDefaultVideoEncoderBackend();
+    }
+
+#ifdef _WIN32
+    if (name == "mf") {
+        return std::unique_ptr<VideoEncoder>(new H264Encoder());
+    }
+#endif
+
+#ifdef CAPTURE_HAVE_X264
+    if (name == "x264") {
+        return std::unique_ptr<VideoEncoder>(new X264Encoder());
+    }
+#endif
+
+    if (name == "none") {
+        error = "No H.264 encoder in this build (Media Foundation needs Windows, x264 needs libx264)";
+    } else {
+        error = "H.264 encoder backend not available in this build: " + name;
+    }
+    return nullptr;
+}
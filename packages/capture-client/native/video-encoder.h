@@ -0,0 +1,94 @@
+/**
+ * Video Encoder Interface
+ * Абстракція H.264 енкодера: Media Foundation (Windows), x264 (програмний)
+ */
+
+#ifndef VIDEO_ENCODER_H
+#define VIDEO_ENCODER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "aligned-memory.h"
+#include "frame-converter.h"
+#include "frame-scaler.h"
+
+// Параметри енкодера (спільні для всіх бекендів)
+struct VideoEncoderConfig {
+    int width = 0;
+    int height = 0;
+    int bitrate = 2000000;              // біт/с
+    int fps = 30;
+    int keyframe_interval = 300;        // Максимальна відстань між IDR кадрами
+    bool use_hardware = true;           // mf: апаратний MFT (NVENC/QuickSync/VCE)
+    bool low_latency = true;            // x264: zerolatency (без lookahead і B-кадрів, slice-потоки)
+    int threads = 0;                    // x264: потоки кодування (0 - авто)
+    std::string preset = "veryfast";    // x264: ultrafast .. medium
+};
+
+class VideoEncoder {
+public:
+    virtual ~VideoEncoder() {}
+
+    virtual bool Initialize(const VideoEncoderConfig& config) = 0;
+    // Закодувати NV12 кадр (Y + UV з кроком width); out_size = 0, якщо енкодеру потрібно більше кадрів
+    virtual bool EncodeNV12(const uint8_t* nv12, uint8_t* out, size_t capacity, size_t& out_size) = 0;
+    virtual void Cleanup() = 0;
+    virtual const char* GetName() const = 0;
+
+    // Закодувати BGRA кадр (ConvertToNV12 + EncodeNV12)
+    bool Encode(const uint8_t* bgra, int stride, uint8_t* out, size_t capacity, size_t& out_size);
+
+    // Розмір BGRA кадру на вході, якщо він відрізняється від розміру кодування:
+    // масштаб зливається з конвертацією в NV12 (один прохід по кадру)
+    void SetSourceSize(int width, int height, ScaleFilter filter);
+
+    // Окремі стадії Encode для конвеєра (можуть виконуватися на різних потоках)
+    bool ConvertToNV12(const uint8_t* bgra, int stride, uint8_t* nv12);
+    size_t GetNV12Size() const { return (size_t)width_ * height_ * 3 / 2; }
+
+    // Пул потоків для смугової конвертації BGRA -> NV12
+    void SetWorkerPool(WorkerPool* pool) {
+        converter_.SetWorkerPool(pool);
+        scaler_.SetWorkerPool(pool);
+    }
+    double GetLastConvertTimeMs() const { return last_convert_ms_; }
+
+    // Наступний закодований кадр - IDR (новий глядач, втрачений кадр).
+    // Безпечно з будь-якого потоку: бекенд забирає запит у EncodeNV12
+    void ForceKeyframe() { force_keyframe_ = true; }
+
+    // Останній закодований кадр - IDR (з SPS/PPS)
+    bool IsLastKeyframe() const { return last_keyframe_; }
+    std::string GetLastError() const { return last_error_; }
+
+protected:
+    void SetError(const std::string& error) { last_error_ = error; }
+    // Запит ForceKeyframe для поточного кадру (скидається атомарно)
+    bool ConsumeKeyframeRequest() { return force_keyframe_.exchange(false); }
+
+    FrameConverter converter_;
+    FrameScaler scaler_;
+    AlignedBuffer nv12_buffer_;     // NV12 кадр для Encode()
+
+    int source_width_ = 0;          // 0 - вхід уже в розмірі кодування
+    int source_height_ = 0;
+    ScaleFilter scale_filter_ = ScaleFilter::Box;
+    double last_convert_ms_ = 0.0;
+
+    int width_ = 0;                 // 0 - енкодер не ініціалізований
+    int height_ = 0;
+    bool last_keyframe_ = false;
+    std::atomic<bool> force_keyframe_{false};
+    std::string last_error_;
+};
+
+// Бекенд за замовчуванням для поточної збірки
+const char* GetDefaultVideoEncoderBackend();
+
+// backend: auto | mf | x264. nullptr, якщо бекенд недоступний у цій збірці (error)
+std::unique_ptr<VideoEncoder> CreateVideoEncoder(const std::string& backend, std::string& error);
+
+#endif // VIDEO_ENCODER_H
@@ -0,0 +1,132 @@
+/**
+ * Persistent Worker Pool Implementation
+ */
+
+#include "worker-pool.h"
+#include <algorithm>
+#include <system_error>
+
+WorkerPool::WorkerPool() {
+}
+
+WorkerPool::~WorkerPool() {
+    Shutdown();
+}
+
+bool WorkerPool::Initialize(int threads) {
+    Shutdown();
+
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    threads = std::max(1, std::min(threads, kMaxThreads));
+
+    stopping_ = false;
+    generation_ = 0;
+
+    // Викликаючий потік - один з робочих, тому створюємо на один менше
+    try {
+        for (int i = 1; i < threads; i++) {
+            workers_.emplace_back(&WorkerPool::WorkerLoop, this);
+        }
+    } catch (const std::system_error&) {
+        Shutdown();
+        return false;
+    }
+
+    return true;
+}
+
+void WorkerPool::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+}
+
+void WorkerPool::Run(int count, TaskFunc func, const void* context) {
+    if (count <= 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> call_lock(call_mutex_);
+
+    // Немає сенсу будити потоки для однієї задачі
+    if (workers_.empty() || count == 1) {
+        for (int i = 0; i < count; i++) {
+            func(context, i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_func_ = func;
+        task_context_ = context;
+        task_count_ = count;
+        next_index_.store(0, std::memory_order_relaxed);
+        pending_ = count;
+        active_workers_ = static_cast<int>(workers_.size());
+        generation_++;
+    }
+    work_cv_.notify_all();
+
+    RunTasks();
+
+    // Чекати, поки всі потоки закінчать і більше не торкаються задачі
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return pending_ == 0 && active_workers_ == 0; });
+    task_func_ = nullptr;
+    task_context_ = nullptr;
+}
+
+void WorkerPool::RunTasks() {
+    int done = 0;
+    for (;;) {
+        int index = next_index_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= task_count_) {
+            break;
+        }
+        task_func_(task_context_, index);
+        done++;
+    }
+
+    if (done > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ -= done;
+        if (pending_ == 0 && active_workers_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+void WorkerPool::WorkerLoop() {
+    uint64_t seen_generation = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) {
+                return;
+            }
+            seen_generation = generation_;
+        }
+
+        RunTasks();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        active_workers_--;
+        if (pending_ == 0 && active_workers_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
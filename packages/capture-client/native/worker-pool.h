@@ -0,0 +1,66 @@
+/**
+ * Persistent Worker Pool
+ * Постійні потоки для паралельної обробки кадрів (створюються один раз при initialize)
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool {
+public:
+    static constexpr int kMaxThreads = 8;
+
+    WorkerPool();
+    ~WorkerPool();
+
+    // threads = 0 -> кількість ядер (але не більше kMaxThreads)
+    bool Initialize(int threads = 0);
+    void Shutdown();
+
+    // Виконати task(i) для кожного i з [0, count) і дочекатися завершення.
+    // Викликаючий потік теж бере участь у роботі. Задача передається за вказівником
+    // (без std::function), тож лямбда з будь-яким захопленням не виділяє пам'ять.
+    template <typename Task>
+    void ParallelFor(int count, const Task& task) {
+        Run(count, &InvokeTask<Task>, &task);
+    }
+
+    // Загальна кількість потоків, включно з викликаючим
+    int GetThreadCount() const { return static_cast<int>(workers_.size()) + 1; }
+
+private:
+    typedef void (*TaskFunc)(const void* context, int index);
+
+    template <typename Task>
+    static void InvokeTask(const void* context, int index) {
+        (*static_cast<const Task*>(context))(index);
+    }
+
+    void Run(int count, TaskFunc func, const void* context);
+    void WorkerLoop();
+    void RunTasks();
+
+    std::vector<std::thread> workers_;
+    std::mutex call_mutex_;     // Один ParallelFor одночасно
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+
+    TaskFunc task_func_ = nullptr;
+    const void* task_context_ = nullptr;
+    int task_count_ = 0;
+    std::atomic<int> next_index_{0};
+    int pending_ = 0;
+    int active_workers_ = 0;
+    uint64_t generation_ = 0;
+    bool stopping_ = false;
+};
+
+#endif // WORKER_POOL_H
@@ -0,0 +1,350 @@
+/**
+ * X11 Screen Capture Implementation (MIT-SHM)
+ */
+
+#include "x11-capture.h"
+#include "cursor.h"
+#include "stats.h"
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#ifdef CAPTURE_HAVE_XRANDR
+#include <X11/extensions/Xrandr.h>
+#endif
+#ifdef CAPTURE_HAVE_XFIXES
+#include <X11/extensions/Xfixes.h>
+#endif
+// X.h визначає CursorShape (клас XQueryBestSize) - конфліктує з типом з cursor.h
+#undef CursorShape
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+// XShmAttach повідомляє про помилку асинхронно (наприклад, віддалений дисплей)
+std::atomic<bool> g_x_error{false};
+
+int RecordXError(Display*, XErrorEvent*) {
+    g_x_error = true;
+    return 0;
+}
+
+} // namespace
+
+X11Capture::X11Capture(const std::string& display_name, int output)
+    : display_name_(display_name), output_(output) {
+}
+
+X11Capture::~X11Capture() {
+    Cleanup();
+}
+
+void X11Capture::SetError(const std::string& error) {
+    last_error_ = error;
+}
+
+void X11Capture::QueryOutputs(Display* display, std::vector<CaptureOutputInfo>& outputs) {
+    outputs.clear();
+    int screen = DefaultScreen(display);
+
+#ifdef CAPTURE_HAVE_XRANDR
+    int event_base = 0;
+    int error_base = 0;
+    int monitor_count = 0;
+    XRRMonitorInfo* monitors = nullptr;
+    if (XRRQueryExtension(display, &event_base, &error_base)) {
+        monitors = XRRGetMonitors(display, RootWindow(display, screen), True, &monitor_count);
+    }
+    for (int i = 0; monitors && i < monitor_count; i++) {
+        CaptureOutputInfo output;
+        output.index = i;
+        char* name = XGetAtomName(display, monitors[i].name);
+        if (name) {
+            output.name = name;
+            XFree(name);
+        }
+        output.x = monitors[i].x;
+        output.y = monitors[i].y;
+        output.width = monitors[i].width;
+        output.height = monitors[i].height;
+        output.primary = monitors[i].primary != 0;
+        outputs.push_back(output);
+    }
+    if (monitors) {
+        XRRFreeMonitors(monitors);
+    }
+#endif
+
+    // Без XRandR (або Xvfb без моніторів) - увесь кореневий екран
+    if (outputs.empty()) {
+        CaptureOutputInfo output;
+        output.name = "screen-" + std::to_string(screen);
+        output.width = DisplayWidth(display, screen);
+        output.height = DisplayHeight(display, screen);
+        output.primary = true;
+        outputs.push_back(output);
+    }
+}
+
+bool X11Capture::EnumerateOutputs(const std::string& display_name,
+                                  std::vector<CaptureOutputInfo>& outputs, std::string& error) {
+    Display* display = XOpenDisplay(display_name.empty() ? nullptr : display_name.c_str());
+    if (!display) {
+        error = "Failed to open X display";
+        return false;
+    }
+    QueryOutputs(display, outputs);
+    XCloseDisplay(display);
+    return true;
+}
+
+bool X11Capture::Initialize(int width, int height) {
+    Cleanup();
+
+    display_ = XOpenDisplay(display_name_.empty() ? nullptr : display_name_.c_str());
+    if (!display_) {
+        SetError("Failed to open X display");
+        return false;
+    }
+
+    int screen = DefaultScreen(display_);
+    root_ = RootWindow(display_, screen);
+
+    // Як і DXGI бекенд - завжди весь монітор (width/height досягаються масштабом у module.cpp)
+    (void)width;
+    (void)height;
+    std::vector<CaptureOutputInfo> outputs;
+    QueryOutputs(display_, outputs);
+    if (output_ < 0 || output_ >= (int)outputs.size()) {
+        SetError("Output not found: " + std::to_string(output_));
+        Cleanup();
+        return false;
+    }
+    const CaptureOutputInfo& output = outputs[output_];
+    if (!ResolveCaptureRegion(region_, output.width, output.height, crop_)) {
+        SetError("Capture region is outside the output");
+        Cleanup();
+        return false;
+    }
+    origin_x_ = output.x + crop_.x;
+    origin_y_ = output.y + crop_.y;
+    width_ = crop_.width;
+    height_ = crop_.height;
+
+    Visual* visual = DefaultVisual(display_, screen);
+    int depth = DefaultDepth(display_, screen);
+    if ((depth != 24 && depth != 32) || visual->red_mask != 0xFF0000 ||
+        visual->green_mask != 0x00FF00 || visual->blue_mask != 0x0000FF) {
+        SetError("Unsupported X visual (expected 24/32-bit BGRX)");
+        Cleanup();
+        return false;
+    }
+
+    if (!InitializeShm()) {
+        // Без MIT-SHM кожен кадр копіюється через сокет X сервера
+        use_shm_ = false;
+    }
+
+#ifdef CAPTURE_HAVE_XFIXES
+    int event_base = 0;
+    int error_base = 0;
+    has_xfixes_ = XFixesQueryExtension(display_, &event_base, &error_base) != False;
+#endif
+    cursor_serial_ = 0;
+
+    return true;
+}
+
+bool X11Capture::InitializeShm() {
+    if (!XShmQueryExtension(display_)) {
+        return false;
+    }
+
+    int screen = DefaultScreen(display_);
+    XShmSegmentInfo* info = new XShmSegmentInfo();
+    memset(info, 0, sizeof(*info));
+
+    XImage* image = XShmCreateImage(display_, DefaultVisual(display_, screen),
+                                    DefaultDepth(display_, screen), ZPixmap, nullptr,
+                                    info, width_, height_);
+    if (!image) {
+        delete info;
+        return false;
+    }
+
+    info->shmid = shmget(IPC_PRIVATE, (size_t)image->bytes_per_line * image->height,
+                         IPC_CREAT | 0600);
+    if (info->shmid < 0) {
+        XDestroyImage(image);
+        delete info;
+        return false;
+    }
+
+    info->shmaddr = image->data = static_cast<char*>(shmat(info->shmid, nullptr, 0));
+    info->readOnly = False;
+    if (info->shmaddr == reinterpret_cast<char*>(-1)) {
+        shmctl(info->shmid, IPC_RMID, nullptr);
+        image->data = nullptr;
+        XDestroyImage(image);
+        delete info;
+        return false;
+    }
+
+    g_x_error = false;
+    XErrorHandler previous = XSetErrorHandler(RecordXError);
+    Status attached = XShmAttach(display_, info);
+    XSync(display_, False);
+    XSetErrorHandler(previous);
+
+    // Сегмент видаляється після від'єднання останнього процесу
+    shmctl(info->shmid, IPC_RMID, nullptr);
+
+    if (!attached || g_x_error) {
+        shmdt(info->shmaddr);
+        image->data = nullptr;
+        XDestroyImage(image);
+        delete info;
+        return false;
+    }
+
+    image_ = image;
+    shm_info_ = info;
+    use_shm_ = true;
+    return true;
+}
+
+bool X11Capture::SetRegion(const FrameRect& region) {
+    region_ = region;
+    return true;
+}
+
+void X11Capture::Cleanup() {
+    ReleaseFrameView();
+
+    if (display_ && shm_info_) {
+        XShmSegmentInfo* info = static_cast<XShmSegmentInfo*>(shm_info_);
+        XShmDetach(display_, info);
+        XSync(display_, False);
+        shmdt(info->shmaddr);
+        delete info;
+        shm_info_ = nullptr;
+    }
+
+    if (image_) {
+        // Дані сегмента вже від'єднані - XDestroyImage не повинен їх звільняти
+        if (use_shm_) {
+            image_->data = nullptr;
+        }
+        XDestroyImage(image_);
+        image_ = nullptr;
+    }
+
+    if (display_) {
+        XCloseDisplay(display_);
+        display_ = nullptr;
+    }
+
+    use_shm_ = false;
+    has_xfixes_ = false;
+    origin_x_ = 0;
+    origin_y_ = 0;
+    width_ = 0;
+    height_ = 0;
+}
+
+bool X11Capture::CaptureFrame(uint8_t* dst, int dst_stride) {
+    if (!dst || dst_stride < width_ * 4) {
+        SetError("Invalid destination buffer");
+        return false;
+    }
+
+    ScopedStageTimer timer(StatStage::Map);
+    FrameView view;
+    if (!AcquireFrameView(view)) {
+        return false;
+    }
+    // X сервер віддає BGRX - альфа-байт не визначений, виставляємо 0xFF як у DXGI
+    CopyFrameView(view, dst, dst_stride);
+    ReleaseFrameView();
+    return true;
+}
+
+bool X11Capture::AcquireFrameView(FrameView& view) {
+    if (!display_) {
+        SetError("Not initialized");
+        return false;
+    }
+
+    if (cursor_) {
+        UpdateCursor();
+    }
+
+    XImage* image = image_;
+    if (use_shm_) {
+        if (!XShmGetImage(display_, root_, image_, origin_x_, origin_y_, AllPlanes)) {
+            SetError("XShmGetImage failed");
+            return false;
+        }
+    } else {
+        image = XGetImage(display_, root_, origin_x_, origin_y_, width_, height_, AllPlanes, ZPixmap);
+        if (!image) {
+            SetError("XGetImage failed");
+            return false;
+        }
+        view_image_ = image;
+    }
+
+    view.data = reinterpret_cast<const uint8_t*>(image->data);
+    view.stride = image->bytes_per_line;
+    view.width = width_;
+    view.height = height_;
+    view.format = PixelFormat::BGRX;
+    view.crop = crop_;
+    return true;
+}
+
+void X11Capture::UpdateCursor() {
+#ifdef CAPTURE_HAVE_XFIXES
+    if (!has_xfixes_) {
+        return;
+    }
+    XFixesCursorImage* cursor = XFixesGetCursorImage(display_);
+    if (!cursor) {
+        return;
+    }
+
+    // Пікселі форми конвертуються лише при зміні курсора (новий serial)
+    if (cursor->cursor_serial != cursor_serial_) {
+        // pixels - unsigned long на піксель (64 біти на LP64), ARGB у молодших 32 бітах
+        const size_t count = (size_t)cursor->width * cursor->height;
+        std::vector<uint32_t> argb(count);
+        for (size_t i = 0; i < count; i++) {
+            argb[i] = (uint32_t)cursor->pixels[i];
+        }
+        CursorShape shape;
+        if (ConvertCursorShape(CursorShapeType::PremultipliedARGB, reinterpret_cast<const uint8_t*>(argb.data()),
+                               cursor->width, cursor->height, cursor->width * 4,
+                               cursor->xhot, cursor->yhot, shape)) {
+            cursor_->UpdateShape(std::move(shape));
+        }
+        cursor_serial_ = cursor->cursor_serial;
+    }
+
+    // x/y - точка вказівника в кореневому вікні; видимий, якщо форма перетинає регіон
+    const int x = cursor->x - cursor->xhot - origin_x_;
+    const int y = cursor->y - cursor->yhot - origin_y_;
+    const bool visible = x + cursor->width > 0 && y + cursor->height > 0 && x < width_ && y < height_;
+    cursor_->UpdatePosition(visible, x, y);
+    XFree(cursor);
+#endif
+}
+
+void X11Capture::ReleaseFrameView() {
+    // Сегмент MIT-SHM перезаписується лише наступним XShmGetImage
+    if (view_image_) {
+        XDestroyImage(view_image_);
+        view_image_ = nullptr;
+    }
+}
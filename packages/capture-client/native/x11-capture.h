@@ -0,0 +1,78 @@
+/**
+ * X11 Screen Capture (MIT-SHM)
+ * Захоплення кореневого вікна через XShmGetImage (працює з Xvfb)
+ */
+
+#ifndef X11_CAPTURE_H
+#define X11_CAPTURE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "capture-source.h"
+
+// Xlib визначає макроси (None, Status, Bool...), тому заголовки X11 лише в .cpp
+struct _XDisplay;
+struct _XImage;
+
+class X11Capture : public CaptureSource {
+public:
+    // display_name порожнє -> $DISPLAY; output - монітор з EnumerateOutputs
+    explicit X11Capture(const std::string& display_name = "", int output = 0);
+    ~X11Capture() override;
+
+    // Монітори XRandR (без XRandR - один вихід на весь кореневий екран)
+    static bool EnumerateOutputs(const std::string& display_name,
+                                 std::vector<CaptureOutputInfo>& outputs, std::string& error);
+
+    bool Initialize(int width = 0, int height = 0) override;
+    bool CaptureFrame(uint8_t* dst, int dst_stride) override;
+    void Cleanup() override;
+
+    // Регіон читається з X сервера без решти монітора (сегмент MIT-SHM розміру регіону)
+    bool SetRegion(const FrameRect& region) override;
+    // View - сам сегмент MIT-SHM (BGRX, крок bytes_per_line)
+    bool SupportsFrameView() const override { return true; }
+    bool AcquireFrameView(FrameView& view) override;
+    void ReleaseFrameView() override;
+    PixelFormat GetViewFormat() const override { return PixelFormat::BGRX; }
+    // Позиція/форма через XFixesGetCursorImage (без XFixes - курсор не відстежується)
+    void SetCursorTracker(CursorTracker* tracker) override { cursor_ = tracker; }
+
+    const char* GetName() const override { return "x11"; }
+    int GetWidth() const override { return width_; }
+    int GetHeight() const override { return height_; }
+    std::string GetLastError() const override { return last_error_; }
+
+    // false - MIT-SHM недоступний, використовується повільніший XGetImage
+    bool IsUsingShm() const { return use_shm_; }
+
+private:
+    bool InitializeShm();
+    void UpdateCursor();
+    void SetError(const std::string& error);
+
+    static void QueryOutputs(_XDisplay* display, std::vector<CaptureOutputInfo>& outputs);
+
+    std::string display_name_;
+    int output_ = 0;
+    _XDisplay* display_ = nullptr;
+    unsigned long root_ = 0;
+    _XImage* image_ = nullptr;
+    _XImage* view_image_ = nullptr; // Без MIT-SHM: XGetImage поточного view
+    void* shm_info_ = nullptr;      // XShmSegmentInfo
+    bool use_shm_ = false;
+    CursorTracker* cursor_ = nullptr;
+    bool has_xfixes_ = false;
+    unsigned long cursor_serial_ = 0;   // XFixesCursorImage::cursor_serial останньої форми
+
+    FrameRect region_;              // Запит SetRegion (відносно монітора)
+    FrameRect crop_;                // Регіон після Initialize
+    int origin_x_ = 0;              // Позиція регіону в кореневому вікні
+    int origin_y_ = 0;
+    int width_ = 0;
+    int height_ = 0;
+    std::string last_error_;
+};
+
+#endif // X11_CAPTURE_H
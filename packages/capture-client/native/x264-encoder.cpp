@@ -0,0 +1,145 @@
+/**
+ * x264 Encoder Implementation
+ * Низька затримка: tune zerolatency (без lookahead і B-кадрів, slice-потоки), VBV на один кадр
+ */
+
+#include "x264-encoder.h"
+#include "stats.h"
+#include <cstdint>
+#include <cstring>
+
+extern "C" {
+#include <x264.h>
+}
+
+X264Encoder::X264Encoder() {
+}
+
+X264Encoder::~X264Encoder() {
+    Cleanup();
+}
+
+bool X264Encoder::Initialize(const VideoEncoderConfig& config) {
+    Cleanup();
+
+    // NV12 з chroma 2x2 - розміри мають бути парними
+    if (config.width <= 0 || config.height <= 0 || config.fps <= 0 ||
+        (config.width & 1) || (config.height & 1)) {
+        SetError("Invalid encoder configuration");
+        return false;
+    }
+
+    x264_param_t param;
+    const char* tune = config.low_latency ? "zerolatency" : nullptr;
+    if (x264_param_default_preset(&param, config.preset.c_str(), tune) < 0) {
+        SetError("Unknown x264 preset: " + config.preset);
+        return false;
+    }
+
+    param.i_log_level = X264_LOG_ERROR;
+    param.i_width = config.width;
+    param.i_height = config.height;
+    param.i_csp = X264_CSP_NV12;
+    param.i_fps_num = config.fps;
+    param.i_fps_den = 1;
+    param.i_timebase_num = 1;
+    param.i_timebase_den = config.fps;
+    param.b_vfr_input = 0;
+
+    // zerolatency вмикає slice-потоки: кадр кодується всіма потоками одразу, без затримки
+    param.i_threads = config.threads > 0 ? config.threads : X264_THREADS_AUTO;
+    param.i_keyint_max = config.keyframe_interval > 0 ? config.keyframe_interval : X264_KEYINT_MAX_INFINITE;
+
+    // ABR з VBV на один кадр - розмір кадру не накопичує затримку в мережі
+    int kbps = config.bitrate / 1000;
+    if (kbps <= 0) {
+        kbps = 2000;
+    }
+    param.rc.i_rc_method = X264_RC_ABR;
+    param.rc.i_bitrate = kbps;
+    param.rc.i_vbv_max_bitrate = kbps;
+    param.rc.i_vbv_buffer_size = kbps / config.fps > 0 ? kbps / config.fps : 1;
+
+    // SPS/PPS перед кожним IDR (глядач може підключитися в будь-який момент), Annex-B
+    param.b_repeat_headers = 1;
+    param.b_annexb = 1;
+
+    if (x264_param_apply_profile(&param, "high") < 0) {
+        SetError("Failed to apply x264 profile");
+        return false;
+    }
+
+    encoder_ = x264_encoder_open(&param);
+    if (!encoder_) {
+        SetError("Failed to open x264 encoder");
+        return false;
+    }
+
+    width_ = config.width;
+    height_ = config.height;
+    pts_ = 0;
+    return true;
+}
+
+bool X264Encoder::EncodeNV12(const uint8_t* nv12, uint8_t* out, size_t capacity, size_t& out_size) {
+    out_size = 0;
+    last_keyframe_ = false;
+
+    if (!encoder_) {
+        SetError("Encoder not initialized");
+        return false;
+    }
+    if (!nv12 || !out) {
+        SetError("Invalid input data size");
+        return false;
+    }
+
+    // Площини вказують прямо на NV12 буфер конвеєра (x264 їх лише читає)
+    x264_picture_t pic_in;
+    x264_picture_init(&pic_in);
+    pic_in.img.i_csp = X264_CSP_NV12;
+    pic_in.img.i_plane = 2;
+    pic_in.img.plane[0] = const_cast<uint8_t*>(nv12);
+    pic_in.img.i_stride[0] = width_;
+    pic_in.img.plane[1] = const_cast<uint8_t*>(nv12) + (size_t)width_ * height_;
+    pic_in.img.i_stride[1] = width_;
+    pic_in.i_pts = pts_++;
+    pic_in.i_type = ConsumeKeyframeRequest() ? X264_TYPE_IDR : X264_TYPE_AUTO;
+
+    x264_picture_t pic_out;
+    x264_nal_t* nals = nullptr;
+    int nal_count = 0;
+    int frame_size = x264_encoder_encode(encoder_, &nals, &nal_count, &pic_in, &pic_out);
+    if (frame_size < 0) {
+        SetError("x264_encoder_encode failed");
+        return false;
+    }
+    if (frame_size == 0) {
+        // Кадр затримано всередині x264 (лише без zerolatency)
+        GetCaptureStats().Add(StatCounter::EncoderNeedInput);
+        return true;
+    }
+
+    if ((size_t)frame_size > capacity) {
+        SetError("Encoded frame does not fit output buffer");
+        return false;
+    }
+
+    // Payload усіх NAL одного кадру лежать у пам'яті поспіль - одна копія у вихідний буфер
+    memcpy(out, nals[0].p_payload, frame_size);
+    out_size = frame_size;
+    last_keyframe_ = pic_out.b_keyframe != 0;
+    return true;
+}
+
+void X264Encoder::Cleanup() {
+    if (encoder_) {
+        x264_encoder_close(encoder_);
+        encoder_ = nullptr;
+    }
+
+    width_ = 0;
+    height_ = 0;
+    pts_ = 0;
+    last_keyframe_ = false;
+}
@@ -0,0 +1,33 @@
+/**
+ * H.264 Encoder using x264 (software)
+ * Портативний програмний бекенд: Linux, CI, порівняння з MF на одній машині
+ */
+
+#ifndef X264_ENCODER_H
+#define X264_ENCODER_H
+
+#include "video-encoder.h"
+
+// Непрозорі типи x264.h - заголовок бібліотеки не потрапляє в модуль
+struct x264_t;
+
+class X264Encoder : public VideoEncoder {
+public:
+    X264Encoder();
+    ~X264Encoder() override;
+
+    X264Encoder(const X264Encoder&) = delete;
+    X264Encoder& operator=(const X264Encoder&) = delete;
+
+    bool Initialize(const VideoEncoderConfig& config) override;
+    // NV12 передається в x264 за вказівниками на площини, без проміжної копії
+    bool EncodeNV12(const uint8_t* nv12, uint8_t* out, size_t capacity, size_t& out_size) override;
+    void Cleanup() override;
+    const char* GetName() const override { return "x264"; }
+
+private:
+    x264_t* encoder_ = nullptr;
+    int64_t pts_ = 0;
+};
+
+#endif // X264_ENCODER_H
@@ -0,0 +1,387 @@
+/**
+ * Capture Recording Tests
+ * Запис -> відкриття: повні й дельта-записи, обірваний запис (index_offset = 0)
+ * відновлюється до останнього цілого кадру, пошкоджений індекс відхиляється,
+ * ReplayCapture дельта-запису віддає ті самі кадри, що й повний запис
+ */
+
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include "capture-recording.h"
+#include "replay-capture.h"
+#include "test-common.h"
+
+namespace {
+
+constexpr int kWidth = 300;     // Крайні плитки сітки 64 обрізані
+constexpr int kHeight = 250;
+constexpr int kFrames = 24;
+
+std::string TempPath(const char* name) {
+    return ::testing::TempDir() + "capture-test-" + name + ".crec";
+}
+
+std::vector<uint8_t> ReadFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void WriteFile(const std::string& path, const std::vector<uint8_t>& data) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(data.data()), (std::streamsize)data.size());
+}
+
+template <typename T>
+T ReadField(const std::vector<uint8_t>& data, size_t offset) {
+    T value;
+    memcpy(&value, data.data() + offset, sizeof(value));
+    return value;
+}
+
+template <typename T>
+void WriteField(std::vector<uint8_t>& data, size_t offset, T value) {
+    memcpy(data.data() + offset, &value, sizeof(value));
+}
+
+// Робочий стіл: курсор-прямокутник і рядок тексту щокадру (дельта), раз на 8 кадрів -
+// нове вікно на весь екран (повний кадр)
+std::vector<TestFrame> MakeSession(uint32_t seed) {
+    std::vector<TestFrame> frames;
+    TestRandom random(seed);
+    TestFrame frame(kWidth, kHeight, 24);
+    frame.FillRandom(seed);
+    for (int i = 0; i < kFrames; i++) {
+        if (i > 0 && i % 8 == 0) {
+            frame.FillRandom(seed + (uint32_t)i);
+        } else if (i > 0) {
+            frame.FillRect(random.Range(kWidth - 12), random.Range(kHeight - 12), 12, 12, random.Next());
+            frame.FillRect(0, kHeight - 5, 1 + random.Range(kWidth), 5, random.Next());
+        }
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+FrameView ViewOf(const TestFrame& frame) {
+    FrameView view;
+    view.data = frame.pixels.data();
+    view.stride = frame.stride;
+    view.width = frame.width;
+    view.height = frame.height;
+    return view;
+}
+
+// Переміщення джерела на кожному третьому кадрі - зберігаються як є
+std::vector<MoveRect> MovesFor(int index) {
+    std::vector<MoveRect> moves;
+    if (index % 3 == 1) {
+        MoveRect move;
+        move.src_x = index;
+        move.src_y = 10;
+        move.width = 40;
+        move.height = 20;
+        move.dst_x = index + 5;
+        move.dst_y = 30;
+        moves.push_back(move);
+    }
+    return moves;
+}
+
+bool Record(const std::string& path, const std::vector<TestFrame>& frames, bool delta, RecorderStats* stats = nullptr) {
+    CaptureRecorder recorder;
+    if (!recorder.Open(path, kWidth, kHeight, PixelFormat::BGRA, delta)) {
+        ADD_FAILURE() << recorder.GetLastError();
+        return false;
+    }
+    for (size_t i = 0; i < frames.size(); i++) {
+        if (!recorder.WriteFrame(ViewOf(frames[i]), MovesFor((int)i))) {
+            ADD_FAILURE() << recorder.GetLastError();
+            return false;
+        }
+    }
+    if (stats) {
+        *stats = recorder.GetStats();
+    }
+    return recorder.Close();
+}
+
+bool SameRows(const uint8_t* data, int stride, const TestFrame& frame) {
+    for (int y = 0; y < frame.height; y++) {
+        if (memcmp(data + (size_t)y * stride, frame.Row(y), (size_t)frame.width * 4) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Обірваний процес: індексу немає, index_offset у заголовку - 0, файл обрізано на size
+std::vector<uint8_t> Unfinished(const std::vector<uint8_t>& closed, size_t size) {
+    const uint64_t index_offset = ReadField<uint64_t>(closed, offsetof(RecordingHeader, index_offset));
+    std::vector<uint8_t> data(closed.begin(), closed.begin() + (ptrdiff_t)std::min<uint64_t>(size, index_offset));
+    WriteField<uint64_t>(data, offsetof(RecordingHeader, frame_count), 0);
+    WriteField<uint64_t>(data, offsetof(RecordingHeader, index_offset), 0);
+    return data;
+}
+
+TEST(CaptureRecordingTest, FullRecordingRoundTrip) {
+    const std::string path = TempPath("full");
+    const std::vector<TestFrame> frames = MakeSession(1);
+    RecorderStats stats;
+    ASSERT_TRUE(Record(path, frames, false, &stats));
+    EXPECT_EQ(stats.frames, (uint64_t)kFrames);
+    EXPECT_EQ(stats.full_frames, (uint64_t)kFrames);
+
+    CaptureRecording recording;
+    ASSERT_TRUE(recording.Open(path)) << recording.GetLastError();
+    EXPECT_FALSE(recording.IsRecovered());
+    EXPECT_FALSE(recording.IsDelta());
+    ASSERT_EQ(recording.GetFrameCount(), (size_t)kFrames);
+    EXPECT_EQ(recording.GetWidth(), kWidth);
+    EXPECT_EQ(recording.GetHeight(), kHeight);
+
+    uint64_t last_timestamp = 0;
+    for (size_t i = 0; i < recording.GetFrameCount(); i++) {
+        SCOPED_TRACE(i);
+        RecordedFrame frame;
+        ASSERT_TRUE(recording.GetFrame(i, frame));
+        EXPECT_TRUE(frame.full);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(frame.pixels) % CaptureRecorder::kRecordAlignment, 0u);
+        EXPECT_TRUE(SameRows(frame.pixels, recording.GetStride(), frames[i]));
+        EXPECT_GE(frame.timestamp_us, last_timestamp);
+        EXPECT_EQ(frame.timestamp_us, recording.GetTimestampUs(i));
+        last_timestamp = frame.timestamp_us;
+
+        const std::vector<MoveRect> moves = MovesFor((int)i);
+        ASSERT_EQ(frame.move_count, (int)moves.size());
+        for (size_t k = 0; k < moves.size(); k++) {
+            EXPECT_EQ(memcmp(&frame.moves[k], &moves[k], sizeof(MoveRect)), 0);
+        }
+    }
+    RecordedFrame frame;
+    EXPECT_FALSE(recording.GetFrame(kFrames, frame));
+    recording.Close();
+    remove(path.c_str());
+}
+
+TEST(CaptureRecordingTest, TruncatedRecordingRecoversWholeFrames) {
+    const std::string path = TempPath("closed");
+    const std::vector<TestFrame> frames = MakeSession(2);
+    ASSERT_TRUE(Record(path, frames, true));
+    const std::vector<uint8_t> closed = ReadFile(path);
+
+    // Зміщення записів кадрів - з індексу завершеного файлу
+    std::vector<uint64_t> offsets;
+    {
+        CaptureRecording recording;
+        ASSERT_TRUE(recording.Open(path)) << recording.GetLastError();
+        const uint64_t index_offset = ReadField<uint64_t>(closed, offsetof(RecordingHeader, index_offset));
+        for (size_t i = 0; i < recording.GetFrameCount(); i++) {
+            offsets.push_back(ReadField<uint64_t>(closed, (size_t)index_offset + i * sizeof(RecordingIndexEntry)));
+        }
+    }
+    ASSERT_EQ(offsets.size(), (size_t)kFrames);
+    const uint64_t data_end = ReadField<uint64_t>(closed, offsetof(RecordingHeader, index_offset));
+
+    struct Cut {
+        uint64_t size;
+        size_t frames;
+    };
+    const Cut cuts[] = {
+        { data_end, (size_t)kFrames },                  // Усі кадри записано, індексу немає
+        { offsets[10], 10 },                            // Рівно на межі запису
+        { offsets[10] + 8, 10 },                        // Посеред заголовка кадру
+        { offsets[10] + sizeof(RecordedFrameHeader) + 100, 10 },   // Посеред пікселів
+        { offsets[0] + sizeof(RecordedFrameHeader) + 1000, 0 },   // Перший кадр неповний - кадрів немає
+    };
+    const std::string truncated_path = TempPath("truncated");
+    for (const Cut& cut : cuts) {
+        SCOPED_TRACE(cut.size);
+        WriteFile(truncated_path, Unfinished(closed, (size_t)cut.size));
+        CaptureRecording recording;
+        if (cut.frames == 0) {
+            EXPECT_FALSE(recording.Open(truncated_path));
+            EXPECT_FALSE(recording.GetLastError().empty());
+            continue;
+        }
+        ASSERT_TRUE(recording.Open(truncated_path)) << recording.GetLastError();
+        EXPECT_TRUE(recording.IsRecovered());
+        EXPECT_TRUE(recording.IsDelta());
+        ASSERT_EQ(recording.GetFrameCount(), cut.frames);
+
+        // Відновлений запис відтворюється так само, як завершений
+        ReplayCapture replay(truncated_path, false, false);
+        ASSERT_TRUE(replay.Initialize()) << replay.GetLastError();
+        TestFrame out(kWidth, kHeight);
+        for (size_t i = 0; i < cut.frames; i++) {
+            SCOPED_TRACE(i);
+            ASSERT_TRUE(replay.CaptureFrame(out.pixels.data(), out.stride)) << replay.GetLastError();
+            ASSERT_TRUE(SamePixels(out, frames[i]));
+        }
+        EXPECT_FALSE(replay.CaptureFrame(out.pixels.data(), out.stride));
+    }
+    remove(path.c_str());
+    remove(truncated_path.c_str());
+}
+
+TEST(CaptureRecordingTest, RejectsCorruptIndexAndHeaders) {
+    const std::string path = TempPath("source");
+    ASSERT_TRUE(Record(path, MakeSession(3), true));
+    const std::vector<uint8_t> closed = ReadFile(path);
+    const size_t index_offset = (size_t)ReadField<uint64_t>(closed, offsetof(RecordingHeader, index_offset));
+    const size_t entry = index_offset + 5 * sizeof(RecordingIndexEntry);
+
+    // Знайти перший дельта-запис - для підміни кадру 0
+    uint64_t delta_offset = 0;
+    for (size_t i = 0; i < (size_t)kFrames && !delta_offset; i++) {
+        const size_t at = index_offset + i * sizeof(RecordingIndexEntry);
+        if (ReadField<uint32_t>(closed, at + offsetof(RecordingIndexEntry, type)) == CaptureRecorder::kFrameDelta) {
+            delta_offset = ReadField<uint64_t>(closed, at);
+        }
+    }
+    ASSERT_NE(delta_offset, 0u);
+    const uint64_t frame5 = ReadField<uint64_t>(closed, entry);
+
+    struct Corruption {
+        const char* name;
+        std::function<void(std::vector<uint8_t>&)> apply;
+    };
+    const Corruption corruptions[] = {
+        { "misaligned entry", [&](std::vector<uint8_t>& d) { WriteField<uint64_t>(d, entry, frame5 + 8); } },
+        { "entry past end", [&](std::vector<uint8_t>& d) { WriteField<uint64_t>(d, entry, (uint64_t)d.size() + 64); } },
+        { "entry into index", [&](std::vector<uint8_t>& d) {
+            WriteField<uint64_t>(d, entry, (uint64_t)index_offset & ~(uint64_t)63); } },
+        { "frame count too large", [&](std::vector<uint8_t>& d) {
+            WriteField<uint64_t>(d, offsetof(RecordingHeader, frame_count), (uint64_t)kFrames + 1); } },
+        { "huge frame count", [&](std::vector<uint8_t>& d) {
+            WriteField<uint64_t>(d, offsetof(RecordingHeader, frame_count), ~0ull / 2); } },
+        { "index offset past end", [&](std::vector<uint8_t>& d) {
+            WriteField<uint64_t>(d, offsetof(RecordingHeader, index_offset), (uint64_t)d.size() + 1); } },
+        { "delta first", [&](std::vector<uint8_t>& d) { WriteField<uint64_t>(d, index_offset, delta_offset); } },
+        { "frame magic", [&](std::vector<uint8_t>& d) { d[(size_t)frame5] ^= 0xFF; } },
+        { "frame type", [&](std::vector<uint8_t>& d) {
+            WriteField<uint16_t>(d, (size_t)frame5 + offsetof(RecordedFrameHeader, type), 7); } },
+        { "pixel bytes", [&](std::vector<uint8_t>& d) {
+            const size_t at = (size_t)frame5 + offsetof(RecordedFrameHeader, pixel_bytes);
+            WriteField<uint64_t>(d, at, ReadField<uint64_t>(d, at) + 4); } },
+        { "dirty rect outside frame", [&](std::vector<uint8_t>& d) {
+            WriteField<int32_t>(d, (size_t)delta_offset + sizeof(RecordedFrameHeader), kWidth); } },
+        { "truncated index", [&](std::vector<uint8_t>& d) { d.resize(d.size() - 1); } },
+        { "bad magic", [&](std::vector<uint8_t>& d) { d[0] ^= 0xFF; } },
+        { "bad version", [&](std::vector<uint8_t>& d) {
+            WriteField<uint16_t>(d, offsetof(RecordingHeader, version), 2); } },
+        { "zero width", [&](std::vector<uint8_t>& d) { WriteField<uint32_t>(d, offsetof(RecordingHeader, width), 0); } },
+        { "short header", [&](std::vector<uint8_t>& d) { d.resize(sizeof(RecordingHeader) - 1); } },
+        { "empty file", [&](std::vector<uint8_t>& d) { d.clear(); } },
+    };
+
+    const std::string corrupt_path = TempPath("corrupt");
+    for (const Corruption& corruption : corruptions) {
+        SCOPED_TRACE(corruption.name);
+        std::vector<uint8_t> data = closed;
+        corruption.apply(data);
+        WriteFile(corrupt_path, data);
+        CaptureRecording recording;
+        EXPECT_FALSE(recording.Open(corrupt_path));
+        EXPECT_FALSE(recording.GetLastError().empty());
+        EXPECT_EQ(recording.GetFrameCount(), 0u);
+
+        ReplayCapture replay(corrupt_path, false, false);
+        EXPECT_FALSE(replay.Initialize());
+    }
+
+    // Без змін файл відкривається - кожна відмова вище викликана саме пошкодженням
+    WriteFile(corrupt_path, closed);
+    CaptureRecording recording;
+    EXPECT_TRUE(recording.Open(corrupt_path)) << recording.GetLastError();
+    remove(path.c_str());
+    remove(corrupt_path.c_str());
+}
+
+TEST(CaptureRecordingTest, DeltaReplayMatchesFullReplay) {
+    const std::vector<TestFrame> frames = MakeSession(4);
+    const std::string full_path = TempPath("replay-full");
+    const std::string delta_path = TempPath("replay-delta");
+    RecorderStats full_stats, delta_stats;
+    ASSERT_TRUE(Record(full_path, frames, false, &full_stats));
+    ASSERT_TRUE(Record(delta_path, frames, true, &delta_stats));
+    // Дельта-запис справді містить дельти і менший за повний
+    EXPECT_EQ(delta_stats.full_frames, 3u);
+    EXPECT_LT(delta_stats.bytes, full_stats.bytes / 2);
+
+    ReplayCapture full(full_path, false, false);
+    ReplayCapture delta(delta_path, false, false);
+    ASSERT_TRUE(full.Initialize()) << full.GetLastError();
+    ASSERT_TRUE(delta.Initialize()) << delta.GetLastError();
+    EXPECT_EQ(delta.GetWidth(), kWidth);
+    EXPECT_EQ(delta.GetHeight(), kHeight);
+
+    TestFrame out_full(kWidth, kHeight, 8);
+    TestFrame out_delta(kWidth, kHeight, 16);
+    for (int i = 0; i < kFrames; i++) {
+        SCOPED_TRACE(i);
+        ASSERT_TRUE(full.CaptureFrame(out_full.pixels.data(), out_full.stride)) << full.GetLastError();
+        ASSERT_TRUE(delta.CaptureFrame(out_delta.pixels.data(), out_delta.stride)) << delta.GetLastError();
+        ASSERT_TRUE(SamePixels(out_full, frames[(size_t)i]));
+        ASSERT_TRUE(SamePixels(out_delta, frames[(size_t)i]));
+        EXPECT_EQ(delta.GetAccumulatedFrames(), 1);
+
+        // Змінені області дельта-кадру покривають усі змінені пікселі
+        if (i > 0 && i % 8 != 0) {
+            std::vector<FrameRect> dirty;
+            ASSERT_TRUE(delta.GetDirtyRects(dirty));
+            TestFrame masked = frames[(size_t)i];
+            for (const FrameRect& rect : dirty) {
+                for (int y = rect.y; y < rect.y + rect.height; y++) {
+                    memcpy(masked.Pixel(rect.x, y), frames[(size_t)i - 1].Pixel(rect.x, y), (size_t)rect.width * 4);
+                }
+            }
+            EXPECT_TRUE(SamePixels(masked, frames[(size_t)i - 1]));
+        }
+        std::vector<MoveRect> moves;
+        ASSERT_TRUE(delta.GetMoveRects(moves));
+        EXPECT_EQ(moves.size(), MovesFor(i).size());
+    }
+    EXPECT_FALSE(full.CaptureFrame(out_full.pixels.data(), out_full.stride));
+    EXPECT_FALSE(delta.CaptureFrame(out_delta.pixels.data(), out_delta.stride));
+    full.Cleanup();
+    delta.Cleanup();
+    remove(full_path.c_str());
+    remove(delta_path.c_str());
+}
+
+TEST(CaptureRecordingTest, DeltaReplayLoopsAndCropsRegion) {
+    const std::vector<TestFrame> frames = MakeSession(5);
+    const std::string path = TempPath("replay-region");
+    ASSERT_TRUE(Record(path, frames, true));
+
+    FrameRect region;
+    region.x = 30;
+    region.y = 20;
+    region.width = 100;
+    region.height = 90;
+    ReplayCapture replay(path, false, true);
+    ASSERT_TRUE(replay.SetRegion(region));
+    ASSERT_TRUE(replay.Initialize()) << replay.GetLastError();
+    ASSERT_EQ(replay.GetWidth(), region.width);
+
+    // Два проходи: після кінця запису - знову з повного кадру 0
+    TestFrame out(region.width, region.height);
+    for (int i = 0; i < 2 * kFrames; i++) {
+        SCOPED_TRACE(i);
+        ASSERT_TRUE(replay.CaptureFrame(out.pixels.data(), out.stride)) << replay.GetLastError();
+        const TestFrame& source = frames[(size_t)(i % kFrames)];
+        for (int y = 0; y < region.height; y++) {
+            ASSERT_EQ(memcmp(out.Row(y), source.Pixel(region.x, region.y + y), (size_t)region.width * 4), 0);
+        }
+    }
+    EXPECT_EQ(replay.GetLoopCount(), 1u);
+    replay.Cleanup();
+    remove(path.c_str());
+}
+
+} // namespace
@@ -0,0 +1,250 @@
+/**
+ * Color Conversion Tests
+ * SSE2/AVX2 ядра BGRA -> NV12/I420 біт-в-біт як scalar еталон: непарні розміри,
+ * рядки з pitch, усі матриці й діапазони; scalar - проти формули з color-convert.h
+ */
+
+#include <gtest/gtest.h>
+#include "color-convert.h"
+#include "frame-converter.h"
+#include "test-common.h"
+#include "worker-pool.h"
+
+namespace {
+
+constexpr uint8_t kSentinel = 0xA5;     // Padding площин: ядро не повинно його змінювати
+
+struct Coefficients {
+    int yr, yg, yb, y_offset;
+    int ur, ug, ub;
+    int vr, vg, vb;
+};
+
+template <ColorMatrix M, ColorRange R>
+Coefficients MakeCoefficients() {
+    typedef YuvCoefficients<M, R> C;
+    return { C::kYR, C::kYG, C::kYB, C::kYOffset, C::kUR, C::kUG, C::kUB, C::kVR, C::kVG, C::kVB };
+}
+
+Coefficients GetCoefficients(ColorMatrix matrix, ColorRange range) {
+    if (matrix == ColorMatrix::BT601) {
+        return range == ColorRange::Limited ? MakeCoefficients<ColorMatrix::BT601, ColorRange::Limited>()
+                                            : MakeCoefficients<ColorMatrix::BT601, ColorRange::Full>();
+    }
+    return range == ColorRange::Limited ? MakeCoefficients<ColorMatrix::BT709, ColorRange::Limited>()
+                                        : MakeCoefficients<ColorMatrix::BT709, ColorRange::Full>();
+}
+
+// Площини YUV 4:2:0 з pitch (для NV12 u - площина UV, v порожня)
+struct Planes {
+    int width = 0;
+    int height = 0;
+    int y_stride = 0;
+    int c_stride = 0;
+    std::vector<uint8_t> y;
+    std::vector<uint8_t> u;
+    std::vector<uint8_t> v;
+
+    Planes(int w, int h, bool nv12, int padding) : width(w), height(h) {
+        const int chroma_width = (w + 1) / 2;
+        const int chroma_height = (h + 1) / 2;
+        y_stride = w + padding;
+        c_stride = (nv12 ? chroma_width * 2 : chroma_width) + padding;
+        y.assign((size_t)y_stride * h, kSentinel);
+        u.assign((size_t)c_stride * chroma_height, kSentinel);
+        if (!nv12) {
+            v.assign((size_t)c_stride * chroma_height, kSentinel);
+        }
+    }
+};
+
+bool Convert(const TestFrame& src, Planes& dst, bool nv12, ColorMatrix matrix, ColorRange range,
+             ConvertKernel kernel) {
+    if (nv12) {
+        return ConvertBGRAToNV12(src.pixels.data(), src.stride, src.width, src.height,
+                                 dst.y.data(), dst.y_stride, dst.u.data(), dst.c_stride,
+                                 matrix, range, kernel);
+    }
+    return ConvertBGRAToI420(src.pixels.data(), src.stride, src.width, src.height,
+                             dst.y.data(), dst.y_stride, dst.u.data(), dst.c_stride,
+                             dst.v.data(), dst.c_stride, matrix, range, kernel);
+}
+
+// Формула з коментаря color-convert.h; непарний останній рядок/стовпець дублюється
+Planes ReferenceConvert(const TestFrame& src, bool nv12, ColorMatrix matrix, ColorRange range,
+                        int padding) {
+    const Coefficients c = GetCoefficients(matrix, range);
+    Planes out(src.width, src.height, nv12, padding);
+
+    for (int y = 0; y < src.height; y++) {
+        for (int x = 0; x < src.width; x++) {
+            const uint8_t* p = src.Pixel(x, y);
+            out.y[(size_t)y * out.y_stride + x] =
+                (uint8_t)(((c.yr * p[2] + c.yg * p[1] + c.yb * p[0] + 128) >> 8) + c.y_offset);
+        }
+    }
+
+    for (int cy = 0; cy < (src.height + 1) / 2; cy++) {
+        for (int cx = 0; cx < (src.width + 1) / 2; cx++) {
+            const int x0 = cx * 2;
+            const int y0 = cy * 2;
+            const int x1 = x0 + 1 < src.width ? x0 + 1 : x0;
+            const int y1 = y0 + 1 < src.height ? y0 + 1 : y0;
+            int sum[3];
+            for (int k = 0; k < 3; k++) {
+                sum[k] = (src.Pixel(x0, y0)[k] + src.Pixel(x1, y0)[k] +
+                          src.Pixel(x0, y1)[k] + src.Pixel(x1, y1)[k] + 2) >> 2;
+            }
+            const int b = sum[0], g = sum[1], r = sum[2];
+            const uint8_t u = (uint8_t)(((c.ur * r + c.ug * g + c.ub * b + 128) >> 8) + 128);
+            const uint8_t v = (uint8_t)(((c.vr * r + c.vg * g + c.vb * b + 128) >> 8) + 128);
+            if (nv12) {
+                out.u[(size_t)cy * out.c_stride + cx * 2] = u;
+                out.u[(size_t)cy * out.c_stride + cx * 2 + 1] = v;
+            } else {
+                out.u[(size_t)cy * out.c_stride + cx] = u;
+                out.v[(size_t)cy * out.c_stride + cx] = v;
+            }
+        }
+    }
+    return out;
+}
+
+// Порівняння разом із padding: ядро не пише за межі рядка
+void ExpectSamePlanes(const Planes& expected, const Planes& actual) {
+    ASSERT_EQ(expected.y.size(), actual.y.size());
+    for (size_t i = 0; i < expected.y.size(); i++) {
+        ASSERT_EQ(expected.y[i], actual.y[i]) << "Y row " << i / expected.y_stride
+                                              << " col " << i % expected.y_stride;
+    }
+    for (size_t i = 0; i < expected.u.size(); i++) {
+        ASSERT_EQ(expected.u[i], actual.u[i]) << "U/UV row " << i / expected.c_stride
+                                              << " col " << i % expected.c_stride;
+    }
+    for (size_t i = 0; i < expected.v.size(); i++) {
+        ASSERT_EQ(expected.v[i], actual.v[i]) << "V row " << i / expected.c_stride
+                                              << " col " << i % expected.c_stride;
+    }
+}
+
+struct FrameSize {
+    int width;
+    int height;
+};
+
+// Непарні розміри і ширини навколо 16/32 пікселів (хвости SSE2/AVX2 ядер)
+const FrameSize kSizes[] = {
+    { 1, 1 }, { 2, 2 }, { 3, 3 }, { 7, 5 }, { 15, 7 }, { 16, 2 }, { 17, 9 }, { 31, 4 },
+    { 32, 3 }, { 33, 17 }, { 47, 6 }, { 63, 11 }, { 64, 64 }, { 65, 33 }, { 129, 7 }, { 1921, 3 },
+};
+
+const ColorMatrix kMatrices[] = { ColorMatrix::BT601, ColorMatrix::BT709 };
+const ColorRange kRanges[] = { ColorRange::Limited, ColorRange::Full };
+
+// Випадкові пікселі + насичені смуги (крайні значення 16-бітних сум)
+TestFrame MakeSource(int width, int height, int padding, uint32_t seed) {
+    TestFrame frame(width, height, padding, kSentinel);
+    frame.FillRandom(seed);
+    if (height > 2) {
+        frame.FillRect(0, 0, width, 1, 0xFFFFFFFF);
+        frame.FillRect(0, 1, width, 1, 0xFF000000);
+    }
+    return frame;
+}
+
+struct KernelCase {
+    ConvertKernel kernel;
+    bool nv12;
+};
+
+void PrintTo(const KernelCase& param, std::ostream* os) {
+    *os << GetConvertKernelName(param.kernel) << (param.nv12 ? " NV12" : " I420");
+}
+
+class ColorConvertKernelTest : public ::testing::TestWithParam<KernelCase> {};
+
+TEST_P(ColorConvertKernelTest, MatchesScalarReference) {
+    const KernelCase param = GetParam();
+    if (!IsConvertKernelSupported(param.kernel)) {
+        GTEST_SKIP() << GetConvertKernelName(param.kernel) << " not supported by this CPU";
+    }
+
+    uint32_t seed = 1;
+    for (const FrameSize& size : kSizes) {
+        // Щільні рядки і pitch, не кратний 16 байтам
+        for (int padding : { 0, 13 }) {
+            const TestFrame src = MakeSource(size.width, size.height, padding * 4, seed++);
+            for (ColorMatrix matrix : kMatrices) {
+                for (ColorRange range : kRanges) {
+                    SCOPED_TRACE(::testing::Message() << size.width << "x" << size.height
+                                 << " padding " << padding << " matrix " << (int)matrix
+                                 << " range " << (int)range);
+                    const Planes expected = ReferenceConvert(src, param.nv12, matrix, range, padding);
+                    Planes actual(size.width, size.height, param.nv12, padding);
+                    ASSERT_TRUE(Convert(src, actual, param.nv12, matrix, range, param.kernel));
+                    ExpectSamePlanes(expected, actual);
+                }
+            }
+        }
+    }
+}
+
+std::string KernelCaseName(const ::testing::TestParamInfo<KernelCase>& info) {
+    return std::string(GetConvertKernelName(info.param.kernel)) + (info.param.nv12 ? "_NV12" : "_I420");
+}
+
+INSTANTIATE_TEST_SUITE_P(Kernels, ColorConvertKernelTest,
+    ::testing::Values(KernelCase{ ConvertKernel::Scalar, true }, KernelCase{ ConvertKernel::Scalar, false },
+                      KernelCase{ ConvertKernel::SSE2, true }, KernelCase{ ConvertKernel::SSE2, false },
+                      KernelCase{ ConvertKernel::AVX2, true }, KernelCase{ ConvertKernel::AVX2, false }),
+    KernelCaseName);
+
+TEST(ColorConvertTest, UnalignedSourceRows) {
+    // Рядки джерела з адреси, не вирівняної на 16 байт (view з crop.x)
+    const int width = 70, height = 9;
+    TestFrame padded = MakeSource(width + 1, height, 0, 99);
+    TestFrame src(width, height);
+    for (int y = 0; y < height; y++) {
+        memcpy(src.Row(y), padded.Pixel(1, y), (size_t)width * 4);
+    }
+    const Planes expected = ReferenceConvert(src, true, ColorMatrix::BT709, ColorRange::Limited, 0);
+
+    for (ConvertKernel kernel : { ConvertKernel::Scalar, ConvertKernel::SSE2, ConvertKernel::AVX2 }) {
+        if (!IsConvertKernelSupported(kernel)) {
+            continue;
+        }
+        SCOPED_TRACE(GetConvertKernelName(kernel));
+        Planes actual(width, height, true, 0);
+        ASSERT_TRUE(ConvertBGRAToNV12(padded.Pixel(1, 0), padded.stride, width, height,
+                                      actual.y.data(), actual.y_stride, actual.u.data(), actual.c_stride,
+                                      ColorMatrix::BT709, ColorRange::Limited, kernel));
+        ExpectSamePlanes(expected, actual);
+    }
+}
+
+TEST(ColorConvertTest, StripedConverterMatchesSingleCall) {
+    // Смуги на пулі потоків (межі - парні рядки) дають той самий кадр
+    WorkerPool pool;
+    ASSERT_TRUE(pool.Initialize(4));
+    FrameConverter converter;
+    converter.SetWorkerPool(&pool);
+    converter.SetColorSpace(ColorMatrix::BT709, ColorRange::Full);
+
+    const TestFrame src = MakeSource(333, 257, 8, 7);
+    const Planes expected = ReferenceConvert(src, false, ColorMatrix::BT709, ColorRange::Full, 3);
+    Planes actual(src.width, src.height, false, 3);
+    ASSERT_TRUE(converter.ConvertToI420(src.pixels.data(), src.stride, src.width, src.height,
+                                        actual.y.data(), actual.y_stride, actual.u.data(), actual.c_stride,
+                                        actual.v.data(), actual.c_stride));
+    ExpectSamePlanes(expected, actual);
+}
+
+TEST(ColorConvertTest, RejectsInvalidArguments) {
+    uint8_t pixel[4] = {};
+    uint8_t plane[4] = {};
+    EXPECT_FALSE(ConvertBGRAToNV12(nullptr, 4, 1, 1, plane, 1, plane, 2));
+    EXPECT_FALSE(ConvertBGRAToNV12(pixel, 4, 0, 1, plane, 1, plane, 2));
+    EXPECT_FALSE(ConvertBGRAToI420(pixel, 4, 1, -1, plane, 1, plane, 1, plane, 1));
+}
+
+} // namespace
@@ -0,0 +1,83 @@
+/**
+ * Test Helpers
+ * Спільні генератори кадрів для тестів ядра
+ */
+
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Детермінований генератор (xorshift32) - однакові кадри на всіх платформах
+class TestRandom {
+public:
+    explicit TestRandom(uint32_t seed) : state_(seed ? seed : 1) {}
+
+    uint32_t Next() {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 17;
+        state_ ^= state_ << 5;
+        return state_;
+    }
+    int Range(int max) { return (int)(Next() % (uint32_t)max); }
+
+private:
+    uint32_t state_;
+};
+
+// BGRA кадр з pitch: рядки width * 4 + padding, padding заповнено fill
+struct TestFrame {
+    int width = 0;
+    int height = 0;
+    int stride = 0;
+    std::vector<uint8_t> pixels;
+
+    TestFrame() {}
+    TestFrame(int w, int h, int padding = 0, uint8_t fill = 0)
+        : width(w), height(h), stride(w * 4 + padding), pixels((size_t)stride * h, fill) {}
+
+    uint8_t* Row(int y) { return pixels.data() + (size_t)y * stride; }
+    const uint8_t* Row(int y) const { return pixels.data() + (size_t)y * stride; }
+    uint8_t* Pixel(int x, int y) { return Row(y) + (size_t)x * 4; }
+    const uint8_t* Pixel(int x, int y) const { return Row(y) + (size_t)x * 4; }
+
+    // Випадкові пікселі з альфою 0xFF (padding не змінюється)
+    void FillRandom(uint32_t seed) {
+        TestRandom random(seed);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                uint32_t value = random.Next();
+                uint8_t* p = Pixel(x, y);
+                p[0] = (uint8_t)value;
+                p[1] = (uint8_t)(value >> 8);
+                p[2] = (uint8_t)(value >> 16);
+                p[3] = 0xFF;
+            }
+        }
+    }
+
+    void FillRect(int x0, int y0, int w, int h, uint32_t bgra) {
+        for (int y = y0; y < y0 + h; y++) {
+            for (int x = x0; x < x0 + w; x++) {
+                memcpy(Pixel(x, y), &bgra, 4);
+            }
+        }
+    }
+};
+
+// Пікселі двох кадрів однакового розміру збігаються (padding не порівнюється)
+inline bool SamePixels(const TestFrame& a, const TestFrame& b) {
+    if (a.width != b.width || a.height != b.height) {
+        return false;
+    }
+    for (int y = 0; y < a.height; y++) {
+        if (memcmp(a.Row(y), b.Row(y), (size_t)a.width * 4) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif // TEST_COMMON_H
@@ -0,0 +1,70 @@
+/**
+ * Cursor Tests
+ * Масштаб форми курсора під кадр, менший або більший за джерело
+ */
+
+#include <gtest/gtest.h>
+#include "cursor.h"
+
+namespace {
+
+// Форма w x h: колір пікселя кодує його координати
+CursorShape MakeShape(int width, int height, int hot_x, int hot_y) {
+    CursorShape shape;
+    shape.id = 42;
+    shape.width = width;
+    shape.height = height;
+    shape.hot_x = hot_x;
+    shape.hot_y = hot_y;
+    shape.bgra.resize((size_t)width * height * 4);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint8_t* p = &shape.bgra[((size_t)y * width + x) * 4];
+            p[0] = (uint8_t)x;
+            p[1] = (uint8_t)y;
+            p[2] = 0;
+            p[3] = 0xFF;
+        }
+    }
+    return shape;
+}
+
+TEST(CursorTest, ScaleHalvesShapeAndHotspot) {
+    const CursorShape shape = MakeShape(32, 32, 10, 6);
+    CursorShape scaled;
+    ScaleCursorShape(shape, 0.5, 0.5, scaled);
+    EXPECT_EQ(scaled.id, shape.id);
+    EXPECT_EQ(scaled.width, 16);
+    EXPECT_EQ(scaled.height, 16);
+    EXPECT_EQ(scaled.hot_x, 5);
+    EXPECT_EQ(scaled.hot_y, 3);
+    ASSERT_EQ(scaled.bgra.size(), 16u * 16 * 4);
+    // Найближчий піксель: вихідний (x, y) бере джерело (2x + 1, 2y + 1)
+    for (int y = 0; y < scaled.height; y++) {
+        for (int x = 0; x < scaled.width; x++) {
+            const uint8_t* p = &scaled.bgra[((size_t)y * scaled.width + x) * 4];
+            ASSERT_EQ(p[0], 2 * x + 1);
+            ASSERT_EQ(p[1], 2 * y + 1);
+        }
+    }
+}
+
+TEST(CursorTest, ScaleKeepsHotspotInsideTinyShape) {
+    const CursorShape shape = MakeShape(3, 2, 2, 1);
+    CursorShape scaled;
+    ScaleCursorShape(shape, 0.1, 0.25, scaled);
+    EXPECT_EQ(scaled.width, 1);
+    EXPECT_EQ(scaled.height, 1);
+    EXPECT_EQ(scaled.hot_x, 0);
+    EXPECT_EQ(scaled.hot_y, 0);
+
+    ScaleCursorShape(shape, 2.0, 1.5, scaled);
+    EXPECT_EQ(scaled.width, 6);
+    EXPECT_EQ(scaled.height, 3);
+    EXPECT_EQ(scaled.hot_x, 4);
+    EXPECT_EQ(scaled.hot_y, 2);
+    EXPECT_EQ(scaled.bgra[((size_t)2 * 6 + 5) * 4], 2);     // Правий нижній - з правого нижнього
+    EXPECT_EQ(scaled.bgra[((size_t)2 * 6 + 5) * 4 + 1], 1);
+}
+
+} // namespace
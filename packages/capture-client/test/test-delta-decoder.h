@@ -0,0 +1,163 @@
+/**
+ * Test Delta Decoder
+ * Отримувач пакетів DLT1 для тестів - той самий порядок дій, що й
+ * backend-server/src/delta-decoder.ts (переміщення -> плитки, кеш плиток за слотами)
+ */
+
+#ifndef TEST_DELTA_DECODER_H
+#define TEST_DELTA_DECODER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "delta-encoder.h"
+#include "test-common.h"
+
+class TestDeltaDecoder {
+public:
+    // false - пакет відхилено (невалідний, обрізаний, невідомий слот або ще не було keyframe);
+    // error пояснює причину, кадр лишається попереднім
+    bool Apply(const uint8_t* packet, size_t size) {
+        error_.clear();
+        if (size < DeltaEncoder::kHeaderSize || ReadU32(packet) != DeltaEncoder::kMagic) {
+            return Fail("bad header");
+        }
+        const int width = ReadU16(packet + 4);
+        const int height = ReadU16(packet + 6);
+        const int tile_size = ReadU16(packet + 8);
+        const uint8_t flags = packet[10];
+        const bool keyframe = (flags & DeltaEncoder::kFlagKeyframe) != 0;
+        const uint32_t changed = ReadU32(packet + 12);
+        if (tile_size == 0) {
+            return Fail("bad tile size");
+        }
+
+        if (keyframe && (frame_.width != width || frame_.height != height)) {
+            frame_ = TestFrame(width, height);
+        }
+        if (frame_.width == 0 || frame_.width != width || frame_.height != height) {
+            return Fail("waiting for keyframe");
+        }
+
+        // Зміни застосовуються до копії - відхилений пакет не псує кадр
+        TestFrame next = frame_;
+        std::vector<std::vector<uint8_t>> cache = keyframe ? std::vector<std::vector<uint8_t>>() : cache_;
+
+        size_t offset = DeltaEncoder::kHeaderSize;
+        if (flags & DeltaEncoder::kFlagMoves) {
+            if (offset + 4 > size) {
+                return Fail("truncated moves");
+            }
+            const int moves = ReadU16(packet + offset);
+            offset += 4;
+            if (offset + (size_t)moves * DeltaEncoder::kMoveSize > size ||
+                !ApplyMoves(next, packet + offset, moves)) {
+                return Fail("bad moves");
+            }
+            offset += (size_t)moves * DeltaEncoder::kMoveSize;
+        }
+
+        const int tiles_x = (width + tile_size - 1) / tile_size;
+        const int tiles_y = (height + tile_size - 1) / tile_size;
+        const int tile_count = tiles_x * tiles_y;
+        const uint8_t* bitmap = packet + offset;
+        offset += (size_t)(tile_count + 7) / 8;
+        const bool cached = (flags & DeltaEncoder::kFlagTileCache) != 0;
+        size_t reference = offset;
+        if (cached) {
+            offset += (size_t)changed * 2;
+        }
+        if (offset > size) {
+            return Fail("truncated index");
+        }
+
+        for (int i = 0; i < tile_count; i++) {
+            if ((bitmap[i >> 3] & (1 << (i & 7))) == 0) {
+                continue;
+            }
+            const int x = (i % tiles_x) * tile_size;
+            const int y = (i / tiles_x) * tile_size;
+            const size_t row_bytes = (size_t)std::min(tile_size, width - x) * 4;
+            const int rows = std::min(tile_size, height - y);
+            const size_t tile_bytes = row_bytes * rows;
+
+            const uint8_t* source = nullptr;
+            if (cached) {
+                if (reference + 2 > size) {
+                    return Fail("truncated references");
+                }
+                const uint16_t value = ReadU16(packet + reference);
+                reference += 2;
+                const uint16_t slot = value & ~DeltaEncoder::kCacheHit;
+                if (value & DeltaEncoder::kCacheHit) {
+                    if (slot >= cache.size() || cache[slot].size() != tile_bytes) {
+                        return Fail("unknown cache slot " + std::to_string(slot));
+                    }
+                    source = cache[slot].data();
+                } else {
+                    if (offset + tile_bytes > size) {
+                        return Fail("truncated tile");
+                    }
+                    if (slot >= cache.size()) {
+                        cache.resize((size_t)slot + 1);
+                    }
+                    cache[slot].assign(packet + offset, packet + offset + tile_bytes);
+                }
+            }
+            if (!source) {
+                if (offset + tile_bytes > size) {
+                    return Fail("truncated tile");
+                }
+                source = packet + offset;
+                offset += tile_bytes;
+            }
+            for (int row = 0; row < rows; row++) {
+                memcpy(next.Pixel(x, y + row), source + row * row_bytes, row_bytes);
+            }
+        }
+
+        frame_ = next;
+        cache_.swap(cache);
+        return true;
+    }
+
+    const TestFrame& GetFrame() const { return frame_; }
+    const std::string& GetError() const { return error_; }
+
+private:
+    static uint16_t ReadU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+    static uint32_t ReadU32(const uint8_t* p) {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+
+    // Джерела всіх переміщень читаються з кадру до будь-якого з них
+    static bool ApplyMoves(TestFrame& frame, const uint8_t* moves, int count) {
+        const TestFrame before = frame;
+        for (int i = 0; i < count; i++) {
+            const uint8_t* m = moves + (size_t)i * DeltaEncoder::kMoveSize;
+            const int src_x = ReadU16(m), src_y = ReadU16(m + 2);
+            const int w = ReadU16(m + 4), h = ReadU16(m + 6);
+            const int dst_x = ReadU16(m + 8), dst_y = ReadU16(m + 10);
+            if (std::max(src_x, dst_x) + w > frame.width || std::max(src_y, dst_y) + h > frame.height) {
+                return false;
+            }
+            for (int row = 0; row < h; row++) {
+                memcpy(frame.Pixel(dst_x, dst_y + row), before.Pixel(src_x, src_y + row), (size_t)w * 4);
+            }
+        }
+        return true;
+    }
+
+    bool Fail(const std::string& error) {
+        error_ = error;
+        return false;
+    }
+
+    TestFrame frame_;
+    std::vector<std::vector<uint8_t>> cache_;
+    std::string error_;
+};
+
+#endif // TEST_DELTA_DECODER_H
@@ -0,0 +1,228 @@
+/**
+ * Delta Encoder Tests
+ * TileDiff і DeltaEncoder на синтетичних кадрах: кодування -> декодування дає
+ * той самий кадр (інтервал keyframe, обрізані крайні плитки, pitch != width * 4)
+ */
+
+#include <gtest/gtest.h>
+#include "delta-encoder.h"
+#include "synthetic-capture.h"
+#include "test-common.h"
+#include "test-delta-decoder.h"
+#include "tile-diff.h"
+
+namespace {
+
+// Кодер з вихідним буфером; Encode повертає пакет (порожній - без змін)
+class DeltaStream {
+public:
+    bool Initialize(int width, int height, int tile_size, int keyframe_interval) {
+        if (!encoder_.Initialize(width, height, tile_size, keyframe_interval)) {
+            return false;
+        }
+        buffer_.resize(encoder_.GetMaxPacketSize());
+        return true;
+    }
+
+    std::vector<uint8_t> Encode(const TestFrame& frame) {
+        size_t size = 0;
+        EXPECT_TRUE(encoder_.Encode(frame.pixels.data(), frame.stride, buffer_.data(), buffer_.size(), size))
+            << encoder_.GetLastError();
+        return std::vector<uint8_t>(buffer_.begin(), buffer_.begin() + size);
+    }
+
+    DeltaEncoder& Get() { return encoder_; }
+
+private:
+    DeltaEncoder encoder_;
+    std::vector<uint8_t> buffer_;
+};
+
+// Кадр, що змінюється кілька плиток за раз: прямокутники випадкових кольорів
+void Mutate(TestFrame& frame, TestRandom& random, int rects) {
+    for (int i = 0; i < rects; i++) {
+        const int w = 1 + random.Range(std::min(frame.width, 40));
+        const int h = 1 + random.Range(std::min(frame.height, 40));
+        frame.FillRect(random.Range(frame.width - w + 1), random.Range(frame.height - h + 1), w, h,
+                       random.Next() | 0xFF000000);
+    }
+}
+
+TEST(TileDiffTest, MarksOnlyChangedTilesIncludingEdges) {
+    // 130x70 плитками 64: праві плитки 2 пікселі завширшки, нижні - 6 рядків
+    TileDiff diff;
+    ASSERT_TRUE(diff.Initialize(130, 70, 64));
+    EXPECT_EQ(diff.GetTilesX(), 3);
+    EXPECT_EQ(diff.GetTilesY(), 2);
+
+    int x, y, w, h;
+    diff.GetTileRect(5, x, y, w, h);
+    EXPECT_EQ(x, 128);
+    EXPECT_EQ(y, 64);
+    EXPECT_EQ(w, 2);
+    EXPECT_EQ(h, 6);
+
+    TestFrame frame(130, 70, 24);
+    frame.FillRandom(3);
+    std::vector<uint8_t> dirty;
+    EXPECT_EQ(diff.Compare(frame.pixels.data(), frame.stride, dirty), 6);
+    EXPECT_EQ(diff.Compare(frame.pixels.data(), frame.stride, dirty), 0);
+
+    // Останній піксель кадру - лише крайня нижня права плитка
+    frame.Pixel(129, 69)[1] ^= 0x01;
+    EXPECT_EQ(diff.Compare(frame.pixels.data(), frame.stride, dirty), 1);
+    EXPECT_TRUE(dirty[5]);
+
+    // Padding рядків не є частиною кадру
+    for (int row = 0; row < frame.height; row++) {
+        memset(frame.Row(row) + frame.width * 4, row, 24);
+    }
+    EXPECT_EQ(diff.Compare(frame.pixels.data(), frame.stride, dirty), 0);
+
+    diff.Reset();
+    EXPECT_EQ(diff.Compare(frame.pixels.data(), frame.stride, dirty), 6);
+}
+
+TEST(TileDiffTest, RejectsInvalidTileSize) {
+    TileDiff diff;
+    EXPECT_FALSE(diff.Initialize(64, 64, TileDiff::kMinTileSize - 1));
+    EXPECT_FALSE(diff.Initialize(64, 64, TileDiff::kMaxTileSize * 2));
+    EXPECT_FALSE(diff.Initialize(0, 64, 64));
+}
+
+struct RoundTripCase {
+    int width;
+    int height;
+    int tile_size;
+    int padding;    // Байти після рядка: pitch = width * 4 + padding
+};
+
+void PrintTo(const RoundTripCase& param, std::ostream* os) {
+    *os << param.width << "x" << param.height << " tile " << param.tile_size << " padding " << param.padding;
+}
+
+class DeltaRoundTripTest : public ::testing::TestWithParam<RoundTripCase> {};
+
+TEST_P(DeltaRoundTripTest, DecodesToSourceFrame) {
+    const RoundTripCase param = GetParam();
+    const int kKeyframeInterval = 7;
+    DeltaStream stream;
+    ASSERT_TRUE(stream.Initialize(param.width, param.height, param.tile_size, kKeyframeInterval));
+
+    TestFrame frame(param.width, param.height, param.padding, 0xCD);
+    frame.FillRandom(11);
+    TestRandom random(5);
+    TestDeltaDecoder decoder;
+
+    for (int i = 0; i < 40; i++) {
+        SCOPED_TRACE(i);
+        if (i > 0) {
+            Mutate(frame, random, 1 + random.Range(4));
+        }
+        const std::vector<uint8_t> packet = stream.Encode(frame);
+        const bool keyframe = i % kKeyframeInterval == 0;
+        EXPECT_EQ(stream.Get().IsLastKeyframe(), keyframe);
+        ASSERT_FALSE(packet.empty());
+        EXPECT_EQ((packet[10] & DeltaEncoder::kFlagKeyframe) != 0, keyframe);
+        if (keyframe) {
+            EXPECT_EQ(stream.Get().GetLastTileCount(), stream.Get().GetTileCount());
+        }
+        ASSERT_TRUE(decoder.Apply(packet.data(), packet.size())) << decoder.GetError();
+        ASSERT_TRUE(SamePixels(decoder.GetFrame(), frame));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Frames, DeltaRoundTripTest, ::testing::Values(
+    RoundTripCase{ 256, 128, 64, 0 },
+    RoundTripCase{ 130, 70, 64, 0 },        // Обрізані крайні плитки
+    RoundTripCase{ 130, 70, 64, 28 },       // pitch != width * 4
+    RoundTripCase{ 97, 33, 16, 4 },
+    RoundTripCase{ 300, 17, 256, 64 },      // Одна смуга плиток, нижчих за tile_size
+    RoundTripCase{ 1, 1, 16, 12 }));
+
+TEST(DeltaEncoderTest, UnchangedFrameProducesNoPacket) {
+    DeltaStream stream;
+    ASSERT_TRUE(stream.Initialize(128, 64, 32, 0));
+    TestFrame frame(128, 64);
+    frame.FillRandom(2);
+    EXPECT_FALSE(stream.Encode(frame).empty());
+    EXPECT_TRUE(stream.Encode(frame).empty());
+    EXPECT_EQ(stream.Get().GetLastTileCount(), 0);
+
+    // Інтервал 0 - keyframe лише перший і за запитом
+    frame.Pixel(0, 0)[0] ^= 0xFF;
+    std::vector<uint8_t> packet = stream.Encode(frame);
+    ASSERT_FALSE(packet.empty());
+    EXPECT_FALSE(stream.Get().IsLastKeyframe());
+    EXPECT_EQ(stream.Get().GetLastTileCount(), 1);
+
+    stream.Get().ForceKeyframe();
+    packet = stream.Encode(frame);
+    ASSERT_FALSE(packet.empty());
+    EXPECT_TRUE(stream.Get().IsLastKeyframe());
+    EXPECT_EQ(stream.Get().GetLastTileCount(), stream.Get().GetTileCount());
+}
+
+TEST(DeltaEncoderTest, LateReceiverWaitsForKeyframe) {
+    DeltaStream stream;
+    ASSERT_TRUE(stream.Initialize(192, 96, 64, 4));
+    TestFrame frame(192, 96);
+    frame.FillRandom(8);
+    TestRandom random(9);
+    TestDeltaDecoder late;
+
+    for (int i = 0; i < 9; i++) {
+        Mutate(frame, random, 2);
+        const std::vector<uint8_t> packet = stream.Encode(frame);
+        ASSERT_FALSE(packet.empty());
+        if (i < 4) {
+            continue;   // Підключився після перших кадрів
+        }
+        // Кадр 4 - keyframe за інтервалом, з нього отримувач уже синхронний
+        ASSERT_TRUE(late.Apply(packet.data(), packet.size())) << late.GetError();
+        ASSERT_TRUE(SamePixels(late.GetFrame(), frame));
+    }
+
+    TestDeltaDecoder fresh;
+    frame.Pixel(1, 1)[2] ^= 0x80;
+    const std::vector<uint8_t> delta = stream.Encode(frame);
+    ASSERT_FALSE(delta.empty());
+    EXPECT_FALSE(fresh.Apply(delta.data(), delta.size()));
+}
+
+TEST(DeltaEncoderTest, SyntheticMixedSequence) {
+    SyntheticCapture source(SyntheticScenario::Mixed, 0, 4);
+    ASSERT_TRUE(source.Initialize(640, 360));
+    DeltaStream stream;
+    ASSERT_TRUE(stream.Initialize(640, 360, 64, 10));
+    TestFrame frame(640, 360, 64);
+    TestDeltaDecoder decoder;
+
+    int packets = 0;
+    for (int i = 0; i < 30; i++) {
+        if (!source.CaptureFrame(frame.pixels.data(), frame.stride)) {
+            continue;
+        }
+        const std::vector<uint8_t> packet = stream.Encode(frame);
+        if (packet.empty()) {
+            continue;
+        }
+        packets++;
+        ASSERT_TRUE(decoder.Apply(packet.data(), packet.size())) << decoder.GetError();
+        ASSERT_TRUE(SamePixels(decoder.GetFrame(), frame)) << "frame " << i;
+    }
+    EXPECT_GT(packets, 10);
+}
+
+TEST(DeltaEncoderTest, RejectsSmallOutputAndHugeFrames) {
+    DeltaEncoder encoder;
+    EXPECT_FALSE(encoder.Initialize(0x10000, 16));
+    ASSERT_TRUE(encoder.Initialize(64, 64, 64, 0));
+    TestFrame frame(64, 64);
+    std::vector<uint8_t> out(encoder.GetMaxPacketSize() - 1);
+    size_t size = 0;
+    EXPECT_FALSE(encoder.Encode(frame.pixels.data(), frame.stride, out.data(), out.size(), size));
+    EXPECT_EQ(size, 0u);
+}
+
+} // namespace
@@ -0,0 +1,330 @@
+/**
+ * Frame Pipeline Tests
+ * Синтетичне джерело -> стадії convert/encode на окремих потоках з імітацією
+ * H.264 енкодера і дельта-кодером; запити keyframe з іншого потоку
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include "color-convert.h"
+#include "delta-encoder.h"
+#include "frame-pipeline.h"
+#include "synthetic-capture.h"
+#include "test-common.h"
+#include "test-delta-decoder.h"
+#include "video-encoder.h"
+
+namespace {
+
+constexpr int kWidth = 320;
+constexpr int kHeight = 240;
+
+uint64_t HashBytes(const uint8_t* data, size_t size) {
+    uint64_t hash = 1469598103934665603ULL;     // FNV-1a
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Імітація H.264 енкодера: пакет - номер кадру, ознака IDR і хеш NV12 входу;
+// IDR за інтервалом або за ForceKeyframe, як x264/MF
+class MockVideoEncoder : public VideoEncoder {
+public:
+    static constexpr size_t kPacketSize = 16;
+
+    bool Initialize(const VideoEncoderConfig& config) override {
+        width_ = config.width;
+        height_ = config.height;
+        keyframe_interval_ = config.keyframe_interval;
+        frames_ = 0;
+        return true;
+    }
+
+    bool EncodeNV12(const uint8_t* nv12, uint8_t* out, size_t capacity, size_t& out_size) override {
+        out_size = 0;
+        if (capacity < kPacketSize) {
+            SetError("Output buffer too small");
+            return false;
+        }
+        last_keyframe_ = ConsumeKeyframeRequest() || frames_ % keyframe_interval_ == 0;
+        const uint32_t index = (uint32_t)frames_++;
+        const uint64_t hash = HashBytes(nv12, GetNV12Size());
+        memcpy(out, &index, 4);
+        out[4] = last_keyframe_ ? 1 : 0;
+        memset(out + 5, 0, 3);
+        memcpy(out + 8, &hash, 8);
+        out_size = kPacketSize;
+        return true;
+    }
+
+    void Cleanup() override { width_ = 0; }
+    const char* GetName() const override { return "mock"; }
+
+private:
+    int keyframe_interval_ = 1;
+    uint64_t frames_ = 0;
+};
+
+// Вихідні буфери слотів: стадія encode і sink працюють на одному потоці
+class PacketBuffers {
+public:
+    uint8_t* Get(PipelineFrame& frame, size_t size) {
+        std::vector<uint8_t>& buffer = buffers_[&frame];
+        buffer.resize(size);
+        return buffer.data();
+    }
+
+private:
+    std::map<PipelineFrame*, std::vector<uint8_t>> buffers_;
+};
+
+struct DeliveredPacket {
+    uint64_t sequence = 0;
+    bool keyframe = false;
+    std::vector<uint8_t> data;
+};
+
+// Зібрані sink пакети (потік останньої стадії) для перевірки в тесті
+class PacketSink {
+public:
+    void Add(const PipelineFrame& frame) {
+        DeliveredPacket packet;
+        packet.sequence = frame.output.sequence;
+        packet.keyframe = frame.output.keyframe;
+        packet.data.assign(frame.output.data, frame.output.data + frame.output.size);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (packet.keyframe) {
+            keyframes_++;
+        }
+        packets_.push_back(std::move(packet));
+    }
+
+    int GetKeyframeCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return keyframes_;
+    }
+
+    std::vector<DeliveredPacket> Take() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return std::move(packets_);
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<DeliveredPacket> packets_;
+    int keyframes_ = 0;
+};
+
+// Джерело (потік тесту) подає кадри, поки всі не пройдуть стадії
+class PipelineDriver {
+public:
+    PipelineDriver(FramePipeline& pipeline, SyntheticCapture& source)
+        : pipeline_(pipeline), source_(source) {}
+
+    // Захопити кадр у вільний слот; копія кадру - для перевірки декодування
+    bool SubmitFrame(TestFrame* copy) {
+        PipelineFrame* slot = nullptr;
+        while (!(slot = pipeline_.AcquireSlot())) {
+            std::this_thread::yield();
+        }
+        if (!source_.CaptureFrame(slot->capture.data(), kWidth * 4)) {
+            pipeline_.Cancel(slot);
+            return false;
+        }
+        if (copy) {
+            *copy = TestFrame(kWidth, kHeight);
+            memcpy(copy->pixels.data(), slot->capture.data(), copy->pixels.size());
+        }
+        slot->output.sequence = ++sequence_;
+        pipeline_.Submit(slot);
+        return true;
+    }
+
+    // Кожен поданий кадр або дійшов до sink, або відкинутий стадією
+    bool WaitForIdle() {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+        while (std::chrono::steady_clock::now() < deadline) {
+            PipelineStats stats = pipeline_.GetStats();
+            uint64_t dropped = 0;
+            for (const PipelineStageStats& stage : stats.stages) {
+                dropped += stage.dropped;
+            }
+            if (stats.completed + dropped == stats.submitted) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    uint64_t GetSequence() const { return sequence_; }
+
+private:
+    FramePipeline& pipeline_;
+    SyntheticCapture& source_;
+    uint64_t sequence_ = 0;
+};
+
+TEST(FramePipelineTest, SyntheticSourceThroughMockVideoEncoder) {
+    SyntheticCapture source(SyntheticScenario::Video, 0, 3);
+    ASSERT_TRUE(source.Initialize(kWidth, kHeight));
+    MockVideoEncoder encoder;
+    VideoEncoderConfig config;
+    config.width = kWidth;
+    config.height = kHeight;
+    config.keyframe_interval = 10;
+    ASSERT_TRUE(encoder.Initialize(config));
+
+    PacketBuffers buffers;
+    PacketSink sink;
+    std::vector<FramePipeline::Stage> stages;
+    stages.push_back({ "convert", [&encoder](PipelineFrame& frame) {
+        return encoder.ConvertToNV12(frame.capture.data(), kWidth * 4, frame.scratch.data());
+    } });
+    stages.push_back({ "encode", [&encoder, &buffers](PipelineFrame& frame) {
+        uint8_t* out = buffers.Get(frame, MockVideoEncoder::kPacketSize);
+        size_t size = 0;
+        if (!encoder.EncodeNV12(frame.scratch.data(), out, MockVideoEncoder::kPacketSize, size)) {
+            return false;
+        }
+        frame.output.data = out;
+        frame.output.size = size;
+        frame.output.keyframe = encoder.IsLastKeyframe();
+        return true;
+    } });
+
+    FramePipeline pipeline;
+    ASSERT_TRUE(pipeline.Start(3, (size_t)kWidth * kHeight * 4, encoder.GetNV12Size(), stages,
+                               [&sink](PipelineFrame& frame) { sink.Add(frame); }));
+
+    // Очікуваний хеш - та сама конвертація на потоці тесту
+    PipelineDriver driver(pipeline, source);
+    std::map<uint64_t, uint64_t> expected;
+    std::vector<uint8_t> nv12(encoder.GetNV12Size());
+    const int kFrames = 45;
+    for (int i = 0; i < kFrames; i++) {
+        TestFrame frame;
+        ASSERT_TRUE(driver.SubmitFrame(&frame));
+        ASSERT_TRUE(ConvertBGRAToNV12(frame.pixels.data(), frame.stride, kWidth, kHeight,
+                                      nv12.data(), kWidth, nv12.data() + kWidth * kHeight, kWidth));
+        expected[driver.GetSequence()] = HashBytes(nv12.data(), nv12.size());
+    }
+    ASSERT_TRUE(driver.WaitForIdle());
+    pipeline.Stop();
+
+    // Порядок кадрів зберігається, жоден не загублено і не перекодовано
+    const std::vector<DeliveredPacket> packets = sink.Take();
+    ASSERT_EQ(packets.size(), (size_t)kFrames);
+    for (size_t i = 0; i < packets.size(); i++) {
+        const DeliveredPacket& packet = packets[i];
+        EXPECT_EQ(packet.sequence, i + 1);
+        uint32_t index;
+        uint64_t hash;
+        memcpy(&index, packet.data.data(), 4);
+        memcpy(&hash, packet.data.data() + 8, 8);
+        EXPECT_EQ(index, i);
+        EXPECT_EQ(packet.keyframe, i % 10 == 0);
+        EXPECT_EQ(hash, expected[packet.sequence]) << "frame " << i;
+    }
+}
+
+TEST(FramePipelineTest, VideoEncoderHonorsForceKeyframe) {
+    MockVideoEncoder encoder;
+    VideoEncoderConfig config;
+    config.width = 64;
+    config.height = 32;
+    config.keyframe_interval = 100;
+    ASSERT_TRUE(encoder.Initialize(config));
+    std::vector<uint8_t> nv12(encoder.GetNV12Size());
+    uint8_t out[MockVideoEncoder::kPacketSize];
+    size_t size = 0;
+
+    ASSERT_TRUE(encoder.EncodeNV12(nv12.data(), out, sizeof(out), size));
+    EXPECT_TRUE(encoder.IsLastKeyframe());
+    ASSERT_TRUE(encoder.EncodeNV12(nv12.data(), out, sizeof(out), size));
+    EXPECT_FALSE(encoder.IsLastKeyframe());
+
+    // Кілька запитів до наступного кадру - один IDR
+    encoder.ForceKeyframe();
+    encoder.ForceKeyframe();
+    ASSERT_TRUE(encoder.EncodeNV12(nv12.data(), out, sizeof(out), size));
+    EXPECT_TRUE(encoder.IsLastKeyframe());
+    ASSERT_TRUE(encoder.EncodeNV12(nv12.data(), out, sizeof(out), size));
+    EXPECT_FALSE(encoder.IsLastKeyframe());
+}
+
+TEST(FramePipelineTest, KeyframeRequestsDuringEncodeAreNotLost) {
+    SyntheticCapture source(SyntheticScenario::Video, 0, 5);
+    ASSERT_TRUE(source.Initialize(kWidth, kHeight));
+    DeltaEncoder encoder;
+    ASSERT_TRUE(encoder.Initialize(kWidth, kHeight, 32, 0));
+
+    PacketBuffers buffers;
+    PacketSink sink;
+    const size_t capacity = encoder.GetMaxPacketSize();
+    std::vector<FramePipeline::Stage> stages;
+    stages.push_back({ "encode", [&encoder, &buffers, capacity](PipelineFrame& frame) {
+        uint8_t* out = buffers.Get(frame, capacity);
+        size_t size = 0;
+        if (!encoder.Encode(frame.capture.data(), kWidth * 4, out, capacity, size) || size == 0) {
+            return false;
+        }
+        frame.output.data = out;
+        frame.output.size = size;
+        frame.output.keyframe = encoder.IsLastKeyframe();
+        return true;
+    } });
+
+    FramePipeline pipeline;
+    ASSERT_TRUE(pipeline.Start(3, (size_t)kWidth * kHeight * 4, 0, stages,
+                               [&sink](PipelineFrame& frame) { sink.Add(frame); }));
+
+    // Запити як requestKeyframe з JS потоку. Інтервал 0 - keyframe дає лише запит
+    // (і перший кадр), тож кожен запит має додати рівно один keyframe
+    PipelineDriver driver(pipeline, source);
+    std::atomic<bool> done{false};
+    std::atomic<int> honored{0};
+    const int kRequests = 20;
+    std::thread requester([&]() {
+        while (!done && sink.GetKeyframeCount() == 0) {
+            std::this_thread::yield();
+        }
+        for (int i = 0; i < kRequests && !done; i++) {
+            const int before = sink.GetKeyframeCount();
+            encoder.ForceKeyframe();
+            while (!done && sink.GetKeyframeCount() == before) {
+                std::this_thread::yield();
+            }
+            if (sink.GetKeyframeCount() == before + 1) {
+                honored++;
+            }
+        }
+    });
+
+    std::map<uint64_t, TestFrame> frames;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    while (honored < kRequests && std::chrono::steady_clock::now() < deadline) {
+        TestFrame frame;
+        ASSERT_TRUE(driver.SubmitFrame(&frame));
+        frames[driver.GetSequence()] = frame;
+    }
+    done = true;
+    requester.join();
+    ASSERT_TRUE(driver.WaitForIdle());
+    pipeline.Stop();
+    EXPECT_EQ(honored.load(), kRequests);
+
+    // Потік пакетів, з якого вийшли keyframe за запитами, декодується без розбіжностей
+    TestDeltaDecoder decoder;
+    for (const DeliveredPacket& packet : sink.Take()) {
+        ASSERT_TRUE(decoder.Apply(packet.data.data(), packet.data.size())) << decoder.GetError();
+        ASSERT_TRUE(SamePixels(decoder.GetFrame(), frames[packet.sequence])) << "frame " << packet.sequence;
+    }
+}
+
+} // namespace
@@ -0,0 +1,105 @@
+/**
+ * GOP Cache Tests
+ * Група кадрів для нових глядачів: починається з keyframe (+ SPS/PPS), переповнена
+ * група не обслуговується, знятий список живе після початку нової групи
+ */
+
+#include <gtest/gtest.h>
+#include "gop-cache.h"
+
+namespace {
+
+GopFrameInfo MakeInfo(bool keyframe) {
+    GopFrameInfo info;
+    info.keyframe = keyframe;
+    return info;
+}
+
+std::vector<uint8_t> MakePacket(uint8_t value, size_t size = 64) {
+    return std::vector<uint8_t>(size, value);
+}
+
+TEST(GopCacheTest, WaitsForKeyframe) {
+    GopCache cache(1 << 20, 10);
+    const std::vector<uint8_t> packet = MakePacket(1);
+    cache.Add(packet.data(), packet.size(), MakeInfo(false));
+    EXPECT_FALSE(cache.GetStats().complete);
+    EXPECT_TRUE(cache.GetSnapshot().empty());
+
+    cache.Add(packet.data(), packet.size(), MakeInfo(true));
+    cache.Add(packet.data(), packet.size(), MakeInfo(false));
+    const GopCache::Snapshot snapshot = cache.GetSnapshot();
+    ASSERT_EQ(snapshot.size(), 2u);
+    EXPECT_TRUE(snapshot[0]->keyframe);
+    EXPECT_FALSE(snapshot[1]->keyframe);
+    EXPECT_EQ(cache.GetStats().gops, 1u);
+}
+
+TEST(GopCacheTest, ParameterSetsPrecedeKeyframe) {
+    GopCache cache(1 << 20, 10);
+    const std::vector<uint8_t> sps_pps = { 0, 0, 0, 1, 0x67, 0, 0, 0, 1, 0x68 };
+    const std::vector<uint8_t> idr = MakePacket(0x65);
+    cache.Add(idr.data(), idr.size(), MakeInfo(true), &sps_pps);
+
+    const GopCache::Snapshot snapshot = cache.GetSnapshot();
+    ASSERT_EQ(snapshot.size(), 2u);
+    EXPECT_TRUE(snapshot[0]->parameter_sets);
+    EXPECT_EQ(snapshot[0]->data.size(), sps_pps.size());
+    EXPECT_TRUE(snapshot[1]->keyframe);
+    EXPECT_EQ(cache.GetStats().bytes, sps_pps.size() + idr.size());
+}
+
+TEST(GopCacheTest, OverflowEmptiesCacheUntilNextKeyframe) {
+    GopCache cache(256, 3);
+    const std::vector<uint8_t> packet = MakePacket(2, 100);
+    cache.Add(packet.data(), packet.size(), MakeInfo(true));
+    cache.Add(packet.data(), packet.size(), MakeInfo(false));
+    cache.Add(packet.data(), packet.size(), MakeInfo(false));    // 300 байт > 256
+
+    GopCacheStats stats = cache.GetStats();
+    EXPECT_FALSE(stats.complete);
+    EXPECT_EQ(stats.frames, 0u);
+    EXPECT_EQ(stats.overflows, 1u);
+
+    // Решта групи відкидається, навіть якщо вміщалася б
+    const std::vector<uint8_t> small = MakePacket(3, 8);
+    cache.Add(small.data(), small.size(), MakeInfo(false));
+    EXPECT_TRUE(cache.GetSnapshot().empty());
+
+    cache.Add(small.data(), small.size(), MakeInfo(true));
+    stats = cache.GetStats();
+    EXPECT_TRUE(stats.complete);
+    EXPECT_EQ(stats.frames, 1u);
+    EXPECT_EQ(stats.gops, 2u);
+}
+
+TEST(GopCacheTest, SnapshotOutlivesNewGroup) {
+    GopCache cache(1 << 20, 10);
+    const std::vector<uint8_t> first = MakePacket(4);
+    cache.Add(first.data(), first.size(), MakeInfo(true));
+    const GopCache::Snapshot snapshot = cache.GetSnapshot();
+
+    const std::vector<uint8_t> second = MakePacket(5);
+    cache.Add(second.data(), second.size(), MakeInfo(true));
+    ASSERT_EQ(snapshot.size(), 1u);
+    EXPECT_EQ(snapshot[0]->data.data()[0], 4);
+    EXPECT_EQ(cache.GetSnapshot()[0]->data.data()[0], 5);
+    EXPECT_EQ(cache.GetStats().replays, 2u);
+}
+
+TEST(GopCacheTest, ClearAndEmptyInput) {
+    GopCache cache(1 << 20, 10);
+    const std::vector<uint8_t> packet = MakePacket(6);
+    cache.Add(packet.data(), 0, MakeInfo(true));
+    cache.Add(nullptr, packet.size(), MakeInfo(true));
+    EXPECT_FALSE(cache.GetStats().complete);
+    EXPECT_EQ(cache.GetStats().gops, 0u);
+
+    cache.Add(packet.data(), packet.size(), MakeInfo(true));
+    cache.Clear();
+    EXPECT_FALSE(cache.GetStats().complete);
+    cache.Add(packet.data(), packet.size(), MakeInfo(false));
+    EXPECT_EQ(cache.GetStats().frames, 0u);
+}
+
+} // namespace
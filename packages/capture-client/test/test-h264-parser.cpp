@@ -0,0 +1,249 @@
+/**
+ * H.264 Parser Tests
+ * Межі NAL при 3- і 4-байтових start codes, trailing_zero_8bits, обрізаних буферах
+ * і зіпсованих заголовках; корпус випадкових потоків і мутацій (fuzz) проти еталону
+ */
+
+#include <gtest/gtest.h>
+#include "h264-parser.h"
+#include "test-common.h"
+
+namespace {
+
+struct TestNal {
+    uint8_t type = 0;
+    std::vector<uint8_t> payload;   // Заголовок NAL + тіло
+};
+
+// NAL з тілом без емуляції start code (як після emulation_prevention_three_byte)
+// і ненульовим останнім байтом (rbsp_stop_one_bit)
+TestNal MakeNal(TestRandom& random, uint8_t type, size_t size) {
+    TestNal nal;
+    nal.type = type;
+    nal.payload.push_back((uint8_t)(0x60 | type));
+    for (size_t i = 1; i < size; i++) {
+        uint8_t value = (uint8_t)random.Range(256);
+        const size_t n = nal.payload.size();
+        if (value <= 3 && n >= 2 && nal.payload[n - 1] == 0 && nal.payload[n - 2] == 0) {
+            value = 0x03;
+            nal.payload.push_back(value);
+            value = (uint8_t)(1 + random.Range(255));
+        }
+        nal.payload.push_back(value);
+    }
+    if (nal.payload.back() == 0) {
+        nal.payload.back() = 0x80;
+    }
+    return nal;
+}
+
+void AppendNal(std::vector<uint8_t>& stream, const TestNal& nal, bool long_start_code, int trailing_zeros) {
+    if (long_start_code) {
+        stream.push_back(0);
+    }
+    stream.insert(stream.end(), { 0, 0, 1 });
+    stream.insert(stream.end(), nal.payload.begin(), nal.payload.end());
+    stream.insert(stream.end(), (size_t)trailing_zeros, 0);
+}
+
+std::vector<uint8_t> NalBytes(const std::vector<uint8_t>& stream, const H264Nal& nal) {
+    return std::vector<uint8_t>(stream.begin() + nal.offset, stream.begin() + nal.offset + nal.size);
+}
+
+const uint8_t kSps[] = { 0x67, 0x64, 0x00, 0x28, 0xAC, 0xD9 };
+const uint8_t kPps[] = { 0x68, 0xEB, 0xE3, 0xCB };
+
+TEST(H264ParserTest, ThreeAndFourByteStartCodes) {
+    const std::vector<uint8_t> stream = {
+        0, 0, 0, 1, 0x67, 0x64, 0x00, 0x28, 0xAC, 0xD9,   // SPS, 4-байтовий код
+        0, 0, 1, 0x68, 0xEB, 0xE3, 0xCB,                  // PPS, 3-байтовий
+        0, 0, 0, 1, 0x65, 0x88, 0x84,                     // IDR
+        0, 0, 1, 0x65, 0x11, 0x22,                        // Другий slice того ж кадру
+    };
+    H264Parser parser;
+    H264Packet packet;
+    ASSERT_TRUE(parser.Parse(stream.data(), stream.size(), packet)) << parser.GetLastError();
+
+    ASSERT_EQ(packet.nal_count, 4);
+    EXPECT_EQ(packet.nals[0].offset, 4u);
+    EXPECT_EQ(packet.nals[0].size, sizeof(kSps));
+    EXPECT_EQ(packet.nals[1].offset, 13u);
+    EXPECT_EQ(packet.nals[1].size, sizeof(kPps));
+    EXPECT_EQ(packet.nals[2].offset, 21u);
+    EXPECT_EQ(packet.nals[2].size, 3u);
+    EXPECT_EQ(packet.nals[3].size, 3u);
+    EXPECT_EQ(packet.nals[0].type, (uint8_t)H264NalType::Sps);
+    EXPECT_EQ(packet.nals[1].type, (uint8_t)H264NalType::Pps);
+    EXPECT_EQ(packet.nals[3].type, (uint8_t)H264NalType::IdrSlice);
+    EXPECT_TRUE(packet.keyframe);
+    EXPECT_TRUE(packet.has_parameter_sets);
+    EXPECT_FALSE(packet.truncated);
+
+    // Кеш параметрів - без start codes; config - з 4-байтовими
+    EXPECT_EQ(parser.GetSps(), std::vector<uint8_t>(kSps, kSps + sizeof(kSps)));
+    EXPECT_EQ(parser.GetPps(), std::vector<uint8_t>(kPps, kPps + sizeof(kPps)));
+    EXPECT_EQ(parser.GetCodecString(), "avc1.640028");
+    const std::vector<uint8_t> config = parser.GetCodecConfig();
+    ASSERT_EQ(config.size(), 8 + sizeof(kSps) + sizeof(kPps));
+    EXPECT_EQ(config[3], 1);
+    EXPECT_EQ(config[4], 0x67);
+    EXPECT_EQ(config[4 + sizeof(kSps) + 3], 1);
+}
+
+TEST(H264ParserTest, TrailingZerosAreNotPartOfNal) {
+    // trailing_zero_8bits після NAL, перед наступним кодом і в кінці буфера
+    const std::vector<uint8_t> stream = {
+        0, 0, 1, 0x41, 0x9A, 0x02, 0, 0, 0, 0,
+        0, 0, 0, 1, 0x41, 0x9B, 0, 0,
+    };
+    H264Parser parser;
+    H264Packet packet;
+    ASSERT_TRUE(parser.Parse(stream.data(), stream.size(), packet)) << parser.GetLastError();
+    ASSERT_EQ(packet.nal_count, 2);
+    EXPECT_EQ(NalBytes(stream, packet.nals[0]), (std::vector<uint8_t>{ 0x41, 0x9A, 0x02 }));
+    EXPECT_EQ(NalBytes(stream, packet.nals[1]), (std::vector<uint8_t>{ 0x41, 0x9B }));
+    EXPECT_FALSE(packet.keyframe);
+    EXPECT_FALSE(packet.has_parameter_sets);
+}
+
+TEST(H264ParserTest, RejectsBuffersWithoutNals) {
+    H264Parser parser;
+    H264Packet packet;
+    const std::vector<std::vector<uint8_t>> bad = {
+        { 0x65, 0x88, 0x84 },               // Без start code
+        { 0, 0 },                           // Обрізаний start code
+        { 0, 0, 0 },
+        { 0, 0, 1 },                        // Код без NAL
+        { 0, 0, 0, 1, 0, 0, 0 },            // Лише trailing zeros
+        { 0, 0, 1, 0xE5, 0x88 },            // forbidden_zero_bit
+    };
+    for (size_t i = 0; i < bad.size(); i++) {
+        SCOPED_TRACE(i);
+        EXPECT_FALSE(parser.Parse(bad[i].data(), bad[i].size(), packet));
+        EXPECT_FALSE(parser.GetLastError().empty());
+        EXPECT_EQ(packet.nal_count, 0);
+    }
+    EXPECT_FALSE(parser.Parse(nullptr, 16, packet));
+    EXPECT_FALSE(parser.HasParameterSets());
+}
+
+TEST(H264ParserTest, TruncatedStreams) {
+    // Буфер обрізано всередині наступного start code: хвіст - лише нулі
+    const std::vector<uint8_t> cut_code = { 0, 0, 1, 0x65, 0x88, 0x84, 0, 0 };
+    H264Parser parser;
+    H264Packet packet;
+    ASSERT_TRUE(parser.Parse(cut_code.data(), cut_code.size(), packet));
+    ASSERT_EQ(packet.nal_count, 1);
+    EXPECT_EQ(packet.nals[0].size, 3u);
+
+    // Код без NAL у кінці буфера пропускається
+    const std::vector<uint8_t> empty_tail = { 0, 0, 1, 0x41, 0x9A, 0, 0, 0, 1 };
+    ASSERT_TRUE(parser.Parse(empty_tail.data(), empty_tail.size(), packet));
+    ASSERT_EQ(packet.nal_count, 1);
+    EXPECT_EQ(packet.nals[0].size, 2u);
+
+    // Сміття перед першим кодом ігнорується
+    const std::vector<uint8_t> garbage = { 0x12, 0x00, 0x34, 0, 0, 1, 0x41, 0x9A };
+    ASSERT_TRUE(parser.Parse(garbage.data(), garbage.size(), packet));
+    ASSERT_EQ(packet.nal_count, 1);
+    EXPECT_EQ(packet.nals[0].offset, 6u);
+}
+
+TEST(H264ParserTest, MoreThanMaxNalsStillFindsKeyframe) {
+    TestRandom random(3);
+    std::vector<uint8_t> stream;
+    for (int i = 0; i < H264Packet::kMaxNals + 4; i++) {
+        AppendNal(stream, MakeNal(random, (uint8_t)H264NalType::Slice, 6), i % 2 == 0, 0);
+    }
+    AppendNal(stream, MakeNal(random, (uint8_t)H264NalType::IdrSlice, 6), true, 0);
+
+    H264Parser parser;
+    H264Packet packet;
+    ASSERT_TRUE(parser.Parse(stream.data(), stream.size(), packet));
+    EXPECT_EQ(packet.nal_count, H264Packet::kMaxNals);
+    EXPECT_TRUE(packet.truncated);
+    EXPECT_TRUE(packet.keyframe);
+}
+
+TEST(H264ParserTest, FindStartCodeAtBufferEdges) {
+    const uint8_t data[] = { 0, 0, 1, 0x41, 0, 0, 0, 1, 0x41, 0, 0 };
+    EXPECT_EQ(H264Parser::FindStartCode(data, sizeof(data), 0), 0u);
+    EXPECT_EQ(H264Parser::FindStartCode(data, sizeof(data), 3), 5u);
+    EXPECT_EQ(H264Parser::FindStartCode(data, sizeof(data), 6), sizeof(data));
+    EXPECT_EQ(H264Parser::FindStartCode(data, 2, 0), 2u);
+    EXPECT_EQ(H264Parser::FindStartCode(data, 0, 0), 0u);
+}
+
+// Корпус: випадкові послідовності NAL з 3/4-байтовими кодами і trailing zeros -
+// парсер повертає рівно ті самі NAL, що було записано
+TEST(H264ParserTest, RandomCorpusRoundTrip) {
+    TestRandom random(11);
+    const uint8_t types[] = { 1, 5, 6, 7, 8, 9 };
+    H264Parser parser;
+    for (int iteration = 0; iteration < 500; iteration++) {
+        SCOPED_TRACE(iteration);
+        std::vector<TestNal> nals(1 + random.Range(H264Packet::kMaxNals));
+        std::vector<uint8_t> stream;
+        bool keyframe = false;
+        for (TestNal& nal : nals) {
+            nal = MakeNal(random, types[random.Range(6)], 1 + random.Range(64));
+            keyframe |= nal.type == (uint8_t)H264NalType::IdrSlice;
+            AppendNal(stream, nal, random.Range(2) == 0, random.Range(4) == 0 ? (int)random.Range(5) : 0);
+        }
+
+        H264Packet packet;
+        ASSERT_TRUE(parser.Parse(stream.data(), stream.size(), packet)) << parser.GetLastError();
+        ASSERT_EQ(packet.nal_count, (int)nals.size());
+        EXPECT_FALSE(packet.truncated);
+        EXPECT_EQ(packet.keyframe, keyframe);
+        for (size_t i = 0; i < nals.size(); i++) {
+            EXPECT_EQ(packet.nals[i].type, nals[i].type);
+            ASSERT_EQ(NalBytes(stream, packet.nals[i]), nals[i].payload);
+        }
+    }
+}
+
+// Мутації корпусу (зсув байтів, обрізання): без падінь, NAL у межах буфера
+TEST(H264ParserTest, MutatedCorpusStaysInBounds) {
+    TestRandom random(12);
+    H264Parser parser;
+    int accepted = 0;
+    for (int iteration = 0; iteration < 2000; iteration++) {
+        std::vector<uint8_t> stream;
+        const int count = 1 + (int)random.Range(8);
+        for (int i = 0; i < count; i++) {
+            AppendNal(stream, MakeNal(random, (uint8_t)(1 + random.Range(12)), 1 + random.Range(32)),
+                      random.Range(2) == 0, (int)random.Range(3));
+        }
+        const int mutations = 1 + (int)random.Range(8);
+        for (int i = 0; i < mutations; i++) {
+            const size_t at = (size_t)random.Range((int)stream.size());
+            switch (random.Range(3)) {
+            case 0: stream[at] = (uint8_t)random.Range(256); break;
+            case 1: stream[at] = (uint8_t)random.Range(2); break;    // Нові / зламані start codes
+            default: stream.resize(std::max<size_t>(at, 1)); break;
+            }
+        }
+
+        // Копія точного розміру - ASan / valgrind бачать читання за межі
+        const std::vector<uint8_t> input(stream);
+        H264Packet packet;
+        if (!parser.Parse(input.data(), input.size(), packet)) {
+            continue;
+        }
+        accepted++;
+        ASSERT_GT(packet.nal_count, 0);
+        for (int i = 0; i < packet.nal_count; i++) {
+            const H264Nal& nal = packet.nals[i];
+            ASSERT_GE(nal.offset, 3u);
+            ASSERT_GT(nal.size, 0u);
+            ASSERT_LE((size_t)nal.offset + nal.size, input.size());
+            EXPECT_EQ(input[nal.offset - 1], 1);
+            EXPECT_EQ(nal.type, input[nal.offset] & 0x1F);
+            EXPECT_NE(input[nal.offset + nal.size - 1], 0);
+        }
+    }
+    EXPECT_GT(accepted, 0);
+}
+
+} // namespace
@@ -0,0 +1,300 @@
+/**
+ * Motion Detector Tests
+ * Пошук зсуву на синтетичній прокрутці (вертикальній, горизонтальній, у вікні):
+ * джерело кожного переміщення в попередньому кадрі збігається з ціллю в поточному.
+ * Хибні підказки (DXGI move rects) не псують картинку - залишок передає кодер.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
+#include "delta-encoder.h"
+#include "motion-detector.h"
+#include "test-common.h"
+#include "test-delta-decoder.h"
+
+namespace {
+
+constexpr int kWidth = 250;     // Остання смуга вужча за kBlockSize
+constexpr int kHeight = 190;
+
+// "Документ" з рядків тексту: 8 рядків випадкових гліфів, 4 порожні (повторювані
+// рядки не голосують за зсув)
+TestFrame MakeDocument(int width, int height, uint32_t seed) {
+    TestFrame document(width, height, 0, 0xFF);
+    TestRandom random(seed);
+    for (int y = 0; y < height; y++) {
+        if (y % 12 >= 8) {
+            continue;
+        }
+        for (int x = 0; x < width; x++) {
+            const uint8_t ink = random.Range(3) == 0 ? (uint8_t)random.Range(128) : 0xFF;
+            uint8_t* p = document.Pixel(x, y);
+            p[0] = p[1] = p[2] = ink;
+        }
+    }
+    return document;
+}
+
+// Вікно width x height документа з позиції (x, y) у кадр з позиції (to_x, to_y)
+void Blit(TestFrame& frame, const TestFrame& document, int x, int y, int width, int height,
+          int to_x = 0, int to_y = 0) {
+    for (int row = 0; row < height; row++) {
+        memcpy(frame.Pixel(to_x, to_y + row), document.Pixel(x, y + row), (size_t)width * 4);
+    }
+}
+
+// Переміщення в межах кадру, цілі не перетинаються, джерело (попередній кадр) = ціль
+void ExpectValidMoves(const std::vector<MoveRect>& moves, const TestFrame& previous, const TestFrame& current) {
+    for (size_t i = 0; i < moves.size(); i++) {
+        SCOPED_TRACE(i);
+        const MoveRect& m = moves[i];
+        ASSERT_GT(m.width, 0);
+        ASSERT_GT(m.height, 0);
+        ASSERT_GE(std::min(m.src_x, m.dst_x), 0);
+        ASSERT_GE(std::min(m.src_y, m.dst_y), 0);
+        ASSERT_LE(std::max(m.src_x, m.dst_x) + m.width, current.width);
+        ASSERT_LE(std::max(m.src_y, m.dst_y) + m.height, current.height);
+        for (int row = 0; row < m.height; row++) {
+            ASSERT_EQ(memcmp(previous.Pixel(m.src_x, m.src_y + row), current.Pixel(m.dst_x, m.dst_y + row),
+                             (size_t)m.width * 4), 0) << "row " << row;
+        }
+        for (size_t j = i + 1; j < moves.size(); j++) {
+            const MoveRect& o = moves[j];
+            EXPECT_FALSE(m.dst_x < o.dst_x + o.width && o.dst_x < m.dst_x + m.width &&
+                         m.dst_y < o.dst_y + o.height && o.dst_y < m.dst_y + m.height) << "overlaps " << j;
+        }
+    }
+}
+
+uint64_t MovedPixels(const std::vector<MoveRect>& moves) {
+    uint64_t pixels = 0;
+    for (const MoveRect& move : moves) {
+        pixels += (uint64_t)move.width * move.height;
+    }
+    return pixels;
+}
+
+TEST(MotionDetectorTest, FirstAndStaticFramesHaveNoMoves) {
+    MotionDetector detector;
+    ASSERT_TRUE(detector.Initialize(kWidth, kHeight));
+    TestFrame frame(kWidth, kHeight);
+    frame.FillRandom(1);
+    std::vector<MoveRect> moves(3);
+    EXPECT_EQ(detector.Analyze(frame.pixels.data(), frame.stride, moves), 0);
+    EXPECT_TRUE(moves.empty());
+    EXPECT_EQ(detector.Analyze(frame.pixels.data(), frame.stride, moves), 0);
+
+    // Новий вміст без зсуву - теж без переміщень
+    frame.FillRandom(2);
+    EXPECT_EQ(detector.Analyze(frame.pixels.data(), frame.stride, moves), 0);
+    EXPECT_EQ(detector.GetStats().frames, 2u);
+    EXPECT_EQ(detector.GetStats().moves, 0u);
+
+    EXPECT_FALSE(detector.Initialize(0, kHeight));
+}
+
+TEST(MotionDetectorTest, DetectsVerticalScroll) {
+    const TestFrame document = MakeDocument(kWidth, kHeight + 200, 3);
+    MotionDetector detector;
+    ASSERT_TRUE(detector.Initialize(kWidth, kHeight));
+    TestFrame previous(kWidth, kHeight, 20);
+    TestFrame current(kWidth, kHeight, 20);
+    std::vector<MoveRect> moves;
+
+    const int shifts[] = { 7, 7, 13, 1, 40 };
+    int top = 0;
+    Blit(previous, document, 0, top, kWidth, kHeight);
+    detector.Analyze(previous.pixels.data(), previous.stride, moves);
+    for (int shift : shifts) {
+        SCOPED_TRACE(shift);
+        top += shift;
+        Blit(current, document, 0, top, kWidth, kHeight);
+        ASSERT_EQ(detector.Analyze(current.pixels.data(), current.stride, moves), 1);
+        ExpectValidMoves(moves, previous, current);
+        // Прокрутка вниз документа: рядок y кадру - рядок y + shift попереднього
+        EXPECT_EQ(moves[0].src_x, 0);
+        EXPECT_EQ(moves[0].dst_x, 0);
+        EXPECT_EQ(moves[0].width, kWidth);
+        EXPECT_EQ(moves[0].src_y, shift);
+        EXPECT_EQ(moves[0].dst_y, 0);
+        EXPECT_EQ(moves[0].height, kHeight - shift);
+        std::swap(previous, current);
+    }
+    EXPECT_EQ(detector.GetStats().hinted, 0u);
+}
+
+TEST(MotionDetectorTest, DetectsHorizontalScroll) {
+    TestFrame document(kWidth + 120, kHeight);
+    document.FillRandom(4);
+    MotionDetector detector;
+    ASSERT_TRUE(detector.Initialize(kWidth, kHeight));
+    TestFrame previous(kWidth, kHeight);
+    TestFrame current(kWidth, kHeight);
+    std::vector<MoveRect> moves;
+
+    Blit(previous, document, 30, 0, kWidth, kHeight);
+    detector.Analyze(previous.pixels.data(), previous.stride, moves);
+    // Вміст їде праворуч: стовпець x кадру - стовпець x - 30 попереднього
+    Blit(current, document, 0, 0, kWidth, kHeight);
+    ASSERT_EQ(detector.Analyze(current.pixels.data(), current.stride, moves), 1);
+    ExpectValidMoves(moves, previous, current);
+    EXPECT_EQ(moves[0].src_x, 0);
+    EXPECT_EQ(moves[0].dst_x, 30);
+    EXPECT_EQ(moves[0].width, kWidth - 30);
+    EXPECT_EQ(moves[0].src_y, 0);
+    EXPECT_EQ(moves[0].dst_y, 0);
+    EXPECT_EQ(moves[0].height, kHeight);
+}
+
+TEST(MotionDetectorTest, DetectsScrollInsideWindow) {
+    // Статичне тло, прокручується лише вікно 128x128 на межах смуг
+    const TestFrame document = MakeDocument(128, 400, 5);
+    TestFrame background(kWidth, kHeight);
+    background.FillRandom(6);
+    MotionDetector detector;
+    ASSERT_TRUE(detector.Initialize(kWidth, kHeight));
+    TestFrame previous = background;
+    TestFrame current = background;
+    std::vector<MoveRect> moves;
+
+    Blit(previous, document, 0, 0, 128, 128, 64, 32);
+    detector.Analyze(previous.pixels.data(), previous.stride, moves);
+    Blit(current, document, 0, 9, 128, 128, 64, 32);
+    ASSERT_EQ(detector.Analyze(current.pixels.data(), current.stride, moves), 1);
+    ExpectValidMoves(moves, previous, current);
+    EXPECT_EQ(moves[0].src_x, 64);
+    EXPECT_EQ(moves[0].dst_x, 64);
+    EXPECT_EQ(moves[0].width, 128);
+    EXPECT_EQ(moves[0].src_y, 32 + 9);
+    EXPECT_EQ(moves[0].dst_y, 32);
+    EXPECT_EQ(moves[0].height, 128 - 9);
+}
+
+TEST(MotionDetectorTest, RandomScrollsAlwaysYieldValidMoves) {
+    const TestFrame document = MakeDocument(kWidth, 2000, 7);
+    TestRandom random(8);
+    MotionDetector detector;
+    ASSERT_TRUE(detector.Initialize(kWidth, kHeight));
+    TestFrame previous(kWidth, kHeight);
+    TestFrame current(kWidth, kHeight);
+    std::vector<MoveRect> moves;
+
+    int top = 900;
+    Blit(previous, document, 0, top, kWidth, kHeight);
+    detector.Analyze(previous.pixels.data(), previous.stride, moves);
+    int scrolled = 0;
+    for (int i = 0; i < 40; i++) {
+        SCOPED_TRACE(i);
+        const int shift = random.Range(121) - 60;
+        top += shift;
+        Blit(current, document, 0, top, kWidth, kHeight);
+        // Інколи зверху змінюється рядок стану - він не входить у переміщення
+        if (random.Range(2) == 0) {
+            current.FillRect(0, 0, kWidth, 4, random.Next() | 0xFF000000);
+        }
+        detector.Analyze(current.pixels.data(), current.stride, moves);
+        ExpectValidMoves(moves, previous, current);
+        if (std::abs(shift) >= 4 && std::abs(shift) <= kHeight - 2 * MotionDetector::kMinRunLength) {
+            scrolled++;
+            EXPECT_FALSE(moves.empty());
+            EXPECT_GE(MovedPixels(moves), (uint64_t)kWidth * (kHeight - std::abs(shift) - 4) / 2);
+        }
+        std::swap(previous, current);
+    }
+    EXPECT_GT(scrolled, 20);
+}
+
+TEST(MotionDetectorTest, HintsReplaceSearchOnceAndAreClipped) {
+    const TestFrame document = MakeDocument(kWidth, kHeight + 50, 9);
+    MotionDetector detector;
+    ASSERT_TRUE(detector.Initialize(kWidth, kHeight));
+    TestFrame frame(kWidth, kHeight);
+    std::vector<MoveRect> moves;
+    Blit(frame, document, 0, 0, kWidth, kHeight);
+    detector.Analyze(frame.pixels.data(), frame.stride, moves);
+
+    // Хибна підказка (зсув 3 замість 20) береться як є, без перевірки
+    MoveRect wrong;
+    wrong.src_x = 0;
+    wrong.src_y = 3;
+    wrong.width = kWidth;
+    wrong.height = kHeight - 3;
+    // Поза кадром - обрізається; без зсуву і повністю за межами - відкидаються
+    MoveRect clipped;
+    clipped.src_x = kWidth - 10;
+    clipped.dst_x = kWidth - 40;
+    clipped.width = 100;
+    clipped.height = 10;
+    MoveRect still;
+    still.width = 10;
+    still.height = 10;
+    MoveRect outside;
+    outside.src_x = kWidth + 5;
+    outside.width = 10;
+    outside.height = 10;
+    detector.SetHints({ wrong, clipped, still, outside });
+
+    Blit(frame, document, 0, 20, kWidth, kHeight);
+    ASSERT_EQ(detector.Analyze(frame.pixels.data(), frame.stride, moves), 2);
+    EXPECT_EQ(moves[0].src_y, 3);
+    EXPECT_EQ(moves[0].height, kHeight - 3);
+    EXPECT_EQ(moves[1].src_x, kWidth - 10);
+    EXPECT_EQ(moves[1].dst_x, kWidth - 40);
+    EXPECT_EQ(moves[1].width, 10);
+    EXPECT_EQ(detector.GetStats().hinted, 1u);
+
+    // Підказки діють на один кадр: далі - власний пошук зсуву
+    Blit(frame, document, 0, 40, kWidth, kHeight);
+    ASSERT_EQ(detector.Analyze(frame.pixels.data(), frame.stride, moves), 1);
+    EXPECT_EQ(moves[0].src_y, 20);
+    EXPECT_EQ(detector.GetStats().hinted, 1u);
+
+    // Лише непридатні підказки - теж пошук
+    detector.SetHints({ still, outside });
+    Blit(frame, document, 0, 50, kWidth, kHeight);
+    ASSERT_EQ(detector.Analyze(frame.pixels.data(), frame.stride, moves), 1);
+    EXPECT_EQ(moves[0].src_y, 10);
+    EXPECT_EQ(detector.GetStats().hinted, 1u);
+}
+
+// Хибні підказки в дельта-кодері: переміщення застосовується, а плитки, що після
+// нього відрізняються від кадру, ідуть залишком - отримувач бачить точний кадр
+TEST(MotionDetectorTest, WrongHintsStillDecodeExactly) {
+    const TestFrame document = MakeDocument(kWidth, kHeight + 300, 10);
+    DeltaEncoder encoder;
+    ASSERT_TRUE(encoder.Initialize(kWidth, kHeight, 64, 0, true));
+    std::vector<uint8_t> buffer(encoder.GetMaxPacketSize());
+    TestDeltaDecoder decoder;
+    TestFrame frame(kWidth, kHeight, 8);
+    TestRandom random(11);
+
+    int top = 0;
+    for (int i = 0; i < 12; i++) {
+        SCOPED_TRACE(i);
+        top += 5 + random.Range(20);
+        Blit(frame, document, 0, top, kWidth, kHeight);
+        if (i > 0) {
+            // Випадкові прямокутники замість справжнього зсуву
+            std::vector<MoveRect> hints(1 + random.Range(3));
+            for (MoveRect& hint : hints) {
+                hint.width = 16 + random.Range(kWidth);
+                hint.height = 16 + random.Range(kHeight);
+                hint.src_x = random.Range(kWidth) - 20;
+                hint.src_y = random.Range(kHeight) - 20;
+                hint.dst_x = random.Range(kWidth);
+                hint.dst_y = random.Range(kHeight);
+            }
+            encoder.SetMoveHints(hints);
+        }
+        size_t size = 0;
+        ASSERT_TRUE(encoder.Encode(frame.pixels.data(), frame.stride, buffer.data(), buffer.size(), size))
+            << encoder.GetLastError();
+        ASSERT_GT(size, 0u);
+        ASSERT_TRUE(decoder.Apply(buffer.data(), size)) << decoder.GetError();
+        ASSERT_TRUE(SamePixels(decoder.GetFrame(), frame));
+    }
+    EXPECT_EQ(encoder.GetMotionStats().hinted, 11u);
+}
+
+} // namespace
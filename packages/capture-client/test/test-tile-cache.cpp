@@ -0,0 +1,205 @@
+/**
+ * Tile Cache Tests
+ * Слоти LRU кешу плиток і дельта-потік з кешем: кодування -> декодування, втрачений
+ * пакет із промахами розсинхронізує слоти, keyframe (ForceKeyframe) відновлює потік
+ */
+
+#include <gtest/gtest.h>
+#include "delta-encoder.h"
+#include "test-common.h"
+#include "test-delta-decoder.h"
+#include "tile-cache.h"
+
+namespace {
+
+constexpr int kTile = 16;
+constexpr size_t kTileBytes = (size_t)kTile * kTile * 4;
+
+TEST(TileCacheTest, AssignsSlotsAndEvictsLeastRecentlyUsed) {
+    TileCache cache;
+    ASSERT_TRUE(cache.Initialize(kTile, kTileBytes * 3 + kTileBytes / 2));
+    EXPECT_EQ(cache.GetSlotCount(), 3);
+    EXPECT_EQ(cache.GetMaxBytes(), kTileBytes * 3);
+
+    uint16_t slot = 0xFFFF;
+    EXPECT_FALSE(cache.Lookup(1, kTileBytes, slot));
+    EXPECT_EQ(slot, 0);
+    EXPECT_FALSE(cache.Lookup(2, kTileBytes, slot));
+    EXPECT_EQ(slot, 1);
+    EXPECT_FALSE(cache.Lookup(3, kTileBytes, slot));
+    EXPECT_EQ(slot, 2);
+
+    // Влучання робить слот нещодавно використаним: витісняється 2, потім 3
+    EXPECT_TRUE(cache.Lookup(1, kTileBytes, slot));
+    EXPECT_EQ(slot, 0);
+    EXPECT_FALSE(cache.Lookup(4, kTileBytes, slot));
+    EXPECT_EQ(slot, 1);
+    EXPECT_FALSE(cache.Lookup(2, kTileBytes, slot));
+    EXPECT_EQ(slot, 2);
+    EXPECT_TRUE(cache.Lookup(4, kTileBytes, slot));
+    EXPECT_EQ(slot, 1);
+
+    const TileCacheStats stats = cache.GetStats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 5u);
+    EXPECT_EQ(stats.evictions, 2u);
+    EXPECT_EQ(stats.bytes_saved, 2 * kTileBytes);
+
+    // Після Reset (keyframe) слоти роздаються з нуля, як у щойно очищеного отримувача
+    cache.Reset();
+    EXPECT_EQ(cache.GetUsedSlots(), 0);
+    EXPECT_FALSE(cache.Lookup(4, kTileBytes, slot));
+    EXPECT_EQ(slot, 0);
+}
+
+TEST(TileCacheTest, BudgetBelowOneTileDisablesCache) {
+    TileCache cache;
+    EXPECT_FALSE(cache.Initialize(kTile, kTileBytes - 1));
+    EXPECT_FALSE(cache.IsEnabled());
+    EXPECT_FALSE(cache.Initialize(0, kTileBytes));
+}
+
+TEST(TileCacheTest, HashCoversPixelsAndSizeButNotPadding) {
+    TestFrame frame(kTile * 2, kTile, 12);
+    frame.FillRandom(4);
+    const uint64_t hash = TileCache::HashTile(frame.pixels.data(), frame.stride, kTile, kTile);
+
+    for (int row = 0; row < frame.height; row++) {
+        memset(frame.Row(row) + frame.width * 4, row + 1, 12);
+    }
+    EXPECT_EQ(TileCache::HashTile(frame.pixels.data(), frame.stride, kTile, kTile), hash);
+
+    EXPECT_NE(TileCache::HashTile(frame.pixels.data(), frame.stride, kTile, kTile - 1), hash);
+    frame.Pixel(kTile - 1, kTile - 1)[3] ^= 0x01;
+    EXPECT_NE(TileCache::HashTile(frame.pixels.data(), frame.stride, kTile, kTile), hash);
+}
+
+// Дельта-кодер з кешем плиток на 64x64 кадрі (16 плиток)
+class CachedDeltaStream {
+public:
+    explicit CachedDeltaStream(size_t cache_tiles = 64) {
+        EXPECT_TRUE(encoder_.Initialize(64, 64, kTile, 0, false, cache_tiles * kTileBytes));
+        buffer_.resize(encoder_.GetMaxPacketSize());
+    }
+
+    std::vector<uint8_t> Encode(const TestFrame& frame) {
+        size_t size = 0;
+        EXPECT_TRUE(encoder_.Encode(frame.pixels.data(), frame.stride, buffer_.data(), buffer_.size(), size))
+            << encoder_.GetLastError();
+        return std::vector<uint8_t>(buffer_.begin(), buffer_.begin() + size);
+    }
+
+    DeltaEncoder& Get() { return encoder_; }
+
+private:
+    DeltaEncoder encoder_;
+    std::vector<uint8_t> buffer_;
+};
+
+// Два "вікна", що по черзі займають верхню половину кадру
+void ShowWindow(TestFrame& frame, const TestFrame& window) {
+    for (int row = 0; row < window.height; row++) {
+        memcpy(frame.Row(row), window.Row(row), (size_t)window.width * 4);
+    }
+}
+
+TEST(TileCacheTest, CachedDeltaRoundTrip) {
+    CachedDeltaStream stream;
+    ASSERT_TRUE(stream.Get().IsTileCacheEnabled());
+    TestFrame frame(64, 64);
+    frame.FillRandom(1);
+    TestFrame first(64, 32), second(64, 32);
+    first.FillRandom(2);
+    second.FillRandom(3);
+    TestDeltaDecoder decoder;
+
+    for (int i = 0; i < 10; i++) {
+        SCOPED_TRACE(i);
+        ShowWindow(frame, i % 2 ? second : first);
+        const std::vector<uint8_t> packet = stream.Encode(frame);
+        ASSERT_FALSE(packet.empty());
+        EXPECT_TRUE(packet[10] & DeltaEncoder::kFlagTileCache);
+        ASSERT_TRUE(decoder.Apply(packet.data(), packet.size())) << decoder.GetError();
+        ASSERT_TRUE(SamePixels(decoder.GetFrame(), frame));
+        if (i >= 2) {
+            // Обидва вікна вже в кеші: лише посилання, без пікселів
+            EXPECT_EQ(stream.Get().GetLastTileCacheStats().hits, 8u);
+            EXPECT_EQ(stream.Get().GetLastTileCacheStats().misses, 0u);
+        }
+    }
+}
+
+TEST(TileCacheTest, DroppedMissPacketDesyncsUntilKeyframe) {
+    TestFrame base(64, 64);
+    base.FillRandom(5);
+    TestFrame first(64, 32), second(64, 32);
+    first.FillRandom(6);
+    second.FillRandom(7);
+
+    // frames[1] приносить вікно second у слоти кешу - саме цей пакет губиться
+    std::vector<TestFrame> frames(4, base);
+    ShowWindow(frames[0], first);
+    ShowWindow(frames[1], second);
+    ShowWindow(frames[2], first);
+    ShowWindow(frames[3], second);
+
+    // Без відновлення: влучання в слот, якого отримувач не має
+    {
+        CachedDeltaStream stream;
+        TestDeltaDecoder decoder;
+        std::vector<uint8_t> packet = stream.Encode(frames[0]);
+        ASSERT_TRUE(decoder.Apply(packet.data(), packet.size())) << decoder.GetError();
+        stream.Encode(frames[1]);
+        packet = stream.Encode(frames[2]);
+        ASSERT_TRUE(decoder.Apply(packet.data(), packet.size())) << decoder.GetError();
+        packet = stream.Encode(frames[3]);
+        EXPECT_FALSE(decoder.Apply(packet.data(), packet.size()));
+    }
+
+    // Як release циклу / помилка EncodeCapturedFrame: ForceKeyframe після втрати
+    {
+        CachedDeltaStream stream;
+        TestDeltaDecoder decoder;
+        std::vector<uint8_t> packet = stream.Encode(frames[0]);
+        ASSERT_TRUE(decoder.Apply(packet.data(), packet.size())) << decoder.GetError();
+        stream.Encode(frames[1]);
+        stream.Get().ForceKeyframe();
+        for (int i = 2; i < 4; i++) {
+            SCOPED_TRACE(i);
+            packet = stream.Encode(frames[i]);
+            EXPECT_EQ(stream.Get().IsLastKeyframe(), i == 2);
+            ASSERT_TRUE(decoder.Apply(packet.data(), packet.size())) << decoder.GetError();
+            ASSERT_TRUE(SamePixels(decoder.GetFrame(), frames[i]));
+        }
+    }
+}
+
+TEST(TileCacheTest, EvictedSlotsStayInSyncWithReceiver) {
+    // Кеш на 10 плиток менший за кадр (16): витіснення на кожному кадрі
+    CachedDeltaStream stream(10);
+    TestFrame frame(64, 64);
+    TestRandom random(8);
+    TestDeltaDecoder decoder;
+    std::vector<TestFrame> windows(3, TestFrame(64, 32));
+    for (size_t i = 0; i < windows.size(); i++) {
+        windows[i].FillRandom(10 + (uint32_t)i);
+    }
+
+    uint64_t hits = 0;
+    for (int i = 0; i < 30; i++) {
+        SCOPED_TRACE(i);
+        ShowWindow(frame, windows[random.Range(3)]);
+        frame.FillRect(0, 32 + random.Range(32), 64, 1, random.Next() | 0xFF000000);
+        const std::vector<uint8_t> packet = stream.Encode(frame);
+        if (packet.empty()) {
+            continue;
+        }
+        hits += stream.Get().GetLastTileCacheStats().hits;
+        ASSERT_TRUE(decoder.Apply(packet.data(), packet.size())) << decoder.GetError();
+        ASSERT_TRUE(SamePixels(decoder.GetFrame(), frame));
+    }
+    EXPECT_GT(stream.Get().GetTileCacheStats().evictions, 0u);
+    EXPECT_GT(hits, 0u);
+}
+
+} // namespace
@@ -0,0 +1,504 @@
+/**
+ * Tile Codec Tests
+ * Ядра підрахунку кольорів (SSE2 / AVX2 проти scalar еталону), блок LZ (стиснення ->
+ * розпакування, пошкоджені й обрізані блоки) і пакет TIL1 екранного кодека:
+ * TileEncoder -> LzDecompress -> потік плиток відновлює кадр без втрат
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "color-count.h"
+#include "lz-block.h"
+#include "test-common.h"
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+#include "tile-encoder.h"
+#endif
+
+namespace {
+
+const ConvertKernel kKernels[] = { ConvertKernel::Scalar, ConvertKernel::SSE2, ConvertKernel::AVX2 };
+
+// Плитка з colors кольорів (альфа випадкова - не враховується), серії довжиною до run
+void FillColors(TestFrame& frame, TestRandom& random, int colors, int run) {
+    std::vector<uint32_t> palette((size_t)colors);
+    for (uint32_t& color : palette) {
+        color = random.Next() & 0x00FFFFFF;
+    }
+    int left = 0;
+    uint32_t color = 0;
+    for (int y = 0; y < frame.height; y++) {
+        for (int x = 0; x < frame.width; x++) {
+            if (left-- <= 0) {
+                color = palette[(size_t)random.Range(colors)];
+                left = random.Range(run);
+            }
+            const uint32_t value = color | (random.Next() << 24);
+            memcpy(frame.Pixel(x, y), &value, 4);
+        }
+    }
+}
+
+TEST(ColorCountTest, KernelsMatchScalarReference) {
+    const CountColorsFunc scalar = GetCountColorsFunc(ConvertKernel::Scalar);
+    ASSERT_NE(scalar, nullptr);
+    TestRandom random(1);
+    const int sizes[][2] = {{1, 1}, {3, 5}, {7, 1}, {8, 8}, {15, 17}, {16, 16}, {33, 9}, {64, 64}, {70, 3}};
+    const int limits[] = { 1, 2, 4, 15, kMaxCountedColors };
+
+    for (ConvertKernel kernel : kKernels) {
+        if (!IsConvertKernelSupported(kernel)) {
+            continue;
+        }
+        SCOPED_TRACE(GetConvertKernelName(kernel));
+        const CountColorsFunc count = GetCountColorsFunc(kernel);
+        ASSERT_NE(count, nullptr);
+        for (const auto& size : sizes) {
+            for (int colors = 1; colors <= kMaxCountedColors + 3; colors++) {
+                TestFrame tile(size[0], size[1], 4 * random.Range(3), 0xAB);
+                FillColors(tile, random, colors, 1 + random.Range(12));
+                for (int limit : limits) {
+                    SCOPED_TRACE(testing::Message() << size[0] << "x" << size[1] << " colors " << colors
+                                                    << " limit " << limit);
+                    uint32_t expected[kMaxCountedColors];
+                    uint32_t actual[kMaxCountedColors];
+                    const int n = scalar(tile.pixels.data(), tile.stride, tile.width, tile.height, expected, limit);
+                    ASSERT_EQ(count(tile.pixels.data(), tile.stride, tile.width, tile.height, actual, limit), n);
+                    if (n <= limit) {
+                        ASSERT_TRUE(std::equal(expected, expected + n, actual));
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(ColorCountTest, IgnoresAlphaAndStopsAfterLimit) {
+    for (ConvertKernel kernel : kKernels) {
+        if (!IsConvertKernelSupported(kernel)) {
+            continue;
+        }
+        SCOPED_TRACE(GetConvertKernelName(kernel));
+        const CountColorsFunc count = GetCountColorsFunc(kernel);
+        uint32_t palette[kMaxCountedColors];
+
+        // Однотонна плитка з різною альфою - один колір
+        TestFrame flat(37, 11);
+        for (int y = 0; y < flat.height; y++) {
+            for (int x = 0; x < flat.width; x++) {
+                const uint32_t value = 0x00123456 | ((uint32_t)(x * 7 + y) << 24);
+                memcpy(flat.Pixel(x, y), &value, 4);
+            }
+        }
+        ASSERT_EQ(count(flat.pixels.data(), flat.stride, flat.width, flat.height, palette, kMaxCountedColors), 1);
+        EXPECT_EQ(palette[0], 0x00123456u);
+
+        // Порядок першої появи; 17-й колір - переповнення
+        TestFrame stripes(kMaxCountedColors + 1, 2);
+        for (int x = 0; x < stripes.width; x++) {
+            stripes.FillRect(x, 0, 1, 2, 0xFF000000 | (uint32_t)(x * 0x010203));
+        }
+        EXPECT_EQ(count(stripes.pixels.data(), stripes.stride, stripes.width, stripes.height, palette,
+                        kMaxCountedColors), kMaxCountedColors + 1);
+        ASSERT_EQ(count(stripes.pixels.data(), stripes.stride, kMaxCountedColors, 2, palette, kMaxCountedColors),
+                  kMaxCountedColors);
+        for (int k = 0; k < kMaxCountedColors; k++) {
+            EXPECT_EQ(palette[k], (uint32_t)(k * 0x010203));
+        }
+    }
+}
+
+std::vector<uint8_t> Compress(const std::vector<uint8_t>& data) {
+    LzCompressor lz;
+    std::vector<uint8_t> block(LzCompressor::GetMaxCompressedSize(data.size()));
+    const size_t size = lz.Compress(data.data(), data.size(), block.data(), block.size());
+    EXPECT_GT(size, 0u);
+    block.resize(size);
+    return block;
+}
+
+// Корпус блоків LZ: порожній, короткі, нестисливі, повтори з перекриттям, довгі серії
+std::vector<std::vector<uint8_t>> LzCorpus() {
+    std::vector<std::vector<uint8_t>> corpus;
+    TestRandom random(2);
+    for (size_t size : { 0, 1, 4, 5, 12, 13, 17, 100 }) {
+        std::vector<uint8_t> data(size);
+        for (uint8_t& value : data) {
+            value = (uint8_t)random.Range(4);
+        }
+        corpus.push_back(data);
+    }
+    std::vector<uint8_t> noise(70000);
+    for (uint8_t& value : noise) {
+        value = (uint8_t)random.Next();
+    }
+    corpus.push_back(noise);
+    corpus.push_back(std::vector<uint8_t>(100000, 0x5A));
+    // Рядки плиток тексту: короткі повтори на відстанях у межах 16-бітного зміщення і поза ним
+    std::vector<uint8_t> text;
+    for (int i = 0; i < 3000; i++) {
+        const size_t from = text.size() > 70000 ? text.size() - 70000 : 0;
+        if (text.size() > 8 && random.Range(2)) {
+            const size_t start = from + (size_t)random.Range((int)(text.size() - from - 4));
+            const size_t length = 4 + (size_t)random.Range(300);
+            for (size_t k = 0; k < length; k++) {
+                text.push_back(text[start + k]);
+            }
+        } else {
+            for (int k = random.Range(20); k >= 0; k--) {
+                text.push_back((uint8_t)random.Next());
+            }
+        }
+    }
+    corpus.push_back(text);
+    return corpus;
+}
+
+TEST(LzBlockTest, RoundTripCorpus) {
+    const std::vector<std::vector<uint8_t>> corpus = LzCorpus();
+    for (size_t i = 0; i < corpus.size(); i++) {
+        SCOPED_TRACE(i);
+        const std::vector<uint8_t>& data = corpus[i];
+        const std::vector<uint8_t> block = Compress(data);
+        ASSERT_LE(block.size(), LzCompressor::GetMaxCompressedSize(data.size()));
+        std::vector<uint8_t> out(data.size() + 1, 0xEE);
+        ASSERT_TRUE(LzDecompress(block.data(), block.size(), out.data(), data.size()));
+        EXPECT_TRUE(std::equal(data.begin(), data.end(), out.begin()));
+        EXPECT_EQ(out.back(), 0xEE);    // За dst_size нічого не пишеться
+
+        // Розмір виходу має збігатися рівно
+        EXPECT_FALSE(LzDecompress(block.data(), block.size(), out.data(), data.size() + 1));
+        if (!data.empty()) {
+            EXPECT_FALSE(LzDecompress(block.data(), block.size(), out.data(), data.size() - 1));
+        }
+    }
+    EXPECT_LT(Compress(corpus.back()).size(), corpus.back().size() / 2);
+}
+
+TEST(LzBlockTest, CompressRejectsSmallCapacity) {
+    const std::vector<uint8_t> data(1000, 7);
+    LzCompressor lz;
+    std::vector<uint8_t> block(LzCompressor::GetMaxCompressedSize(data.size()));
+    EXPECT_EQ(lz.Compress(data.data(), data.size(), block.data(), block.size() - 1), 0u);
+    EXPECT_EQ(lz.Compress(data.data(), data.size(), nullptr, block.size()), 0u);
+}
+
+TEST(LzBlockTest, RejectsCorruptBlocks) {
+    uint8_t out[64];
+    const std::vector<std::vector<uint8_t>> bad = {
+        { 0xF0 },                               // Довжина літералів обірвана
+        { 0xF0, 0xFF },
+        { 0x30, 'a', 'b' },                     // Літералів менше, ніж у токені
+        { 0x10, 'a', 0x01 },                    // Зміщення обрізане
+        { 0x10, 'a', 0x00, 0x00 },              // Нульове зміщення
+        { 0x10, 'a', 0x02, 0x00 },              // Зміщення до початку виходу
+        { 0x1F, 'a', 0x01, 0x00 },              // Довжина збігу обірвана
+        { 0x1F, 'a', 0x01, 0x00, 0xFF, 0x40 },  // Збіг за межі виходу
+        { 0x00, 0x00, 0x00 },                   // Збіг без виходу перед ним
+    };
+    for (size_t i = 0; i < bad.size(); i++) {
+        SCOPED_TRACE(i);
+        EXPECT_FALSE(LzDecompress(bad[i].data(), bad[i].size(), out, sizeof(out)));
+    }
+
+    // Збіг, що перекриває сам себе (зміщення 1) - валідний
+    const uint8_t overlap[] = { 0x1E, 'a', 0x01, 0x00 };
+    ASSERT_TRUE(LzDecompress(overlap, sizeof(overlap), out, 1 + 14 + 4));
+    EXPECT_TRUE(std::all_of(out, out + 19, [](uint8_t value) { return value == 'a'; }));
+}
+
+// Обрізання й мутації валідних блоків: лише false, без запису за dst_size
+TEST(LzBlockTest, TruncatedAndMutatedBlocksStayInBounds) {
+    const std::vector<std::vector<uint8_t>> corpus = LzCorpus();
+    TestRandom random(3);
+    for (size_t i = 0; i < corpus.size(); i++) {
+        SCOPED_TRACE(i);
+        const std::vector<uint8_t>& data = corpus[i];
+        const std::vector<uint8_t> block = Compress(data);
+        std::vector<uint8_t> out(data.size() + 16, 0xEE);
+
+        for (int cut = 0; cut < 40 && !data.empty(); cut++) {
+            const size_t size = block.size() - 1 - (size_t)random.Range((int)block.size());
+            const std::vector<uint8_t> truncated(block.begin(), block.begin() + size);
+            EXPECT_FALSE(LzDecompress(truncated.data(), truncated.size(), out.data(), data.size())) << size;
+        }
+        for (int mutation = 0; mutation < 200 && !block.empty(); mutation++) {
+            std::vector<uint8_t> mutated(block);
+            mutated[(size_t)random.Range((int)mutated.size())] ^= (uint8_t)(1 + random.Range(255));
+            LzDecompress(mutated.data(), mutated.size(), out.data(), data.size());
+        }
+        EXPECT_TRUE(std::all_of(out.begin() + data.size(), out.end(), [](uint8_t value) { return value == 0xEE; }));
+    }
+}
+
+#ifdef CAPTURE_BENCH_HAVE_JPEG
+
+inline uint32_t ReadU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline uint16_t ReadU16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// Розбір пакета TIL1: LZ потік плиток -> кадр. Складні плитки (JPEG атлас) лише
+// рахуються - їх пікселі лишаються з frame; решта мають збігтися без втрат.
+class TestTileDecoder {
+public:
+    bool Decode(const uint8_t* packet, size_t size, TestFrame& frame) {
+        complex_ = 0;
+        if (size < TileEncoder::kHeaderSize || ReadU32(packet) != TileEncoder::kMagic ||
+            ReadU16(packet + 4) != frame.width || ReadU16(packet + 6) != frame.height) {
+            return Fail("bad header");
+        }
+        const int tile_size = ReadU16(packet + 8);
+        const size_t stream_size = ReadU32(packet + 12);
+        const size_t lz_size = ReadU32(packet + 16);
+        const size_t jpeg_size = ReadU32(packet + 20);
+        if (tile_size == 0 || TileEncoder::kHeaderSize + lz_size + jpeg_size != size) {
+            return Fail("bad sizes");
+        }
+        stream_.assign(stream_size, 0);
+        if (!LzDecompress(packet + TileEncoder::kHeaderSize, lz_size, stream_.data(), stream_size)) {
+            return Fail("corrupt LZ block");
+        }
+
+        const uint8_t* p = stream_.data();
+        const uint8_t* end = p + stream_.size();
+        for (int y0 = 0; y0 < frame.height; y0 += tile_size) {
+            for (int x0 = 0; x0 < frame.width; x0 += tile_size) {
+                const int w = std::min(tile_size, frame.width - x0);
+                const int h = std::min(tile_size, frame.height - y0);
+                if (p >= end) {
+                    return Fail("stream ended early");
+                }
+                auto put = [&](int i, const uint8_t* bgr) {
+                    uint8_t* out = frame.Pixel(x0 + i % w, y0 + i / w);
+                    memcpy(out, bgr, 3);
+                    out[3] = 0xFF;
+                };
+                const uint8_t type = *p++;
+                if (type == TileEncoder::kTileComplex) {
+                    complex_++;
+                    continue;
+                }
+                if (type == TileEncoder::kTileFlat || type == TileEncoder::kTileRaw) {
+                    const bool raw = type == TileEncoder::kTileRaw;
+                    if (end - p < (raw ? (ptrdiff_t)w * h * 3 : 3)) {
+                        return Fail("flat/raw tile truncated");
+                    }
+                    for (int i = 0; i < w * h; i++) {
+                        put(i, raw ? p + (size_t)i * 3 : p);
+                    }
+                    p += raw ? (size_t)w * h * 3 : 3;
+                    continue;
+                }
+                if (type != TileEncoder::kTilePalette && type != TileEncoder::kTileRle) {
+                    return Fail("unknown tile type");
+                }
+                const int colors = p < end ? *p++ : 0;
+                if (colors < 2 || colors > TileEncoder::kMaxPaletteColors || end - p < colors * 3) {
+                    return Fail("bad palette");
+                }
+                const uint8_t* palette = p;
+                p += colors * 3;
+                if (type == TileEncoder::kTilePalette) {
+                    const int bits = colors <= 2 ? 1 : (colors <= 4 ? 2 : 4);
+                    const int row_bytes = (w * bits + 7) / 8;
+                    if (end - p < (ptrdiff_t)row_bytes * h) {
+                        return Fail("palette indices truncated");
+                    }
+                    for (int y = 0; y < h; y++, p += row_bytes) {
+                        for (int x = 0; x < w; x++) {
+                            const int bit = x * bits;
+                            const int index = (p[bit >> 3] >> (8 - bits - (bit & 7))) & ((1 << bits) - 1);
+                            if (index >= colors) {
+                                return Fail("palette index out of range");
+                            }
+                            put(y * w + x, palette + index * 3);
+                        }
+                    }
+                    continue;
+                }
+                for (int i = 0; i < w * h;) {
+                    if (p >= end) {
+                        return Fail("rle truncated");
+                    }
+                    const int index = *p >> 4;
+                    const int run_end = i + (*p & 15) + 1;
+                    p++;
+                    if (index >= colors || run_end > w * h) {
+                        return Fail("bad rle run");
+                    }
+                    for (; i < run_end; i++) {
+                        put(i, palette + index * 3);
+                    }
+                }
+            }
+        }
+        return p == end ? true : Fail("trailing stream bytes");
+    }
+
+    int GetComplexTiles() const { return complex_; }
+    const std::string& GetError() const { return error_; }
+
+private:
+    bool Fail(const std::string& error) {
+        error_ = error;
+        return false;
+    }
+
+    std::vector<uint8_t> stream_;
+    int complex_ = 0;
+    std::string error_;
+};
+
+// Кадр з усіма типами плиток 64x64: однотонні, 2 / 4 / 16 кольорів з довгими серіями
+// (RLE) і поодинокими пікселями (упаковані індекси), шум; крайні плитки обрізані
+TestFrame MakeScreen(int width, int height, uint32_t seed) {
+    TestFrame frame(width, height, 12);
+    TestRandom random(seed);
+    for (int y0 = 0; y0 < height; y0 += 64) {
+        for (int x0 = 0; x0 < width; x0 += 64) {
+            TestFrame tile(std::min(64, width - x0), std::min(64, height - y0));
+            const int kind = random.Range(7);
+            if (kind == 0) {
+                tile.FillRect(0, 0, tile.width, tile.height, random.Next());
+            } else if (kind == 6) {
+                tile.FillRandom(random.Next());
+            } else {
+                const int colors[] = { 2, 3, 4, 9, 16 };
+                FillColors(tile, random, colors[kind - 1], kind % 2 ? 1 : 40);
+            }
+            for (int y = 0; y < tile.height; y++) {
+                memcpy(frame.Pixel(x0, y0 + y), tile.Row(y), (size_t)tile.width * 4);
+            }
+        }
+    }
+    return frame;
+}
+
+// Альфа не передається - порівнюються лише B, G, R
+bool SameColors(const TestFrame& a, const TestFrame& b) {
+    for (int y = 0; y < a.height; y++) {
+        for (int x = 0; x < a.width; x++) {
+            if (memcmp(a.Pixel(x, y), b.Pixel(x, y), 3) != 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+TEST(TileEncoderTest, LosslessRoundTripThroughLz) {
+    const int sizes[][2] = {{256, 192}, {200, 130}, {64, 64}, {17, 5}};
+    for (const auto& size : sizes) {
+        SCOPED_TRACE(testing::Message() << size[0] << "x" << size[1]);
+        TileEncoder encoder;
+        ASSERT_TRUE(encoder.Initialize(size[0], size[1], 64, 0)) << encoder.GetLastError();
+        std::vector<uint8_t> packet(encoder.GetMaxPacketSize());
+        TestTileDecoder decoder;
+        TileEncoderStats totals;
+
+        for (uint32_t seed = 1; seed <= 8; seed++) {
+            SCOPED_TRACE(seed);
+            const TestFrame frame = MakeScreen(size[0], size[1], seed);
+            size_t packet_size = 0;
+            ASSERT_TRUE(encoder.Encode(frame.pixels.data(), frame.stride, packet.data(), packet.size(), packet_size))
+                << encoder.GetLastError();
+            const TileEncoderStats stats = encoder.GetLastStats();
+            EXPECT_EQ(stats.jpeg_bytes, 0u);
+            EXPECT_EQ(packet_size, TileEncoder::kHeaderSize + stats.lz_bytes);
+
+            TestFrame decoded(size[0], size[1]);
+            ASSERT_TRUE(decoder.Decode(packet.data(), packet_size, decoded)) << decoder.GetError();
+            ASSERT_TRUE(SameColors(decoded, frame));
+            totals.flat_tiles += stats.flat_tiles;
+            totals.palette_tiles += stats.palette_tiles;
+            totals.rle_tiles += stats.rle_tiles;
+            totals.complex_tiles += stats.complex_tiles;
+        }
+        if (size[0] >= 200) {
+            EXPECT_GT(totals.flat_tiles, 0);
+            EXPECT_GT(totals.palette_tiles, 0);
+            EXPECT_GT(totals.rle_tiles, 0);
+            EXPECT_GT(totals.complex_tiles, 0);
+        }
+    }
+}
+
+TEST(TileEncoderTest, JpegAtlasKeepsLosslessTilesExact) {
+    TileEncoder encoder;
+    ASSERT_TRUE(encoder.Initialize(320, 200, 64, 80)) << encoder.GetLastError();
+    std::vector<uint8_t> packet(encoder.GetMaxPacketSize());
+    const TestFrame frame = MakeScreen(320, 200, 21);
+    size_t packet_size = 0;
+    ASSERT_TRUE(encoder.Encode(frame.pixels.data(), frame.stride, packet.data(), packet.size(), packet_size))
+        << encoder.GetLastError();
+    const TileEncoderStats stats = encoder.GetLastStats();
+    ASSERT_GT(stats.complex_tiles, 0);
+    EXPECT_GT(stats.jpeg_bytes, 0u);
+    EXPECT_EQ(packet[10], std::min(TileEncoder::kAtlasColumns, stats.complex_tiles));
+
+    // Складні плитки з JPEG лишаються з кадру - решта мають збігтися точно
+    TestFrame decoded = frame;
+    TestTileDecoder decoder;
+    ASSERT_TRUE(decoder.Decode(packet.data(), packet_size, decoded)) << decoder.GetError();
+    EXPECT_EQ(decoder.GetComplexTiles(), stats.complex_tiles);
+    EXPECT_TRUE(SameColors(decoded, frame));
+}
+
+TEST(TileEncoderTest, CorruptPacketsAreRejected) {
+    TileEncoder encoder;
+    ASSERT_TRUE(encoder.Initialize(200, 130, 64, 0));
+    std::vector<uint8_t> packet(encoder.GetMaxPacketSize());
+    const TestFrame frame = MakeScreen(200, 130, 31);
+    size_t packet_size = 0;
+    ASSERT_TRUE(encoder.Encode(frame.pixels.data(), frame.stride, packet.data(), packet.size(), packet_size));
+    packet.resize(packet_size);
+    TestTileDecoder decoder;
+    TestFrame decoded(200, 130);
+
+    std::vector<uint8_t> bad = packet;
+    bad.resize(packet.size() - 1);
+    EXPECT_FALSE(decoder.Decode(bad.data(), bad.size(), decoded));
+    bad = packet;
+    bad[12]++;                  // Розмір потоку не збігається з LZ блоком
+    EXPECT_FALSE(decoder.Decode(bad.data(), bad.size(), decoded));
+    bad = packet;
+    bad[0] ^= 0xFF;
+    EXPECT_FALSE(decoder.Decode(bad.data(), bad.size(), decoded));
+
+    // Мутації тіла: декодер або відхиляє пакет, або читає лише в межах потоку
+    TestRandom random(32);
+    for (int i = 0; i < 300; i++) {
+        bad = packet;
+        bad[TileEncoder::kHeaderSize + (size_t)random.Range((int)(packet.size() - TileEncoder::kHeaderSize))] ^=
+            (uint8_t)(1 + random.Range(255));
+        decoder.Decode(bad.data(), bad.size(), decoded);
+    }
+}
+
+TEST(TileEncoderTest, RejectsInvalidConfigAndSmallOutput) {
+    TileEncoder encoder;
+    EXPECT_FALSE(encoder.Initialize(0, 100));
+    EXPECT_FALSE(encoder.Initialize(70000, 100));
+    EXPECT_FALSE(encoder.Initialize(100, 100, 24));
+    EXPECT_FALSE(encoder.Initialize(100, 100, 512));
+
+    const TestFrame frame = MakeScreen(100, 100, 41);
+    std::vector<uint8_t> packet(1 << 20);
+    size_t size = 0;
+    EXPECT_FALSE(encoder.Encode(frame.pixels.data(), frame.stride, packet.data(), packet.size(), size));
+
+    ASSERT_TRUE(encoder.Initialize(100, 100, 16, 0));
+    EXPECT_FALSE(encoder.Encode(frame.pixels.data(), frame.stride, packet.data(), encoder.GetMaxPacketSize() - 1,
+                                size));
+    EXPECT_FALSE(encoder.Encode(frame.pixels.data(), 100 * 4 - 1, packet.data(), packet.size(), size));
+    EXPECT_FALSE(encoder.GetLastError().empty());
+    EXPECT_EQ(size, 0u);
+    EXPECT_TRUE(encoder.Encode(frame.pixels.data(), frame.stride, packet.data(), packet.size(), size));
+}
+
+#endif // CAPTURE_BENCH_HAVE_JPEG
+
+} // namespace
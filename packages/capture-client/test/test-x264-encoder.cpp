@@ -0,0 +1,187 @@
+/**
+ * x264 Encoder Tests
+ * Вихід x264 розбирається H264Parser (SPS/PPS + IDR на першому кадрі, IDR за
+ * ForceKeyframe) і, якщо знайдено libavcodec, декодується назад з перевіркою PSNR
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include "color-convert.h"
+#include "h264-parser.h"
+#include "test-common.h"
+#include "x264-encoder.h"
+
+#ifdef CAPTURE_TEST_HAVE_AVCODEC
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+#endif
+
+namespace {
+
+constexpr int kWidth = 320;
+constexpr int kHeight = 240;
+
+struct EncodedPacket {
+    std::vector<uint8_t> data;
+    bool keyframe = false;
+};
+
+// Градієнт із прямокутником, що рухається: плавна зміна без зміни сцени
+// (scenecut x264 не вставляє власних IDR)
+void DrawFrame(TestFrame& frame, int index) {
+    for (int y = 0; y < frame.height; y++) {
+        for (int x = 0; x < frame.width; x++) {
+            uint8_t* p = frame.Pixel(x, y);
+            p[0] = (uint8_t)(x * 255 / frame.width);
+            p[1] = (uint8_t)(y * 255 / frame.height);
+            p[2] = (uint8_t)((x + y) / 4);
+            p[3] = 0xFF;
+        }
+    }
+    frame.FillRect((index * 6) % (frame.width - 48), 40 + (index * 3) % 120, 48, 48, 0xFFE0E0E0);
+}
+
+// Кадри DrawFrame -> NV12 -> x264; nv12 - входи енкодера для порівняння з декодером
+class X264Stream {
+public:
+    bool Initialize(int keyframe_interval) {
+        VideoEncoderConfig config;
+        config.width = kWidth;
+        config.height = kHeight;
+        config.bitrate = 4000000;
+        config.keyframe_interval = keyframe_interval;
+        config.preset = "ultrafast";
+        if (!encoder_.Initialize(config)) {
+            return false;
+        }
+        frame_ = TestFrame(kWidth, kHeight);
+        out_.resize(encoder_.GetNV12Size() * 2);
+        return true;
+    }
+
+    EncodedPacket Encode() {
+        DrawFrame(frame_, (int)inputs_.size());
+        std::vector<uint8_t> nv12(encoder_.GetNV12Size());
+        EXPECT_TRUE(ConvertBGRAToNV12(frame_.pixels.data(), frame_.stride, kWidth, kHeight,
+                                      nv12.data(), kWidth, nv12.data() + kWidth * kHeight, kWidth));
+        EncodedPacket packet;
+        size_t size = 0;
+        EXPECT_TRUE(encoder_.EncodeNV12(nv12.data(), out_.data(), out_.size(), size)) << encoder_.GetLastError();
+        packet.data.assign(out_.begin(), out_.begin() + size);
+        packet.keyframe = encoder_.IsLastKeyframe();
+        inputs_.push_back(std::move(nv12));
+        return packet;
+    }
+
+    X264Encoder& Get() { return encoder_; }
+    const std::vector<uint8_t>& GetInput(size_t index) const { return inputs_[index]; }
+
+private:
+    X264Encoder encoder_;
+    TestFrame frame_;
+    std::vector<uint8_t> out_;
+    std::vector<std::vector<uint8_t>> inputs_;
+};
+
+TEST(X264EncoderTest, FirstFrameIsIdrWithParameterSets) {
+    X264Stream stream;
+    ASSERT_TRUE(stream.Initialize(300));
+    H264Parser parser;
+
+    for (int i = 0; i < 10; i++) {
+        SCOPED_TRACE(i);
+        const EncodedPacket packet = stream.Encode();
+        ASSERT_FALSE(packet.data.empty());   // zerolatency: кадр на кожен вхід
+        H264Packet parsed;
+        ASSERT_TRUE(parser.Parse(packet.data.data(), packet.data.size(), parsed)) << parser.GetLastError();
+        EXPECT_EQ(parsed.keyframe, i == 0);
+        EXPECT_EQ(packet.keyframe, i == 0);
+        EXPECT_EQ(parsed.has_parameter_sets, i == 0);
+    }
+    EXPECT_TRUE(parser.HasParameterSets());
+    EXPECT_EQ(parser.GetCodecString().compare(0, 5, "avc1."), 0);
+}
+
+TEST(X264EncoderTest, ForceKeyframeProducesIdrOnNextFrame) {
+    X264Stream stream;
+    ASSERT_TRUE(stream.Initialize(0));
+    H264Parser parser;
+
+    for (int i = 0; i < 12; i++) {
+        SCOPED_TRACE(i);
+        if (i == 5 || i == 9) {
+            stream.Get().ForceKeyframe();
+        }
+        const EncodedPacket packet = stream.Encode();
+        H264Packet parsed;
+        ASSERT_TRUE(parser.Parse(packet.data.data(), packet.data.size(), parsed)) << parser.GetLastError();
+        const bool expected = i == 0 || i == 5 || i == 9;
+        EXPECT_EQ(packet.keyframe, expected);
+        EXPECT_EQ(parsed.keyframe, expected);
+        // b_repeat_headers: SPS/PPS перед кожним IDR - глядач стартує з нього
+        EXPECT_EQ(parsed.has_parameter_sets, expected);
+    }
+}
+
+#ifdef CAPTURE_TEST_HAVE_AVCODEC
+// PSNR площини Y декодованого кадру проти входу енкодера
+double LumaPsnr(const uint8_t* expected, const AVFrame* frame) {
+    double error = 0.0;
+    for (int y = 0; y < kHeight; y++) {
+        const uint8_t* row = frame->data[0] + (size_t)y * frame->linesize[0];
+        for (int x = 0; x < kWidth; x++) {
+            const double d = (double)expected[(size_t)y * kWidth + x] - row[x];
+            error += d * d;
+        }
+    }
+    const double mse = error / ((double)kWidth * kHeight);
+    return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 100.0;
+}
+
+TEST(X264EncoderTest, DecodesWithLibavcodec) {
+    const AVCodec* codec = avcodec_find_decoder(AV_CODEC_ID_H264);
+    ASSERT_NE(codec, nullptr);
+    AVCodecContext* context = avcodec_alloc_context3(codec);
+    ASSERT_NE(context, nullptr);
+    ASSERT_EQ(avcodec_open2(context, codec, nullptr), 0);
+    AVPacket* av_packet = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+
+    X264Stream stream;
+    ASSERT_TRUE(stream.Initialize(0));
+    const int kFrames = 20;
+    int decoded = 0;
+    double min_psnr = 100.0;
+    for (int i = 0; i <= kFrames; i++) {
+        if (i == 10) {
+            stream.Get().ForceKeyframe();
+        }
+        // Останній крок - flush декодера
+        EncodedPacket packet;
+        if (i < kFrames) {
+            packet = stream.Encode();
+            av_packet->data = packet.data.data();
+            av_packet->size = (int)packet.data.size();
+            ASSERT_EQ(avcodec_send_packet(context, av_packet), 0);
+        } else {
+            ASSERT_EQ(avcodec_send_packet(context, nullptr), 0);
+        }
+        while (avcodec_receive_frame(context, frame) == 0) {
+            ASSERT_EQ(frame->width, kWidth);
+            ASSERT_EQ(frame->height, kHeight);
+            min_psnr = std::min(min_psnr, LumaPsnr(stream.GetInput(decoded).data(), frame));
+            decoded++;
+        }
+    }
+    EXPECT_EQ(decoded, kFrames);
+    EXPECT_GT(min_psnr, 30.0);
+
+    av_frame_free(&frame);
+    av_packet_free(&av_packet);
+    avcodec_free_context(&context);
+}
+#endif
+
+} // namespace
@@ -4,6 +4,7 @@
  */
 
 let videoElement = null;
+let tileCanvas = null; // Кадри codec: 'tile' декодуються тут (tile-decoder.js)
 let mediaSource = null;
 let sourceBuffer = null;
 let frameQueue = [];
@@ -13,9 +14,17 @@ let lastFrameTime = 0;
 let frameCount = 0;
 let fpsUpdateInterval = null;
 
+// Курсор - окремий шар поверх відео (позиція приходить без нового кадру)
+let cursorCanvas = null;
+const cursorShapes = new Map(); // 'output:id' -> canvas з формою
+let cursorState = null;
+let cursorFrame = { width: 0, height: 0, output: 0 };
+
 // Ініціалізація
 document.addEventListener('DOMContentLoaded', () => {
     videoElement = document.getElementById('videoPlayer');
+    tileCanvas = document.getElementById('tileCanvas');
+    cursorCanvas = document.getElementById('cursorOverlay');
     initFpsMonitor();
 });
 
@@ -25,7 +34,23 @@ document.addEventListener('DOMContentLoaded', () => {
 function onFrameReceived(frameData, metadata) {
     // Оновити лічильник FPS
     updateFps();
+
+    // Координати курсора - у пікселях кадру
+    const output = metadata.output || 0;
+    if (metadata.width !== cursorFrame.width || metadata.height !== cursorFrame.height ||
+        output !== cursorFrame.output) {
+        cursorFrame = { width: metadata.width, height: metadata.height, output: output };
+        drawCursor();
+    }
     
+    if (metadata.codec === 'tile') {
+        displayTileFrame(frameData);
+        return;
+    }
+    if (tileCanvas) {
+        tileCanvas.classList.remove('active');
+    }
+
     // Спробувати відобразити через MSE або blob
     try {
         displayFrameWithBlob(frameData, metadata);
@@ -56,6 +81,70 @@ function displayFrameWithBlob(frameData, metadata) {
     }, 100);
 }
 
+/**
+ * Екранний кодек: текст і UI без втрат, складні плитки - з JPEG атласу
+ */
+function displayTileFrame(frameData) {
+    if (!tileCanvas) {
+        return;
+    }
+    tileCanvas.classList.add('active');
+    drawTileFrame(tileCanvas, frameData).catch((error) => {
+        console.error('Помилка декодування tile кадру:', error);
+        log('❌ Помилка декодування tile кадру:', error.message);
+    });
+}
+
+/**
+ * Стан курсора від сервера: позиція, id форми і (першого разу) пікселі форми
+ */
+function onCursorReceived(message) {
+    if (message.shape) {
+        cursorShapes.set(`${message.output}:${message.shape.id}`, createCursorImage(message.shape));
+    }
+    if ((message.output || 0) === cursorFrame.output) {
+        cursorState = message;
+        drawCursor();
+    }
+}
+
+// Непремультиплікована BGRA (base64) -> canvas з RGBA
+function createCursorImage(shape) {
+    const bytes = Uint8Array.from(atob(shape.data), (c) => c.charCodeAt(0));
+    const image = new ImageData(shape.width, shape.height);
+    for (let i = 0; i < bytes.length; i += 4) {
+        image.data[i] = bytes[i + 2];
+        image.data[i + 1] = bytes[i + 1];
+        image.data[i + 2] = bytes[i];
+        image.data[i + 3] = bytes[i + 3];
+    }
+    const canvas = document.createElement('canvas');
+    canvas.width = shape.width;
+    canvas.height = shape.height;
+    canvas.getContext('2d').putImageData(image, 0, 0);
+    return canvas;
+}
+
+function drawCursor() {
+    if (!cursorCanvas || !cursorFrame.width) {
+        return;
+    }
+    // Шар має розмір кадру, масштабується разом з відео (object-fit: contain)
+    if (cursorCanvas.width !== cursorFrame.width || cursorCanvas.height !== cursorFrame.height) {
+        cursorCanvas.width = cursorFrame.width;
+        cursorCanvas.height = cursorFrame.height;
+    }
+    const context = cursorCanvas.getContext('2d');
+    context.clearRect(0, 0, cursorCanvas.width, cursorCanvas.height);
+    if (!cursorState || !cursorState.visible) {
+        return;
+    }
+    const shape = cursorShapes.get(`${cursorState.output || 0}:${cursorState.shapeId}`);
+    if (shape) {
+        context.drawImage(shape, cursorState.x, cursorState.y);
+    }
+}
+
 /**
  * Відображення через Media Source Extensions (для H.264)
  * TODO: Повна реалізація MSE
@@ -157,9 +246,16 @@ function stopVideo() {
         videoElement.src = '';
         videoElement.poster = '';
     }
+    if (tileCanvas) {
+        tileCanvas.classList.remove('active');
+    }
     
     mediaSource = null;
     sourceBuffer = null;
+
+    cursorState = null;
+    cursorShapes.clear();
+    drawCursor();
     
     // Скинути FPS
     currentFps = 0;
@@ -0,0 +1,269 @@
+/**
+ * Tile Decoder - кадри екранного кодека (codec: 'tile')
+ * Формат пакету - packages/capture-client/native/tile-encoder.h: потік плиток у блоці LZ4
+ * (текст і UI без втрат) + JPEG атлас складних плиток, який декодує браузер
+ */
+
+const TILE_MAGIC = 0x314C4954; // 'TIL1'
+const TILE_HEADER_SIZE = 24;
+const TILE_FLAT = 0;
+const TILE_PALETTE = 1;
+const TILE_RLE = 2;
+const TILE_COMPLEX = 3;
+const TILE_RAW = 4;
+
+let tileFrameSequence = 0;
+
+/**
+ * Розпакувати блок LZ4 рівно в dst; false - блок пошкоджений
+ */
+function lzDecompress(src, dst) {
+    let ip = 0;
+    let op = 0;
+
+    while (ip < src.length) {
+        const token = src[ip++];
+
+        let literals = token >> 4;
+        if (literals === 15) {
+            let byte;
+            do {
+                if (ip >= src.length) {
+                    return false;
+                }
+                byte = src[ip++];
+                literals += byte;
+            } while (byte === 255);
+        }
+        if (literals > src.length - ip || literals > dst.length - op) {
+            return false;
+        }
+        dst.set(src.subarray(ip, ip + literals), op);
+        ip += literals;
+        op += literals;
+        if (ip === src.length) {
+            break;
+        }
+
+        if (src.length - ip < 2) {
+            return false;
+        }
+        const offset = src[ip] | (src[ip + 1] << 8);
+        ip += 2;
+        if (offset === 0 || offset > op) {
+            return false;
+        }
+
+        let length = token & 15;
+        if (length === 15) {
+            let byte;
+            do {
+                if (ip >= src.length) {
+                    return false;
+                }
+                byte = src[ip++];
+                length += byte;
+            } while (byte === 255);
+        }
+        length += 4;
+        if (length > dst.length - op) {
+            return false;
+        }
+
+        // Збіг може перекривати сам себе - побайтово
+        for (let i = 0; i < length; i++, op++) {
+            dst[op] = dst[op - offset];
+        }
+    }
+    return op === dst.length;
+}
+
+/**
+ * Пакет -> { width, height, pixels (RGBA), cells: [{ x, y, width, height, sx, sy }], atlas (JPEG) }.
+ * Клітинки атласу (sx, sy) малюються поверх pixels у (x, y). null - пакет пошкоджений.
+ */
+function decodeTilePacket(frameData) {
+    const bytes = frameData instanceof Uint8Array ? frameData : new Uint8Array(frameData);
+    if (bytes.length < TILE_HEADER_SIZE) {
+        return null;
+    }
+    const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+    if (view.getUint32(0, true) !== TILE_MAGIC) {
+        return null;
+    }
+    const width = view.getUint16(4, true);
+    const height = view.getUint16(6, true);
+    const tileSize = view.getUint16(8, true);
+    const atlasColumns = bytes[10];
+    const streamSize = view.getUint32(12, true);
+    const lzSize = view.getUint32(16, true);
+    const jpegSize = view.getUint32(20, true);
+    if (TILE_HEADER_SIZE + lzSize + jpegSize !== bytes.length || tileSize === 0) {
+        return null;
+    }
+
+    const stream = new Uint8Array(streamSize);
+    if (!lzDecompress(bytes.subarray(TILE_HEADER_SIZE, TILE_HEADER_SIZE + lzSize), stream)) {
+        return null;
+    }
+
+    const pixels = new Uint8ClampedArray(width * height * 4);
+    const cells = [];
+    const tilesX = Math.ceil(width / tileSize);
+    const tilesY = Math.ceil(height / tileSize);
+    const palette = new Uint8Array(16 * 3);
+    let p = 0;
+
+    for (let ty = 0; ty < tilesY; ty++) {
+        for (let tx = 0; tx < tilesX; tx++) {
+            const x0 = tx * tileSize;
+            const y0 = ty * tileSize;
+            const w = Math.min(tileSize, width - x0);
+            const h = Math.min(tileSize, height - y0);
+            if (p >= stream.length) {
+                return null;
+            }
+            const type = stream[p++];
+
+            if (type === TILE_COMPLEX) {
+                if (!atlasColumns) {
+                    return null;
+                }
+                const cell = cells.length;
+                cells.push({
+                    x: x0, y: y0, width: w, height: h,
+                    sx: (cell % atlasColumns) * tileSize,
+                    sy: Math.floor(cell / atlasColumns) * tileSize
+                });
+                continue;
+            }
+
+            if (type === TILE_FLAT || type === TILE_RAW) {
+                const raw = type === TILE_RAW;
+                if (p + (raw ? w * h * 3 : 3) > stream.length) {
+                    return null;
+                }
+                for (let y = 0; y < h; y++) {
+                    let o = ((y0 + y) * width + x0) * 4;
+                    for (let x = 0; x < w; x++, o += 4) {
+                        pixels[o] = stream[p + 2];
+                        pixels[o + 1] = stream[p + 1];
+                        pixels[o + 2] = stream[p];
+                        pixels[o + 3] = 255;
+                        if (raw) {
+                            p += 3;
+                        }
+                    }
+                }
+                if (!raw) {
+                    p += 3;
+                }
+                continue;
+            }
+
+            if (type !== TILE_PALETTE && type !== TILE_RLE) {
+                return null;
+            }
+            const colors = stream[p++];
+            if (colors < 2 || colors > 16 || p + colors * 3 > stream.length) {
+                return null;
+            }
+            palette.set(stream.subarray(p, p + colors * 3));
+            p += colors * 3;
+
+            const put = (x, y, index) => {
+                const o = ((y0 + y) * width + x0 + x) * 4;
+                const c = index * 3;
+                pixels[o] = palette[c + 2];
+                pixels[o + 1] = palette[c + 1];
+                pixels[o + 2] = palette[c];
+                pixels[o + 3] = 255;
+            };
+
+            if (type === TILE_PALETTE) {
+                // Старші біти - лівіші пікселі, рядок доповнено до байта
+                const bits = colors <= 2 ? 1 : (colors <= 4 ? 2 : 4);
+                const mask = (1 << bits) - 1;
+                const rowBytes = Math.ceil(w * bits / 8);
+                if (p + rowBytes * h > stream.length) {
+                    return null;
+                }
+                for (let y = 0; y < h; y++, p += rowBytes) {
+                    for (let x = 0; x < w; x++) {
+                        const bit = x * bits;
+                        const index = (stream[p + (bit >> 3)] >> (8 - bits - (bit & 7))) & mask;
+                        if (index >= colors) {
+                            return null;
+                        }
+                        put(x, y, index);
+                    }
+                }
+            } else {
+                // Серії (індекс << 4 | довжина - 1) по пікселях плитки рядками
+                for (let i = 0; i < w * h;) {
+                    if (p >= stream.length) {
+                        return null;
+                    }
+                    const run = stream[p++];
+                    const index = run >> 4;
+                    const end = i + (run & 15) + 1;
+                    if (index >= colors || end > w * h) {
+                        return null;
+                    }
+                    for (; i < end; i++) {
+                        put(i % w, Math.floor(i / w), index);
+                    }
+                }
+            }
+        }
+    }
+    if (p !== stream.length || cells.length > 0 && jpegSize === 0) {
+        return null;
+    }
+
+    return {
+        width: width,
+        height: height,
+        pixels: pixels,
+        cells: cells,
+        atlas: jpegSize > 0 ? bytes.subarray(TILE_HEADER_SIZE + lzSize) : null
+    };
+}
+
+/**
+ * Показати кадр на canvas. Атлас декодується асинхронно, тож кадр малюється цілком
+ * лише після нього; кадр, який тим часом застарів, відкидається.
+ */
+async function drawTileFrame(canvas, frameData) {
+    const sequence = ++tileFrameSequence;
+    const frame = decodeTilePacket(frameData);
+    if (!frame) {
+        throw new Error('Пошкоджений tile пакет');
+    }
+
+    let atlas = null;
+    if (frame.atlas) {
+        atlas = await createImageBitmap(new Blob([frame.atlas], { type: 'image/jpeg' }));
+    }
+    if (sequence !== tileFrameSequence) {
+        if (atlas) {
+            atlas.close();
+        }
+        return;
+    }
+
+    if (canvas.width !== frame.width || canvas.height !== frame.height) {
+        canvas.width = frame.width;
+        canvas.height = frame.height;
+    }
+    const context = canvas.getContext('2d');
+    context.putImageData(new ImageData(frame.pixels, frame.width, frame.height), 0, 0);
+    if (atlas) {
+        for (const cell of frame.cells) {
+            context.drawImage(atlas, cell.sx, cell.sy, cell.width, cell.height,
+                              cell.x, cell.y, cell.width, cell.height);
+        }
+        atlas.close();
+    }
+}
+
@@ -233,6 +233,10 @@ function handleTextMessage(message) {
         case 'frame_metadata':
             handleFrameMetadata(message);
             break;
+
+        case 'cursor':
+            onCursorReceived(message);
+            break;
             
         case 'stream_ended':
             log('⚠️ Потік завершено');